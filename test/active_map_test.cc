@@ -8,8 +8,10 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 #include <climits>
+#include <cstring>
 #include <vector>
 #include "third_party/googletest/src/include/gtest/gtest.h"
+#include "./vpx_config.h"
 #include "test/codec_factory.h"
 #include "test/encode_test_driver.h"
 #include "test/i420_video_source.h"
@@ -88,4 +90,111 @@ TEST_P(ActiveMapTest, Test) {
 VP9_INSTANTIATE_TEST_CASE(ActiveMapTest,
                           ::testing::Values(::libvpx_test::kRealTime),
                           ::testing::Range(0, 9));
+
+#if CONFIG_VP9_ENCODER
+// Source content of the frame, with the inactive blocks of the active map
+// frozen from frame kFreezeFrame on, or scribbled over from kScribbleFrame on.
+const int kUnchangedWidth = 178;
+const int kUnchangedHeight = 142;
+const int kFreezeFrame = 2;
+const int kScribbleFrame = 6;
+
+bool IsActive(int mb_row, int mb_col) { return (mb_row * 3 + mb_col) % 5 < 2; }
+
+void FillUnchangedFrame(vpx_image_t *img, int frame, bool scribble) {
+  for (int plane = 0; plane < 3; ++plane) {
+    const int shift = plane ? 1 : 0;
+    const int w = (kUnchangedWidth + shift) >> shift;
+    const int h = (kUnchangedHeight + shift) >> shift;
+    for (int r = 0; r < h; ++r) {
+      uint8_t *const row = img->planes[plane] + r * img->stride[plane];
+      for (int c = 0; c < w; ++c) {
+        const bool active = IsActive((r << shift) >> 4, (c << shift) >> 4);
+        int f = frame;
+        if (!active && frame >= kFreezeFrame) {
+          f = scribble && frame >= kScribbleFrame ? 3 * frame : kFreezeFrame;
+        }
+        row[c] = static_cast<uint8_t>((r * (plane + 2) + c + f * 7) & 0xff);
+      }
+    }
+  }
+}
+
+class UnchangedVideoSource : public ::libvpx_test::DummyVideoSource {
+ public:
+  explicit UnchangedVideoSource(bool scribble) : scribble_(scribble) {
+    SetSize(kUnchangedWidth, kUnchangedHeight);
+    set_limit(12);
+  }
+
+ protected:
+  virtual void FillFrame() {
+    if (img_) FillUnchangedFrame(img_, frame_, scribble_);
+  }
+
+  bool scribble_;
+};
+
+// Sets the active map from kFreezeFrame on, with the inactive blocks left
+// unchanged in the source when inactive_unchanged_ is set.
+class ActiveMapUnchangedTest : public ActiveMapTest {
+ protected:
+  ActiveMapUnchangedTest() : inactive_unchanged_(false) {}
+
+  virtual void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                                  ::libvpx_test::Encoder *encoder) {
+    const int mb_rows = (kUnchangedHeight + 15) / 16;
+    const int mb_cols = (kUnchangedWidth + 15) / 16;
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, cpu_used_);
+      encoder->Control(VP9E_SET_INACTIVE_UNCHANGED, inactive_unchanged_);
+    } else if (video->frame() == kFreezeFrame) {
+      std::vector<uint8_t> active_map(mb_rows * mb_cols);
+      for (int r = 0; r < mb_rows; ++r) {
+        for (int c = 0; c < mb_cols; ++c) {
+          active_map[r * mb_cols + c] = IsActive(r, c);
+        }
+      }
+      vpx_active_map_t map = vpx_active_map_t();
+      map.rows = mb_rows;
+      map.cols = mb_cols;
+      map.active_map = &active_map[0];
+      encoder->Control(VP8E_SET_ACTIVEMAP, &map);
+    }
+  }
+
+  virtual void FramePktHook(const vpx_codec_cx_pkt_t *pkt) {
+    const uint8_t *const buf = static_cast<uint8_t *>(pkt->data.frame.buf);
+    stream_.insert(stream_.end(), buf, buf + pkt->data.frame.sz);
+  }
+
+  std::vector<uint8_t> Encode(bool inactive_unchanged, bool scribble) {
+    UnchangedVideoSource video(scribble);
+    inactive_unchanged_ = inactive_unchanged;
+    stream_.clear();
+    RunLoop(&video);
+    return stream_;
+  }
+
+  bool inactive_unchanged_;
+  std::vector<uint8_t> stream_;
+};
+
+// Copying only the active blocks gives the same stream, and the inactive
+// blocks of the source are not read once the encoder has copied them.
+TEST_P(ActiveMapUnchangedTest, CopiesActiveBlocksOnly) {
+  cfg_.g_lag_in_frames = 0;
+  cfg_.rc_end_usage = VPX_CBR;
+  cfg_.rc_resize_allowed = 0;
+  cfg_.kf_max_dist = 90000;
+  const std::vector<uint8_t> full_copy = Encode(false, false);
+  ASSERT_FALSE(full_copy.empty());
+  EXPECT_TRUE(full_copy == Encode(true, false));
+  EXPECT_TRUE(full_copy == Encode(true, true));
+}
+
+VP9_INSTANTIATE_TEST_CASE(ActiveMapUnchangedTest,
+                          ::testing::Values(::libvpx_test::kRealTime),
+                          ::testing::Values(7));
+#endif  // CONFIG_VP9_ENCODER
 }  // namespace
@@ -526,17 +526,24 @@ INSTANTIATE_TEST_CASE_P(SSSE3, TransDCT,
                                                      VPX_BITS_8)));
 #endif  // HAVE_SSSE3 && !CONFIG_VP9_HIGHBITDEPTH && ARCH_X86_64
 
-#if HAVE_AVX2 && !CONFIG_VP9_HIGHBITDEPTH
-static const FuncInfo dct_avx2_func_info = {
-  &fdct_wrapper<vpx_fdct32x32_avx2>, &idct_wrapper<vpx_idct32x32_1024_add_sse2>,
-  32, 1
+#if HAVE_AVX2
+static const FuncInfo dct_avx2_func_info[] = {
+#if CONFIG_VP9_HIGHBITDEPTH
+  { &fdct_wrapper<vpx_highbd_fdct32x32_avx2>,
+    &highbd_idct_wrapper<vpx_highbd_idct32x32_1024_add_sse2>, 32, 2 },
+#endif
+  { &fdct_wrapper<vpx_fdct32x32_avx2>,
+    &idct_wrapper<vpx_idct32x32_1024_add_sse2>, 32, 1 }
 };
 
-// TODO(johannkoenig): high bit depth fdct32x32.
-INSTANTIATE_TEST_CASE_P(AVX2, TransDCT,
-                        ::testing::Values(make_tuple(0, &dct_avx2_func_info, 0,
-                                                     VPX_BITS_8)));
-#endif  // HAVE_AVX2 && !CONFIG_VP9_HIGHBITDEPTH
+INSTANTIATE_TEST_CASE_P(
+    AVX2, TransDCT,
+    ::testing::Combine(
+        ::testing::Range(0, static_cast<int>(sizeof(dct_avx2_func_info) /
+                                             sizeof(dct_avx2_func_info[0]))),
+        ::testing::Values(dct_avx2_func_info), ::testing::Values(0),
+        ::testing::Values(VPX_BITS_8, VPX_BITS_10, VPX_BITS_12)));
+#endif  // HAVE_AVX2
 
 #if HAVE_NEON
 static const FuncInfo dct_neon_func_info[4] = {
@@ -688,6 +695,24 @@ INSTANTIATE_TEST_CASE_P(
                                          VPX_BITS_12)));
 #endif  // HAVE_SSE4_1 && CONFIG_VP9_HIGHBITDEPTH
 
+#if HAVE_AVX2
+static const FuncInfo ht_avx2_func_info[] = {
+#if CONFIG_VP9_HIGHBITDEPTH
+  { &vp9_highbd_fht16x16_avx2,
+    &highbd_iht_wrapper<vp9_highbd_iht16x16_256_add_avx2>, 16, 2 },
+#endif
+  { &vp9_fht16x16_avx2, &iht_wrapper<vp9_iht16x16_256_add_avx2>, 16, 1 }
+};
+
+INSTANTIATE_TEST_CASE_P(
+    AVX2, TransHT,
+    ::testing::Combine(
+        ::testing::Range(0, static_cast<int>(sizeof(ht_avx2_func_info) /
+                                             sizeof(ht_avx2_func_info[0]))),
+        ::testing::Values(ht_avx2_func_info), ::testing::Range(0, 4),
+        ::testing::Values(VPX_BITS_8, VPX_BITS_10, VPX_BITS_12)));
+#endif  // HAVE_AVX2
+
 #if HAVE_VSX && !CONFIG_EMULATE_HARDWARE && !CONFIG_VP9_HIGHBITDEPTH
 static const FuncInfo ht_vsx_func_info[3] = {
   { &vp9_fht4x4_c, &iht_wrapper<vp9_iht4x4_16_add_vsx>, 4, 1 },
@@ -8,10 +8,13 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string>
+
 #include "third_party/googletest/src/include/gtest/gtest.h"
 
 #include "./vpx_config.h"
 #include "test/ivf_video_source.h"
+#include "test/md5_helper.h"
 #include "vpx/vp8dx.h"
 #include "vpx/vpx_decoder.h"
 
@@ -69,6 +72,9 @@ TEST(DecodeAPI, OptionalParams) {
             vpx_codec_dec_init(&dec, &vpx_codec_vp8_dx_algo, NULL,
                                VPX_CODEC_USE_ERROR_CONCEALMENT));
 #endif  // CONFIG_ERROR_CONCEALMENT
+  EXPECT_EQ(VPX_CODEC_INCAPABLE,
+            vpx_codec_dec_init(&dec, &vpx_codec_vp8_dx_algo, NULL,
+                               VPX_CODEC_USE_ASYNC));
 }
 #endif  // CONFIG_VP8_DECODER
 
@@ -110,6 +116,13 @@ void TestVp9Controls(vpx_codec_ctx_t *dec) {
   EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
             vpx_codec_control(dec, VP8_COPY_REFERENCE, NULL));
   vpx_img_free(&ref_copy.img);
+
+  vp9_borrowed_frame_t borrowed;
+  borrowed.idx = 0;
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_control(dec, VP9D_RETURN_FRAME, &borrowed));
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_control(dec, VP9D_BORROW_FRAME, NULL));
 }
 
 TEST(DecodeAPI, Vp9InvalidDecode) {
@@ -138,6 +151,178 @@ TEST(DecodeAPI, Vp9InvalidDecode) {
   EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
 }
 
+TEST(DecodeAPI, Vp9BorrowFrame) {
+  const vpx_codec_iface_t *const codec = &vpx_codec_vp9_dx_algo;
+  // The frames are held across resolution changes.
+  const char filename[] = "vp90-2-05-resize.ivf";
+  const int kNumHeld = 4;
+  libvpx_test::IVFVideoSource video(filename);
+  video.Init();
+  video.Begin();
+  ASSERT_TRUE(!HasFailure());
+
+  vpx_codec_ctx_t dec, ref_dec;
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&dec, codec, NULL, 0));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&ref_dec, codec, NULL, 0));
+
+  vp9_borrowed_frame_t held[kNumHeld];
+  std::string expected_md5[kNumHeld];
+  int num_held = 0;
+  int num_frames = 0;
+  for (; video.cxdata() != NULL; video.Next()) {
+    const uint32_t frame_size = static_cast<uint32_t>(video.frame_size());
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec, video.cxdata(), frame_size, NULL, 0));
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&ref_dec, video.cxdata(), frame_size, NULL, 0));
+
+    vpx_codec_iter_t iter = NULL;
+    const vpx_image_t *const img = vpx_codec_get_frame(&ref_dec, &iter);
+    vp9_borrowed_frame_t *const frame = &held[num_frames % kNumHeld];
+    // Return the frame borrowed kNumHeld frames ago, once it has been checked
+    // against the reference decode.
+    if (num_held == kNumHeld) {
+      libvpx_test::MD5 md5;
+      md5.Add(&frame->img);
+      EXPECT_EQ(expected_md5[num_frames % kNumHeld], md5.Get());
+      ASSERT_EQ(VPX_CODEC_OK,
+                vpx_codec_control(&dec, VP9D_RETURN_FRAME, frame));
+      --num_held;
+    }
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_BORROW_FRAME, frame));
+    iter = NULL;
+    EXPECT_EQ(NULL, vpx_codec_get_frame(&dec, &iter));
+    if (img == NULL) {
+      EXPECT_EQ(-1, frame->idx);
+      continue;
+    }
+    ASSERT_GE(frame->idx, 0);
+    libvpx_test::MD5 md5;
+    md5.Add(img);
+    expected_md5[num_frames % kNumHeld] = md5.Get();
+    ++num_held;
+    ++num_frames;
+  }
+  EXPECT_GT(num_frames, kNumHeld);
+
+  for (int i = num_frames - num_held; i < num_frames; ++i) {
+    vp9_borrowed_frame_t *const frame = &held[i % kNumHeld];
+    libvpx_test::MD5 md5;
+    md5.Add(&frame->img);
+    EXPECT_EQ(expected_md5[i % kNumHeld], md5.Get());
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_RETURN_FRAME, frame));
+    EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+              vpx_codec_control(&dec, VP9D_RETURN_FRAME, frame));
+  }
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&ref_dec));
+}
+
+// A keyframe decoded after a corrupt frame releases every frame buffer, except
+// the borrowed ones.
+TEST(DecodeAPI, Vp9BorrowFrameAcrossResync) {
+  const vpx_codec_iface_t *const codec = &vpx_codec_vp9_dx_algo;
+  const char filename[] = "vp90-2-05-resize.ivf";
+  const int kNumFramesBefore = 3;
+  const int kNumFramesAfter = 20;
+  libvpx_test::IVFVideoSource video(filename);
+  video.Init();
+  video.Begin();
+  ASSERT_TRUE(!HasFailure());
+
+  vpx_codec_ctx_t dec;
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&dec, codec, NULL, 0));
+  for (int i = 0; i < kNumFramesBefore; ++i, video.Next()) {
+    ASSERT_TRUE(video.cxdata() != NULL);
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec, video.cxdata(),
+                               static_cast<unsigned int>(video.frame_size()),
+                               NULL, 0));
+  }
+  vp9_borrowed_frame_t frame;
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_BORROW_FRAME, &frame));
+  ASSERT_GE(frame.idx, 0);
+  libvpx_test::MD5 expected_md5;
+  expected_md5.Add(&frame.img);
+
+  // A truncated inter frame.
+  ASSERT_TRUE(video.cxdata() != NULL);
+  EXPECT_NE(VPX_CODEC_OK, vpx_codec_decode(&dec, video.cxdata(), 1, NULL, 0));
+
+  // Decode from the first keyframe again, with enough frames to reuse every
+  // free frame buffer.
+  libvpx_test::IVFVideoSource restart(filename);
+  restart.Init();
+  restart.Begin();
+  ASSERT_TRUE(!HasFailure());
+  for (int i = 0; i < kNumFramesAfter && restart.cxdata() != NULL;
+       ++i, restart.Next()) {
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec, restart.cxdata(),
+                               static_cast<unsigned int>(restart.frame_size()),
+                               NULL, 0));
+    vpx_codec_iter_t iter = NULL;
+    while (vpx_codec_get_frame(&dec, &iter) != NULL) {
+    }
+  }
+
+  libvpx_test::MD5 md5;
+  md5.Add(&frame.img);
+  EXPECT_STREQ(expected_md5.Get(), md5.Get());
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_RETURN_FRAME, &frame));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+}
+
+TEST(DecodeAPI, Vp9StageStats) {
+  const vpx_codec_iface_t *const codec = &vpx_codec_vp9_dx_algo;
+  const char filename[] = "vp90-2-05-resize.ivf";
+  libvpx_test::IVFVideoSource video(filename);
+  video.Init();
+  video.Begin();
+  ASSERT_TRUE(!HasFailure());
+
+  vpx_codec_ctx_t dec;
+  vp9_stage_stats_t stats;
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&dec, codec, NULL, 0));
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(&dec, VP9D_SET_STAGE_STATS, 1));
+
+  for (; video.cxdata() != NULL; video.Next()) {
+    const uint32_t frame_size = static_cast<uint32_t>(video.frame_size());
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_decode(&dec, video.cxdata(), frame_size, NULL, 0));
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&dec, VP9D_GET_STAGE_STATS, &stats));
+    vpx_codec_iter_t iter = NULL;
+    const vpx_image_t *const img = vpx_codec_get_frame(&dec, &iter);
+    if (img == NULL) continue;
+
+    const unsigned int sb_cols = (img->d_w + 63) / 64;
+    const unsigned int sb_rows = (img->d_h + 63) / 64;
+    EXPECT_EQ(sb_cols * sb_rows, stats.superblocks);
+    EXPECT_GT(stats.bytes_read, 0u);
+    EXPECT_LE(stats.bytes_read, frame_size);
+    // A single thread runs one stage at a time.
+    uint64_t stage_ticks = 0;
+    for (int i = 0; i < VP9_DECODER_STAGES; ++i) {
+      stage_ticks += stats.stage_ticks[i];
+    }
+    EXPECT_LE(stage_ticks, stats.frame_ticks);
+  }
+  EXPECT_EQ(VPX_CODEC_ERROR, vpx_codec_control(&dec, VP9D_SET_STAGE_STATS, 0));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+
+  // The counters are only kept when enabled.
+  ASSERT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&dec, codec, NULL, 0));
+  video.Begin();
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_decode(&dec, video.cxdata(),
+                             static_cast<uint32_t>(video.frame_size()), NULL,
+                             0));
+  EXPECT_EQ(VPX_CODEC_ERROR,
+            vpx_codec_control(&dec, VP9D_GET_STAGE_STATS, &stats));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&dec));
+}
+
 void TestPeekInfo(const uint8_t *const data, uint32_t data_sz,
                   uint32_t peek_size) {
   const vpx_codec_iface_t *const codec = &vpx_codec_vp9_dx_algo;
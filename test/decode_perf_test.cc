@@ -8,8 +8,10 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <ctime>
 #include <string>
 #include <tuple>
+#include <vector>
 
 #include "test/codec_factory.h"
 #include "test/decode_test_driver.h"
@@ -19,6 +21,7 @@
 #include "test/md5_helper.h"
 #include "test/util.h"
 #include "test/webm_video_source.h"
+#include "vpx/vp8dx.h"
 #include "vpx_ports/vpx_timer.h"
 #include "./ivfenc.h"
 #include "./vpx_version.h"
@@ -110,6 +113,284 @@ TEST_P(DecodePerfTest, PerfTest) {
 INSTANTIATE_TEST_CASE_P(VP9, DecodePerfTest,
                         ::testing::ValuesIn(kVP9DecodePerfVectors));
 
+/*
+ DecodeRowMtScalingTest decodes with row based multi-threading, using the
+ same vector with 1 to 32 threads, to report how decoding scales.
+ */
+const char *const kVP9DecodeScalingVectors[] = {
+  "vp90-2-bbb_1920x1080_tile_1x1_2581kbps.webm",
+  "vp90-2-bbb_1920x1080_tile_1x4_2586kbps.webm",
+  "vp90-2-tos_1920x800_tile_1x4_fpm_2335kbps.webm",
+};
+
+const unsigned kDecodeScalingThreads[] = { 1, 2, 4, 8, 16, 32 };
+
+class DecodeRowMtScalingTest
+    : public ::testing::TestWithParam<DecodePerfParam> {};
+
+TEST_P(DecodeRowMtScalingTest, PerfTest) {
+  const char *const video_name = GET_PARAM(VIDEO_NAME);
+  const unsigned threads = GET_PARAM(THREADS);
+
+  libvpx_test::WebMVideoSource video(video_name);
+  video.Init();
+
+  vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+  cfg.threads = threads;
+  libvpx_test::VP9Decoder decoder(cfg, 0);
+  decoder.Control(VP9D_SET_ROW_MT, 1);
+
+  vpx_usec_timer t;
+  vpx_usec_timer_start(&t);
+
+  for (video.Begin(); video.cxdata() != NULL; video.Next()) {
+    decoder.DecodeFrame(video.cxdata(), video.frame_size());
+  }
+
+  vpx_usec_timer_mark(&t);
+  const double elapsed_secs = double(vpx_usec_timer_elapsed(&t)) / kUsecsInSec;
+  const unsigned frames = video.frame_number();
+  const double fps = double(frames) / elapsed_secs;
+
+  printf("{\n");
+  printf("\t\"type\" : \"decode_row_mt_scaling_test\",\n");
+  printf("\t\"version\" : \"%s\",\n", VERSION_STRING_NOSP);
+  printf("\t\"videoName\" : \"%s\",\n", video_name);
+  printf("\t\"threadCount\" : %u,\n", threads);
+  printf("\t\"decodeTimeSecs\" : %f,\n", elapsed_secs);
+  printf("\t\"totalFrames\" : %u,\n", frames);
+  printf("\t\"framesPerSecond\" : %f\n", fps);
+  printf("}\n");
+}
+
+INSTANTIATE_TEST_CASE_P(
+    VP9, DecodeRowMtScalingTest,
+    ::testing::Combine(::testing::ValuesIn(kVP9DecodeScalingVectors),
+                       ::testing::ValuesIn(kDecodeScalingThreads)));
+
+/*
+ DecodeBorrowFramePerfTest compares a consumer that copies each output frame
+ out of the decoder, to keep it past the next decode call, with one that
+ borrows the decoder's buffer with VP9D_BORROW_FRAME. Each frame is read once.
+ */
+const char *const kVP9DecodeBorrowFrameVectors[] = {
+  "vp90-2-bbb_1920x1080_tile_1x4_2586kbps.webm",
+  "vp90-2-tos_1920x800_tile_1x4_fpm_2335kbps.webm",
+};
+
+// Bytes in the visible planes of an 8-bit 4:2:0 image.
+size_t FrameBytes(unsigned int width, unsigned int height) {
+  return width * height + 2 * ((width + 1) / 2) * ((height + 1) / 2);
+}
+
+// Reads the picture once, as a consumer would.
+uint32_t ReadFrame(const vpx_image_t *img) {
+  uint32_t sum = 0;
+  for (int plane = 0; plane < 3; ++plane) {
+    const unsigned int w = plane ? (img->d_w + 1) >> 1 : img->d_w;
+    const unsigned int h = plane ? (img->d_h + 1) >> 1 : img->d_h;
+    for (unsigned int y = 0; y < h; ++y) {
+      const uint8_t *const row = img->planes[plane] + y * img->stride[plane];
+      for (unsigned int x = 0; x < w; ++x) sum += row[x];
+    }
+  }
+  return sum;
+}
+
+// Copies the visible planes of |img| to |buf|.
+void CopyFrame(const vpx_image_t *img, std::vector<uint8_t> *buf) {
+  buf->resize(FrameBytes(img->d_w, img->d_h));
+  uint8_t *dst = &(*buf)[0];
+  for (int plane = 0; plane < 3; ++plane) {
+    const unsigned int w = plane ? (img->d_w + 1) >> 1 : img->d_w;
+    const unsigned int h = plane ? (img->d_h + 1) >> 1 : img->d_h;
+    for (unsigned int y = 0; y < h; ++y) {
+      memcpy(dst, img->planes[plane] + y * img->stride[plane], w);
+      dst += w;
+    }
+  }
+}
+
+class DecodeBorrowFramePerfTest
+    : public ::testing::TestWithParam<const char *> {};
+
+TEST_P(DecodeBorrowFramePerfTest, PerfTest) {
+  const char *const video_name = GetParam();
+  double elapsed_secs[2];
+  uint32_t sum[2] = { 0, 0 };
+  size_t bytes_copied = 0;
+  unsigned frames = 0;
+
+  for (int borrow = 0; borrow < 2; ++borrow) {
+    libvpx_test::WebMVideoSource video(video_name);
+    video.Init();
+
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = 4;
+    libvpx_test::VP9Decoder decoder(cfg, 0);
+    std::vector<uint8_t> copy;
+
+    vpx_usec_timer t;
+    vpx_usec_timer_start(&t);
+
+    for (video.Begin(); video.cxdata() != NULL; video.Next()) {
+      decoder.DecodeFrame(video.cxdata(), video.frame_size());
+      if (borrow) {
+        vp9_borrowed_frame_t frame;
+        decoder.Control(VP9D_BORROW_FRAME, &frame);
+        if (frame.idx < 0) continue;
+        sum[borrow] += ReadFrame(&frame.img);
+        decoder.Control(VP9D_RETURN_FRAME, &frame);
+      } else {
+        libvpx_test::DxDataIterator dec_iter = decoder.GetDxData();
+        const vpx_image_t *const img = dec_iter.Next();
+        if (img == NULL) continue;
+        CopyFrame(img, &copy);
+        bytes_copied += copy.size();
+        // Read the copy as an image with packed planes.
+        vpx_image_t copy_img;
+        vpx_img_wrap(&copy_img, VPX_IMG_FMT_I420, img->d_w, img->d_h, 1,
+                     &copy[0]);
+        sum[borrow] += ReadFrame(&copy_img);
+      }
+    }
+
+    vpx_usec_timer_mark(&t);
+    elapsed_secs[borrow] = double(vpx_usec_timer_elapsed(&t)) / kUsecsInSec;
+    frames = video.frame_number();
+  }
+  EXPECT_EQ(sum[0], sum[1]);
+
+  // The copy reads and writes each frame once.
+  const double bytes_saved_per_frame = 2.0 * bytes_copied / frames;
+  printf("{\n");
+  printf("\t\"type\" : \"decode_borrow_frame_perf_test\",\n");
+  printf("\t\"version\" : \"%s\",\n", VERSION_STRING_NOSP);
+  printf("\t\"videoName\" : \"%s\",\n", video_name);
+  printf("\t\"totalFrames\" : %u,\n", frames);
+  printf("\t\"copyDecodeTimeSecs\" : %f,\n", elapsed_secs[0]);
+  printf("\t\"borrowDecodeTimeSecs\" : %f,\n", elapsed_secs[1]);
+  printf("\t\"bytesSavedPerFrame\" : %.0f,\n", bytes_saved_per_frame);
+  printf("\t\"bytesSavedPer4kFrame\" : %.0f\n",
+         2.0 * FrameBytes(3840, 2160));
+  printf("}\n");
+}
+
+INSTANTIATE_TEST_CASE_P(VP9, DecodeBorrowFramePerfTest,
+                        ::testing::ValuesIn(kVP9DecodeBorrowFrameVectors));
+
+/*
+ DecodeFusedLoopFilterPerfTest decodes with a single thread, running the loop
+ filter a superblock row at a time and then fused into decoding with
+ VP9D_SET_FUSED_LOOP_FILTER.
+ */
+const char *const kVP9DecodeFusedLoopFilterVectors[] = {
+  "vp90-2-bbb_1920x1080_tile_1x1_2581kbps.webm",
+  "vp90-2-bbb_1920x1080_tile_1x4_2586kbps.webm",
+  "vp90-2-tos_1920x800_tile_1x4_fpm_2335kbps.webm",
+};
+
+class DecodeFusedLoopFilterPerfTest
+    : public ::testing::TestWithParam<const char *> {};
+
+TEST_P(DecodeFusedLoopFilterPerfTest, PerfTest) {
+  const char *const video_name = GetParam();
+  double fps[2];
+  unsigned frames = 0;
+
+  for (int fused = 0; fused < 2; ++fused) {
+    libvpx_test::WebMVideoSource video(video_name);
+    video.Init();
+
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = 1;
+    libvpx_test::VP9Decoder decoder(cfg, 0);
+    decoder.Control(VP9D_SET_FUSED_LOOP_FILTER, fused);
+
+    vpx_usec_timer t;
+    vpx_usec_timer_start(&t);
+
+    for (video.Begin(); video.cxdata() != NULL; video.Next()) {
+      decoder.DecodeFrame(video.cxdata(), video.frame_size());
+    }
+
+    vpx_usec_timer_mark(&t);
+    const double elapsed_secs =
+        double(vpx_usec_timer_elapsed(&t)) / kUsecsInSec;
+    frames = video.frame_number();
+    fps[fused] = double(frames) / elapsed_secs;
+  }
+
+  printf("{\n");
+  printf("\t\"type\" : \"decode_fused_loop_filter_perf_test\",\n");
+  printf("\t\"version\" : \"%s\",\n", VERSION_STRING_NOSP);
+  printf("\t\"videoName\" : \"%s\",\n", video_name);
+  printf("\t\"totalFrames\" : %u,\n", frames);
+  printf("\t\"rowFramesPerSecond\" : %f,\n", fps[0]);
+  printf("\t\"fusedFramesPerSecond\" : %f,\n", fps[1]);
+  printf("\t\"speedup\" : %f\n", fps[1] / fps[0]);
+  printf("}\n");
+}
+
+INSTANTIATE_TEST_CASE_P(VP9, DecodeFusedLoopFilterPerfTest,
+                        ::testing::ValuesIn(kVP9DecodeFusedLoopFilterVectors));
+
+#if CONFIG_VP8_DECODER
+/*
+ VP8DecodeRowSyncPerfTest decodes a VP8 stream with 1 to 8 threads and
+ reports the process CPU time per frame next to the wall time, since threads
+ waiting on the macroblock row above cost CPU without speeding up decoding.
+ */
+const char *const kVP8DecodeRowSyncVectors[] = { "tos_vp8.webm" };
+
+const unsigned kVP8DecodeRowSyncThreads[] = { 1, 2, 4, 8 };
+
+class VP8DecodeRowSyncPerfTest
+    : public ::testing::TestWithParam<DecodePerfParam> {};
+
+TEST_P(VP8DecodeRowSyncPerfTest, PerfTest) {
+  const char *const video_name = GET_PARAM(VIDEO_NAME);
+  const unsigned threads = GET_PARAM(THREADS);
+
+  libvpx_test::WebMVideoSource video(video_name);
+  video.Init();
+
+  vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+  cfg.threads = threads;
+  libvpx_test::VP8Decoder decoder(cfg, 0);
+
+  vpx_usec_timer t;
+  vpx_usec_timer_start(&t);
+  // CPU time of all the threads of the process.
+  const std::clock_t cpu_start = std::clock();
+
+  for (video.Begin(); video.cxdata() != NULL; video.Next()) {
+    decoder.DecodeFrame(video.cxdata(), video.frame_size());
+  }
+
+  const double cpu_secs = double(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+  vpx_usec_timer_mark(&t);
+  const double elapsed_secs = double(vpx_usec_timer_elapsed(&t)) / kUsecsInSec;
+  const unsigned frames = video.frame_number();
+
+  printf("{\n");
+  printf("\t\"type\" : \"vp8_decode_row_sync_perf_test\",\n");
+  printf("\t\"version\" : \"%s\",\n", VERSION_STRING_NOSP);
+  printf("\t\"videoName\" : \"%s\",\n", video_name);
+  printf("\t\"threadCount\" : %u,\n", threads);
+  printf("\t\"totalFrames\" : %u,\n", frames);
+  printf("\t\"framesPerSecond\" : %f,\n", frames / elapsed_secs);
+  printf("\t\"cpuMsecsPerFrame\" : %f,\n", 1000.0 * cpu_secs / frames);
+  printf("\t\"cpuUtilization\" : %f\n", cpu_secs / elapsed_secs);
+  printf("}\n");
+}
+
+INSTANTIATE_TEST_CASE_P(
+    VP8, VP8DecodeRowSyncPerfTest,
+    ::testing::Combine(::testing::ValuesIn(kVP8DecodeRowSyncVectors),
+                       ::testing::ValuesIn(kVP8DecodeRowSyncThreads)));
+#endif  // CONFIG_VP8_DECODER
+
 class VP9NewEncodeDecodePerfTest
     : public ::libvpx_test::EncoderTest,
       public ::libvpx_test::CodecTestWithParam<libvpx_test::TestMode> {
@@ -8,11 +8,16 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
 #include "third_party/googletest/src/include/gtest/gtest.h"
 
 #include "./vpx_config.h"
 #include "vpx/vp8cx.h"
 #include "vpx/vpx_encoder.h"
+#include "vpx/vpx_image.h"
 
 namespace {
 
@@ -192,4 +197,306 @@ TEST(EncodeAPI, MultiResEncode) {
   }
 }
 
+#if CONFIG_VP9_ENCODER
+void ReleaseSource(void *user_priv, const vpx_image_t *img) {
+  std::vector<int> *const released = static_cast<std::vector<int> *>(user_priv);
+  ++(*released)[reinterpret_cast<intptr_t>(img->user_priv)];
+}
+
+void FillFrame(vpx_image_t *img, int frame) {
+  for (int plane = 0; plane < 3; ++plane) {
+    const int w = plane ? (img->d_w + 1) >> 1 : img->d_w;
+    const int h = plane ? (img->d_h + 1) >> 1 : img->d_h;
+    for (int r = 0; r < h; ++r) {
+      uint8_t *const row = img->planes[plane] + r * img->stride[plane];
+      for (int c = 0; c < w; ++c) {
+        row[c] = static_cast<uint8_t>((r * 3 + c * (plane + 1) + frame * 5) &
+                                      0xff);
+      }
+    }
+  }
+}
+
+// Lent images are allocated kPaddedSize square, with a stride other than the
+// one of the encoder's own copies, and with a kLagMargin margin above and left
+// of them when the encoder has lag.
+const int kPaddedSize = 320;
+const int kLagMargin = 16;
+const int kLentFrames = 8;
+
+// Returns the stream of one pass over kLentFrames frames, or the first pass
+// stats.
+std::vector<uint8_t> EncodePass(bool lend, int lag, int cpu_used, int width,
+                                int height, vpx_enc_pass pass,
+                                const std::vector<uint8_t> &stats,
+                                std::vector<int> *released) {
+  const unsigned long deadline = lag ? VPX_DL_GOOD_QUALITY : VPX_DL_REALTIME;
+  const int margin = lag ? kLagMargin : 0;
+  vpx_codec_ctx_t enc;
+  vpx_codec_enc_cfg_t cfg;
+  std::vector<uint8_t> out;
+  vpx_image_t img[kLentFrames];
+
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_config_default(vpx_codec_vp9_cx(), &cfg, 0));
+  cfg.g_w = width;
+  cfg.g_h = height;
+  cfg.g_lag_in_frames = lag;
+  cfg.g_pass = pass;
+  cfg.rc_end_usage = lag ? VPX_VBR : VPX_CBR;
+  if (pass == VPX_RC_LAST_PASS) {
+    cfg.rc_twopass_stats_in.buf = const_cast<uint8_t *>(&stats[0]);
+    cfg.rc_twopass_stats_in.sz = stats.size();
+  }
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg, 0));
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP8E_SET_CPUUSED, cpu_used));
+  if (lag) {
+    // Short golden frame groups, so that an alt-ref is coded.
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&enc, VP9E_SET_MIN_GF_INTERVAL, 4));
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&enc, VP9E_SET_MAX_GF_INTERVAL, 4));
+  }
+
+  vpx_source_release_cb_t cb;
+  cb.release_source = ReleaseSource;
+  cb.user_priv = released;
+  if (lend) {
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&enc, VP9E_SET_SOURCE_RELEASE_CB, &cb));
+  }
+
+  for (int i = 0; i <= kLentFrames; ++i) {
+    // The last pass flushes the frames held for lookahead.
+    vpx_image_t *const frame = i < kLentFrames ? &img[i] : NULL;
+    if (frame != NULL) {
+      if (lend) {
+        // Padded allocation, with the padding holding stale data.
+        EXPECT_TRUE(vpx_img_alloc(frame, VPX_IMG_FMT_I420, kPaddedSize,
+                                  kPaddedSize, 32) != NULL);
+        memset(frame->img_data, 0x5a, kPaddedSize * kPaddedSize * 3 / 2);
+        EXPECT_EQ(0, vpx_img_set_rect(frame, margin, margin, width, height));
+      } else {
+        EXPECT_TRUE(vpx_img_alloc(frame, VPX_IMG_FMT_I420, width, height,
+                                  32) != NULL);
+      }
+      frame->user_priv = reinterpret_cast<void *>(static_cast<intptr_t>(i));
+      FillFrame(frame, i);
+    }
+    bool got_data;
+    do {
+      EXPECT_EQ(VPX_CODEC_OK, vpx_codec_encode(&enc, frame, i, 1, 0, deadline));
+      got_data = false;
+      vpx_codec_iter_t iter = NULL;
+      const vpx_codec_cx_pkt_t *pkt;
+      while ((pkt = vpx_codec_get_cx_data(&enc, &iter)) != NULL) {
+        const uint8_t *buf;
+        size_t sz;
+        if (pkt->kind == VPX_CODEC_CX_FRAME_PKT) {
+          buf = static_cast<uint8_t *>(pkt->data.frame.buf);
+          sz = pkt->data.frame.sz;
+        } else if (pkt->kind == VPX_CODEC_STATS_PKT) {
+          buf = static_cast<uint8_t *>(pkt->data.twopass_stats.buf);
+          sz = pkt->data.twopass_stats.sz;
+        } else {
+          continue;
+        }
+        out.insert(out.end(), buf, buf + sz);
+        got_data = true;
+      }
+    } while (frame == NULL && got_data);
+    // A lent image is still held by the encoder after it has been coded.
+    if (frame != NULL && lend && pass != VPX_RC_FIRST_PASS) {
+      EXPECT_EQ(0, (*released)[i]) << "frame " << i;
+    }
+  }
+  // Frames that left the lookahead and ARNR window are already handed back.
+  if (lend && lag && pass != VPX_RC_FIRST_PASS) {
+    EXPECT_EQ(1, (*released)[0]);
+  }
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  for (int i = 0; i < kLentFrames; ++i) vpx_img_free(&img[i]);
+  return out;
+}
+
+// Returns the stream of a one pass encode without lag. With lag, two passes
+// run so that the frames are filtered into alt-refs and searched by the
+// temporal dependency model, and the first pass stats come ahead of the
+// stream.
+std::vector<uint8_t> EncodeFrames(bool lend, int lag, int cpu_used, int width,
+                                  int height, std::vector<int> *released) {
+  const std::vector<uint8_t> no_stats;
+  if (lag == 0) {
+    return EncodePass(lend, lag, cpu_used, width, height, VPX_RC_ONE_PASS,
+                      no_stats, released);
+  }
+  const std::vector<uint8_t> stats =
+      EncodePass(lend, lag, cpu_used, width, height, VPX_RC_FIRST_PASS,
+                 no_stats, released);
+  // First pass frames are copied and handed back right away.
+  for (int i = 0; i < kLentFrames; ++i) {
+    EXPECT_EQ(lend ? 1 : 0, (*released)[i]) << "first pass frame " << i;
+    (*released)[i] = 0;
+  }
+  std::vector<uint8_t> out = stats;
+  const std::vector<uint8_t> stream = EncodePass(
+      lend, lag, cpu_used, width, height, VPX_RC_LAST_PASS, stats, released);
+  out.insert(out.end(), stream.begin(), stream.end());
+  return out;
+}
+
+// Images lent to the encoder are read in place, handed back exactly once and
+// give the same stream as images that are copied in. Speed 5 runs the RD intra
+// search on key frames, speed 8 the pickmode one. With lag, the lent frames
+// are filtered into alt-refs and searched by the temporal model.
+TEST(EncodeAPI, LentSourceFrames) {
+  static const int kConfigs[][4] = {
+    { 0, 8, 176, 144 }, { 0, 5, 176, 144 }, { 0, 5, 178, 142 },
+    { 0, 5, 250, 190 }, { 6, 2, 176, 144 }, { 6, 2, 178, 142 },
+    { 6, 0, 250, 190 }
+  };
+  for (size_t c = 0; c < sizeof(kConfigs) / sizeof(kConfigs[0]); ++c) {
+    const int lag = kConfigs[c][0];
+    const int cpu_used = kConfigs[c][1];
+    const int width = kConfigs[c][2];
+    const int height = kConfigs[c][3];
+    SCOPED_TRACE(testing::Message() << "lag " << lag << " cpu-used "
+                                    << cpu_used << " " << width << "x"
+                                    << height);
+    std::vector<int> released_copied(kLentFrames, 0);
+    std::vector<int> released_lent(kLentFrames, 0);
+    const std::vector<uint8_t> copied =
+        EncodeFrames(false, lag, cpu_used, width, height, &released_copied);
+    const std::vector<uint8_t> lent =
+        EncodeFrames(true, lag, cpu_used, width, height, &released_lent);
+    ASSERT_FALSE(copied.empty());
+    EXPECT_TRUE(copied == lent);
+    for (int i = 0; i < kLentFrames; ++i) {
+      EXPECT_EQ(0, released_copied[i]) << "frame " << i;
+      EXPECT_EQ(1, released_lent[i]) << "frame " << i;
+    }
+  }
+}
+
+// The stage counters cover one frame and fit in the time taken to encode it.
+TEST(EncodeAPI, Vp9FrameStageStats) {
+  const int kWidth = 176;
+  const int kHeight = 144;
+  vpx_codec_ctx_t enc;
+  vpx_codec_enc_cfg_t cfg;
+  vpx_image_t img;
+  vp9e_stage_stats_t stats;
+
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_config_default(vpx_codec_vp9_cx(), &cfg, 0));
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_threads = 1;
+  cfg.g_lag_in_frames = 0;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg, 0));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 4));
+  EXPECT_EQ(VPX_CODEC_ERROR,
+            vpx_codec_control(&enc, VP9E_GET_FRAME_STAGE_STATS, &stats));
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_control(&enc, VP9E_SET_FRAME_STAGE_STATS, 2));
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9E_SET_FRAME_STAGE_STATS, 1));
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_control(&enc, VP9E_GET_FRAME_STAGE_STATS,
+                              static_cast<vp9e_stage_stats_t *>(NULL)));
+
+  ASSERT_TRUE(vpx_img_alloc(&img, VPX_IMG_FMT_I420, kWidth, kHeight, 32) !=
+              NULL);
+  for (int i = 0; i < 4; ++i) {
+    FillFrame(&img, i);
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_encode(&enc, &img, i, 1, 0, VPX_DL_GOOD_QUALITY));
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&enc, VP9E_GET_FRAME_STAGE_STATS, &stats));
+    EXPECT_EQ(1, stats.num_threads) << "frame " << i;
+    EXPECT_GE(stats.encode_passes, 1) << "frame " << i;
+    EXPECT_GT(stats.frame_ticks, 0u) << "frame " << i;
+    EXPECT_GT(stats.stage_ticks[VP9E_STAGE_MODE_DECISION], 0u);
+    EXPECT_GT(stats.stage_ticks[VP9E_STAGE_BITSTREAM], 0u);
+    uint64_t sum = 0;
+    for (int s = 0; s < VP9E_ENCODER_STAGES; ++s) sum += stats.stage_ticks[s];
+    EXPECT_LE(sum, stats.frame_ticks) << "frame " << i;
+    EXPECT_LE(stats.thread_busy_ticks[0], stats.frame_ticks);
+  }
+  vpx_img_free(&img);
+
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9E_SET_FRAME_STAGE_STATS, 0));
+  EXPECT_EQ(VPX_CODEC_ERROR,
+            vpx_codec_control(&enc, VP9E_GET_FRAME_STAGE_STATS, &stats));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+}
+
+// With lag, images without a margin are copied and handed back right away, and
+// images are handed back when vpx_codec_encode() fails before the encoder
+// takes them.
+TEST(EncodeAPI, LentSourceErrors) {
+  const int kWidth = 176;
+  const int kHeight = 144;
+  vpx_codec_ctx_t enc;
+  vpx_codec_enc_cfg_t cfg;
+  vpx_image_t img;
+  vpx_image_t small_img;
+  std::vector<int> released(2, 0);
+  vpx_source_release_cb_t cb;
+  cb.release_source = ReleaseSource;
+  cb.user_priv = &released;
+
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_config_default(vpx_codec_vp9_cx(), &cfg, 0));
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_lag_in_frames = 10;
+  ASSERT_TRUE(vpx_img_alloc(&img, VPX_IMG_FMT_I420, kPaddedSize, kPaddedSize,
+                            32) != NULL);
+  ASSERT_EQ(0, vpx_img_set_rect(&img, 0, 0, kWidth, kHeight));
+  ASSERT_TRUE(vpx_img_alloc(&small_img, VPX_IMG_FMT_I420, kWidth / 2,
+                            kHeight / 2, 32) != NULL);
+  img.user_priv = reinterpret_cast<void *>(static_cast<intptr_t>(0));
+  small_img.user_priv = reinterpret_cast<void *>(static_cast<intptr_t>(1));
+  FillFrame(&img, 0);
+  FillFrame(&small_img, 0);
+
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg, 0));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9E_SET_SOURCE_RELEASE_CB, &cb));
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_encode(&enc, &img, 0, 1, 0, VPX_DL_GOOD_QUALITY));
+  EXPECT_EQ(1, released[0]);
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  EXPECT_EQ(1, released[0]);
+  released[0] = 0;
+
+  cfg.g_lag_in_frames = 0;
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg, 0));
+  ASSERT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9E_SET_SOURCE_RELEASE_CB, &cb));
+
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_encode(&enc, &img, 0, 1,
+                             VP8_EFLAG_NO_UPD_GF | VP8_EFLAG_FORCE_GF,
+                             VPX_DL_REALTIME));
+  EXPECT_EQ(1, released[0]);
+  EXPECT_NE(VPX_CODEC_OK, vpx_codec_encode(&enc, &small_img, 0, 1, 0,
+                                           VPX_DL_REALTIME));
+  EXPECT_EQ(1, released[1]);
+
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  EXPECT_EQ(1, released[0]);
+  EXPECT_EQ(1, released[1]);
+  vpx_img_free(&img);
+  vpx_img_free(&small_img);
+}
+#endif  // CONFIG_VP9_ENCODER
+
 }  // namespace
@@ -232,6 +232,15 @@ TEST_P(SixtapPredictTest, TestWithUnalignedDst) {
   TestWithUnalignedDst(vp8_sixtap_predict16x16_c);
 }
 
+TEST_P(SixtapPredictTest, DISABLED_Speed) {
+  const int kCountSpeedTestBlock = 5000000 / (width_ * height_);
+  RunNTimes(kCountSpeedTestBlock);
+
+  char title[16];
+  snprintf(title, sizeof(title), "%dx%d", width_, height_);
+  PrintMedian(title);
+}
+
 TEST_P(SixtapPredictTest, TestWithPresetData) {
   // Test input
   static const uint8_t kTestData[kSrcSize] = {
@@ -332,6 +341,11 @@ INSTANTIATE_TEST_CASE_P(
                       make_tuple(8, 4, &vp8_sixtap_predict8x4_ssse3),
                       make_tuple(4, 4, &vp8_sixtap_predict4x4_ssse3)));
 #endif
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, SixtapPredictTest,
+    ::testing::Values(make_tuple(16, 16, &vp8_sixtap_predict16x16_avx2)));
+#endif
 #if HAVE_MSA
 INSTANTIATE_TEST_CASE_P(
     MSA, SixtapPredictTest,
@@ -395,6 +409,11 @@ INSTANTIATE_TEST_CASE_P(
     ::testing::Values(make_tuple(16, 16, &vp8_bilinear_predict16x16_ssse3),
                       make_tuple(8, 8, &vp8_bilinear_predict8x8_ssse3)));
 #endif
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, BilinearPredictTest,
+    ::testing::Values(make_tuple(16, 16, &vp8_bilinear_predict16x16_avx2)));
+#endif
 #if HAVE_MSA
 INSTANTIATE_TEST_CASE_P(
     MSA, BilinearPredictTest,
@@ -201,6 +201,14 @@ INSTANTIATE_TEST_CASE_P(
                                  &vp8_regular_quantize_b_c)));
 #endif  // HAVE_SSE4_1
 
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, QuantizeTest,
+    ::testing::Values(
+        make_tuple(&vp8_fast_quantize_b_avx2, &vp8_fast_quantize_b_c),
+        make_tuple(&vp8_regular_quantize_b_avx2, &vp8_regular_quantize_b_c)));
+#endif  // HAVE_AVX2
+
 #if HAVE_NEON
 INSTANTIATE_TEST_CASE_P(NEON, QuantizeTest,
                         ::testing::Values(make_tuple(&vp8_fast_quantize_b_neon,
@@ -1022,12 +1022,16 @@ INSTANTIATE_TEST_CASE_P(AVX2, SADavgTest, ::testing::ValuesIn(avg_avx2_tests));
 const SadMxNx4Param x4d_avx2_tests[] = {
   SadMxNx4Param(64, 64, &vpx_sad64x64x4d_avx2),
   SadMxNx4Param(32, 32, &vpx_sad32x32x4d_avx2),
+  SadMxNx4Param(16, 16, &vpx_sad16x16x4d_avx2),
+  SadMxNx4Param(16, 8, &vpx_sad16x8x4d_avx2),
 };
 INSTANTIATE_TEST_CASE_P(AVX2, SADx4Test, ::testing::ValuesIn(x4d_avx2_tests));
 
 const SadMxNx8Param x8_avx2_tests[] = {
   // SadMxNx8Param(64, 64, &vpx_sad64x64x8_c),
   SadMxNx8Param(32, 32, &vpx_sad32x32x8_avx2),
+  SadMxNx8Param(16, 16, &vpx_sad16x16x8_avx2),
+  SadMxNx8Param(16, 8, &vpx_sad16x8x8_avx2),
 };
 INSTANTIATE_TEST_CASE_P(AVX2, SADx8Test, ::testing::ValuesIn(x8_avx2_tests));
 #endif  // HAVE_AVX2
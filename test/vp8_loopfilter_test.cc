@@ -0,0 +1,170 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+#include <tuple>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vp8_rtcd.h"
+#include "./vpx_config.h"
+#include "test/acm_random.h"
+#include "test/bench.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+#include "vp8/common/loopfilter.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+
+namespace {
+
+using libvpx_test::ACMRandom;
+
+// The macroblock sits at (16, 16) of the luma plane and (8, 8) of the chroma
+// planes so the filters can read and write across every edge they touch.
+const int kYStride = 48;
+const int kUVStride = 24;
+const int kYSize = kYStride * 48;
+const int kUVSize = kUVStride * 24;
+const int kYOffset = 16 * kYStride + 16;
+const int kUVOffset = 8 * kUVStride + 8;
+
+typedef void (*LoopFilterFunc)(unsigned char *y_ptr, unsigned char *u_ptr,
+                               unsigned char *v_ptr, int y_stride,
+                               int uv_stride, loop_filter_info *lfi);
+
+typedef std::tuple<LoopFilterFunc, LoopFilterFunc> LoopFilterParam;
+
+class VP8LoopFilterTest : public AbstractBench,
+                          public ::testing::TestWithParam<LoopFilterParam> {
+ protected:
+  virtual void SetUp() {
+    lf_ = GET_PARAM(0);
+    ref_lf_ = GET_PARAM(1);
+    rnd_.Reset(ACMRandom::DeterministicSeed());
+    lfi_.mblim = mblim_;
+    lfi_.blim = blim_;
+    lfi_.lim = lim_;
+    lfi_.hev_thr = hev_thr_;
+  }
+
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+  virtual void Run() {
+    lf_(y_ + kYOffset, u_ + kUVOffset, v_ + kUVOffset, kYStride, kUVStride,
+        &lfi_);
+  }
+
+  // Thresholds as vp8_loop_filter_update_sharpness() derives them.
+  void SetLevel(int level, int sharpness, int hev_threshold) {
+    int limit = level >> ((sharpness > 0) + (sharpness > 4));
+    if (sharpness > 0 && limit > 9 - sharpness) limit = 9 - sharpness;
+    if (limit < 1) limit = 1;
+    memset(mblim_, (level + 2) * 2 + limit, sizeof(mblim_));
+    memset(blim_, level * 2 + limit, sizeof(blim_));
+    memset(lim_, limit, sizeof(lim_));
+    memset(hev_thr_, hev_threshold, sizeof(hev_thr_));
+  }
+
+  // Pixels around a common base value. A small spread makes most edges pass
+  // the filter mask, a large one exercises the saturating paths.
+  void FillPlane(uint8_t *plane, int size, int base, int spread) {
+    for (int i = 0; i < size; ++i) {
+      const int p = base + rnd_(2 * spread + 1) - spread;
+      plane[i] = static_cast<uint8_t>(p < 0 ? 0 : (p > 255 ? 255 : p));
+    }
+  }
+
+  void RunComparison(int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+      const int base = rnd_.Rand8();
+      const int spread = 1 + rnd_((i % 4 == 0) ? 128 : 16);
+      const bool with_uv = (i % 4) != 1;
+      SetLevel(rnd_(64), rnd_(8), rnd_(4));
+      FillPlane(y_, kYSize, base, spread);
+      FillPlane(u_, kUVSize, base, spread);
+      FillPlane(v_, kUVSize, base, spread);
+      memcpy(ref_y_, y_, sizeof(y_));
+      memcpy(ref_u_, u_, sizeof(u_));
+      memcpy(ref_v_, v_, sizeof(v_));
+
+      ref_lf_(ref_y_ + kYOffset, with_uv ? ref_u_ + kUVOffset : NULL,
+              with_uv ? ref_v_ + kUVOffset : NULL, kYStride, kUVStride, &lfi_);
+      ASM_REGISTER_STATE_CHECK(lf_(y_ + kYOffset,
+                                   with_uv ? u_ + kUVOffset : NULL,
+                                   with_uv ? v_ + kUVOffset : NULL, kYStride,
+                                   kUVStride, &lfi_));
+
+      ASSERT_EQ(0, memcmp(ref_y_, y_, sizeof(y_))) << "y mismatch, i: " << i;
+      ASSERT_EQ(0, memcmp(ref_u_, u_, sizeof(u_))) << "u mismatch, i: " << i;
+      ASSERT_EQ(0, memcmp(ref_v_, v_, sizeof(v_))) << "v mismatch, i: " << i;
+    }
+  }
+
+  LoopFilterFunc lf_;
+  LoopFilterFunc ref_lf_;
+  ACMRandom rnd_;
+  loop_filter_info lfi_;
+  DECLARE_ALIGNED(16, uint8_t, mblim_[16]);
+  DECLARE_ALIGNED(16, uint8_t, blim_[16]);
+  DECLARE_ALIGNED(16, uint8_t, lim_[16]);
+  DECLARE_ALIGNED(16, uint8_t, hev_thr_[16]);
+  uint8_t y_[kYSize];
+  uint8_t u_[kUVSize];
+  uint8_t v_[kUVSize];
+  uint8_t ref_y_[kYSize];
+  uint8_t ref_u_[kUVSize];
+  uint8_t ref_v_[kUVSize];
+};
+
+TEST_P(VP8LoopFilterTest, MatchesReference) { RunComparison(10000); }
+
+TEST_P(VP8LoopFilterTest, DISABLED_Speed) {
+  SetLevel(32, 0, 2);
+  FillPlane(y_, kYSize, 128, 4);
+  FillPlane(u_, kUVSize, 128, 4);
+  FillPlane(v_, kUVSize, 128, 4);
+
+  RunNTimes(1000000);
+  PrintMedian("vp8 loop filter");
+}
+
+using std::make_tuple;
+
+INSTANTIATE_TEST_CASE_P(
+    C, VP8LoopFilterTest,
+    ::testing::Values(
+        make_tuple(&vp8_loop_filter_mbh_c, &vp8_loop_filter_mbh_c),
+        make_tuple(&vp8_loop_filter_bh_c, &vp8_loop_filter_bh_c),
+        make_tuple(&vp8_loop_filter_mbv_c, &vp8_loop_filter_mbv_c),
+        make_tuple(&vp8_loop_filter_bv_c, &vp8_loop_filter_bv_c)));
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(
+    SSE2, VP8LoopFilterTest,
+    ::testing::Values(
+        make_tuple(&vp8_loop_filter_mbh_sse2, &vp8_loop_filter_mbh_c),
+        make_tuple(&vp8_loop_filter_bh_sse2, &vp8_loop_filter_bh_c),
+        make_tuple(&vp8_loop_filter_mbv_sse2, &vp8_loop_filter_mbv_c),
+        make_tuple(&vp8_loop_filter_bv_sse2, &vp8_loop_filter_bv_c)));
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, VP8LoopFilterTest,
+    ::testing::Values(
+        make_tuple(&vp8_loop_filter_mbh_avx2, &vp8_loop_filter_mbh_c),
+        make_tuple(&vp8_loop_filter_bh_avx2, &vp8_loop_filter_bh_c),
+        make_tuple(&vp8_loop_filter_mbv_avx2, &vp8_loop_filter_mbv_c),
+        make_tuple(&vp8_loop_filter_bv_avx2, &vp8_loop_filter_bv_c)));
+#endif  // HAVE_AVX2
+
+}  // namespace
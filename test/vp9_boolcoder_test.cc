@@ -12,9 +12,22 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <memory>
+#include <vector>
+
 #include "third_party/googletest/src/include/gtest/gtest.h"
 
+#include "./vpx_config.h"
 #include "test/acm_random.h"
+#include "test/bench.h"
+#if CONFIG_WEBM_IO
+#include "test/webm_video_source.h"
+#endif
+#include "vp9/common/vp9_entropy.h"
+#include "vp9/common/vp9_onyxc_int.h"
+#include "vp9/common/vp9_scan.h"
+#include "vp9/decoder/vp9_decoder.h"
+#include "vp9/decoder/vp9_detokenize.h"
 #include "vpx/vpx_integer.h"
 #include "vpx_dsp/bitreader.h"
 #include "vpx_dsp/bitwriter.h"
@@ -87,3 +100,178 @@ TEST(VP9, TestBitIO) {
     }
   }
 }
+
+namespace {
+
+void XorDecrypt(void *decrypt_state, const uint8_t *input, uint8_t *output,
+                int count) {
+  const uint8_t key = *static_cast<const uint8_t *>(decrypt_state);
+  for (int i = 0; i < count; ++i) output[i] = input[i] ^ key;
+}
+
+}  // namespace
+
+// Reads buffers that end exactly where the writer stopped, so the last
+// refills take the end of buffer path, with and without decryption.
+TEST(VP9, TestBitIOExactSize) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  const int kMaxBits = 200;
+  uint8_t probas[kMaxBits];
+  int bits[kMaxBits];
+  uint8_t bw_buffer[kMaxBits];
+  uint8_t encrypted[kMaxBits];
+  uint8_t key = 0x5a;
+
+  for (int num_bits = 1; num_bits <= kMaxBits; ++num_bits) {
+    vpx_writer bw;
+    vpx_start_encode(&bw, bw_buffer);
+    for (int i = 0; i < num_bits; ++i) {
+      probas[i] = 1 + rnd(255);
+      bits[i] = rnd(2);
+      vpx_write(&bw, bits[i], probas[i]);
+    }
+    vpx_stop_encode(&bw);
+    for (unsigned int i = 0; i < bw.pos; ++i) encrypted[i] = bw_buffer[i] ^ key;
+
+    for (int decrypt = 0; decrypt <= 1; ++decrypt) {
+      vpx_reader br;
+      ASSERT_EQ(0, vpx_reader_init(&br, decrypt ? encrypted : bw_buffer, bw.pos,
+                                   decrypt ? XorDecrypt : NULL,
+                                   decrypt ? &key : NULL));
+      for (int i = 0; i < num_bits; ++i) {
+        ASSERT_EQ(bits[i], vpx_read(&br, probas[i]))
+            << "pos: " << i << " / " << num_bits << " decrypt: " << decrypt;
+      }
+      EXPECT_EQ(0, vpx_reader_has_error(&br)) << "num_bits: " << num_bits;
+    }
+  }
+}
+
+#if CONFIG_WEBM_IO
+namespace {
+
+// Reads the compressed frames of real streams, so the reader sees real entropy
+// coded data. The Speed test decodes them as bools with probabilities taken
+// from the coefficient Pareto table. TokenSpeed decodes them as coefficient
+// tokens with the default coefficient probabilities, cycling through the
+// transform sizes, which exercises the token tree and extra bit readers.
+class BoolDecoderSpeedTest : public AbstractBench,
+                             public ::testing::TestWithParam<const char *> {
+ protected:
+  virtual void SetUp() {
+    libvpx_test::WebMVideoSource video(GetParam());
+    video.Init();
+    for (video.Begin(); video.cxdata() != NULL; video.Next()) {
+      frames_.push_back(std::vector<uint8_t>(
+          video.cxdata(), video.cxdata() + video.frame_size()));
+    }
+    ASSERT_FALSE(frames_.empty()) << "Failed to read " << GetParam();
+    tokens_ = false;
+    checksum_ = 0;
+  }
+
+  virtual void Run() {
+    num_symbols_ = 0;
+    for (size_t f = 0; f < frames_.size(); ++f) {
+      if (tokens_) {
+        ReadTokens(frames_[f]);
+      } else {
+        ReadBools(frames_[f]);
+      }
+    }
+  }
+
+  void ReadBools(const std::vector<uint8_t> &frame) {
+    const vpx_prob *const probs = &vp9_pareto8_full[0][0];
+    const int num_probs = COEFF_PROB_MODELS * MODEL_NODES;
+    vpx_reader br;
+    int p = 0;
+    vpx_reader_init(&br, &frame[0], frame.size(), NULL, NULL);
+    while (!vpx_reader_has_error(&br)) {
+      checksum_ += vpx_read(&br, probs[p]);
+      if (++p == num_probs) p = 0;
+      ++num_symbols_;
+    }
+  }
+
+  void SetUpTokens() {
+    tokens_ = true;
+    twd_.reset(new TileWorkerData);
+    memset(twd_.get(), 0, sizeof(*twd_));
+    memset(&fc_, 0, sizeof(fc_));
+    memset(&cm_, 0, sizeof(cm_));
+    memset(&mi_, 0, sizeof(mi_));
+    memset(above_, 0, sizeof(above_));
+    memset(left_, 0, sizeof(left_));
+    cm_.fc = &fc_;
+    vp9_default_coef_probs(&cm_);
+    mi_ptr_ = &mi_;
+    mi_.ref_frame[0] = LAST_FRAME;
+    twd_->xd.fc = &fc_;
+    twd_->xd.mi = &mi_ptr_;
+#if CONFIG_VP9_HIGHBITDEPTH
+    twd_->xd.bd = 8;
+#endif
+    for (int plane = 0; plane < 2; ++plane) {
+      struct macroblockd_plane *const pd = &twd_->xd.plane[plane];
+      pd->dqcoeff = twd_->dqcoeff;
+      pd->seg_dequant[0][0] = 8;
+      pd->seg_dequant[0][1] = 12;
+      pd->above_context = above_;
+      pd->left_context = left_;
+    }
+  }
+
+  void ReadTokens(const std::vector<uint8_t> &frame) {
+    vpx_reader *const br = &twd_->bit_reader;
+    vpx_reader_init(br, &frame[0], frame.size(), NULL, NULL);
+    for (int k = 0; !vpx_reader_has_error(br); ++k) {
+      const TX_SIZE tx_size = static_cast<TX_SIZE>((k >> 1) & 3);
+      const scan_order *const sc = &vp9_default_scan_orders[tx_size];
+      const int eob = vp9_decode_block_tokens(
+          twd_.get(), k & 1, sc, (k * 8) & 15, (k * 4) & 15, tx_size, 0);
+      for (int i = 0; i < eob; ++i) {
+        checksum_ += static_cast<unsigned int>(twd_->dqcoeff[sc->scan[i]]);
+        twd_->dqcoeff[sc->scan[i]] = 0;
+      }
+      ++num_symbols_;
+    }
+  }
+
+  std::vector<std::vector<uint8_t> > frames_;
+  bool tokens_;
+  int64_t num_symbols_;
+  unsigned int checksum_;
+  std::unique_ptr<TileWorkerData> twd_;
+  FRAME_CONTEXT fc_;
+  VP9_COMMON cm_;
+  MODE_INFO mi_;
+  MODE_INFO *mi_ptr_;
+  ENTROPY_CONTEXT above_[32];
+  ENTROPY_CONTEXT left_[32];
+};
+
+TEST_P(BoolDecoderSpeedTest, DISABLED_Speed) {
+  RunNTimes(4);
+  printf("%s: %lld bools\n", GetParam(), static_cast<long long>(num_symbols_));
+  PrintMedian("vpx_read");
+}
+
+TEST_P(BoolDecoderSpeedTest, DISABLED_TokenSpeed) {
+  SetUpTokens();
+  RunNTimes(4);
+  printf("%s: %lld blocks\n", GetParam(),
+         static_cast<long long>(num_symbols_));
+  PrintMedian("vp9_decode_block_tokens");
+}
+
+const char *const kBoolDecoderSpeedVectors[] = {
+  "vp90-2-08-tile-4x4.webm", "vp90-2-02-size-lf-1920x1080.webm",
+  "vp90-2-20-big_superframe-01.webm"
+};
+
+INSTANTIATE_TEST_CASE_P(VP9, BoolDecoderSpeedTest,
+                        ::testing::ValuesIn(kBoolDecoderSpeedVectors));
+
+}  // namespace
+#endif  // CONFIG_WEBM_IO
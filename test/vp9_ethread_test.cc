@@ -229,6 +229,7 @@ class VPxEncoderThreadTest
     init_flags_ = VPX_CODEC_USE_PSNR;
     md5_.clear();
     row_mt_mode_ = 1;
+    tpl_mode_ = 1;
     psnr_ = 0.0;
     nframes_ = 0;
   }
@@ -274,6 +275,7 @@ class VPxEncoderThreadTest
         encoder->Control(VP9E_SET_AQ_MODE, 3);
       }
       encoder->Control(VP9E_SET_ROW_MT, row_mt_mode_);
+      encoder->Control(VP9E_SET_TPL, tpl_mode_);
 
       encoder_initialized_ = true;
     }
@@ -310,6 +312,7 @@ class VPxEncoderThreadTest
   ::libvpx_test::TestMode encoding_mode_;
   int set_cpu_used_;
   int row_mt_mode_;
+  int tpl_mode_;
   double psnr_;
   unsigned int nframes_;
   std::vector<std::string> md5_;
@@ -390,6 +393,51 @@ TEST_P(VPxEncoderThreadTest, EncoderResultTest) {
   EXPECT_NEAR(single_thr_psnr, multi_thr_psnr, 0.2);
 }
 
+// The TPL model is built by row jobs when row_mt_mode_ = 1. It must give the
+// same result as the single threaded pass, whatever the number of threads.
+TEST_P(VPxEncoderThreadTest, TplRowMtResultTest) {
+  // The model is only built for the ARFs of two-pass good quality encodes.
+  if (encoding_mode_ != ::libvpx_test::kTwoPassGood) return;
+
+  ::libvpx_test::Y4mVideoSource video("niklas_1280_720_30.y4m", 15, 20);
+  cfg_.rc_target_bitrate = 1000;
+  init_flags_ = VPX_CODEC_USE_PSNR;
+
+  // The model changes the encode, which shows that it is built below.
+  tpl_mode_ = 0;
+  row_mt_mode_ = 0;
+  cfg_.g_threads = 1;
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  const std::vector<std::string> no_tpl_md5 = md5_;
+  md5_.clear();
+
+  // Single threaded model vs the model built by one row-mt worker.
+  tpl_mode_ = 1;
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  const std::vector<std::string> single_thr_md5 = md5_;
+  md5_.clear();
+  ASSERT_NE(no_tpl_md5, single_thr_md5);
+
+  row_mt_mode_ = 1;
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  const std::vector<std::string> row_mt_single_thr_md5 = md5_;
+  md5_.clear();
+  ASSERT_EQ(single_thr_md5, row_mt_single_thr_md5);
+
+  // With row-mt the rest of the encode is bit exact from 2 threads on, so any
+  // difference comes from the rows of the model being split between threads.
+  cfg_.g_threads = 2;
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  const std::vector<std::string> row_mt_two_thr_md5 = md5_;
+  md5_.clear();
+
+  cfg_.g_threads = threads_;
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  const std::vector<std::string> row_mt_multi_thr_md5 = md5_;
+  md5_.clear();
+  ASSERT_EQ(row_mt_two_thr_md5, row_mt_multi_thr_md5);
+}
+
 INSTANTIATE_TEST_CASE_P(
     VP9, VPxFirstPassEncoderThreadTest,
     ::testing::Combine(
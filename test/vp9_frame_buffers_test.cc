@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2020 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+#include "vp9/common/vp9_frame_buffers.h"
+
+namespace {
+
+class VP9FrameBuffersTest : public ::testing::TestWithParam<int> {
+ protected:
+  virtual void SetUp() {
+    memset(&list_, 0, sizeof(list_));
+    ASSERT_EQ(0, vp9_alloc_internal_frame_buffers(&list_));
+    list_.prefault = GetParam() & 1;
+    list_.use_huge_pages = (GetParam() >> 1) & 1;
+  }
+
+  virtual void TearDown() { vp9_free_internal_frame_buffers(&list_); }
+
+  InternalFrameBufferList list_;
+};
+
+TEST_P(VP9FrameBuffersTest, RecycleAcrossSizes) {
+  const size_t kLarge = 1920 * 1080 * 3 / 2;
+  const size_t kSmall = 640 * 360 * 3 / 2;
+  vpx_codec_frame_buffer_t fb[2];
+
+  ASSERT_EQ(0, vp9_get_frame_buffer(&list_, kLarge, &fb[0]));
+  EXPECT_GE(fb[0].size, kLarge);
+  // The size class leaves at most 25% unused.
+  EXPECT_LE(fb[0].size, kLarge + kLarge / 4 + (GetParam() & 2 ? 2 << 20 : 0));
+  for (size_t i = 0; i < kLarge; ++i) ASSERT_EQ(0, fb[0].data[i]);
+  ASSERT_EQ(0, vp9_release_frame_buffer(&list_, &fb[0]));
+  EXPECT_EQ(1u, list_.num_allocs);
+  EXPECT_EQ(fb[0].size, list_.bytes_allocated);
+
+  // A smaller frame reuses the free buffer.
+  ASSERT_EQ(0, vp9_get_frame_buffer(&list_, kSmall, &fb[0]));
+  EXPECT_EQ(1u, list_.num_allocs);
+  EXPECT_EQ(1u, list_.num_recycles);
+
+  // The next one needs a buffer of its own.
+  ASSERT_EQ(0, vp9_get_frame_buffer(&list_, kSmall, &fb[1]));
+  EXPECT_EQ(2u, list_.num_allocs);
+  EXPECT_LT(fb[1].size, fb[0].size);
+  ASSERT_EQ(0, vp9_release_frame_buffer(&list_, &fb[0]));
+  ASSERT_EQ(0, vp9_release_frame_buffer(&list_, &fb[1]));
+
+  // The smallest buffer that fits is used, leaving the large one free.
+  ASSERT_EQ(0, vp9_get_frame_buffer(&list_, kSmall, &fb[0]));
+  ASSERT_EQ(0, vp9_get_frame_buffer(&list_, kLarge, &fb[1]));
+  EXPECT_EQ(2u, list_.num_allocs);
+  EXPECT_EQ(3u, list_.num_recycles);
+  ASSERT_EQ(0, vp9_release_frame_buffer(&list_, &fb[0]));
+  ASSERT_EQ(0, vp9_release_frame_buffer(&list_, &fb[1]));
+}
+
+TEST_P(VP9FrameBuffersTest, AllBuffersInUse) {
+  vpx_codec_frame_buffer_t fb;
+  for (int i = 0; i < list_.num_internal_frame_buffers; ++i) {
+    ASSERT_EQ(0, vp9_get_frame_buffer(&list_, 4096, &fb));
+  }
+  EXPECT_EQ(-1, vp9_get_frame_buffer(&list_, 4096, &fb));
+}
+
+// Default, prefault, huge pages.
+INSTANTIATE_TEST_CASE_P(C, VP9FrameBuffersTest, ::testing::Values(0, 1, 2));
+
+}  // namespace
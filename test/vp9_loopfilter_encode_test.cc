@@ -0,0 +1,238 @@
+/*
+ *  Copyright (c) 2020 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "test/acm_random.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/video_source.h"
+
+namespace {
+
+const int kWidth = 352;
+const int kHeight = 288;
+
+// Frames of a gradient that brightens by 5 levels a frame.
+class GradientVideoSource : public ::libvpx_test::DummyVideoSource {
+ public:
+  GradientVideoSource() { SetSize(kWidth, kHeight); }
+
+ protected:
+  virtual void FillFrame() {
+    if (!img_) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? (img_->d_w + 1) >> 1 : img_->d_w;
+      const int h = plane ? (img_->d_h + 1) >> 1 : img_->d_h;
+      for (int r = 0; r < h; ++r) {
+        uint8_t *const row = img_->planes[plane] + r * img_->stride[plane];
+        for (int c = 0; c < w; ++c) {
+          row[c] = static_cast<uint8_t>(
+              (r * 3 + c * (plane + 1) + frame_ * 5) & 0xff);
+        }
+      }
+    }
+  }
+};
+
+// Gradient frames overlaid with blocks and noise, so that key frames coded at
+// a high quantizer need filtering.
+class BlockyVideoSource : public GradientVideoSource {
+ public:
+  BlockyVideoSource() : rnd_(libvpx_test::ACMRandom::DeterministicSeed()) {}
+
+  virtual void Begin() {
+    rnd_.Reset(libvpx_test::ACMRandom::DeterministicSeed());
+    GradientVideoSource::Begin();
+  }
+
+ protected:
+  virtual void FillFrame() {
+    if (!img_) return;
+    GradientVideoSource::FillFrame();
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? (img_->d_w + 1) >> 1 : img_->d_w;
+      const int h = plane ? (img_->d_h + 1) >> 1 : img_->d_h;
+      for (int r = 0; r < h; ++r) {
+        uint8_t *const row = img_->planes[plane] + r * img_->stride[plane];
+        for (int c = 0; c < w; ++c) {
+          row[c] = static_cast<uint8_t>(((r / 12 + c / 20) & 1) * 96 +
+                                        (row[c] >> 2) + (rnd_.Rand8() >> 5));
+        }
+      }
+    }
+  }
+
+  libvpx_test::ACMRandom rnd_;
+};
+
+class LoopFilterPipelineTest : public ::libvpx_test::EncoderTest,
+                               public ::testing::Test {
+ protected:
+  LoopFilterPipelineTest()
+      : EncoderTest(&::libvpx_test::kVP9), pipeline_(0), row_mt_(0),
+        encoding_(false) {}
+  virtual ~LoopFilterPipelineTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libvpx_test::kOnePassGood);
+    cfg_.g_threads = 2;
+    cfg_.g_lag_in_frames = 0;
+  }
+
+  virtual void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                                  ::libvpx_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, 4);
+      encoder->Control(VP9E_SET_LOOPFILTER_PIPELINE, pipeline_);
+      encoder->Control(VP9E_SET_ROW_MT, row_mt_);
+    }
+    encoding_ = video->img() != NULL;
+  }
+
+  // Reads the reconstruction while a pipelined loop filter may still run.
+  virtual void PostEncodeFrameHook(::libvpx_test::Encoder *encoder) {
+    if (!encoding_) return;
+    vp9_ref_frame_t ref;
+    ref.idx = 0;
+    encoder->Control(VP9_GET_REFERENCE, &ref);
+    libvpx_test::MD5 md5;
+    md5.Add(&ref.img);
+    recon_.push_back(md5.Get());
+  }
+
+  virtual void FramePktHook(const vpx_codec_cx_pkt_t *pkt) {
+    const uint8_t *const buf = static_cast<uint8_t *>(pkt->data.frame.buf);
+    stream_.insert(stream_.end(), buf, buf + pkt->data.frame.sz);
+  }
+
+  void Encode(int pipeline, int row_mt) {
+    GradientVideoSource video;
+    video.set_limit(10);
+    pipeline_ = pipeline;
+    row_mt_ = row_mt;
+    stream_.clear();
+    recon_.clear();
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  }
+
+  void ExpectSameOutput(int row_mt) {
+    ASSERT_NO_FATAL_FAILURE(Encode(0, row_mt));
+    const std::vector<uint8_t> stream = stream_;
+    const std::vector<std::string> recon = recon_;
+    ASSERT_NO_FATAL_FAILURE(Encode(1, row_mt));
+    ASSERT_FALSE(stream.empty());
+    EXPECT_TRUE(stream == stream_);
+    ASSERT_EQ(recon.size(), recon_.size());
+    for (size_t i = 0; i < recon.size(); ++i) {
+      EXPECT_EQ(recon[i], recon_[i]) << "frame " << i;
+    }
+  }
+
+  int pipeline_;
+  int row_mt_;
+  bool encoding_;
+  std::vector<uint8_t> stream_;
+  std::vector<std::string> recon_;
+};
+
+// Filtering the reconstruction on its own thread changes neither the stream
+// nor the reconstruction handed out by VP9_GET_REFERENCE.
+TEST_F(LoopFilterPipelineTest, MatchesSerialLoopFilter) {
+  ExpectSameOutput(0);
+}
+
+// With row based multi-threading, the encoder workers filter the frame and the
+// option is ignored.
+TEST_F(LoopFilterPipelineTest, MatchesRowMtLoopFilter) { ExpectSameOutput(1); }
+
+// Codes key frames at rising quantizers and keeps the luma PSNR and the loop
+// filter level of each.
+class SampledLpfPickTest : public ::libvpx_test::EncoderTest,
+                           public ::testing::Test {
+ protected:
+  SampledLpfPickTest()
+      : EncoderTest(&::libvpx_test::kVP9), sampled_lpf_pick_(0),
+        encoding_(false) {}
+  virtual ~SampledLpfPickTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libvpx_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = VPX_Q;
+    init_flags_ = VPX_CODEC_USE_PSNR;
+    frame_flags_ = VPX_EFLAG_FORCE_KF;
+  }
+
+  virtual void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                                  ::libvpx_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, 4);
+      encoder->Control(VP9E_SET_SAMPLED_LPF_PICK, sampled_lpf_pick_);
+    }
+    encoding_ = video->img() != NULL;
+    if (encoding_) encoder->Control(VP8E_SET_CQ_LEVEL, 36 + 5 * video->frame());
+  }
+
+  virtual void PostEncodeFrameHook(::libvpx_test::Encoder *encoder) {
+    if (!encoding_) return;
+    int level = -1;
+    encoder->Control(VP9E_GET_LOOPFILTER_LEVEL, &level);
+    levels_.push_back(level);
+  }
+
+  virtual void PSNRPktHook(const vpx_codec_cx_pkt_t *pkt) {
+    psnr_.push_back(pkt->data.psnr.psnr[1]);
+  }
+
+  void Encode(int sampled_lpf_pick) {
+    BlockyVideoSource video;
+    video.set_limit(6);
+    sampled_lpf_pick_ = sampled_lpf_pick;
+    levels_.clear();
+    psnr_.clear();
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  }
+
+  int sampled_lpf_pick_;
+  bool encoding_;
+  std::vector<int> levels_;
+  std::vector<double> psnr_;
+};
+
+// Only the loop filter level differs between the two encodes of each key
+// frame. The level picked from sampled rows may differ from the full search
+// where the error is flat around the minimum, but must filter the frame about
+// as well.
+TEST_F(SampledLpfPickTest, FiltersAsWellAsFullSearch) {
+  ASSERT_NO_FATAL_FAILURE(Encode(0));
+  const std::vector<int> full_levels = levels_;
+  const std::vector<double> full = psnr_;
+  ASSERT_NO_FATAL_FAILURE(Encode(1));
+  ASSERT_EQ(6u, full.size());
+  ASSERT_EQ(full.size(), psnr_.size());
+  ASSERT_EQ(full.size(), levels_.size());
+  int filtered_frames = 0;
+  for (size_t i = 0; i < full.size(); ++i) {
+    filtered_frames += full_levels[i] > 0;
+    EXPECT_LE(abs(full_levels[i] - levels_[i]), 8) << "frame " << i;
+    EXPECT_GT(psnr_[i], full[i] - 0.05) << "frame " << i;
+  }
+  EXPECT_GE(filtered_frames, 4);
+}
+
+}  // namespace
@@ -0,0 +1,257 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vp9_rtcd.h"
+#include "./vpx_config.h"
+#include "test/acm_random.h"
+#include "test/bench.h"
+#include "test/clear_system_state.h"
+#include "test/md5_helper.h"
+#include "test/register_state_check.h"
+#include "vp9/encoder/vp9_resize.h"
+#include "vpx/vpx_integer.h"
+
+namespace {
+
+using libvpx_test::ACMRandom;
+
+const int kTaps = 8;
+const int kMaxLength = 256;
+// Samples the kernels may read before and after the input row.
+const int kPad = 8;
+
+typedef void (*ResizeHorzFunc)(const uint8_t *input, const int *pos,
+                               const int16_t *const *filter, uint8_t *output,
+                               int length);
+typedef void (*ResizeVertFunc)(const uint8_t *const *rows,
+                               const int16_t *filter, uint8_t *output,
+                               int width);
+
+// Filters whose taps sum to 128 like the resize filters, with taps up to the
+// 128 of the full-band integer position filter.
+void RandomFilter(ACMRandom *rnd, int16_t *filter) {
+  int sum = 0;
+  for (int k = 0; k < kTaps; ++k) {
+    filter[k] = static_cast<int16_t>((*rnd)(49) - 24);
+    sum += filter[k];
+  }
+  filter[3 + (*rnd)(2)] += static_cast<int16_t>(128 - sum);
+}
+
+class ResizeHorzTest : public AbstractBench,
+                       public ::testing::TestWithParam<ResizeHorzFunc> {
+ protected:
+  virtual void SetUp() {
+    func_ = GetParam();
+    rnd_.Reset(ACMRandom::DeterministicSeed());
+  }
+
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+  virtual void Run() {
+    func_(input_ + kPad, pos_, filter_ptrs_, output_, kMaxLength);
+  }
+
+  // Every output gets its own filter and a window starting anywhere from
+  // kPad / 2 samples before the row to kPad / 2 before its end.
+  void FillRandom(int in_length, int out_length) {
+    for (int i = 0; i < in_length + 2 * kPad; ++i) input_[i] = rnd_.Rand8();
+    for (int o = 0; o < out_length; ++o) {
+      pos_[o] = static_cast<int>(rnd_(in_length + 1)) - kPad / 2;
+      RandomFilter(&rnd_, filters_[o]);
+      filter_ptrs_[o] = filters_[o];
+    }
+  }
+
+  ResizeHorzFunc func_;
+  ACMRandom rnd_;
+  uint8_t input_[kMaxLength + 2 * kPad];
+  int pos_[kMaxLength];
+  int16_t filters_[kMaxLength][kTaps];
+  const int16_t *filter_ptrs_[kMaxLength];
+  uint8_t output_[kMaxLength + 16];
+};
+
+TEST_P(ResizeHorzTest, MatchesReference) {
+  uint8_t ref[kMaxLength + 16];
+  for (int i = 0; i < 1000; ++i) {
+    const int in_length = 1 + rnd_(kMaxLength);
+    const int out_length = 1 + rnd_(kMaxLength);
+    FillRandom(in_length, out_length);
+    memset(ref, 0xa5, sizeof(ref));
+    memset(output_, 0xa5, sizeof(output_));
+    vp9_resize_horz_8tap_c(input_ + kPad, pos_, filter_ptrs_, ref, out_length);
+    ASM_REGISTER_STATE_CHECK(
+        func_(input_ + kPad, pos_, filter_ptrs_, output_, out_length));
+    ASSERT_EQ(0, memcmp(ref, output_, sizeof(ref)))
+        << "i: " << i << " in: " << in_length << " out: " << out_length;
+  }
+}
+
+TEST_P(ResizeHorzTest, DISABLED_Speed) {
+  FillRandom(kMaxLength, kMaxLength);
+  RunNTimes(100000);
+  PrintMedian("resize horizontal 8-tap");
+}
+
+class ResizeVertTest : public AbstractBench,
+                       public ::testing::TestWithParam<ResizeVertFunc> {
+ protected:
+  virtual void SetUp() {
+    func_ = GetParam();
+    rnd_.Reset(ACMRandom::DeterministicSeed());
+  }
+
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+  virtual void Run() { func_(rows_, filter_, output_, kMaxLength); }
+
+  // Rows may repeat, as they do where the filter is clamped to the plane.
+  void FillRandom() {
+    for (int i = 0; i < kTaps * kMaxLength; ++i) input_[i] = rnd_.Rand8();
+    for (int k = 0; k < kTaps; ++k) {
+      const int row = (k > 0 && rnd_(4) == 0) ? rnd_(k) : k;
+      rows_[k] = input_ + row * kMaxLength;
+    }
+    RandomFilter(&rnd_, filter_);
+  }
+
+  ResizeVertFunc func_;
+  ACMRandom rnd_;
+  uint8_t input_[kTaps * kMaxLength];
+  const uint8_t *rows_[kTaps];
+  int16_t filter_[kTaps];
+  uint8_t output_[kMaxLength + 32];
+};
+
+TEST_P(ResizeVertTest, MatchesReference) {
+  uint8_t ref[kMaxLength + 32];
+  for (int i = 0; i < 1000; ++i) {
+    const int width = 1 + rnd_(kMaxLength);
+    FillRandom();
+    memset(ref, 0xa5, sizeof(ref));
+    memset(output_, 0xa5, sizeof(output_));
+    vp9_resize_vert_8tap_c(rows_, filter_, ref, width);
+    ASM_REGISTER_STATE_CHECK(func_(rows_, filter_, output_, width));
+    ASSERT_EQ(0, memcmp(ref, output_, sizeof(ref)))
+        << "i: " << i << " width: " << width;
+  }
+}
+
+TEST_P(ResizeVertTest, DISABLED_Speed) {
+  FillRandom();
+  RunNTimes(200000);
+  PrintMedian("resize vertical 8-tap");
+}
+
+// Splitting the passes into interleaved row stripes and column blocks, as the
+// encoder's workers do, must give the same plane as a single pass.
+TEST(ResizePlaneTest, SplitMatchesWhole) {
+  static const int kSizes[][4] = {
+    { 352, 288, 176, 144 }, { 320, 180, 480, 270 }, { 200, 150, 67, 49 },
+    { 130, 99, 130, 33 },   { 97, 65, 97, 65 },     { 64, 48, 10, 300 },
+  };
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  for (size_t s = 0; s < sizeof(kSizes) / sizeof(kSizes[0]); ++s) {
+    const int width = kSizes[s][0];
+    const int height = kSizes[s][1];
+    const int width2 = kSizes[s][2];
+    const int height2 = kSizes[s][3];
+    const int in_stride = width + 5;
+    const int out_stride = width2 + 3;
+    uint8_t *const input = new uint8_t[in_stride * height];
+    uint8_t *const ref = new uint8_t[out_stride * height2];
+    uint8_t *const output = new uint8_t[out_stride * height2];
+    for (int i = 0; i < in_stride * height; ++i) input[i] = rnd.Rand8();
+    memset(ref, 0, out_stride * height2);
+    memset(output, 0, out_stride * height2);
+
+    vp9_resize_plane(input, height, width, in_stride, ref, height2, width2,
+                     out_stride);
+    for (int workers = 2; workers <= 4; ++workers) {
+      ResizePlaneJob job;
+      ASSERT_NE(0, vp9_resize_plane_job_init(&job, input, height, width,
+                                             in_stride, output, height2,
+                                             width2, out_stride));
+      for (int w = workers - 1; w >= 0; --w)
+        vp9_resize_plane_rows(&job, w, workers);
+      for (int w = 0; w < workers; ++w) vp9_resize_plane_cols(&job, w, workers);
+      vp9_resize_plane_job_free(&job);
+      ASSERT_EQ(0, memcmp(ref, output, out_stride * height2))
+          << width << "x" << height << " -> " << width2 << "x" << height2
+          << " workers: " << workers;
+      memset(output, 0, out_stride * height2);
+    }
+
+    delete[] input;
+    delete[] ref;
+    delete[] output;
+  }
+}
+
+// The md5s were produced by vp9_resize_plane() before it was tiled and
+// vectorized, so any change to the output is caught.
+TEST(ResizePlaneTest, MatchesOldImplementation) {
+  static const struct {
+    int width, height, width2, height2;
+    const char *md5;
+  } kPlanes[] = {
+    { 352, 288, 176, 144, "bf21fcfca8cbc4044ef597c107c14f14" },
+    { 320, 180, 480, 270, "384e8f21e84098fe649bb4bbe393bd48" },
+    { 200, 150, 67, 49, "1b1b1ebb341d26edb1f0cd31a9541765" },
+    { 130, 99, 130, 33, "f67386a8b7f1cc0b5fca14631d1b432f" },
+    { 64, 48, 10, 300, "1937ecfff5b5bd3cb962fa10cdd4b3b6" },
+  };
+  for (size_t p = 0; p < sizeof(kPlanes) / sizeof(kPlanes[0]); ++p) {
+    const int width = kPlanes[p].width;
+    const int height = kPlanes[p].height;
+    const int width2 = kPlanes[p].width2;
+    const int height2 = kPlanes[p].height2;
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    uint8_t *const input = new uint8_t[width * height];
+    uint8_t *const output = new uint8_t[width2 * height2];
+    for (int i = 0; i < width * height; ++i) input[i] = rnd.Rand8();
+
+    vp9_resize_plane(input, height, width, width, output, height2, width2,
+                     width2);
+    libvpx_test::MD5 md5;
+    md5.Add(output, width2 * height2);
+    EXPECT_STREQ(kPlanes[p].md5, md5.Get())
+        << width << "x" << height << " -> " << width2 << "x" << height2;
+
+    delete[] input;
+    delete[] output;
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(C, ResizeHorzTest,
+                        ::testing::Values(&vp9_resize_horz_8tap_c));
+INSTANTIATE_TEST_CASE_P(C, ResizeVertTest,
+                        ::testing::Values(&vp9_resize_vert_8tap_c));
+
+#if HAVE_SSE4_1
+INSTANTIATE_TEST_CASE_P(SSE4_1, ResizeHorzTest,
+                        ::testing::Values(&vp9_resize_horz_8tap_sse4_1));
+INSTANTIATE_TEST_CASE_P(SSE4_1, ResizeVertTest,
+                        ::testing::Values(&vp9_resize_vert_8tap_sse4_1));
+#endif  // HAVE_SSE4_1
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, ResizeHorzTest,
+                        ::testing::Values(&vp9_resize_horz_8tap_avx2));
+INSTANTIATE_TEST_CASE_P(AVX2, ResizeVertTest,
+                        ::testing::Values(&vp9_resize_vert_8tap_avx2));
+#endif  // HAVE_AVX2
+
+}  // namespace
@@ -18,6 +18,8 @@
 #if CONFIG_WEBM_IO
 #include "test/webm_video_source.h"
 #endif
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
 #include "vpx_util/vpx_thread.h"
 
 namespace {
@@ -127,6 +129,67 @@ TEST_P(VPxWorkerThreadTest, EndWithoutSync) {
   }
 }
 
+#if CONFIG_MULTITHREAD
+TEST(VPxWorkerThreadTest, PoolWorkers) {
+  static const int kNumWorkers = 16;
+  VPxWorkerPool *const pool = vpx_worker_pool_create(3);
+  ASSERT_TRUE(pool != NULL);
+  VPxWorker workers[kNumWorkers];
+  int hook_data[kNumWorkers];
+  int return_value[kNumWorkers];
+
+  for (int n = 0; n < kNumWorkers; ++n) {
+    vpx_get_worker_interface()->init(&workers[n]);
+    workers[n].pool = pool;
+    EXPECT_NE(vpx_get_worker_interface()->reset(&workers[n]), 0);
+    return_value[n] = n & 1;
+    workers[n].hook = ThreadHook;
+    workers[n].data1 = &hook_data[n];
+    workers[n].data2 = &return_value[n];
+  }
+
+  // More jobs than threads are queued.
+  for (int i = 0; i < 2; ++i) {
+    for (int n = 0; n < kNumWorkers; ++n) {
+      hook_data[n] = 0;
+      vpx_get_worker_interface()->launch(&workers[n]);
+    }
+    for (int n = 0; n < kNumWorkers; ++n) {
+      EXPECT_EQ(n & 1, vpx_get_worker_interface()->sync(&workers[n]));
+      EXPECT_EQ(5, hook_data[n]);
+    }
+  }
+
+  for (int n = 0; n < kNumWorkers; ++n) {
+    vpx_get_worker_interface()->end(&workers[n]);
+  }
+  vpx_worker_pool_destroy(pool);
+}
+
+TEST(VPxWorkerThreadTest, PoolReserve) {
+  VPxWorkerPool *const pool = vpx_worker_pool_create(5);
+  ASSERT_TRUE(pool != NULL);
+
+  // A single client may use all the threads.
+  vpx_worker_pool_add_client(pool);
+  EXPECT_EQ(5, vpx_worker_pool_reserve(pool, 8));
+  EXPECT_EQ(0, vpx_worker_pool_reserve(pool, 1));
+  vpx_worker_pool_release(pool, 5);
+
+  // Otherwise each one gets its share, rounded up.
+  vpx_worker_pool_add_client(pool);
+  EXPECT_EQ(3, vpx_worker_pool_reserve(pool, 8));
+  EXPECT_EQ(2, vpx_worker_pool_reserve(pool, 8));
+  vpx_worker_pool_release(pool, 3);
+  EXPECT_EQ(1, vpx_worker_pool_reserve(pool, 1));
+  vpx_worker_pool_release(pool, 3);
+
+  vpx_worker_pool_remove_client(pool);
+  vpx_worker_pool_remove_client(pool);
+  vpx_worker_pool_destroy(pool);
+}
+#endif  // CONFIG_MULTITHREAD
+
 TEST(VPxWorkerThreadTest, TestInterfaceAPI) {
   EXPECT_EQ(0, vpx_set_worker_interface(NULL));
   EXPECT_TRUE(vpx_get_worker_interface() != NULL);
@@ -154,13 +217,17 @@ struct FileList {
 };
 
 // Decodes |filename| with |num_threads|. Returns the md5 of the decoded frames.
-string DecodeFile(const string &filename, int num_threads) {
+string DecodeFile(const string &filename, int num_threads,
+                  bool frame_parallel = false,
+                  vpx_codec_thread_pool_t *pool = NULL) {
   libvpx_test::WebMVideoSource video(filename);
   video.Init();
 
   vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
   cfg.threads = num_threads;
   libvpx_test::VP9Decoder decoder(cfg, 0);
+  if (frame_parallel) decoder.Control(VP9D_SET_FRAME_PARALLEL, 1);
+  if (pool != NULL) decoder.Control(VP9D_SET_THREAD_POOL, pool);
 
   libvpx_test::MD5 md5;
   for (video.Begin(); video.cxdata(); video.Next()) {
@@ -179,19 +246,80 @@ string DecodeFile(const string &filename, int num_threads) {
       md5.Add(img);
     }
   }
+
+  // Frames still in flight are output once the decoder is flushed.
+  if (frame_parallel) {
+    const vpx_codec_err_t res = decoder.DecodeFrame(NULL, 0);
+    EXPECT_EQ(VPX_CODEC_OK, res) << decoder.DecodeError();
+
+    libvpx_test::DxDataIterator dec_iter = decoder.GetDxData();
+    const vpx_image_t *img = NULL;
+    while ((img = dec_iter.Next())) {
+      md5.Add(img);
+    }
+  }
   return string(md5.Get());
 }
 
-void DecodeFiles(const FileList files[]) {
+void DecodeFiles(const FileList files[], bool frame_parallel = false,
+                 vpx_codec_thread_pool_t *pool = NULL) {
   for (const FileList *iter = files; iter->name != NULL; ++iter) {
     SCOPED_TRACE(iter->name);
     for (int t = 1; t <= 8; ++t) {
-      EXPECT_EQ(iter->expected_md5, DecodeFile(iter->name, t))
+      EXPECT_EQ(iter->expected_md5,
+                DecodeFile(iter->name, t, frame_parallel, pool))
           << "threads = " << t;
     }
   }
 }
 
+void PutFrame(void *user_priv, const vpx_image_t *img) {
+  static_cast<libvpx_test::MD5 *>(user_priv)->Add(img);
+}
+
+void AddFrames(vpx_codec_ctx_t *decoder, libvpx_test::MD5 *md5) {
+  vpx_codec_iter_t iter = NULL;
+  const vpx_image_t *img = NULL;
+  while ((img = vpx_codec_get_frame(decoder, &iter))) md5->Add(img);
+}
+
+// Decodes |filename| with VPX_CODEC_USE_ASYNC and |num_threads|, taking the
+// frames from the put_frame callback or by polling for them. Returns the md5
+// of the decoded frames.
+string DecodeFileAsync(const string &filename, int num_threads,
+                       bool put_frame) {
+  libvpx_test::WebMVideoSource video(filename);
+  video.Init();
+
+  vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+  cfg.threads = num_threads;
+  vpx_codec_ctx_t decoder;
+  libvpx_test::MD5 md5;
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_dec_init(&decoder, &vpx_codec_vp9_dx_algo,
+                                             &cfg, VPX_CODEC_USE_ASYNC));
+  if (put_frame) {
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_register_put_frame_cb(&decoder, PutFrame, &md5));
+  }
+
+  for (video.Begin(); video.cxdata(); video.Next()) {
+    const vpx_codec_err_t res = vpx_codec_decode(
+        &decoder, video.cxdata(), video.frame_size(), NULL, 0);
+    if (res != VPX_CODEC_OK) {
+      EXPECT_EQ(VPX_CODEC_OK, res) << vpx_codec_error_detail(&decoder);
+      break;
+    }
+    // Only the frames already decoded are returned.
+    if (!put_frame) AddFrames(&decoder, &md5);
+  }
+
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_decode(&decoder, NULL, 0, NULL, 0));
+  if (!put_frame) AddFrames(&decoder, &md5);
+
+  vpx_codec_destroy(&decoder);
+  return string(md5.Get());
+}
+
 // Trivial serialized thread worker interface implementation.
 // Note any worker that requires synchronization between other workers will
 // hang.
@@ -232,6 +360,62 @@ TEST(VPxWorkerThreadTest, TestSerialInterface) {
   EXPECT_EQ(expected_md5, DecodeFile(filename, 2));
 }
 
+#if CONFIG_VP9_POSTPROC
+// Decodes |filename| with |num_threads| and the post-processing in |pp|.
+// Returns the md5 of the post-processed frames.
+string DecodeFilePostProc(const string &filename, int num_threads,
+                          vp8_postproc_cfg_t pp) {
+  libvpx_test::WebMVideoSource video(filename);
+  video.Init();
+
+  vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+  cfg.threads = num_threads;
+  libvpx_test::VP9Decoder decoder(cfg, VPX_CODEC_USE_POSTPROC);
+  decoder.Control(VP8_SET_POSTPROC, &pp);
+
+  libvpx_test::MD5 md5;
+  for (video.Begin(); video.cxdata(); video.Next()) {
+    const vpx_codec_err_t res =
+        decoder.DecodeFrame(video.cxdata(), video.frame_size());
+    if (res != VPX_CODEC_OK) {
+      EXPECT_EQ(VPX_CODEC_OK, res) << decoder.DecodeError();
+      break;
+    }
+
+    libvpx_test::DxDataIterator dec_iter = decoder.GetDxData();
+    const vpx_image_t *img = NULL;
+    while ((img = dec_iter.Next())) {
+      md5.Add(img);
+    }
+  }
+  return string(md5.Get());
+}
+
+// Post-processing is split between the decoder's workers, which must give the
+// same frames as a single thread.
+TEST(VP9DecodeMultiThreadedTest, PostProc) {
+  static const char *const kFiles[] = { "vp90-2-03-size-226x226.webm",
+                                        "vp90-2-08-tile-4x1.webm" };
+  static const vp8_postproc_cfg_t kConfigs[] = {
+    { VP8_DEBLOCK, 4, 0 },
+    { VP8_DEBLOCK | VP8_DEMACROBLOCK, 8, 0 },
+    { VP8_MFQE, 0, 0 },
+    { VP8_DEBLOCK | VP8_DEMACROBLOCK | VP8_MFQE, 15, 0 },
+  };
+  for (size_t f = 0; f < sizeof(kFiles) / sizeof(kFiles[0]); ++f) {
+    SCOPED_TRACE(kFiles[f]);
+    for (size_t c = 0; c < sizeof(kConfigs) / sizeof(kConfigs[0]); ++c) {
+      const string expected_md5 =
+          DecodeFilePostProc(kFiles[f], 1, kConfigs[c]);
+      for (int t = 2; t <= 4; ++t) {
+        EXPECT_EQ(expected_md5, DecodeFilePostProc(kFiles[f], t, kConfigs[c]))
+            << "flags = " << kConfigs[c].post_proc_flag << " threads = " << t;
+      }
+    }
+  }
+}
+#endif  // CONFIG_VP9_POSTPROC
+
 TEST(VP9DecodeMultiThreadedTest, NoTilesNonFrameParallel) {
   // no tiles or frame parallel; this exercises loop filter threading.
   EXPECT_EQ("b35a1b707b28e82be025d960aba039bc",
@@ -302,6 +486,41 @@ TEST(VP9DecodeMultiThreadedTest, FrameParallelResize) {
   DecodeFiles(files);
 }
 
+TEST(VP9DecodeMultiThreadedTest, FrameParallelDecode) {
+  static const FileList files[] = {
+    { "vp90-2-03-size-226x226.webm", "b35a1b707b28e82be025d960aba039bc" },
+    { "vp90-2-08-tile_1x2_frame_parallel.webm",
+      "68ede6abd66bae0a2edf2eb9232241b6" },
+    { "vp90-2-08-tile_1x4.webm", "988d86049e884c66909d2d163a09841a" },
+    { "vp90-2-08-tile-4x4.webm", "85c2299892460d76e2c600502d52bfe2" },
+    { "vp90-2-14-resize-fp-tiles-16-8-4-2-1.webm",
+      "eecf17290739bc708506fa4827665989" },
+    { NULL, NULL }
+  };
+
+  DecodeFiles(files, true);
+}
+
+TEST(VP9DecodeMultiThreadedTest, AsyncDecode) {
+  static const FileList files[] = {
+    { "vp90-2-03-size-226x226.webm", "b35a1b707b28e82be025d960aba039bc" },
+    { "vp90-2-08-tile_1x4.webm", "988d86049e884c66909d2d163a09841a" },
+    { "vp90-2-14-resize-fp-tiles-16-8-4-2-1.webm",
+      "eecf17290739bc708506fa4827665989" },
+    { NULL, NULL }
+  };
+
+  for (const FileList *iter = files; iter->name != NULL; ++iter) {
+    SCOPED_TRACE(iter->name);
+    for (int t = 1; t <= 8; ++t) {
+      EXPECT_EQ(iter->expected_md5, DecodeFileAsync(iter->name, t, false))
+          << "threads = " << t;
+      EXPECT_EQ(iter->expected_md5, DecodeFileAsync(iter->name, t, true))
+          << "threads = " << t << " put_frame";
+    }
+  }
+}
+
 TEST(VP9DecodeMultiThreadedTest, NonFrameParallel) {
   static const FileList files[] = {
     { "vp90-2-08-tile_1x2.webm", "570b4a5d5a70d58b5359671668328a16" },
@@ -314,6 +533,23 @@ TEST(VP9DecodeMultiThreadedTest, NonFrameParallel) {
 
   DecodeFiles(files);
 }
+
+#if CONFIG_MULTITHREAD
+TEST(VP9DecodeMultiThreadedTest, SharedThreadPool) {
+  static const FileList files[] = {
+    { "vp90-2-03-size-226x226.webm", "b35a1b707b28e82be025d960aba039bc" },
+    { "vp90-2-08-tile_1x4.webm", "988d86049e884c66909d2d163a09841a" },
+    { "vp90-2-08-tile_1x8.webm", "0941902a52e9092cb010905eab16364c" },
+    { NULL, NULL }
+  };
+  // Fewer threads than the decoder asks for.
+  vpx_codec_thread_pool_t *const pool = vpx_codec_thread_pool_create(3);
+  ASSERT_TRUE(pool != NULL);
+
+  DecodeFiles(files, false, pool);
+  vpx_codec_thread_pool_destroy(pool);
+}
+#endif  // CONFIG_MULTITHREAD
 #endif  // CONFIG_WEBM_IO
 
 INSTANTIATE_TEST_CASE_P(Synchronous, VPxWorkerThreadTest, ::testing::Bool());
@@ -346,6 +346,63 @@ vpxenc_vp9_webm_2pass() {
   fi
 }
 
+# Compares a two pass encode using a chunked first pass against the serial
+# first pass. A single chunk and the number of first pass threads must not
+# change the output; smaller chunks must stay within 5% of the serial size.
+vpxenc_vp9_ivf_2pass_fp_chunks() {
+  if [ "$(vpxenc_can_encode_vp9)" = "yes" ]; then
+    local output="${VPX_TEST_OUTPUT_DIR}/vp9_fp_chunks"
+    local limit=20
+    local serial_size=0
+    local chunked_size=0
+
+    vpxenc $(yuv_input_hantro_collage) \
+      --codec=vp9 \
+      --limit="${limit}" \
+      --ivf \
+      --output="${output}_serial.ivf" \
+      --passes=2
+
+    vpxenc $(yuv_input_hantro_collage) \
+      --codec=vp9 \
+      --limit="${limit}" \
+      --ivf \
+      --output="${output}_whole.ivf" \
+      --passes=2 \
+      --fp-chunk-frames="${limit}"
+
+    if ! cmp -s "${output}_serial.ivf" "${output}_whole.ivf"; then
+      elog "A single first pass chunk changed the output."
+      return 1
+    fi
+
+    for threads in 1 3; do
+      vpxenc $(yuv_input_hantro_collage) \
+        --codec=vp9 \
+        --limit="${limit}" \
+        --ivf \
+        --output="${output}_${threads}.ivf" \
+        --passes=2 \
+        --fp-chunk-frames=6 \
+        --fp-threads="${threads}"
+    done
+
+    if ! cmp -s "${output}_1.ivf" "${output}_3.ivf"; then
+      elog "The number of first pass threads changed the output."
+      return 1
+    fi
+
+    serial_size=$(stat -c '%s' "${output}_serial.ivf")
+    chunked_size=$(stat -c '%s' "${output}_1.ivf")
+    if [ $((chunked_size * 100)) -lt $((serial_size * 95)) ] || \
+       [ $((chunked_size * 100)) -gt $((serial_size * 105)) ]; then
+      elog "Chunked first pass output size is not within 5% of serial."
+      echo "${chunked_size}" " vs " "${serial_size}"
+      return 1
+    fi
+  fi
+}
+
 vpxenc_vp9_ivf_lossless() {
   if [ "$(vpxenc_can_encode_vp9)" = "yes" ]; then
     local output="${VPX_TEST_OUTPUT_DIR}/vp9_lossless.ivf"
@@ -481,7 +538,8 @@ if [ "$(vpx_config_option_enabled CONFIG_REALTIME_ONLY)" != "yes" ]; then
   vpxenc_tests="$vpxenc_tests
                 vpxenc_vp8_webm_2pass
                 vpxenc_vp8_webm_lag10_frames20
-                vpxenc_vp9_webm_2pass"
+                vpxenc_vp9_webm_2pass
+                vpxenc_vp9_ivf_2pass_fp_chunks"
 fi
 
 run_tests vpxenc_verify_environment "${vpxenc_tests}"
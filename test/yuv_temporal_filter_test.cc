@@ -704,5 +704,11 @@ INSTANTIATE_TEST_CASE_P(SSE4_1, YUVTemporalFilterTest,
                         ::testing::Values(TemporalFilterWithBd(
                             &vp9_apply_temporal_filter_sse4_1, 8)));
 #endif  // HAVE_SSE4_1
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, YUVTemporalFilterTest,
+                        ::testing::Values(TemporalFilterWithBd(
+                            &vp9_apply_temporal_filter_avx2, 8)));
+#endif  // HAVE_AVX2
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 }  // namespace
@@ -0,0 +1,59 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "vp8/common/threading.h"
+
+#if CONFIG_OS_SUPPORT && CONFIG_MULTITHREAD
+
+#if VP8_ROW_SYNC_FUTEX
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+void vp8_row_sync_block(int mb_col,
+                        const vpx_atomic_int *last_row_current_mb_col,
+                        int nsync, vpx_atomic_int *sleepers) {
+  /* Registering before the check below means a writer that stores a new
+   * value after it will see the sleeper and wake the futex, and one that
+   * stored before it leaves a value the check sees.
+   */
+  vpx_atomic_fetch_add(sleepers, 1);
+  for (;;) {
+    const int col = vpx_atomic_load_acquire(last_row_current_mb_col);
+    if (mb_col <= col - nsync) break;
+    /* Returns at once if the row has moved on since it was read. */
+    syscall(SYS_futex, &last_row_current_mb_col->value, FUTEX_WAIT_PRIVATE,
+            col, NULL, NULL, 0);
+  }
+  vpx_atomic_fetch_add(sleepers, -1);
+}
+
+void vp8_row_sync_wake(vpx_atomic_int *current_mb_col) {
+  syscall(SYS_futex, &current_mb_col->value, FUTEX_WAKE_PRIVATE, INT_MAX,
+          NULL, NULL, 0);
+}
+#else
+void vp8_row_sync_block(int mb_col,
+                        const vpx_atomic_int *last_row_current_mb_col,
+                        int nsync, vpx_atomic_int *sleepers) {
+  (void)sleepers;
+  while (mb_col > vpx_atomic_load_acquire(last_row_current_mb_col) - nsync) {
+    x86_pause_hint();
+    thread_sleep(0);
+  }
+}
+
+void vp8_row_sync_wake(vpx_atomic_int *current_mb_col) {
+  (void)current_mb_col;
+}
+#endif  // VP8_ROW_SYNC_FUTEX
+
+#endif  // CONFIG_OS_SUPPORT && CONFIG_MULTITHREAD
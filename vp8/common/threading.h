@@ -191,16 +191,63 @@ static inline int sem_destroy(sem_t *sem) {
 #define x86_pause_hint()
 #endif
 
+#include "vpx_dsp/vpx_dsp_common.h"
 #include "vpx_util/vpx_thread.h"
 #include "vpx_util/vpx_atomics.h"
 
-static INLINE void vp8_atomic_spin_wait(
-    int mb_col, const vpx_atomic_int *last_row_current_mb_col,
-    const int nsync) {
-  while (mb_col > (vpx_atomic_load_acquire(last_row_current_mb_col) - nsync)) {
+/* Row progress is published in one vpx_atomic_int per macroblock row. A
+ * thread waiting on the row above spins for a while, then blocks until the
+ * row is written. On Linux it sleeps in a futex on the progress word, and
+ * 'sleepers' counts the blocked threads so that writers only make a system
+ * call when someone may be waiting. Elsewhere it yields in a loop.
+ */
+#if defined(__linux__)
+#define VP8_ROW_SYNC_FUTEX 1
+#else
+#define VP8_ROW_SYNC_FUTEX 0
+#endif
+
+/* Spin budget of a waiting thread, in pause hints. It grows when the row
+ * above arrives while spinning and halves whenever the thread blocks.
+ */
+#define VP8_ROW_SYNC_MIN_SPINS 16
+#define VP8_ROW_SYNC_INIT_SPINS 1024
+#define VP8_ROW_SYNC_MAX_SPINS 4096
+
+void vp8_row_sync_block(int mb_col,
+                        const vpx_atomic_int *last_row_current_mb_col,
+                        int nsync, vpx_atomic_int *sleepers);
+void vp8_row_sync_wake(vpx_atomic_int *current_mb_col);
+
+/* Publishes 'value' as the progress of a row and wakes its waiters. */
+static INLINE void vp8_row_sync_write(vpx_atomic_int *current_mb_col,
+                                      int value, vpx_atomic_int *sleepers) {
+  vpx_atomic_store_release(current_mb_col, value);
+#if VP8_ROW_SYNC_FUTEX
+  /* The read-modify-write orders the store before the check, pairing with
+   * the increment in vp8_row_sync_block().
+   */
+  if (vpx_atomic_fetch_add(sleepers, 0) != 0) vp8_row_sync_wake(current_mb_col);
+#else
+  (void)sleepers;
+#endif
+}
+
+/* Waits until the row above is 'nsync' macroblocks ahead of 'mb_col'. */
+static INLINE void vp8_row_sync_wait(
+    int mb_col, const vpx_atomic_int *last_row_current_mb_col, int nsync,
+    vpx_atomic_int *sleepers, int *spin_limit) {
+  int spins;
+  for (spins = 0; spins < *spin_limit; ++spins) {
+    if (mb_col <= vpx_atomic_load_acquire(last_row_current_mb_col) - nsync) {
+      if (spins * 2 > *spin_limit)
+        *spin_limit = VPXMIN(spins * 2, VP8_ROW_SYNC_MAX_SPINS);
+      return;
+    }
     x86_pause_hint();
-    thread_sleep(0);
   }
+  *spin_limit = VPXMAX(*spin_limit >> 1, VP8_ROW_SYNC_MIN_SPINS);
+  vp8_row_sync_block(mb_col, last_row_current_mb_col, nsync, sleepers);
 }
 
 #endif /* CONFIG_OS_SUPPORT && CONFIG_MULTITHREAD */
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <immintrin.h>  // AVX2
+
+#include "./vp8_rtcd.h"
+#include "./vpx_config.h"
+#include "vp8/common/filter.h"
+#include "vpx_ports/mem.h"
+
+// Both passes round back to [0, 255], so the intermediate rows are kept as
+// bytes and every pass is a single _mm256_maddubs_epi16 per 16 pixels. The
+// taps of a non-zero offset are at most 112 and fit the signed byte operand.
+static INLINE __m256i bilinear_taps(int offset) {
+  const short *filter = vp8_bilinear_filters[offset];
+  return _mm256_set1_epi16((short)((filter[1] << 8) | filter[0]));
+}
+
+static INLINE __m256i load_2x16(const uint8_t *lo, const uint8_t *hi) {
+  const __m128i a = _mm_loadu_si128((const __m128i *)lo);
+  const __m128i b = _mm_loadu_si128((const __m128i *)hi);
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(a), b, 1);
+}
+
+// Returns row a in the low lane and row b in the high lane, each filtered
+// from the byte pairs (a[i], a1[i]) and (b[i], b1[i]).
+static INLINE __m256i filter_2x16(__m256i ab, __m256i ab1, __m256i taps) {
+  const __m256i round = _mm256_set1_epi16(1 << (VP8_FILTER_SHIFT - 1));
+  __m256i lo = _mm256_maddubs_epi16(_mm256_unpacklo_epi8(ab, ab1), taps);
+  __m256i hi = _mm256_maddubs_epi16(_mm256_unpackhi_epi8(ab, ab1), taps);
+  lo = _mm256_srli_epi16(_mm256_add_epi16(lo, round), VP8_FILTER_SHIFT);
+  hi = _mm256_srli_epi16(_mm256_add_epi16(hi, round), VP8_FILTER_SHIFT);
+  return _mm256_packus_epi16(lo, hi);
+}
+
+static void horizontal_16xn(const uint8_t *src, int src_stride, uint8_t *dst,
+                            int dst_stride, int height, int xoffset) {
+  const __m256i taps = bilinear_taps(xoffset);
+  int h;
+
+  for (h = 0; h + 2 <= height; h += 2) {
+    const __m256i ab = load_2x16(src, src + src_stride);
+    const __m256i ab1 = load_2x16(src + 1, src + src_stride + 1);
+    const __m256i out = filter_2x16(ab, ab1, taps);
+    _mm_storeu_si128((__m128i *)dst, _mm256_castsi256_si128(out));
+    _mm_storeu_si128((__m128i *)(dst + dst_stride),
+                     _mm256_extracti128_si256(out, 1));
+    src += 2 * src_stride;
+    dst += 2 * dst_stride;
+  }
+
+  if (h < height) {
+    const __m256i aa = load_2x16(src, src);
+    const __m256i aa1 = load_2x16(src + 1, src + 1);
+    const __m256i out = filter_2x16(aa, aa1, taps);
+    _mm_storeu_si128((__m128i *)dst, _mm256_castsi256_si128(out));
+  }
+}
+
+static void vertical_16x16(const uint8_t *src, int src_stride, uint8_t *dst,
+                           int dst_stride, int yoffset) {
+  const __m256i taps = bilinear_taps(yoffset);
+  int h;
+
+  for (h = 0; h < 16; h += 2) {
+    const __m256i ab = load_2x16(src, src + src_stride);
+    const __m256i ab1 = load_2x16(src + src_stride, src + 2 * src_stride);
+    const __m256i out = filter_2x16(ab, ab1, taps);
+    _mm_storeu_si128((__m128i *)dst, _mm256_castsi256_si128(out));
+    _mm_storeu_si128((__m128i *)(dst + dst_stride),
+                     _mm256_extracti128_si256(out, 1));
+    src += 2 * src_stride;
+    dst += 2 * dst_stride;
+  }
+}
+
+void vp8_bilinear_predict16x16_avx2(uint8_t *src_ptr, int src_pixels_per_line,
+                                    int xoffset, int yoffset, uint8_t *dst_ptr,
+                                    int dst_pitch) {
+  DECLARE_ALIGNED(32, uint8_t, FData[16 * 17]);
+
+  assert((xoffset | yoffset) != 0);
+
+  if (yoffset == 0) {
+    horizontal_16xn(src_ptr, src_pixels_per_line, dst_ptr, dst_pitch, 16,
+                    xoffset);
+  } else if (xoffset == 0) {
+    vertical_16x16(src_ptr, src_pixels_per_line, dst_ptr, dst_pitch, yoffset);
+  } else {
+    horizontal_16xn(src_ptr, src_pixels_per_line, FData, 16, 17, xoffset);
+    vertical_16x16(FData, 16, dst_ptr, dst_pitch, yoffset);
+  }
+}
@@ -0,0 +1,407 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vp8_rtcd.h"
+#include "./vpx_config.h"
+#include "vp8/common/loopfilter.h"
+#include "vpx_ports/mem.h"
+
+// The low 128-bit lane of every register carries 16 luma pixels and the high
+// lane carries 8 U pixels followed by 8 V pixels, so one pass filters the
+// edge of all three planes of a macroblock. s[0..7] are p3 p2 p1 p0 q0 q1 q2
+// q3 across the edge.
+
+static INLINE __m256i abs_diff(__m256i a, __m256i b) {
+  return _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+}
+
+// Arithmetic right shift of signed bytes.
+static INLINE __m256i sra_epi8(__m256i x, const int n) {
+  const __m256i lo = _mm256_srai_epi16(_mm256_unpacklo_epi8(x, x), 8 + n);
+  const __m256i hi = _mm256_srai_epi16(_mm256_unpackhi_epi8(x, x), 8 + n);
+  return _mm256_packs_epi16(lo, hi);
+}
+
+// Returns 0xff for every pixel where the edge is filtered and sets *hev to
+// 0xff where the edge has high variance.
+static INLINE __m256i filter_mask(const __m256i *s, const __m256i blimit,
+                                  const __m256i limit, const __m256i thresh,
+                                  __m256i *hev) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i ap1p0 = abs_diff(s[2], s[3]);
+  const __m256i aq1q0 = abs_diff(s[5], s[4]);
+  const __m256i ap0q0 = abs_diff(s[3], s[4]);
+  const __m256i ap1q1 = abs_diff(s[2], s[5]);
+  const __m256i h = _mm256_max_epu8(ap1p0, aq1q0);
+  __m256i m, e;
+
+  m = _mm256_max_epu8(abs_diff(s[0], s[1]), abs_diff(s[1], s[2]));
+  m = _mm256_max_epu8(m, abs_diff(s[6], s[5]));
+  m = _mm256_max_epu8(m, abs_diff(s[7], s[6]));
+  m = _mm256_max_epu8(m, h);
+
+  // abs(p0 - q0) * 2 + abs(p1 - q1) / 2. blimit never exceeds 255, so the
+  // saturating adds do not change the comparison.
+  e = _mm256_srli_epi16(_mm256_and_si256(ap1q1, _mm256_set1_epi8((char)0xfe)),
+                        1);
+  e = _mm256_adds_epu8(_mm256_adds_epu8(ap0q0, ap0q0), e);
+
+  *hev = _mm256_xor_si256(
+      _mm256_cmpeq_epi8(_mm256_subs_epu8(h, thresh), zero),
+      _mm256_cmpeq_epi8(zero, zero));
+  return _mm256_cmpeq_epi8(
+      _mm256_or_si256(_mm256_subs_epu8(m, limit), _mm256_subs_epu8(e, blimit)),
+      zero);
+}
+
+// filter_value = clamp(clamp(ps1 - qs1) + 3 * (qs0 - ps0)) on signed pixels.
+static INLINE __m256i filter_value(__m256i ps1, __m256i ps0, __m256i qs0,
+                                   __m256i qs1, __m256i outer) {
+  const __m256i d = _mm256_subs_epi8(qs0, ps0);
+  __m256i f = _mm256_and_si256(_mm256_subs_epi8(ps1, qs1), outer);
+  f = _mm256_adds_epi8(f, d);
+  f = _mm256_adds_epi8(f, d);
+  return _mm256_adds_epi8(f, d);
+}
+
+static INLINE void normal_filter(__m256i *s, const __m256i mask,
+                                 const __m256i hev) {
+  const __m256i t80 = _mm256_set1_epi8((char)0x80);
+  __m256i ps1 = _mm256_xor_si256(s[2], t80);
+  __m256i ps0 = _mm256_xor_si256(s[3], t80);
+  __m256i qs0 = _mm256_xor_si256(s[4], t80);
+  __m256i qs1 = _mm256_xor_si256(s[5], t80);
+  __m256i f, f1, f2;
+
+  f = _mm256_and_si256(filter_value(ps1, ps0, qs0, qs1, hev), mask);
+  f1 = sra_epi8(_mm256_adds_epi8(f, _mm256_set1_epi8(4)), 3);
+  f2 = sra_epi8(_mm256_adds_epi8(f, _mm256_set1_epi8(3)), 3);
+  qs0 = _mm256_subs_epi8(qs0, f1);
+  ps0 = _mm256_adds_epi8(ps0, f2);
+
+  // Outer tap adjustments where the variance is low.
+  f = sra_epi8(_mm256_adds_epi8(f1, _mm256_set1_epi8(1)), 1);
+  f = _mm256_andnot_si256(hev, f);
+  qs1 = _mm256_subs_epi8(qs1, f);
+  ps1 = _mm256_adds_epi8(ps1, f);
+
+  s[2] = _mm256_xor_si256(ps1, t80);
+  s[3] = _mm256_xor_si256(ps0, t80);
+  s[4] = _mm256_xor_si256(qs0, t80);
+  s[5] = _mm256_xor_si256(qs1, t80);
+}
+
+// clamp((63 + f * k) >> 7) for signed bytes f.
+static INLINE __m256i mb_tap(const __m256i f_lo, const __m256i f_hi,
+                             const int k) {
+  const __m256i kk = _mm256_set1_epi16(k);
+  const __m256i r = _mm256_set1_epi16(63);
+  const __m256i lo = _mm256_srai_epi16(
+      _mm256_add_epi16(_mm256_mullo_epi16(f_lo, kk), r), 7);
+  const __m256i hi = _mm256_srai_epi16(
+      _mm256_add_epi16(_mm256_mullo_epi16(f_hi, kk), r), 7);
+  return _mm256_packs_epi16(lo, hi);
+}
+
+static INLINE void mb_filter(__m256i *s, const __m256i mask,
+                             const __m256i hev) {
+  const __m256i t80 = _mm256_set1_epi8((char)0x80);
+  __m256i ps2 = _mm256_xor_si256(s[1], t80);
+  __m256i ps1 = _mm256_xor_si256(s[2], t80);
+  __m256i ps0 = _mm256_xor_si256(s[3], t80);
+  __m256i qs0 = _mm256_xor_si256(s[4], t80);
+  __m256i qs1 = _mm256_xor_si256(s[5], t80);
+  __m256i qs2 = _mm256_xor_si256(s[6], t80);
+  __m256i f, f1, f2, f_lo, f_hi, u;
+
+  f = filter_value(ps1, ps0, qs0, qs1, _mm256_cmpeq_epi8(t80, t80));
+  f = _mm256_and_si256(f, mask);
+
+  // High edge variance: adjust p0 and q0 only.
+  f2 = _mm256_and_si256(f, hev);
+  f1 = sra_epi8(_mm256_adds_epi8(f2, _mm256_set1_epi8(4)), 3);
+  f2 = sra_epi8(_mm256_adds_epi8(f2, _mm256_set1_epi8(3)), 3);
+  qs0 = _mm256_subs_epi8(qs0, f1);
+  ps0 = _mm256_adds_epi8(ps0, f2);
+
+  // Otherwise apply the wide filter with 27/128, 18/128 and 9/128 weights.
+  f = _mm256_andnot_si256(hev, f);
+  f_lo = _mm256_srai_epi16(_mm256_unpacklo_epi8(f, f), 8);
+  f_hi = _mm256_srai_epi16(_mm256_unpackhi_epi8(f, f), 8);
+
+  u = mb_tap(f_lo, f_hi, 27);
+  qs0 = _mm256_subs_epi8(qs0, u);
+  ps0 = _mm256_adds_epi8(ps0, u);
+  u = mb_tap(f_lo, f_hi, 18);
+  qs1 = _mm256_subs_epi8(qs1, u);
+  ps1 = _mm256_adds_epi8(ps1, u);
+  u = mb_tap(f_lo, f_hi, 9);
+  qs2 = _mm256_subs_epi8(qs2, u);
+  ps2 = _mm256_adds_epi8(ps2, u);
+
+  s[1] = _mm256_xor_si256(ps2, t80);
+  s[2] = _mm256_xor_si256(ps1, t80);
+  s[3] = _mm256_xor_si256(ps0, t80);
+  s[4] = _mm256_xor_si256(qs0, t80);
+  s[5] = _mm256_xor_si256(qs1, t80);
+  s[6] = _mm256_xor_si256(qs2, t80);
+}
+
+static INLINE void filter_edge(__m256i *s, const __m256i blimit,
+                               const __m256i limit, const __m256i thresh,
+                               const __m256i lanes, int mb) {
+  __m256i hev;
+  const __m256i mask =
+      _mm256_and_si256(filter_mask(s, blimit, limit, thresh, &hev), lanes);
+  if (mb) {
+    mb_filter(s, mask, hev);
+  } else {
+    normal_filter(s, mask, hev);
+  }
+}
+
+// Row r of the luma block in the low lane and row r of U and V in the high
+// lane. Without chroma the high lane is left zero; the callers mask it out.
+static INLINE __m256i load_row(const uint8_t *y, const uint8_t *u,
+                               const uint8_t *v, int r, int y_stride,
+                               int uv_stride) {
+  const __m128i yy = _mm_loadu_si128((const __m128i *)(y + r * y_stride));
+  __m128i uv = _mm_setzero_si128();
+  if (u) {
+    uv = _mm_unpacklo_epi64(
+        _mm_loadl_epi64((const __m128i *)(u + r * uv_stride)),
+        _mm_loadl_epi64((const __m128i *)(v + r * uv_stride)));
+  }
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(yy), uv, 1);
+}
+
+static INLINE void store_row(uint8_t *y, uint8_t *u, uint8_t *v, int r,
+                             int y_stride, int uv_stride, const __m256i x) {
+  _mm_storeu_si128((__m128i *)(y + r * y_stride), _mm256_castsi256_si128(x));
+  if (u) {
+    const __m128i uv = _mm256_extracti128_si256(x, 1);
+    _mm_storel_epi64((__m128i *)(u + r * uv_stride), uv);
+    _mm_storel_epi64((__m128i *)(v + r * uv_stride), _mm_srli_si128(uv, 8));
+  }
+}
+
+static INLINE __m256i load_thresh(const unsigned char *p) {
+  return _mm256_set1_epi8((char)p[0]);
+}
+
+static INLINE __m256i lane_mask(int both) {
+  return both ? _mm256_set1_epi8((char)0xff)
+              : _mm256_inserti128_si256(_mm256_set1_epi8((char)0xff),
+                                        _mm_setzero_si128(), 1);
+}
+
+// Transposes, in each lane, the low 8 bytes of 16 rows into 8 columns of 16
+// bytes.
+static INLINE void transpose_16x8(const __m256i *in, __m256i *out) {
+  __m256i a[8], b[8], c[8];
+  int i;
+
+  for (i = 0; i < 8; ++i) a[i] = _mm256_unpacklo_epi8(in[2 * i], in[2 * i + 1]);
+  for (i = 0; i < 4; ++i) {
+    b[i] = _mm256_unpacklo_epi16(a[2 * i], a[2 * i + 1]);
+    b[i + 4] = _mm256_unpackhi_epi16(a[2 * i], a[2 * i + 1]);
+  }
+  // c[k] holds columns 2k and 2k + 1 of rows 0-7 for k < 4 and of rows 8-15
+  // for k >= 4.
+  c[0] = _mm256_unpacklo_epi32(b[0], b[1]);
+  c[1] = _mm256_unpackhi_epi32(b[0], b[1]);
+  c[2] = _mm256_unpacklo_epi32(b[4], b[5]);
+  c[3] = _mm256_unpackhi_epi32(b[4], b[5]);
+  c[4] = _mm256_unpacklo_epi32(b[2], b[3]);
+  c[5] = _mm256_unpackhi_epi32(b[2], b[3]);
+  c[6] = _mm256_unpacklo_epi32(b[6], b[7]);
+  c[7] = _mm256_unpackhi_epi32(b[6], b[7]);
+  for (i = 0; i < 4; ++i) {
+    out[2 * i] = _mm256_unpacklo_epi64(c[i], c[i + 4]);
+    out[2 * i + 1] = _mm256_unpackhi_epi64(c[i], c[i + 4]);
+  }
+}
+
+// Inverse of transpose_16x8: 8 columns of 16 bytes become 16 rows of 8
+// bytes, returned in pairs with row 2k in the low and row 2k + 1 in the high
+// 8 bytes of out[k].
+static INLINE void transpose_8x16(const __m256i *in, __m256i *out) {
+  __m256i a[8], b[8];
+  int i;
+
+  for (i = 0; i < 4; ++i) {
+    a[i] = _mm256_unpacklo_epi8(in[2 * i], in[2 * i + 1]);
+    a[i + 4] = _mm256_unpackhi_epi8(in[2 * i], in[2 * i + 1]);
+  }
+  // b[0..3]: rows 0-3, 4-7, 8-11 and 12-15 of columns 0-3; b[4..7] the same
+  // rows of columns 4-7.
+  b[0] = _mm256_unpacklo_epi16(a[0], a[1]);
+  b[1] = _mm256_unpackhi_epi16(a[0], a[1]);
+  b[2] = _mm256_unpacklo_epi16(a[4], a[5]);
+  b[3] = _mm256_unpackhi_epi16(a[4], a[5]);
+  b[4] = _mm256_unpacklo_epi16(a[2], a[3]);
+  b[5] = _mm256_unpackhi_epi16(a[2], a[3]);
+  b[6] = _mm256_unpacklo_epi16(a[6], a[7]);
+  b[7] = _mm256_unpackhi_epi16(a[6], a[7]);
+  for (i = 0; i < 4; ++i) {
+    out[2 * i] = _mm256_unpacklo_epi32(b[i], b[i + 4]);
+    out[2 * i + 1] = _mm256_unpackhi_epi32(b[i], b[i + 4]);
+  }
+}
+
+static INLINE void store_row_pair(uint8_t *y, uint8_t *u, uint8_t *v, int r,
+                                  int y_stride, int uv_stride,
+                                  const __m256i x) {
+  const __m128i yy = _mm256_castsi256_si128(x);
+  _mm_storel_epi64((__m128i *)(y + r * y_stride), yy);
+  _mm_storel_epi64((__m128i *)(y + (r + 1) * y_stride), _mm_srli_si128(yy, 8));
+  if (u) {
+    const __m128i uv = _mm256_extracti128_si256(x, 1);
+    uint8_t *c = r < 8 ? u + r * uv_stride : v + (r - 8) * uv_stride;
+    _mm_storel_epi64((__m128i *)c, uv);
+    _mm_storel_epi64((__m128i *)(c + uv_stride), _mm_srli_si128(uv, 8));
+  }
+}
+
+// Rows 0-15 of the high lane are the 8 rows of U followed by the 8 rows of V.
+static INLINE __m256i load_row_v(const uint8_t *y, const uint8_t *u,
+                                 const uint8_t *v, int r, int y_stride,
+                                 int uv_stride) {
+  const __m128i yy = _mm_loadu_si128((const __m128i *)(y + r * y_stride));
+  __m128i uv = _mm_setzero_si128();
+  if (u) {
+    const uint8_t *c = r < 8 ? u + r * uv_stride : v + (r - 8) * uv_stride;
+    uv = _mm_loadl_epi64((const __m128i *)c);
+  }
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(yy), uv, 1);
+}
+
+/* Horizontal MB filtering */
+void vp8_loop_filter_mbh_avx2(unsigned char *y_ptr, unsigned char *u_ptr,
+                              unsigned char *v_ptr, int y_stride, int uv_stride,
+                              loop_filter_info *lfi) {
+  __m256i s[8];
+  int i;
+
+  if (!v_ptr) u_ptr = NULL;
+  for (i = 0; i < 8; ++i) {
+    s[i] = load_row(y_ptr, u_ptr, v_ptr, i - 4, y_stride, uv_stride);
+  }
+
+  filter_edge(s, load_thresh(lfi->mblim), load_thresh(lfi->lim),
+              load_thresh(lfi->hev_thr), lane_mask(u_ptr != NULL), 1);
+
+  for (i = 1; i < 7; ++i) {
+    store_row(y_ptr, u_ptr, v_ptr, i - 4, y_stride, uv_stride, s[i]);
+  }
+}
+
+/* Horizontal B Filtering */
+void vp8_loop_filter_bh_avx2(unsigned char *y_ptr, unsigned char *u_ptr,
+                             unsigned char *v_ptr, int y_stride, int uv_stride,
+                             loop_filter_info *lfi) {
+  const __m256i blimit = load_thresh(lfi->blim);
+  const __m256i limit = load_thresh(lfi->lim);
+  const __m256i thresh = load_thresh(lfi->hev_thr);
+  const __m256i luma_only = lane_mask(0);
+  __m256i s[16];
+  int i;
+
+  if (!v_ptr) u_ptr = NULL;
+  // The chroma edge at row 4 is filtered together with the first luma edge.
+  for (i = 0; i < 8; ++i) {
+    s[i] = load_row(y_ptr, u_ptr, v_ptr, i, y_stride, uv_stride);
+  }
+  for (i = 8; i < 16; ++i) {
+    s[i] = load_row(y_ptr, NULL, NULL, i, y_stride, uv_stride);
+  }
+
+  filter_edge(s, blimit, limit, thresh, lane_mask(u_ptr != NULL), 0);
+  filter_edge(s + 4, blimit, limit, thresh, luma_only, 0);
+  filter_edge(s + 8, blimit, limit, thresh, luma_only, 0);
+
+  for (i = 2; i < 6; ++i) {
+    store_row(y_ptr, u_ptr, v_ptr, i, y_stride, uv_stride, s[i]);
+  }
+  for (i = 6; i < 14; ++i) {
+    store_row(y_ptr, NULL, NULL, i, y_stride, uv_stride, s[i]);
+  }
+}
+
+/* Vertical MB Filtering */
+void vp8_loop_filter_mbv_avx2(unsigned char *y_ptr, unsigned char *u_ptr,
+                              unsigned char *v_ptr, int y_stride, int uv_stride,
+                              loop_filter_info *lfi) {
+  __m256i rows[16], s[8];
+  int i;
+
+  if (!v_ptr) u_ptr = NULL;
+  for (i = 0; i < 16; ++i) {
+    rows[i] = load_row_v(y_ptr - 4, u_ptr ? u_ptr - 4 : NULL,
+                         v_ptr ? v_ptr - 4 : NULL, i, y_stride, uv_stride);
+  }
+  transpose_16x8(rows, s);
+
+  filter_edge(s, load_thresh(lfi->mblim), load_thresh(lfi->lim),
+              load_thresh(lfi->hev_thr), lane_mask(u_ptr != NULL), 1);
+
+  transpose_8x16(s, rows);
+  for (i = 0; i < 8; ++i) {
+    store_row_pair(y_ptr - 4, u_ptr ? u_ptr - 4 : NULL,
+                   v_ptr ? v_ptr - 4 : NULL, 2 * i, y_stride, uv_stride,
+                   rows[i]);
+  }
+}
+
+/* Vertical B Filtering */
+void vp8_loop_filter_bv_avx2(unsigned char *y_ptr, unsigned char *u_ptr,
+                             unsigned char *v_ptr, int y_stride, int uv_stride,
+                             loop_filter_info *lfi) {
+  const __m256i blimit = load_thresh(lfi->blim);
+  const __m256i limit = load_thresh(lfi->lim);
+  const __m256i thresh = load_thresh(lfi->hev_thr);
+  const __m256i luma_only = lane_mask(0);
+  __m256i rows[16], s[16], lo[8], hi[8];
+  int i;
+
+  if (!v_ptr) u_ptr = NULL;
+  // Transpose the whole luma block once so the three edges are filtered in
+  // registers. Columns 0-7 of the high lane hold the chroma columns.
+  for (i = 0; i < 16; ++i) {
+    rows[i] = load_row_v(y_ptr, u_ptr, v_ptr, i, y_stride, uv_stride);
+  }
+  transpose_16x8(rows, s);
+  for (i = 0; i < 16; ++i) rows[i] = _mm256_srli_si256(rows[i], 8);
+  transpose_16x8(rows, s + 8);
+
+  filter_edge(s, blimit, limit, thresh, lane_mask(u_ptr != NULL), 0);
+  filter_edge(s + 4, blimit, limit, thresh, luma_only, 0);
+  filter_edge(s + 8, blimit, limit, thresh, luma_only, 0);
+
+  transpose_8x16(s, lo);
+  transpose_8x16(s + 8, hi);
+  for (i = 0; i < 8; ++i) {
+    const __m128i l = _mm256_castsi256_si128(lo[i]);
+    const __m128i h = _mm256_castsi256_si128(hi[i]);
+    _mm_storeu_si128((__m128i *)(y_ptr + 2 * i * y_stride),
+                     _mm_unpacklo_epi64(l, h));
+    _mm_storeu_si128((__m128i *)(y_ptr + (2 * i + 1) * y_stride),
+                     _mm_unpackhi_epi64(l, h));
+    if (u_ptr) {
+      const __m128i uv = _mm256_extracti128_si256(lo[i], 1);
+      uint8_t *c =
+          i < 4 ? u_ptr + 2 * i * uv_stride : v_ptr + (2 * i - 8) * uv_stride;
+      _mm_storel_epi64((__m128i *)c, uv);
+      _mm_storel_epi64((__m128i *)(c + uv_stride), _mm_srli_si128(uv, 8));
+    }
+  }
+}
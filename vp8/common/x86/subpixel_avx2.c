@@ -0,0 +1,182 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vp8_rtcd.h"
+#include "./vpx_config.h"
+#include "vp8/common/filter.h"
+#include "vpx_ports/mem.h"
+
+// The six taps are applied as three byte pairs with _mm256_maddubs_epi16:
+// (k0, k5), (k1, k3) and (k2, k4). Every pair holds at most one negative tap
+// and one tap of at most 123, so no pair sum can saturate. (k1, k3) and
+// (k2, k4) are added first and (k0, k5), which is never negative, last.
+// Whenever one of the saturating adds clips, the exact sum lies outside
+// [0, 255 << 7] on the same side, so the packus below produces the same
+// 0 or 255 the C code clamps to.
+static INLINE __m256i pair_taps(const short *taps, int a, int b) {
+  return _mm256_set1_epi16((short)((taps[b] << 8) | (taps[a] & 0xff)));
+}
+
+static INLINE __m256i round_shift(__m256i x) {
+  const __m256i round = _mm256_set1_epi16(1 << (VP8_FILTER_SHIFT - 1));
+  return _mm256_srai_epi16(_mm256_adds_epi16(x, round), VP8_FILTER_SHIFT);
+}
+
+static INLINE __m256i load_2x16(const uint8_t *lo, const uint8_t *hi) {
+  const __m128i a = _mm_loadu_si128((const __m128i *)lo);
+  const __m128i b = _mm_loadu_si128((const __m128i *)hi);
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(a), b, 1);
+}
+
+static INLINE void store_2x16(uint8_t *lo, uint8_t *hi, __m256i x) {
+  _mm_storeu_si128((__m128i *)lo, _mm256_castsi256_si128(x));
+  _mm_storeu_si128((__m128i *)hi, _mm256_extracti128_si256(x, 1));
+}
+
+// Filter one row of 16 pixels. Pixels 0-7 come from the low lane, which is
+// loaded from src - 2, and pixels 8-15 from the high lane, which is loaded
+// from src + 3 so that no byte past src[18] is read.
+static INLINE __m256i sixtap_h_row(const uint8_t *src, const __m256i *shuf,
+                                   const __m256i *taps) {
+  const __m256i s = load_2x16(src - 2, src + 3);
+  const __m256i p13 =
+      _mm256_maddubs_epi16(_mm256_shuffle_epi8(s, shuf[0]), taps[0]);
+  const __m256i p24 =
+      _mm256_maddubs_epi16(_mm256_shuffle_epi8(s, shuf[1]), taps[1]);
+  const __m256i p05 =
+      _mm256_maddubs_epi16(_mm256_shuffle_epi8(s, shuf[2]), taps[2]);
+  return round_shift(_mm256_adds_epi16(_mm256_adds_epi16(p13, p24), p05));
+}
+
+static void sixtap_h_16xn(const uint8_t *src, int src_stride, uint8_t *dst,
+                          int dst_stride, int height, int xoffset) {
+  DECLARE_ALIGNED(32, static const uint8_t, shuf_k13[32]) = {
+    1, 3, 2, 4, 3, 5, 4, 6, 5, 7,  6, 8,  7, 9,  8,  10,
+    4, 6, 5, 7, 6, 8, 7, 9, 8, 10, 9, 11, 10, 12, 11, 13
+  };
+  DECLARE_ALIGNED(32, static const uint8_t, shuf_k24[32]) = {
+    2, 4, 3, 5, 4, 6, 5, 7, 6, 8,  7, 9,  8,  10, 9,  11,
+    5, 7, 6, 8, 7, 9, 8, 10, 9, 11, 10, 12, 11, 13, 12, 14
+  };
+  DECLARE_ALIGNED(32, static const uint8_t, shuf_k05[32]) = {
+    0, 5, 1, 6, 2, 7,  3, 8,  4, 9,  5, 10, 6,  11, 7,  12,
+    3, 8, 4, 9, 5, 10, 6, 11, 7, 12, 8, 13, 9, 14, 10, 15
+  };
+  const short *filter = vp8_sub_pel_filters[xoffset];
+  __m256i shuf[3], taps[3];
+  int h;
+
+  shuf[0] = _mm256_load_si256((const __m256i *)shuf_k13);
+  shuf[1] = _mm256_load_si256((const __m256i *)shuf_k24);
+  shuf[2] = _mm256_load_si256((const __m256i *)shuf_k05);
+  taps[0] = pair_taps(filter, 1, 3);
+  taps[1] = pair_taps(filter, 2, 4);
+  taps[2] = pair_taps(filter, 0, 5);
+
+  for (h = 0; h + 2 <= height; h += 2) {
+    const __m256i a = sixtap_h_row(src, shuf, taps);
+    const __m256i b = sixtap_h_row(src + src_stride, shuf, taps);
+    // packus interleaves the lanes as a0-7 b0-7 | a8-15 b8-15.
+    const __m256i ab = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b),
+                                                0xd8);
+    store_2x16(dst, dst + dst_stride, ab);
+    src += 2 * src_stride;
+    dst += 2 * dst_stride;
+  }
+
+  if (h < height) {
+    const __m256i a = sixtap_h_row(src, shuf, taps);
+    const __m256i aa = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, a),
+                                                0xd8);
+    _mm_storeu_si128((__m128i *)dst, _mm256_castsi256_si128(aa));
+  }
+}
+
+// Filter 16 rows vertically. src points 2 rows above the first output row.
+// Each ymm holds a pair of consecutive rows so two output rows are produced
+// per iteration.
+static void sixtap_v_16x16(const uint8_t *src, int src_stride, uint8_t *dst,
+                           int dst_stride, int yoffset) {
+  const short *filter = vp8_sub_pel_filters[yoffset];
+  const __m256i k13 = pair_taps(filter, 1, 3);
+  const __m256i k24 = pair_taps(filter, 2, 4);
+  const __m256i k05 = pair_taps(filter, 0, 5);
+  __m256i r[6];
+  int h;
+
+  r[0] = load_2x16(src, src + src_stride);
+  r[1] = load_2x16(src + src_stride, src + 2 * src_stride);
+  r[2] = load_2x16(src + 2 * src_stride, src + 3 * src_stride);
+  r[3] = load_2x16(src + 3 * src_stride, src + 4 * src_stride);
+  r[4] = load_2x16(src + 4 * src_stride, src + 5 * src_stride);
+  src += 5 * src_stride;
+
+  for (h = 0; h < 16; h += 2) {
+    __m256i lo, hi;
+    r[5] = load_2x16(src, src + src_stride);
+    src += 2 * src_stride;
+
+    lo = _mm256_adds_epi16(
+        _mm256_maddubs_epi16(_mm256_unpacklo_epi8(r[1], r[3]), k13),
+        _mm256_maddubs_epi16(_mm256_unpacklo_epi8(r[2], r[4]), k24));
+    hi = _mm256_adds_epi16(
+        _mm256_maddubs_epi16(_mm256_unpackhi_epi8(r[1], r[3]), k13),
+        _mm256_maddubs_epi16(_mm256_unpackhi_epi8(r[2], r[4]), k24));
+    lo = _mm256_adds_epi16(
+        lo, _mm256_maddubs_epi16(_mm256_unpacklo_epi8(r[0], r[5]), k05));
+    hi = _mm256_adds_epi16(
+        hi, _mm256_maddubs_epi16(_mm256_unpackhi_epi8(r[0], r[5]), k05));
+
+    store_2x16(dst, dst + dst_stride,
+               _mm256_packus_epi16(round_shift(lo), round_shift(hi)));
+    dst += 2 * dst_stride;
+
+    if (h + 2 < 16) {
+      r[0] = r[2];
+      r[1] = r[3];
+      r[2] = r[4];
+      r[3] = r[5];
+      r[4] = _mm256_inserti128_si256(
+          _mm256_permute2x128_si256(r[5], r[5], 0x01),
+          _mm_loadu_si128((const __m128i *)src), 1);
+    }
+  }
+}
+
+void vp8_sixtap_predict16x16_avx2(unsigned char *src_ptr,
+                                  int src_pixels_per_line, int xoffset,
+                                  int yoffset, unsigned char *dst_ptr,
+                                  int dst_pitch) {
+  DECLARE_ALIGNED(32, unsigned char, FData[16 * 21]);
+
+  if (xoffset) {
+    if (yoffset) {
+      sixtap_h_16xn(src_ptr - 2 * src_pixels_per_line, src_pixels_per_line,
+                    FData, 16, 21, xoffset);
+      sixtap_v_16x16(FData, 16, dst_ptr, dst_pitch, yoffset);
+    } else {
+      /* First-pass only */
+      sixtap_h_16xn(src_ptr, src_pixels_per_line, dst_ptr, dst_pitch, 16,
+                    xoffset);
+    }
+  } else {
+    if (yoffset) {
+      /* Second-pass only */
+      sixtap_v_16x16(src_ptr - 2 * src_pixels_per_line, src_pixels_per_line,
+                     dst_ptr, dst_pitch, yoffset);
+    } else {
+      /* The full-pel filter has a center tap of 128, which does not fit the
+       * signed byte taps used above. */
+      vp8_copy_mem16x16(src_ptr, src_pixels_per_line, dst_ptr, dst_pitch);
+    }
+  }
+}
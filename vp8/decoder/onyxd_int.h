@@ -80,6 +80,8 @@ typedef struct VP8D_COMP {
   int sync_range;
   /* Each row remembers its already decoded column. */
   vpx_atomic_int *mt_current_mb_col;
+  /* Threads blocked waiting for a row, see vp8_row_sync_wait(). */
+  vpx_atomic_int mt_row_sleepers;
 
   unsigned char **mt_yabove_row; /* mb_rows x width */
   unsigned char **mt_uabove_row;
@@ -257,6 +257,7 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
       VPX_ATOMIC_INIT(pc->mb_cols + nsync);
   int num_part = 1 << pbi->common.multi_token_partition;
   int last_mb_row = start_mb_row;
+  int spin_limit = VP8_ROW_SYNC_INIT_SPINS;
 
   YV12_BUFFER_CONFIG *yv12_fb_new = pbi->dec_fb_ref[INTRA_FRAME];
   YV12_BUFFER_CONFIG *yv12_fb_lst = pbi->dec_fb_ref[LAST_FRAME];
@@ -358,11 +359,12 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
 
     for (mb_col = 0; mb_col < pc->mb_cols; ++mb_col) {
       if (((mb_col - 1) % nsync) == 0) {
-        vpx_atomic_store_release(current_mb_col, mb_col - 1);
+        vp8_row_sync_write(current_mb_col, mb_col - 1, &pbi->mt_row_sleepers);
       }
 
       if (mb_row && !(mb_col & (nsync - 1))) {
-        vp8_atomic_spin_wait(mb_col, last_row_current_mb_col, nsync);
+        vp8_row_sync_wait(mb_col, last_row_current_mb_col, nsync,
+                          &pbi->mt_row_sleepers, &spin_limit);
       }
 
       /* Distance of MB to the various image edges.
@@ -409,7 +411,8 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
         for (; mb_row < pc->mb_rows;
              mb_row += (pbi->decoding_thread_count + 1)) {
           current_mb_col = &pbi->mt_current_mb_col[mb_row];
-          vpx_atomic_store_release(current_mb_col, pc->mb_cols + nsync);
+          vp8_row_sync_write(current_mb_col, pc->mb_cols + nsync,
+                             &pbi->mt_row_sleepers);
         }
         vpx_internal_error(&xd->error_info, VPX_CODEC_CORRUPT_FRAME,
                            "Corrupted reference frame");
@@ -564,7 +567,7 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
     }
 
     /* last MB of row is ready just after extension is done */
-    vpx_atomic_store_release(current_mb_col, mb_col + nsync);
+    vp8_row_sync_write(current_mb_col, mb_col + nsync, &pbi->mt_row_sleepers);
 
     ++xd->mode_info_context; /* skip prediction column */
     xd->up_available = 1;
@@ -758,6 +761,7 @@ void vp8mt_alloc_temp_buffers(VP8D_COMP *pbi, int width, int prev_mb_rows) {
                     vpx_malloc(sizeof(*pbi->mt_current_mb_col) * pc->mb_rows));
     for (i = 0; i < pc->mb_rows; ++i)
       vpx_atomic_init(&pbi->mt_current_mb_col[i], 0);
+    vpx_atomic_init(&pbi->mt_row_sleepers, 0);
 
     /* Allocate memory for above_row buffers. */
     CALLOC_ARRAY(pbi->mt_yabove_row, pc->mb_rows);
@@ -417,11 +417,12 @@ static void encode_mb_row(VP8_COMP *cpi, VP8_COMMON *cm, int mb_row,
 #if CONFIG_MULTITHREAD
     if (vpx_atomic_load_acquire(&cpi->b_multi_threaded) != 0) {
       if (((mb_col - 1) % nsync) == 0) {
-        vpx_atomic_store_release(current_mb_col, mb_col - 1);
+        vp8_row_sync_write(current_mb_col, mb_col - 1, &cpi->mt_row_sleepers);
       }
 
       if (mb_row && !(mb_col & (nsync - 1))) {
-        vp8_atomic_spin_wait(mb_col, last_row_current_mb_col, nsync);
+        vp8_row_sync_wait(mb_col, last_row_current_mb_col, nsync,
+                          &cpi->mt_row_sleepers, &cpi->mt_spin_limit);
       }
     }
 #endif
@@ -562,8 +563,8 @@ static void encode_mb_row(VP8_COMP *cpi, VP8_COMMON *cm, int mb_row,
 
 #if CONFIG_MULTITHREAD
   if (vpx_atomic_load_acquire(&cpi->b_multi_threaded) != 0) {
-    vpx_atomic_store_release(current_mb_col,
-                             vpx_atomic_load_acquire(&rightmost_col));
+    vp8_row_sync_write(current_mb_col, vpx_atomic_load_acquire(&rightmost_col),
+                       &cpi->mt_row_sleepers);
   }
 #endif
 
@@ -46,6 +46,7 @@ static THREAD_FUNCTION thread_encoding_proc(void *p_data) {
   VP8_COMP *cpi = (VP8_COMP *)(((ENCODETHREAD_DATA *)p_data)->ptr1);
   MB_ROW_COMP *mbri = (MB_ROW_COMP *)(((ENCODETHREAD_DATA *)p_data)->ptr2);
   ENTROPY_CONTEXT_PLANES mb_row_left_context;
+  int spin_limit = VP8_ROW_SYNC_INIT_SPINS;
 
   while (1) {
     if (vpx_atomic_load_acquire(&cpi->b_multi_threaded) == 0) break;
@@ -108,11 +109,13 @@ static THREAD_FUNCTION thread_encoding_proc(void *p_data) {
         /* for each macroblock col in image */
         for (mb_col = 0; mb_col < cm->mb_cols; ++mb_col) {
           if (((mb_col - 1) % nsync) == 0) {
-            vpx_atomic_store_release(current_mb_col, mb_col - 1);
+            vp8_row_sync_write(current_mb_col, mb_col - 1,
+                               &cpi->mt_row_sleepers);
           }
 
           if (mb_row && !(mb_col & (nsync - 1))) {
-            vp8_atomic_spin_wait(mb_col, last_row_current_mb_col, nsync);
+            vp8_row_sync_wait(mb_col, last_row_current_mb_col, nsync,
+                              &cpi->mt_row_sleepers, &spin_limit);
           }
 
 #if CONFIG_REALTIME_ONLY & CONFIG_ONTHEFLY_BITPACKING
@@ -284,7 +287,8 @@ static THREAD_FUNCTION thread_encoding_proc(void *p_data) {
         vp8_extend_mb_row(&cm->yv12_fb[dst_fb_idx], xd->dst.y_buffer + 16,
                           xd->dst.u_buffer + 8, xd->dst.v_buffer + 8);
 
-        vpx_atomic_store_release(current_mb_col, mb_col + nsync);
+        vp8_row_sync_write(current_mb_col, mb_col + nsync,
+                           &cpi->mt_row_sleepers);
 
         /* this is to account for the border */
         xd->mode_info_context++;
@@ -489,6 +493,8 @@ int vp8cx_create_encoder_threads(VP8_COMP *cpi) {
   const VP8_COMMON *cm = &cpi->common;
 
   vpx_atomic_init(&cpi->b_multi_threaded, 0);
+  vpx_atomic_init(&cpi->mt_row_sleepers, 0);
+  cpi->mt_spin_limit = VP8_ROW_SYNC_INIT_SPINS;
   cpi->encoding_thread_count = 0;
   cpi->b_lpf_running = 0;
 
@@ -525,6 +525,10 @@ typedef struct VP8_COMP {
   /* multithread data */
   vpx_atomic_int *mt_current_mb_col;
   int mt_sync_range;
+  /* Threads blocked waiting for a row, see vp8_row_sync_wait(). */
+  vpx_atomic_int mt_row_sleepers;
+  /* Spin budget of the main thread's row waits. */
+  int mt_spin_limit;
   vpx_atomic_int b_multi_threaded;
   int encoding_thread_count;
   int b_lpf_running;
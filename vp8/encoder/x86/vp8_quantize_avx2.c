@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h> /* AVX2 */
+
+#include "./vp8_rtcd.h"
+#include "vp8/common/entropy.h" /* vp8_default_zig_zag1d */
+#include "vp8/encoder/block.h"
+#include "vpx_ports/bitops.h"
+#include "vpx_ports/mem.h"
+
+/* Returns a 16 bit mask with bit i set when the lane of mask16 holding
+ * coefficient vp8_default_zig_zag1d[i] is set. */
+static INLINE int zig_zag_movemask(__m256i mask16) {
+  const __m128i zig_zag = _mm_setr_epi8(0, 1, 4, 8, 5, 2, 3, 6, 9, 12, 13, 10,
+                                        7, 11, 14, 15);
+  /* packs works per lane: 0-7 land in the low and 8-15 in the third quad. */
+  const __m256i packed = _mm256_permute4x64_epi64(
+      _mm256_packs_epi16(mask16, _mm256_setzero_si256()), 0x08);
+  return _mm_movemask_epi8(
+      _mm_shuffle_epi8(_mm256_castsi256_si128(packed), zig_zag));
+}
+
+void vp8_fast_quantize_b_avx2(BLOCK *b, BLOCKD *d) {
+  const __m256i z = _mm256_loadu_si256((const __m256i *)b->coeff);
+  const __m256i round = _mm256_loadu_si256((const __m256i *)b->round);
+  const __m256i quant_fast =
+      _mm256_loadu_si256((const __m256i *)b->quant_fast);
+  const __m256i dequant = _mm256_loadu_si256((const __m256i *)d->dequant);
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i sz = _mm256_srai_epi16(z, 15);
+  __m256i x, y;
+  int nonzero;
+
+  /* y = ((abs(z) + round) * quant) >> 16 */
+  x = _mm256_add_epi16(_mm256_abs_epi16(z), round);
+  y = _mm256_mulhi_epi16(x, quant_fast);
+
+  /* Restore the sign. */
+  x = _mm256_sub_epi16(_mm256_xor_si256(y, sz), sz);
+  _mm256_storeu_si256((__m256i *)d->qcoeff, x);
+  _mm256_storeu_si256((__m256i *)d->dqcoeff, _mm256_mullo_epi16(x, dequant));
+
+  nonzero = zig_zag_movemask(
+      _mm256_xor_si256(_mm256_cmpeq_epi16(y, zero), _mm256_cmpeq_epi16(y, y)));
+  *d->eob = (char)(nonzero ? get_msb(nonzero) + 1 : 0);
+}
+
+void vp8_regular_quantize_b_avx2(BLOCK *b, BLOCKD *d) {
+  DECLARE_ALIGNED(32, short, x_minus_zbin[16]);
+  DECLARE_ALIGNED(32, short, y[16]);
+  DECLARE_ALIGNED(32, short, qcoeff[16]) = { 0 };
+  const short *zbin_boost = b->zrun_zbin_boost;
+  const __m256i z = _mm256_loadu_si256((const __m256i *)b->coeff);
+  const __m256i zbin = _mm256_add_epi16(
+      _mm256_loadu_si256((const __m256i *)b->zbin),
+      _mm256_set1_epi16(b->zbin_extra));
+  const __m256i round = _mm256_loadu_si256((const __m256i *)b->round);
+  const __m256i quant = _mm256_loadu_si256((const __m256i *)b->quant);
+  const __m256i quant_shift =
+      _mm256_loadu_si256((const __m256i *)b->quant_shift);
+  const __m256i dequant = _mm256_loadu_si256((const __m256i *)d->dequant);
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i x, xz, yy, q;
+  unsigned int candidates;
+  int eob = -1;
+
+  /* As in the SSE4.1 version, compare x - (zbin[] + extra) against the boost
+   * and compute every quantized value up front. */
+  x = _mm256_abs_epi16(z);
+  xz = _mm256_sub_epi16(x, zbin);
+  x = _mm256_add_epi16(x, round);
+  yy = _mm256_add_epi16(_mm256_mulhi_epi16(x, quant), x);
+  yy = _mm256_mulhi_epi16(yy, quant_shift);
+  yy = _mm256_sign_epi16(yy, z);
+  _mm256_store_si256((__m256i *)x_minus_zbin, xz);
+  _mm256_store_si256((__m256i *)y, yy);
+
+  /* The zero run boosts are never negative, so only coefficients that clear
+   * the unboosted zbin and quantize to a non-zero value can be kept. Walk
+   * just those in zig-zag order; the run since the last kept coefficient
+   * selects the boost. */
+  candidates = (unsigned int)zig_zag_movemask(_mm256_andnot_si256(
+      _mm256_or_si256(_mm256_cmpgt_epi16(zero, xz),
+                      _mm256_cmpeq_epi16(yy, zero)),
+      _mm256_cmpeq_epi16(zero, zero)));
+  while (candidates) {
+    const int i = get_msb(candidates & (0u - candidates));
+    const int rc = vp8_default_zig_zag1d[i];
+    if (x_minus_zbin[rc] >= zbin_boost[i - eob - 1]) {
+      qcoeff[rc] = y[rc];
+      eob = i;
+    }
+    candidates &= candidates - 1;
+  }
+
+  q = _mm256_load_si256((const __m256i *)qcoeff);
+  _mm256_storeu_si256((__m256i *)d->qcoeff, q);
+  _mm256_storeu_si256((__m256i *)d->dqcoeff, _mm256_mullo_epi16(q, dequant));
+  *d->eob = (char)(eob + 1);
+}
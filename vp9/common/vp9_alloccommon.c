@@ -73,6 +73,8 @@ void vp9_free_ref_frame_buffers(BufferPool *pool) {
     }
     vpx_free(pool->frame_bufs[i].mvs);
     pool->frame_bufs[i].mvs = NULL;
+    vpx_free(pool->frame_bufs[i].seg_map);
+    pool->frame_bufs[i].seg_map = NULL;
     vpx_free_frame_buffer(&pool->frame_bufs[i].buf);
   }
 }
@@ -85,6 +87,9 @@ void vp9_free_postproc_buffers(VP9_COMMON *cm) {
   cm->postproc_state.limits = NULL;
   vpx_free(cm->postproc_state.generated_noise);
   cm->postproc_state.generated_noise = NULL;
+  vpx_free(cm->postproc_state.worker_data);
+  cm->postproc_state.worker_data = NULL;
+  cm->postproc_state.num_worker_data = 0;
 #else
   (void)cm;
 #endif
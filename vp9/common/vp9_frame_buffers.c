@@ -9,18 +9,58 @@
  */
 
 #include <assert.h>
+#include <string.h>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
 
 #include "vp9/common/vp9_frame_buffers.h"
 #include "vpx_mem/vpx_mem.h"
 
+#define HUGE_PAGE_SIZE (2 << 20)
+
+// Rounds |size| up to a size class. Classes are a quarter of a power of two
+// apart, so a buffer reused for a smaller frame wastes at most 25%, and frame
+// sizes that differ slightly share a class.
+static size_t get_size_class(size_t size) {
+  size_t step = 1;
+  while (step << 3 < size) step <<= 1;
+  return (size + step - 1) & ~(step - 1);
+}
+
+static uint8_t *alloc_frame_buffer(const InternalFrameBufferList *list,
+                                   size_t size) {
+  uint8_t *data;
+  if (!list->prefault && !list->use_huge_pages) {
+    // The data must be zeroed to fix a valgrind error from the C loop filter
+    // due to access uninitialized memory in frame border. It could be
+    // skipped if border were totally removed.
+    return (uint8_t *)vpx_calloc(1, size);
+  }
+  if (list->use_huge_pages) {
+    data = (uint8_t *)vpx_memalign(HUGE_PAGE_SIZE, size);
+#if defined(MADV_HUGEPAGE)
+    if (data != NULL) madvise(data, size, MADV_HUGEPAGE);
+#endif
+  } else {
+    data = (uint8_t *)vpx_malloc(size);
+  }
+  // Zeroing also faults the pages in now rather than while decoding.
+  if (data != NULL) memset(data, 0, size);
+  return data;
+}
+
 int vp9_alloc_internal_frame_buffers(InternalFrameBufferList *list) {
   assert(list != NULL);
   vp9_free_internal_frame_buffers(list);
 
-  list->num_internal_frame_buffers =
-      VP9_MAXIMUM_REF_BUFFERS + VPX_MAXIMUM_WORK_BUFFERS;
+  list->num_internal_frame_buffers = VP9_MAXIMUM_REF_BUFFERS +
+                                     VPX_MAXIMUM_WORK_BUFFERS +
+                                     MAX_BORROWED_FRAMES;
   list->int_fb = (InternalFrameBuffer *)vpx_calloc(
       list->num_internal_frame_buffers, sizeof(*list->int_fb));
+  list->num_allocs = 0;
+  list->num_recycles = 0;
   return (list->int_fb == NULL);
 }
 
@@ -35,30 +75,52 @@ void vp9_free_internal_frame_buffers(InternalFrameBufferList *list) {
   }
   vpx_free(list->int_fb);
   list->int_fb = NULL;
+  list->bytes_allocated = 0;
 }
 
 int vp9_get_frame_buffer(void *cb_priv, size_t min_size,
                          vpx_codec_frame_buffer_t *fb) {
-  int i;
+  int i, best, smallest;
   InternalFrameBufferList *const int_fb_list =
       (InternalFrameBufferList *)cb_priv;
   if (int_fb_list == NULL) return -1;
 
-  // Find a free frame buffer.
+  // Use the smallest free buffer that is large enough, so that buffers left
+  // over from a larger resolution are recycled instead of reallocated.
+  // Otherwise the smallest free buffer is replaced.
+  best = -1;
+  smallest = -1;
   for (i = 0; i < int_fb_list->num_internal_frame_buffers; ++i) {
-    if (!int_fb_list->int_fb[i].in_use) break;
+    const InternalFrameBuffer *const int_fb = &int_fb_list->int_fb[i];
+    if (int_fb->in_use) continue;
+    if (int_fb->size >= min_size) {
+      if (best < 0 || int_fb->size < int_fb_list->int_fb[best].size) best = i;
+    } else if (smallest < 0 ||
+               int_fb->size < int_fb_list->int_fb[smallest].size) {
+      smallest = i;
+    }
   }
 
-  if (i == int_fb_list->num_internal_frame_buffers) return -1;
-
-  if (int_fb_list->int_fb[i].size < min_size) {
-    vpx_free(int_fb_list->int_fb[i].data);
-    // The data must be zeroed to fix a valgrind error from the C loop filter
-    // due to access uninitialized memory in frame border. It could be
-    // skipped if border were totally removed.
-    int_fb_list->int_fb[i].data = (uint8_t *)vpx_calloc(1, min_size);
-    if (!int_fb_list->int_fb[i].data) return -1;
-    int_fb_list->int_fb[i].size = min_size;
+  if (best >= 0) {
+    i = best;
+    ++int_fb_list->num_recycles;
+  } else if (smallest >= 0) {
+    InternalFrameBuffer *const int_fb = &int_fb_list->int_fb[smallest];
+    size_t size = get_size_class(min_size);
+    if (int_fb_list->use_huge_pages) {
+      size = (size + HUGE_PAGE_SIZE - 1) & ~((size_t)HUGE_PAGE_SIZE - 1);
+    }
+    i = smallest;
+    vpx_free(int_fb->data);
+    int_fb_list->bytes_allocated -= int_fb->size;
+    int_fb->size = 0;
+    int_fb->data = alloc_frame_buffer(int_fb_list, size);
+    if (!int_fb->data) return -1;
+    int_fb->size = size;
+    int_fb_list->bytes_allocated += size;
+    ++int_fb_list->num_allocs;
+  } else {
+    return -1;
   }
 
   fb->data = int_fb_list->int_fb[i].data;
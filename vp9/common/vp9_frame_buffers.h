@@ -18,6 +18,9 @@
 extern "C" {
 #endif
 
+// Frames the application may hold with VP9D_BORROW_FRAME.
+#define MAX_BORROWED_FRAMES 8
+
 typedef struct InternalFrameBuffer {
   uint8_t *data;
   size_t size;
@@ -27,6 +30,13 @@ typedef struct InternalFrameBuffer {
 typedef struct InternalFrameBufferList {
   int num_internal_frame_buffers;
   InternalFrameBuffer *int_fb;
+  // Options for new allocations.
+  int prefault;        // Fault the pages in when the buffer is allocated.
+  int use_huge_pages;  // Back the buffers with huge pages where supported.
+  // Requests served by allocating a buffer or by reusing a free one.
+  unsigned int num_allocs;
+  unsigned int num_recycles;
+  size_t bytes_allocated;
 } InternalFrameBufferList;
 
 // Initializes |list|. Returns 0 on success.
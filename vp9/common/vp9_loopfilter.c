@@ -1421,12 +1421,15 @@ void vp9_filter_block_plane_ss11(VP9_COMMON *const cm,
   }
 }
 
-static void loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, VP9_COMMON *cm,
+static void loop_filter_cols(YV12_BUFFER_CONFIG *frame_buffer, VP9_COMMON *cm,
                              struct macroblockd_plane planes[MAX_MB_PLANE],
-                             int start, int stop, int y_only) {
+                             int mi_row, int mi_col_start, int mi_col_end,
+                             int y_only) {
   const int num_planes = y_only ? 1 : MAX_MB_PLANE;
+  MODE_INFO **mi = cm->mi_grid_visible + mi_row * cm->mi_stride;
+  LOOP_FILTER_MASK *lfm = get_lfm(&cm->lf, mi_row, mi_col_start);
   enum lf_path path;
-  int mi_row, mi_col;
+  int mi_col;
 
   if (y_only)
     path = LF_PATH_444;
@@ -1437,37 +1440,43 @@ static void loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, VP9_COMMON *cm,
   else
     path = LF_PATH_SLOW;
 
-  for (mi_row = start; mi_row < stop; mi_row += MI_BLOCK_SIZE) {
-    MODE_INFO **mi = cm->mi_grid_visible + mi_row * cm->mi_stride;
-    LOOP_FILTER_MASK *lfm = get_lfm(&cm->lf, mi_row, 0);
-
-    for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE, ++lfm) {
-      int plane;
-
-      vp9_setup_dst_planes(planes, frame_buffer, mi_row, mi_col);
-
-      // TODO(jimbankoski): For 444 only need to do y mask.
-      vp9_adjust_mask(cm, mi_row, mi_col, lfm);
-
-      vp9_filter_block_plane_ss00(cm, &planes[0], mi_row, lfm);
-      for (plane = 1; plane < num_planes; ++plane) {
-        switch (path) {
-          case LF_PATH_420:
-            vp9_filter_block_plane_ss11(cm, &planes[plane], mi_row, lfm);
-            break;
-          case LF_PATH_444:
-            vp9_filter_block_plane_ss00(cm, &planes[plane], mi_row, lfm);
-            break;
-          case LF_PATH_SLOW:
-            vp9_filter_block_plane_non420(cm, &planes[plane], mi + mi_col,
-                                          mi_row, mi_col);
-            break;
-        }
+  for (mi_col = mi_col_start; mi_col < mi_col_end;
+       mi_col += MI_BLOCK_SIZE, ++lfm) {
+    int plane;
+
+    vp9_setup_dst_planes(planes, frame_buffer, mi_row, mi_col);
+
+    // TODO(jimbankoski): For 444 only need to do y mask.
+    vp9_adjust_mask(cm, mi_row, mi_col, lfm);
+
+    vp9_filter_block_plane_ss00(cm, &planes[0], mi_row, lfm);
+    for (plane = 1; plane < num_planes; ++plane) {
+      switch (path) {
+        case LF_PATH_420:
+          vp9_filter_block_plane_ss11(cm, &planes[plane], mi_row, lfm);
+          break;
+        case LF_PATH_444:
+          vp9_filter_block_plane_ss00(cm, &planes[plane], mi_row, lfm);
+          break;
+        case LF_PATH_SLOW:
+          vp9_filter_block_plane_non420(cm, &planes[plane], mi + mi_col,
+                                        mi_row, mi_col);
+          break;
       }
     }
   }
 }
 
+static void loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, VP9_COMMON *cm,
+                             struct macroblockd_plane planes[MAX_MB_PLANE],
+                             int start, int stop, int y_only) {
+  int mi_row;
+
+  for (mi_row = start; mi_row < stop; mi_row += MI_BLOCK_SIZE) {
+    loop_filter_cols(frame_buffer, cm, planes, mi_row, 0, cm->mi_cols, y_only);
+  }
+}
+
 void vp9_loop_filter_frame(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
                            MACROBLOCKD *xd, int frame_filter_level, int y_only,
                            int partial_frame) {
@@ -1626,6 +1635,12 @@ void vp9_reset_lfm(VP9_COMMON *const cm) {
   }
 }
 
+void vp9_loop_filter_cols(LFWorkerData *lf_data, int mi_row, int mi_col_start,
+                          int mi_col_end) {
+  loop_filter_cols(lf_data->frame_buffer, lf_data->cm, lf_data->planes, mi_row,
+                   mi_col_start, mi_col_end, lf_data->y_only);
+}
+
 int vp9_loop_filter_worker(void *arg1, void *unused) {
   LFWorkerData *const lf_data = (LFWorkerData *)arg1;
   (void)unused;
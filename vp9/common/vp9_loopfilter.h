@@ -151,6 +151,12 @@ void vp9_loop_filter_data_reset(
     LFWorkerData *lf_data, YV12_BUFFER_CONFIG *frame_buffer,
     struct VP9Common *cm, const struct macroblockd_plane planes[MAX_MB_PLANE]);
 
+// Filters the superblocks of the superblock row at mi_row that start in
+// [mi_col_start, mi_col_end). The superblocks to their left and the rows above
+// must already be filtered.
+void vp9_loop_filter_cols(LFWorkerData *lf_data, int mi_row, int mi_col_start,
+                          int mi_col_end);
+
 // Operates on the rows described by 'arg1' (cast to LFWorkerData *).
 int vp9_loop_filter_worker(void *arg1, void *unused);
 #ifdef __cplusplus
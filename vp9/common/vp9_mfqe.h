@@ -22,7 +22,10 @@ extern "C" {
 // the motion of the blocks and other conditions such as the SAD of
 // the current block and correlated block, the variance of the block
 // difference, etc.
-void vp9_mfqe(struct VP9Common *cm);
+// This runs on the superblock rows start, start + step, ... Each superblock
+// only writes its own area of the post-processing buffer, so the rows can be
+// split between threads.
+void vp9_mfqe_rows(struct VP9Common *cm, int start, int step);
 
 #ifdef __cplusplus
 }  // extern "C"
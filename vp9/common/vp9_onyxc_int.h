@@ -38,8 +38,12 @@ extern "C" {
 #define REF_FRAMES (1 << REF_FRAMES_LOG2)
 
 // 1 scratch frame for the new frame, REFS_PER_FRAME for scaled references on
-// the encoder.
-#define FRAME_BUFFERS (REF_FRAMES + 1 + REFS_PER_FRAME)
+// the encoder. Frame parallel decode additionally needs one scratch frame per
+// frame worker plus one per frame waiting in the output cache, and the
+// application may hold frames.
+#define FRAME_BUFFERS                                         \
+  (REF_FRAMES + 1 + REFS_PER_FRAME + 2 * MAX_DECODE_THREADS + \
+   MAX_BORROWED_FRAMES)
 
 #define FRAME_CONTEXTS_LOG2 2
 #define FRAME_CONTEXTS (1 << FRAME_CONTEXTS_LOG2)
@@ -72,9 +76,25 @@ typedef struct {
   int frame_index;
   vpx_codec_frame_buffer_t raw_frame_buffer;
   YV12_BUFFER_CONFIG buf;
+
+  // Frame parallel decode only: number of luma rows, counted from the top of
+  // the frame, that have been decoded and loop filtered. INT_MAX once the
+  // whole frame is done. Protected by BufferPool::pool_mutex.
+  int row;
+  // Frame parallel decode only: segmentation map written while decoding this
+  // frame, sized mi_rows * mi_cols like mvs.
+  uint8_t *seg_map;
 } RefCntBuffer;
 
 typedef struct BufferPool {
+#if CONFIG_MULTITHREAD
+  // Protect BufferPool from being accessed by several FrameWorkers at
+  // the same time during frame parallel decode.
+  pthread_mutex_t pool_mutex;
+  // Signaled whenever a frame worker makes decoding progress.
+  pthread_cond_t progress_cond;
+#endif
+
   // Private data associated with the frame buffer callbacks.
   void *cb_priv;
 
@@ -239,6 +259,7 @@ typedef struct VP9Common {
 
   int error_resilient_mode;
   int frame_parallel_decoding_mode;
+  int frame_parallel_decode;  // frame-based threading.
 
   int log2_tile_cols, log2_tile_rows;
   int byte_alignment;
@@ -254,6 +275,22 @@ typedef struct VP9Common {
   int lf_row;
 } VP9_COMMON;
 
+static INLINE void lock_buffer_pool(BufferPool *const pool) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&pool->pool_mutex);
+#else
+  (void)pool;
+#endif
+}
+
+static INLINE void unlock_buffer_pool(BufferPool *const pool) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&pool->pool_mutex);
+#else
+  (void)pool;
+#endif
+}
+
 static INLINE YV12_BUFFER_CONFIG *get_buf_frame(VP9_COMMON *cm, int index) {
   if (index < 0 || index >= FRAME_BUFFERS) return NULL;
   if (cm->error.error_code != VPX_CODEC_OK) return NULL;
@@ -23,6 +23,7 @@
 #include "vpx_ports/system_state.h"
 #include "vpx_scale/vpx_scale.h"
 #include "vpx_scale/yv12config.h"
+#include "vpx_util/vpx_thread.h"
 
 #include "vp9/common/vp9_onyxc_int.h"
 #include "vp9/common/vp9_postproc.h"
@@ -33,6 +34,23 @@ static const uint8_t q_diff_thresh = 20;
 static const uint8_t last_q_thresh = 170;
 extern const int16_t vpx_rv[];
 
+// Width of the luma column blocks demacroblocked down by each worker in turn.
+// The noise added by vpx_mbpost_proc_down() repeats every 8 columns, so the
+// blocks give the same result as a single pass.
+#define MBPOST_PROC_DOWN_COLS 64
+
+// Superblock rows, macroblock rows or column blocks start, start + step, ...
+// of the frame filtered by a post-processing worker.
+typedef struct PostProcWorkerData {
+  VP9_COMMON *cm;
+  const YV12_BUFFER_CONFIG *src;
+  YV12_BUFFER_CONFIG *dst;
+  uint8_t *limits;
+  int flimit;  // Demacroblocking filter level, 0 to only deblock.
+  int start;
+  int step;
+} PostProcWorkerData;
+
 #if CONFIG_VP9_HIGHBITDEPTH
 static const int16_t kernel5[] = { 1, 1, 4, 1, 1 };
 
@@ -183,11 +201,141 @@ void vp9_highbd_mbpost_proc_down_c(uint16_t *dst, int pitch, int rows, int cols,
 }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
+// Deblocks the macroblock rows of the job and, for demacroblocking,
+// filters their luma rows across. Each row only reads the source and its own
+// rows of the destination.
+static void deblock_rows(const PostProcWorkerData *data) {
+  const VP9_COMMON *const cm = data->cm;
+  const YV12_BUFFER_CONFIG *const src = data->src;
+  YV12_BUFFER_CONFIG *const dst = data->dst;
+  int mbr;
+
+  for (mbr = data->start; mbr < cm->mb_rows; mbr += data->step) {
+    vpx_post_proc_down_and_across_mb_row(
+        src->y_buffer + 16 * mbr * src->y_stride,
+        dst->y_buffer + 16 * mbr * dst->y_stride, src->y_stride,
+        dst->y_stride, src->y_width, data->limits, 16);
+    vpx_post_proc_down_and_across_mb_row(
+        src->u_buffer + 8 * mbr * src->uv_stride,
+        dst->u_buffer + 8 * mbr * dst->uv_stride, src->uv_stride,
+        dst->uv_stride, src->uv_width, data->limits, 8);
+    vpx_post_proc_down_and_across_mb_row(
+        src->v_buffer + 8 * mbr * src->uv_stride,
+        dst->v_buffer + 8 * mbr * dst->uv_stride, src->uv_stride,
+        dst->uv_stride, src->uv_width, data->limits, 8);
+
+    if (data->flimit) {
+      const int rows = VPXMIN(16, dst->y_height - 16 * mbr);
+      if (rows > 0) {
+        vpx_mbpost_proc_across_ip(dst->y_buffer + 16 * mbr * dst->y_stride,
+                                  dst->y_stride, rows, dst->y_width,
+                                  data->flimit);
+      }
+    }
+  }
+}
+
+static void mbpost_proc_down_cols(const PostProcWorkerData *data) {
+  YV12_BUFFER_CONFIG *const post = data->dst;
+  const int blocks =
+      (post->y_width + MBPOST_PROC_DOWN_COLS - 1) / MBPOST_PROC_DOWN_COLS;
+  int block;
+
+  for (block = data->start; block < blocks; block += data->step) {
+    const int col = block * MBPOST_PROC_DOWN_COLS;
+    vpx_mbpost_proc_down(post->y_buffer + col, post->y_stride, post->y_height,
+                         VPXMIN(MBPOST_PROC_DOWN_COLS, post->y_width - col),
+                         data->flimit);
+  }
+}
+
+static int deblock_worker_hook(void *arg1, void *arg2) {
+  (void)arg2;
+  deblock_rows((const PostProcWorkerData *)arg1);
+  return 1;
+}
+
+static int mbpost_proc_down_worker_hook(void *arg1, void *arg2) {
+  (void)arg2;
+  mbpost_proc_down_cols((const PostProcWorkerData *)arg1);
+  return 1;
+}
+
+static int mfqe_worker_hook(void *arg1, void *arg2) {
+  const PostProcWorkerData *const data = (const PostProcWorkerData *)arg1;
+  (void)arg2;
+  vp9_mfqe_rows(data->cm, data->start, data->step);
+  return 1;
+}
+
+// Runs hook on the job, split between the workers when there is more than
+// one, and returns once all of them are done.
+static void run_post_proc_workers(const PostProcWorkerData *job,
+                                  VPxWorkerHook hook, VPxWorker *workers,
+                                  int num_workers) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  PostProcWorkerData *const worker_data = job->cm->postproc_state.worker_data;
+  int i;
+
+  if (num_workers <= 1) {
+    PostProcWorkerData data = *job;
+    data.start = 0;
+    data.step = 1;
+    hook(&data, NULL);
+    return;
+  }
+
+  assert(num_workers <= job->cm->postproc_state.num_worker_data);
+  for (i = 0; i < num_workers; ++i) {
+    VPxWorker *const worker = &workers[i];
+    PostProcWorkerData *const data = &worker_data[i];
+    *data = *job;
+    data->start = i;
+    data->step = num_workers;
+    worker->hook = hook;
+    worker->data1 = data;
+    worker->data2 = NULL;
+    if (i == num_workers - 1) {
+      winterface->execute(worker);
+    } else {
+      winterface->launch(worker);
+    }
+  }
+
+  for (i = 0; i < num_workers; ++i) winterface->sync(&workers[i]);
+}
+
+static int get_deblock_level(int q) {
+  return (int)(6.0e-05 * q * q * q - 0.0067 * q * q + 0.306 * q + 0.0065 +
+               0.5);
+}
+
+static void deblock_frame(VP9_COMMON *cm, const YV12_BUFFER_CONFIG *src,
+                          YV12_BUFFER_CONFIG *dst, int q, int flimit,
+                          uint8_t *limits, VPxWorker *workers,
+                          int num_workers) {
+  PostProcWorkerData job;
+  memset(limits, (unsigned char)get_deblock_level(q), 16 * cm->mb_cols);
+  memset(&job, 0, sizeof(job));
+  job.cm = cm;
+  job.src = src;
+  job.dst = dst;
+  job.limits = limits;
+  job.flimit = flimit;
+  run_post_proc_workers(&job, deblock_worker_hook, workers, num_workers);
+  // The rows are all filtered across before the columns are filtered down.
+  if (flimit) {
+    run_post_proc_workers(&job, mbpost_proc_down_worker_hook, workers,
+                          num_workers);
+  }
+}
+
 static void deblock_and_de_macro_block(VP9_COMMON *cm,
                                        YV12_BUFFER_CONFIG *source,
                                        YV12_BUFFER_CONFIG *post, int q,
                                        int low_var_thresh, int flag,
-                                       uint8_t *limits) {
+                                       uint8_t *limits, VPxWorker *workers,
+                                       int num_workers) {
   (void)low_var_thresh;
   (void)flag;
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -217,22 +365,19 @@ static void deblock_and_de_macro_block(VP9_COMMON *cm,
         source->uv_height, source->uv_width, ppl);
   } else {
 #endif  // CONFIG_VP9_HIGHBITDEPTH
-    vp9_deblock(cm, source, post, q, limits);
-    vpx_mbpost_proc_across_ip(post->y_buffer, post->y_stride, post->y_height,
-                              post->y_width, q2mbl(q));
-    vpx_mbpost_proc_down(post->y_buffer, post->y_stride, post->y_height,
-                         post->y_width, q2mbl(q));
+    deblock_frame(cm, source, post, q, q2mbl(q), limits, workers,
+                  num_workers);
 #if CONFIG_VP9_HIGHBITDEPTH
   }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 }
 
-void vp9_deblock(struct VP9Common *cm, const YV12_BUFFER_CONFIG *src,
-                 YV12_BUFFER_CONFIG *dst, int q, uint8_t *limits) {
-  const int ppl =
-      (int)(6.0e-05 * q * q * q - 0.0067 * q * q + 0.306 * q + 0.0065 + 0.5);
+static void deblock(struct VP9Common *cm, const YV12_BUFFER_CONFIG *src,
+                    YV12_BUFFER_CONFIG *dst, int q, uint8_t *limits,
+                    VPxWorker *workers, int num_workers) {
 #if CONFIG_VP9_HIGHBITDEPTH
   if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
+    const int ppl = get_deblock_level(q);
     int i;
     const uint8_t *const srcs[3] = { src->y_buffer, src->u_buffer,
                                      src->v_buffer };
@@ -252,30 +397,17 @@ void vp9_deblock(struct VP9Common *cm, const YV12_BUFFER_CONFIG *src,
     }
   } else {
 #endif  // CONFIG_VP9_HIGHBITDEPTH
-    int mbr;
-    const int mb_rows = cm->mb_rows;
-    const int mb_cols = cm->mb_cols;
-    memset(limits, (unsigned char)ppl, 16 * mb_cols);
-
-    for (mbr = 0; mbr < mb_rows; mbr++) {
-      vpx_post_proc_down_and_across_mb_row(
-          src->y_buffer + 16 * mbr * src->y_stride,
-          dst->y_buffer + 16 * mbr * dst->y_stride, src->y_stride,
-          dst->y_stride, src->y_width, limits, 16);
-      vpx_post_proc_down_and_across_mb_row(
-          src->u_buffer + 8 * mbr * src->uv_stride,
-          dst->u_buffer + 8 * mbr * dst->uv_stride, src->uv_stride,
-          dst->uv_stride, src->uv_width, limits, 8);
-      vpx_post_proc_down_and_across_mb_row(
-          src->v_buffer + 8 * mbr * src->uv_stride,
-          dst->v_buffer + 8 * mbr * dst->uv_stride, src->uv_stride,
-          dst->uv_stride, src->uv_width, limits, 8);
-    }
+    deblock_frame(cm, src, dst, q, 0, limits, workers, num_workers);
 #if CONFIG_VP9_HIGHBITDEPTH
   }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 }
 
+void vp9_deblock(struct VP9Common *cm, const YV12_BUFFER_CONFIG *src,
+                 YV12_BUFFER_CONFIG *dst, int q, uint8_t *limits) {
+  deblock(cm, src, dst, q, limits, NULL, 0);
+}
+
 void vp9_denoise(struct VP9Common *cm, const YV12_BUFFER_CONFIG *src,
                  YV12_BUFFER_CONFIG *dst, int q, uint8_t *limits) {
   vp9_deblock(cm, src, dst, q, limits);
@@ -293,7 +425,8 @@ static void swap_mi_and_prev_mi(VP9_COMMON *cm) {
 }
 
 int vp9_post_proc_frame(struct VP9Common *cm, YV12_BUFFER_CONFIG *dest,
-                        vp9_ppflags_t *ppflags, int unscaled_width) {
+                        vp9_ppflags_t *ppflags, int unscaled_width,
+                        VPxWorker *workers, int num_workers) {
   const int q = VPXMIN(105, cm->lf.filter_level * 2);
   const int flags = ppflags->post_proc_flag;
   YV12_BUFFER_CONFIG *const ppbuf = &cm->post_proc_buffer;
@@ -371,11 +504,23 @@ int vp9_post_proc_frame(struct VP9Common *cm, YV12_BUFFER_CONFIG *dest,
     }
   }
 
+  if (num_workers > ppstate->num_worker_data) {
+    vpx_free(ppstate->worker_data);
+    ppstate->num_worker_data = 0;
+    ppstate->worker_data = (PostProcWorkerData *)vpx_calloc(
+        num_workers, sizeof(*ppstate->worker_data));
+    if (!ppstate->worker_data) return 1;
+    ppstate->num_worker_data = num_workers;
+  }
+
   if ((flags & VP9D_MFQE) && cm->current_video_frame >= 2 &&
       ppstate->last_frame_valid && cm->bit_depth == 8 &&
       ppstate->last_base_qindex <= last_q_thresh &&
       cm->base_qindex - ppstate->last_base_qindex >= q_diff_thresh) {
-    vp9_mfqe(cm);
+    PostProcWorkerData job;
+    memset(&job, 0, sizeof(job));
+    job.cm = cm;
+    run_post_proc_workers(&job, mfqe_worker_hook, workers, num_workers);
     // TODO(jackychen): Consider whether enable deblocking by default
     // if mfqe is enabled. Need to take both the quality and the speed
     // into consideration.
@@ -385,19 +530,21 @@ int vp9_post_proc_frame(struct VP9Common *cm, YV12_BUFFER_CONFIG *dest,
     if ((flags & VP9D_DEMACROBLOCK) && cm->post_proc_buffer_int.buffer_alloc) {
       deblock_and_de_macro_block(cm, &cm->post_proc_buffer_int, ppbuf,
                                  q + (ppflags->deblocking_level - 5) * 10, 1, 0,
-                                 cm->postproc_state.limits);
+                                 cm->postproc_state.limits, workers,
+                                 num_workers);
     } else if (flags & VP9D_DEBLOCK) {
-      vp9_deblock(cm, &cm->post_proc_buffer_int, ppbuf, q,
-                  cm->postproc_state.limits);
+      deblock(cm, &cm->post_proc_buffer_int, ppbuf, q,
+              cm->postproc_state.limits, workers, num_workers);
     } else {
       vpx_yv12_copy_frame(&cm->post_proc_buffer_int, ppbuf);
     }
   } else if (flags & VP9D_DEMACROBLOCK) {
     deblock_and_de_macro_block(cm, cm->frame_to_show, ppbuf,
                                q + (ppflags->deblocking_level - 5) * 10, 1, 0,
-                               cm->postproc_state.limits);
+                               cm->postproc_state.limits, workers, num_workers);
   } else if (flags & VP9D_DEBLOCK) {
-    vp9_deblock(cm, cm->frame_to_show, ppbuf, q, cm->postproc_state.limits);
+    deblock(cm, cm->frame_to_show, ppbuf, q, cm->postproc_state.limits,
+            workers, num_workers);
   } else {
     vpx_yv12_copy_frame(cm->frame_to_show, ppbuf);
   }
@@ -13,6 +13,7 @@
 
 #include "vpx_ports/mem.h"
 #include "vpx_scale/yv12config.h"
+#include "vpx_util/vpx_thread.h"
 #include "vp9/common/vp9_blockd.h"
 #include "vp9/common/vp9_mfqe.h"
 #include "vp9/common/vp9_ppflags.h"
@@ -31,14 +32,18 @@ struct postproc_state {
   int clamp;
   uint8_t *limits;
   int8_t *generated_noise;
+  struct PostProcWorkerData *worker_data;
+  int num_worker_data;
 };
 
 struct VP9Common;
 
 #define MFQE_PRECISION 4
 
+// The filters are split by rows or columns between the workers, if any.
 int vp9_post_proc_frame(struct VP9Common *cm, YV12_BUFFER_CONFIG *dest,
-                        vp9_ppflags_t *ppflags, int unscaled_width);
+                        vp9_ppflags_t *ppflags, int unscaled_width,
+                        VPxWorker *workers, int num_workers);
 
 void vp9_denoise(struct VP9Common *cm, const YV12_BUFFER_CONFIG *src,
                  YV12_BUFFER_CONFIG *dst, int q, uint8_t *limits);
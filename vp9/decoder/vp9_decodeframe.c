@@ -9,6 +9,7 @@
  */
 
 #include <assert.h>
+#include <limits.h>
 #include <stdlib.h>  // qsort()
 
 #include "./vp9_rtcd.h"
@@ -21,6 +22,7 @@
 #include "vpx_mem/vpx_mem.h"
 #include "vpx_ports/mem.h"
 #include "vpx_ports/mem_ops.h"
+#include "vpx_ports/vpx_timer.h"
 #include "vpx_scale/vpx_scale.h"
 #include "vpx_util/vpx_thread.h"
 #if CONFIG_BITSTREAM_DEBUG || CONFIG_MISMATCH_DEBUG
@@ -45,6 +47,7 @@
 #include "vp9/decoder/vp9_decodemv.h"
 #include "vp9/decoder/vp9_decoder.h"
 #include "vp9/decoder/vp9_dsubexp.h"
+#include "vp9/decoder/vp9_dthread.h"
 #include "vp9/decoder/vp9_job_queue.h"
 
 #define MAX_VP9_HEADER_SIZE 80
@@ -55,6 +58,26 @@ typedef int (*predict_recon_func)(TileWorkerData *twd, MODE_INFO *const mi,
 typedef void (*intra_recon_func)(TileWorkerData *twd, MODE_INFO *const mi,
                                  int plane, int row, int col, TX_SIZE tx_size);
 
+// Stage timing costs a test of 'stage' when it is disabled.
+static INLINE uint64_t stage_start(const StageCounts *stage) {
+  return stage != NULL ? vpx_timer_ticks() : 0;
+}
+
+// Charges the time since 'start' to 'type' and returns the current time.
+static INLINE uint64_t stage_mark(StageCounts *stage, int type,
+                                  uint64_t start) {
+  if (stage != NULL) {
+    const uint64_t now = vpx_timer_ticks();
+    stage->ticks[type] += now - start;
+    return now;
+  }
+  return 0;
+}
+
+static INLINE void idle_mark(StageCounts *stage, uint64_t start) {
+  if (stage != NULL) stage->idle_ticks += vpx_timer_ticks() - start;
+}
+
 static int read_is_valid(const uint8_t *start, size_t len, const uint8_t *end) {
   return len != 0 && len <= (size_t)(end - start);
 }
@@ -312,6 +335,7 @@ static void predict_and_reconstruct_intra_block(TileWorkerData *twd,
   struct macroblockd_plane *const pd = &xd->plane[plane];
   PREDICTION_MODE mode = (plane == 0) ? mi->mode : mi->uv_mode;
   uint8_t *dst;
+  uint64_t t = stage_start(twd->stage);
   dst = &pd->dst.buf[4 * row * pd->dst.stride + 4 * col];
 
   if (mi->sb_type < BLOCK_8X8)
@@ -319,6 +343,7 @@ static void predict_and_reconstruct_intra_block(TileWorkerData *twd,
 
   vp9_predict_intra_block(xd, pd->n4_wl, tx_size, mode, dst, pd->dst.stride,
                           dst, pd->dst.stride, col, row, plane);
+  t = stage_mark(twd->stage, VP9_STAGE_PREDICTION, t);
 
   if (!mi->skip) {
     const TX_TYPE tx_type =
@@ -328,9 +353,11 @@ static void predict_and_reconstruct_intra_block(TileWorkerData *twd,
                                : &vp9_scan_orders[tx_size][tx_type];
     const int eob = vp9_decode_block_tokens(twd, plane, sc, col, row, tx_size,
                                             mi->segment_id);
+    t = stage_mark(twd->stage, VP9_STAGE_DETOKENIZE, t);
     if (eob > 0) {
       inverse_transform_block_intra(xd, plane, tx_type, tx_size, dst,
                                     pd->dst.stride, eob);
+      stage_mark(twd->stage, VP9_STAGE_INVERSE_TRANSFORM, t);
     }
   }
 }
@@ -368,12 +395,14 @@ static void predict_and_reconstruct_intra_block_row_mt(TileWorkerData *twd,
   struct macroblockd_plane *const pd = &xd->plane[plane];
   PREDICTION_MODE mode = (plane == 0) ? mi->mode : mi->uv_mode;
   uint8_t *dst = &pd->dst.buf[4 * row * pd->dst.stride + 4 * col];
+  uint64_t t = stage_start(twd->stage);
 
   if (mi->sb_type < BLOCK_8X8)
     if (plane == 0) mode = xd->mi[0]->bmi[(row << 1) + col].as_mode;
 
   vp9_predict_intra_block(xd, pd->n4_wl, tx_size, mode, dst, pd->dst.stride,
                           dst, pd->dst.stride, col, row, plane);
+  t = stage_mark(twd->stage, VP9_STAGE_PREDICTION, t);
 
   if (!mi->skip) {
     const TX_TYPE tx_type =
@@ -381,6 +410,7 @@ static void predict_and_reconstruct_intra_block_row_mt(TileWorkerData *twd,
     if (*pd->eob > 0) {
       inverse_transform_block_intra(xd, plane, tx_type, tx_size, dst,
                                     pd->dst.stride, *pd->eob);
+      stage_mark(twd->stage, VP9_STAGE_INVERSE_TRANSFORM, t);
     }
     /* Keep the alignment to 16 */
     pd->dqcoeff += (16 << (tx_size << 1));
@@ -394,12 +424,17 @@ static int reconstruct_inter_block(TileWorkerData *twd, MODE_INFO *const mi,
   MACROBLOCKD *const xd = &twd->xd;
   struct macroblockd_plane *const pd = &xd->plane[plane];
   const scan_order *sc = &vp9_default_scan_orders[tx_size];
+  const uint64_t t = stage_start(twd->stage);
   const int eob = vp9_decode_block_tokens(twd, plane, sc, col, row, tx_size,
                                           mi->segment_id);
   uint8_t *dst = &pd->dst.buf[4 * row * pd->dst.stride + 4 * col];
 
   if (eob > 0) {
+    const uint64_t t_itx = stage_mark(twd->stage, VP9_STAGE_DETOKENIZE, t);
     inverse_transform_block_inter(xd, plane, tx_size, dst, pd->dst.stride, eob);
+    stage_mark(twd->stage, VP9_STAGE_INVERSE_TRANSFORM, t_itx);
+  } else {
+    stage_mark(twd->stage, VP9_STAGE_DETOKENIZE, t);
   }
 #if CONFIG_MISMATCH_DEBUG
   {
@@ -574,9 +609,20 @@ static void extend_and_predict(const uint8_t *buf_ptr1, int pre_buf_stride,
 }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
+// Blocks until rows [0, last_row] of a reference plane can be read. The last
+// row is clamped to the plane, so predictions that reach into the border wait
+// for the edge rows they replicate.
+static INLINE void wait_for_ref_rows(VP9Decoder *const pbi,
+                                     RefCntBuffer *const ref_frame_buf,
+                                     int last_row, int plane_height,
+                                     int subsampling_y) {
+  last_row = clamp(last_row, 0, plane_height - 1);
+  vp9_frameworker_wait(pbi, ref_frame_buf, (last_row + 1) << subsampling_y);
+}
+
 static void dec_build_inter_predictors(
-    MACROBLOCKD *xd, int plane, int bw, int bh, int x, int y, int w, int h,
-    int mi_x, int mi_y, const InterpKernel *kernel,
+    VP9Decoder *const pbi, MACROBLOCKD *xd, int plane, int bw, int bh, int x,
+    int y, int w, int h, int mi_x, int mi_y, const InterpKernel *kernel,
     const struct scale_factors *sf, struct buf_2d *pre_buf,
     struct buf_2d *dst_buf, const MV *mv, RefCntBuffer *ref_frame_buf,
     int is_scaled, int ref) {
@@ -678,6 +724,11 @@ static void dec_build_inter_predictors(
       y_pad = 1;
     }
 
+    // Wait until the reference rows are ready in frame parallel decode.
+    if (pbi->common.frame_parallel_decode)
+      wait_for_ref_rows(pbi, ref_frame_buf, y1, frame_height,
+                        pd->subsampling_y);
+
     // Skip border extension if block is inside the frame.
     if (x0 < 0 || x0 > frame_width - 1 || x1 < 0 || x1 > frame_width - 1 ||
         y0 < 0 || y0 > frame_height - 1 || y1 < 0 || y1 > frame_height - 1) {
@@ -696,6 +747,9 @@ static void dec_build_inter_predictors(
                          w, h, ref, xs, ys);
       return;
     }
+  } else if (pbi->common.frame_parallel_decode) {
+    wait_for_ref_rows(pbi, ref_frame_buf, y0 + h - 1, frame_height,
+                      pd->subsampling_y);
   }
 #if CONFIG_VP9_HIGHBITDEPTH
   if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
@@ -755,10 +809,10 @@ static void dec_build_inter_predictors_sb(VP9Decoder *const pbi,
         for (y = 0; y < num_4x4_h; ++y) {
           for (x = 0; x < num_4x4_w; ++x) {
             const MV mv = average_split_mvs(pd, mi, ref, i++);
-            dec_build_inter_predictors(xd, plane, n4w_x4, n4h_x4, 4 * x, 4 * y,
-                                       4, 4, mi_x, mi_y, kernel, sf, pre_buf,
-                                       dst_buf, &mv, ref_frame_buf, is_scaled,
-                                       ref);
+            dec_build_inter_predictors(pbi, xd, plane, n4w_x4, n4h_x4, 4 * x,
+                                       4 * y, 4, 4, mi_x, mi_y, kernel, sf,
+                                       pre_buf, dst_buf, &mv, ref_frame_buf,
+                                       is_scaled, ref);
           }
         }
       }
@@ -772,9 +826,10 @@ static void dec_build_inter_predictors_sb(VP9Decoder *const pbi,
         const int n4w_x4 = 4 * num_4x4_w;
         const int n4h_x4 = 4 * num_4x4_h;
         struct buf_2d *const pre_buf = &pd->pre[ref];
-        dec_build_inter_predictors(xd, plane, n4w_x4, n4h_x4, 0, 0, n4w_x4,
-                                   n4h_x4, mi_x, mi_y, kernel, sf, pre_buf,
-                                   dst_buf, &mv, ref_frame_buf, is_scaled, ref);
+        dec_build_inter_predictors(pbi, xd, plane, n4w_x4, n4h_x4, 0, 0,
+                                   n4w_x4, n4h_x4, mi_x, mi_y, kernel, sf,
+                                   pre_buf, dst_buf, &mv, ref_frame_buf,
+                                   is_scaled, ref);
       }
     }
   }
@@ -918,6 +973,7 @@ static void decode_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
   const int y_mis = VPXMIN(bh, cm->mi_rows - mi_row);
   vpx_reader *r = &twd->bit_reader;
   MACROBLOCKD *const xd = &twd->xd;
+  uint64_t t = stage_start(twd->stage);
 
   MODE_INFO *mi = set_offsets(cm, xd, bsize, mi_row, mi_col, bw, bh, x_mis,
                               y_mis, bwl, bhl);
@@ -931,6 +987,7 @@ static void decode_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
   }
 
   vp9_read_mode_info(twd, pbi, mi_row, mi_col, x_mis, y_mis);
+  t = stage_mark(twd->stage, VP9_STAGE_MODE_INFO, t);
 
   if (mi->skip) {
     dec_reset_skip_context(xd);
@@ -965,6 +1022,7 @@ static void decode_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
   } else {
     // Prediction
     dec_build_inter_predictors_sb(pbi, xd, mi_row, mi_col);
+    stage_mark(twd->stage, VP9_STAGE_PREDICTION, t);
 #if CONFIG_MISMATCH_DEBUG
     {
       int plane;
@@ -1048,11 +1106,14 @@ static void recon_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
                         predict_and_reconstruct_intra_block_row_mt);
   } else {
     // Prediction
+    uint64_t t = stage_start(twd->stage);
     dec_build_inter_predictors_sb(pbi, xd, mi_row, mi_col);
+    t = stage_mark(twd->stage, VP9_STAGE_PREDICTION, t);
 
     // Reconstruction
     if (!mi->skip) {
       predict_recon_inter(xd, mi, twd, reconstruct_inter_block_row_mt);
+      stage_mark(twd->stage, VP9_STAGE_INVERSE_TRANSFORM, t);
     }
   }
 
@@ -1068,6 +1129,7 @@ static void parse_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
   const int y_mis = VPXMIN(bh, cm->mi_rows - mi_row);
   vpx_reader *r = &twd->bit_reader;
   MACROBLOCKD *const xd = &twd->xd;
+  uint64_t t = stage_start(twd->stage);
 
   MODE_INFO *mi = set_offsets(cm, xd, bsize, mi_row, mi_col, bw, bh, x_mis,
                               y_mis, bwl, bhl);
@@ -1081,6 +1143,7 @@ static void parse_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
   }
 
   vp9_read_mode_info(twd, pbi, mi_row, mi_col, x_mis, y_mis);
+  t = stage_mark(twd->stage, VP9_STAGE_MODE_INFO, t);
 
   if (mi->skip) {
     dec_reset_skip_context(xd);
@@ -1115,6 +1178,8 @@ static void parse_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
     }
   }
 
+  stage_mark(twd->stage, VP9_STAGE_DETOKENIZE, t);
+
   xd->corrupted |= vpx_reader_has_error(r);
 }
 
@@ -1473,6 +1538,12 @@ static void resize_mv_buffer(VP9_COMMON *cm) {
   CHECK_MEM_ERROR(cm, cm->cur_frame->mvs,
                   (MV_REF *)vpx_calloc(cm->mi_rows * cm->mi_cols,
                                        sizeof(*cm->cur_frame->mvs)));
+  if (cm->frame_parallel_decode) {
+    vpx_free(cm->cur_frame->seg_map);
+    CHECK_MEM_ERROR(cm, cm->cur_frame->seg_map,
+                    (uint8_t *)vpx_calloc(cm->mi_rows * cm->mi_cols,
+                                          sizeof(*cm->cur_frame->seg_map)));
+  }
 }
 
 static void resize_context_buffers(VP9_COMMON *cm, int width, int height) {
@@ -1508,7 +1579,8 @@ static void resize_context_buffers(VP9_COMMON *cm, int width, int height) {
     cm->height = height;
   }
   if (cm->cur_frame->mvs == NULL || cm->mi_rows > cm->cur_frame->mi_rows ||
-      cm->mi_cols > cm->cur_frame->mi_cols) {
+      cm->mi_cols > cm->cur_frame->mi_cols ||
+      (cm->frame_parallel_decode && cm->cur_frame->seg_map == NULL)) {
     resize_mv_buffer(cm);
   }
 }
@@ -1520,6 +1592,7 @@ static void setup_frame_size(VP9_COMMON *cm, struct vpx_read_bit_buffer *rb) {
   resize_context_buffers(cm, width, height);
   setup_render_size(cm, rb);
 
+  lock_buffer_pool(pool);
   if (vpx_realloc_frame_buffer(
           get_frame_new_buffer(cm), cm->width, cm->height, cm->subsampling_x,
           cm->subsampling_y,
@@ -1529,9 +1602,11 @@ static void setup_frame_size(VP9_COMMON *cm, struct vpx_read_bit_buffer *rb) {
           VP9_DEC_BORDER_IN_PIXELS, cm->byte_alignment,
           &pool->frame_bufs[cm->new_fb_idx].raw_frame_buffer, pool->get_fb_cb,
           pool->cb_priv)) {
+    unlock_buffer_pool(pool);
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate frame buffer");
   }
+  unlock_buffer_pool(pool);
 
   pool->frame_bufs[cm->new_fb_idx].released = 0;
   pool->frame_bufs[cm->new_fb_idx].buf.subsampling_x = cm->subsampling_x;
@@ -1604,6 +1679,7 @@ static void setup_frame_size_with_refs(VP9_COMMON *cm,
   resize_context_buffers(cm, width, height);
   setup_render_size(cm, rb);
 
+  lock_buffer_pool(pool);
   if (vpx_realloc_frame_buffer(
           get_frame_new_buffer(cm), cm->width, cm->height, cm->subsampling_x,
           cm->subsampling_y,
@@ -1613,9 +1689,11 @@ static void setup_frame_size_with_refs(VP9_COMMON *cm,
           VP9_DEC_BORDER_IN_PIXELS, cm->byte_alignment,
           &pool->frame_bufs[cm->new_fb_idx].raw_frame_buffer, pool->get_fb_cb,
           pool->cb_priv)) {
+    unlock_buffer_pool(pool);
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate frame buffer");
   }
+  unlock_buffer_pool(pool);
 
   pool->frame_bufs[cm->new_fb_idx].released = 0;
   pool->frame_bufs[cm->new_fb_idx].buf.subsampling_x = cm->subsampling_x;
@@ -1760,7 +1838,11 @@ static void vp9_tile_done(VP9Decoder *pbi) {
   terminate = all_parse_done == row_mt_worker_data->num_tiles_done;
   pthread_mutex_unlock(&row_mt_worker_data->recon_done_mutex);
   if (terminate) {
-    vp9_jobq_terminate(&row_mt_worker_data->jobq);
+    if (row_mt_worker_data->use_jobq) {
+      vp9_jobq_terminate(&row_mt_worker_data->jobq);
+    } else {
+      vp9_jobsched_terminate(&row_mt_worker_data->jobsched);
+    }
   }
 #else
   (void)pbi;
@@ -1773,10 +1855,51 @@ static void vp9_jobq_alloc(VP9Decoder *pbi) {
   const int aligned_rows = mi_cols_aligned_to_sb(cm->mi_rows);
   const int sb_rows = aligned_rows >> MI_BLOCK_SIZE_LOG2;
   const int tile_cols = 1 << cm->log2_tile_cols;
-  const size_t jobq_size = (tile_cols * sb_rows * 2 + sb_rows) * sizeof(Job);
+  const int num_jobs = tile_cols * sb_rows * 2 + sb_rows;
+  const size_t jobq_size = num_jobs * sizeof(Job);
+#if CONFIG_MULTITHREAD
+  // Any worker may end up queuing every job of the frame.
+  const int num_lists = pbi->max_threads;
+
+  if (num_jobs > row_mt_worker_data->job_list_size ||
+      num_lists > row_mt_worker_data->num_job_lists) {
+    vpx_free(row_mt_worker_data->job_lists);
+    vpx_free(row_mt_worker_data->job_list_buf);
+    row_mt_worker_data->job_list_size = 0;
+    row_mt_worker_data->num_job_lists = 0;
+    row_mt_worker_data->job_list_buf = (vpx_atomic_int *)vpx_calloc(
+        num_lists * num_jobs, sizeof(*row_mt_worker_data->job_list_buf));
+    row_mt_worker_data->job_lists = (JobListRowMt *)vpx_calloc(
+        num_lists, sizeof(*row_mt_worker_data->job_lists));
+    if (row_mt_worker_data->job_list_buf != NULL &&
+        row_mt_worker_data->job_lists != NULL) {
+      vp9_jobsched_set_lists(&row_mt_worker_data->jobsched,
+                             row_mt_worker_data->job_lists,
+                             row_mt_worker_data->job_list_buf, num_lists,
+                             num_jobs);
+      row_mt_worker_data->job_list_size = num_jobs;
+      row_mt_worker_data->num_job_lists = num_lists;
+    } else {
+      vpx_free(row_mt_worker_data->job_lists);
+      vpx_free(row_mt_worker_data->job_list_buf);
+      row_mt_worker_data->job_lists = NULL;
+      row_mt_worker_data->job_list_buf = NULL;
+    }
+  }
+
+  // The jobs go through the mutex based jobq if the job lists could not be
+  // allocated.
+  row_mt_worker_data->use_jobq = row_mt_worker_data->job_lists == NULL;
+  if (!row_mt_worker_data->use_jobq) return;
+#endif  // CONFIG_MULTITHREAD
 
   if (jobq_size > row_mt_worker_data->jobq_size) {
-    vpx_free(row_mt_worker_data->jobq_buf);
+    if (row_mt_worker_data->jobq_buf != NULL) {
+      vp9_jobq_deinit(&row_mt_worker_data->jobq);
+      vpx_free(row_mt_worker_data->jobq_buf);
+      row_mt_worker_data->jobq_buf = NULL;
+      row_mt_worker_data->jobq_size = 0;
+    }
     CHECK_MEM_ERROR(cm, row_mt_worker_data->jobq_buf, vpx_calloc(1, jobq_size));
     vp9_jobq_init(&row_mt_worker_data->jobq, row_mt_worker_data->jobq_buf,
                   jobq_size);
@@ -1784,9 +1907,51 @@ static void vp9_jobq_alloc(VP9Decoder *pbi) {
   }
 }
 
+// Jobs are queued on the job list of |worker_id|, or on the shared jobq when
+// built without threads or when the job lists could not be allocated.
+static void queue_job(RowMTWorkerData *const row_mt_worker_data, int worker_id,
+                      const Job *job) {
+#if CONFIG_MULTITHREAD
+  if (!row_mt_worker_data->use_jobq) {
+    assert(job->tile_col < (1 << 6));
+    vp9_jobsched_queue(
+        &row_mt_worker_data->jobsched, worker_id,
+        (job->row_num << 8) | (job->tile_col << 2) | (int)job->job_type);
+    return;
+  }
+#endif  // CONFIG_MULTITHREAD
+  (void)worker_id;
+  vp9_jobq_queue(&row_mt_worker_data->jobq, job, sizeof(*job));
+}
+
+// The time spent waiting for a job is charged to 'stage' as idle time.
+static int dequeue_job(RowMTWorkerData *const row_mt_worker_data,
+                       int worker_id, Job *job, StageCounts *stage) {
+  const uint64_t t = stage_start(stage);
+  int done;
+#if CONFIG_MULTITHREAD
+  if (!row_mt_worker_data->use_jobq) {
+    int code;
+    done =
+        vp9_jobsched_dequeue(&row_mt_worker_data->jobsched, worker_id, &code);
+    if (!done) {
+      job->row_num = code >> 8;
+      job->tile_col = (code >> 2) & 63;
+      job->job_type = (JobType)(code & 3);
+    }
+    idle_mark(stage, t);
+    return done;
+  }
+#endif  // CONFIG_MULTITHREAD
+  (void)worker_id;
+  done = vp9_jobq_dequeue(&row_mt_worker_data->jobq, job, sizeof(*job), 1);
+  idle_mark(stage, t);
+  return done;
+}
+
 static void recon_tile_row(TileWorkerData *tile_data, VP9Decoder *pbi,
                            int mi_row, int is_last_row, VP9LfSync *lf_sync,
-                           int cur_tile_col) {
+                           int cur_tile_col, int worker_id) {
   VP9_COMMON *const cm = &pbi->common;
   RowMTWorkerData *const row_mt_worker_data = pbi->row_mt_worker_data;
   const int tile_cols = 1 << cm->log2_tile_cols;
@@ -1831,15 +1996,14 @@ static void recon_tile_row(TileWorkerData *tile_data, VP9Decoder *pbi,
         if (is_lpf_job_ready) {
           Job lpf_job;
           lpf_job.job_type = LPF_JOB;
+          lpf_job.tile_col = 0;
           if (cur_sb_row > 0) {
             lpf_job.row_num = mi_row - MI_BLOCK_SIZE;
-            vp9_jobq_queue(&row_mt_worker_data->jobq, &lpf_job,
-                           sizeof(lpf_job));
+            queue_job(row_mt_worker_data, worker_id, &lpf_job);
           }
           if (is_last_row) {
             lpf_job.row_num = mi_row;
-            vp9_jobq_queue(&row_mt_worker_data->jobq, &lpf_job,
-                           sizeof(lpf_job));
+            queue_job(row_mt_worker_data, worker_id, &lpf_job);
           }
         }
       }
@@ -1888,6 +2052,7 @@ static void parse_tile_row(TileWorkerData *tile_data, VP9Decoder *pbi,
         row_mt_worker_data->partition + sb_num * PARTITIONS_PER_SB;
     process_partition(tile_data, pbi, mi_row, mi_col, BLOCK_64X64, 4, PARSE,
                       parse_block);
+    if (tile_data->stage != NULL) ++tile_data->stage->superblocks;
   }
 }
 
@@ -1904,9 +2069,12 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
   Job job;
   LFWorkerData *lf_data = thread_data->lf_data;
   VP9LfSync *lf_sync = thread_data->lf_sync;
+  const int worker_id = (int)(thread_data - row_mt_worker_data->thread_data);
+  StageCounts *volatile const stage =
+      pbi->stage_stats ? &thread_data->stage_counts : NULL;
   volatile int corrupted = 0;
 
-  while (!vp9_jobq_dequeue(&row_mt_worker_data->jobq, &job, sizeof(job), 1)) {
+  while (!dequeue_job(row_mt_worker_data, worker_id, &job, stage)) {
     int mi_col;
     const int mi_row = job.row_num;
 
@@ -1916,7 +2084,9 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
 
       if (cm->lf.filter_level && !cm->skip_loop_filter &&
           mi_row < cm->mi_rows) {
+        const uint64_t t = stage_start(stage);
         vp9_loopfilter_job(lf_data, lf_sync);
+        stage_mark(stage, VP9_STAGE_LOOP_FILTER, t);
       }
     } else if (job.job_type == RECON_JOB) {
       const int cur_sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
@@ -1926,6 +2096,7 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
       int mi_col_start, mi_col_end;
 
       tile_data_recon->xd = pbi->mb;
+      tile_data_recon->stage = stage;
       vp9_tile_init(&tile_data_recon->xd.tile, cm, 0, job.tile_col);
       vp9_init_macroblockd(cm, &tile_data_recon->xd, tile_data_recon->dqcoeff);
       mi_col_start = tile_data_recon->xd.tile.mi_col_start;
@@ -1951,7 +2122,7 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
       tile_data_recon->xd.error_info = &tile_data_recon->error_info;
 
       recon_tile_row(tile_data_recon, pbi, mi_row, is_last_row, lf_sync,
-                     job.tile_col);
+                     job.tile_col, worker_id);
 
       if (corrupted)
         vpx_internal_error(&tile_data_recon->error_info,
@@ -1974,6 +2145,8 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
       tile_data->xd = pbi->mb;
       tile_data->xd.counts =
           cm->frame_parallel_decoding_mode ? 0 : &tile_data->counts;
+      // Parse jobs of a tile may run on any thread.
+      tile_data->stage = stage;
 
       tile_data->error_info.setjmp = 1;
 
@@ -1990,8 +2163,7 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
         recon_job.row_num = mi_row;
         recon_job.tile_col = job.tile_col;
         recon_job.job_type = RECON_JOB;
-        vp9_jobq_queue(&row_mt_worker_data->jobq, &recon_job,
-                       sizeof(recon_job));
+        queue_job(row_mt_worker_data, worker_id, &recon_job);
       }
 
       /* Queue next parse job */
@@ -2000,8 +2172,7 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
         parse_job.row_num = mi_row + MI_BLOCK_SIZE;
         parse_job.tile_col = job.tile_col;
         parse_job.job_type = PARSE_JOB;
-        vp9_jobq_queue(&row_mt_worker_data->jobq, &parse_job,
-                       sizeof(parse_job));
+        queue_job(row_mt_worker_data, worker_id, &parse_job);
       }
     }
   }
@@ -2009,6 +2180,15 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
   return !corrupted;
 }
 
+static int loop_filter_worker_hook(void *arg1, void *arg2) {
+  VP9Decoder *const pbi = (VP9Decoder *)arg2;
+  StageCounts *const stage = pbi->stage_stats ? &pbi->lf_stage_counts : NULL;
+  const uint64_t t = stage_start(stage);
+  const int ret = vp9_loop_filter_worker(arg1, NULL);
+  stage_mark(stage, VP9_STAGE_LOOP_FILTER, t);
+  return ret;
+}
+
 static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
                                    const uint8_t *data_end) {
   VP9_COMMON *const cm = &pbi->common;
@@ -2020,12 +2200,31 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
   int tile_row, tile_col;
   int mi_row, mi_col;
   TileWorkerData *tile_data = NULL;
+  // All the tiles are decoded by this thread.
+  StageCounts *const stage = pbi->stage_stats ? &pbi->stage_counts : NULL;
+  uint64_t t;
+  // Frame parallel decode: frame the segmentation map is predicted from.
+  RefCntBuffer *const seg_map_buf =
+      cm->frame_parallel_decode && cm->seg.enabled && cm->last_frame_seg_map
+          ? pbi->prev_seg_map_buf
+          : NULL;
+  // Filter the superblock row above each superblock as soon as the
+  // superblocks that predict from it have been decoded, rather than walking
+  // the whole row again once it is complete. This needs the tiles of a row to
+  // be decoded left to right.
+  const int fuse_lf = cm->lf.filter_level && !cm->skip_loop_filter &&
+                      pbi->fused_lf && pbi->max_threads <= 1 &&
+                      !pbi->inv_tile_order;
 
   if (cm->lf.filter_level && !cm->skip_loop_filter &&
       pbi->lf_worker.data1 == NULL) {
     CHECK_MEM_ERROR(cm, pbi->lf_worker.data1,
                     vpx_memalign(32, sizeof(LFWorkerData)));
-    pbi->lf_worker.hook = vp9_loop_filter_worker;
+    pbi->lf_worker.hook = loop_filter_worker_hook;
+    pbi->lf_worker.data2 = pbi;
+    // The loop filter does not wait on other jobs, so it can be queued on the
+    // pool without reserving a thread.
+    pbi->lf_worker.pool = pbi->worker_pool;
     if (pbi->max_threads > 1 && !winterface->reset(&pbi->lf_worker)) {
       vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
                          "Loop filter thread creation failed");
@@ -2064,6 +2263,7 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
       tile_data->xd.corrupted = 0;
       tile_data->xd.counts =
           cm->frame_parallel_decoding_mode ? NULL : &cm->counts;
+      tile_data->stage = stage;
       vp9_zero(tile_data->dqcoeff);
       vp9_tile_init(&tile_data->xd.tile, cm, tile_row, tile_col);
       setup_token_decoder(buf->data, data_end, buf->size, &cm->error,
@@ -2078,6 +2278,17 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
     vp9_tile_set_row(&tile, cm, tile_row);
     for (mi_row = tile.mi_row_start; mi_row < tile.mi_row_end;
          mi_row += MI_BLOCK_SIZE) {
+      if (cm->frame_parallel_decode) {
+        // The previous frame's motion vectors and segmentation map are read
+        // co-located, so only this superblock row of them is needed.
+        const int sb_row_end = (mi_row + MI_BLOCK_SIZE) * MI_SIZE;
+        t = stage_start(stage);
+        if (cm->use_prev_frame_mvs)
+          vp9_frameworker_wait(pbi, cm->prev_frame, sb_row_end);
+        if (seg_map_buf != NULL)
+          vp9_frameworker_wait(pbi, seg_map_buf, sb_row_end);
+        idle_mark(stage, t);
+      }
       for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
         const int col =
             pbi->inv_tile_order ? tile_cols - tile_col - 1 : tile_col;
@@ -2110,6 +2321,16 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
           } else {
             decode_partition(tile_data, pbi, mi_row, mi_col, BLOCK_64X64, 4);
           }
+          if (stage != NULL) ++stage->superblocks;
+          // This superblock was the last to predict from the unfiltered
+          // pixels of the one above the previous superblock.
+          if (fuse_lf && mi_row >= MI_BLOCK_SIZE && mi_col >= MI_BLOCK_SIZE) {
+            t = stage_start(stage);
+            vp9_loop_filter_cols((LFWorkerData *)pbi->lf_worker.data1,
+                                 mi_row - MI_BLOCK_SIZE, mi_col - MI_BLOCK_SIZE,
+                                 mi_col);
+            stage_mark(stage, VP9_STAGE_LOOP_FILTER, t);
+          }
         }
         pbi->mb.corrupted |= tile_data->xd.corrupted;
         if (pbi->mb.corrupted)
@@ -2124,17 +2345,43 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
         // delay the loopfilter by 1 macroblock row.
         if (lf_start < 0) continue;
 
+        if (fuse_lf) {
+          // Finish the row above with its last superblock.
+          t = stage_start(stage);
+          vp9_loop_filter_cols(lf_data, lf_start,
+                               (cm->mi_cols - 1) & ~(MI_BLOCK_SIZE - 1),
+                               cm->mi_cols);
+          stage_mark(stage, VP9_STAGE_LOOP_FILTER, t);
+          lf_data->start = lf_start;
+          lf_data->stop = mi_row;
+          if (cm->frame_parallel_decode)
+            vp9_frameworker_broadcast(cm->buffer_pool, pbi->cur_buf,
+                                      mi_row * MI_SIZE - 16);
+          continue;
+        }
+
         // decoding has completed: finish up the loop filter in this thread.
         if (mi_row + MI_BLOCK_SIZE >= cm->mi_rows) continue;
 
+        t = stage_start(stage);
         winterface->sync(&pbi->lf_worker);
+        idle_mark(stage, t);
         lf_data->start = lf_start;
         lf_data->stop = mi_row;
         if (pbi->max_threads > 1) {
           winterface->launch(&pbi->lf_worker);
         } else {
           winterface->execute(&pbi->lf_worker);
+          // Filtering the next superblock row may still modify up to 7
+          // pixel rows above it in every plane, i.e. 14 luma rows when the
+          // chroma planes are subsampled vertically.
+          if (cm->frame_parallel_decode)
+            vp9_frameworker_broadcast(cm->buffer_pool, pbi->cur_buf,
+                                      mi_row * MI_SIZE - 16);
         }
+      } else if (cm->frame_parallel_decode) {
+        vp9_frameworker_broadcast(cm->buffer_pool, pbi->cur_buf,
+                                  (mi_row + MI_BLOCK_SIZE) * MI_SIZE);
       }
     }
   }
@@ -2142,12 +2389,17 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
   // Loopfilter remaining rows in the frame.
   if (cm->lf.filter_level && !cm->skip_loop_filter) {
     LFWorkerData *const lf_data = (LFWorkerData *)pbi->lf_worker.data1;
+    t = stage_start(stage);
     winterface->sync(&pbi->lf_worker);
+    idle_mark(stage, t);
     lf_data->start = lf_data->stop;
     lf_data->stop = cm->mi_rows;
     winterface->execute(&pbi->lf_worker);
   }
 
+  if (cm->frame_parallel_decode)
+    vp9_frameworker_broadcast(cm->buffer_pool, pbi->cur_buf, INT_MAX);
+
   // Get last tile data.
   tile_data = pbi->tile_worker_data + tile_cols * tile_rows - 1;
 
@@ -2232,6 +2484,7 @@ static int tile_worker_hook(void *arg1, void *arg2) {
       for (mi_col = tile->mi_col_start; mi_col < tile->mi_col_end;
            mi_col += MI_BLOCK_SIZE) {
         decode_partition(tile_data, pbi, mi_row, mi_col, BLOCK_64X64, 4);
+        if (tile_data->stage != NULL) ++tile_data->stage->superblocks;
       }
       if (pbi->lpf_mt_opt && cm->lf.filter_level && !cm->skip_loop_filter) {
         const int aligned_rows = mi_cols_aligned_to_sb(cm->mi_rows);
@@ -2260,7 +2513,9 @@ static int tile_worker_hook(void *arg1, void *arg2) {
 
   if (pbi->lpf_mt_opt && !tile_data->xd.corrupted && cm->lf.filter_level &&
       !cm->skip_loop_filter) {
+    const uint64_t t = stage_start(tile_data->stage);
     vp9_loopfilter_rows(lf_data, lf_sync);
+    stage_mark(tile_data->stage, VP9_STAGE_LOOP_FILTER, t);
   }
 
   tile_data->data_end = bit_reader_end;
@@ -2275,26 +2530,13 @@ static int compare_tile_buffers(const void *a, const void *b) {
 }
 
 static INLINE void init_mt(VP9Decoder *pbi) {
-  int n;
   VP9_COMMON *const cm = &pbi->common;
   VP9LfSync *lf_row_sync = &pbi->lf_row_sync;
   const int aligned_mi_cols = mi_cols_aligned_to_sb(cm->mi_cols);
-  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
-
-  if (pbi->num_tile_workers == 0) {
-    const int num_threads = pbi->max_threads;
-    CHECK_MEM_ERROR(cm, pbi->tile_workers,
-                    vpx_malloc(num_threads * sizeof(*pbi->tile_workers)));
-    for (n = 0; n < num_threads; ++n) {
-      VPxWorker *const worker = &pbi->tile_workers[n];
-      ++pbi->num_tile_workers;
 
-      winterface->init(worker);
-      if (n < num_threads - 1 && !winterface->reset(worker)) {
-        vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
-                           "Tile decoder thread creation failed");
-      }
-    }
+  if (pbi->num_tile_workers == 0 && !vp9_create_tile_workers(pbi)) {
+    vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
+                       "Tile decoder thread creation failed");
   }
 
   // Initialize LPF
@@ -2315,6 +2557,18 @@ static INLINE void init_mt(VP9Decoder *pbi) {
   vp9_reset_lfm(cm);
 }
 
+// Returns how many of |num_workers| tile workers, including the one run by
+// the calling thread, can be launched. The workers wait on each other so with
+// a pool they are limited to the threads that can be reserved for them, which
+// are released once the workers have been synced.
+static int reserve_pool_workers(VP9Decoder *pbi, int num_workers) {
+  if (pbi->worker_pool == NULL) return num_workers;
+  assert(pbi->num_pool_workers == 0);
+  pbi->num_pool_workers =
+      vpx_worker_pool_reserve(pbi->worker_pool, num_workers - 1);
+  return pbi->num_pool_workers + 1;
+}
+
 static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
                                                const uint8_t *data,
                                                const uint8_t *data_end) {
@@ -2323,7 +2577,7 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
   const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
   const int tile_cols = 1 << cm->log2_tile_cols;
   const int tile_rows = 1 << cm->log2_tile_rows;
-  const int num_workers = pbi->max_threads;
+  int num_workers;
   int i, n;
   int col;
   int corrupted = 0;
@@ -2331,6 +2585,8 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
   const int sb_cols = mi_cols_aligned_to_sb(cm->mi_cols) >> MI_BLOCK_SIZE_LOG2;
   VP9LfSync *lf_row_sync = &pbi->lf_row_sync;
   YV12_BUFFER_CONFIG *const new_fb = get_frame_new_buffer(cm);
+  StageCounts *const stage = pbi->stage_stats ? &pbi->stage_counts : NULL;
+  uint64_t t;
 
   assert(tile_cols <= (1 << 6));
   assert(tile_rows == 1);
@@ -2340,6 +2596,7 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
          sb_rows * sb_cols * sizeof(*row_mt_worker_data->recon_map));
 
   init_mt(pbi);
+  num_workers = reserve_pool_workers(pbi, pbi->max_threads);
 
   // Reset tile decoding hook
   for (n = 0; n < num_workers; ++n) {
@@ -2355,6 +2612,7 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
     }
 
     thread_data->pbi = pbi;
+    vp9_zero(thread_data->stage_counts);
 
     worker->hook = row_decode_worker_hook;
     worker->data1 = thread_data;
@@ -2369,7 +2627,15 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
   }
 
   /* Reset the jobq to start of the jobq buffer */
+#if CONFIG_MULTITHREAD
+  if (!row_mt_worker_data->use_jobq) {
+    vp9_jobsched_reset(&row_mt_worker_data->jobsched);
+  } else {
+    vp9_jobq_reset(&row_mt_worker_data->jobq);
+  }
+#else
   vp9_jobq_reset(&row_mt_worker_data->jobq);
+#endif
   row_mt_worker_data->num_tiles_done = 0;
   row_mt_worker_data->data_end = NULL;
 
@@ -2385,13 +2651,13 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
     }
   }
 
-  // queue parse jobs for 0th row of every tile
+  // queue parse jobs for 0th row of every tile, spread over the workers
   for (col = 0; col < tile_cols; ++col) {
     Job parse_job;
     parse_job.row_num = 0;
     parse_job.tile_col = col;
     parse_job.job_type = PARSE_JOB;
-    vp9_jobq_queue(&row_mt_worker_data->jobq, &parse_job, sizeof(parse_job));
+    queue_job(row_mt_worker_data, col % num_workers, &parse_job);
   }
 
   for (i = 0; i < num_workers; ++i) {
@@ -2404,6 +2670,7 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
     }
   }
 
+  t = stage_start(stage);
   for (; n > 0; --n) {
     VPxWorker *const worker = &pbi->tile_workers[n - 1];
     // TODO(jzern): The tile may have specific error data associated with
@@ -2412,6 +2679,8 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
     // detected, there's no point in continuing to decode tiles.
     corrupted |= !winterface->sync(worker);
   }
+  idle_mark(stage, t);
+  release_pool_workers(pbi);
 
   pbi->mb.corrupted = corrupted;
 
@@ -2429,6 +2698,13 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
     }
   }
 
+  if (stage != NULL) {
+    for (i = 0; i < num_workers; ++i) {
+      const ThreadData *const thread_data = &row_mt_worker_data->thread_data[i];
+      vp9_accumulate_stage_counts(stage, &thread_data->stage_counts);
+    }
+  }
+
   return row_mt_worker_data->data_end;
 }
 
@@ -2441,7 +2717,8 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
   YV12_BUFFER_CONFIG *const new_fb = get_frame_new_buffer(cm);
   const int tile_cols = 1 << cm->log2_tile_cols;
   const int tile_rows = 1 << cm->log2_tile_rows;
-  const int num_workers = VPXMIN(pbi->max_threads, tile_cols);
+  StageCounts *const stage = pbi->stage_stats ? &pbi->stage_counts : NULL;
+  int num_workers;
   int n;
 
   assert(tile_cols <= (1 << 6));
@@ -2449,6 +2726,7 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
   (void)tile_rows;
 
   init_mt(pbi);
+  num_workers = reserve_pool_workers(pbi, VPXMIN(pbi->max_threads, tile_cols));
 
   // Reset tile decoding hook
   for (n = 0; n < num_workers; ++n) {
@@ -2467,6 +2745,8 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
     tile_data->xd = pbi->mb;
     tile_data->xd.counts =
         cm->frame_parallel_decoding_mode ? NULL : &tile_data->counts;
+    tile_data->stage = stage != NULL ? &tile_data->stage_counts : NULL;
+    vp9_zero(tile_data->stage_counts);
     worker->hook = tile_worker_hook;
     worker->data1 = tile_data;
     worker->data2 = pbi;
@@ -2517,6 +2797,7 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
     const int base = tile_cols / num_workers;
     const int remain = tile_cols % num_workers;
     int buf_start = 0;
+    uint64_t t;
 
     for (n = 0; n < num_workers; ++n) {
       const int count = base + (remain + n) / num_workers;
@@ -2537,6 +2818,7 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
       }
     }
 
+    t = stage_start(stage);
     for (; n > 0; --n) {
       VPxWorker *const worker = &pbi->tile_workers[n - 1];
       TileWorkerData *const tile_data = (TileWorkerData *)worker->data1;
@@ -2547,6 +2829,8 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
       pbi->mb.corrupted |= !winterface->sync(worker);
       if (!bit_reader_end) bit_reader_end = tile_data->data_end;
     }
+    idle_mark(stage, t);
+    release_pool_workers(pbi);
   }
 
   // Accumulate thread frame counts.
@@ -2558,6 +2842,14 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
     }
   }
 
+  if (stage != NULL) {
+    for (n = 0; n < num_workers; ++n) {
+      TileWorkerData *const tile_data =
+          (TileWorkerData *)pbi->tile_workers[n].data1;
+      vp9_accumulate_stage_counts(stage, &tile_data->stage_counts);
+    }
+  }
+
   assert(bit_reader_end || pbi->mb.corrupted);
   return bit_reader_end;
 }
@@ -2611,22 +2903,48 @@ static void read_bitdepth_colorspace_sampling(VP9_COMMON *cm,
   }
 }
 
-static INLINE void flush_all_fb_on_key(VP9_COMMON *cm) {
+static INLINE void flush_all_fb_on_key(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
   if (cm->frame_type == KEY_FRAME && cm->current_video_frame > 0) {
     RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
     BufferPool *const pool = cm->buffer_pool;
     int i;
+    lock_buffer_pool(pool);
     for (i = 0; i < FRAME_BUFFERS; ++i) {
       if (i == cm->new_fb_idx) continue;
-      frame_bufs[i].ref_count = 0;
-      if (!frame_bufs[i].released) {
+      // Borrowed frames stay valid until the application returns them.
+      frame_bufs[i].ref_count =
+          pbi->borrowed_frames != NULL ? pbi->borrowed_frames[i] : 0;
+      if (frame_bufs[i].ref_count == 0 && !frame_bufs[i].released) {
         pool->release_fb_cb(pool->cb_priv, &frame_bufs[i].raw_frame_buffer);
         frame_bufs[i].released = 1;
       }
     }
+    unlock_buffer_pool(pool);
   }
 }
 
+// In frame parallel decode every frame writes its segmentation map to its own
+// frame buffer and predicts from the map of the last frame that had
+// segmentation enabled, unless this frame resets the map.
+static void setup_frame_parallel_seg_map(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  RefCntBuffer *seg_map_buf = pbi->prev_seg_map_buf;
+
+  if (cm->show_existing_frame) {
+    pbi->next_seg_map_buf = seg_map_buf;
+    return;
+  }
+
+  if (frame_is_intra_only(cm) || cm->error_resilient_mode ||
+      cm->width != cm->last_width || cm->height != cm->last_height)
+    seg_map_buf = NULL;
+
+  cm->last_frame_seg_map = seg_map_buf != NULL ? seg_map_buf->seg_map : NULL;
+  cm->current_frame_seg_map = cm->cur_frame->seg_map;
+  pbi->next_seg_map_buf = cm->seg.enabled ? cm->cur_frame : seg_map_buf;
+}
+
 static size_t read_uncompressed_header(VP9Decoder *pbi,
                                        struct vpx_read_bit_buffer *rb) {
   VP9_COMMON *const cm = &pbi->common;
@@ -2657,13 +2975,16 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
   if (cm->show_existing_frame) {
     // Show an existing frame directly.
     const int frame_to_show = cm->ref_frame_map[vpx_rb_read_literal(rb, 3)];
+    lock_buffer_pool(pool);
     if (frame_to_show < 0 || frame_bufs[frame_to_show].ref_count < 1) {
+      unlock_buffer_pool(pool);
       vpx_internal_error(&cm->error, VPX_CODEC_UNSUP_BITSTREAM,
                          "Buffer %d does not contain a decoded frame",
                          frame_to_show);
     }
 
     ref_cnt_fb(frame_bufs, &cm->new_fb_idx, frame_to_show);
+    unlock_buffer_pool(pool);
     pbi->refresh_frame_flags = 0;
     cm->lf.filter_level = 0;
     cm->show_frame = 1;
@@ -2691,7 +3012,9 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
     setup_frame_size(cm, rb);
     if (pbi->need_resync) {
       memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
-      flush_all_fb_on_key(cm);
+      // Frames in flight or waiting for output still hold buffers in frame
+      // parallel decode, which flushes the pool itself after an error.
+      if (!cm->frame_parallel_decode) flush_all_fb_on_key(pbi);
       pbi->need_resync = 0;
     }
   } else {
@@ -2785,6 +3108,7 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
   cm->frame_context_idx = vpx_rb_read_literal(rb, FRAME_CONTEXTS_LOG2);
 
   // Generate next_ref_frame_map.
+  lock_buffer_pool(pool);
   for (mask = pbi->refresh_frame_flags; mask; mask >>= 1) {
     if (mask & 1) {
       cm->next_ref_frame_map[ref_index] = cm->new_fb_idx;
@@ -2804,6 +3128,7 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
     if (cm->ref_frame_map[ref_index] >= 0)
       ++frame_bufs[cm->ref_frame_map[ref_index]].ref_count;
   }
+  unlock_buffer_pool(pool);
   pbi->hold_ref_buf = 1;
 
   if (frame_is_intra_only(cm) || cm->error_resilient_mode)
@@ -2826,6 +3151,7 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
                       vpx_calloc(1, sizeof(*pbi->row_mt_worker_data)));
 #if CONFIG_MULTITHREAD
       pthread_mutex_init(&pbi->row_mt_worker_data->recon_done_mutex, NULL);
+      vp9_jobsched_init(&pbi->row_mt_worker_data->jobsched);
 #endif
     }
 
@@ -2962,9 +3288,12 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
 #endif
   xd->cur_buf = new_fb;
 
+  if (cm->frame_parallel_decode) setup_frame_parallel_seg_map(pbi);
+
   if (!first_partition_size) {
     // showing a frame directly
     *p_data_end = data + (cm->profile <= PROFILE_2 ? 1 : 2);
+    if (cm->frame_parallel_decode) vp9_frameworker_signal_context_ready(pbi);
     return;
   }
 
@@ -2991,6 +3320,17 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
     vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
                        "Decode failed. Frame data header is corrupted.");
 
+  // In frame parallel decode the next frame can start as soon as its entropy
+  // context is known, unless it depends on this frame's adapted probabilities.
+  if (cm->frame_parallel_decode &&
+      (cm->frame_parallel_decoding_mode || !cm->refresh_frame_context)) {
+    if (cm->refresh_frame_context) {
+      context_updated = 1;
+      cm->frame_contexts[cm->frame_context_idx] = *cm->fc;
+    }
+    vp9_frameworker_signal_context_ready(pbi);
+  }
+
   if (cm->lf.filter_level && !cm->skip_loop_filter) {
     vp9_loop_filter_frame_init(cm, cm->lf.filter_level);
   }
@@ -3021,9 +3361,17 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
           if (!cm->skip_loop_filter) {
             // If multiple threads are used to decode tiles, then we use those
             // threads to do parallel loopfiltering.
-            vp9_loop_filter_frame_mt(
-                new_fb, cm, pbi->mb.plane, cm->lf.filter_level, 0, 0,
-                pbi->tile_workers, pbi->num_tile_workers, &pbi->lf_row_sync);
+            const int num_workers =
+                reserve_pool_workers(pbi, pbi->num_tile_workers);
+            StageCounts *const stage =
+                pbi->stage_stats ? &pbi->stage_counts : NULL;
+            const uint64_t t = stage_start(stage);
+            vp9_loop_filter_frame_mt(new_fb, cm, pbi->mb.plane,
+                                     cm->lf.filter_level, 0, 0,
+                                     pbi->tile_workers, num_workers,
+                                     &pbi->lf_row_sync);
+            stage_mark(stage, VP9_STAGE_LOOP_FILTER, t);
+            release_pool_workers(pbi);
           }
         } else {
           vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
@@ -3052,4 +3400,6 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
   // Non frame parallel update frame context here.
   if (cm->refresh_frame_context && !context_updated)
     cm->frame_contexts[cm->frame_context_idx] = *cm->fc;
+
+  if (cm->frame_parallel_decode) vp9_frameworker_signal_context_ready(pbi);
 }
@@ -35,6 +35,7 @@
 #include "vp9/decoder/vp9_decodeframe.h"
 #include "vp9/decoder/vp9_decoder.h"
 #include "vp9/decoder/vp9_detokenize.h"
+#include "vp9/decoder/vp9_dthread.h"
 
 static void initialize_dec(void) {
   static volatile int init_done = 0;
@@ -208,6 +209,31 @@ VP9Decoder *vp9_decoder_create(BufferPool *const pool) {
   return pbi;
 }
 
+int vp9_create_tile_workers(VP9Decoder *pbi) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  const int num_threads = pbi->max_threads;
+  int n;
+
+  assert(pbi->num_tile_workers == 0);
+  pbi->tile_workers = vpx_malloc(num_threads * sizeof(*pbi->tile_workers));
+  if (pbi->tile_workers == NULL) return 0;
+  for (n = 0; n < num_threads; ++n) {
+    VPxWorker *const worker = &pbi->tile_workers[n];
+    winterface->init(worker);
+    worker->pool = pbi->worker_pool;
+    if (n < num_threads - 1 && !winterface->reset(worker)) break;
+  }
+
+  if (n < num_threads) {
+    while (n-- > 0) winterface->end(&pbi->tile_workers[n]);
+    vpx_free(pbi->tile_workers);
+    pbi->tile_workers = NULL;
+    return 0;
+  }
+  pbi->num_tile_workers = num_threads;
+  return 1;
+}
+
 void vp9_decoder_remove(VP9Decoder *pbi) {
   int i;
 
@@ -231,11 +257,16 @@ void vp9_decoder_remove(VP9Decoder *pbi) {
   if (pbi->row_mt == 1) {
     vp9_dec_free_row_mt_mem(pbi->row_mt_worker_data);
     if (pbi->row_mt_worker_data != NULL) {
-      vp9_jobq_deinit(&pbi->row_mt_worker_data->jobq);
-      vpx_free(pbi->row_mt_worker_data->jobq_buf);
 #if CONFIG_MULTITHREAD
+      vp9_jobsched_deinit(&pbi->row_mt_worker_data->jobsched);
+      vpx_free(pbi->row_mt_worker_data->job_lists);
+      vpx_free(pbi->row_mt_worker_data->job_list_buf);
       pthread_mutex_destroy(&pbi->row_mt_worker_data->recon_done_mutex);
 #endif
+      if (pbi->row_mt_worker_data->jobq_buf != NULL) {
+        vp9_jobq_deinit(&pbi->row_mt_worker_data->jobq);
+        vpx_free(pbi->row_mt_worker_data->jobq_buf);
+      }
     }
     vpx_free(pbi->row_mt_worker_data);
   }
@@ -332,6 +363,7 @@ static void swap_frame_buffers(VP9Decoder *pbi) {
   BufferPool *const pool = cm->buffer_pool;
   RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
 
+  lock_buffer_pool(pool);
   for (mask = pbi->refresh_frame_flags; mask; mask >>= 1) {
     const int old_idx = cm->ref_frame_map[ref_index];
     // Current thread releases the holding of reference frame.
@@ -354,7 +386,9 @@ static void swap_frame_buffers(VP9Decoder *pbi) {
   pbi->hold_ref_buf = 0;
   cm->frame_to_show = get_frame_new_buffer(cm);
 
-  --frame_bufs[cm->new_fb_idx].ref_count;
+  // In frame parallel decode the frame is held until it has been output.
+  if (!cm->frame_parallel_decode) --frame_bufs[cm->new_fb_idx].ref_count;
+  unlock_buffer_pool(pool);
 
   // Invalidate these references until the next frame starts.
   for (ref_index = 0; ref_index < 3; ref_index++)
@@ -374,10 +408,12 @@ static void release_fb_on_decoder_exit(VP9Decoder *pbi) {
   for (i = 0; i < pbi->num_tile_workers; ++i) {
     winterface->sync(&pbi->tile_workers[i]);
   }
+  release_pool_workers(pbi);
 
   // Release all the reference buffers if worker thread is holding them.
   if (pbi->hold_ref_buf == 1) {
     int ref_index = 0, mask;
+    lock_buffer_pool(pool);
     for (mask = pbi->refresh_frame_flags; mask; mask >>= 1) {
       const int old_idx = cm->ref_frame_map[ref_index];
       // Current thread releases the holding of reference frame.
@@ -395,10 +431,28 @@ static void release_fb_on_decoder_exit(VP9Decoder *pbi) {
       const int old_idx = cm->ref_frame_map[ref_index];
       decrease_ref_count(old_idx, frame_bufs, pool);
     }
+    unlock_buffer_pool(pool);
     pbi->hold_ref_buf = 0;
   }
 }
 
+static void update_stage_stats(VP9Decoder *pbi, uint64_t frame_ticks,
+                               int64_t frame_usec, size_t bytes_read) {
+  vp9_stage_stats_t *const stats = &pbi->last_stage_stats;
+  StageCounts counts = pbi->stage_counts;
+  int i;
+
+  // lf_worker has been synced by the end of the frame.
+  vp9_accumulate_stage_counts(&counts, &pbi->lf_stage_counts);
+  for (i = 0; i < VP9_DECODER_STAGES; ++i)
+    stats->stage_ticks[i] = counts.ticks[i];
+  stats->idle_ticks = counts.idle_ticks;
+  stats->frame_ticks = frame_ticks;
+  stats->frame_usec = frame_usec;
+  stats->bytes_read = bytes_read;
+  stats->superblocks = counts.superblocks;
+}
+
 int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
                                 const uint8_t **psource) {
   VP9_COMMON *volatile const cm = &pbi->common;
@@ -425,19 +479,37 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
 
   pbi->ready_for_new_data = 0;
 
-  // Check if the previous frame was a frame without any references to it.
-  if (cm->new_fb_idx >= 0 && frame_bufs[cm->new_fb_idx].ref_count == 0 &&
-      !frame_bufs[cm->new_fb_idx].released) {
+  if (cm->frame_parallel_decode) {
+    // frame_context_ready is cleared when the frame is submitted.
+    // Set up from the frame buffers in vp9_decode_frame().
+    cm->last_frame_seg_map = NULL;
+    cm->current_frame_seg_map = NULL;
+    memset(pbi->ref_frame_progress, -1, sizeof(pbi->ref_frame_progress));
+  } else if (cm->new_fb_idx >= 0 &&
+             frame_bufs[cm->new_fb_idx].ref_count == 0 &&
+             !frame_bufs[cm->new_fb_idx].released) {
+    // Check if the previous frame was a frame without any references to it.
     pool->release_fb_cb(pool->cb_priv,
                         &frame_bufs[cm->new_fb_idx].raw_frame_buffer);
     frame_bufs[cm->new_fb_idx].released = 1;
   }
 
   // Find a free frame buffer. Return error if can not find any.
+  lock_buffer_pool(pool);
   cm->new_fb_idx = get_free_fb(cm);
+  if (cm->new_fb_idx != INVALID_IDX) {
+    frame_bufs[cm->new_fb_idx].row = -1;
+    frame_bufs[cm->new_fb_idx].buf.corrupted = 0;
+  }
+  unlock_buffer_pool(pool);
   if (cm->new_fb_idx == INVALID_IDX) {
     pbi->ready_for_new_data = 1;
     release_fb_on_decoder_exit(pbi);
+    if (cm->frame_parallel_decode) {
+      pbi->need_resync = 1;
+      vp9_frameworker_signal_context_ready(pbi);
+      vp9_frameworker_release_context(pbi);
+    }
     vpx_clear_system_state();
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Unable to find free frame buffer");
@@ -453,20 +525,59 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
   if (setjmp(cm->error.jmp)) {
     cm->error.setjmp = 0;
     pbi->ready_for_new_data = 1;
+    if (cm->frame_parallel_decode) {
+      // Unblock the frames waiting on this one. They may still read the
+      // buffers held here, so the references are dropped by the flush of the
+      // buffer pool once no frame is in flight.
+      pbi->need_resync = 1;
+      pbi->hold_ref_buf = 0;
+      vp9_frameworker_signal_context_ready(pbi);
+      if (pbi->cur_buf == &frame_bufs[cm->new_fb_idx]) {
+        pbi->cur_buf->buf.corrupted = 1;
+        vp9_frameworker_broadcast(pool, pbi->cur_buf, INT_MAX);
+      }
+      release_fb_on_decoder_exit(pbi);
+      vpx_clear_system_state();
+      return -1;
+    }
     release_fb_on_decoder_exit(pbi);
     // Release current frame.
+    lock_buffer_pool(pool);
     decrease_ref_count(cm->new_fb_idx, frame_bufs, pool);
+    unlock_buffer_pool(pool);
     vpx_clear_system_state();
     return -1;
   }
 
   cm->error.setjmp = 1;
-  vp9_decode_frame(pbi, source, source + size, psource);
+  if (pbi->stage_stats) {
+    struct vpx_usec_timer timer;
+    const uint64_t start = vpx_timer_ticks();
+    vpx_usec_timer_start(&timer);
+    vp9_zero(pbi->stage_counts);
+    vp9_zero(pbi->lf_stage_counts);
+    vp9_decode_frame(pbi, source, source + size, psource);
+    vpx_usec_timer_mark(&timer);
+    update_stage_stats(pbi, vpx_timer_ticks() - start,
+                       vpx_usec_timer_elapsed(&timer),
+                       (size_t)(*psource - source));
+  } else {
+    vp9_decode_frame(pbi, source, source + size, psource);
+  }
 
   swap_frame_buffers(pbi);
 
   vpx_clear_system_state();
 
+  if (cm->frame_parallel_decode) {
+    // The state below is handed to the next frame by
+    // vp9_frameworker_copy_context() instead.
+    vp9_frameworker_release_context(pbi);
+    if (cm->show_frame) cm->cur_show_frame_fb_idx = cm->new_fb_idx;
+    cm->error.setjmp = 0;
+    return retcode;
+  }
+
   if (!cm->show_existing_frame) {
     cm->last_show_frame = cm->show_frame;
     cm->prev_frame = cm->cur_frame;
@@ -505,7 +616,19 @@ int vp9_get_raw_frame(VP9Decoder *pbi, YV12_BUFFER_CONFIG *sd,
 
 #if CONFIG_VP9_POSTPROC
   if (!cm->show_existing_frame) {
-    ret = vp9_post_proc_frame(cm, sd, flags, cm->width);
+    // Post-processing is split between the tile workers, which are otherwise
+    // only created for multi-tile or row-mt decoding. It runs single threaded
+    // if they cannot be created. It only starts once the whole frame is loop
+    // filtered, even when the flags were set with VP8_SET_POSTPROC before
+    // decoding: they may still change until the frame is fetched, and MFQE
+    // and the post-processing state advance with each fetched frame, not
+    // with each decoded one.
+    if (flags->post_proc_flag && pbi->max_threads > 1 &&
+        pbi->num_tile_workers == 0) {
+      vp9_create_tile_workers(pbi);
+    }
+    ret = vp9_post_proc_frame(cm, sd, flags, cm->width, pbi->tile_workers,
+                              pbi->num_tile_workers);
   } else {
     *sd = *cm->frame_to_show;
     ret = 0;
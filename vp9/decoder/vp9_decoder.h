@@ -13,6 +13,7 @@
 
 #include "./vpx_config.h"
 
+#include "vpx/vp8dx.h"
 #include "vpx/vpx_codec.h"
 #include "vpx_dsp/bitreader.h"
 #include "vpx_scale/yv12config.h"
@@ -33,10 +34,18 @@ extern "C" {
 
 typedef enum JobType { PARSE_JOB, RECON_JOB, LPF_JOB } JobType;
 
+// Time spent by one thread in each decoding stage, see VP9D_SET_STAGE_STATS.
+typedef struct StageCounts {
+  uint64_t ticks[VP9_DECODER_STAGES];
+  uint64_t idle_ticks;
+  unsigned int superblocks;
+} StageCounts;
+
 typedef struct ThreadData {
   struct VP9Decoder *pbi;
   LFWorkerData *lf_data;
   VP9LfSync *lf_sync;
+  StageCounts stage_counts;
 } ThreadData;
 
 typedef struct TileBuffer {
@@ -50,6 +59,8 @@ typedef struct TileWorkerData {
   int buf_start, buf_end;  // pbi->tile_buffers to decode, inclusive
   vpx_reader bit_reader;
   FRAME_COUNTS counts;
+  StageCounts stage_counts;
+  StageCounts *stage;  // Stage timing destination, NULL when disabled.
   LFWorkerData *lf_data;
   VP9LfSync *lf_sync;
   DECLARE_ALIGNED(16, MACROBLOCKD, xd);
@@ -73,6 +84,16 @@ typedef struct RowMTWorkerData {
   uint8_t *jobq_buf;
   JobQueueRowMt jobq;
   size_t jobq_size;
+#if CONFIG_MULTITHREAD
+  // Replaces jobq when threads are available.
+  JobSchedRowMt jobsched;
+  JobListRowMt *job_lists;
+  vpx_atomic_int *job_list_buf;
+  int num_job_lists;
+  int job_list_size;
+  // Set when the job lists could not be allocated, jobq is used instead.
+  int use_jobq;
+#endif
   int num_tiles_done;
   int num_jobs;
 #if CONFIG_MULTITHREAD
@@ -119,10 +140,37 @@ typedef struct VP9Decoder {
   int inv_tile_order;
   int need_resync;   // wait for key/intra-only frame.
   int hold_ref_buf;  // hold the reference buffer.
+  // References held by the application on each frame buffer through
+  // VP9D_BORROW_FRAME, NULL if frames cannot be borrowed.
+  const int *borrowed_frames;
 
   int row_mt;
   int lpf_mt_opt;
+  int fused_lf;     // Filter each superblock during single threaded decode.
+  int stage_stats;  // Time the decoding stages of each frame.
   RowMTWorkerData *row_mt_worker_data;
+
+  // Threads shared with other decoders, NULL if the workers own their threads.
+  VPxWorkerPool *worker_pool;
+  int num_pool_workers;  // Pool threads reserved for the running tile workers.
+
+  // Frame parallel decode only. frame_context_ready and the next_* buffers
+  // are protected by BufferPool::pool_mutex.
+  int frame_context_ready;  // Context for the next frame can be copied.
+  // Frame whose seg_map is used as last_frame_seg_map. Holds a reference.
+  RefCntBuffer *prev_seg_map_buf;
+  // prev_frame and prev_seg_map_buf for the next frame. Each holds a
+  // reference that is handed over by vp9_frameworker_copy_context().
+  RefCntBuffer *next_prev_frame;
+  RefCntBuffer *next_seg_map_buf;
+  // Last decoding progress observed for each frame buffer in this frame.
+  int ref_frame_progress[FRAME_BUFFERS];
+
+  // Stage timing of the calling thread and of lf_worker, merged into
+  // last_stage_stats once the frame is decoded.
+  StageCounts stage_counts;
+  StageCounts lf_stage_counts;
+  vp9_stage_stats_t last_stage_stats;
 } VP9Decoder;
 
 int vp9_receive_compressed_data(struct VP9Decoder *pbi, size_t size,
@@ -160,11 +208,30 @@ struct VP9Decoder *vp9_decoder_create(BufferPool *const pool);
 
 void vp9_decoder_remove(struct VP9Decoder *pbi);
 
+// Creates the max_threads tile workers, the last of which runs on the calling
+// thread. Returns 0 with no workers created on failure.
+int vp9_create_tile_workers(struct VP9Decoder *pbi);
+
 void vp9_dec_alloc_row_mt_mem(RowMTWorkerData *row_mt_worker_data,
                               VP9_COMMON *cm, int num_sbs, int max_threads,
                               int num_jobs);
 void vp9_dec_free_row_mt_mem(RowMTWorkerData *row_mt_worker_data);
 
+static INLINE void vp9_accumulate_stage_counts(StageCounts *acc,
+                                               const StageCounts *counts) {
+  int i;
+  for (i = 0; i < VP9_DECODER_STAGES; ++i) acc->ticks[i] += counts->ticks[i];
+  acc->idle_ticks += counts->idle_ticks;
+  acc->superblocks += counts->superblocks;
+}
+
+static INLINE void release_pool_workers(VP9Decoder *pbi) {
+  if (pbi->num_pool_workers > 0) {
+    vpx_worker_pool_release(pbi->worker_pool, pbi->num_pool_workers);
+    pbi->num_pool_workers = 0;
+  }
+}
+
 static INLINE void decrease_ref_count(int idx, RefCntBuffer *const frame_bufs,
                                       BufferPool *const pool) {
   if (idx >= 0 && frame_bufs[idx].ref_count > 0) {
@@ -29,11 +29,24 @@
     if (counts) ++coef_counts[band][ctx][token]; \
   } while (0)
 
-static INLINE int read_bool(vpx_reader *r, int prob, BD_VALUE *value,
-                            int *count, unsigned int *range) {
-  const unsigned int split = (*range * prob + (256 - prob)) >> CHAR_BIT;
-  const BD_VALUE bigsplit = (BD_VALUE)split << (BD_VALUE_SIZE - CHAR_BIT);
+static INLINE void refill(vpx_reader *r, BD_VALUE *value, int *count) {
+  r->value = *value;
+  r->count = *count;
+  vpx_reader_fill(r);
+  *value = r->value;
+  *count = r->count;
+}
+
+// Makes sure the next n bools (at most VPX_READER_BOOLS_PER_FILL) can be read
+// with read_bool_nofill().
+static INLINE void reserve_bools(vpx_reader *r, int n, BD_VALUE *value,
+                                 int *count) {
+  assert(n <= VPX_READER_BOOLS_PER_FILL);
+  if (*count < VPX_READER_MAX_BOOL_BITS * (n - 1)) refill(r, value, count);
+}
+
 #if CONFIG_BITSTREAM_DEBUG
+static void check_bool(int prob, int bit) {
   const int queue_r = bitstream_queue_get_read();
   const int frame_idx = bitstream_queue_get_frame_read();
   int ref_result, ref_prob;
@@ -46,72 +59,124 @@ static INLINE int read_bool(vpx_reader *r, int prob, BD_VALUE *value,
 
     assert(0);
   }
-#endif
+  if (bit != ref_result) {
+    fprintf(stderr,
+            "\n *** [bit] result error, frame_idx_r %d bit %d ref_result %d "
+            "queue_r %d\n",
+            frame_idx, bit, ref_result, queue_r);
 
-  if (*count < 0) {
-    r->value = *value;
-    r->count = *count;
-    vpx_reader_fill(r);
-    *value = r->value;
-    *count = r->count;
+    assert(0);
   }
+}
+#endif  // CONFIG_BITSTREAM_DEBUG
 
+// Tree nodes: the caller branches on the result right away, so branching here
+// as well costs nothing extra.
+static INLINE int read_bool_nofill(int prob, BD_VALUE *value, int *count,
+                                   unsigned int *range) {
+  const unsigned int split = (*range * prob + (256 - prob)) >> CHAR_BIT;
+  const BD_VALUE bigsplit = (BD_VALUE)split << (BD_VALUE_SIZE - CHAR_BIT);
+  int bit = 0;
+  int shift;
+  assert(*count >= 0);
   if (*value >= bigsplit) {
     *range = *range - split;
     *value = *value - bigsplit;
-    {
-      const int shift = vpx_norm[*range];
-      *range <<= shift;
-      *value <<= shift;
-      *count -= shift;
-    }
-#if CONFIG_BITSTREAM_DEBUG
-    {
-      const int bit = 1;
-      if (bit != ref_result) {
-        fprintf(
-            stderr,
-            "\n *** [bit] result error, frame_idx_r %d bit %d ref_result %d "
-            "queue_r %d\n",
-            frame_idx, bit, ref_result, queue_r);
-
-        assert(0);
-      }
-    }
-#endif
-    return 1;
-  }
-  *range = split;
-  {
-    const int shift = vpx_norm[*range];
-    *range <<= shift;
-    *value <<= shift;
-    *count -= shift;
+    bit = 1;
+  } else {
+    *range = split;
   }
+  shift = vpx_norm[*range];
+  *range <<= shift;
+  *value <<= shift;
+  *count -= shift;
 #if CONFIG_BITSTREAM_DEBUG
-  {
-    const int bit = 0;
-    if (bit != ref_result) {
-      fprintf(stderr,
-              "\n *** [bit] result error, frame_idx_r %d bit %d ref_result %d "
-              "queue_r %d\n",
-              frame_idx, bit, ref_result, queue_r);
+  check_bool(prob, bit);
+#endif
+  return bit;
+}
 
-      assert(0);
-    }
-  }
+// Extra bits and signs are close to equiprobable and only accumulated, so
+// the interval is selected with masks to avoid the mispredicted branches.
+static INLINE int read_literal_nofill(int prob, BD_VALUE *value, int *count,
+                                      unsigned int *range) {
+  const unsigned int split = (*range * prob + (256 - prob)) >> CHAR_BIT;
+  const BD_VALUE bigsplit = (BD_VALUE)split << (BD_VALUE_SIZE - CHAR_BIT);
+  const int bit = *value >= bigsplit;
+  const unsigned int new_range = split + ((*range - 2 * split) & (0u - bit));
+  const int shift = vpx_norm[new_range];
+  assert(*count >= 0);
+  *range = new_range << shift;
+  *value = (*value - (bigsplit & (0 - (BD_VALUE)bit))) << shift;
+  *count -= shift;
+#if CONFIG_BITSTREAM_DEBUG
+  check_bool(prob, bit);
 #endif
-  return 0;
+  return bit;
+}
+
+static INLINE int read_bool(vpx_reader *r, int prob, BD_VALUE *value,
+                            int *count, unsigned int *range) {
+  if (*count < 0) refill(r, value, count);
+  return read_bool_nofill(prob, value, count, range);
+}
+
+static INLINE int read_sign(vpx_reader *r, BD_VALUE *value, int *count,
+                            unsigned int *range) {
+  if (*count < 0) refill(r, value, count);
+  return read_literal_nofill(128, value, count, range);
 }
 
 static INLINE int read_coeff(vpx_reader *r, const vpx_prob *probs, int n,
                              BD_VALUE *value, int *count, unsigned int *range) {
-  int i, val = 0;
-  for (i = 0; i < n; ++i)
-    val = (val << 1) | read_bool(r, probs[i], value, count, range);
+  int val = 0;
+  while (n > 0) {
+    const int batch = VPXMIN(n, VPX_READER_BOOLS_PER_FILL);
+    int i;
+    reserve_bools(r, batch, value, count);
+    for (i = 0; i < batch; ++i)
+      val = (val << 1) | read_literal_nofill(*probs++, value, count, range);
+    n -= batch;
+  }
   return val;
 }
 
+// Reads the rest of a token whose ONE_CONTEXT_NODE bool was 1, i.e. one of
+// TWO_TOKEN to CATEGORY6_TOKEN, and returns its magnitude. The Pareto tail of
+// the tree is at most four bools deep, so they all follow one refill check.
+static INLINE int read_big_token(vpx_reader *r, const vpx_prob *p,
+                                 const uint8_t *cat6_prob, int cat6_bits,
+                                 uint8_t *token_cache, BD_VALUE *value,
+                                 int *count, unsigned int *range) {
+  reserve_bools(r, 4, value, count);
+  if (!read_bool_nofill(p[0], value, count, range)) {
+    if (!read_bool_nofill(p[1], value, count, range)) {
+      *token_cache = 2;
+      return 2;
+    }
+    *token_cache = 3;
+    return 3 + read_bool_nofill(p[2], value, count, range);
+  }
+  if (!read_bool_nofill(p[3], value, count, range)) {
+    *token_cache = 4;
+    if (read_bool_nofill(p[4], value, count, range))
+      return CAT2_MIN_VAL +
+             read_coeff(r, vp9_cat2_prob, 2, value, count, range);
+    return CAT1_MIN_VAL + read_coeff(r, vp9_cat1_prob, 1, value, count, range);
+  }
+  *token_cache = 5;
+  if (!read_bool_nofill(p[5], value, count, range)) {
+    if (read_bool_nofill(p[6], value, count, range))
+      return CAT4_MIN_VAL +
+             read_coeff(r, vp9_cat4_prob, 4, value, count, range);
+    return CAT3_MIN_VAL + read_coeff(r, vp9_cat3_prob, 3, value, count, range);
+  }
+  if (read_bool_nofill(p[7], value, count, range))
+    return CAT6_MIN_VAL +
+           read_coeff(r, cat6_prob, cat6_bits, value, count, range);
+  return CAT5_MIN_VAL + read_coeff(r, vp9_cat5_prob, 5, value, count, range);
+}
+
 static int decode_coefs(const MACROBLOCKD *xd, PLANE_TYPE type,
                         tran_low_t *dqcoeff, TX_SIZE tx_size, const int16_t *dq,
                         int ctx, const int16_t *scan, const int16_t *nb,
@@ -124,7 +189,7 @@ static int decode_coefs(const MACROBLOCKD *xd, PLANE_TYPE type,
   const vpx_prob(*coef_probs)[COEFF_CONTEXTS][UNCONSTRAINED_NODES] =
       fc->coef_probs[tx_size][type][ref];
   const vpx_prob *prob;
-  unsigned int(*coef_counts)[COEFF_CONTEXTS][UNCONSTRAINED_NODES + 1];
+  unsigned int(*coef_counts)[COEFF_CONTEXTS][UNCONSTRAINED_NODES + 1] = NULL;
   unsigned int(*eob_branch_count)[COEFF_CONTEXTS];
   uint8_t token_cache[32 * 32];
   const uint8_t *band_translate = get_band_translate(tx_size);
@@ -156,7 +221,6 @@ static int decode_coefs(const MACROBLOCKD *xd, PLANE_TYPE type,
   }
 
   while (c < max_eob) {
-    int val = -1;
     band = *band_translate++;
     prob = coef_probs[band][ctx];
     if (counts) ++eob_branch_count[band][ctx];
@@ -183,51 +247,16 @@ static int decode_coefs(const MACROBLOCKD *xd, PLANE_TYPE type,
 
     if (read_bool(r, prob[ONE_CONTEXT_NODE], &value, &count, &range)) {
       const vpx_prob *p = vp9_pareto8_full[prob[PIVOT_NODE] - 1];
+      const int val = read_big_token(r, p, cat6_prob, cat6_bits,
+                                     &token_cache[scan[c]], &value, &count,
+                                     &range);
       INCREMENT_COUNT(TWO_TOKEN);
-      if (read_bool(r, p[0], &value, &count, &range)) {
-        if (read_bool(r, p[3], &value, &count, &range)) {
-          token_cache[scan[c]] = 5;
-          if (read_bool(r, p[5], &value, &count, &range)) {
-            if (read_bool(r, p[7], &value, &count, &range)) {
-              val = CAT6_MIN_VAL +
-                    read_coeff(r, cat6_prob, cat6_bits, &value, &count, &range);
-            } else {
-              val = CAT5_MIN_VAL +
-                    read_coeff(r, vp9_cat5_prob, 5, &value, &count, &range);
-            }
-          } else if (read_bool(r, p[6], &value, &count, &range)) {
-            val = CAT4_MIN_VAL +
-                  read_coeff(r, vp9_cat4_prob, 4, &value, &count, &range);
-          } else {
-            val = CAT3_MIN_VAL +
-                  read_coeff(r, vp9_cat3_prob, 3, &value, &count, &range);
-          }
-        } else {
-          token_cache[scan[c]] = 4;
-          if (read_bool(r, p[4], &value, &count, &range)) {
-            val = CAT2_MIN_VAL +
-                  read_coeff(r, vp9_cat2_prob, 2, &value, &count, &range);
-          } else {
-            val = CAT1_MIN_VAL +
-                  read_coeff(r, vp9_cat1_prob, 1, &value, &count, &range);
-          }
-        }
 #if CONFIG_VP9_HIGHBITDEPTH
-        // val may use 18-bits
-        v = (int)(((int64_t)val * dqv) >> dq_shift);
+      // val may use 18-bits
+      v = (int)(((int64_t)val * dqv) >> dq_shift);
 #else
-        v = (val * dqv) >> dq_shift;
+      v = (val * dqv) >> dq_shift;
 #endif
-      } else {
-        if (read_bool(r, p[1], &value, &count, &range)) {
-          token_cache[scan[c]] = 3;
-          v = ((3 + read_bool(r, p[2], &value, &count, &range)) * dqv) >>
-              dq_shift;
-        } else {
-          token_cache[scan[c]] = 2;
-          v = (2 * dqv) >> dq_shift;
-        }
-      }
     } else {
       INCREMENT_COUNT(ONE_TOKEN);
       token_cache[scan[c]] = 1;
@@ -236,17 +265,13 @@ static int decode_coefs(const MACROBLOCKD *xd, PLANE_TYPE type,
 #if CONFIG_COEFFICIENT_RANGE_CHECKING
 #if CONFIG_VP9_HIGHBITDEPTH
     dqcoeff[scan[c]] = highbd_check_range(
-        read_bool(r, 128, &value, &count, &range) ? -v : v, xd->bd);
+        read_sign(r, &value, &count, &range) ? -v : v, xd->bd);
 #else
     dqcoeff[scan[c]] =
-        check_range(read_bool(r, 128, &value, &count, &range) ? -v : v);
+        check_range(read_sign(r, &value, &count, &range) ? -v : v);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 #else
-    if (read_bool(r, 128, &value, &count, &range)) {
-      dqcoeff[scan[c]] = -v;
-    } else {
-      dqcoeff[scan[c]] = v;
-    }
+    dqcoeff[scan[c]] = read_sign(r, &value, &count, &range) ? -v : v;
 #endif  // CONFIG_COEFFICIENT_RANGE_CHECKING
     ++c;
     ctx = get_coef_context(nb, token_cache, c);
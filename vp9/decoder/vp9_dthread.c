@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "./vpx_config.h"
+#include "vp9/decoder/vp9_dthread.h"
+#include "vp9/decoder/vp9_decoder.h"
+
+void vp9_frameworker_wait(VP9Decoder *pbi, RefCntBuffer *ref_buf, int row) {
+#if CONFIG_MULTITHREAD
+  BufferPool *const pool = pbi->common.buffer_pool;
+  int *const progress =
+      &pbi->ref_frame_progress[ref_buf - pool->frame_bufs];
+
+  // Rows already known to be ready do not need the lock.
+  if (*progress >= row) return;
+
+  pthread_mutex_lock(&pool->pool_mutex);
+  while (ref_buf->row < row)
+    pthread_cond_wait(&pool->progress_cond, &pool->pool_mutex);
+  *progress = ref_buf->row;
+  pthread_mutex_unlock(&pool->pool_mutex);
+#else
+  (void)pbi;
+  (void)ref_buf;
+  (void)row;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vp9_frameworker_broadcast(BufferPool *pool, RefCntBuffer *buf, int row) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&pool->pool_mutex);
+  buf->row = row;
+  pthread_cond_broadcast(&pool->progress_cond);
+  pthread_mutex_unlock(&pool->pool_mutex);
+#else
+  (void)pool;
+  buf->row = row;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vp9_frameworker_signal_context_ready(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  BufferPool *const pool = cm->buffer_pool;
+
+  lock_buffer_pool(pool);
+  if (!pbi->frame_context_ready) {
+    if (pbi->need_resync) {
+      // The frame failed, so the next one has nothing to predict from.
+      pbi->next_prev_frame = NULL;
+      pbi->next_seg_map_buf = NULL;
+    } else {
+      pbi->next_prev_frame =
+          cm->show_existing_frame ? cm->prev_frame : cm->cur_frame;
+      if (pbi->next_prev_frame != NULL) ++pbi->next_prev_frame->ref_count;
+      if (pbi->next_seg_map_buf != NULL) ++pbi->next_seg_map_buf->ref_count;
+    }
+    pbi->frame_context_ready = 1;
+#if CONFIG_MULTITHREAD
+    pthread_cond_broadcast(&pool->progress_cond);
+#endif
+  }
+  unlock_buffer_pool(pool);
+}
+
+void vp9_frameworker_copy_context(VP9Decoder *dst, VP9Decoder *src) {
+  VP9_COMMON *const dst_cm = &dst->common;
+  VP9_COMMON *const src_cm = &src->common;
+  BufferPool *const pool = src_cm->buffer_pool;
+  int show_existing;
+
+  lock_buffer_pool(pool);
+#if CONFIG_MULTITHREAD
+  while (!src->frame_context_ready)
+    pthread_cond_wait(&pool->progress_cond, &pool->pool_mutex);
+#endif
+  unlock_buffer_pool(pool);
+
+  show_existing = src_cm->show_existing_frame;
+
+  // The references taken by src for the next frame are handed over to dst.
+  dst_cm->prev_frame = src->next_prev_frame;
+  dst->prev_seg_map_buf = src->next_seg_map_buf;
+  if (dst != src) {
+    src->next_prev_frame = NULL;
+    src->next_seg_map_buf = NULL;
+  }
+
+  dst->need_resync = src->need_resync;
+  dst_cm->last_width = show_existing ? src_cm->last_width : src_cm->width;
+  dst_cm->last_height = show_existing ? src_cm->last_height : src_cm->height;
+  dst_cm->last_show_frame =
+      show_existing ? src_cm->last_show_frame : src_cm->show_frame;
+  dst_cm->current_video_frame =
+      src_cm->current_video_frame + src_cm->show_frame;
+  if (dst == src) return;
+
+  dst_cm->frame_type = src_cm->frame_type;
+  dst_cm->intra_only = src_cm->intra_only;
+  dst_cm->bit_depth = src_cm->bit_depth;
+#if CONFIG_VP9_HIGHBITDEPTH
+  dst_cm->use_highbitdepth = src_cm->use_highbitdepth;
+#endif
+  dst_cm->color_space = src_cm->color_space;
+  dst_cm->color_range = src_cm->color_range;
+  dst_cm->subsampling_x = src_cm->subsampling_x;
+  dst_cm->subsampling_y = src_cm->subsampling_y;
+  memcpy(dst_cm->ref_frame_map,
+         show_existing ? src_cm->ref_frame_map : src_cm->next_ref_frame_map,
+         sizeof(src_cm->ref_frame_map));
+  memcpy(dst_cm->lf.ref_deltas, src_cm->lf.ref_deltas,
+         sizeof(src_cm->lf.ref_deltas));
+  memcpy(dst_cm->lf.mode_deltas, src_cm->lf.mode_deltas,
+         sizeof(src_cm->lf.mode_deltas));
+  dst_cm->seg = src_cm->seg;
+  memcpy(dst_cm->frame_contexts, src_cm->frame_contexts,
+         FRAME_CONTEXTS * sizeof(dst_cm->frame_contexts[0]));
+}
+
+void vp9_frameworker_release_context(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  BufferPool *const pool = cm->buffer_pool;
+  RefCntBuffer *const frame_bufs = pool->frame_bufs;
+
+  lock_buffer_pool(pool);
+  if (cm->prev_frame != NULL)
+    decrease_ref_count((int)(cm->prev_frame - frame_bufs), frame_bufs, pool);
+  if (pbi->prev_seg_map_buf != NULL) {
+    decrease_ref_count((int)(pbi->prev_seg_map_buf - frame_bufs), frame_bufs,
+                       pool);
+  }
+  unlock_buffer_pool(pool);
+  cm->prev_frame = NULL;
+  pbi->prev_seg_map_buf = NULL;
+}
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VP9_DECODER_VP9_DTHREAD_H_
+#define VPX_VP9_DECODER_VP9_DTHREAD_H_
+
+#include "./vpx_config.h"
+#include "vpx/internal/vpx_codec_internal.h"
+#include "vpx_util/vpx_thread.h"
+
+#include "vp9/common/vp9_onyxc_int.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct VP9Decoder;
+
+// WorkerData for the FrameWorker thread.
+typedef struct FrameWorkerData {
+  struct VP9Decoder *pbi;
+  const uint8_t *data;
+  const uint8_t *data_end;
+  size_t data_size;
+  void *user_priv;
+  int result;
+  int worker_id;
+
+  // Output the decoded frame if it is shown. Only the last frame of each
+  // packet is output, the same as in serial decode.
+  int output_frame;
+
+  // scratch_buffer holds a copy of the compressed frame, as the application
+  // may reuse its buffer before the frame has been decoded.
+  uint8_t *scratch_buffer;
+  size_t scratch_buffer_size;
+} FrameWorkerData;
+
+// Wait until the given reference frame has decoded and loop filtered at
+// least |row| luma rows (and the matching rows of the chroma planes).
+void vp9_frameworker_wait(struct VP9Decoder *pbi, RefCntBuffer *ref_buf,
+                          int row);
+
+// Publish decoding progress of |buf|. INT_MAX marks the frame as done.
+void vp9_frameworker_broadcast(BufferPool *pool, RefCntBuffer *buf, int row);
+
+// Signal that the state the next frame's header depends on, i.e. the
+// reference map, entropy contexts, segmentation and loop filter deltas, is
+// final. Takes the references handed over to the next frame.
+void vp9_frameworker_signal_context_ready(struct VP9Decoder *pbi);
+
+// Copy the decoder state from |src| for |dst| to decode the next frame,
+// waiting until the context of |src| is ready. |dst| and |src| may be the
+// same decoder.
+void vp9_frameworker_copy_context(struct VP9Decoder *dst,
+                                  struct VP9Decoder *src);
+
+// Drop the references taken for the frame decoded by |pbi| once its decode
+// is over.
+void vp9_frameworker_release_context(struct VP9Decoder *pbi);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // VPX_VP9_DECODER_VP9_DTHREAD_H_
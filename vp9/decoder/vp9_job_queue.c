@@ -58,7 +58,7 @@ void vp9_jobq_terminate(JobQueueRowMt *jobq) {
 #endif
 }
 
-int vp9_jobq_queue(JobQueueRowMt *jobq, void *job, size_t job_size) {
+int vp9_jobq_queue(JobQueueRowMt *jobq, const void *job, size_t job_size) {
   int ret = 0;
 #if CONFIG_MULTITHREAD
   pthread_mutex_lock(&jobq->mutex);
@@ -122,3 +122,114 @@ int vp9_jobq_dequeue(JobQueueRowMt *jobq, void *job, size_t job_size,
 
   return ret;
 }
+
+#if CONFIG_MULTITHREAD
+void vp9_jobsched_init(JobSchedRowMt *sched) {
+  pthread_mutex_init(&sched->mutex, NULL);
+  pthread_cond_init(&sched->cond, NULL);
+  sched->lists = NULL;
+  sched->num_lists = 0;
+  vpx_atomic_init(&sched->num_jobs, 0);
+  vpx_atomic_init(&sched->num_idle, 0);
+  sched->terminate = 0;
+}
+
+void vp9_jobsched_set_lists(JobSchedRowMt *sched, JobListRowMt *lists,
+                            vpx_atomic_int *buf, int num_lists,
+                            int list_size) {
+  int i;
+  for (i = 0; i < num_lists; ++i) {
+    lists[i].jobs = buf + i * list_size;
+    lists[i].size = list_size;
+  }
+  sched->lists = lists;
+  sched->num_lists = num_lists;
+  vp9_jobsched_reset(sched);
+}
+
+void vp9_jobsched_reset(JobSchedRowMt *sched) {
+  int i;
+  for (i = 0; i < sched->num_lists; ++i) {
+    vpx_atomic_init(&sched->lists[i].head, 0);
+    vpx_atomic_init(&sched->lists[i].tail, 0);
+  }
+  vpx_atomic_init(&sched->num_jobs, 0);
+  vpx_atomic_init(&sched->num_idle, 0);
+  sched->terminate = 0;
+}
+
+void vp9_jobsched_deinit(JobSchedRowMt *sched) {
+  pthread_mutex_destroy(&sched->mutex);
+  pthread_cond_destroy(&sched->cond);
+}
+
+void vp9_jobsched_terminate(JobSchedRowMt *sched) {
+  pthread_mutex_lock(&sched->mutex);
+  sched->terminate = 1;
+  pthread_cond_broadcast(&sched->cond);
+  pthread_mutex_unlock(&sched->mutex);
+}
+
+int vp9_jobsched_queue(JobSchedRowMt *sched, int list_idx, int job) {
+  JobListRowMt *const list = &sched->lists[list_idx];
+  const int tail = vpx_atomic_load_acquire(&list->tail);
+
+  if (tail >= list->size) {
+    /* Wrap around case is not supported */
+    assert(0);
+    return 1;
+  }
+  vpx_atomic_store_release(&list->jobs[tail], job);
+  vpx_atomic_store_release(&list->tail, tail + 1);
+
+  // Pairs with the update of num_idle in vp9_jobsched_dequeue(): either the
+  // sleeping worker sees the job or the job is queued after the worker
+  // declared itself idle, and it is woken up here.
+  vpx_atomic_fetch_add(&sched->num_jobs, 1);
+  if (vpx_atomic_fetch_add(&sched->num_idle, 0) > 0) {
+    pthread_mutex_lock(&sched->mutex);
+    pthread_cond_signal(&sched->cond);
+    pthread_mutex_unlock(&sched->mutex);
+  }
+  return 0;
+}
+
+static int take_job(JobSchedRowMt *sched, JobListRowMt *list, int *job) {
+  int head = vpx_atomic_load_acquire(&list->head);
+  while (head < vpx_atomic_load_acquire(&list->tail)) {
+    // Slots are not reused within a frame, so the job read here is valid if
+    // the head has not moved meanwhile.
+    const int j = vpx_atomic_load_acquire(&list->jobs[head]);
+    if (vpx_atomic_compare_exchange(&list->head, head, head + 1)) {
+      vpx_atomic_fetch_add(&sched->num_jobs, -1);
+      *job = j;
+      return 1;
+    }
+    head = vpx_atomic_load_acquire(&list->head);
+  }
+  return 0;
+}
+
+int vp9_jobsched_dequeue(JobSchedRowMt *sched, int list_idx, int *job) {
+  const int num_lists = sched->num_lists;
+  while (1) {
+    int done;
+    int i;
+
+    for (i = 0; i < num_lists; ++i) {
+      // Own list first, then steal from the next workers.
+      JobListRowMt *const list = &sched->lists[(list_idx + i) % num_lists];
+      if (take_job(sched, list, job)) return 0;
+    }
+
+    pthread_mutex_lock(&sched->mutex);
+    vpx_atomic_fetch_add(&sched->num_idle, 1);
+    while (vpx_atomic_fetch_add(&sched->num_jobs, 0) <= 0 && !sched->terminate)
+      pthread_cond_wait(&sched->cond, &sched->mutex);
+    vpx_atomic_fetch_add(&sched->num_idle, -1);
+    done = sched->terminate && vpx_atomic_fetch_add(&sched->num_jobs, 0) <= 0;
+    pthread_mutex_unlock(&sched->mutex);
+    if (done) return 1;
+  }
+}
+#endif  // CONFIG_MULTITHREAD
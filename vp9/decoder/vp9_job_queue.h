@@ -11,6 +11,7 @@
 #ifndef VPX_VP9_DECODER_VP9_JOB_QUEUE_H_
 #define VPX_VP9_DECODER_VP9_JOB_QUEUE_H_
 
+#include "vpx_util/vpx_atomics.h"
 #include "vpx_util/vpx_thread.h"
 
 typedef struct {
@@ -38,8 +39,52 @@ void vp9_jobq_init(JobQueueRowMt *jobq, uint8_t *buf, size_t buf_size);
 void vp9_jobq_reset(JobQueueRowMt *jobq);
 void vp9_jobq_deinit(JobQueueRowMt *jobq);
 void vp9_jobq_terminate(JobQueueRowMt *jobq);
-int vp9_jobq_queue(JobQueueRowMt *jobq, void *job, size_t job_size);
+int vp9_jobq_queue(JobQueueRowMt *jobq, const void *job, size_t job_size);
 int vp9_jobq_dequeue(JobQueueRowMt *jobq, void *job, size_t job_size,
                      int blocking);
 
+#if CONFIG_MULTITHREAD
+// Job list of one worker. Only the owner adds jobs at the tail, any worker
+// takes them from the head. The list does not wrap around, so each slot is
+// written once per frame.
+typedef struct {
+  vpx_atomic_int head;
+  vpx_atomic_int tail;
+  vpx_atomic_int *jobs;
+  int size;
+} JobListRowMt;
+
+// Work stealing scheduler: a worker takes jobs from its own list first and
+// steals from the lists of the other workers when it runs out. Jobs are
+// encoded in an int. The mutex is only taken to put idle workers to sleep and
+// wake them up.
+typedef struct {
+  JobListRowMt *lists;
+  int num_lists;
+
+  // Jobs queued and not yet taken.
+  vpx_atomic_int num_jobs;
+
+  // Workers sleeping on cond.
+  vpx_atomic_int num_idle;
+
+  int terminate;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+} JobSchedRowMt;
+
+void vp9_jobsched_init(JobSchedRowMt *sched);
+void vp9_jobsched_set_lists(JobSchedRowMt *sched, JobListRowMt *lists,
+                            vpx_atomic_int *buf, int num_lists,
+                            int list_size);
+void vp9_jobsched_reset(JobSchedRowMt *sched);
+void vp9_jobsched_deinit(JobSchedRowMt *sched);
+void vp9_jobsched_terminate(JobSchedRowMt *sched);
+int vp9_jobsched_queue(JobSchedRowMt *sched, int list_idx, int job);
+// Blocks until a job is available. Returns 1 once the scheduler has been
+// terminated and all the jobs have been taken.
+int vp9_jobsched_dequeue(JobSchedRowMt *sched, int list_idx, int *job);
+#endif  // CONFIG_MULTITHREAD
+
 #endif  // VPX_VP9_DECODER_VP9_JOB_QUEUE_H_
@@ -343,7 +343,7 @@ static int is_superblock_flat_static(VP9_COMP *const cpi, int sb_row_index,
     uint64_t block_sad;
     const uint8_t *last_src_y = cpi->Last_Source->y_buffer;
     const int last_ystride = cpi->Last_Source->y_stride;
-    last_src_y += (sb_row_index << 6) * ystride + (sb_col_index << 6);
+    last_src_y += (sb_row_index << 6) * last_ystride + (sb_col_index << 6);
     block_sad =
         cpi->fn_ptr[bsize].sdf(src_y, ystride, last_src_y, last_ystride);
     if (block_sad == 0) return 1;
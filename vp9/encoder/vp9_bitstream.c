@@ -1355,6 +1355,7 @@ void vp9_pack_bitstream(VP9_COMP *cpi, uint8_t *dest, size_t *size) {
   size_t first_part_size, uncompressed_hdr_size;
   struct vpx_write_bit_buffer wb = { data, 0 };
   struct vpx_write_bit_buffer saved_wb;
+  const uint64_t stage_t = frame_stage_start(cpi);
 
 #if CONFIG_BITSTREAM_DEBUG
   bitstream_queue_reset_write();
@@ -1367,6 +1368,7 @@ void vp9_pack_bitstream(VP9_COMP *cpi, uint8_t *dest, size_t *size) {
     uncompressed_hdr_size = vpx_wb_bytes_written(&wb);
     data += uncompressed_hdr_size;
     *size = data - dest;
+    frame_stage_mark(cpi, VP9E_STAGE_BITSTREAM, stage_t);
     return;
   }
 
@@ -1386,4 +1388,5 @@ void vp9_pack_bitstream(VP9_COMP *cpi, uint8_t *dest, size_t *size) {
   data += encode_tiles(cpi, data);
 
   *size = data - dest;
+  frame_stage_mark(cpi, VP9E_STAGE_BITSTREAM, stage_t);
 }
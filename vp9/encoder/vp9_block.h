@@ -212,6 +212,9 @@ struct macroblock {
   DECLARE_ALIGNED(16, uint8_t, est_pred[64 * 64]);
 
   struct scale_factors *me_sf;
+
+  // Stage timing destination of the thread, NULL when disabled.
+  struct EncStageCounts *stage;
 };
 
 #ifdef __cplusplus
@@ -1238,8 +1238,8 @@ static void chroma_check(VP9_COMP *cpi, MACROBLOCK *x, int bsize,
   }
 }
 
-static uint64_t avg_source_sad(VP9_COMP *cpi, MACROBLOCK *x, int shift,
-                               int sb_offset) {
+static uint64_t avg_source_sad(VP9_COMP *cpi, MACROBLOCK *x, int mi_row,
+                               int mi_col, int sb_offset) {
   unsigned int tmp_sse;
   uint64_t tmp_sad;
   unsigned int tmp_variance;
@@ -1253,8 +1253,8 @@ static uint64_t avg_source_sad(VP9_COMP *cpi, MACROBLOCK *x, int shift,
 #if CONFIG_VP9_HIGHBITDEPTH
   if (cpi->common.use_highbitdepth) return 0;
 #endif
-  src_y += shift;
-  last_src_y += shift;
+  src_y += src_ystride * (mi_row << 3) + (mi_col << 3);
+  last_src_y += last_src_ystride * (mi_row << 3) + (mi_col << 3);
   tmp_sad =
       cpi->fn_ptr[bsize].sdf(src_y, src_ystride, last_src_y, last_src_ystride);
   tmp_variance = vpx_variance64x64(src_y, src_ystride, last_src_y,
@@ -2005,6 +2005,7 @@ static void rd_pick_sb_modes(VP9_COMP *cpi, TileDataEnc *tile_data,
   const AQ_MODE aq_mode = cpi->oxcf.aq_mode;
   int i, orig_rdmult;
   int64_t best_rd = INT64_MAX;
+  const uint64_t t = stage_start(x->stage);
 
   vpx_clear_system_state();
 
@@ -2105,6 +2106,7 @@ static void rd_pick_sb_modes(VP9_COMP *cpi, TileDataEnc *tile_data,
 
   ctx->rate = rd_cost->rate;
   ctx->dist = rd_cost->dist;
+  stage_mark(x->stage, VP9E_STAGE_MODE_DECISION, t);
 }
 #endif  // !CONFIG_REALTIME_ONLY
 
@@ -4424,9 +4426,12 @@ static void encode_rd_sb_row(VP9_COMP *cpi, ThreadData *td,
     const int idx_str = cm->mi_stride * mi_row + mi_col;
     MODE_INFO **mi = cm->mi_grid_visible + idx_str;
 
+    uint64_t sb_start;
+
     vp9_rd_cost_reset(&dummy_rdc);
     (*(cpi->row_mt_sync_read_ptr))(&tile_data->row_mt_sync, sb_row,
                                    sb_col_in_tile);
+    sb_start = stage_start(x->stage);
 
     if (sf->adaptive_pred_interp_filter) {
       for (i = 0; i < 64; ++i) td->leaf_tree[i].pred_interp_filter = SWITCHABLE;
@@ -4498,6 +4503,7 @@ static void encode_rd_sb_row(VP9_COMP *cpi, ThreadData *td,
       rd_pick_partition(cpi, td, tile_data, tp, mi_row, mi_col, BLOCK_64X64,
                         &dummy_rdc, dummy_rdc, td->pc_root);
     }
+    if (x->stage != NULL) x->stage->sb_ticks += vpx_timer_ticks() - sb_start;
     (*(cpi->row_mt_sync_write_ptr))(&tile_data->row_mt_sync, sb_row,
                                     sb_col_in_tile, num_sb_cols);
   }
@@ -4623,6 +4629,7 @@ static void nonrd_pick_sb_modes(VP9_COMP *cpi, TileDataEnc *tile_data,
   const int num_4x4_blocks_wide = num_4x4_blocks_wide_lookup[bs];
   const int num_4x4_blocks_high = num_4x4_blocks_high_lookup[bs];
   int plane;
+  const uint64_t t = stage_start(x->stage);
 
   set_offsets(cpi, tile_info, x, mi_row, mi_col, bsize);
 
@@ -4675,6 +4682,7 @@ static void nonrd_pick_sb_modes(VP9_COMP *cpi, TileDataEnc *tile_data,
 
   ctx->rate = rd_cost->rate;
   ctx->dist = rd_cost->dist;
+  stage_mark(x->stage, VP9E_STAGE_MODE_DECISION, t);
 }
 
 static void fill_mode_info_sb(VP9_COMMON *cm, MACROBLOCK *x, int mi_row,
@@ -5452,9 +5460,11 @@ static void encode_nonrd_sb_row(VP9_COMP *cpi, ThreadData *td,
     BLOCK_SIZE bsize = BLOCK_64X64;
     int seg_skip = 0;
     int i;
+    uint64_t sb_start;
 
     (*(cpi->row_mt_sync_read_ptr))(&tile_data->row_mt_sync, sb_row,
                                    sb_col_in_tile);
+    sb_start = stage_start(x->stage);
 
     if (cpi->use_skin_detection) {
       vp9_compute_skin_sb(cpi, BLOCK_16X16, mi_row, mi_col);
@@ -5491,9 +5501,8 @@ static void encode_nonrd_sb_row(VP9_COMP *cpi, ThreadData *td,
     }
 
     if (cpi->compute_source_sad_onepass && cpi->sf.use_source_sad) {
-      int shift = cpi->Source->y_stride * (mi_row << 3) + (mi_col << 3);
       int sb_offset2 = ((cm->mi_cols + 7) >> 3) * (mi_row >> 3) + (mi_col >> 3);
-      int64_t source_sad = avg_source_sad(cpi, x, shift, sb_offset2);
+      int64_t source_sad = avg_source_sad(cpi, x, mi_row, mi_col, sb_offset2);
       if (sf->adapt_partition_source_sad &&
           (cpi->oxcf.rc_mode == VPX_VBR && !cpi->rc.is_src_frame_alt_ref &&
            source_sad > sf->adapt_partition_thresh &&
@@ -5578,6 +5587,7 @@ static void encode_nonrd_sb_row(VP9_COMP *cpi, ThreadData *td,
         cpi->count_lastgolden_frame_usage[sboffset] = x->lastgolden_frame_usage;
     }
 
+    if (x->stage != NULL) x->stage->sb_ticks += vpx_timer_ticks() - sb_start;
     (*(cpi->row_mt_sync_write_ptr))(&tile_data->row_mt_sync, sb_row,
                                     sb_col_in_tile, num_sb_cols);
   }
@@ -6067,15 +6077,25 @@ static void encode_frame_internal(VP9_COMP *cpi) {
       cpi->row_mt_sync_write_ptr = vp9_row_mt_sync_write_dummy;
       // If allowed, encoding tiles in parallel with one thread handling one
       // tile when row based multi-threading is disabled.
-      if (VPXMIN(cpi->oxcf.max_threads, 1 << cm->log2_tile_cols) > 1)
+      if (VPXMIN(cpi->oxcf.max_threads, 1 << cm->log2_tile_cols) > 1) {
         vp9_encode_tiles_mt(cpi);
-      else
+      } else {
+        const uint64_t start = frame_stage_start(cpi);
+        reset_stage_counts(cpi, &cpi->td);
         encode_tiles(cpi);
+        if (cpi->stage_stats) {
+          vp9_accumulate_stage_counts(cpi, &cpi->td, 0,
+                                      vpx_timer_ticks() - start);
+        }
+      }
     } else {
       cpi->row_mt_sync_read_ptr = vp9_row_mt_sync_read;
       cpi->row_mt_sync_write_ptr = vp9_row_mt_sync_write;
       vp9_encode_tiles_row_mt(cpi);
     }
+    // The stages below the tile level are only timed while encoding tiles.
+    cpi->td.mb.stage = NULL;
+    if (cpi->stage_stats) ++cpi->frame_stage_stats.encode_passes;
 
     vpx_usec_timer_mark(&emr_timer);
     cpi->time_encode_sb_row += vpx_usec_timer_elapsed(&emr_timer);
@@ -6373,6 +6393,7 @@ static void encode_superblock(VP9_COMP *cpi, ThreadData *td, TOKENEXTRA **t,
   MODE_INFO *mi = xd->mi[0];
   const int seg_skip =
       segfeature_active(&cm->seg, mi->segment_id, SEG_LVL_SKIP);
+  uint64_t stage_t;
   x->skip_recode = !x->select_tx_size && mi->sb_type >= BLOCK_8X8 &&
                    cpi->oxcf.aq_mode != COMPLEXITY_AQ &&
                    cpi->oxcf.aq_mode != CYCLIC_REFRESH_AQ &&
@@ -6389,6 +6410,7 @@ static void encode_superblock(VP9_COMP *cpi, ThreadData *td, TOKENEXTRA **t,
 
   if (x->skip_encode) return;
 
+  stage_t = stage_start(x->stage);
   if (!is_inter_block(mi)) {
     int plane;
 #if CONFIG_BETTER_HW_COMPATIBILITY && CONFIG_VP9_HIGHBITDEPTH
@@ -6475,4 +6497,9 @@ static void encode_superblock(VP9_COMP *cpi, ThreadData *td, TOKENEXTRA **t,
           cpi->svc.spatial_layer_id == cpi->svc.number_spatial_layers - 1)))
       update_zeromv_cnt(cpi, mi, mi_row, mi_col, bsize);
   }
+  // The dry runs rd_pick_partition() makes to cost a partition belong to the
+  // search; only the final encode of the chosen modes is quantization.
+  stage_mark(x->stage,
+             output_enabled ? VP9E_STAGE_QUANTIZE : VP9E_STAGE_MODE_DECISION,
+             stage_t);
 }
@@ -1020,6 +1020,10 @@ static void dealloc_compressor_data(VP9_COMP *cpi) {
   vpx_free(cpi->mi_ssim_rdmult_scaling_factors);
   cpi->mi_ssim_rdmult_scaling_factors = NULL;
 
+  vpx_free(cpi->arnr_filter_data.block_search);
+  cpi->arnr_filter_data.block_search = NULL;
+  cpi->arnr_filter_data.block_search_size = 0;
+
   vp9_free_ref_frame_buffers(cm->buffer_pool);
 #if CONFIG_VP9_POSTPROC
   vp9_free_postproc_buffers(cm);
@@ -1937,12 +1941,18 @@ static void alloc_copy_partition_data(VP9_COMP *cpi) {
   }
 }
 
+void vp9_sync_loopfilter_pipeline(VP9_COMP *cpi) {
+  vpx_get_worker_interface()->sync(&cpi->lf_pipeline_worker);
+}
+
 void vp9_change_config(struct VP9_COMP *cpi, const VP9EncoderConfig *oxcf) {
   VP9_COMMON *const cm = &cpi->common;
   RATE_CONTROL *const rc = &cpi->rc;
   int last_w = cpi->oxcf.width;
   int last_h = cpi->oxcf.height;
 
+  vp9_sync_loopfilter_pipeline(cpi);
+
   vp9_init_quantizer(cpi);
   if (cm->profile != oxcf->profile) cm->profile = oxcf->profile;
   cm->bit_depth = oxcf->bit_depth;
@@ -2168,6 +2178,7 @@ VP9_COMP *vp9_create_compressor(VP9EncoderConfig *oxcf,
   if (!cm) return NULL;
 
   vp9_zero(*cpi);
+  vpx_get_worker_interface()->init(&cpi->lf_pipeline_worker);
 
   if (setjmp(cm->error.jmp)) {
     cm->error.setjmp = 0;
@@ -2435,6 +2446,9 @@ VP9_COMP *vp9_create_compressor(VP9EncoderConfig *oxcf,
   cpi->tpl_ready = 0;
 #endif  // CONFIG_NON_GREEDY_MV
   for (i = 0; i < MAX_ARF_GOP_SIZE; ++i) cpi->tpl_stats[i].tpl_stats_ptr = NULL;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_init(&cpi->tpl_mutex, NULL);
+#endif
 
   // Allocate memory to store variances for a frame.
   CHECK_MEM_ERROR(cm, cpi->source_diff_var, vpx_calloc(cm->MBs, sizeof(diff)));
@@ -2545,6 +2559,9 @@ void vp9_remove_compressor(VP9_COMP *cpi) {
 
   if (!cpi) return;
 
+  vpx_get_worker_interface()->end(&cpi->lf_pipeline_worker);
+  vpx_free(cpi->lf_pipeline_worker.data1);
+
 #if CONFIG_INTERNAL_STATS
   vpx_free(cpi->ssim_vars);
 #endif
@@ -2645,6 +2662,10 @@ void vp9_remove_compressor(VP9_COMP *cpi) {
   vp9_denoiser_free(&(cpi->denoiser));
 #endif
 
+#if CONFIG_MULTITHREAD
+  pthread_mutex_destroy(&cpi->tpl_mutex);
+#endif
+
   if (cpi->kmeans_data_arr_alloc) {
 #if CONFIG_MULTITHREAD
     pthread_mutex_destroy(&cpi->kmeans_mutex);
@@ -2809,6 +2830,7 @@ static YV12_BUFFER_CONFIG *get_vp9_ref_frame_buffer(
 int vp9_copy_reference_enc(VP9_COMP *cpi, VP9_REFFRAME ref_frame_flag,
                            YV12_BUFFER_CONFIG *sd) {
   YV12_BUFFER_CONFIG *cfg = get_vp9_ref_frame_buffer(cpi, ref_frame_flag);
+  vp9_sync_loopfilter_pipeline(cpi);
   if (cfg) {
     vpx_yv12_copy_frame(cfg, sd);
     return 0;
@@ -2820,6 +2842,7 @@ int vp9_copy_reference_enc(VP9_COMP *cpi, VP9_REFFRAME ref_frame_flag,
 int vp9_set_reference_enc(VP9_COMP *cpi, VP9_REFFRAME ref_frame_flag,
                           YV12_BUFFER_CONFIG *sd) {
   YV12_BUFFER_CONFIG *cfg = get_vp9_ref_frame_buffer(cpi, ref_frame_flag);
+  vp9_sync_loopfilter_pipeline(cpi);
   if (cfg) {
     vpx_yv12_copy_frame(sd, cfg);
     return 0;
@@ -2896,11 +2919,13 @@ void vp9_write_yuv_rec_frame(VP9_COMMON *cm) {
 #endif
 
 #if CONFIG_VP9_HIGHBITDEPTH
-static void scale_and_extend_frame_nonnormative(const YV12_BUFFER_CONFIG *src,
+static void scale_and_extend_frame_nonnormative(VP9_COMP *cpi,
+                                                const YV12_BUFFER_CONFIG *src,
                                                 YV12_BUFFER_CONFIG *dst,
                                                 int bd) {
 #else
-static void scale_and_extend_frame_nonnormative(const YV12_BUFFER_CONFIG *src,
+static void scale_and_extend_frame_nonnormative(VP9_COMP *cpi,
+                                                const YV12_BUFFER_CONFIG *src,
                                                 YV12_BUFFER_CONFIG *dst) {
 #endif  // CONFIG_VP9_HIGHBITDEPTH
   // TODO(dkovalev): replace YV12_BUFFER_CONFIG with vpx_image_t
@@ -2919,20 +2944,36 @@ static void scale_and_extend_frame_nonnormative(const YV12_BUFFER_CONFIG *src,
   const int dst_heights[3] = { dst->y_crop_height, dst->uv_crop_height,
                                dst->uv_crop_height };
 
-  for (i = 0; i < MAX_MB_PLANE; ++i) {
 #if CONFIG_VP9_HIGHBITDEPTH
-    if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
+  if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
+    for (i = 0; i < MAX_MB_PLANE; ++i)
       vp9_highbd_resize_plane(srcs[i], src_heights[i], src_widths[i],
                               src_strides[i], dsts[i], dst_heights[i],
                               dst_widths[i], dst_strides[i], bd);
-    } else {
+    vpx_extend_frame_borders(dst);
+    return;
+  }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+  // Only workers that already exist are used, so the first frames of a
+  // multi-threaded encode are resized on the main thread.
+  if (cpi->num_workers > 1) {
+    ResizePlaneJob jobs[MAX_MB_PLANE];
+    int ok = 1;
+    for (i = 0; i < MAX_MB_PLANE; ++i)
+      ok &= vp9_resize_plane_job_init(&jobs[i], srcs[i], src_heights[i],
+                                      src_widths[i], src_strides[i], dsts[i],
+                                      dst_heights[i], dst_widths[i],
+                                      dst_strides[i]);
+    if (ok) vp9_resize_planes_mt(cpi, jobs);
+    for (i = 0; i < MAX_MB_PLANE; ++i) vp9_resize_plane_job_free(&jobs[i]);
+    if (!ok)
+      vpx_internal_error(&cpi->common.error, VPX_CODEC_MEM_ERROR,
+                         "Failed to allocate resize buffers");
+  } else {
+    for (i = 0; i < MAX_MB_PLANE; ++i)
       vp9_resize_plane(srcs[i], src_heights[i], src_widths[i], src_strides[i],
                        dsts[i], dst_heights[i], dst_widths[i], dst_strides[i]);
-    }
-#else
-    vp9_resize_plane(srcs[i], src_heights[i], src_widths[i], src_strides[i],
-                     dsts[i], dst_heights[i], dst_widths[i], dst_strides[i]);
-#endif  // CONFIG_VP9_HIGHBITDEPTH
   }
   vpx_extend_frame_borders(dst);
 }
@@ -3192,6 +3233,39 @@ void vp9_update_reference_frames(VP9_COMP *cpi) {
   if (is_one_pass_cbr_svc(cpi)) vp9_svc_update_ref_frame(cpi);
 }
 
+static int loopfilter_pipeline_hook(void *arg1, void *unused) {
+  LFWorkerData *const lf_data = (LFWorkerData *)arg1;
+  (void)unused;
+  vp9_loop_filter_worker(lf_data, NULL);
+  vpx_extend_frame_inner_borders(lf_data->frame_buffer);
+  return 1;
+}
+
+// Filters cm->frame_to_show on cpi->lf_pipeline_worker. The caller waits for
+// it with vp9_sync_loopfilter_pipeline().
+static void launch_loopfilter_pipeline(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  VPxWorker *const worker = &cpi->lf_pipeline_worker;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  LFWorkerData *lf_data;
+
+  if (worker->data1 == NULL) {
+    CHECK_MEM_ERROR(cm, worker->data1, vpx_memalign(32, sizeof(LFWorkerData)));
+    worker->hook = loopfilter_pipeline_hook;
+    if (!winterface->reset(worker)) {
+      vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
+                         "Loop filter thread creation failed");
+    }
+  }
+
+  lf_data = (LFWorkerData *)worker->data1;
+  winterface->sync(worker);
+  vp9_loop_filter_data_reset(lf_data, cm->frame_to_show, cm,
+                             cpi->td.mb.e_mbd.plane);
+  lf_data->stop = cm->mi_rows;
+  winterface->launch(worker);
+}
+
 static void loopfilter_frame(VP9_COMP *cpi, VP9_COMMON *cm) {
   MACROBLOCKD *xd = &cpi->td.mb.e_mbd;
   struct loopfilter *lf = &cm->lf;
@@ -3213,6 +3287,7 @@ static void loopfilter_frame(VP9_COMP *cpi, VP9_COMMON *cm) {
     lf->last_filt_level = 0;
   } else {
     struct vpx_usec_timer timer;
+    const uint64_t stage_t = frame_stage_start(cpi);
 
     vpx_clear_system_state();
 
@@ -3231,11 +3306,21 @@ static void loopfilter_frame(VP9_COMP *cpi, VP9_COMMON *cm) {
 
     vpx_usec_timer_mark(&timer);
     cpi->time_pick_lpf += vpx_usec_timer_elapsed(&timer);
+    frame_stage_mark(cpi, VP9E_STAGE_LOOP_FILTER_PICK, stage_t);
   }
 
   if (lf->filter_level > 0 && is_reference_frame) {
     vp9_build_mask_frame(cm, lf->filter_level, 0);
 
+    // The 4:2:0 and 4:4:4 filters only read the masks built above, so they
+    // can run while the bitstream is packed and the mode info is swapped.
+    // Encoder workers filter the rows in parallel instead.
+    if (cpi->oxcf.loopfilter_pipeline && cpi->num_workers <= 1 &&
+        cm->subsampling_x == cm->subsampling_y) {
+      launch_loopfilter_pipeline(cpi);
+      return;
+    }
+
     if (cpi->num_workers > 1)
       vp9_loop_filter_frame_mt(cm->frame_to_show, cm, xd->plane,
                                lf->filter_level, 0, 0, cpi->workers,
@@ -3630,16 +3715,22 @@ static void setup_denoiser_buffer(VP9_COMP *cpi) {
 }
 #endif
 
-static void init_motion_estimation(VP9_COMP *cpi) {
-  int y_stride = cpi->scaled_source.y_stride;
-
+static void init_search_sites(VP9_COMP *cpi, search_site_config *cfg,
+                              int stride) {
   if (cpi->sf.mv.search_method == NSTEP) {
-    vp9_init3smotion_compensation(&cpi->ss_cfg, y_stride);
+    vp9_init3smotion_compensation(cfg, stride);
   } else if (cpi->sf.mv.search_method == DIAMOND) {
-    vp9_init_dsmotion_compensation(&cpi->ss_cfg, y_stride);
+    vp9_init_dsmotion_compensation(cfg, stride);
   }
 }
 
+static void init_motion_estimation(VP9_COMP *cpi) {
+  init_search_sites(cpi, &cpi->ss_cfg, cpi->scaled_source.y_stride);
+  // Keep the sites for lent source frames in the same layout.
+  if (cpi->lent_ss_cfg.stride != 0)
+    init_search_sites(cpi, &cpi->lent_ss_cfg, cpi->lent_ss_cfg.stride);
+}
+
 static void set_frame_size(VP9_COMP *cpi) {
   int ref_frame;
   VP9_COMMON *const cm = &cpi->common;
@@ -3769,7 +3860,7 @@ static INLINE void set_raw_source_frame(VP9_COMP *cpi) {
 #ifdef ENABLE_KF_DENOISE
   if (is_spatial_denoise_enabled(cpi)) {
     cpi->raw_source_frame = vp9_scale_if_required(
-        cm, &cpi->raw_unscaled_source, &cpi->raw_scaled_source,
+        cpi, &cpi->raw_unscaled_source, &cpi->raw_scaled_source,
         (oxcf->pass == 0), EIGHTTAP, 0);
   } else {
     cpi->raw_source_frame = cpi->Source;
@@ -3835,7 +3926,7 @@ static int encode_without_recode_loop(VP9_COMP *cpi, size_t *size,
     svc->scaled_one_half = 0;
   } else {
     cpi->Source = vp9_scale_if_required(
-        cm, cpi->un_scaled_source, &cpi->scaled_source, (cpi->oxcf.pass == 0),
+        cpi, cpi->un_scaled_source, &cpi->scaled_source, (cpi->oxcf.pass == 0),
         filter_scaler, phase_scaler);
   }
 #ifdef OUTPUT_YUV_SVC_SRC
@@ -3850,7 +3941,7 @@ static int encode_without_recode_loop(VP9_COMP *cpi, size_t *size,
 #ifdef ENABLE_KF_DENOISE
     if (is_spatial_denoise_enabled(cpi)) {
       cpi->raw_source_frame = vp9_scale_if_required(
-          cm, &cpi->raw_unscaled_source, &cpi->raw_scaled_source,
+          cpi, &cpi->raw_unscaled_source, &cpi->raw_scaled_source,
           (cpi->oxcf.pass == 0), EIGHTTAP, phase_scaler);
     } else {
       cpi->raw_source_frame = cpi->Source;
@@ -3885,7 +3976,7 @@ static int encode_without_recode_loop(VP9_COMP *cpi, size_t *size,
        (cpi->noise_estimate.enabled && !cpi->oxcf.noise_sensitivity) ||
        cpi->compute_source_sad_onepass))
     cpi->Last_Source = vp9_scale_if_required(
-        cm, cpi->unscaled_last_source, &cpi->scaled_last_source,
+        cpi, cpi->unscaled_last_source, &cpi->scaled_last_source,
         (cpi->oxcf.pass == 0), EIGHTTAP, 0);
 
   if (cpi->Last_Source == NULL ||
@@ -4179,7 +4270,7 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size,
     }
 
     cpi->Source =
-        vp9_scale_if_required(cm, cpi->un_scaled_source, &cpi->scaled_source,
+        vp9_scale_if_required(cpi, cpi->un_scaled_source, &cpi->scaled_source,
                               (oxcf->pass == 0), EIGHTTAP, 0);
 
     // Unfiltered raw source used in metrics calculation if the source
@@ -4188,7 +4279,7 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size,
 #ifdef ENABLE_KF_DENOISE
       if (is_spatial_denoise_enabled(cpi)) {
         cpi->raw_source_frame = vp9_scale_if_required(
-            cm, &cpi->raw_unscaled_source, &cpi->raw_scaled_source,
+            cpi, &cpi->raw_unscaled_source, &cpi->raw_scaled_source,
             (oxcf->pass == 0), EIGHTTAP, 0);
       } else {
         cpi->raw_source_frame = cpi->Source;
@@ -4199,7 +4290,7 @@ static void encode_with_recode_loop(VP9_COMP *cpi, size_t *size,
     }
 
     if (cpi->unscaled_last_source != NULL)
-      cpi->Last_Source = vp9_scale_if_required(cm, cpi->unscaled_last_source,
+      cpi->Last_Source = vp9_scale_if_required(cpi, cpi->unscaled_last_source,
                                                &cpi->scaled_last_source,
                                                (oxcf->pass == 0), EIGHTTAP, 0);
 
@@ -4530,8 +4621,9 @@ YV12_BUFFER_CONFIG *vp9_svc_twostage_scale(
 }
 
 YV12_BUFFER_CONFIG *vp9_scale_if_required(
-    VP9_COMMON *cm, YV12_BUFFER_CONFIG *unscaled, YV12_BUFFER_CONFIG *scaled,
+    VP9_COMP *cpi, YV12_BUFFER_CONFIG *unscaled, YV12_BUFFER_CONFIG *scaled,
     int use_normative_scaler, INTERP_FILTER filter_type, int phase_scaler) {
+  VP9_COMMON *const cm = &cpi->common;
   if (cm->mi_cols * MI_SIZE != unscaled->y_width ||
       cm->mi_rows * MI_SIZE != unscaled->y_height) {
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -4543,13 +4635,14 @@ YV12_BUFFER_CONFIG *vp9_scale_if_required(
         scale_and_extend_frame(unscaled, scaled, (int)cm->bit_depth,
                                filter_type, phase_scaler);
     else
-      scale_and_extend_frame_nonnormative(unscaled, scaled, (int)cm->bit_depth);
+      scale_and_extend_frame_nonnormative(cpi, unscaled, scaled,
+                                          (int)cm->bit_depth);
 #else
     if (use_normative_scaler && unscaled->y_width <= (scaled->y_width << 1) &&
         unscaled->y_height <= (scaled->y_height << 1))
       vp9_scale_and_extend_frame(unscaled, scaled, filter_type, phase_scaler);
     else
-      scale_and_extend_frame_nonnormative(unscaled, scaled);
+      scale_and_extend_frame_nonnormative(cpi, unscaled, scaled);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
     return scaled;
   } else {
@@ -5357,9 +5450,54 @@ static void check_initial_width(VP9_COMP *cpi,
   }
 }
 
-int vp9_receive_raw_frame(VP9_COMP *cpi, vpx_enc_frame_flags_t frame_flags,
-                          YV12_BUFFER_CONFIG *sd, int64_t time_stamp,
-                          int64_t end_time) {
+// Frames held for lookahead are filtered into alt-refs and searched by the
+// temporal dependency model, which read them around their edges.
+static int needs_full_border(const VP9_COMP *cpi) {
+  return cpi->lookahead->max_sz > 1 + MAX_PRE_FRAMES;
+}
+
+// Lent source frames are extended in place like copied ones, so they can be
+// read in place when the source is not scaled and is allocated large enough.
+// The first pass noise estimate samples up to 57 pixels left of a block, past
+// the extended border, so first pass source frames are always copied.
+static int can_read_in_place(VP9_COMP *cpi, const YV12_BUFFER_CONFIG *sd,
+                             int padded_width, int padded_height, int border) {
+  const VP9_COMMON *const cm = &cpi->common;
+  const int full_border = needs_full_border(cpi);
+  const int min_width = full_border
+                            ? vp9_get_lookahead_extend_size(sd->y_crop_width)
+                            : vp9_get_src_extend_size(sd->y_crop_width);
+  const int min_height =
+      full_border ? vp9_get_lookahead_extend_size(sd->y_crop_height)
+                  : vp9_get_src_extend_size(sd->y_crop_height);
+  // Denoising writes its output back into the source frame.
+  return cpi->oxcf.pass != 1 && !cpi->use_svc &&
+         cpi->oxcf.resize_mode == RESIZE_NONE &&
+         cpi->oxcf.noise_sensitivity == 0 && sd->y_crop_width == cm->width &&
+         sd->y_crop_height == cm->height && border >= (full_border ? 16 : 0) &&
+         padded_width >= min_width && padded_height >= min_height;
+}
+
+// Returns the map of the source blocks that are unchanged from the previous
+// frame, which is the active map when it applies to the frame being received.
+static const unsigned char *get_static_map(const VP9_COMP *cpi,
+                                           const YV12_BUFFER_CONFIG *sd) {
+  const VP9_COMMON *const cm = &cpi->common;
+  if (cpi->oxcf.inactive_unchanged && cpi->active_map.enabled &&
+      cpi->lookahead->max_sz == 1 + MAX_PRE_FRAMES && !cpi->use_svc &&
+      cpi->oxcf.resize_mode == RESIZE_NONE &&
+      cpi->oxcf.noise_sensitivity == 0 && sd->y_crop_width == cm->width &&
+      sd->y_crop_height == cm->height) {
+    assert(AM_SEGMENT_ID_ACTIVE == 0);
+    return cpi->active_map.map;
+  }
+  return NULL;
+}
+
+static int receive_frame(VP9_COMP *cpi, vpx_enc_frame_flags_t frame_flags,
+                         YV12_BUFFER_CONFIG *sd, int padded_width,
+                         int padded_height, int border, int64_t time_stamp,
+                         int64_t end_time, const void *lent_frame) {
   VP9_COMMON *const cm = &cpi->common;
   struct vpx_usec_timer timer;
   int res = 0;
@@ -5384,17 +5522,9 @@ int vp9_receive_raw_frame(VP9_COMP *cpi, vpx_enc_frame_flags_t frame_flags,
 #if CONFIG_VP9_TEMPORAL_DENOISING
   setup_denoiser_buffer(cpi);
 #endif
-  vpx_usec_timer_start(&timer);
-
-  if (vp9_lookahead_push(cpi->lookahead, sd, time_stamp, end_time,
-#if CONFIG_VP9_HIGHBITDEPTH
-                         use_highbitdepth,
-#endif  // CONFIG_VP9_HIGHBITDEPTH
-                         frame_flags))
-    res = -1;
-  vpx_usec_timer_mark(&timer);
-  cpi->time_receive_data += vpx_usec_timer_elapsed(&timer);
 
+  // A lent frame is owned by the lookahead once it is pushed, so the checks
+  // that raise an error come first.
   if ((cm->profile == PROFILE_0 || cm->profile == PROFILE_2) &&
       (subsampling_x != 1 || subsampling_y != 1)) {
     vpx_internal_error(&cm->error, VPX_CODEC_INVALID_PARAM,
@@ -5408,9 +5538,54 @@ int vp9_receive_raw_frame(VP9_COMP *cpi, vpx_enc_frame_flags_t frame_flags,
     res = -1;
   }
 
+  vpx_usec_timer_start(&timer);
+
+  if (lent_frame != NULL) {
+    cpi->lookahead->release_lent_frame = cpi->release_lent_frame;
+    cpi->lookahead->release_priv = cpi->release_lent_priv;
+  }
+
+  if (lent_frame != NULL &&
+      can_read_in_place(cpi, sd, padded_width, padded_height, border)) {
+    if (vp9_lookahead_lend(cpi->lookahead, sd, needs_full_border(cpi),
+                           time_stamp, end_time, frame_flags, lent_frame)) {
+      cpi->release_lent_frame(cpi->release_lent_priv, lent_frame);
+      res = -1;
+    } else if (sd->y_stride != cpi->lent_ss_cfg.stride) {
+      // Motion searches on the frame step by its own stride.
+      init_search_sites(cpi, &cpi->lent_ss_cfg, sd->y_stride);
+    }
+  } else {
+    if (vp9_lookahead_push(cpi->lookahead, sd, time_stamp, end_time,
+#if CONFIG_VP9_HIGHBITDEPTH
+                           use_highbitdepth,
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+                           frame_flags, get_static_map(cpi, sd)))
+      res = -1;
+    if (lent_frame != NULL)
+      cpi->release_lent_frame(cpi->release_lent_priv, lent_frame);
+  }
+  vpx_usec_timer_mark(&timer);
+  cpi->time_receive_data += vpx_usec_timer_elapsed(&timer);
+
   return res;
 }
 
+int vp9_receive_raw_frame(VP9_COMP *cpi, vpx_enc_frame_flags_t frame_flags,
+                          YV12_BUFFER_CONFIG *sd, int64_t time_stamp,
+                          int64_t end_time) {
+  return receive_frame(cpi, frame_flags, sd, 0, 0, 0, time_stamp, end_time,
+                       NULL);
+}
+
+int vp9_receive_lent_frame(VP9_COMP *cpi, vpx_enc_frame_flags_t frame_flags,
+                           YV12_BUFFER_CONFIG *sd, int padded_width,
+                           int padded_height, int border, int64_t time_stamp,
+                           int64_t end_time, const void *lent_frame) {
+  return receive_frame(cpi, frame_flags, sd, padded_width, padded_height,
+                       border, time_stamp, end_time, lent_frame);
+}
+
 static int frame_is_reference(const VP9_COMP *cpi) {
   const VP9_COMMON *cm = &cpi->common;
 
@@ -5740,12 +5915,6 @@ static void update_level_info(VP9_COMP *cpi, size_t *size, int arf_src_index) {
   }
 }
 
-typedef struct GF_PICTURE {
-  YV12_BUFFER_CONFIG *frame;
-  int ref_frame[3];
-  FRAME_UPDATE_TYPE update_type;
-} GF_PICTURE;
-
 static void init_gop_frames(VP9_COMP *cpi, GF_PICTURE *gf_picture,
                             const GF_GROUP *gf_group, int *tpl_group_frames) {
   VP9_COMMON *cm = &cpi->common;
@@ -5893,9 +6062,10 @@ static void init_tpl_stats(VP9_COMP *cpi) {
 #if CONFIG_NON_GREEDY_MV
 static uint32_t full_pixel_motion_search(VP9_COMP *cpi, ThreadData *td,
                                          int frame_idx, uint8_t *cur_frame_buf,
-                                         uint8_t *ref_frame_buf, int stride,
-                                         BLOCK_SIZE bsize, int mi_row,
-                                         int mi_col, MV *mv, int rf_idx) {
+                                         int cur_stride, uint8_t *ref_frame_buf,
+                                         int ref_stride, BLOCK_SIZE bsize,
+                                         int mi_row, int mi_col, MV *mv,
+                                         int rf_idx) {
   MACROBLOCK *const x = &td->mb;
   MACROBLOCKD *const xd = &x->e_mbd;
   MV_SPEED_FEATURES *const mv_sf = &cpi->sf.mv;
@@ -5916,9 +6086,9 @@ static uint32_t full_pixel_motion_search(VP9_COMP *cpi, ThreadData *td,
 
   // Setup frame pointers
   x->plane[0].src.buf = cur_frame_buf;
-  x->plane[0].src.stride = stride;
+  x->plane[0].src.stride = cur_stride;
   xd->plane[0].pre[0].buf = ref_frame_buf;
-  xd->plane[0].pre[0].stride = stride;
+  xd->plane[0].pre[0].stride = ref_stride;
 
   step_param = mv_sf->reduce_first_step_size;
   step_param = VPXMIN(step_param, MAX_MVSEARCH_STEPS - 2);
@@ -5937,8 +6107,8 @@ static uint32_t full_pixel_motion_search(VP9_COMP *cpi, ThreadData *td,
 }
 
 static uint32_t sub_pixel_motion_search(VP9_COMP *cpi, ThreadData *td,
-                                        uint8_t *cur_frame_buf,
-                                        uint8_t *ref_frame_buf, int stride,
+                                        uint8_t *cur_frame_buf, int cur_stride,
+                                        uint8_t *ref_frame_buf, int ref_stride,
                                         BLOCK_SIZE bsize, MV *mv) {
   MACROBLOCK *const x = &td->mb;
   MACROBLOCKD *const xd = &x->e_mbd;
@@ -5952,9 +6122,9 @@ static uint32_t sub_pixel_motion_search(VP9_COMP *cpi, ThreadData *td,
 
   // Setup frame pointers
   x->plane[0].src.buf = cur_frame_buf;
-  x->plane[0].src.stride = stride;
+  x->plane[0].src.stride = cur_stride;
   xd->plane[0].pre[0].buf = ref_frame_buf;
-  xd->plane[0].pre[0].stride = stride;
+  xd->plane[0].pre[0].stride = ref_stride;
 
   // TODO(yunqing): may use higher tap interp filter than 2 taps.
   // Ignore mv costing by sending NULL pointer instead of cost array
@@ -5970,8 +6140,9 @@ static uint32_t sub_pixel_motion_search(VP9_COMP *cpi, ThreadData *td,
 #else  // CONFIG_NON_GREEDY_MV
 static uint32_t motion_compensated_prediction(VP9_COMP *cpi, ThreadData *td,
                                               uint8_t *cur_frame_buf,
+                                              int cur_stride,
                                               uint8_t *ref_frame_buf,
-                                              int stride, BLOCK_SIZE bsize,
+                                              int ref_stride, BLOCK_SIZE bsize,
                                               MV *mv) {
   MACROBLOCK *const x = &td->mb;
   MACROBLOCKD *const xd = &x->e_mbd;
@@ -5993,9 +6164,9 @@ static uint32_t motion_compensated_prediction(VP9_COMP *cpi, ThreadData *td,
 
   // Setup frame pointers
   x->plane[0].src.buf = cur_frame_buf;
-  x->plane[0].src.stride = stride;
+  x->plane[0].src.stride = cur_stride;
   xd->plane[0].pre[0].buf = ref_frame_buf;
-  xd->plane[0].pre[0].stride = stride;
+  xd->plane[0].pre[0].stride = ref_stride;
 
   step_param = mv_sf->reduce_first_step_size;
   step_param = VPXMIN(step_param, MAX_MVSEARCH_STEPS - 2);
@@ -6220,7 +6391,7 @@ static void set_mv_limits(const VP9_COMMON *cm, MACROBLOCK *x, int mi_row,
       ((cm->mi_cols - 1 - mi_col) * MI_SIZE) + (17 - 2 * VP9_INTERP_EXTEND);
 }
 
-static void mode_estimation(VP9_COMP *cpi, MACROBLOCK *x, MACROBLOCKD *xd,
+static void mode_estimation(VP9_COMP *cpi, ThreadData *td,
                             struct scale_factors *sf, GF_PICTURE *gf_picture,
                             int frame_idx, TplDepFrame *tpl_frame,
                             int16_t *src_diff, tran_low_t *coeff,
@@ -6229,7 +6400,8 @@ static void mode_estimation(VP9_COMP *cpi, MACROBLOCK *x, MACROBLOCKD *xd,
                             YV12_BUFFER_CONFIG *ref_frame[], uint8_t *predictor,
                             int64_t *recon_error, int64_t *sse) {
   VP9_COMMON *cm = &cpi->common;
-  ThreadData *td = &cpi->td;
+  MACROBLOCK *x = &td->mb;
+  MACROBLOCKD *xd = &x->e_mbd;
 
   const int bw = 4 << b_width_log2_lookup[bsize];
   const int bh = 4 << b_height_log2_lookup[bsize];
@@ -6303,22 +6475,27 @@ static void mode_estimation(VP9_COMP *cpi, MACROBLOCK *x, MACROBLOCKD *xd,
 
   for (rf_idx = 0; rf_idx < 3; ++rf_idx) {
     int_mv mv;
+    int ref_y_offset;
     if (ref_frame[rf_idx] == NULL) continue;
+    // Source frames lent to the encoder keep the application's stride.
+    ref_y_offset =
+        mi_row * MI_SIZE * ref_frame[rf_idx]->y_stride + mi_col * MI_SIZE;
 
 #if CONFIG_NON_GREEDY_MV
     (void)td;
     mv.as_int =
         get_pyramid_mv(tpl_frame, rf_idx, bsize, mi_row, mi_col)->as_int;
 #else
-    motion_compensated_prediction(cpi, td, xd->cur_buf->y_buffer + mb_y_offset,
-                                  ref_frame[rf_idx]->y_buffer + mb_y_offset,
-                                  xd->cur_buf->y_stride, bsize, &mv.as_mv);
+    motion_compensated_prediction(
+        cpi, td, xd->cur_buf->y_buffer + mb_y_offset, xd->cur_buf->y_stride,
+        ref_frame[rf_idx]->y_buffer + ref_y_offset, ref_frame[rf_idx]->y_stride,
+        bsize, &mv.as_mv);
 #endif
 
 #if CONFIG_VP9_HIGHBITDEPTH
     if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
       vp9_highbd_build_inter_predictor(
-          CONVERT_TO_SHORTPTR(ref_frame[rf_idx]->y_buffer + mb_y_offset),
+          CONVERT_TO_SHORTPTR(ref_frame[rf_idx]->y_buffer + ref_y_offset),
           ref_frame[rf_idx]->y_stride, CONVERT_TO_SHORTPTR(&predictor[0]), bw,
           &mv.as_mv, sf, bw, bh, 0, kernel, MV_PRECISION_Q3, mi_col * MI_SIZE,
           mi_row * MI_SIZE, xd->bd);
@@ -6329,7 +6506,7 @@ static void mode_estimation(VP9_COMP *cpi, MACROBLOCK *x, MACROBLOCKD *xd,
       inter_cost = vpx_highbd_satd(coeff, pix_num);
     } else {
       vp9_build_inter_predictor(
-          ref_frame[rf_idx]->y_buffer + mb_y_offset,
+          ref_frame[rf_idx]->y_buffer + ref_y_offset,
           ref_frame[rf_idx]->y_stride, &predictor[0], bw, &mv.as_mv, sf, bw, bh,
           0, kernel, MV_PRECISION_Q3, mi_col * MI_SIZE, mi_row * MI_SIZE);
       vpx_subtract_block(bh, bw, src_diff, bw,
@@ -6339,7 +6516,7 @@ static void mode_estimation(VP9_COMP *cpi, MACROBLOCK *x, MACROBLOCKD *xd,
       inter_cost = vpx_satd(coeff, pix_num);
     }
 #else
-    vp9_build_inter_predictor(ref_frame[rf_idx]->y_buffer + mb_y_offset,
+    vp9_build_inter_predictor(ref_frame[rf_idx]->y_buffer + ref_y_offset,
                               ref_frame[rf_idx]->y_stride, &predictor[0], bw,
                               &mv.as_mv, sf, bw, bh, 0, kernel, MV_PRECISION_Q3,
                               mi_col * MI_SIZE, mi_row * MI_SIZE);
@@ -6381,9 +6558,9 @@ static int get_block_src_pred_buf(MACROBLOCKD *xd, GF_PICTURE *gf_picture,
     ref_frame = gf_picture[ref_frame_idx].frame;
     src->buf = xd->cur_buf->y_buffer + mb_y_offset;
     src->stride = xd->cur_buf->y_stride;
-    pre->buf = ref_frame->y_buffer + mb_y_offset;
+    pre->buf = ref_frame->y_buffer + mi_row * MI_SIZE * ref_frame->y_stride +
+               mi_col * MI_SIZE;
     pre->stride = ref_frame->y_stride;
-    assert(src->stride == pre->stride);
     return 1;
   } else {
     printf("invalid ref_frame_idx");
@@ -6766,12 +6943,15 @@ static void do_motion_search(VP9_COMP *cpi, ThreadData *td, int frame_idx,
   {
     int_mv *mv = get_pyramid_mv(tpl_frame, rf_idx, bsize, mi_row, mi_col);
     uint8_t *cur_frame_buf = xd->cur_buf->y_buffer + mb_y_offset;
-    uint8_t *ref_frame_buf = ref_frame->y_buffer + mb_y_offset;
+    uint8_t *ref_frame_buf = ref_frame->y_buffer +
+                             mi_row * MI_SIZE * ref_frame->y_stride +
+                             mi_col * MI_SIZE;
     const int stride = xd->cur_buf->y_stride;
-    full_pixel_motion_search(cpi, td, frame_idx, cur_frame_buf, ref_frame_buf,
-                             stride, bsize, mi_row, mi_col, &mv->as_mv, rf_idx);
-    sub_pixel_motion_search(cpi, td, cur_frame_buf, ref_frame_buf, stride,
-                            bsize, &mv->as_mv);
+    full_pixel_motion_search(cpi, td, frame_idx, cur_frame_buf, stride,
+                             ref_frame_buf, ref_frame->y_stride, bsize, mi_row,
+                             mi_col, &mv->as_mv, rf_idx);
+    sub_pixel_motion_search(cpi, td, cur_frame_buf, stride, ref_frame_buf,
+                            ref_frame->y_stride, bsize, &mv->as_mv);
   }
 }
 
@@ -6952,19 +7132,19 @@ static void build_motion_field(VP9_COMP *cpi, MACROBLOCKD *xd, int frame_idx,
 }
 #endif  // CONFIG_NON_GREEDY_MV
 
-static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
-                              int frame_idx, BLOCK_SIZE bsize) {
+void vp9_mc_flow_dispenser_row(VP9_COMP *cpi, ThreadData *td, int mi_row,
+                               int mi_col_start, int mi_col_end) {
+  TplDispenserData *const data = &cpi->tpl_dispenser_data;
+  const int frame_idx = data->frame_idx;
+  const BLOCK_SIZE bsize = data->bsize;
   TplDepFrame *tpl_frame = &cpi->tpl_stats[frame_idx];
-  YV12_BUFFER_CONFIG *this_frame = gf_picture[frame_idx].frame;
-  YV12_BUFFER_CONFIG *ref_frame[3] = { NULL, NULL, NULL };
-
-  VP9_COMMON *cm = &cpi->common;
-  struct scale_factors sf;
-  int rdmult, idx;
-  ThreadData *td = &cpi->td;
-  MACROBLOCK *x = &td->mb;
-  MACROBLOCKD *xd = &x->e_mbd;
-  int mi_row, mi_col;
+  MACROBLOCKD *xd = &td->mb.e_mbd;
+  MODE_INFO **const mi_grid = xd->mi;
+  // Each job works on its own copy of the mode info that mode_estimation()
+  // scribbles on, so that row jobs never share it.
+  MODE_INFO mi = *cpi->common.mi;
+  MODE_INFO *mi_ptr = &mi;
+  int mi_col;
 
 #if CONFIG_VP9_HIGHBITDEPTH
   DECLARE_ALIGNED(16, uint16_t, predictor16[32 * 32 * 3]);
@@ -6979,28 +7159,72 @@ static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
   DECLARE_ALIGNED(16, tran_low_t, dqcoeff[32 * 32]);
 
   const TX_SIZE tx_size = max_txsize_lookup[bsize];
-  const int mi_height = num_8x8_blocks_high_lookup[bsize];
   const int mi_width = num_8x8_blocks_wide_lookup[bsize];
   int64_t recon_error, sse;
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH)
+    predictor = CONVERT_TO_BYTEPTR(predictor16);
+  else
+    predictor = predictor8;
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+  xd->mi = &mi_ptr;
+
+  for (mi_col = mi_col_start; mi_col < mi_col_end; mi_col += mi_width) {
+    mode_estimation(cpi, td, &data->sf, data->gf_picture, frame_idx,
+                    tpl_frame, src_diff, coeff, qcoeff, dqcoeff, mi_row,
+                    mi_col, bsize, tx_size, data->ref_frame, predictor,
+                    &recon_error, &sse);
+    tpl_model_store(tpl_frame->tpl_stats_ptr, mi_row, mi_col, bsize,
+                    tpl_frame->stride);
+  }
+
+  xd->mi = mi_grid;
+
+  // Motion flow dependency dispenser. The propagation only accumulates
+  // integer costs into the stats of the reference frames, so serializing the
+  // rows is enough to keep the result independent of the job order.
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&cpi->tpl_mutex);
+#endif
+  for (mi_col = mi_col_start; mi_col < mi_col_end; mi_col += mi_width)
+    tpl_model_update(cpi->tpl_stats, tpl_frame->tpl_stats_ptr, mi_row, mi_col,
+                     bsize);
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&cpi->tpl_mutex);
+#endif
+}
+
+static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
+                              int frame_idx, BLOCK_SIZE bsize) {
+  TplDepFrame *tpl_frame = &cpi->tpl_stats[frame_idx];
+  TplDispenserData *const data = &cpi->tpl_dispenser_data;
+  YV12_BUFFER_CONFIG *this_frame = gf_picture[frame_idx].frame;
+
+  VP9_COMMON *cm = &cpi->common;
+  int rdmult, idx;
+  ThreadData *td = &cpi->td;
+  MACROBLOCKD *xd = &td->mb.e_mbd;
+  const int mi_height = num_8x8_blocks_high_lookup[bsize];
 #if CONFIG_NON_GREEDY_MV
   int square_block_idx;
   int rf_idx;
 #endif
 
+  data->gf_picture = gf_picture;
+  data->frame_idx = frame_idx;
+  data->bsize = bsize;
+
   // Setup scaling factor
 #if CONFIG_VP9_HIGHBITDEPTH
   vp9_setup_scale_factors_for_frame(
-      &sf, this_frame->y_crop_width, this_frame->y_crop_height,
+      &data->sf, this_frame->y_crop_width, this_frame->y_crop_height,
       this_frame->y_crop_width, this_frame->y_crop_height,
       cpi->common.use_highbitdepth);
-
-  if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH)
-    predictor = CONVERT_TO_BYTEPTR(predictor16);
-  else
-    predictor = predictor8;
 #else
   vp9_setup_scale_factors_for_frame(
-      &sf, this_frame->y_crop_width, this_frame->y_crop_height,
+      &data->sf, this_frame->y_crop_width, this_frame->y_crop_height,
       this_frame->y_crop_width, this_frame->y_crop_height);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
@@ -7008,7 +7232,7 @@ static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
   // unavailable, the pointer will be set to Null.
   for (idx = 0; idx < 3; ++idx) {
     int rf_idx = gf_picture[frame_idx].ref_frame[idx];
-    if (rf_idx != -1) ref_frame[idx] = gf_picture[rf_idx].frame;
+    data->ref_frame[idx] = rf_idx != -1 ? gf_picture[rf_idx].frame : NULL;
   }
 
   xd->mi = cm->mi_grid_visible;
@@ -7029,29 +7253,23 @@ static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
   for (square_block_idx = 0; square_block_idx < SQUARE_BLOCK_SIZES;
        ++square_block_idx) {
     BLOCK_SIZE square_bsize = square_block_idx_to_bsize(square_block_idx);
-    build_motion_field(cpi, xd, frame_idx, ref_frame, square_bsize);
+    build_motion_field(cpi, xd, frame_idx, data->ref_frame, square_bsize);
   }
   for (rf_idx = 0; rf_idx < 3; ++rf_idx) {
     int ref_frame_idx = gf_picture[frame_idx].ref_frame[rf_idx];
     if (ref_frame_idx != -1) {
-      predict_mv_mode_arr(cpi, x, gf_picture, frame_idx, tpl_frame, rf_idx,
-                          bsize);
+      predict_mv_mode_arr(cpi, &td->mb, gf_picture, frame_idx, tpl_frame,
+                          rf_idx, bsize);
     }
   }
 #endif
 
-  for (mi_row = 0; mi_row < cm->mi_rows; mi_row += mi_height) {
-    for (mi_col = 0; mi_col < cm->mi_cols; mi_col += mi_width) {
-      mode_estimation(cpi, x, xd, &sf, gf_picture, frame_idx, tpl_frame,
-                      src_diff, coeff, qcoeff, dqcoeff, mi_row, mi_col, bsize,
-                      tx_size, ref_frame, predictor, &recon_error, &sse);
-      // Motion flow dependency dispenser.
-      tpl_model_store(tpl_frame->tpl_stats_ptr, mi_row, mi_col, bsize,
-                      tpl_frame->stride);
-
-      tpl_model_update(cpi->tpl_stats, tpl_frame->tpl_stats_ptr, mi_row, mi_col,
-                       bsize);
-    }
+  if (cpi->row_mt) {
+    vp9_mc_flow_dispenser_row_mt(cpi);
+  } else {
+    int mi_row;
+    for (mi_row = 0; mi_row < cm->mi_rows; mi_row += mi_height)
+      vp9_mc_flow_dispenser_row(cpi, td, mi_row, 0, cm->mi_cols);
   }
 }
 
@@ -7249,6 +7467,20 @@ static void setup_tpl_stats(VP9_COMP *cpi) {
 #endif  // CONFIG_NON_GREEDY_MV
 }
 
+// A lent source frame lacks the border the scaler reads, so it is copied when
+// the coded size has changed since it was received.
+static void copy_lent_source_if_scaled(VP9_COMP *cpi,
+                                       struct lookahead_entry *entry) {
+  VP9_COMMON *const cm = &cpi->common;
+  if (entry == NULL || entry->lent_frame == NULL) return;
+  if ((entry->img.y_crop_width != cm->width ||
+       entry->img.y_crop_height != cm->height) &&
+      vp9_lookahead_copy_lent(cpi->lookahead, entry)) {
+    vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                       "Failed to copy lent source frame");
+  }
+}
+
 int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
                             size_t *size, uint8_t *dest, int64_t *time_stamp,
                             int64_t *time_end, int flush) {
@@ -7257,6 +7489,7 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
   BufferPool *const pool = cm->buffer_pool;
   RATE_CONTROL *const rc = &cpi->rc;
   struct vpx_usec_timer cmptimer;
+  uint64_t stage_t, frame_t = 0;
   YV12_BUFFER_CONFIG *force_src_buffer = NULL;
   struct lookahead_entry *last_source = NULL;
   struct lookahead_entry *source = NULL;
@@ -7264,11 +7497,18 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
   const int gf_group_index = cpi->twopass.gf_group.index;
   int i;
 
+  // The previous frame is the reference for this one.
+  vp9_sync_loopfilter_pipeline(cpi);
+
   if (is_one_pass_cbr_svc(cpi)) {
     vp9_one_pass_cbr_svc_start_layer(cpi);
   }
 
   vpx_usec_timer_start(&cmptimer);
+  if (cpi->stage_stats) {
+    memset(&cpi->frame_stage_stats, 0, sizeof(cpi->frame_stage_stats));
+    frame_t = vpx_timer_ticks();
+  }
 
   vp9_set_high_precision_mv(cpi, ALTREF_HIGH_PRECISION_MV);
 
@@ -7329,8 +7569,10 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
         not_last_frame |= ALT_REF_AQ_APPLY_TO_LAST_FRAME;
 
         // Produce the filtered ARF frame.
+        stage_t = frame_stage_start(cpi);
         vp9_temporal_filter(cpi, arf_src_index);
         vpx_extend_frame_borders(&cpi->alt_ref_buffer);
+        frame_stage_mark(cpi, VP9E_STAGE_TEMPORAL_FILTER, stage_t);
 
         // for small bitrates segmentation overhead usually
         // eats all bitrate gain from enabling delta quantizers
@@ -7381,6 +7623,8 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
   }
 
   if (source) {
+    copy_lent_source_if_scaled(cpi, source);
+    copy_lent_source_if_scaled(cpi, last_source);
     cpi->un_scaled_source = cpi->Source =
         force_src_buffer ? force_src_buffer : &source->img;
 
@@ -7476,9 +7720,11 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
   if (gf_group_index == 1 &&
       cpi->twopass.gf_group.update_type[gf_group_index] == ARF_UPDATE &&
       cpi->sf.enable_tpl_model) {
+    stage_t = frame_stage_start(cpi);
     init_tpl_buffer(cpi);
     vp9_estimate_qp_gop(cpi);
     setup_tpl_stats(cpi);
+    frame_stage_mark(cpi, VP9E_STAGE_TPL, stage_t);
   }
 
 #if CONFIG_BITSTREAM_DEBUG
@@ -7547,9 +7793,17 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
 
   vpx_usec_timer_mark(&cmptimer);
   cpi->time_compress_data += vpx_usec_timer_elapsed(&cmptimer);
+  if (cpi->stage_stats && *size > 0) {
+    cpi->frame_stage_stats.frame_ticks = vpx_timer_ticks() - frame_t;
+    cpi->frame_stage_stats.frame_usec = vpx_usec_timer_elapsed(&cmptimer);
+    cpi->last_stage_stats = cpi->frame_stage_stats;
+  }
 
   // Should we calculate metrics for the frame.
-  if (is_psnr_calc_enabled(cpi)) generate_psnr_packet(cpi);
+  if (is_psnr_calc_enabled(cpi)) {
+    vp9_sync_loopfilter_pipeline(cpi);
+    generate_psnr_packet(cpi);
+  }
 
   if (cpi->keep_level_stats && oxcf->pass != 1)
     update_level_info(cpi, size, arf_src_index);
@@ -7559,6 +7813,7 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
   if (oxcf->pass != 1) {
     double samples = 0.0;
     cpi->bytes += (int)(*size);
+    vp9_sync_loopfilter_pipeline(cpi);
 
     if (cm->show_frame) {
       uint32_t bit_depth = 8;
@@ -7609,7 +7864,7 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
             ppflags.deblocking_level = 0;  // not used in vp9_post_proc_frame()
             ppflags.noise_level = 0;       // not used in vp9_post_proc_frame()
             vp9_post_proc_frame(cm, pp, &ppflags,
-                                cpi->un_scaled_source->y_width);
+                                cpi->un_scaled_source->y_width, NULL, 0);
           }
 #endif
           vpx_clear_system_state();
@@ -7741,8 +7996,10 @@ int vp9_get_preview_raw_frame(VP9_COMP *cpi, YV12_BUFFER_CONFIG *dest,
     return -1;
   } else {
     int ret;
+    vp9_sync_loopfilter_pipeline(cpi);
 #if CONFIG_VP9_POSTPROC
-    ret = vp9_post_proc_frame(cm, dest, flags, cpi->un_scaled_source->y_width);
+    ret = vp9_post_proc_frame(cm, dest, flags, cpi->un_scaled_source->y_width,
+                              NULL, 0);
 #else
     if (cm->frame_to_show) {
       *dest = *cm->frame_to_show;
@@ -7767,6 +8024,7 @@ int vp9_set_internal_size(VP9_COMP *cpi, VPX_SCALING horiz_mode,
 
   if (horiz_mode > ONETWO || vert_mode > ONETWO) return -1;
 
+  vp9_sync_loopfilter_pipeline(cpi);
   Scale2Ratio(horiz_mode, &hr, &hs);
   Scale2Ratio(vert_mode, &vr, &vs);
 
@@ -7786,6 +8044,7 @@ int vp9_set_internal_size(VP9_COMP *cpi, VPX_SCALING horiz_mode,
 int vp9_set_size_literal(VP9_COMP *cpi, unsigned int width,
                          unsigned int height) {
   VP9_COMMON *cm = &cpi->common;
+  vp9_sync_loopfilter_pipeline(cpi);
 #if CONFIG_VP9_HIGHBITDEPTH
   check_initial_width(cpi, cm->use_highbitdepth, 1, 1);
 #else
@@ -7883,3 +8142,27 @@ void vp9_set_row_mt(VP9_COMP *cpi) {
   else
     cpi->row_mt_bit_exact = 0;
 }
+
+void vp9_accumulate_stage_counts(VP9_COMP *cpi, const ThreadData *td,
+                                 int thread, uint64_t ticks) {
+  vp9e_stage_stats_t *const stats = &cpi->frame_stage_stats;
+  const EncStageCounts *const counts = &td->stage_counts;
+  const uint64_t inner = counts->ticks[VP9E_STAGE_MODE_DECISION] +
+                         counts->ticks[VP9E_STAGE_QUANTIZE];
+  int i;
+
+  for (i = 0; i < VP9E_ENCODER_STAGES; ++i)
+    stats->stage_ticks[i] += counts->ticks[i];
+  // Whatever the superblock loop spent outside mode decision and encoding is
+  // the partition search around them.
+  if (counts->sb_ticks > inner)
+    stats->stage_ticks[VP9E_STAGE_PARTITION_SEARCH] +=
+        counts->sb_ticks - inner;
+
+  if (thread < VP9E_STAGE_STATS_MAX_THREADS) {
+    stats->thread_busy_ticks[thread] += counts->sb_ticks;
+    if (ticks > counts->sb_ticks)
+      stats->thread_idle_ticks[thread] += ticks - counts->sb_ticks;
+    stats->num_threads = VPXMAX(stats->num_threads, thread + 1);
+  }
+}
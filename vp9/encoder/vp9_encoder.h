@@ -21,6 +21,7 @@
 #endif
 #include "vpx_dsp/variance.h"
 #include "vpx_ports/system_state.h"
+#include "vpx_ports/vpx_timer.h"
 #include "vpx_util/vpx_thread.h"
 
 #include "vp9/common/vp9_alloccommon.h"
@@ -278,6 +279,13 @@ typedef struct VP9EncoderConfig {
 
   int row_mt;
   unsigned int motion_vector_unit_test;
+  // Filter the reconstruction on a separate thread, overlapping with the
+  // bitstream packing and whatever runs before the next encode call.
+  int loopfilter_pipeline;
+  // The inactive blocks of the active map are unchanged in the source.
+  int inactive_unchanged;
+  // Pick the loop filter level from sampled superblock rows.
+  int sampled_lpf_pick;
 } VP9EncoderConfig;
 
 static INLINE int is_lossless_requested(const VP9EncoderConfig *cfg) {
@@ -388,10 +396,18 @@ typedef struct RD_COUNTS {
   int64_t filter_diff[SWITCHABLE_FILTER_CONTEXTS];
 } RD_COUNTS;
 
+// Time spent by one thread encoding tiles, see VP9E_SET_FRAME_STAGE_STATS.
+// Only the stages run inside superblocks are counted here.
+typedef struct EncStageCounts {
+  uint64_t ticks[VP9E_ENCODER_STAGES];
+  uint64_t sb_ticks;  // Superblock encoding, including the stages inside it.
+} EncStageCounts;
+
 typedef struct ThreadData {
   MACROBLOCK mb;
   RD_COUNTS rd_counts;
   FRAME_COUNTS *counts;
+  EncStageCounts stage_counts;
 
   PICK_MODE_CONTEXT *leaf_tree;
   PC_TREE *pc_tree;
@@ -504,14 +520,42 @@ typedef struct {
   double max_cpb_size;  // in bits
 } LevelConstraint;
 
+// Motion search result of a temporal filter block in one of the frames.
+typedef struct ARNRBlockSearch {
+  MV ref_mv;
+  MV blk_mvs[4];
+  int blk_fw[4];
+  int use_32x32;
+} ARNRBlockSearch;
+
 typedef struct ARNRFilterData {
   YV12_BUFFER_CONFIG *frames[MAX_LAG_BUFFERS];
   int strength;
   int frame_count;
   int alt_ref_index;
   struct scale_factors sf;
+  // Search results of every block in every frame, when the searches are run
+  // ahead of the filtering. The filter searches as it goes otherwise.
+  ARNRBlockSearch *block_search;
+  int block_search_size;
+  int use_block_search;
 } ARNRFilterData;
 
+typedef struct GF_PICTURE {
+  YV12_BUFFER_CONFIG *frame;
+  int ref_frame[3];
+  FRAME_UPDATE_TYPE update_type;
+} GF_PICTURE;
+
+// Per frame state shared by the mc_flow_dispenser row jobs.
+typedef struct TplDispenserData {
+  GF_PICTURE *gf_picture;
+  YV12_BUFFER_CONFIG *ref_frame[3];
+  int frame_idx;
+  BLOCK_SIZE bsize;
+  struct scale_factors sf;
+} TplDispenserData;
+
 typedef struct EncFrameBuf {
   int mem_valid;
   int released;
@@ -547,6 +591,9 @@ typedef struct VP9_COMP {
   VP9EncoderConfig oxcf;
   struct lookahead_ctx *lookahead;
   struct lookahead_entry *alt_ref_source;
+  // Returns the source frames passed to vp9_receive_lent_frame().
+  vp9_release_lent_frame_fn_t release_lent_frame;
+  void *release_lent_priv;
 
   YV12_BUFFER_CONFIG *Source;
   YV12_BUFFER_CONFIG *Last_Source;  // NULL for first frame and alt_ref frames
@@ -564,7 +611,9 @@ typedef struct VP9_COMP {
   TplDepFrame tpl_stats[MAX_ARF_GOP_SIZE];
   YV12_BUFFER_CONFIG *tpl_recon_frames[REF_FRAMES];
   EncFrameBuf enc_frame_buf[REF_FRAMES];
+  TplDispenserData tpl_dispenser_data;
 #if CONFIG_MULTITHREAD
+  pthread_mutex_t tpl_mutex;
   pthread_mutex_t kmeans_mutex;
 #endif
   int kmeans_data_arr_alloc;
@@ -757,6 +806,8 @@ typedef struct VP9_COMP {
   int frame_flags;
 
   search_site_config ss_cfg;
+  // Search sites for the stride of the last source frame read in place.
+  search_site_config lent_ss_cfg;
 
   int mbmode_cost[INTRA_MODES];
   unsigned int inter_mode_cost[INTER_MODE_CONTEXTS][INTER_MODES];
@@ -804,6 +855,8 @@ typedef struct VP9_COMP {
   VPxWorker *workers;
   struct EncWorkerData *tile_thr_data;
   VP9LfSync lf_row_sync;
+  // Loop filters the last frame when oxcf.loopfilter_pipeline is set.
+  VPxWorker lf_pipeline_worker;
   struct VP9BitstreamWorkerData *vp9_bitstream_worker_data;
 
   int keep_level_stats;
@@ -843,6 +896,12 @@ typedef struct VP9_COMP {
 
   int multi_layer_arf;
   vpx_roi_map_t roi;
+
+  // Stage timing, see VP9E_SET_FRAME_STAGE_STATS. frame_stage_stats collects
+  // the frame being encoded and is copied to last_stage_stats once it is done.
+  int stage_stats;
+  vp9e_stage_stats_t frame_stage_stats;
+  vp9e_stage_stats_t last_stage_stats;
 } VP9_COMP;
 
 void vp9_initialize_enc(void);
@@ -859,6 +918,16 @@ int vp9_receive_raw_frame(VP9_COMP *cpi, vpx_enc_frame_flags_t frame_flags,
                           YV12_BUFFER_CONFIG *sd, int64_t time_stamp,
                           int64_t end_time);
 
+// Like vp9_receive_raw_frame(), but the frame may be read in place instead of
+// copied when its planes are allocated padded_width x padded_height or larger
+// from their first pixel on, with border pixels allocated above and left of
+// it. lent_frame is passed to cpi->release_lent_frame once the encoder is done
+// with the frame, which is right away if it was copied.
+int vp9_receive_lent_frame(VP9_COMP *cpi, vpx_enc_frame_flags_t frame_flags,
+                           YV12_BUFFER_CONFIG *sd, int padded_width,
+                           int padded_height, int border, int64_t time_stamp,
+                           int64_t end_time, const void *lent_frame);
+
 int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
                             size_t *size, uint8_t *dest, int64_t *time_stamp,
                             int64_t *time_end, int flush);
@@ -866,6 +935,11 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
 int vp9_get_preview_raw_frame(VP9_COMP *cpi, YV12_BUFFER_CONFIG *dest,
                               vp9_ppflags_t *flags);
 
+// Waits for the loop filter of the previous frame if it was pipelined. This
+// must be called before the reconstruction, the loop filter masks or the frame
+// size can be read or changed.
+void vp9_sync_loopfilter_pipeline(VP9_COMP *cpi);
+
 int vp9_use_as_reference(VP9_COMP *cpi, int ref_frame_flags);
 
 void vp9_update_reference(VP9_COMP *cpi, int ref_frame_flags);
@@ -1000,7 +1074,7 @@ YV12_BUFFER_CONFIG *vp9_svc_twostage_scale(
     int phase_scaler, INTERP_FILTER filter_type2, int phase_scaler2);
 
 YV12_BUFFER_CONFIG *vp9_scale_if_required(
-    VP9_COMMON *cm, YV12_BUFFER_CONFIG *unscaled, YV12_BUFFER_CONFIG *scaled,
+    VP9_COMP *cpi, YV12_BUFFER_CONFIG *unscaled, YV12_BUFFER_CONFIG *scaled,
     int use_normative_scaler, INTERP_FILTER filter_type, int phase_scaler);
 
 void vp9_apply_encoding_flags(VP9_COMP *cpi, vpx_enc_frame_flags_t flags);
@@ -1052,6 +1126,45 @@ static INLINE int get_num_cols(TileInfo tile, int shift) {
   return num_cols;
 }
 
+// Stage timing costs a test of 'stage' when it is disabled.
+static INLINE uint64_t stage_start(const EncStageCounts *stage) {
+  return stage != NULL ? vpx_timer_ticks() : 0;
+}
+
+// Charges the time since 'start' to 'type' and returns the current time.
+static INLINE uint64_t stage_mark(EncStageCounts *stage, int type,
+                                  uint64_t start) {
+  if (stage != NULL) {
+    const uint64_t now = vpx_timer_ticks();
+    stage->ticks[type] += now - start;
+    return now;
+  }
+  return 0;
+}
+
+// Points the stage timing of 'td' at its own counters before it encodes tiles.
+static INLINE void reset_stage_counts(const struct VP9_COMP *cpi,
+                                      ThreadData *td) {
+  td->mb.stage = cpi->stage_stats ? &td->stage_counts : NULL;
+  if (td->mb.stage != NULL) memset(td->mb.stage, 0, sizeof(*td->mb.stage));
+}
+
+// The same for the stages run once per frame by the calling thread.
+static INLINE uint64_t frame_stage_start(const struct VP9_COMP *cpi) {
+  return cpi->stage_stats ? vpx_timer_ticks() : 0;
+}
+
+static INLINE void frame_stage_mark(struct VP9_COMP *cpi, int type,
+                                    uint64_t start) {
+  if (cpi->stage_stats)
+    cpi->frame_stage_stats.stage_ticks[type] += vpx_timer_ticks() - start;
+}
+
+// Adds the counters 'td' collected while tile encoding took 'ticks' to thread
+// 'thread' of the frame stage stats.
+void vp9_accumulate_stage_counts(struct VP9_COMP *cpi, const ThreadData *td,
+                                 int thread, uint64_t ticks);
+
 static INLINE int get_level_index(VP9_LEVEL level) {
   int i;
   for (i = 0; i < VP9_LEVELS; ++i) {
@@ -1086,6 +1199,12 @@ void vp9_new_framerate(VP9_COMP *cpi, double framerate);
 
 void vp9_set_row_mt(VP9_COMP *cpi);
 
+// Builds the TPL stats of the mi_row block row between mi_col_start and
+// mi_col_end for the frame described by cpi->tpl_dispenser_data, and
+// propagates them into the stats of its reference frames.
+void vp9_mc_flow_dispenser_row(VP9_COMP *cpi, ThreadData *td, int mi_row,
+                               int mi_col_start, int mi_col_end);
+
 #define LAYER_IDS_TO_IDX(sl, tl, num_tl) ((sl) * (num_tl) + (tl))
 
 #ifdef __cplusplus
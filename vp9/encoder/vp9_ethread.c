@@ -13,6 +13,7 @@
 #include "vp9/encoder/vp9_ethread.h"
 #include "vp9/encoder/vp9_firstpass.h"
 #include "vp9/encoder/vp9_multi_thread.h"
+#include "vp9/encoder/vp9_resize.h"
 #include "vp9/encoder/vp9_temporal_filter.h"
 #include "vpx_dsp/vpx_dsp_common.h"
 
@@ -174,6 +175,7 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
   const int tile_cols = 1 << cm->log2_tile_cols;
   const int num_workers = VPXMIN(cpi->oxcf.max_threads, tile_cols);
   int i;
+  uint64_t start, ticks = 0;
 
   vp9_init_tile_data(cpi);
 
@@ -192,6 +194,7 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
       memcpy(thread_data->td->counts, &cpi->common.counts,
              sizeof(cpi->common.counts));
     }
+    reset_stage_counts(cpi, thread_data->td);
 
     // Handle use_nonrd_pick_mode case.
     if (cpi->sf.use_nonrd_pick_mode) {
@@ -211,7 +214,9 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
     }
   }
 
+  start = frame_stage_start(cpi);
   launch_enc_workers(cpi, enc_worker_hook, NULL, num_workers);
+  if (cpi->stage_stats) ticks = vpx_timer_ticks() - start;
 
   for (i = 0; i < num_workers; i++) {
     VPxWorker *const worker = &cpi->workers[i];
@@ -222,6 +227,8 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
       vp9_accumulate_frame_counts(&cm->counts, thread_data->td->counts, 0);
       accumulate_rd_opt(&cpi->td, thread_data->td);
     }
+    if (cpi->stage_stats)
+      vp9_accumulate_stage_counts(cpi, thread_data->td, i, ticks);
   }
 }
 
@@ -521,11 +528,38 @@ static int temporal_filter_worker_hook(void *arg1, void *arg2) {
   return 0;
 }
 
+static int temporal_filter_search_worker_hook(void *arg1, void *unused) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  VP9_COMP *const cpi = thread_data->cpi;
+  const ARNRFilterData *const arnr_filter_data = &cpi->arnr_filter_data;
+  const int alt_ref_index = arnr_filter_data->alt_ref_index;
+  const int search_frames = arnr_filter_data->frame_count - 1;
+  const YV12_BUFFER_CONFIG *const f = arnr_filter_data->frames[alt_ref_index];
+  const int mb_rows = (f->y_crop_height + BH - 1) >> BH_LOG2;
+  int job;
+
+  (void)unused;
+
+  // Go through the frames within each row, so the searches of a row in the
+  // different frames run concurrently.
+  for (job = thread_data->start; job < mb_rows * search_frames;
+       job += cpi->num_workers) {
+    const int mb_row = job / search_frames;
+    int frame = job % search_frames;
+
+    if (frame >= alt_ref_index) ++frame;
+    if (arnr_filter_data->frames[frame] != NULL)
+      vp9_temporal_filter_search_row(cpi, thread_data->td, frame, mb_row);
+  }
+  return 0;
+}
+
 void vp9_temporal_filter_row_mt(VP9_COMP *cpi) {
   VP9_COMMON *const cm = &cpi->common;
   const int tile_cols = 1 << cm->log2_tile_cols;
   const int tile_rows = 1 << cm->log2_tile_rows;
   MultiThreadHandle *multi_thread_ctxt = &cpi->multi_thread_ctxt;
+  ARNRFilterData *const arnr_filter_data = &cpi->arnr_filter_data;
   int num_workers = cpi->num_workers ? cpi->num_workers : 1;
   int i;
 
@@ -541,24 +575,155 @@ void vp9_temporal_filter_row_mt(VP9_COMP *cpi) {
 
   create_enc_workers(cpi, num_workers);
 
+  for (i = 0; i < num_workers; i++) {
+    EncWorkerData *thread_data;
+    thread_data = &cpi->tile_thr_data[i];
+
+    // Before encoding a frame, copy the thread data from cpi.
+    if (thread_data->td != &cpi->td) {
+      thread_data->td->mb = cpi->td.mb;
+    }
+  }
+
+  // With several workers, run the motion searches of all the frames first,
+  // spread over rows and frames, and then filter the rows from their results.
+  arnr_filter_data->use_block_search =
+      num_workers > 1 && arnr_filter_data->frame_count > 1;
+  if (arnr_filter_data->use_block_search) {
+    const YV12_BUFFER_CONFIG *const f =
+        arnr_filter_data->frames[arnr_filter_data->alt_ref_index];
+    const int mb_cols = (f->y_crop_width + BW - 1) >> BW_LOG2;
+    const int mb_rows = (f->y_crop_height + BH - 1) >> BH_LOG2;
+    const int num_blocks = arnr_filter_data->frame_count * mb_rows * mb_cols;
+
+    if (arnr_filter_data->block_search_size < num_blocks) {
+      vpx_free(arnr_filter_data->block_search);
+      arnr_filter_data->block_search_size = 0;
+      CHECK_MEM_ERROR(cm, arnr_filter_data->block_search,
+                      vpx_malloc(num_blocks *
+                                 sizeof(*arnr_filter_data->block_search)));
+      arnr_filter_data->block_search_size = num_blocks;
+    }
+
+    launch_enc_workers(cpi, temporal_filter_search_worker_hook, NULL,
+                       num_workers);
+  }
+
   vp9_assign_tile_to_thread(multi_thread_ctxt, tile_cols, cpi->num_workers);
 
   vp9_prepare_job_queue(cpi, ARNR_JOB);
 
+  launch_enc_workers(cpi, temporal_filter_worker_hook, multi_thread_ctxt,
+                     num_workers);
+}
+#endif  // !CONFIG_REALTIME_ONLY
+
+static int mc_flow_dispenser_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  MultiThreadHandle *multi_thread_ctxt = (MultiThreadHandle *)arg2;
+  VP9_COMP *const cpi = thread_data->cpi;
+  const VP9_COMMON *const cm = &cpi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int mi_height =
+      num_8x8_blocks_high_lookup[cpi->tpl_dispenser_data.bsize];
+  int tile_row, tile_col;
+  TileDataEnc *this_tile;
+  int end_of_frame;
+  int thread_id = thread_data->thread_id;
+  int cur_tile_id = multi_thread_ctxt->thread_id_to_tile_id[thread_id];
+  JobNode *proc_job = NULL;
+  int mi_row;
+
+  end_of_frame = 0;
+  while (0 == end_of_frame) {
+    // Get the next job in the queue
+    proc_job =
+        (JobNode *)vp9_enc_grp_get_next_job(multi_thread_ctxt, cur_tile_id);
+    if (NULL == proc_job) {
+      // Query for the status of other tiles
+      end_of_frame = vp9_get_tiles_proc_status(
+          multi_thread_ctxt, thread_data->tile_completion_status, &cur_tile_id,
+          tile_cols);
+    } else {
+      tile_col = proc_job->tile_col_id;
+      tile_row = proc_job->tile_row_id;
+      this_tile = &cpi->tile_data[tile_row * tile_cols + tile_col];
+      mi_row = proc_job->vert_unit_row_num * mi_height;
+
+      vp9_mc_flow_dispenser_row(cpi, thread_data->td, mi_row,
+                                this_tile->tile_info.mi_col_start,
+                                this_tile->tile_info.mi_col_end);
+    }
+  }
+  return 0;
+}
+
+void vp9_mc_flow_dispenser_row_mt(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  MultiThreadHandle *multi_thread_ctxt = &cpi->multi_thread_ctxt;
+  int num_workers = VPXMAX(cpi->oxcf.max_threads, 1);
+  int i;
+
+  if (multi_thread_ctxt->allocated_tile_cols < tile_cols ||
+      multi_thread_ctxt->allocated_tile_rows < tile_rows ||
+      multi_thread_ctxt->allocated_vert_unit_rows < cm->mb_rows) {
+    vp9_row_mt_mem_dealloc(cpi);
+    vp9_init_tile_data(cpi);
+    vp9_row_mt_mem_alloc(cpi);
+  } else {
+    vp9_init_tile_data(cpi);
+  }
+
+  create_enc_workers(cpi, num_workers);
+
+  vp9_assign_tile_to_thread(multi_thread_ctxt, tile_cols, cpi->num_workers);
+
+  vp9_prepare_job_queue(cpi, TPL_JOB);
+
   for (i = 0; i < num_workers; i++) {
     EncWorkerData *thread_data;
     thread_data = &cpi->tile_thr_data[i];
 
-    // Before encoding a frame, copy the thread data from cpi.
+    // Before building the stats of a frame, copy the thread data from cpi.
     if (thread_data->td != &cpi->td) {
       thread_data->td->mb = cpi->td.mb;
     }
   }
 
-  launch_enc_workers(cpi, temporal_filter_worker_hook, multi_thread_ctxt,
+  launch_enc_workers(cpi, mc_flow_dispenser_worker_hook, multi_thread_ctxt,
                      num_workers);
 }
-#endif  // !CONFIG_REALTIME_ONLY
+
+static int resize_rows_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  const ResizePlaneJob *const jobs = (const ResizePlaneJob *)arg2;
+  int plane;
+
+  for (plane = 0; plane < MAX_MB_PLANE; ++plane)
+    vp9_resize_plane_rows(&jobs[plane], thread_data->start,
+                          thread_data->cpi->num_workers);
+  return 0;
+}
+
+static int resize_cols_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  const ResizePlaneJob *const jobs = (const ResizePlaneJob *)arg2;
+  int plane;
+
+  for (plane = 0; plane < MAX_MB_PLANE; ++plane)
+    vp9_resize_plane_cols(&jobs[plane], thread_data->start,
+                          thread_data->cpi->num_workers);
+  return 0;
+}
+
+void vp9_resize_planes_mt(VP9_COMP *cpi, ResizePlaneJob *jobs) {
+  // Every worker takes its share of the row stripes of all the planes, and
+  // once those are done its share of the column blocks.
+  launch_enc_workers(cpi, resize_rows_worker_hook, jobs, cpi->num_workers);
+  launch_enc_workers(cpi, resize_cols_worker_hook, jobs, cpi->num_workers);
+}
 
 static int enc_row_mt_worker_hook(void *arg1, void *arg2) {
   EncWorkerData *const thread_data = (EncWorkerData *)arg1;
@@ -601,6 +766,7 @@ void vp9_encode_tiles_row_mt(VP9_COMP *cpi) {
   MultiThreadHandle *multi_thread_ctxt = &cpi->multi_thread_ctxt;
   int num_workers = VPXMAX(cpi->oxcf.max_threads, 1);
   int i;
+  uint64_t start, ticks = 0;
 
   if (multi_thread_ctxt->allocated_tile_cols < tile_cols ||
       multi_thread_ctxt->allocated_tile_rows < tile_rows ||
@@ -632,6 +798,7 @@ void vp9_encode_tiles_row_mt(VP9_COMP *cpi) {
       memcpy(thread_data->td->counts, &cpi->common.counts,
              sizeof(cpi->common.counts));
     }
+    reset_stage_counts(cpi, thread_data->td);
 
     // Handle use_nonrd_pick_mode case.
     if (cpi->sf.use_nonrd_pick_mode) {
@@ -651,8 +818,10 @@ void vp9_encode_tiles_row_mt(VP9_COMP *cpi) {
     }
   }
 
+  start = frame_stage_start(cpi);
   launch_enc_workers(cpi, enc_row_mt_worker_hook, multi_thread_ctxt,
                      num_workers);
+  if (cpi->stage_stats) ticks = vpx_timer_ticks() - start;
 
   for (i = 0; i < num_workers; i++) {
     VPxWorker *const worker = &cpi->workers[i];
@@ -663,5 +832,7 @@ void vp9_encode_tiles_row_mt(VP9_COMP *cpi) {
       vp9_accumulate_frame_counts(&cm->counts, thread_data->td->counts, 0);
       accumulate_rd_opt(&cpi->td, thread_data->td);
     }
+    if (cpi->stage_stats)
+      vp9_accumulate_stage_counts(cpi, thread_data->td, i, ticks);
   }
 }
@@ -21,6 +21,7 @@ extern "C" {
 
 struct VP9_COMP;
 struct ThreadData;
+struct ResizePlaneJob;
 
 typedef struct EncWorkerData {
   struct VP9_COMP *cpi;
@@ -65,6 +66,11 @@ void vp9_row_mt_sync_mem_dealloc(VP9RowMTSync *row_mt_sync);
 
 void vp9_temporal_filter_row_mt(struct VP9_COMP *cpi);
 
+void vp9_mc_flow_dispenser_row_mt(struct VP9_COMP *cpi);
+
+// Resize the MAX_MB_PLANE planes of jobs with the encoder's workers.
+void vp9_resize_planes_mt(struct VP9_COMP *cpi, struct ResizePlaneJob *jobs);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -109,13 +109,12 @@ void vp9_copy_and_extend_frame(const YV12_BUFFER_CONFIG *src,
   const int el_y = 16;
   // Motion estimation may use src block variance with the block size up
   // to 64x64, so the right and bottom need to be extended to 64 multiple
-  // or up to 16, whichever is greater.
+  // or up to 16, whichever is greater. The temporal dependency model reads
+  // further on frames held for lookahead.
   const int er_y =
-      VPXMAX(src->y_width + 16, ALIGN_POWER_OF_TWO(src->y_width, 6)) -
-      src->y_crop_width;
+      vp9_get_lookahead_extend_size(src->y_width) - src->y_crop_width;
   const int eb_y =
-      VPXMAX(src->y_height + 16, ALIGN_POWER_OF_TWO(src->y_height, 6)) -
-      src->y_crop_height;
+      vp9_get_lookahead_extend_size(src->y_height) - src->y_crop_height;
   const int uv_width_subsampling = (src->uv_width != src->y_width);
   const int uv_height_subsampling = (src->uv_height != src->y_height);
   const int et_uv = et_y >> uv_height_subsampling;
@@ -156,30 +155,59 @@ void vp9_copy_and_extend_frame(const YV12_BUFFER_CONFIG *src,
 void vp9_copy_and_extend_frame_with_rect(const YV12_BUFFER_CONFIG *src,
                                          YV12_BUFFER_CONFIG *dst, int srcy,
                                          int srcx, int srch, int srcw) {
-  // If the side is not touching the bounder then don't extend.
-  const int et_y = srcy ? 0 : dst->border;
-  const int el_y = srcx ? 0 : dst->border;
-  const int eb_y = srcy + srch != src->y_height
+  // Extend the sides of the rectangle that are on the frame edges as far as
+  // vp9_copy_and_extend_frame() does.
+  const int ss_x = src->subsampling_x;
+  const int ss_y = src->subsampling_y;
+  const int y_end = VPXMIN(srcy + srch, src->y_crop_height);
+  const int x_end = VPXMIN(srcx + srcw, src->y_crop_width);
+  const int et_y = srcy ? 0 : 16;
+  const int el_y = srcx ? 0 : 16;
+  const int eb_y = y_end != src->y_crop_height
                        ? 0
-                       : dst->border + dst->y_height - src->y_height;
-  const int er_y = srcx + srcw != src->y_width
+                       : vp9_get_lookahead_extend_size(src->y_height) - y_end;
+  const int er_y = x_end != src->y_crop_width
                        ? 0
-                       : dst->border + dst->y_width - src->y_width;
+                       : vp9_get_lookahead_extend_size(src->y_width) - x_end;
   const int src_y_offset = srcy * src->y_stride + srcx;
   const int dst_y_offset = srcy * dst->y_stride + srcx;
 
-  const int et_uv = ROUND_POWER_OF_TWO(et_y, 1);
-  const int el_uv = ROUND_POWER_OF_TWO(el_y, 1);
-  const int eb_uv = ROUND_POWER_OF_TWO(eb_y, 1);
-  const int er_uv = ROUND_POWER_OF_TWO(er_y, 1);
-  const int src_uv_offset = ((srcy * src->uv_stride) >> 1) + (srcx >> 1);
-  const int dst_uv_offset = ((srcy * dst->uv_stride) >> 1) + (srcx >> 1);
-  const int srch_uv = ROUND_POWER_OF_TWO(srch, 1);
-  const int srcw_uv = ROUND_POWER_OF_TWO(srcw, 1);
+  const int et_uv = et_y >> ss_y;
+  const int el_uv = el_y >> ss_x;
+  const int eb_uv = eb_y >> ss_y;
+  const int er_uv = er_y >> ss_x;
+  const int srcy_uv = srcy >> ss_y;
+  const int srcx_uv = srcx >> ss_x;
+  const int srch_uv = ((y_end + ss_y) >> ss_y) - srcy_uv;
+  const int srcw_uv = ((x_end + ss_x) >> ss_x) - srcx_uv;
+  const int src_uv_offset = srcy_uv * src->uv_stride + srcx_uv;
+  const int dst_uv_offset = srcy_uv * dst->uv_stride + srcx_uv;
+
+  if (x_end <= srcx || y_end <= srcy) return;
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
+    highbd_copy_and_extend_plane(
+        src->y_buffer + src_y_offset, src->y_stride,
+        dst->y_buffer + dst_y_offset, dst->y_stride, x_end - srcx,
+        y_end - srcy, et_y, el_y, eb_y, er_y);
+
+    highbd_copy_and_extend_plane(
+        src->u_buffer + src_uv_offset, src->uv_stride,
+        dst->u_buffer + dst_uv_offset, dst->uv_stride, srcw_uv, srch_uv,
+        et_uv, el_uv, eb_uv, er_uv);
+
+    highbd_copy_and_extend_plane(
+        src->v_buffer + src_uv_offset, src->uv_stride,
+        dst->v_buffer + dst_uv_offset, dst->uv_stride, srcw_uv, srch_uv,
+        et_uv, el_uv, eb_uv, er_uv);
+    return;
+  }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
 
   copy_and_extend_plane(src->y_buffer + src_y_offset, src->y_stride,
-                        dst->y_buffer + dst_y_offset, dst->y_stride, srcw, srch,
-                        et_y, el_y, eb_y, er_y);
+                        dst->y_buffer + dst_y_offset, dst->y_stride,
+                        x_end - srcx, y_end - srcy, et_y, el_y, eb_y, er_y);
 
   copy_and_extend_plane(src->u_buffer + src_uv_offset, src->uv_stride,
                         dst->u_buffer + dst_uv_offset, dst->uv_stride, srcw_uv,
@@ -189,3 +217,93 @@ void vp9_copy_and_extend_frame_with_rect(const YV12_BUFFER_CONFIG *src,
                         dst->v_buffer + dst_uv_offset, dst->uv_stride, srcw_uv,
                         srch_uv, et_uv, el_uv, eb_uv, er_uv);
 }
+
+static void extend_plane_in_place(uint8_t *buf, int stride, int w, int h,
+                                  int extend_top, int extend_left,
+                                  int extend_bottom, int extend_right) {
+  const uint8_t *const first_row = buf - extend_left;
+  const uint8_t *const last_row = first_row + (h - 1) * stride;
+  const int linesize = extend_left + w + extend_right;
+  uint8_t *row = buf;
+  int i;
+
+  for (i = 0; i < h; i++) {
+    memset(row - extend_left, row[0], extend_left);
+    memset(row + w, row[w - 1], extend_right);
+    row += stride;
+  }
+
+  row = buf - extend_left;
+  for (i = 1; i <= extend_top; i++)
+    memcpy(row - i * stride, first_row, linesize);
+  for (i = 0; i < extend_bottom; i++)
+    memcpy(row + (h + i) * stride, last_row, linesize);
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+static void highbd_extend_plane_in_place(uint8_t *buf8, int stride, int w,
+                                         int h, int extend_top,
+                                         int extend_left, int extend_bottom,
+                                         int extend_right) {
+  uint16_t *const buf = CONVERT_TO_SHORTPTR(buf8);
+  const uint16_t *const first_row = buf - extend_left;
+  const uint16_t *const last_row = first_row + (h - 1) * stride;
+  const int linesize = extend_left + w + extend_right;
+  uint16_t *row = buf;
+  int i;
+
+  for (i = 0; i < h; i++) {
+    vpx_memset16(row - extend_left, row[0], extend_left);
+    vpx_memset16(row + w, row[w - 1], extend_right);
+    row += stride;
+  }
+
+  row = buf - extend_left;
+  for (i = 1; i <= extend_top; i++)
+    memcpy(row - i * stride, first_row, linesize * sizeof(row[0]));
+  for (i = 0; i < extend_bottom; i++)
+    memcpy(row + (h + i) * stride, last_row, linesize * sizeof(row[0]));
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+void vp9_extend_frame_in_place(YV12_BUFFER_CONFIG *ybf, int full_border) {
+  // The same extents as vp9_copy_and_extend_frame() with full_border. Only
+  // alt-ref filtering and the temporal dependency model read above and left
+  // of the frame or that far right and down.
+  const int et_y = full_border ? 16 : 0;
+  const int el_y = et_y;
+  const int extend_width =
+      full_border ? vp9_get_lookahead_extend_size(ybf->y_crop_width)
+                  : vp9_get_src_extend_size(ybf->y_crop_width);
+  const int extend_height =
+      full_border ? vp9_get_lookahead_extend_size(ybf->y_crop_height)
+                  : vp9_get_src_extend_size(ybf->y_crop_height);
+  const int er_y = extend_width - ybf->y_crop_width;
+  const int eb_y = extend_height - ybf->y_crop_height;
+  const int et_uv = et_y >> ybf->subsampling_y;
+  const int el_uv = el_y >> ybf->subsampling_x;
+  const int er_uv = er_y >> ybf->subsampling_x;
+  const int eb_uv = eb_y >> ybf->subsampling_y;
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (ybf->flags & YV12_FLAG_HIGHBITDEPTH) {
+    highbd_extend_plane_in_place(ybf->y_buffer, ybf->y_stride,
+                                 ybf->y_crop_width, ybf->y_crop_height, et_y,
+                                 el_y, eb_y, er_y);
+    highbd_extend_plane_in_place(ybf->u_buffer, ybf->uv_stride,
+                                 ybf->uv_crop_width, ybf->uv_crop_height,
+                                 et_uv, el_uv, eb_uv, er_uv);
+    highbd_extend_plane_in_place(ybf->v_buffer, ybf->uv_stride,
+                                 ybf->uv_crop_width, ybf->uv_crop_height,
+                                 et_uv, el_uv, eb_uv, er_uv);
+    return;
+  }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+  extend_plane_in_place(ybf->y_buffer, ybf->y_stride, ybf->y_crop_width,
+                        ybf->y_crop_height, et_y, el_y, eb_y, er_y);
+  extend_plane_in_place(ybf->u_buffer, ybf->uv_stride, ybf->uv_crop_width,
+                        ybf->uv_crop_height, et_uv, el_uv, eb_uv, er_uv);
+  extend_plane_in_place(ybf->v_buffer, ybf->uv_stride, ybf->uv_crop_width,
+                        ybf->uv_crop_height, et_uv, el_uv, eb_uv, er_uv);
+}
@@ -11,6 +11,9 @@
 #ifndef VPX_VP9_ENCODER_VP9_EXTEND_H_
 #define VPX_VP9_ENCODER_VP9_EXTEND_H_
 
+#include "./vpx_config.h"
+#include "vpx_dsp/vpx_dsp_common.h"
+#include "vpx_ports/mem.h"
 #include "vpx_scale/yv12config.h"
 #include "vpx/vpx_integer.h"
 
@@ -21,9 +24,35 @@ extern "C" {
 void vp9_copy_and_extend_frame(const YV12_BUFFER_CONFIG *src,
                                YV12_BUFFER_CONFIG *dst);
 
+// Copies a rectangle, given in luma pixels and clipped to the frame, and
+// extends its sides that lie on the frame edges like vp9_copy_and_extend_frame.
 void vp9_copy_and_extend_frame_with_rect(const YV12_BUFFER_CONFIG *src,
                                          YV12_BUFFER_CONFIG *dst, int srcy,
                                          int srcx, int srch, int srcw);
+
+// Returns how far right or down a source frame of the given width or height is
+// read: block variances cover whole 64x64 blocks and up to 16 pixels past the
+// 8-aligned size are used otherwise.
+static INLINE int vp9_get_src_extend_size(int size) {
+  const int aligned_size = ALIGN_POWER_OF_TWO(size, 3);
+  return VPXMAX(aligned_size + 16, ALIGN_POWER_OF_TWO(aligned_size, 6));
+}
+
+// Returns how far right or down a source frame held for lookahead is read:
+// the temporal dependency model also reads 32x32 blocks displaced up to 16
+// pixels past the last 8x8 block.
+static INLINE int vp9_get_lookahead_extend_size(int size) {
+  return VPXMAX(vp9_get_src_extend_size(size),
+                ALIGN_POWER_OF_TWO(size, 3) + 32 + 16);
+}
+
+// Extends the edges of the frame in place, the right and bottom ones up to
+// vp9_get_src_extend_size() of the crop size. With full_border set, as for
+// frames held for lookahead, they go up to
+// vp9_get_lookahead_extend_size() and the top and left ones are extended by
+// 16 pixels too. The planes must be allocated that large.
+void vp9_extend_frame_in_place(YV12_BUFFER_CONFIG *ybf, int full_border);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
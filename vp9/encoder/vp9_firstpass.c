@@ -317,6 +317,17 @@ void vp9_end_first_pass(VP9_COMP *cpi) {
   cpi->twopass.fp_mb_float_stats = NULL;
 }
 
+void vp9_merge_first_pass_stats(FIRSTPASS_STATS *stats, int num_frames) {
+  FIRSTPASS_STATS *const total = &stats[num_frames];
+  int i;
+
+  zero_stats(total);
+  for (i = 0; i < num_frames; ++i) {
+    stats[i].frame = i;
+    accumulate_stats(total, &stats[i]);
+  }
+}
+
 static vpx_variance_fn_t get_block_variance_fn(BLOCK_SIZE bsize) {
   switch (bsize) {
     case BLOCK_8X8: return vpx_mse8x8;
@@ -1063,9 +1074,10 @@ void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
       // Compute the motion error of the 0,0 motion using the last source
       // frame as the reference. Skip the further motion search on
       // reconstructed frame if this error is very small.
-      unscaled_last_source_buf_2d.buf =
-          cpi->unscaled_last_source->y_buffer + recon_yoffset;
       unscaled_last_source_buf_2d.stride = cpi->unscaled_last_source->y_stride;
+      unscaled_last_source_buf_2d.buf =
+          cpi->unscaled_last_source->y_buffer +
+          mb_row * 16 * unscaled_last_source_buf_2d.stride + mb_col * 16;
 #if CONFIG_VP9_HIGHBITDEPTH
       if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
         raw_motion_error = highbd_get_prediction_error(
@@ -205,6 +205,11 @@ void vp9_init_first_pass(struct VP9_COMP *cpi);
 void vp9_first_pass(struct VP9_COMP *cpi, const struct lookahead_entry *source);
 void vp9_end_first_pass(struct VP9_COMP *cpi);
 
+// Turns the per frame stats of first passes run on consecutive parts of a
+// clip into the stats of a single first pass: stats[0..num_frames - 1] are
+// renumbered from 0 and stats[num_frames] receives their totals.
+void vp9_merge_first_pass_stats(FIRSTPASS_STATS *stats, int num_frames);
+
 void vp9_first_pass_encode_tile_mb_row(struct VP9_COMP *cpi,
                                        struct ThreadData *td,
                                        FIRSTPASS_DATA *fp_acc_data,
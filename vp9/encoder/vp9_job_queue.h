@@ -15,6 +15,7 @@ typedef enum {
   FIRST_PASS_JOB,
   ENCODE_JOB,
   ARNR_JOB,
+  TPL_JOB,
   NUM_JOB_TYPES,
 } JOB_TYPE;
 
@@ -9,6 +9,7 @@
  */
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "./vpx_config.h"
 
@@ -29,12 +30,26 @@ static struct lookahead_entry *pop(struct lookahead_ctx *ctx, int *idx) {
   return buf;
 }
 
+/* Give a lent frame back and restore the entry's own buffer */
+static void release_lent(struct lookahead_ctx *ctx,
+                         struct lookahead_entry *buf) {
+  if (buf->lent_frame != NULL) {
+    ctx->release_lent_frame(ctx->release_priv, buf->lent_frame);
+    buf->lent_frame = NULL;
+    buf->img = buf->own_img;
+  }
+}
+
 void vp9_lookahead_destroy(struct lookahead_ctx *ctx) {
   if (ctx) {
     if (ctx->buf) {
       int i;
 
-      for (i = 0; i < ctx->max_sz; i++) vpx_free_frame_buffer(&ctx->buf[i].img);
+      for (i = 0; i < ctx->max_sz; i++) {
+        release_lent(ctx, &ctx->buf[i]);
+        vpx_free_frame_buffer(&ctx->buf[i].img);
+        free(ctx->buf[i].dirty_map);
+      }
       free(ctx->buf);
     }
     free(ctx);
@@ -80,106 +95,210 @@ bail:
   return NULL;
 }
 
-#define USE_PARTIAL_COPY 0
+/* Fit the entry's own buffer to the dimensions of src */
+static int resize_img(YV12_BUFFER_CONFIG *img, const YV12_BUFFER_CONFIG *src,
+                      int use_highbitdepth) {
+  const int new_dimensions = src->y_crop_width != img->y_crop_width ||
+                             src->y_crop_height != img->y_crop_height ||
+                             src->uv_crop_width != img->uv_crop_width ||
+                             src->uv_crop_height != img->uv_crop_height;
+  const int larger_dimensions =
+      src->y_crop_width > img->y_width || src->y_crop_height > img->y_height ||
+      src->uv_crop_width > img->uv_width ||
+      src->uv_crop_height > img->uv_height;
+  assert(!larger_dimensions || new_dimensions);
+#if !CONFIG_VP9_HIGHBITDEPTH
+  (void)use_highbitdepth;
+#endif
 
-int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
-                       int64_t ts_start, int64_t ts_end,
+  if (larger_dimensions) {
+    YV12_BUFFER_CONFIG new_img;
+    memset(&new_img, 0, sizeof(new_img));
+    if (vpx_alloc_frame_buffer(&new_img, src->y_crop_width, src->y_crop_height,
+                               src->subsampling_x, src->subsampling_y,
 #if CONFIG_VP9_HIGHBITDEPTH
-                       int use_highbitdepth,
+                               use_highbitdepth,
 #endif
-                       vpx_enc_frame_flags_t flags) {
-  struct lookahead_entry *buf;
-#if USE_PARTIAL_COPY
-  int row, col, active_end;
-  int mb_rows = (src->y_height + 15) >> 4;
-  int mb_cols = (src->y_width + 15) >> 4;
-#endif
-  int width = src->y_crop_width;
-  int height = src->y_crop_height;
-  int uv_width = src->uv_crop_width;
-  int uv_height = src->uv_crop_height;
-  int subsampling_x = src->subsampling_x;
-  int subsampling_y = src->subsampling_y;
-  int larger_dimensions, new_dimensions;
-
-  if (ctx->sz + 1 + MAX_PRE_FRAMES > ctx->max_sz) return 1;
-  ctx->sz++;
-  buf = pop(ctx, &ctx->write_idx);
+                               VP9_ENC_BORDER_IN_PIXELS, 0))
+      return 1;
+    vpx_free_frame_buffer(img);
+    *img = new_img;
+  } else if (new_dimensions) {
+    img->y_crop_width = src->y_crop_width;
+    img->y_crop_height = src->y_crop_height;
+    img->uv_crop_width = src->uv_crop_width;
+    img->uv_crop_height = src->uv_crop_height;
+    img->subsampling_x = src->subsampling_x;
+    img->subsampling_y = src->subsampling_y;
+  }
+  return 0;
+}
 
-  new_dimensions = width != buf->img.y_crop_width ||
-                   height != buf->img.y_crop_height ||
-                   uv_width != buf->img.uv_crop_width ||
-                   uv_height != buf->img.uv_crop_height;
-  larger_dimensions = width > buf->img.y_width || height > buf->img.y_height ||
-                      uv_width > buf->img.uv_width ||
-                      uv_height > buf->img.uv_height;
-  assert(!larger_dimensions || new_dimensions);
+/* Size the entries' dirty maps for frames of rows x cols 8x8 blocks */
+static int alloc_dirty_maps(struct lookahead_ctx *ctx, int rows, int cols) {
+  int i;
 
-#if USE_PARTIAL_COPY
-  // TODO(jkoleszar): This is disabled for now, as
-  // vp9_copy_and_extend_frame_with_rect is not subsampling/alpha aware.
+  ctx->map_rows = 0;
+  ctx->map_cols = 0;
+  for (i = 0; i < ctx->max_sz; i++) {
+    struct lookahead_entry *const buf = &ctx->buf[i];
+    free(buf->dirty_map);
+    buf->dirty_map = calloc(rows * cols, 1);
+    buf->dirty_all = 1;
+    if (!buf->dirty_map) return 1;
+  }
+  ctx->map_rows = rows;
+  ctx->map_cols = cols;
+  return 0;
+}
 
-  // Only do this partial copy if the following conditions are all met:
-  // 1. Lookahead queue has has size of 1.
-  // 2. Active map is provided.
-  // 3. This is not a key frame, golden nor altref frame.
-  if (!new_dimensions && ctx->max_sz == 1 && active_map && !flags) {
-    for (row = 0; row < mb_rows; ++row) {
-      col = 0;
+/* Record in the other entries which blocks the enqueued frame changed */
+static void mark_dirty(struct lookahead_ctx *ctx,
+                       const struct lookahead_entry *buf,
+                       const unsigned char *static_map) {
+  const int num_blocks = ctx->map_rows * ctx->map_cols;
+  int i, j;
 
-      while (1) {
-        // Find the first active macroblock in this row.
-        for (; col < mb_cols; ++col) {
-          if (active_map[col]) break;
-        }
+  for (i = 0; i < ctx->max_sz; i++) {
+    struct lookahead_entry *const entry = &ctx->buf[i];
+    if (entry == buf) continue;
+    if (static_map == NULL) {
+      entry->dirty_all = 1;
+    } else if (!entry->dirty_all) {
+      for (j = 0; j < num_blocks; j++) entry->dirty_map[j] |= !static_map[j];
+    }
+  }
+}
 
-        // No more active macroblock in this row.
-        if (col == mb_cols) break;
+/* Copy the 8x8 blocks that changed since dst was written, a run at a time */
+static void copy_dirty_blocks(const YV12_BUFFER_CONFIG *src,
+                              YV12_BUFFER_CONFIG *dst,
+                              const unsigned char *static_map,
+                              const unsigned char *dirty_map, int rows,
+                              int cols) {
+  int row, col, run_end;
 
-        // Find the end of active region in this row.
-        active_end = col;
+  for (row = 0; row < rows; ++row) {
+    col = 0;
 
-        for (; active_end < mb_cols; ++active_end) {
-          if (!active_map[active_end]) break;
-        }
+    while (1) {
+      // Find the first changed block in this row.
+      for (; col < cols; ++col) {
+        if (!static_map[col] || dirty_map[col]) break;
+      }
 
-        // Only copy this active region.
-        vp9_copy_and_extend_frame_with_rect(src, &buf->img, row << 4, col << 4,
-                                            16, (active_end - col) << 4);
+      // No more changed blocks in this row.
+      if (col == cols) break;
 
-        // Start again from the end of this active region.
-        col = active_end;
+      // Find the end of the changed run in this row.
+      for (run_end = col; run_end < cols; ++run_end) {
+        if (static_map[run_end] && !dirty_map[run_end]) break;
       }
 
-      active_map += mb_cols;
+      vp9_copy_and_extend_frame_with_rect(src, dst, row << 3, col << 3, 8,
+                                          (run_end - col) << 3);
+
+      // Start again from the end of this run.
+      col = run_end;
     }
-  } else {
+
+    static_map += cols;
+    dirty_map += cols;
+  }
+}
+
+int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
+                       int64_t ts_start, int64_t ts_end,
+#if CONFIG_VP9_HIGHBITDEPTH
+                       int use_highbitdepth,
 #endif
-    if (larger_dimensions) {
-      YV12_BUFFER_CONFIG new_img;
-      memset(&new_img, 0, sizeof(new_img));
-      if (vpx_alloc_frame_buffer(&new_img, width, height, subsampling_x,
-                                 subsampling_y,
+                       vpx_enc_frame_flags_t flags,
+                       const unsigned char *static_map) {
+  struct lookahead_entry *buf;
+  const int map_rows = (src->y_crop_height + 7) >> 3;
+  const int map_cols = (src->y_crop_width + 7) >> 3;
+  int partial_copy;
+
+  if (ctx->sz + 1 + MAX_PRE_FRAMES > ctx->max_sz) return 1;
+  ctx->sz++;
+  buf = pop(ctx, &ctx->write_idx);
+  release_lent(ctx, buf);
+
+  if (static_map != NULL &&
+      (map_rows != ctx->map_rows || map_cols != ctx->map_cols) &&
+      alloc_dirty_maps(ctx, map_rows, map_cols))
+    static_map = NULL;
+
+  // Only copy the changed blocks if the framebuffer was written at this size
+  // and the blocks changed since are known. Key frames get a full copy.
+  partial_copy = static_map != NULL && !buf->dirty_all &&
+                 !(flags & VPX_EFLAG_FORCE_KF) &&
+                 buf->img.y_crop_width == src->y_crop_width &&
+                 buf->img.y_crop_height == src->y_crop_height;
+
+  if (partial_copy) {
+    copy_dirty_blocks(src, &buf->img, static_map, buf->dirty_map, map_rows,
+                      map_cols);
+  } else {
+    buf->dirty_all = 1;
 #if CONFIG_VP9_HIGHBITDEPTH
-                                 use_highbitdepth,
+    if (resize_img(&buf->img, src, use_highbitdepth)) return 1;
+#else
+    if (resize_img(&buf->img, src, 0)) return 1;
 #endif
-                                 VP9_ENC_BORDER_IN_PIXELS, 0))
-        return 1;
-      vpx_free_frame_buffer(&buf->img);
-      buf->img = new_img;
-    } else if (new_dimensions) {
-      buf->img.y_crop_width = src->y_crop_width;
-      buf->img.y_crop_height = src->y_crop_height;
-      buf->img.uv_crop_width = src->uv_crop_width;
-      buf->img.uv_crop_height = src->uv_crop_height;
-      buf->img.subsampling_x = src->subsampling_x;
-      buf->img.subsampling_y = src->subsampling_y;
-    }
-    // Partial copy not implemented yet
     vp9_copy_and_extend_frame(src, &buf->img);
-#if USE_PARTIAL_COPY
   }
-#endif
+  mark_dirty(ctx, buf, static_map);
+  if (buf->dirty_map != NULL)
+    memset(buf->dirty_map, 0, ctx->map_rows * ctx->map_cols);
+  buf->dirty_all = 0;
+
+  buf->ts_start = ts_start;
+  buf->ts_end = ts_end;
+  buf->flags = flags;
+  return 0;
+}
+
+int vp9_lookahead_lend(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
+                       int full_border, int64_t ts_start, int64_t ts_end,
+                       vpx_enc_frame_flags_t flags, const void *lent_frame) {
+  struct lookahead_entry *buf;
+  YV12_BUFFER_CONFIG *img;
+
+  if (ctx->sz + 1 + MAX_PRE_FRAMES > ctx->max_sz) return 1;
+  ctx->sz++;
+  buf = pop(ctx, &ctx->write_idx);
+  release_lent(ctx, buf);
+
+  // The entry's own buffer goes stale while the lent frame is used.
+  buf->dirty_all = 1;
+  mark_dirty(ctx, buf, NULL);
+
+  // Describe the lent planes like a frame buffer allocated for their size.
+  buf->own_img = buf->img;
+  buf->lent_frame = lent_frame;
+  img = &buf->img;
+  img->y_buffer = src->y_buffer;
+  img->u_buffer = src->u_buffer;
+  img->v_buffer = src->v_buffer;
+  img->y_stride = src->y_stride;
+  img->uv_stride = src->uv_stride;
+  img->y_crop_width = src->y_crop_width;
+  img->y_crop_height = src->y_crop_height;
+  img->y_width = ALIGN_POWER_OF_TWO(src->y_crop_width, 3);
+  img->y_height = ALIGN_POWER_OF_TWO(src->y_crop_height, 3);
+  img->uv_crop_width = src->uv_crop_width;
+  img->uv_crop_height = src->uv_crop_height;
+  img->uv_width = img->y_width >> src->subsampling_x;
+  img->uv_height = img->y_height >> src->subsampling_y;
+  img->subsampling_x = src->subsampling_x;
+  img->subsampling_y = src->subsampling_y;
+  img->buffer_alloc = NULL;
+  img->buffer_alloc_sz = 0;
+  img->frame_size = 0;
+  img->border = full_border ? 16 : 0;
+  img->flags = src->flags;
+  vp9_extend_frame_in_place(img, full_border);
 
   buf->ts_start = ts_start;
   buf->ts_end = ts_end;
@@ -187,6 +306,24 @@ int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
   return 0;
 }
 
+int vp9_lookahead_copy_lent(struct lookahead_ctx *ctx,
+                            struct lookahead_entry *entry) {
+  YV12_BUFFER_CONFIG lent;
+
+  if (entry->lent_frame == NULL) return 0;
+  lent = entry->img;
+  entry->img = entry->own_img;
+  if (resize_img(&entry->img, &lent,
+                 (lent.flags & YV12_FLAG_HIGHBITDEPTH) != 0)) {
+    entry->img = lent;
+    return 1;
+  }
+  vp9_copy_and_extend_frame(&lent, &entry->img);
+  entry->own_img = entry->img;
+  release_lent(ctx, entry);
+  return 0;
+}
+
 struct lookahead_entry *vp9_lookahead_pop(struct lookahead_ctx *ctx,
                                           int drain) {
   struct lookahead_entry *buf = NULL;
@@ -194,6 +331,13 @@ struct lookahead_entry *vp9_lookahead_pop(struct lookahead_ctx *ctx,
   if (ctx && ctx->sz && (drain || ctx->sz == ctx->max_sz - MAX_PRE_FRAMES)) {
     buf = pop(ctx, &ctx->read_idx);
     ctx->sz--;
+    // The previous frame is still read as the last source of this one, but
+    // the frame before it has left the window unless the ring is that small.
+    if (ctx->sz + MAX_PRE_FRAMES + 2 <= ctx->max_sz) {
+      int index = ctx->read_idx - (MAX_PRE_FRAMES + 2);
+      if (index < 0) index += ctx->max_sz;
+      release_lent(ctx, ctx->buf + index);
+    }
   }
   return buf;
 }
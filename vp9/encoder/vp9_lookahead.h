@@ -26,8 +26,20 @@ struct lookahead_entry {
   int64_t ts_start;
   int64_t ts_end;
   vpx_enc_frame_flags_t flags;
+  // The frame img points into when it was lent by the application, else NULL.
+  // The entry's own buffer is kept in own_img until the frame is released.
+  const void *lent_frame;
+  YV12_BUFFER_CONFIG own_img;
+  // The 8x8 blocks that changed since img was last written, or dirty_all when
+  // that is not known and the next push has to copy the whole frame.
+  unsigned char *dirty_map;
+  int dirty_all;
 };
 
+// Hands a frame enqueued with vp9_lookahead_lend() back to its owner.
+typedef void (*vp9_release_lent_frame_fn_t)(void *priv,
+                                            const void *lent_frame);
+
 // The max of past frames we want to keep in the queue.
 #define MAX_PRE_FRAMES 1
 
@@ -37,6 +49,10 @@ struct lookahead_ctx {
   int read_idx;                /* Read index */
   int write_idx;               /* Write index */
   struct lookahead_entry *buf; /* Buffer list */
+  vp9_release_lent_frame_fn_t release_lent_frame; /* Returns lent frames */
+  void *release_priv;
+  int map_rows; /* Size of the entries' dirty maps, in 8x8 blocks */
+  int map_cols;
 };
 
 /**\brief Initializes the lookahead stage
@@ -62,22 +78,56 @@ void vp9_lookahead_destroy(struct lookahead_ctx *ctx);
  * This function will copy the source image into a new framebuffer with
  * the expected stride/border.
  *
- * If active_map is non-NULL and there is only one frame in the queue, then copy
- * only active macroblocks.
+ * If static_map is non-NULL, its nonzero entries mark the 8x8 blocks of src
+ * that are unchanged from the previously enqueued frame. Only the blocks that
+ * changed since the reused framebuffer was written are then copied.
  *
  * \param[in] ctx         Pointer to the lookahead context
  * \param[in] src         Pointer to the image to enqueue
  * \param[in] ts_start    Timestamp for the start of this frame
  * \param[in] ts_end      Timestamp for the end of this frame
  * \param[in] flags       Flags set on this frame
- * \param[in] active_map  Map that specifies which macroblock is active
+ * \param[in] static_map  Map of the unchanged 8x8 blocks, or NULL
  */
 int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
                        int64_t ts_start, int64_t ts_end,
 #if CONFIG_VP9_HIGHBITDEPTH
                        int use_highbitdepth,
 #endif
-                       vpx_enc_frame_flags_t flags);
+                       vpx_enc_frame_flags_t flags,
+                       const unsigned char *static_map);
+
+/**\brief Enqueue a source buffer without copying it
+ *
+ * The entry reads the source image in place. Its edges are extended in place
+ * by vp9_extend_frame_in_place(), so the planes must be allocated that large.
+ * lent_frame is passed to
+ * ctx->release_lent_frame once the entry has left the window of frames read
+ * by the encoder, is reused or the lookahead is destroyed.
+ *
+ * \param[in] ctx         Pointer to the lookahead context
+ * \param[in] src         Pointer to the image to enqueue
+ * \param[in] full_border Whether to extend the edges for lookahead
+ * \param[in] ts_start    Timestamp for the start of this frame
+ * \param[in] ts_end      Timestamp for the end of this frame
+ * \param[in] flags       Flags set on this frame
+ * \param[in] lent_frame  Handle of the image for the release callback
+ */
+int vp9_lookahead_lend(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
+                       int full_border, int64_t ts_start, int64_t ts_end,
+                       vpx_enc_frame_flags_t flags, const void *lent_frame);
+
+/**\brief Copy a lent source buffer into the lookahead
+ *
+ * Replaces the image of an entry enqueued with vp9_lookahead_lend() by a copy
+ * with the full border and releases the lent frame. Does nothing for entries
+ * that already hold a copy.
+ *
+ * \param[in] ctx       Pointer to the lookahead context
+ * \param[in] entry     Entry to copy
+ */
+int vp9_lookahead_copy_lent(struct lookahead_ctx *ctx,
+                            struct lookahead_entry *entry);
 
 /**\brief Get the next source buffer to encode
  *
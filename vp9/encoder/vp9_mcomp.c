@@ -126,6 +126,7 @@ void vp9_init_dsmotion_compensation(search_site_config *cfg, int stride) {
     }
   }
 
+  cfg->stride = stride;
   cfg->searches_per_step = 4;
   cfg->total_steps = ss_count / cfg->searches_per_step;
 }
@@ -146,6 +147,7 @@ void vp9_init3smotion_compensation(search_site_config *cfg, int stride) {
     }
   }
 
+  cfg->stride = stride;
   cfg->searches_per_step = 8;
   cfg->total_steps = ss_count / cfg->searches_per_step;
 }
@@ -2443,6 +2445,25 @@ static int get_exhaustive_threshold(int exhaustive_searches_thresh,
          (8 - (b_width_log2_lookup[bsize] + b_height_log2_lookup[bsize]));
 }
 
+// Returns the search sites for the reference buffer set up in x. The sites in
+// cpi->ss_cfg are laid out for the encoder's frame stride, and the ones in
+// cpi->lent_ss_cfg for the stride of source frames lent to the encoder. Only
+// lent frames with yet another stride have the sites rebuilt in tmp_cfg.
+static const search_site_config *get_search_site_config(
+    const VP9_COMP *cpi, const MACROBLOCK *x, search_site_config *tmp_cfg) {
+  const int stride = x->e_mbd.plane[0].pre[0].stride;
+  if (cpi->ss_cfg.total_steps == 0 || stride == cpi->ss_cfg.stride)
+    return &cpi->ss_cfg;
+  if (stride == cpi->lent_ss_cfg.stride &&
+      cpi->lent_ss_cfg.searches_per_step == cpi->ss_cfg.searches_per_step)
+    return &cpi->lent_ss_cfg;
+  if (cpi->ss_cfg.searches_per_step == 8)
+    vp9_init3smotion_compensation(tmp_cfg, stride);
+  else
+    vp9_init_dsmotion_compensation(tmp_cfg, stride);
+  return tmp_cfg;
+}
+
 #if CONFIG_NON_GREEDY_MV
 // Runs sequence of diamond searches in smaller steps for RD.
 /* do_refine: If last step (1-away) of n-step search doesn't pick the center
@@ -2460,9 +2481,12 @@ int vp9_full_pixel_diamond_new(const VP9_COMP *cpi, MACROBLOCK *x,
   int bestsme;
   const int further_steps = MAX_MVSEARCH_STEPS - 1 - step_param;
   const MV center_mv = { 0, 0 };
+  search_site_config tmp_cfg;
+  const search_site_config *const cfg =
+      get_search_site_config(cpi, x, &tmp_cfg);
   vpx_clear_system_state();
-  diamond_search_sad_new(x, &cpi->ss_cfg, mvp_full, best_mv, step_param, lambda,
-                         &n, fn_ptr, nb_full_mvs, full_mv_num);
+  diamond_search_sad_new(x, cfg, mvp_full, best_mv, step_param, lambda, &n,
+                         fn_ptr, nb_full_mvs, full_mv_num);
 
   bestsme = vp9_get_mvpred_var(x, best_mv, &center_mv, fn_ptr, 0);
 
@@ -2476,9 +2500,8 @@ int vp9_full_pixel_diamond_new(const VP9_COMP *cpi, MACROBLOCK *x,
       num00--;
     } else {
       MV temp_mv;
-      diamond_search_sad_new(x, &cpi->ss_cfg, mvp_full, &temp_mv,
-                             step_param + n, lambda, &num00, fn_ptr,
-                             nb_full_mvs, full_mv_num);
+      diamond_search_sad_new(x, cfg, mvp_full, &temp_mv, step_param + n,
+                             lambda, &num00, fn_ptr, nb_full_mvs, full_mv_num);
       thissme = vp9_get_mvpred_var(x, &temp_mv, &center_mv, fn_ptr, 0);
       // check to see if refining search is needed.
       if (num00 > further_steps - n) do_refine = 0;
@@ -2529,8 +2552,11 @@ static int full_pixel_diamond(const VP9_COMP *const cpi,
                               const MV *ref_mv, MV *dst_mv) {
   MV temp_mv;
   int thissme, n, num00 = 0;
-  int bestsme = cpi->diamond_search_sad(x, &cpi->ss_cfg, mvp_full, &temp_mv,
-                                        step_param, sadpb, &n, fn_ptr, ref_mv);
+  search_site_config tmp_cfg;
+  const search_site_config *const cfg =
+      get_search_site_config(cpi, x, &tmp_cfg);
+  int bestsme = cpi->diamond_search_sad(x, cfg, mvp_full, &temp_mv, step_param,
+                                        sadpb, &n, fn_ptr, ref_mv);
   if (bestsme < INT_MAX)
     bestsme = vp9_get_mvpred_var(x, &temp_mv, ref_mv, fn_ptr, 1);
   *dst_mv = temp_mv;
@@ -2545,9 +2571,9 @@ static int full_pixel_diamond(const VP9_COMP *const cpi,
     if (num00) {
       num00--;
     } else {
-      thissme = cpi->diamond_search_sad(x, &cpi->ss_cfg, mvp_full, &temp_mv,
-                                        step_param + n, sadpb, &num00, fn_ptr,
-                                        ref_mv);
+      thissme =
+          cpi->diamond_search_sad(x, cfg, mvp_full, &temp_mv, step_param + n,
+                                  sadpb, &num00, fn_ptr, ref_mv);
       if (thissme < INT_MAX)
         thissme = vp9_get_mvpred_var(x, &temp_mv, ref_mv, fn_ptr, 1);
 
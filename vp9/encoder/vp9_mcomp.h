@@ -37,6 +37,7 @@ typedef struct search_site_config {
   // motion search sites
   MV ss_mv[8 * MAX_MVSEARCH_STEPS];        // Motion vector
   intptr_t ss_os[8 * MAX_MVSEARCH_STEPS];  // Offset
+  int stride;                              // Stride the offsets are for
   int searches_per_step;
   int total_steps;
 } search_site_config;
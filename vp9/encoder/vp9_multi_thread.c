@@ -241,6 +241,12 @@ void vp9_prepare_job_queue(VP9_COMP *cpi, JOB_TYPE job_type) {
     case ARNR_JOB:
       jobs_per_tile_col = ((cm->mi_rows + TF_ROUND) >> TF_SHIFT);
       break;
+    case TPL_JOB: {
+      const int mi_height =
+          num_8x8_blocks_high_lookup[cpi->tpl_dispenser_data.bsize];
+      jobs_per_tile_col = (cm->mi_rows + mi_height - 1) / mi_height;
+      break;
+    }
     default: assert(0);
   }
 
@@ -43,6 +43,77 @@ static int get_max_filter_level(const VP9_COMP *cpi) {
   }
 }
 
+// Superblock rows tried by LPF_PICK_FROM_SAMPLED_ROWS are this many rows
+// apart (half as many on small frames). No two sampled rows are adjacent, so
+// each one can be filtered, measured and restored on its own.
+#define LPF_SAMPLED_ROW_STEP 4
+
+// Filtering a horizontal edge may change the rows up to this far above it.
+#define LPF_ROWS_ABOVE 8
+
+// Filtered error of the levels tried by the search. With
+// LPF_PICK_FROM_SAMPLED_ROWS the error of a level may only cover its first
+// rows_done sampled rows: a level is no longer evaluated once it cannot win
+// the comparison it is tried for, and resumes from there if it is tried again.
+typedef struct LpfSearchCache {
+  int64_t err[MAX_LOOP_FILTER + 1];
+  int rows_done[MAX_LOOP_FILTER + 1];
+  int num_rows;
+  int first_sb_row;
+  int sb_row_step;
+} LpfSearchCache;
+
+static void init_search_cache(const VP9_COMMON *cm, LPF_PICK_METHOD method,
+                              LpfSearchCache *cache) {
+  memset(cache, 0, sizeof(*cache));
+  if (method == LPF_PICK_FROM_SAMPLED_ROWS) {
+    const int sb_rows =
+        mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+    cache->sb_row_step = sb_rows > 2 * LPF_SAMPLED_ROW_STEP
+                             ? LPF_SAMPLED_ROW_STEP
+                             : LPF_SAMPLED_ROW_STEP / 2;
+    cache->first_sb_row = VPXMIN(cache->sb_row_step >> 1, sb_rows - 1);
+    cache->num_rows = (sb_rows - cache->first_sb_row + cache->sb_row_step - 1) /
+                      cache->sb_row_step;
+  } else {
+    cache->num_rows = 1;
+  }
+}
+
+// Returns the first and last + 1 luma rows of the superblock row starting at
+// mi_row that filtering it may change.
+static void get_sb_row_extent(const YV12_BUFFER_CONFIG *frame, int mi_row,
+                              int *y_start, int *y_end) {
+  *y_start = VPXMAX(mi_row * MI_SIZE - LPF_ROWS_ABOVE, 0);
+  *y_end = VPXMIN((mi_row + MI_BLOCK_SIZE) * MI_SIZE, frame->y_height);
+}
+
+static void copy_y_rows(const YV12_BUFFER_CONFIG *src_ybc,
+                        YV12_BUFFER_CONFIG *dst_ybc, int y_start, int y_end) {
+  const uint8_t *src = src_ybc->y_buffer + y_start * src_ybc->y_stride;
+  uint8_t *dst = dst_ybc->y_buffer + y_start * dst_ybc->y_stride;
+  int row;
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (src_ybc->flags & YV12_FLAG_HIGHBITDEPTH) {
+    const uint16_t *src16 = CONVERT_TO_SHORTPTR(src);
+    uint16_t *dst16 = CONVERT_TO_SHORTPTR(dst);
+    for (row = y_start; row < y_end; ++row) {
+      memcpy(dst16, src16, src_ybc->y_width * sizeof(uint16_t));
+      src16 += src_ybc->y_stride;
+      dst16 += dst_ybc->y_stride;
+    }
+    return;
+  }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+  for (row = y_start; row < y_end; ++row) {
+    memcpy(dst, src, src_ybc->y_width);
+    src += src_ybc->y_stride;
+    dst += dst_ybc->y_stride;
+  }
+}
+
 static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
                                 VP9_COMP *const cpi, int filt_level,
                                 int partial_frame) {
@@ -75,8 +146,84 @@ static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
   return filt_err;
 }
 
+// Filters the luma of the superblock row starting at mi_row on its own, at the
+// level set up by the last vp9_loop_filter_frame_init(), and returns the error
+// of the rows that may have changed.
+static int64_t try_filter_sb_row(const YV12_BUFFER_CONFIG *sd,
+                                 VP9_COMP *const cpi, LFWorkerData *lf_data,
+                                 int mi_row) {
+  VP9_COMMON *const cm = &cpi->common;
+  YV12_BUFFER_CONFIG *const frame = cm->frame_to_show;
+  MODE_INFO **mi = cm->mi_grid_visible + mi_row * cm->mi_stride;
+  const int y_end =
+      VPXMIN((mi_row + MI_BLOCK_SIZE) * MI_SIZE, frame->y_crop_height);
+  int y_start, restore_end;
+  int mi_col;
+  int64_t filt_err;
+
+  for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE) {
+    vp9_setup_mask(cm, mi_row, mi_col, mi + mi_col, cm->mi_stride,
+                   get_lfm(&cm->lf, mi_row, mi_col));
+  }
+  vp9_loop_filter_cols(lf_data, mi_row, 0, cm->mi_cols);
+
+  get_sb_row_extent(frame, mi_row, &y_start, &restore_end);
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (cm->use_highbitdepth) {
+    filt_err = vpx_highbd_get_y_sse_part(sd, frame, 0, frame->y_crop_width,
+                                         y_start, y_end - y_start);
+  } else {
+    filt_err = vpx_get_y_sse_part(sd, frame, 0, frame->y_crop_width, y_start,
+                                  y_end - y_start);
+  }
+#else
+  filt_err = vpx_get_y_sse_part(sd, frame, 0, frame->y_crop_width, y_start,
+                                y_end - y_start);
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+  // Re-instate the unfiltered rows
+  copy_y_rows(&cpi->last_frame_uf, frame, y_start, restore_end);
+
+  return filt_err;
+}
+
+// Returns the error of filt_level, or, for LPF_PICK_FROM_SAMPLED_ROWS, a
+// partial error no smaller than limit once the level is known to reach it.
+static int64_t get_filter_err(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
+                              LpfSearchCache *cache, int filt_level,
+                              LPF_PICK_METHOD method, int64_t limit) {
+  VP9_COMMON *const cm = &cpi->common;
+
+  if (method != LPF_PICK_FROM_SAMPLED_ROWS) {
+    if (!cache->rows_done[filt_level]) {
+      cache->err[filt_level] = try_filter_frame(
+          sd, cpi, filt_level, method == LPF_PICK_FROM_SUBIMAGE);
+      cache->rows_done[filt_level] = 1;
+    }
+  } else if (cache->rows_done[filt_level] < cache->num_rows &&
+             cache->err[filt_level] < limit) {
+    LFWorkerData lf_data;
+
+    vp9_loop_filter_frame_init(cm, filt_level);
+    vp9_loop_filter_data_reset(&lf_data, cm->frame_to_show, cm,
+                               cpi->td.mb.e_mbd.plane);
+    lf_data.y_only = 1;
+
+    do {
+      const int sb_row = cache->first_sb_row +
+                         cache->rows_done[filt_level] * cache->sb_row_step;
+      cache->err[filt_level] +=
+          try_filter_sb_row(sd, cpi, &lf_data, sb_row * MI_BLOCK_SIZE);
+      ++cache->rows_done[filt_level];
+    } while (cache->rows_done[filt_level] < cache->num_rows &&
+             cache->err[filt_level] < limit);
+  }
+
+  return cache->err[filt_level];
+}
+
 static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
-                               int partial_frame) {
+                               LPF_PICK_METHOD method) {
   const VP9_COMMON *const cm = &cpi->common;
   const struct loopfilter *const lf = &cm->lf;
   const int min_filter_level = 0;
@@ -90,18 +237,27 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
   int filt_mid = clamp(lf->last_filt_level, min_filter_level, max_filter_level);
   int filter_step = filt_mid < 16 ? 4 : filt_mid / 4;
   // Sum squared error at each filter level
-  int64_t ss_err[MAX_LOOP_FILTER + 1];
+  LpfSearchCache cache;
   unsigned int section_intra_rating = get_section_intra_rating(cpi);
 
-  // Set each entry to -1
-  memset(ss_err, 0xFF, sizeof(ss_err));
+  init_search_cache(cm, method, &cache);
 
   //  Make a copy of the unfiltered / processed recon buffer
-  vpx_yv12_copy_y(cm->frame_to_show, &cpi->last_frame_uf);
+  if (method == LPF_PICK_FROM_SAMPLED_ROWS) {
+    int i;
+    for (i = 0; i < cache.num_rows; ++i) {
+      const int sb_row = cache.first_sb_row + i * cache.sb_row_step;
+      int y_start, y_end;
+      get_sb_row_extent(cm->frame_to_show, sb_row * MI_BLOCK_SIZE, &y_start,
+                        &y_end);
+      copy_y_rows(cm->frame_to_show, &cpi->last_frame_uf, y_start, y_end);
+    }
+  } else {
+    vpx_yv12_copy_y(cm->frame_to_show, &cpi->last_frame_uf);
+  }
 
-  best_err = try_filter_frame(sd, cpi, filt_mid, partial_frame);
+  best_err = get_filter_err(sd, cpi, &cache, filt_mid, method, INT64_MAX);
   filt_best = filt_mid;
-  ss_err[filt_mid] = best_err;
 
   while (filter_step > 0) {
     const int filt_high = VPXMIN(filt_mid + filter_step, max_filter_level);
@@ -118,14 +274,13 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
 
     if (filt_direction <= 0 && filt_low != filt_mid) {
       // Get Low filter error score
-      if (ss_err[filt_low] < 0) {
-        ss_err[filt_low] = try_filter_frame(sd, cpi, filt_low, partial_frame);
-      }
+      const int64_t low_err = get_filter_err(sd, cpi, &cache, filt_low, method,
+                                             best_err + bias);
       // If value is close to the best so far then bias towards a lower loop
       // filter value.
-      if ((ss_err[filt_low] - bias) < best_err) {
+      if ((low_err - bias) < best_err) {
         // Was it actually better than the previous best?
-        if (ss_err[filt_low] < best_err) best_err = ss_err[filt_low];
+        if (low_err < best_err) best_err = low_err;
 
         filt_best = filt_low;
       }
@@ -133,12 +288,11 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
 
     // Now look at filt_high
     if (filt_direction >= 0 && filt_high != filt_mid) {
-      if (ss_err[filt_high] < 0) {
-        ss_err[filt_high] = try_filter_frame(sd, cpi, filt_high, partial_frame);
-      }
+      const int64_t high_err = get_filter_err(sd, cpi, &cache, filt_high,
+                                              method, best_err - bias);
       // Was it better than the previous best?
-      if (ss_err[filt_high] < (best_err - bias)) {
-        best_err = ss_err[filt_high];
+      if (high_err < (best_err - bias)) {
+        best_err = high_err;
         filt_best = filt_high;
       }
     }
@@ -197,7 +351,6 @@ void vp9_pick_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
     if (cm->frame_type == KEY_FRAME) filt_guess -= 4;
     lf->filter_level = clamp(filt_guess, min_filter_level, max_filter_level);
   } else {
-    lf->filter_level =
-        search_filter_level(sd, cpi, method == LPF_PICK_FROM_SUBIMAGE);
+    lf->filter_level = search_filter_level(sd, cpi, method);
   }
 }
@@ -15,6 +15,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "./vp9_rtcd.h"
 #include "./vpx_config.h"
 #if CONFIG_VP9_HIGHBITDEPTH
 #include "vpx_dsp/vpx_dsp_common.h"
@@ -26,6 +27,10 @@
 #define FILTER_BITS 7
 
 #define INTERP_TAPS 8
+// vpx_filter.h, which vp9_rtcd.h pulls in, has these for the 1/16 pel
+// convolutions. The resize filters are 1/32 pel.
+#undef SUBPEL_BITS
+#undef SUBPEL_MASK
 #define SUBPEL_BITS 5
 #define SUBPEL_MASK ((1 << SUBPEL_BITS) - 1)
 #define INTERP_PRECISION_BITS 32
@@ -132,9 +137,12 @@ static const interp_kernel filteredinterp_filters1000[(1 << SUBPEL_BITS)] = {
   { 0, 1, -2, 7, 127, -6, 2, -1 },     { 0, 0, -1, 3, 128, -3, 1, 0 }
 };
 
-// Filters for factor of 2 downsampling.
-static const int16_t vp9_down2_symeven_half_filter[] = { 56, 12, -3, -1 };
-static const int16_t vp9_down2_symodd_half_filter[] = { 64, 35, 0, -3 };
+// Filters for factor of 2 downsampling, as 8-tap kernels starting 3 samples
+// before the first of the input samples an output replaces.
+static const int16_t down2_symeven_filter[INTERP_TAPS] = { -1, -3, 12, 56,
+                                                            56, 12, -3, -1 };
+static const int16_t down2_symodd_filter[INTERP_TAPS] = { -3, 0, 35, 64,
+                                                           35, 0, -3, 0 };
 
 static const interp_kernel *choose_interp_filter(int inlength, int outlength) {
   int outlength16 = outlength * 16;
@@ -150,204 +158,6 @@ static const interp_kernel *choose_interp_filter(int inlength, int outlength) {
     return filteredinterp_filters500;
 }
 
-static void interpolate(const uint8_t *const input, int inlength,
-                        uint8_t *output, int outlength) {
-  const int64_t delta =
-      (((uint64_t)inlength << 32) + outlength / 2) / outlength;
-  const int64_t offset =
-      inlength > outlength
-          ? (((int64_t)(inlength - outlength) << 31) + outlength / 2) /
-                outlength
-          : -(((int64_t)(outlength - inlength) << 31) + outlength / 2) /
-                outlength;
-  uint8_t *optr = output;
-  int x, x1, x2, sum, k, int_pel, sub_pel;
-  int64_t y;
-
-  const interp_kernel *interp_filters =
-      choose_interp_filter(inlength, outlength);
-
-  x = 0;
-  y = offset;
-  while ((y >> INTERP_PRECISION_BITS) < (INTERP_TAPS / 2 - 1)) {
-    x++;
-    y += delta;
-  }
-  x1 = x;
-  x = outlength - 1;
-  y = delta * x + offset;
-  while ((y >> INTERP_PRECISION_BITS) + (int64_t)(INTERP_TAPS / 2) >=
-         inlength) {
-    x--;
-    y -= delta;
-  }
-  x2 = x;
-  if (x1 > x2) {
-    for (x = 0, y = offset; x < outlength; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k) {
-        const int pk = int_pel - INTERP_TAPS / 2 + 1 + k;
-        sum += filter[k] *
-               input[(pk < 0 ? 0 : (pk >= inlength ? inlength - 1 : pk))];
-      }
-      *optr++ = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
-    }
-  } else {
-    // Initial part.
-    for (x = 0, y = offset; x < x1; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k)
-        sum += filter[k] * input[(int_pel - INTERP_TAPS / 2 + 1 + k < 0
-                                      ? 0
-                                      : int_pel - INTERP_TAPS / 2 + 1 + k)];
-      *optr++ = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
-    }
-    // Middle part.
-    for (; x <= x2; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k)
-        sum += filter[k] * input[int_pel - INTERP_TAPS / 2 + 1 + k];
-      *optr++ = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
-    }
-    // End part.
-    for (; x < outlength; ++x, y += delta) {
-      const int16_t *filter;
-      int_pel = y >> INTERP_PRECISION_BITS;
-      sub_pel = (y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
-      filter = interp_filters[sub_pel];
-      sum = 0;
-      for (k = 0; k < INTERP_TAPS; ++k)
-        sum += filter[k] * input[(int_pel - INTERP_TAPS / 2 + 1 + k >= inlength
-                                      ? inlength - 1
-                                      : int_pel - INTERP_TAPS / 2 + 1 + k)];
-      *optr++ = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
-    }
-  }
-}
-
-static void down2_symeven(const uint8_t *const input, int length,
-                          uint8_t *output) {
-  // Actual filter len = 2 * filter_len_half.
-  const int16_t *filter = vp9_down2_symeven_half_filter;
-  const int filter_len_half = sizeof(vp9_down2_symeven_half_filter) / 2;
-  int i, j;
-  uint8_t *optr = output;
-  int l1 = filter_len_half;
-  int l2 = (length - filter_len_half);
-  l1 += (l1 & 1);
-  l2 += (l2 & 1);
-  if (l1 > l2) {
-    // Short input length.
-    for (i = 0; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] +
-                input[(i + 1 + j >= length ? length - 1 : i + 1 + j)]) *
-               filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-  } else {
-    // Initial part.
-    for (i = 0; i < l1; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] + input[i + 1 + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-    // Middle part.
-    for (; i < l2; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[i + 1 + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-    // End part.
-    for (; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1));
-      for (j = 0; j < filter_len_half; ++j) {
-        sum += (input[i - j] +
-                input[(i + 1 + j >= length ? length - 1 : i + 1 + j)]) *
-               filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-  }
-}
-
-static void down2_symodd(const uint8_t *const input, int length,
-                         uint8_t *output) {
-  // Actual filter len = 2 * filter_len_half - 1.
-  const int16_t *filter = vp9_down2_symodd_half_filter;
-  const int filter_len_half = sizeof(vp9_down2_symodd_half_filter) / 2;
-  int i, j;
-  uint8_t *optr = output;
-  int l1 = filter_len_half - 1;
-  int l2 = (length - filter_len_half + 1);
-  l1 += (l1 & 1);
-  l2 += (l2 & 1);
-  if (l1 > l2) {
-    // Short input length.
-    for (i = 0; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] +
-                input[(i + j >= length ? length - 1 : i + j)]) *
-               filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-  } else {
-    // Initial part.
-    for (i = 0; i < l1; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[(i - j < 0 ? 0 : i - j)] + input[i + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-    // Middle part.
-    for (; i < l2; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[i + j]) * filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-    // End part.
-    for (; i < length; i += 2) {
-      int sum = (1 << (FILTER_BITS - 1)) + input[i] * filter[0];
-      for (j = 1; j < filter_len_half; ++j) {
-        sum += (input[i - j] + input[(i + j >= length ? length - 1 : i + j)]) *
-               filter[j];
-      }
-      sum >>= FILTER_BITS;
-      *optr++ = clip_pixel(sum);
-    }
-  }
-}
-
 static int get_down2_length(int length, int steps) {
   int s;
   for (s = 0; s < steps; ++s) length = (length + 1) >> 1;
@@ -364,94 +174,259 @@ static int get_down2_steps(int in_length, int out_length) {
   return steps;
 }
 
-static void resize_multistep(const uint8_t *const input, int length,
-                             uint8_t *output, int olength, uint8_t *otmp) {
-  int steps;
-  if (length == olength) {
-    memcpy(output, input, sizeof(output[0]) * length);
-    return;
+void vp9_resize_horz_8tap_c(const uint8_t *input, const int *pos,
+                            const int16_t *const *filter, uint8_t *output,
+                            int length) {
+  int o, k;
+  for (o = 0; o < length; ++o) {
+    const uint8_t *const in = input + pos[o];
+    const int16_t *const f = filter[o];
+    int sum = 0;
+    for (k = 0; k < INTERP_TAPS; ++k) sum += f[k] * in[k];
+    output[o] = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
   }
-  steps = get_down2_steps(length, olength);
+}
 
-  if (steps > 0) {
-    int s;
-    uint8_t *out = NULL;
-    uint8_t *otmp2;
-    int filteredlength = length;
+void vp9_resize_vert_8tap_c(const uint8_t *const *rows, const int16_t *filter,
+                            uint8_t *output, int width) {
+  int c, k;
+  for (c = 0; c < width; ++c) {
+    int sum = 0;
+    for (k = 0; k < INTERP_TAPS; ++k) sum += filter[k] * rows[k][c];
+    output[c] = clip_pixel(ROUND_POWER_OF_TWO(sum, FILTER_BITS));
+  }
+}
 
-    assert(otmp != NULL);
-    otmp2 = otmp + get_down2_length(length, 1);
-    for (s = 0; s < steps; ++s) {
-      const int proj_filteredlength = get_down2_length(filteredlength, 1);
-      const uint8_t *const in = (s == 0 ? input : out);
-      if (s == steps - 1 && proj_filteredlength == olength)
-        out = output;
-      else
-        out = (s & 1 ? otmp2 : otmp);
-      if (filteredlength & 1)
-        down2_symodd(in, filteredlength, out);
-      else
-        down2_symeven(in, filteredlength, out);
-      filteredlength = proj_filteredlength;
+// Rows are copied into buffers with this many replicated samples on each side
+// so the horizontal kernels never have to clamp. No 8-tap window starts more
+// than 4 samples before the row or ends more than 3 samples after it.
+#define RESIZE_PAD 8
+#define RESIZE_ROW_STRIPE 16
+#define RESIZE_COL_BLOCK 64
+
+static int init_resize_plan(ResizePlan *plan, int length, int olength) {
+  int steps, s, o;
+  int total = 0;
+  int filteredlength = length;
+  int *pos;
+  const int16_t **filter;
+
+  plan->num_steps = 0;
+  plan->pos = NULL;
+  plan->filter = NULL;
+  if (length == olength) return 1;
+
+  steps = get_down2_steps(length, olength);
+  for (s = 0; s < steps; ++s) {
+    filteredlength = get_down2_length(filteredlength, 1);
+    total += filteredlength;
+  }
+  if (filteredlength != olength) total += olength;
+  assert(steps < RESIZE_MAX_STEPS);
+
+  plan->pos = pos = (int *)malloc(total * sizeof(*pos));
+  plan->filter = filter = (const int16_t **)malloc(total * sizeof(*filter));
+  if (pos == NULL || filter == NULL) return 0;
+
+  filteredlength = length;
+  for (s = 0; s < steps; ++s) {
+    ResizeStep *const step = &plan->steps[plan->num_steps++];
+    const int16_t *const kernel =
+        (filteredlength & 1) ? down2_symodd_filter : down2_symeven_filter;
+    step->in_length = filteredlength;
+    step->out_length = get_down2_length(filteredlength, 1);
+    step->pos = pos;
+    step->filter = filter;
+    for (o = 0; o < step->out_length; ++o) {
+      *pos++ = 2 * o - INTERP_TAPS / 2 + 1;
+      *filter++ = kernel;
     }
-    if (filteredlength != olength) {
-      interpolate(out, filteredlength, output, olength);
+    filteredlength = step->out_length;
+  }
+
+  if (filteredlength != olength) {
+    const int inlength = filteredlength;
+    const int64_t delta =
+        (((uint64_t)inlength << 32) + olength / 2) / olength;
+    const int64_t offset =
+        inlength > olength
+            ? (((int64_t)(inlength - olength) << 31) + olength / 2) / olength
+            : -(((int64_t)(olength - inlength) << 31) + olength / 2) /
+                  olength;
+    const interp_kernel *interp_filters =
+        choose_interp_filter(inlength, olength);
+    ResizeStep *const step = &plan->steps[plan->num_steps++];
+    int64_t y = offset;
+    step->in_length = inlength;
+    step->out_length = olength;
+    step->pos = pos;
+    step->filter = filter;
+    for (o = 0; o < olength; ++o, y += delta) {
+      const int int_pel = (int)(y >> INTERP_PRECISION_BITS);
+      const int sub_pel =
+          (int)(y >> (INTERP_PRECISION_BITS - SUBPEL_BITS)) & SUBPEL_MASK;
+      *pos++ = int_pel - INTERP_TAPS / 2 + 1;
+      *filter++ = interp_filters[sub_pel];
     }
-  } else {
-    interpolate(input, length, output, olength);
   }
+  return 1;
 }
 
-static void fill_col_to_arr(uint8_t *img, int stride, int len, uint8_t *arr) {
-  int i;
-  uint8_t *iptr = img;
-  uint8_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *aptr++ = *iptr;
+static void free_resize_plan(ResizePlan *plan) {
+  free(plan->pos);
+  free(plan->filter);
+  plan->pos = NULL;
+  plan->filter = NULL;
+}
+
+int vp9_resize_plane_job_init(ResizePlaneJob *job, const uint8_t *const input,
+                              int height, int width, int in_stride,
+                              uint8_t *output, int height2, int width2,
+                              int out_stride) {
+  int ok;
+  assert(width > 0);
+  assert(height > 0);
+  assert(width2 > 0);
+  assert(height2 > 0);
+  job->input = input;
+  job->height = height;
+  job->width = width;
+  job->in_stride = in_stride;
+  job->output = output;
+  job->height2 = height2;
+  job->width2 = width2;
+  job->out_stride = out_stride;
+  job->intbuf = (uint8_t *)malloc(width2 * height * sizeof(*job->intbuf));
+  ok = init_resize_plan(&job->horz, width, width2);
+  ok &= init_resize_plan(&job->vert, height, height2);
+  if (!ok || job->intbuf == NULL) {
+    vp9_resize_plane_job_free(job);
+    return 0;
   }
+  return 1;
 }
 
-static void fill_arr_to_col(uint8_t *img, int stride, int len, uint8_t *arr) {
-  int i;
-  uint8_t *iptr = img;
-  uint8_t *aptr = arr;
-  for (i = 0; i < len; ++i, iptr += stride) {
-    *iptr = *aptr++;
+void vp9_resize_plane_job_free(ResizePlaneJob *job) {
+  free(job->intbuf);
+  job->intbuf = NULL;
+  free_resize_plan(&job->horz);
+  free_resize_plan(&job->vert);
+}
+
+int vp9_resize_plane_row_stripes(const ResizePlaneJob *job) {
+  return (job->height + RESIZE_ROW_STRIPE - 1) / RESIZE_ROW_STRIPE;
+}
+
+int vp9_resize_plane_col_blocks(const ResizePlaneJob *job) {
+  return (job->width2 + RESIZE_COL_BLOCK - 1) / RESIZE_COL_BLOCK;
+}
+
+static void extend_row(uint8_t *row, int length) {
+  memset(row - RESIZE_PAD, row[0], RESIZE_PAD);
+  memset(row + length, row[length - 1], RESIZE_PAD);
+}
+
+void vp9_resize_plane_rows(const ResizePlaneJob *job, int start, int step) {
+  const ResizePlan *const plan = &job->horz;
+  const int buf_size = job->width + 2 * RESIZE_PAD;
+  const int stripes = vp9_resize_plane_row_stripes(job);
+  uint8_t *buf[2] = { NULL, NULL };
+  int stripe, i, s;
+
+  if (job->intbuf == NULL) return;
+  if (plan->num_steps > 0) {
+    buf[0] = (uint8_t *)malloc(2 * buf_size * sizeof(*buf[0]));
+    if (buf[0] == NULL) return;
+    buf[1] = buf[0] + buf_size;
+  }
+
+  for (stripe = start; stripe < stripes; stripe += step) {
+    const int row_end = VPXMIN((stripe + 1) * RESIZE_ROW_STRIPE, job->height);
+    for (i = stripe * RESIZE_ROW_STRIPE; i < row_end; ++i) {
+      const uint8_t *const input = job->input + job->in_stride * i;
+      uint8_t *const output = job->intbuf + job->width2 * i;
+      uint8_t *in = buf[0] + RESIZE_PAD;
+      if (plan->num_steps == 0) {
+        memcpy(output, input, job->width);
+        continue;
+      }
+      memcpy(in, input, job->width);
+      extend_row(in, job->width);
+      for (s = 0; s < plan->num_steps; ++s) {
+        const ResizeStep *const rs = &plan->steps[s];
+        const int last = s == plan->num_steps - 1;
+        uint8_t *const out = last ? output : buf[(s + 1) & 1] + RESIZE_PAD;
+        vp9_resize_horz_8tap(in, rs->pos, rs->filter, out, rs->out_length);
+        if (!last) extend_row(out, rs->out_length);
+        in = out;
+      }
+    }
+  }
+  free(buf[0]);
+}
+
+void vp9_resize_plane_cols(const ResizePlaneJob *job, int start, int step) {
+  const ResizePlan *const plan = &job->vert;
+  const int buf_size = RESIZE_COL_BLOCK * get_down2_length(job->height, 1);
+  const int blocks = vp9_resize_plane_col_blocks(job);
+  uint8_t *buf[2] = { NULL, NULL };
+  int block, i, s, k;
+
+  if (job->intbuf == NULL) return;
+  if (plan->num_steps > 1) {
+    buf[0] = (uint8_t *)malloc(2 * buf_size * sizeof(*buf[0]));
+    if (buf[0] == NULL) return;
+    buf[1] = buf[0] + buf_size;
+  }
+
+  for (block = start; block < blocks; block += step) {
+    const int col = block * RESIZE_COL_BLOCK;
+    const int bw = VPXMIN(RESIZE_COL_BLOCK, job->width2 - col);
+    const uint8_t *in = job->intbuf + col;
+    int in_stride = job->width2;
+    if (plan->num_steps == 0) {
+      for (i = 0; i < job->height; ++i)
+        memcpy(job->output + job->out_stride * i + col, in + in_stride * i, bw);
+      continue;
+    }
+    // Every step of the block works on bw wide rows that stay in cache.
+    for (s = 0; s < plan->num_steps; ++s) {
+      const ResizeStep *const rs = &plan->steps[s];
+      const int last = s == plan->num_steps - 1;
+      uint8_t *const out = last ? job->output + col : buf[s & 1];
+      const int out_stride = last ? job->out_stride : bw;
+      for (i = 0; i < rs->out_length; ++i) {
+        const uint8_t *rows[INTERP_TAPS];
+        for (k = 0; k < INTERP_TAPS; ++k) {
+          const int p = clamp(rs->pos[i] + k, 0, rs->in_length - 1);
+          rows[k] = in + in_stride * p;
+        }
+        vp9_resize_vert_8tap(rows, rs->filter[i], out + out_stride * i, bw);
+      }
+      in = out;
+      in_stride = out_stride;
+    }
   }
+  free(buf[0]);
 }
 
 void vp9_resize_plane(const uint8_t *const input, int height, int width,
                       int in_stride, uint8_t *output, int height2, int width2,
                       int out_stride) {
-  int i;
-  uint8_t *intbuf = (uint8_t *)calloc(width2 * height, sizeof(*intbuf));
-  uint8_t *tmpbuf =
-      (uint8_t *)calloc(width < height ? height : width, sizeof(*tmpbuf));
-  uint8_t *arrbuf = (uint8_t *)calloc(height, sizeof(*arrbuf));
-  uint8_t *arrbuf2 = (uint8_t *)calloc(height2, sizeof(*arrbuf2));
-  if (intbuf == NULL || tmpbuf == NULL || arrbuf == NULL || arrbuf2 == NULL)
-    goto Error;
-  assert(width > 0);
-  assert(height > 0);
-  assert(width2 > 0);
-  assert(height2 > 0);
-  for (i = 0; i < height; ++i)
-    resize_multistep(input + in_stride * i, width, intbuf + width2 * i, width2,
-                     tmpbuf);
-  for (i = 0; i < width2; ++i) {
-    fill_col_to_arr(intbuf + i, width2, height, arrbuf);
-    resize_multistep(arrbuf, height, arrbuf2, height2, tmpbuf);
-    fill_arr_to_col(output + i, out_stride, height2, arrbuf2);
+  ResizePlaneJob job;
+  if (vp9_resize_plane_job_init(&job, input, height, width, in_stride, output,
+                                height2, width2, out_stride)) {
+    vp9_resize_plane_rows(&job, 0, 1);
+    vp9_resize_plane_cols(&job, 0, 1);
   }
-
-Error:
-  free(intbuf);
-  free(tmpbuf);
-  free(arrbuf);
-  free(arrbuf2);
+  vp9_resize_plane_job_free(&job);
 }
 
 #if CONFIG_VP9_HIGHBITDEPTH
+// Filters for factor of 2 downsampling.
+static const int16_t vp9_down2_symeven_half_filter[] = { 56, 12, -3, -1 };
+static const int16_t vp9_down2_symodd_half_filter[] = { 64, 35, 0, -3 };
+
 static void highbd_interpolate(const uint16_t *const input, int inlength,
                                uint16_t *output, int outlength, int bd) {
   const int64_t delta =
@@ -18,6 +18,54 @@
 extern "C" {
 #endif
 
+// Each 1-D resize is a chain of factor of 2 downsamplings followed by an
+// optional interpolation. Output sample o of a step is an 8-tap filter over the
+// step's input starting at pos[o], with positions clamped to the input.
+typedef struct {
+  int in_length;
+  int out_length;
+  const int *pos;
+  const int16_t *const *filter;
+} ResizeStep;
+
+#define RESIZE_MAX_STEPS 32
+
+typedef struct {
+  int num_steps;
+  ResizeStep steps[RESIZE_MAX_STEPS];
+  int *pos;
+  const int16_t **filter;
+} ResizePlan;
+
+// A plane is resized horizontally in stripes of rows into intbuf and then
+// vertically in blocks of columns, so the two passes can be split among
+// threads. All the stripes have to be done before any column block.
+typedef struct ResizePlaneJob {
+  const uint8_t *input;
+  int height;
+  int width;
+  int in_stride;
+  uint8_t *output;
+  int height2;
+  int width2;
+  int out_stride;
+  uint8_t *intbuf;
+  ResizePlan horz;
+  ResizePlan vert;
+} ResizePlaneJob;
+
+// Returns 0 if memory allocation fails. The job must be freed either way.
+int vp9_resize_plane_job_init(ResizePlaneJob *job, const uint8_t *const input,
+                              int height, int width, int in_stride,
+                              uint8_t *output, int height2, int width2,
+                              int out_stride);
+void vp9_resize_plane_job_free(ResizePlaneJob *job);
+int vp9_resize_plane_row_stripes(const ResizePlaneJob *job);
+int vp9_resize_plane_col_blocks(const ResizePlaneJob *job);
+// Resize the row stripes (column blocks) start, start + step, ...
+void vp9_resize_plane_rows(const ResizePlaneJob *job, int start, int step);
+void vp9_resize_plane_cols(const ResizePlaneJob *job, int start, int step);
+
 void vp9_resize_plane(const uint8_t *const input, int height, int width,
                       int in_stride, uint8_t *output, int height2, int width2,
                       int out_stride);
@@ -991,6 +991,9 @@ void vp9_set_speed_features_framesize_independent(VP9_COMP *cpi, int speed) {
     set_good_speed_feature_framesize_independent(cpi, cm, sf, speed);
 #endif
 
+  if (oxcf->sampled_lpf_pick && sf->lpf_pick < LPF_PICK_FROM_Q)
+    sf->lpf_pick = LPF_PICK_FROM_SAMPLED_ROWS;
+
   cpi->diamond_search_sad = vp9_diamond_search_sad;
 
   // Slow quant, dct and trellis not worthwhile for first pass
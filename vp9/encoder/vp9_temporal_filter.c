@@ -47,22 +47,15 @@ static int64_t highbd_index_mult[14] = { 0U,          0U,          0U,
 
 static void temporal_filter_predictors_mb_c(
     MACROBLOCKD *xd, uint8_t *y_mb_ptr, uint8_t *u_mb_ptr, uint8_t *v_mb_ptr,
-    int stride, int uv_block_width, int uv_block_height, int mv_row, int mv_col,
-    uint8_t *pred, struct scale_factors *scale, int x, int y, MV *blk_mvs,
-    int use_32x32) {
+    int stride, int uv_stride, int uv_block_width, int uv_block_height,
+    int mv_row, int mv_col, uint8_t *pred, struct scale_factors *scale, int x,
+    int y, const MV *blk_mvs, int use_32x32) {
   const int which_mv = 0;
   const InterpKernel *const kernel = vp9_filter_kernels[EIGHTTAP_SHARP];
   int i, j, k = 0, ys = (BH >> 1), xs = (BW >> 1);
 
-  enum mv_precision mv_precision_uv;
-  int uv_stride;
-  if (uv_block_width == (BW >> 1)) {
-    uv_stride = (stride + 1) >> 1;
-    mv_precision_uv = MV_PRECISION_Q4;
-  } else {
-    uv_stride = stride;
-    mv_precision_uv = MV_PRECISION_Q3;
-  }
+  const enum mv_precision mv_precision_uv =
+      uv_block_width == (BW >> 1) ? MV_PRECISION_Q4 : MV_PRECISION_Q3;
 #if !CONFIG_VP9_HIGHBITDEPTH
   (void)xd;
 #endif
@@ -550,7 +543,7 @@ void vp9_highbd_apply_temporal_filter_c(
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
 static uint32_t temporal_filter_find_matching_mb_c(
-    VP9_COMP *cpi, ThreadData *td, uint8_t *arf_frame_buf,
+    VP9_COMP *cpi, ThreadData *td, uint8_t *arf_frame_buf, int arf_stride,
     uint8_t *frame_ptr_buf, int stride, MV *ref_mv, MV *blk_mvs,
     int *blk_bestsme) {
   MACROBLOCK *const x = &td->mb;
@@ -579,7 +572,7 @@ static uint32_t temporal_filter_find_matching_mb_c(
 
   // Setup frame pointers
   x->plane[0].src.buf = arf_frame_buf;
-  x->plane[0].src.stride = stride;
+  x->plane[0].src.stride = arf_stride;
   xd->plane[0].pre[0].buf = frame_ptr_buf;
   xd->plane[0].pre[0].stride = stride;
 
@@ -613,8 +606,8 @@ static uint32_t temporal_filter_find_matching_mb_c(
   for (i = 0; i < BH; i += SUB_BH) {
     for (j = 0; j < BW; j += SUB_BW) {
       // Setup frame pointers
-      x->plane[0].src.buf = arf_frame_buf + i * stride + j;
-      x->plane[0].src.stride = stride;
+      x->plane[0].src.buf = arf_frame_buf + i * arf_stride + j;
+      x->plane[0].src.stride = arf_stride;
       xd->plane[0].pre[0].buf = frame_ptr_buf + i * stride + j;
       xd->plane[0].pre[0].stride = stride;
 
@@ -642,6 +635,113 @@ static uint32_t temporal_filter_find_matching_mb_c(
   return bestsme;
 }
 
+static void temporal_filter_search_block(VP9_COMP *cpi, ThreadData *td,
+                                         int frame, int mb_row, int mb_col,
+                                         ARNRBlockSearch *search) {
+  const ARNRFilterData *const arnr_filter_data = &cpi->arnr_filter_data;
+  YV12_BUFFER_CONFIG *const *const frames = arnr_filter_data->frames;
+  const int alt_ref_index = arnr_filter_data->alt_ref_index;
+  const YV12_BUFFER_CONFIG *const f = frames[alt_ref_index];
+  const int mb_cols = (f->y_crop_width + BW - 1) >> BW_LOG2;
+  const int mb_rows = (f->y_crop_height + BH - 1) >> BH_LOG2;
+  const int mb_y_offset = mb_row * BH * f->y_stride + mb_col * BW;
+  // Lent source frames have their own strides.
+  const int frame_y_offset =
+      mb_row * BH * frames[frame]->y_stride + mb_col * BW;
+  int *const blk_fw = search->blk_fw;
+  int k;
+
+  search->ref_mv = kZeroMv;
+  search->blk_mvs[0] = kZeroMv;
+  search->blk_mvs[1] = kZeroMv;
+  search->blk_mvs[2] = kZeroMv;
+  search->blk_mvs[3] = kZeroMv;
+
+  if (frame == alt_ref_index) {
+    blk_fw[0] = blk_fw[1] = blk_fw[2] = blk_fw[3] = 2;
+    search->use_32x32 = 1;
+  } else {
+    const int thresh_low = 10000;
+    const int thresh_high = 20000;
+    int blk_bestsme[4] = { INT_MAX, INT_MAX, INT_MAX, INT_MAX };
+    int err, err16;
+    int max_err = INT_MIN, min_err = INT_MAX;
+
+    // Source frames are extended to 16 pixels. This is different than
+    //  L/A/G reference frames that have a border of 32 (VP9ENCBORDERINPIXELS)
+    // A 6/8 tap filter is used for motion search.  This requires 2 pixels
+    //  before and 3 pixels after.  So the largest Y mv on a border would
+    //  then be 16 - VP9_INTERP_EXTEND. The UV blocks are half the size of the
+    //  Y and therefore only extended by 8.  The largest mv that a UV block
+    //  can support is 8 - VP9_INTERP_EXTEND.  A UV mv is half of a Y mv.
+    //  (16 - VP9_INTERP_EXTEND) >> 1 which is greater than
+    //  8 - VP9_INTERP_EXTEND.
+    // To keep the mv in play for both Y and UV planes the max that it
+    //  can be on a border is therefore 16 - (2*VP9_INTERP_EXTEND+1).
+    td->mb.mv_limits.row_min = -((mb_row * BH) + (17 - 2 * VP9_INTERP_EXTEND));
+    td->mb.mv_limits.row_max =
+        ((mb_rows - 1 - mb_row) * BH) + (17 - 2 * VP9_INTERP_EXTEND);
+    td->mb.mv_limits.col_min = -((mb_col * BW) + (17 - 2 * VP9_INTERP_EXTEND));
+    td->mb.mv_limits.col_max =
+        ((mb_cols - 1 - mb_col) * BW) + (17 - 2 * VP9_INTERP_EXTEND);
+
+    // Find best match in this frame by MC
+    err = temporal_filter_find_matching_mb_c(
+        cpi, td, f->y_buffer + mb_y_offset, f->y_stride,
+        frames[frame]->y_buffer + frame_y_offset, frames[frame]->y_stride,
+        &search->ref_mv, search->blk_mvs, blk_bestsme);
+
+    err16 = blk_bestsme[0] + blk_bestsme[1] + blk_bestsme[2] + blk_bestsme[3];
+    for (k = 0; k < 4; k++) {
+      if (min_err > blk_bestsme[k]) min_err = blk_bestsme[k];
+      if (max_err < blk_bestsme[k]) max_err = blk_bestsme[k];
+    }
+
+    if (((err * 15 < (err16 << 4)) && max_err - min_err < 10000) ||
+        ((err * 14 < (err16 << 4)) && max_err - min_err < 5000)) {
+      search->use_32x32 = 1;
+      // Assign higher weight to matching MB if it's error
+      // score is lower. If not applying MC default behavior
+      // is to weight all MBs equal.
+      blk_fw[0] = err < (thresh_low << THR_SHIFT)
+                      ? 2
+                      : err < (thresh_high << THR_SHIFT) ? 1 : 0;
+      blk_fw[1] = blk_fw[2] = blk_fw[3] = blk_fw[0];
+    } else {
+      search->use_32x32 = 0;
+      for (k = 0; k < 4; k++)
+        blk_fw[k] = blk_bestsme[k] < thresh_low
+                        ? 2
+                        : blk_bestsme[k] < thresh_high ? 1 : 0;
+    }
+
+    for (k = 0; k < 4; k++) {
+      switch (abs(frame - alt_ref_index)) {
+        case 1: blk_fw[k] = VPXMIN(blk_fw[k], 2); break;
+        case 2:
+        case 3: blk_fw[k] = VPXMIN(blk_fw[k], 1); break;
+        default: break;
+      }
+    }
+  }
+}
+
+void vp9_temporal_filter_search_row(VP9_COMP *cpi, ThreadData *td, int frame,
+                                    int mb_row) {
+  ARNRFilterData *const arnr_filter_data = &cpi->arnr_filter_data;
+  const YV12_BUFFER_CONFIG *const f =
+      arnr_filter_data->frames[arnr_filter_data->alt_ref_index];
+  const int mb_cols = (f->y_crop_width + BW - 1) >> BW_LOG2;
+  const int mb_rows = (f->y_crop_height + BH - 1) >> BH_LOG2;
+  ARNRBlockSearch *const search =
+      arnr_filter_data->block_search + (frame * mb_rows + mb_row) * mb_cols;
+  int mb_col;
+
+  for (mb_col = 0; mb_col < mb_cols; mb_col++)
+    temporal_filter_search_block(cpi, td, frame, mb_row, mb_col,
+                                 &search[mb_col]);
+}
+
 void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
                                        int mb_row, int mb_col_start,
                                        int mb_col_end) {
@@ -674,6 +774,10 @@ void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
   int mb_y_offset = mb_row * BH * (f->y_stride) + BW * mb_col_start;
   int mb_uv_offset =
       mb_row * mb_uv_height * f->uv_stride + mb_uv_width * mb_col_start;
+  int dst_y_offset =
+      mb_row * BH * cpi->alt_ref_buffer.y_stride + BW * mb_col_start;
+  int dst_uv_offset = mb_row * mb_uv_height * cpi->alt_ref_buffer.uv_stride +
+                      mb_uv_width * mb_col_start;
 
 #if CONFIG_VP9_HIGHBITDEPTH
   if (mbd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
@@ -683,33 +787,13 @@ void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
   }
 #endif
 
-  // Source frames are extended to 16 pixels. This is different than
-  //  L/A/G reference frames that have a border of 32 (VP9ENCBORDERINPIXELS)
-  // A 6/8 tap filter is used for motion search.  This requires 2 pixels
-  //  before and 3 pixels after.  So the largest Y mv on a border would
-  //  then be 16 - VP9_INTERP_EXTEND. The UV blocks are half the size of the
-  //  Y and therefore only extended by 8.  The largest mv that a UV block
-  //  can support is 8 - VP9_INTERP_EXTEND.  A UV mv is half of a Y mv.
-  //  (16 - VP9_INTERP_EXTEND) >> 1 which is greater than
-  //  8 - VP9_INTERP_EXTEND.
-  // To keep the mv in play for both Y and UV planes the max that it
-  //  can be on a border is therefore 16 - (2*VP9_INTERP_EXTEND+1).
-  td->mb.mv_limits.row_min = -((mb_row * BH) + (17 - 2 * VP9_INTERP_EXTEND));
-  td->mb.mv_limits.row_max =
-      ((mb_rows - 1 - mb_row) * BH) + (17 - 2 * VP9_INTERP_EXTEND);
-
   for (mb_col = mb_col_start; mb_col < mb_col_end; mb_col++) {
     int i, j, k;
     int stride;
-    MV ref_mv;
 
     vp9_zero_array(accumulator, BLK_PELS * 3);
     vp9_zero_array(count, BLK_PELS * 3);
 
-    td->mb.mv_limits.col_min = -((mb_col * BW) + (17 - 2 * VP9_INTERP_EXTEND));
-    td->mb.mv_limits.col_max =
-        ((mb_cols - 1 - mb_col) * BW) + (17 - 2 * VP9_INTERP_EXTEND);
-
     if (cpi->oxcf.content == VP9E_CONTENT_FILM) {
       unsigned int src_variance;
       struct buf_2d src;
@@ -734,79 +818,32 @@ void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
     }
 
     for (frame = 0; frame < frame_count; frame++) {
-      // MVs for 4 16x16 sub blocks.
-      MV blk_mvs[4];
-      // Filter weights for 4 16x16 sub blocks.
-      int blk_fw[4] = { 0, 0, 0, 0 };
-      int use_32x32 = 0;
+      ARNRBlockSearch block_search;
+      const ARNRBlockSearch *search = &block_search;
 
       if (frames[frame] == NULL) continue;
 
-      ref_mv.row = 0;
-      ref_mv.col = 0;
-      blk_mvs[0] = kZeroMv;
-      blk_mvs[1] = kZeroMv;
-      blk_mvs[2] = kZeroMv;
-      blk_mvs[3] = kZeroMv;
-
-      if (frame == alt_ref_index) {
-        blk_fw[0] = blk_fw[1] = blk_fw[2] = blk_fw[3] = 2;
-        use_32x32 = 1;
+      if (arnr_filter_data->use_block_search && frame != alt_ref_index) {
+        const int index = (frame * mb_rows + mb_row) * mb_cols + mb_col;
+        search = &arnr_filter_data->block_search[index];
       } else {
-        const int thresh_low = 10000;
-        const int thresh_high = 20000;
-        int blk_bestsme[4] = { INT_MAX, INT_MAX, INT_MAX, INT_MAX };
-
-        // Find best match in this frame by MC
-        int err = temporal_filter_find_matching_mb_c(
-            cpi, td, frames[alt_ref_index]->y_buffer + mb_y_offset,
-            frames[frame]->y_buffer + mb_y_offset, frames[frame]->y_stride,
-            &ref_mv, blk_mvs, blk_bestsme);
-
-        int err16 =
-            blk_bestsme[0] + blk_bestsme[1] + blk_bestsme[2] + blk_bestsme[3];
-        int max_err = INT_MIN, min_err = INT_MAX;
-        for (k = 0; k < 4; k++) {
-          if (min_err > blk_bestsme[k]) min_err = blk_bestsme[k];
-          if (max_err < blk_bestsme[k]) max_err = blk_bestsme[k];
-        }
-
-        if (((err * 15 < (err16 << 4)) && max_err - min_err < 10000) ||
-            ((err * 14 < (err16 << 4)) && max_err - min_err < 5000)) {
-          use_32x32 = 1;
-          // Assign higher weight to matching MB if it's error
-          // score is lower. If not applying MC default behavior
-          // is to weight all MBs equal.
-          blk_fw[0] = err < (thresh_low << THR_SHIFT)
-                          ? 2
-                          : err < (thresh_high << THR_SHIFT) ? 1 : 0;
-          blk_fw[1] = blk_fw[2] = blk_fw[3] = blk_fw[0];
-        } else {
-          use_32x32 = 0;
-          for (k = 0; k < 4; k++)
-            blk_fw[k] = blk_bestsme[k] < thresh_low
-                            ? 2
-                            : blk_bestsme[k] < thresh_high ? 1 : 0;
-        }
-
-        for (k = 0; k < 4; k++) {
-          switch (abs(frame - alt_ref_index)) {
-            case 1: blk_fw[k] = VPXMIN(blk_fw[k], 2); break;
-            case 2:
-            case 3: blk_fw[k] = VPXMIN(blk_fw[k], 1); break;
-            default: break;
-          }
-        }
+        temporal_filter_search_block(cpi, td, frame, mb_row, mb_col,
+                                     &block_search);
       }
 
-      if (blk_fw[0] | blk_fw[1] | blk_fw[2] | blk_fw[3]) {
+      if (search->blk_fw[0] | search->blk_fw[1] | search->blk_fw[2] |
+          search->blk_fw[3]) {
+        const YV12_BUFFER_CONFIG *const ref = frames[frame];
+        const int ref_y_offset = mb_row * BH * ref->y_stride + mb_col * BW;
+        const int ref_uv_offset =
+            mb_row * mb_uv_height * ref->uv_stride + mb_col * mb_uv_width;
         // Construct the predictors
         temporal_filter_predictors_mb_c(
-            mbd, frames[frame]->y_buffer + mb_y_offset,
-            frames[frame]->u_buffer + mb_uv_offset,
-            frames[frame]->v_buffer + mb_uv_offset, frames[frame]->y_stride,
-            mb_uv_width, mb_uv_height, ref_mv.row, ref_mv.col, predictor, scale,
-            mb_col * BW, mb_row * BH, blk_mvs, use_32x32);
+            mbd, ref->y_buffer + ref_y_offset, ref->u_buffer + ref_uv_offset,
+            ref->v_buffer + ref_uv_offset, ref->y_stride, ref->uv_stride,
+            mb_uv_width, mb_uv_height, search->ref_mv.row, search->ref_mv.col,
+            predictor, scale, mb_col * BW, mb_row * BH, search->blk_mvs,
+            search->use_32x32);
 
 #if CONFIG_VP9_HIGHBITDEPTH
         if (mbd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
@@ -820,8 +857,8 @@ void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
               CONVERT_TO_SHORTPTR(predictor + BLK_PELS),
               CONVERT_TO_SHORTPTR(predictor + (BLK_PELS << 1)), mb_uv_width, BW,
               BH, mbd->plane[1].subsampling_x, mbd->plane[1].subsampling_y,
-              adj_strength, blk_fw, use_32x32, accumulator, count,
-              accumulator + BLK_PELS, count + BLK_PELS,
+              adj_strength, search->blk_fw, search->use_32x32, accumulator,
+              count, accumulator + BLK_PELS, count + BLK_PELS,
               accumulator + (BLK_PELS << 1), count + (BLK_PELS << 1));
         } else {
           // Apply the filter (YUV)
@@ -830,9 +867,10 @@ void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
               f->u_buffer + mb_uv_offset, f->v_buffer + mb_uv_offset,
               f->uv_stride, predictor + BLK_PELS, predictor + (BLK_PELS << 1),
               mb_uv_width, BW, BH, mbd->plane[1].subsampling_x,
-              mbd->plane[1].subsampling_y, strength, blk_fw, use_32x32,
-              accumulator, count, accumulator + BLK_PELS, count + BLK_PELS,
-              accumulator + (BLK_PELS << 1), count + (BLK_PELS << 1));
+              mbd->plane[1].subsampling_y, strength, search->blk_fw,
+              search->use_32x32, accumulator, count, accumulator + BLK_PELS,
+              count + BLK_PELS, accumulator + (BLK_PELS << 1),
+              count + (BLK_PELS << 1));
         }
 #else
         // Apply the filter (YUV)
@@ -841,9 +879,10 @@ void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
             f->u_buffer + mb_uv_offset, f->v_buffer + mb_uv_offset,
             f->uv_stride, predictor + BLK_PELS, predictor + (BLK_PELS << 1),
             mb_uv_width, BW, BH, mbd->plane[1].subsampling_x,
-            mbd->plane[1].subsampling_y, strength, blk_fw, use_32x32,
-            accumulator, count, accumulator + BLK_PELS, count + BLK_PELS,
-            accumulator + (BLK_PELS << 1), count + (BLK_PELS << 1));
+            mbd->plane[1].subsampling_y, strength, search->blk_fw,
+            search->use_32x32, accumulator, count, accumulator + BLK_PELS,
+            count + BLK_PELS, accumulator + (BLK_PELS << 1),
+            count + (BLK_PELS << 1));
 #endif  // CONFIG_VP9_HIGHBITDEPTH
       }
     }
@@ -856,7 +895,7 @@ void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
       dst1 = cpi->alt_ref_buffer.y_buffer;
       dst1_16 = CONVERT_TO_SHORTPTR(dst1);
       stride = cpi->alt_ref_buffer.y_stride;
-      byte = mb_y_offset;
+      byte = dst_y_offset;
       for (i = 0, k = 0; i < BH; i++) {
         for (j = 0; j < BW; j++, k++) {
           unsigned int pval = accumulator[k] + (count[k] >> 1);
@@ -877,7 +916,7 @@ void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
       dst1_16 = CONVERT_TO_SHORTPTR(dst1);
       dst2_16 = CONVERT_TO_SHORTPTR(dst2);
       stride = cpi->alt_ref_buffer.uv_stride;
-      byte = mb_uv_offset;
+      byte = dst_uv_offset;
       for (i = 0, k = BLK_PELS; i < mb_uv_height; i++) {
         for (j = 0; j < mb_uv_width; j++, k++) {
           int m = k + BLK_PELS;
@@ -904,7 +943,7 @@ void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
       // Normalize filter output to produce AltRef frame
       dst1 = cpi->alt_ref_buffer.y_buffer;
       stride = cpi->alt_ref_buffer.y_stride;
-      byte = mb_y_offset;
+      byte = dst_y_offset;
       for (i = 0, k = 0; i < BH; i++) {
         for (j = 0; j < BW; j++, k++) {
           unsigned int pval = accumulator[k] + (count[k] >> 1);
@@ -922,7 +961,7 @@ void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
       dst1 = cpi->alt_ref_buffer.u_buffer;
       dst2 = cpi->alt_ref_buffer.v_buffer;
       stride = cpi->alt_ref_buffer.uv_stride;
-      byte = mb_uv_offset;
+      byte = dst_uv_offset;
       for (i = 0, k = BLK_PELS; i < mb_uv_height; i++) {
         for (j = 0; j < mb_uv_width; j++, k++) {
           int m = k + BLK_PELS;
@@ -949,7 +988,7 @@ void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
     // Normalize filter output to produce AltRef frame
     dst1 = cpi->alt_ref_buffer.y_buffer;
     stride = cpi->alt_ref_buffer.y_stride;
-    byte = mb_y_offset;
+    byte = dst_y_offset;
     for (i = 0, k = 0; i < BH; i++) {
       for (j = 0; j < BW; j++, k++) {
         unsigned int pval = accumulator[k] + (count[k] >> 1);
@@ -967,7 +1006,7 @@ void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
     dst1 = cpi->alt_ref_buffer.u_buffer;
     dst2 = cpi->alt_ref_buffer.v_buffer;
     stride = cpi->alt_ref_buffer.uv_stride;
-    byte = mb_uv_offset;
+    byte = dst_uv_offset;
     for (i = 0, k = BLK_PELS; i < mb_uv_height; i++) {
       for (j = 0; j < mb_uv_width; j++, k++) {
         int m = k + BLK_PELS;
@@ -992,6 +1031,8 @@ void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
 #endif  // CONFIG_VP9_HIGHBITDEPTH
     mb_y_offset += BW;
     mb_uv_offset += mb_uv_width;
+    dst_y_offset += BW;
+    dst_uv_offset += mb_uv_width;
   }
 }
 
@@ -1170,7 +1211,7 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
                                "Failed to reallocate alt_ref_buffer");
           }
           frames[frame] = vp9_scale_if_required(
-              cm, frames[frame], &cpi->svc.scaled_frames[frame_used], 0,
+              cpi, frames[frame], &cpi->svc.scaled_frames[frame_used], 0,
               EIGHTTAP, 0);
           ++frame_used;
         }
@@ -1198,6 +1239,7 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
   set_error_per_bit(&cpi->td.mb, rdmult);
   vp9_initialize_me_consts(cpi, &cpi->td.mb, ARNR_FILT_QINDEX);
 
+  arnr_filter_data->use_block_search = 0;
   if (!cpi->row_mt)
     temporal_filter_iterate_c(cpi);
   else
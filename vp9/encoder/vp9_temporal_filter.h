@@ -39,6 +39,11 @@ void vp9_temporal_filter_iterate_row_c(VP9_COMP *cpi, ThreadData *td,
                                        int mb_row, int mb_col_start,
                                        int mb_col_end);
 
+// Runs the motion searches of a block row in one of the frames and stores the
+// results in cpi->arnr_filter_data.block_search.
+void vp9_temporal_filter_search_row(VP9_COMP *cpi, ThreadData *td, int frame,
+                                    int mb_row);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -0,0 +1,753 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "./vp9_rtcd.h"
+#include "./vpx_config.h"
+#include "vpx/vpx_integer.h"
+#include "vp9/encoder/vp9_encoder.h"
+#include "vp9/encoder/vp9_temporal_filter.h"
+#include "vp9/encoder/x86/temporal_filter_constants.h"
+
+// The luma path works on rows of 16 pixels held in a single register. The
+// chroma path works on rows of 8 pixels with the u plane in the low lane and
+// the v plane in the high lane, so both planes are filtered together.
+
+static INLINE __m256i combine_128(const __m128i lo, const __m128i hi) {
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+// Read in 16 pixels from a and b as 8-bit unsigned integers, compute the
+// difference squared, and store as unsigned 16-bit integer to dst.
+static INLINE void store_dist_16(const uint8_t *a, const uint8_t *b,
+                                 uint16_t *dst) {
+  const __m256i a_reg =
+      _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)a));
+  const __m256i b_reg =
+      _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)b));
+  __m256i dist;
+
+  dist = _mm256_sub_epi16(a_reg, b_reg);
+  dist = _mm256_mullo_epi16(dist, dist);
+
+  _mm256_storeu_si256((__m256i *)dst, dist);
+}
+
+// Read in 8 u pixels and 8 v pixels, compute the difference squared for both
+// planes at once, and store to u_dst and v_dst.
+static INLINE void store_dist_8_uv(const uint8_t *u_a, const uint8_t *u_b,
+                                   const uint8_t *v_a, const uint8_t *v_b,
+                                   uint16_t *u_dst, uint16_t *v_dst) {
+  const __m128i a_u8 =
+      _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)u_a),
+                         _mm_loadl_epi64((const __m128i *)v_a));
+  const __m128i b_u8 =
+      _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)u_b),
+                         _mm_loadl_epi64((const __m128i *)v_b));
+  __m256i dist;
+
+  dist = _mm256_sub_epi16(_mm256_cvtepu8_epi16(a_u8),
+                          _mm256_cvtepu8_epi16(b_u8));
+  dist = _mm256_mullo_epi16(dist, dist);
+
+  _mm_storeu_si128((__m128i *)u_dst, _mm256_castsi256_si128(dist));
+  _mm_storeu_si128((__m128i *)v_dst, _mm256_extracti128_si256(dist, 1));
+}
+
+// Average the value based on the number of values summed (9 for pixels away
+// from the border, 4 for pixels in corners, and 6 for other edge values).
+//
+// Add in the rounding factor and shift, clamp to 16, invert and shift. Multiply
+// by weight.
+static INLINE __m256i average_16(__m256i sum, const __m256i mul_constants,
+                                 const int strength, const int rounding,
+                                 const __m256i weight) {
+  // _mm256_srl_epi16 uses the lower 64 bit value for the shift.
+  const __m128i strength_u128 = _mm_set_epi32(0, 0, 0, strength);
+  const __m256i rounding_u16 = _mm256_set1_epi16(rounding);
+  const __m256i sixteen = _mm256_set1_epi16(16);
+
+  // modifier * 3 / index;
+  sum = _mm256_mulhi_epu16(sum, mul_constants);
+
+  sum = _mm256_adds_epu16(sum, rounding_u16);
+  sum = _mm256_srl_epi16(sum, strength_u128);
+
+  sum = _mm256_min_epu16(sum, sixteen);
+
+  sum = _mm256_sub_epi16(sixteen, sum);
+
+  return _mm256_mullo_epi16(sum, weight);
+}
+
+// Add 'sum_u16' to 'count'. Multiply by 'pred' and add to 'accumulator.'
+static INLINE void accumulate_and_store_16(const __m256i sum_u16,
+                                           const uint8_t *pred, uint16_t *count,
+                                           uint32_t *accumulator) {
+  const __m256i pred_u16 =
+      _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)pred));
+  __m256i count_u16 = _mm256_loadu_si256((const __m256i *)count);
+  __m256i pred_0_u32, pred_1_u32;
+  __m256i accum_0_u32, accum_1_u32;
+
+  count_u16 = _mm256_adds_epu16(count_u16, sum_u16);
+  _mm256_storeu_si256((__m256i *)count, count_u16);
+
+  pred_0_u32 = _mm256_mullo_epi16(sum_u16, pred_u16);
+  pred_1_u32 = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(pred_0_u32, 1));
+  pred_0_u32 = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(pred_0_u32));
+
+  accum_0_u32 = _mm256_loadu_si256((const __m256i *)accumulator);
+  accum_1_u32 = _mm256_loadu_si256((const __m256i *)(accumulator + 8));
+
+  accum_0_u32 = _mm256_add_epi32(pred_0_u32, accum_0_u32);
+  accum_1_u32 = _mm256_add_epi32(pred_1_u32, accum_1_u32);
+
+  _mm256_storeu_si256((__m256i *)accumulator, accum_0_u32);
+  _mm256_storeu_si256((__m256i *)(accumulator + 8), accum_1_u32);
+}
+
+// Same as accumulate_and_store_16() but with the u plane in the low lane of
+// 'sum_u16' and the v plane in the high lane.
+static INLINE void accumulate_and_store_8_uv(const __m256i sum_u16,
+                                             const uint8_t *u_pre,
+                                             const uint8_t *v_pre,
+                                             uint16_t *u_count,
+                                             uint16_t *v_count,
+                                             uint32_t *u_accum,
+                                             uint32_t *v_accum) {
+  const __m128i pred_u8 =
+      _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)u_pre),
+                         _mm_loadl_epi64((const __m128i *)v_pre));
+  const __m256i pred_u16 = _mm256_cvtepu8_epi16(pred_u8);
+  __m256i count_u16 =
+      combine_128(_mm_loadu_si128((const __m128i *)u_count),
+                  _mm_loadu_si128((const __m128i *)v_count));
+  __m256i prod_u16, u_pred_u32, v_pred_u32;
+  __m256i u_accum_u32, v_accum_u32;
+
+  count_u16 = _mm256_adds_epu16(count_u16, sum_u16);
+  _mm_storeu_si128((__m128i *)u_count, _mm256_castsi256_si128(count_u16));
+  _mm_storeu_si128((__m128i *)v_count, _mm256_extracti128_si256(count_u16, 1));
+
+  prod_u16 = _mm256_mullo_epi16(sum_u16, pred_u16);
+  u_pred_u32 = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(prod_u16));
+  v_pred_u32 = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(prod_u16, 1));
+
+  u_accum_u32 = _mm256_loadu_si256((const __m256i *)u_accum);
+  v_accum_u32 = _mm256_loadu_si256((const __m256i *)v_accum);
+
+  u_accum_u32 = _mm256_add_epi32(u_pred_u32, u_accum_u32);
+  v_accum_u32 = _mm256_add_epi32(v_pred_u32, v_accum_u32);
+
+  _mm256_storeu_si256((__m256i *)u_accum, u_accum_u32);
+  _mm256_storeu_si256((__m256i *)v_accum, v_accum_u32);
+}
+
+// Read in 16 values from y_dist. For each index i, compute y_dist[i-1] +
+// y_dist[i] + y_dist[i+1] and return them as 16-bit unsigned ints.
+static INLINE __m256i get_sum_16(const uint16_t *y_dist) {
+  const __m256i dist_reg = _mm256_loadu_si256((const __m256i *)y_dist);
+  const __m256i dist_left = _mm256_loadu_si256((const __m256i *)(y_dist - 1));
+  const __m256i dist_right = _mm256_loadu_si256((const __m256i *)(y_dist + 1));
+
+  return _mm256_adds_epu16(_mm256_adds_epu16(dist_reg, dist_left), dist_right);
+}
+
+// Same as get_sum_16() for 8 values of u_dist in the low lane and 8 values of
+// v_dist in the high lane.
+static INLINE __m256i get_sum_8_uv(const uint16_t *u_dist,
+                                   const uint16_t *v_dist) {
+  const __m256i dist_reg =
+      combine_128(_mm_loadu_si128((const __m128i *)u_dist),
+                  _mm_loadu_si128((const __m128i *)v_dist));
+  const __m256i dist_left =
+      combine_128(_mm_loadu_si128((const __m128i *)(u_dist - 1)),
+                  _mm_loadu_si128((const __m128i *)(v_dist - 1)));
+  const __m256i dist_right =
+      combine_128(_mm_loadu_si128((const __m128i *)(u_dist + 1)),
+                  _mm_loadu_si128((const __m128i *)(v_dist + 1)));
+
+  return _mm256_adds_epu16(_mm256_adds_epu16(dist_reg, dist_left), dist_right);
+}
+
+// Read in a row of chroma values corresponding to a row of 16 luma values and
+// return the sum of the u and v distortions.
+static INLINE __m256i read_chroma_dist_row_16(int ss_x, const uint16_t *u_dist,
+                                              const uint16_t *v_dist) {
+  __m256i u_reg, v_reg;
+
+  if (!ss_x) {
+    // If there is no chroma subsampling in the horizontal direction, then we
+    // need to load 16 entries from chroma.
+    u_reg = _mm256_loadu_si256((const __m256i *)u_dist);
+    v_reg = _mm256_loadu_si256((const __m256i *)v_dist);
+  } else {  // ss_x == 1
+    // Otherwise, we only need to load 8 entries and duplicate each of them.
+    u_reg = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)u_dist));
+    v_reg = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)v_dist));
+
+    u_reg = _mm256_or_si256(u_reg, _mm256_slli_epi32(u_reg, 16));
+    v_reg = _mm256_or_si256(v_reg, _mm256_slli_epi32(v_reg, 16));
+  }
+
+  return _mm256_adds_epu16(u_reg, v_reg);
+}
+
+// Return the luma distortion for a row of 8 chroma pixels, summed over the
+// luma pixels that correspond to each chroma pixel. The result is duplicated
+// in both lanes so it can be added to the u and v sums together.
+static INLINE __m256i get_luma_dist_for_8_chroma(const uint16_t *y_dist,
+                                                 int ss_x, int ss_y) {
+  __m128i y_reg;
+
+  if (!ss_x) {
+    y_reg = _mm_loadu_si128((const __m128i *)y_dist);
+    if (ss_y == 1) {
+      const __m128i y_tmp =
+          _mm_loadu_si128((const __m128i *)(y_dist + DIST_STRIDE));
+      y_reg = _mm_adds_epu16(y_reg, y_tmp);
+    }
+  } else {
+    const __m256i low_mask = _mm256_set1_epi32(0xffff);
+    __m256i y_16 = _mm256_loadu_si256((const __m256i *)y_dist);
+    __m256i y_32;
+    if (ss_y == 1) {
+      const __m256i y_tmp =
+          _mm256_loadu_si256((const __m256i *)(y_dist + DIST_STRIDE));
+      y_16 = _mm256_adds_epu16(y_16, y_tmp);
+    }
+
+    // Horizontal add of adjacent pairs as 32-bit ints, then saturate back.
+    y_32 = _mm256_add_epi32(_mm256_and_si256(y_16, low_mask),
+                            _mm256_srli_epi32(y_16, 16));
+    y_reg = _mm_packus_epi32(_mm256_castsi256_si128(y_32),
+                             _mm256_extracti128_si256(y_32, 1));
+  }
+
+  return _mm256_broadcastsi128_si256(y_reg);
+}
+
+// Apply temporal filter to the luma components. This performs temporal
+// filtering on a luma block of 16 X block_height. Use blk_fw as an array of
+// size 4 for the weights for each of the 4 subblocks if blk_fw is not NULL,
+// else use top_weight for top half, and bottom weight for bottom half.
+static void vp9_apply_temporal_filter_luma_16(
+    const uint8_t *y_pre, int y_pre_stride, unsigned int block_height,
+    int ss_x, int ss_y, int strength, int use_whole_blk, uint32_t *y_accum,
+    uint16_t *y_count, const uint16_t *y_dist, const uint16_t *u_dist,
+    const uint16_t *v_dist, const int16_t *const *neighbors_first,
+    const int16_t *const *neighbors_second, int top_weight, int bottom_weight,
+    const int *blk_fw) {
+  const int rounding = (1 << strength) >> 1;
+  __m256i weight, mul;
+  __m256i sum_row_1, sum_row_2, sum_row_3;
+  __m256i uv_sum, sum_row;
+
+  // Loop variables
+  unsigned int h;
+
+  assert(strength >= 0);
+  assert(strength <= 6);
+
+  // Initialize the weights
+  if (blk_fw) {
+    weight = combine_128(_mm_set1_epi16(blk_fw[0]), _mm_set1_epi16(blk_fw[1]));
+  } else {
+    weight = _mm256_set1_epi16(top_weight);
+  }
+
+  // First row
+  mul = combine_128(_mm_load_si128((const __m128i *)neighbors_first[0]),
+                    _mm_load_si128((const __m128i *)neighbors_second[0]));
+
+  // Add luma values
+  sum_row_2 = get_sum_16(y_dist);
+  sum_row_3 = get_sum_16(y_dist + DIST_STRIDE);
+
+  sum_row = _mm256_adds_epu16(sum_row_2, sum_row_3);
+
+  // Add chroma values
+  uv_sum = read_chroma_dist_row_16(ss_x, u_dist, v_dist);
+  sum_row = _mm256_adds_epu16(sum_row, uv_sum);
+
+  // Get modifier and store result
+  sum_row = average_16(sum_row, mul, strength, rounding, weight);
+  accumulate_and_store_16(sum_row, y_pre, y_count, y_accum);
+
+  y_pre += y_pre_stride;
+  y_count += y_pre_stride;
+  y_accum += y_pre_stride;
+  y_dist += DIST_STRIDE;
+
+  u_dist += DIST_STRIDE;
+  v_dist += DIST_STRIDE;
+
+  // Then all the rows except the last one
+  mul = combine_128(_mm_load_si128((const __m128i *)neighbors_first[1]),
+                    _mm_load_si128((const __m128i *)neighbors_second[1]));
+
+  for (h = 1; h < block_height - 1; ++h) {
+    // Move the weight to bottom half
+    if (!use_whole_blk && h == block_height / 2) {
+      if (blk_fw) {
+        weight =
+            combine_128(_mm_set1_epi16(blk_fw[2]), _mm_set1_epi16(blk_fw[3]));
+      } else {
+        weight = _mm256_set1_epi16(bottom_weight);
+      }
+    }
+    // Shift the rows up
+    sum_row_1 = sum_row_2;
+    sum_row_2 = sum_row_3;
+
+    // Add luma values to the modifier
+    sum_row = _mm256_adds_epu16(sum_row_1, sum_row_2);
+    sum_row_3 = get_sum_16(y_dist + DIST_STRIDE);
+    sum_row = _mm256_adds_epu16(sum_row, sum_row_3);
+
+    // Add chroma values to the modifier
+    if (ss_y == 0 || h % 2 == 0) {
+      // Only calculate the new chroma distortion if we are at a pixel that
+      // corresponds to a new chroma row
+      uv_sum = read_chroma_dist_row_16(ss_x, u_dist, v_dist);
+
+      u_dist += DIST_STRIDE;
+      v_dist += DIST_STRIDE;
+    }
+
+    sum_row = _mm256_adds_epu16(sum_row, uv_sum);
+
+    // Get modifier and store result
+    sum_row = average_16(sum_row, mul, strength, rounding, weight);
+    accumulate_and_store_16(sum_row, y_pre, y_count, y_accum);
+
+    y_pre += y_pre_stride;
+    y_count += y_pre_stride;
+    y_accum += y_pre_stride;
+    y_dist += DIST_STRIDE;
+  }
+
+  // The last row
+  mul = combine_128(_mm_load_si128((const __m128i *)neighbors_first[0]),
+                    _mm_load_si128((const __m128i *)neighbors_second[0]));
+
+  // Shift the rows up
+  sum_row_1 = sum_row_2;
+  sum_row_2 = sum_row_3;
+
+  // Add luma values to the modifier
+  sum_row = _mm256_adds_epu16(sum_row_1, sum_row_2);
+
+  // Add chroma values to the modifier
+  if (ss_y == 0) {
+    // Only calculate the new chroma distortion if we are at a pixel that
+    // corresponds to a new chroma row
+    uv_sum = read_chroma_dist_row_16(ss_x, u_dist, v_dist);
+  }
+
+  sum_row = _mm256_adds_epu16(sum_row, uv_sum);
+
+  // Get modifier and store result
+  sum_row = average_16(sum_row, mul, strength, rounding, weight);
+  accumulate_and_store_16(sum_row, y_pre, y_count, y_accum);
+}
+
+// Perform temporal filter for the luma component.
+static void vp9_apply_temporal_filter_luma(
+    const uint8_t *y_pre, int y_pre_stride, unsigned int block_width,
+    unsigned int block_height, int ss_x, int ss_y, int strength,
+    const int *blk_fw, int use_whole_blk, uint32_t *y_accum, uint16_t *y_count,
+    const uint16_t *y_dist, const uint16_t *u_dist, const uint16_t *v_dist) {
+  unsigned int blk_col = 0, uv_blk_col = 0;
+  const unsigned int blk_col_step = 16, uv_blk_col_step = 16 >> ss_x;
+  const unsigned int mid_width = block_width >> 1,
+                     last_width = block_width - blk_col_step;
+  int top_weight = blk_fw[0],
+      bottom_weight = use_whole_blk ? blk_fw[0] : blk_fw[2];
+  const int16_t *const *neighbors_first;
+  const int16_t *const *neighbors_second;
+
+  if (block_width == 16) {
+    // Special Case: The blockwidth is 16 and we are operating on a row of 16
+    // chroma pixels. In this case, we can't use the usual left-middle-right
+    // pattern. We also don't support splitting now.
+    neighbors_first = LUMA_LEFT_COLUMN_NEIGHBORS;
+    neighbors_second = LUMA_RIGHT_COLUMN_NEIGHBORS;
+    vp9_apply_temporal_filter_luma_16(
+        y_pre, y_pre_stride, block_height, ss_x, ss_y, strength, use_whole_blk,
+        y_accum, y_count, y_dist, u_dist, v_dist, neighbors_first,
+        neighbors_second, top_weight, bottom_weight,
+        use_whole_blk ? NULL : blk_fw);
+    return;
+  }
+
+  // Left
+  neighbors_first = LUMA_LEFT_COLUMN_NEIGHBORS;
+  neighbors_second = LUMA_MIDDLE_COLUMN_NEIGHBORS;
+  vp9_apply_temporal_filter_luma_16(
+      y_pre + blk_col, y_pre_stride, block_height, ss_x, ss_y, strength,
+      use_whole_blk, y_accum + blk_col, y_count + blk_col, y_dist + blk_col,
+      u_dist + uv_blk_col, v_dist + uv_blk_col, neighbors_first,
+      neighbors_second, top_weight, bottom_weight, NULL);
+
+  blk_col += blk_col_step;
+  uv_blk_col += uv_blk_col_step;
+
+  // Middle First
+  neighbors_first = LUMA_MIDDLE_COLUMN_NEIGHBORS;
+  for (; blk_col < mid_width;
+       blk_col += blk_col_step, uv_blk_col += uv_blk_col_step) {
+    vp9_apply_temporal_filter_luma_16(
+        y_pre + blk_col, y_pre_stride, block_height, ss_x, ss_y, strength,
+        use_whole_blk, y_accum + blk_col, y_count + blk_col, y_dist + blk_col,
+        u_dist + uv_blk_col, v_dist + uv_blk_col, neighbors_first,
+        neighbors_second, top_weight, bottom_weight, NULL);
+  }
+
+  if (!use_whole_blk) {
+    top_weight = blk_fw[1];
+    bottom_weight = blk_fw[3];
+  }
+
+  // Middle Second
+  for (; blk_col < last_width;
+       blk_col += blk_col_step, uv_blk_col += uv_blk_col_step) {
+    vp9_apply_temporal_filter_luma_16(
+        y_pre + blk_col, y_pre_stride, block_height, ss_x, ss_y, strength,
+        use_whole_blk, y_accum + blk_col, y_count + blk_col, y_dist + blk_col,
+        u_dist + uv_blk_col, v_dist + uv_blk_col, neighbors_first,
+        neighbors_second, top_weight, bottom_weight, NULL);
+  }
+
+  // Right
+  neighbors_second = LUMA_RIGHT_COLUMN_NEIGHBORS;
+  vp9_apply_temporal_filter_luma_16(
+      y_pre + blk_col, y_pre_stride, block_height, ss_x, ss_y, strength,
+      use_whole_blk, y_accum + blk_col, y_count + blk_col, y_dist + blk_col,
+      u_dist + uv_blk_col, v_dist + uv_blk_col, neighbors_first,
+      neighbors_second, top_weight, bottom_weight, NULL);
+}
+
+// Apply temporal filter to the chroma components. This performs temporal
+// filtering on a chroma block of 8 X uv_height for both the u and the v plane.
+// If blk_fw is not NULL, use blk_fw as an array of size 4 for the weights for
+// each of the 4 subblocks, else use top_weight for top half, and bottom weight
+// for bottom half.
+static void vp9_apply_temporal_filter_chroma_8(
+    const uint8_t *u_pre, const uint8_t *v_pre, int uv_pre_stride,
+    unsigned int uv_block_height, int ss_x, int ss_y, int strength,
+    uint32_t *u_accum, uint16_t *u_count, uint32_t *v_accum, uint16_t *v_count,
+    const uint16_t *y_dist, const uint16_t *u_dist, const uint16_t *v_dist,
+    const int16_t *const *neighbors, int top_weight, int bottom_weight,
+    const int *blk_fw) {
+  const int rounding = (1 << strength) >> 1;
+  __m256i weight, mul;
+  __m256i sum_row_1, sum_row_2, sum_row_3;
+  __m256i sum_row;
+
+  // Loop variable
+  unsigned int h;
+
+  // Initialize weight
+  if (blk_fw) {
+    weight = _mm256_broadcastsi128_si256(
+        _mm_setr_epi16(blk_fw[0], blk_fw[0], blk_fw[0], blk_fw[0], blk_fw[1],
+                       blk_fw[1], blk_fw[1], blk_fw[1]));
+  } else {
+    weight = _mm256_set1_epi16(top_weight);
+  }
+
+  // First row
+  mul = _mm256_broadcastsi128_si256(
+      _mm_load_si128((const __m128i *)neighbors[0]));
+
+  // Add chroma values
+  sum_row_2 = get_sum_8_uv(u_dist, v_dist);
+  sum_row_3 = get_sum_8_uv(u_dist + DIST_STRIDE, v_dist + DIST_STRIDE);
+
+  sum_row = _mm256_adds_epu16(sum_row_2, sum_row_3);
+
+  // Add luma values
+  sum_row = _mm256_adds_epu16(sum_row,
+                              get_luma_dist_for_8_chroma(y_dist, ss_x, ss_y));
+
+  // Get modifier and store result
+  sum_row = average_16(sum_row, mul, strength, rounding, weight);
+  accumulate_and_store_8_uv(sum_row, u_pre, v_pre, u_count, v_count, u_accum,
+                            v_accum);
+
+  u_pre += uv_pre_stride;
+  u_dist += DIST_STRIDE;
+  v_pre += uv_pre_stride;
+  v_dist += DIST_STRIDE;
+  u_count += uv_pre_stride;
+  u_accum += uv_pre_stride;
+  v_count += uv_pre_stride;
+  v_accum += uv_pre_stride;
+
+  y_dist += DIST_STRIDE * (1 + ss_y);
+
+  // Then all the rows except the last one
+  mul = _mm256_broadcastsi128_si256(
+      _mm_load_si128((const __m128i *)neighbors[1]));
+
+  for (h = 1; h < uv_block_height - 1; ++h) {
+    // Move the weight pointer to the bottom half of the blocks
+    if (h == uv_block_height / 2) {
+      if (blk_fw) {
+        weight = _mm256_broadcastsi128_si256(
+            _mm_setr_epi16(blk_fw[2], blk_fw[2], blk_fw[2], blk_fw[2],
+                           blk_fw[3], blk_fw[3], blk_fw[3], blk_fw[3]));
+      } else {
+        weight = _mm256_set1_epi16(bottom_weight);
+      }
+    }
+
+    // Shift the rows up
+    sum_row_1 = sum_row_2;
+    sum_row_2 = sum_row_3;
+
+    // Add chroma values
+    sum_row = _mm256_adds_epu16(sum_row_1, sum_row_2);
+    sum_row_3 = get_sum_8_uv(u_dist + DIST_STRIDE, v_dist + DIST_STRIDE);
+    sum_row = _mm256_adds_epu16(sum_row, sum_row_3);
+
+    // Add luma values
+    sum_row = _mm256_adds_epu16(sum_row,
+                                get_luma_dist_for_8_chroma(y_dist, ss_x, ss_y));
+
+    // Get modifier and store result
+    sum_row = average_16(sum_row, mul, strength, rounding, weight);
+    accumulate_and_store_8_uv(sum_row, u_pre, v_pre, u_count, v_count, u_accum,
+                              v_accum);
+
+    u_pre += uv_pre_stride;
+    u_dist += DIST_STRIDE;
+    v_pre += uv_pre_stride;
+    v_dist += DIST_STRIDE;
+    u_count += uv_pre_stride;
+    u_accum += uv_pre_stride;
+    v_count += uv_pre_stride;
+    v_accum += uv_pre_stride;
+
+    y_dist += DIST_STRIDE * (1 + ss_y);
+  }
+
+  // The last row
+  mul = _mm256_broadcastsi128_si256(
+      _mm_load_si128((const __m128i *)neighbors[0]));
+
+  // Shift the rows up
+  sum_row_1 = sum_row_2;
+  sum_row_2 = sum_row_3;
+
+  // Add chroma values
+  sum_row = _mm256_adds_epu16(sum_row_1, sum_row_2);
+
+  // Add luma values
+  sum_row = _mm256_adds_epu16(sum_row,
+                              get_luma_dist_for_8_chroma(y_dist, ss_x, ss_y));
+
+  // Get modifier and store result
+  sum_row = average_16(sum_row, mul, strength, rounding, weight);
+  accumulate_and_store_8_uv(sum_row, u_pre, v_pre, u_count, v_count, u_accum,
+                            v_accum);
+}
+
+// Perform temporal filter for the chroma components.
+static void vp9_apply_temporal_filter_chroma(
+    const uint8_t *u_pre, const uint8_t *v_pre, int uv_pre_stride,
+    unsigned int block_width, unsigned int block_height, int ss_x, int ss_y,
+    int strength, const int *blk_fw, int use_whole_blk, uint32_t *u_accum,
+    uint16_t *u_count, uint32_t *v_accum, uint16_t *v_count,
+    const uint16_t *y_dist, const uint16_t *u_dist, const uint16_t *v_dist) {
+  const unsigned int uv_width = block_width >> ss_x,
+                     uv_height = block_height >> ss_y;
+
+  unsigned int blk_col = 0, uv_blk_col = 0;
+  const unsigned int uv_blk_col_step = 8, blk_col_step = 8 << ss_x;
+  const unsigned int uv_mid_width = uv_width >> 1,
+                     uv_last_width = uv_width - uv_blk_col_step;
+  int top_weight = blk_fw[0],
+      bottom_weight = use_whole_blk ? blk_fw[0] : blk_fw[2];
+  const int16_t *const *neighbors;
+
+  if (uv_width == 8) {
+    // Special Case: We are subsampling in x direction on a 16x16 block. Since
+    // we are operating on a row of 8 chroma pixels, we can't use the usual
+    // left-middle-right pattern.
+    assert(ss_x);
+
+    if (ss_y) {
+      neighbors = CHROMA_DOUBLE_SS_SINGLE_COLUMN_NEIGHBORS;
+    } else {
+      neighbors = CHROMA_SINGLE_SS_SINGLE_COLUMN_NEIGHBORS;
+    }
+
+    vp9_apply_temporal_filter_chroma_8(
+        u_pre, v_pre, uv_pre_stride, uv_height, ss_x, ss_y, strength, u_accum,
+        u_count, v_accum, v_count, y_dist, u_dist, v_dist, neighbors,
+        top_weight, bottom_weight, use_whole_blk ? NULL : blk_fw);
+    return;
+  }
+
+  // Left
+  if (ss_x && ss_y) {
+    neighbors = CHROMA_DOUBLE_SS_LEFT_COLUMN_NEIGHBORS;
+  } else if (ss_x || ss_y) {
+    neighbors = CHROMA_SINGLE_SS_LEFT_COLUMN_NEIGHBORS;
+  } else {
+    neighbors = CHROMA_NO_SS_LEFT_COLUMN_NEIGHBORS;
+  }
+
+  vp9_apply_temporal_filter_chroma_8(
+      u_pre + uv_blk_col, v_pre + uv_blk_col, uv_pre_stride, uv_height, ss_x,
+      ss_y, strength, u_accum + uv_blk_col, u_count + uv_blk_col,
+      v_accum + uv_blk_col, v_count + uv_blk_col, y_dist + blk_col,
+      u_dist + uv_blk_col, v_dist + uv_blk_col, neighbors, top_weight,
+      bottom_weight, NULL);
+
+  blk_col += blk_col_step;
+  uv_blk_col += uv_blk_col_step;
+
+  // Middle First
+  if (ss_x && ss_y) {
+    neighbors = CHROMA_DOUBLE_SS_MIDDLE_COLUMN_NEIGHBORS;
+  } else if (ss_x || ss_y) {
+    neighbors = CHROMA_SINGLE_SS_MIDDLE_COLUMN_NEIGHBORS;
+  } else {
+    neighbors = CHROMA_NO_SS_MIDDLE_COLUMN_NEIGHBORS;
+  }
+
+  for (; uv_blk_col < uv_mid_width;
+       blk_col += blk_col_step, uv_blk_col += uv_blk_col_step) {
+    vp9_apply_temporal_filter_chroma_8(
+        u_pre + uv_blk_col, v_pre + uv_blk_col, uv_pre_stride, uv_height, ss_x,
+        ss_y, strength, u_accum + uv_blk_col, u_count + uv_blk_col,
+        v_accum + uv_blk_col, v_count + uv_blk_col, y_dist + blk_col,
+        u_dist + uv_blk_col, v_dist + uv_blk_col, neighbors, top_weight,
+        bottom_weight, NULL);
+  }
+
+  if (!use_whole_blk) {
+    top_weight = blk_fw[1];
+    bottom_weight = blk_fw[3];
+  }
+
+  // Middle Second
+  for (; uv_blk_col < uv_last_width;
+       blk_col += blk_col_step, uv_blk_col += uv_blk_col_step) {
+    vp9_apply_temporal_filter_chroma_8(
+        u_pre + uv_blk_col, v_pre + uv_blk_col, uv_pre_stride, uv_height, ss_x,
+        ss_y, strength, u_accum + uv_blk_col, u_count + uv_blk_col,
+        v_accum + uv_blk_col, v_count + uv_blk_col, y_dist + blk_col,
+        u_dist + uv_blk_col, v_dist + uv_blk_col, neighbors, top_weight,
+        bottom_weight, NULL);
+  }
+
+  // Right
+  if (ss_x && ss_y) {
+    neighbors = CHROMA_DOUBLE_SS_RIGHT_COLUMN_NEIGHBORS;
+  } else if (ss_x || ss_y) {
+    neighbors = CHROMA_SINGLE_SS_RIGHT_COLUMN_NEIGHBORS;
+  } else {
+    neighbors = CHROMA_NO_SS_RIGHT_COLUMN_NEIGHBORS;
+  }
+
+  vp9_apply_temporal_filter_chroma_8(
+      u_pre + uv_blk_col, v_pre + uv_blk_col, uv_pre_stride, uv_height, ss_x,
+      ss_y, strength, u_accum + uv_blk_col, u_count + uv_blk_col,
+      v_accum + uv_blk_col, v_count + uv_blk_col, y_dist + blk_col,
+      u_dist + uv_blk_col, v_dist + uv_blk_col, neighbors, top_weight,
+      bottom_weight, NULL);
+}
+
+void vp9_apply_temporal_filter_avx2(
+    const uint8_t *y_src, int y_src_stride, const uint8_t *y_pre,
+    int y_pre_stride, const uint8_t *u_src, const uint8_t *v_src,
+    int uv_src_stride, const uint8_t *u_pre, const uint8_t *v_pre,
+    int uv_pre_stride, unsigned int block_width, unsigned int block_height,
+    int ss_x, int ss_y, int strength, const int *const blk_fw,
+    int use_whole_blk, uint32_t *y_accum, uint16_t *y_count, uint32_t *u_accum,
+    uint16_t *u_count, uint32_t *v_accum, uint16_t *v_count) {
+  const unsigned int chroma_height = block_height >> ss_y,
+                     chroma_width = block_width >> ss_x;
+
+  DECLARE_ALIGNED(32, uint16_t, y_dist[BH * DIST_STRIDE]) = { 0 };
+  DECLARE_ALIGNED(32, uint16_t, u_dist[BH * DIST_STRIDE]) = { 0 };
+  DECLARE_ALIGNED(32, uint16_t, v_dist[BH * DIST_STRIDE]) = { 0 };
+
+  uint16_t *y_dist_ptr = y_dist + 1, *u_dist_ptr = u_dist + 1,
+           *v_dist_ptr = v_dist + 1;
+  const uint8_t *y_src_ptr = y_src, *u_src_ptr = u_src, *v_src_ptr = v_src;
+  const uint8_t *y_pre_ptr = y_pre, *u_pre_ptr = u_pre, *v_pre_ptr = v_pre;
+
+  // Loop variables
+  unsigned int row, blk_col;
+
+  assert(block_width <= BW && "block width too large");
+  assert(block_height <= BH && "block height too large");
+  assert(block_width % 16 == 0 && "block width must be multiple of 16");
+  assert(block_height % 2 == 0 && "block height must be even");
+  assert((ss_x == 0 || ss_x == 1) && (ss_y == 0 || ss_y == 1) &&
+         "invalid chroma subsampling");
+  assert(strength >= 0 && strength <= 6 && "invalid temporal filter strength");
+  assert(blk_fw[0] >= 0 && "filter weight must be positive");
+  assert(
+      (use_whole_blk || (blk_fw[1] >= 0 && blk_fw[2] >= 0 && blk_fw[3] >= 0)) &&
+      "subblock filter weight must be positive");
+  assert(blk_fw[0] <= 2 && "sublock filter weight must be less than 2");
+  assert(
+      (use_whole_blk || (blk_fw[1] <= 2 && blk_fw[2] <= 2 && blk_fw[3] <= 2)) &&
+      "subblock filter weight must be less than 2");
+
+  // Precompute the difference squared
+  for (row = 0; row < block_height; row++) {
+    for (blk_col = 0; blk_col < block_width; blk_col += 16) {
+      store_dist_16(y_src_ptr + blk_col, y_pre_ptr + blk_col,
+                    y_dist_ptr + blk_col);
+    }
+    y_src_ptr += y_src_stride;
+    y_pre_ptr += y_pre_stride;
+    y_dist_ptr += DIST_STRIDE;
+  }
+
+  for (row = 0; row < chroma_height; row++) {
+    for (blk_col = 0; blk_col < chroma_width; blk_col += 8) {
+      store_dist_8_uv(u_src_ptr + blk_col, u_pre_ptr + blk_col,
+                      v_src_ptr + blk_col, v_pre_ptr + blk_col,
+                      u_dist_ptr + blk_col, v_dist_ptr + blk_col);
+    }
+
+    u_src_ptr += uv_src_stride;
+    u_pre_ptr += uv_pre_stride;
+    u_dist_ptr += DIST_STRIDE;
+    v_src_ptr += uv_src_stride;
+    v_pre_ptr += uv_pre_stride;
+    v_dist_ptr += DIST_STRIDE;
+  }
+
+  y_dist_ptr = y_dist + 1;
+  u_dist_ptr = u_dist + 1;
+  v_dist_ptr = v_dist + 1;
+
+  vp9_apply_temporal_filter_luma(y_pre, y_pre_stride, block_width,
+                                 block_height, ss_x, ss_y, strength, blk_fw,
+                                 use_whole_blk, y_accum, y_count, y_dist_ptr,
+                                 u_dist_ptr, v_dist_ptr);
+
+  vp9_apply_temporal_filter_chroma(
+      u_pre, v_pre, uv_pre_stride, block_width, block_height, ss_x, ss_y,
+      strength, blk_fw, use_whole_blk, u_accum, u_count, v_accum, v_count,
+      y_dist_ptr, u_dist_ptr, v_dist_ptr);
+}
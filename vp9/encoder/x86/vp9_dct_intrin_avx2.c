@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <immintrin.h>  // AVX2
+
+#include "./vp9_rtcd.h"
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_dsp/txfm_common.h"
+#include "vpx_dsp/x86/fwd_txfm_avx2.h"
+#include "vpx_dsp/x86/fwd_txfm_sse2.h"
+#include "vpx_dsp/x86/transpose_avx2.h"
+#include "vpx_ports/mem.h"
+
+#define pair256_set_epi16(a, b)                                            \
+  _mm256_set_epi16((int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a), \
+                   (int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a), \
+                   (int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a), \
+                   (int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a))
+
+static INLINE void load_buffer_16x16(const int16_t *input, __m256i *in,
+                                     int stride) {
+  int i;
+  for (i = 0; i < 16; ++i) {
+    in[i] = _mm256_loadu_si256((const __m256i *)(input + i * stride));
+    in[i] = _mm256_slli_epi16(in[i], 2);
+  }
+}
+
+static INLINE void write_buffer_16x16(tran_low_t *output, __m256i *in) {
+  int i;
+  for (i = 0; i < 16; ++i) {
+    const __m128i lo = _mm256_castsi256_si128(in[i]);
+    const __m128i hi = _mm256_extracti128_si256(in[i], 1);
+    store_output(&lo, output + i * 16);
+    store_output(&hi, output + i * 16 + 8);
+  }
+}
+
+#define DCT_HIGH_BIT_DEPTH 0
+#define FHT16x16_AVX2 vp9_fht16x16_avx2
+#define FDCT16x16_2D vpx_fdct16x16_sse2
+#define FDCT16_AVX2 fdct16_avx2
+#define FADST16_AVX2 fadst16_avx2
+#define RIGHT_SHIFT_16x16 right_shift_16x16
+#include "vp9/encoder/x86/vp9_fht16x16_impl_avx2.h"
+#undef FHT16x16_AVX2
+#undef FDCT16x16_2D
+#undef FDCT16_AVX2
+#undef FADST16_AVX2
+#undef RIGHT_SHIFT_16x16
+#undef DCT_HIGH_BIT_DEPTH
+
+#if CONFIG_VP9_HIGHBITDEPTH
+#define DCT_HIGH_BIT_DEPTH 1
+#define FHT16x16_AVX2 vp9_highbd_fht16x16_avx2
+#define FDCT16x16_2D vpx_highbd_fdct16x16_sse2
+#define FDCT16_AVX2 highbd_fdct16_avx2
+#define FADST16_AVX2 highbd_fadst16_avx2
+#define RIGHT_SHIFT_16x16 highbd_right_shift_16x16
+#include "vp9/encoder/x86/vp9_fht16x16_impl_avx2.h"  // NOLINT
+#undef FHT16x16_AVX2
+#undef FDCT16x16_2D
+#undef FDCT16_AVX2
+#undef FADST16_AVX2
+#undef RIGHT_SHIFT_16x16
+#undef DCT_HIGH_BIT_DEPTH
+#endif  // CONFIG_VP9_HIGHBITDEPTH
@@ -0,0 +1,904 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// The 16x16 hybrid transforms hold a whole row (or column, after the
+// transpose) of the block in each register, so each 1-D transform is done in
+// a single pass. Every operation is local to a 128 bit lane, so the arithmetic
+// is the same as the SSE2 8 column version. This file is included by
+// vp9_dct_intrin_avx2.c, which provides the load and store helpers.
+//
+// With DCT_HIGH_BIT_DEPTH the 16 bit adds, subtracts and packs saturate and
+// record the largest magnitude. The 32 bit sums cannot overflow for any 16
+// bit input, so a block whose 16 bit intermediates never saturate matches the
+// C transform, and the others are redone in C.
+
+#if DCT_HIGH_BIT_DEPTH
+#define ADD_EPI16(a, b) adds_epi16_overflow_avx2(a, b, &overflow)
+#define SUB_EPI16(a, b) subs_epi16_overflow_avx2(a, b, &overflow)
+#define PACKS_EPI32(a, b) packs_epi32_overflow_avx2(a, b, &overflow)
+#else
+#define ADD_EPI16 _mm256_add_epi16
+#define SUB_EPI16 _mm256_sub_epi16
+#define PACKS_EPI32 _mm256_packs_epi32
+#endif  // DCT_HIGH_BIT_DEPTH
+
+// right shift and rounding
+static INLINE int RIGHT_SHIFT_16x16(__m256i *res) {
+#if DCT_HIGH_BIT_DEPTH
+  __m256i overflow = _mm256_setzero_si256();
+#endif  // DCT_HIGH_BIT_DEPTH
+  const __m256i const_rounding = _mm256_set1_epi16(1);
+  int i;
+  for (i = 0; i < 16; ++i) {
+    const __m256i sign = _mm256_srai_epi16(res[i], 15);
+    res[i] = ADD_EPI16(res[i], const_rounding);
+    res[i] = SUB_EPI16(res[i], sign);
+    res[i] = _mm256_srai_epi16(res[i], 2);
+  }
+#if DCT_HIGH_BIT_DEPTH
+  return has_overflow_avx2(overflow);
+#else
+  return 0;
+#endif  // DCT_HIGH_BIT_DEPTH
+}
+
+static int FDCT16_AVX2(__m256i *in) {
+  // perform 16x16 1-D DCT for 16 columns
+  __m256i i[8], s[8], p[8], t[8], u[16], v[16];
+#if DCT_HIGH_BIT_DEPTH
+  __m256i overflow = _mm256_setzero_si256();
+#endif  // DCT_HIGH_BIT_DEPTH
+  const __m256i k__cospi_p16_p16 = _mm256_set1_epi16(cospi_16_64);
+  const __m256i k__cospi_p16_m16 = pair256_set_epi16(cospi_16_64, -cospi_16_64);
+  const __m256i k__cospi_m16_p16 = pair256_set_epi16(-cospi_16_64, cospi_16_64);
+  const __m256i k__cospi_p24_p08 = pair256_set_epi16(cospi_24_64, cospi_8_64);
+  const __m256i k__cospi_p08_m24 = pair256_set_epi16(cospi_8_64, -cospi_24_64);
+  const __m256i k__cospi_m08_p24 = pair256_set_epi16(-cospi_8_64, cospi_24_64);
+  const __m256i k__cospi_p28_p04 = pair256_set_epi16(cospi_28_64, cospi_4_64);
+  const __m256i k__cospi_m04_p28 = pair256_set_epi16(-cospi_4_64, cospi_28_64);
+  const __m256i k__cospi_p12_p20 = pair256_set_epi16(cospi_12_64, cospi_20_64);
+  const __m256i k__cospi_m20_p12 = pair256_set_epi16(-cospi_20_64, cospi_12_64);
+  const __m256i k__cospi_p30_p02 = pair256_set_epi16(cospi_30_64, cospi_2_64);
+  const __m256i k__cospi_p14_p18 = pair256_set_epi16(cospi_14_64, cospi_18_64);
+  const __m256i k__cospi_m02_p30 = pair256_set_epi16(-cospi_2_64, cospi_30_64);
+  const __m256i k__cospi_m18_p14 = pair256_set_epi16(-cospi_18_64, cospi_14_64);
+  const __m256i k__cospi_p22_p10 = pair256_set_epi16(cospi_22_64, cospi_10_64);
+  const __m256i k__cospi_p06_p26 = pair256_set_epi16(cospi_6_64, cospi_26_64);
+  const __m256i k__cospi_m10_p22 = pair256_set_epi16(-cospi_10_64, cospi_22_64);
+  const __m256i k__cospi_m26_p06 = pair256_set_epi16(-cospi_26_64, cospi_6_64);
+  const __m256i k__DCT_CONST_ROUNDING = _mm256_set1_epi32(DCT_CONST_ROUNDING);
+
+  // stage 1
+  i[0] = ADD_EPI16(in[0], in[15]);
+  i[1] = ADD_EPI16(in[1], in[14]);
+  i[2] = ADD_EPI16(in[2], in[13]);
+  i[3] = ADD_EPI16(in[3], in[12]);
+  i[4] = ADD_EPI16(in[4], in[11]);
+  i[5] = ADD_EPI16(in[5], in[10]);
+  i[6] = ADD_EPI16(in[6], in[9]);
+  i[7] = ADD_EPI16(in[7], in[8]);
+
+  s[0] = SUB_EPI16(in[7], in[8]);
+  s[1] = SUB_EPI16(in[6], in[9]);
+  s[2] = SUB_EPI16(in[5], in[10]);
+  s[3] = SUB_EPI16(in[4], in[11]);
+  s[4] = SUB_EPI16(in[3], in[12]);
+  s[5] = SUB_EPI16(in[2], in[13]);
+  s[6] = SUB_EPI16(in[1], in[14]);
+  s[7] = SUB_EPI16(in[0], in[15]);
+
+  p[0] = ADD_EPI16(i[0], i[7]);
+  p[1] = ADD_EPI16(i[1], i[6]);
+  p[2] = ADD_EPI16(i[2], i[5]);
+  p[3] = ADD_EPI16(i[3], i[4]);
+  p[4] = SUB_EPI16(i[3], i[4]);
+  p[5] = SUB_EPI16(i[2], i[5]);
+  p[6] = SUB_EPI16(i[1], i[6]);
+  p[7] = SUB_EPI16(i[0], i[7]);
+
+  u[0] = ADD_EPI16(p[0], p[3]);
+  u[1] = ADD_EPI16(p[1], p[2]);
+  u[2] = SUB_EPI16(p[1], p[2]);
+  u[3] = SUB_EPI16(p[0], p[3]);
+
+  v[0] = _mm256_unpacklo_epi16(u[0], u[1]);
+  v[1] = _mm256_unpackhi_epi16(u[0], u[1]);
+  v[2] = _mm256_unpacklo_epi16(u[2], u[3]);
+  v[3] = _mm256_unpackhi_epi16(u[2], u[3]);
+
+  u[0] = _mm256_madd_epi16(v[0], k__cospi_p16_p16);
+  u[1] = _mm256_madd_epi16(v[1], k__cospi_p16_p16);
+  u[2] = _mm256_madd_epi16(v[0], k__cospi_p16_m16);
+  u[3] = _mm256_madd_epi16(v[1], k__cospi_p16_m16);
+  u[4] = _mm256_madd_epi16(v[2], k__cospi_p24_p08);
+  u[5] = _mm256_madd_epi16(v[3], k__cospi_p24_p08);
+  u[6] = _mm256_madd_epi16(v[2], k__cospi_m08_p24);
+  u[7] = _mm256_madd_epi16(v[3], k__cospi_m08_p24);
+
+  v[0] = _mm256_add_epi32(u[0], k__DCT_CONST_ROUNDING);
+  v[1] = _mm256_add_epi32(u[1], k__DCT_CONST_ROUNDING);
+  v[2] = _mm256_add_epi32(u[2], k__DCT_CONST_ROUNDING);
+  v[3] = _mm256_add_epi32(u[3], k__DCT_CONST_ROUNDING);
+  v[4] = _mm256_add_epi32(u[4], k__DCT_CONST_ROUNDING);
+  v[5] = _mm256_add_epi32(u[5], k__DCT_CONST_ROUNDING);
+  v[6] = _mm256_add_epi32(u[6], k__DCT_CONST_ROUNDING);
+  v[7] = _mm256_add_epi32(u[7], k__DCT_CONST_ROUNDING);
+
+  u[0] = _mm256_srai_epi32(v[0], DCT_CONST_BITS);
+  u[1] = _mm256_srai_epi32(v[1], DCT_CONST_BITS);
+  u[2] = _mm256_srai_epi32(v[2], DCT_CONST_BITS);
+  u[3] = _mm256_srai_epi32(v[3], DCT_CONST_BITS);
+  u[4] = _mm256_srai_epi32(v[4], DCT_CONST_BITS);
+  u[5] = _mm256_srai_epi32(v[5], DCT_CONST_BITS);
+  u[6] = _mm256_srai_epi32(v[6], DCT_CONST_BITS);
+  u[7] = _mm256_srai_epi32(v[7], DCT_CONST_BITS);
+
+  in[0] = PACKS_EPI32(u[0], u[1]);
+  in[4] = PACKS_EPI32(u[4], u[5]);
+  in[8] = PACKS_EPI32(u[2], u[3]);
+  in[12] = PACKS_EPI32(u[6], u[7]);
+
+  u[0] = _mm256_unpacklo_epi16(p[5], p[6]);
+  u[1] = _mm256_unpackhi_epi16(p[5], p[6]);
+  v[0] = _mm256_madd_epi16(u[0], k__cospi_m16_p16);
+  v[1] = _mm256_madd_epi16(u[1], k__cospi_m16_p16);
+  v[2] = _mm256_madd_epi16(u[0], k__cospi_p16_p16);
+  v[3] = _mm256_madd_epi16(u[1], k__cospi_p16_p16);
+
+  u[0] = _mm256_add_epi32(v[0], k__DCT_CONST_ROUNDING);
+  u[1] = _mm256_add_epi32(v[1], k__DCT_CONST_ROUNDING);
+  u[2] = _mm256_add_epi32(v[2], k__DCT_CONST_ROUNDING);
+  u[3] = _mm256_add_epi32(v[3], k__DCT_CONST_ROUNDING);
+
+  v[0] = _mm256_srai_epi32(u[0], DCT_CONST_BITS);
+  v[1] = _mm256_srai_epi32(u[1], DCT_CONST_BITS);
+  v[2] = _mm256_srai_epi32(u[2], DCT_CONST_BITS);
+  v[3] = _mm256_srai_epi32(u[3], DCT_CONST_BITS);
+
+  u[0] = PACKS_EPI32(v[0], v[1]);
+  u[1] = PACKS_EPI32(v[2], v[3]);
+
+  t[0] = ADD_EPI16(p[4], u[0]);
+  t[1] = SUB_EPI16(p[4], u[0]);
+  t[2] = SUB_EPI16(p[7], u[1]);
+  t[3] = ADD_EPI16(p[7], u[1]);
+
+  u[0] = _mm256_unpacklo_epi16(t[0], t[3]);
+  u[1] = _mm256_unpackhi_epi16(t[0], t[3]);
+  u[2] = _mm256_unpacklo_epi16(t[1], t[2]);
+  u[3] = _mm256_unpackhi_epi16(t[1], t[2]);
+
+  v[0] = _mm256_madd_epi16(u[0], k__cospi_p28_p04);
+  v[1] = _mm256_madd_epi16(u[1], k__cospi_p28_p04);
+  v[2] = _mm256_madd_epi16(u[2], k__cospi_p12_p20);
+  v[3] = _mm256_madd_epi16(u[3], k__cospi_p12_p20);
+  v[4] = _mm256_madd_epi16(u[2], k__cospi_m20_p12);
+  v[5] = _mm256_madd_epi16(u[3], k__cospi_m20_p12);
+  v[6] = _mm256_madd_epi16(u[0], k__cospi_m04_p28);
+  v[7] = _mm256_madd_epi16(u[1], k__cospi_m04_p28);
+
+  u[0] = _mm256_add_epi32(v[0], k__DCT_CONST_ROUNDING);
+  u[1] = _mm256_add_epi32(v[1], k__DCT_CONST_ROUNDING);
+  u[2] = _mm256_add_epi32(v[2], k__DCT_CONST_ROUNDING);
+  u[3] = _mm256_add_epi32(v[3], k__DCT_CONST_ROUNDING);
+  u[4] = _mm256_add_epi32(v[4], k__DCT_CONST_ROUNDING);
+  u[5] = _mm256_add_epi32(v[5], k__DCT_CONST_ROUNDING);
+  u[6] = _mm256_add_epi32(v[6], k__DCT_CONST_ROUNDING);
+  u[7] = _mm256_add_epi32(v[7], k__DCT_CONST_ROUNDING);
+
+  v[0] = _mm256_srai_epi32(u[0], DCT_CONST_BITS);
+  v[1] = _mm256_srai_epi32(u[1], DCT_CONST_BITS);
+  v[2] = _mm256_srai_epi32(u[2], DCT_CONST_BITS);
+  v[3] = _mm256_srai_epi32(u[3], DCT_CONST_BITS);
+  v[4] = _mm256_srai_epi32(u[4], DCT_CONST_BITS);
+  v[5] = _mm256_srai_epi32(u[5], DCT_CONST_BITS);
+  v[6] = _mm256_srai_epi32(u[6], DCT_CONST_BITS);
+  v[7] = _mm256_srai_epi32(u[7], DCT_CONST_BITS);
+
+  in[2] = PACKS_EPI32(v[0], v[1]);
+  in[6] = PACKS_EPI32(v[4], v[5]);
+  in[10] = PACKS_EPI32(v[2], v[3]);
+  in[14] = PACKS_EPI32(v[6], v[7]);
+
+  // stage 2
+  u[0] = _mm256_unpacklo_epi16(s[2], s[5]);
+  u[1] = _mm256_unpackhi_epi16(s[2], s[5]);
+  u[2] = _mm256_unpacklo_epi16(s[3], s[4]);
+  u[3] = _mm256_unpackhi_epi16(s[3], s[4]);
+
+  v[0] = _mm256_madd_epi16(u[0], k__cospi_m16_p16);
+  v[1] = _mm256_madd_epi16(u[1], k__cospi_m16_p16);
+  v[2] = _mm256_madd_epi16(u[2], k__cospi_m16_p16);
+  v[3] = _mm256_madd_epi16(u[3], k__cospi_m16_p16);
+  v[4] = _mm256_madd_epi16(u[2], k__cospi_p16_p16);
+  v[5] = _mm256_madd_epi16(u[3], k__cospi_p16_p16);
+  v[6] = _mm256_madd_epi16(u[0], k__cospi_p16_p16);
+  v[7] = _mm256_madd_epi16(u[1], k__cospi_p16_p16);
+
+  u[0] = _mm256_add_epi32(v[0], k__DCT_CONST_ROUNDING);
+  u[1] = _mm256_add_epi32(v[1], k__DCT_CONST_ROUNDING);
+  u[2] = _mm256_add_epi32(v[2], k__DCT_CONST_ROUNDING);
+  u[3] = _mm256_add_epi32(v[3], k__DCT_CONST_ROUNDING);
+  u[4] = _mm256_add_epi32(v[4], k__DCT_CONST_ROUNDING);
+  u[5] = _mm256_add_epi32(v[5], k__DCT_CONST_ROUNDING);
+  u[6] = _mm256_add_epi32(v[6], k__DCT_CONST_ROUNDING);
+  u[7] = _mm256_add_epi32(v[7], k__DCT_CONST_ROUNDING);
+
+  v[0] = _mm256_srai_epi32(u[0], DCT_CONST_BITS);
+  v[1] = _mm256_srai_epi32(u[1], DCT_CONST_BITS);
+  v[2] = _mm256_srai_epi32(u[2], DCT_CONST_BITS);
+  v[3] = _mm256_srai_epi32(u[3], DCT_CONST_BITS);
+  v[4] = _mm256_srai_epi32(u[4], DCT_CONST_BITS);
+  v[5] = _mm256_srai_epi32(u[5], DCT_CONST_BITS);
+  v[6] = _mm256_srai_epi32(u[6], DCT_CONST_BITS);
+  v[7] = _mm256_srai_epi32(u[7], DCT_CONST_BITS);
+
+  t[2] = PACKS_EPI32(v[0], v[1]);
+  t[3] = PACKS_EPI32(v[2], v[3]);
+  t[4] = PACKS_EPI32(v[4], v[5]);
+  t[5] = PACKS_EPI32(v[6], v[7]);
+
+  // stage 3
+  p[0] = ADD_EPI16(s[0], t[3]);
+  p[1] = ADD_EPI16(s[1], t[2]);
+  p[2] = SUB_EPI16(s[1], t[2]);
+  p[3] = SUB_EPI16(s[0], t[3]);
+  p[4] = SUB_EPI16(s[7], t[4]);
+  p[5] = SUB_EPI16(s[6], t[5]);
+  p[6] = ADD_EPI16(s[6], t[5]);
+  p[7] = ADD_EPI16(s[7], t[4]);
+
+  // stage 4
+  u[0] = _mm256_unpacklo_epi16(p[1], p[6]);
+  u[1] = _mm256_unpackhi_epi16(p[1], p[6]);
+  u[2] = _mm256_unpacklo_epi16(p[2], p[5]);
+  u[3] = _mm256_unpackhi_epi16(p[2], p[5]);
+
+  v[0] = _mm256_madd_epi16(u[0], k__cospi_m08_p24);
+  v[1] = _mm256_madd_epi16(u[1], k__cospi_m08_p24);
+  v[2] = _mm256_madd_epi16(u[2], k__cospi_p24_p08);
+  v[3] = _mm256_madd_epi16(u[3], k__cospi_p24_p08);
+  v[4] = _mm256_madd_epi16(u[2], k__cospi_p08_m24);
+  v[5] = _mm256_madd_epi16(u[3], k__cospi_p08_m24);
+  v[6] = _mm256_madd_epi16(u[0], k__cospi_p24_p08);
+  v[7] = _mm256_madd_epi16(u[1], k__cospi_p24_p08);
+
+  u[0] = _mm256_add_epi32(v[0], k__DCT_CONST_ROUNDING);
+  u[1] = _mm256_add_epi32(v[1], k__DCT_CONST_ROUNDING);
+  u[2] = _mm256_add_epi32(v[2], k__DCT_CONST_ROUNDING);
+  u[3] = _mm256_add_epi32(v[3], k__DCT_CONST_ROUNDING);
+  u[4] = _mm256_add_epi32(v[4], k__DCT_CONST_ROUNDING);
+  u[5] = _mm256_add_epi32(v[5], k__DCT_CONST_ROUNDING);
+  u[6] = _mm256_add_epi32(v[6], k__DCT_CONST_ROUNDING);
+  u[7] = _mm256_add_epi32(v[7], k__DCT_CONST_ROUNDING);
+
+  v[0] = _mm256_srai_epi32(u[0], DCT_CONST_BITS);
+  v[1] = _mm256_srai_epi32(u[1], DCT_CONST_BITS);
+  v[2] = _mm256_srai_epi32(u[2], DCT_CONST_BITS);
+  v[3] = _mm256_srai_epi32(u[3], DCT_CONST_BITS);
+  v[4] = _mm256_srai_epi32(u[4], DCT_CONST_BITS);
+  v[5] = _mm256_srai_epi32(u[5], DCT_CONST_BITS);
+  v[6] = _mm256_srai_epi32(u[6], DCT_CONST_BITS);
+  v[7] = _mm256_srai_epi32(u[7], DCT_CONST_BITS);
+
+  t[1] = PACKS_EPI32(v[0], v[1]);
+  t[2] = PACKS_EPI32(v[2], v[3]);
+  t[5] = PACKS_EPI32(v[4], v[5]);
+  t[6] = PACKS_EPI32(v[6], v[7]);
+
+  // stage 5
+  s[0] = ADD_EPI16(p[0], t[1]);
+  s[1] = SUB_EPI16(p[0], t[1]);
+  s[2] = ADD_EPI16(p[3], t[2]);
+  s[3] = SUB_EPI16(p[3], t[2]);
+  s[4] = SUB_EPI16(p[4], t[5]);
+  s[5] = ADD_EPI16(p[4], t[5]);
+  s[6] = SUB_EPI16(p[7], t[6]);
+  s[7] = ADD_EPI16(p[7], t[6]);
+
+  // stage 6
+  u[0] = _mm256_unpacklo_epi16(s[0], s[7]);
+  u[1] = _mm256_unpackhi_epi16(s[0], s[7]);
+  u[2] = _mm256_unpacklo_epi16(s[1], s[6]);
+  u[3] = _mm256_unpackhi_epi16(s[1], s[6]);
+  u[4] = _mm256_unpacklo_epi16(s[2], s[5]);
+  u[5] = _mm256_unpackhi_epi16(s[2], s[5]);
+  u[6] = _mm256_unpacklo_epi16(s[3], s[4]);
+  u[7] = _mm256_unpackhi_epi16(s[3], s[4]);
+
+  v[0] = _mm256_madd_epi16(u[0], k__cospi_p30_p02);
+  v[1] = _mm256_madd_epi16(u[1], k__cospi_p30_p02);
+  v[2] = _mm256_madd_epi16(u[2], k__cospi_p14_p18);
+  v[3] = _mm256_madd_epi16(u[3], k__cospi_p14_p18);
+  v[4] = _mm256_madd_epi16(u[4], k__cospi_p22_p10);
+  v[5] = _mm256_madd_epi16(u[5], k__cospi_p22_p10);
+  v[6] = _mm256_madd_epi16(u[6], k__cospi_p06_p26);
+  v[7] = _mm256_madd_epi16(u[7], k__cospi_p06_p26);
+  v[8] = _mm256_madd_epi16(u[6], k__cospi_m26_p06);
+  v[9] = _mm256_madd_epi16(u[7], k__cospi_m26_p06);
+  v[10] = _mm256_madd_epi16(u[4], k__cospi_m10_p22);
+  v[11] = _mm256_madd_epi16(u[5], k__cospi_m10_p22);
+  v[12] = _mm256_madd_epi16(u[2], k__cospi_m18_p14);
+  v[13] = _mm256_madd_epi16(u[3], k__cospi_m18_p14);
+  v[14] = _mm256_madd_epi16(u[0], k__cospi_m02_p30);
+  v[15] = _mm256_madd_epi16(u[1], k__cospi_m02_p30);
+
+  u[0] = _mm256_add_epi32(v[0], k__DCT_CONST_ROUNDING);
+  u[1] = _mm256_add_epi32(v[1], k__DCT_CONST_ROUNDING);
+  u[2] = _mm256_add_epi32(v[2], k__DCT_CONST_ROUNDING);
+  u[3] = _mm256_add_epi32(v[3], k__DCT_CONST_ROUNDING);
+  u[4] = _mm256_add_epi32(v[4], k__DCT_CONST_ROUNDING);
+  u[5] = _mm256_add_epi32(v[5], k__DCT_CONST_ROUNDING);
+  u[6] = _mm256_add_epi32(v[6], k__DCT_CONST_ROUNDING);
+  u[7] = _mm256_add_epi32(v[7], k__DCT_CONST_ROUNDING);
+  u[8] = _mm256_add_epi32(v[8], k__DCT_CONST_ROUNDING);
+  u[9] = _mm256_add_epi32(v[9], k__DCT_CONST_ROUNDING);
+  u[10] = _mm256_add_epi32(v[10], k__DCT_CONST_ROUNDING);
+  u[11] = _mm256_add_epi32(v[11], k__DCT_CONST_ROUNDING);
+  u[12] = _mm256_add_epi32(v[12], k__DCT_CONST_ROUNDING);
+  u[13] = _mm256_add_epi32(v[13], k__DCT_CONST_ROUNDING);
+  u[14] = _mm256_add_epi32(v[14], k__DCT_CONST_ROUNDING);
+  u[15] = _mm256_add_epi32(v[15], k__DCT_CONST_ROUNDING);
+
+  v[0] = _mm256_srai_epi32(u[0], DCT_CONST_BITS);
+  v[1] = _mm256_srai_epi32(u[1], DCT_CONST_BITS);
+  v[2] = _mm256_srai_epi32(u[2], DCT_CONST_BITS);
+  v[3] = _mm256_srai_epi32(u[3], DCT_CONST_BITS);
+  v[4] = _mm256_srai_epi32(u[4], DCT_CONST_BITS);
+  v[5] = _mm256_srai_epi32(u[5], DCT_CONST_BITS);
+  v[6] = _mm256_srai_epi32(u[6], DCT_CONST_BITS);
+  v[7] = _mm256_srai_epi32(u[7], DCT_CONST_BITS);
+  v[8] = _mm256_srai_epi32(u[8], DCT_CONST_BITS);
+  v[9] = _mm256_srai_epi32(u[9], DCT_CONST_BITS);
+  v[10] = _mm256_srai_epi32(u[10], DCT_CONST_BITS);
+  v[11] = _mm256_srai_epi32(u[11], DCT_CONST_BITS);
+  v[12] = _mm256_srai_epi32(u[12], DCT_CONST_BITS);
+  v[13] = _mm256_srai_epi32(u[13], DCT_CONST_BITS);
+  v[14] = _mm256_srai_epi32(u[14], DCT_CONST_BITS);
+  v[15] = _mm256_srai_epi32(u[15], DCT_CONST_BITS);
+
+  in[1] = PACKS_EPI32(v[0], v[1]);
+  in[9] = PACKS_EPI32(v[2], v[3]);
+  in[5] = PACKS_EPI32(v[4], v[5]);
+  in[13] = PACKS_EPI32(v[6], v[7]);
+  in[3] = PACKS_EPI32(v[8], v[9]);
+  in[11] = PACKS_EPI32(v[10], v[11]);
+  in[7] = PACKS_EPI32(v[12], v[13]);
+  in[15] = PACKS_EPI32(v[14], v[15]);
+#if DCT_HIGH_BIT_DEPTH
+  return has_overflow_avx2(overflow);
+#else
+  return 0;
+#endif  // DCT_HIGH_BIT_DEPTH
+}
+
+static int FADST16_AVX2(__m256i *in) {
+  // perform 16x16 1-D ADST for 16 columns
+  __m256i s[16], x[16], u[32], v[32];
+#if DCT_HIGH_BIT_DEPTH
+  __m256i overflow = _mm256_setzero_si256();
+#endif  // DCT_HIGH_BIT_DEPTH
+  const __m256i k__cospi_p01_p31 = pair256_set_epi16(cospi_1_64, cospi_31_64);
+  const __m256i k__cospi_p31_m01 = pair256_set_epi16(cospi_31_64, -cospi_1_64);
+  const __m256i k__cospi_p05_p27 = pair256_set_epi16(cospi_5_64, cospi_27_64);
+  const __m256i k__cospi_p27_m05 = pair256_set_epi16(cospi_27_64, -cospi_5_64);
+  const __m256i k__cospi_p09_p23 = pair256_set_epi16(cospi_9_64, cospi_23_64);
+  const __m256i k__cospi_p23_m09 = pair256_set_epi16(cospi_23_64, -cospi_9_64);
+  const __m256i k__cospi_p13_p19 = pair256_set_epi16(cospi_13_64, cospi_19_64);
+  const __m256i k__cospi_p19_m13 = pair256_set_epi16(cospi_19_64, -cospi_13_64);
+  const __m256i k__cospi_p17_p15 = pair256_set_epi16(cospi_17_64, cospi_15_64);
+  const __m256i k__cospi_p15_m17 = pair256_set_epi16(cospi_15_64, -cospi_17_64);
+  const __m256i k__cospi_p21_p11 = pair256_set_epi16(cospi_21_64, cospi_11_64);
+  const __m256i k__cospi_p11_m21 = pair256_set_epi16(cospi_11_64, -cospi_21_64);
+  const __m256i k__cospi_p25_p07 = pair256_set_epi16(cospi_25_64, cospi_7_64);
+  const __m256i k__cospi_p07_m25 = pair256_set_epi16(cospi_7_64, -cospi_25_64);
+  const __m256i k__cospi_p29_p03 = pair256_set_epi16(cospi_29_64, cospi_3_64);
+  const __m256i k__cospi_p03_m29 = pair256_set_epi16(cospi_3_64, -cospi_29_64);
+  const __m256i k__cospi_p04_p28 = pair256_set_epi16(cospi_4_64, cospi_28_64);
+  const __m256i k__cospi_p28_m04 = pair256_set_epi16(cospi_28_64, -cospi_4_64);
+  const __m256i k__cospi_p20_p12 = pair256_set_epi16(cospi_20_64, cospi_12_64);
+  const __m256i k__cospi_p12_m20 = pair256_set_epi16(cospi_12_64, -cospi_20_64);
+  const __m256i k__cospi_m28_p04 = pair256_set_epi16(-cospi_28_64, cospi_4_64);
+  const __m256i k__cospi_m12_p20 = pair256_set_epi16(-cospi_12_64, cospi_20_64);
+  const __m256i k__cospi_p08_p24 = pair256_set_epi16(cospi_8_64, cospi_24_64);
+  const __m256i k__cospi_p24_m08 = pair256_set_epi16(cospi_24_64, -cospi_8_64);
+  const __m256i k__cospi_m24_p08 = pair256_set_epi16(-cospi_24_64, cospi_8_64);
+  const __m256i k__cospi_m16_m16 = _mm256_set1_epi16(-cospi_16_64);
+  const __m256i k__cospi_p16_p16 = _mm256_set1_epi16(cospi_16_64);
+  const __m256i k__cospi_p16_m16 = pair256_set_epi16(cospi_16_64, -cospi_16_64);
+  const __m256i k__cospi_m16_p16 = pair256_set_epi16(-cospi_16_64, cospi_16_64);
+  const __m256i k__DCT_CONST_ROUNDING = _mm256_set1_epi32(DCT_CONST_ROUNDING);
+  const __m256i kZero = _mm256_set1_epi16(0);
+
+  u[0] = _mm256_unpacklo_epi16(in[15], in[0]);
+  u[1] = _mm256_unpackhi_epi16(in[15], in[0]);
+  u[2] = _mm256_unpacklo_epi16(in[13], in[2]);
+  u[3] = _mm256_unpackhi_epi16(in[13], in[2]);
+  u[4] = _mm256_unpacklo_epi16(in[11], in[4]);
+  u[5] = _mm256_unpackhi_epi16(in[11], in[4]);
+  u[6] = _mm256_unpacklo_epi16(in[9], in[6]);
+  u[7] = _mm256_unpackhi_epi16(in[9], in[6]);
+  u[8] = _mm256_unpacklo_epi16(in[7], in[8]);
+  u[9] = _mm256_unpackhi_epi16(in[7], in[8]);
+  u[10] = _mm256_unpacklo_epi16(in[5], in[10]);
+  u[11] = _mm256_unpackhi_epi16(in[5], in[10]);
+  u[12] = _mm256_unpacklo_epi16(in[3], in[12]);
+  u[13] = _mm256_unpackhi_epi16(in[3], in[12]);
+  u[14] = _mm256_unpacklo_epi16(in[1], in[14]);
+  u[15] = _mm256_unpackhi_epi16(in[1], in[14]);
+
+  v[0] = _mm256_madd_epi16(u[0], k__cospi_p01_p31);
+  v[1] = _mm256_madd_epi16(u[1], k__cospi_p01_p31);
+  v[2] = _mm256_madd_epi16(u[0], k__cospi_p31_m01);
+  v[3] = _mm256_madd_epi16(u[1], k__cospi_p31_m01);
+  v[4] = _mm256_madd_epi16(u[2], k__cospi_p05_p27);
+  v[5] = _mm256_madd_epi16(u[3], k__cospi_p05_p27);
+  v[6] = _mm256_madd_epi16(u[2], k__cospi_p27_m05);
+  v[7] = _mm256_madd_epi16(u[3], k__cospi_p27_m05);
+  v[8] = _mm256_madd_epi16(u[4], k__cospi_p09_p23);
+  v[9] = _mm256_madd_epi16(u[5], k__cospi_p09_p23);
+  v[10] = _mm256_madd_epi16(u[4], k__cospi_p23_m09);
+  v[11] = _mm256_madd_epi16(u[5], k__cospi_p23_m09);
+  v[12] = _mm256_madd_epi16(u[6], k__cospi_p13_p19);
+  v[13] = _mm256_madd_epi16(u[7], k__cospi_p13_p19);
+  v[14] = _mm256_madd_epi16(u[6], k__cospi_p19_m13);
+  v[15] = _mm256_madd_epi16(u[7], k__cospi_p19_m13);
+  v[16] = _mm256_madd_epi16(u[8], k__cospi_p17_p15);
+  v[17] = _mm256_madd_epi16(u[9], k__cospi_p17_p15);
+  v[18] = _mm256_madd_epi16(u[8], k__cospi_p15_m17);
+  v[19] = _mm256_madd_epi16(u[9], k__cospi_p15_m17);
+  v[20] = _mm256_madd_epi16(u[10], k__cospi_p21_p11);
+  v[21] = _mm256_madd_epi16(u[11], k__cospi_p21_p11);
+  v[22] = _mm256_madd_epi16(u[10], k__cospi_p11_m21);
+  v[23] = _mm256_madd_epi16(u[11], k__cospi_p11_m21);
+  v[24] = _mm256_madd_epi16(u[12], k__cospi_p25_p07);
+  v[25] = _mm256_madd_epi16(u[13], k__cospi_p25_p07);
+  v[26] = _mm256_madd_epi16(u[12], k__cospi_p07_m25);
+  v[27] = _mm256_madd_epi16(u[13], k__cospi_p07_m25);
+  v[28] = _mm256_madd_epi16(u[14], k__cospi_p29_p03);
+  v[29] = _mm256_madd_epi16(u[15], k__cospi_p29_p03);
+  v[30] = _mm256_madd_epi16(u[14], k__cospi_p03_m29);
+  v[31] = _mm256_madd_epi16(u[15], k__cospi_p03_m29);
+
+  u[0] = _mm256_add_epi32(v[0], v[16]);
+  u[1] = _mm256_add_epi32(v[1], v[17]);
+  u[2] = _mm256_add_epi32(v[2], v[18]);
+  u[3] = _mm256_add_epi32(v[3], v[19]);
+  u[4] = _mm256_add_epi32(v[4], v[20]);
+  u[5] = _mm256_add_epi32(v[5], v[21]);
+  u[6] = _mm256_add_epi32(v[6], v[22]);
+  u[7] = _mm256_add_epi32(v[7], v[23]);
+  u[8] = _mm256_add_epi32(v[8], v[24]);
+  u[9] = _mm256_add_epi32(v[9], v[25]);
+  u[10] = _mm256_add_epi32(v[10], v[26]);
+  u[11] = _mm256_add_epi32(v[11], v[27]);
+  u[12] = _mm256_add_epi32(v[12], v[28]);
+  u[13] = _mm256_add_epi32(v[13], v[29]);
+  u[14] = _mm256_add_epi32(v[14], v[30]);
+  u[15] = _mm256_add_epi32(v[15], v[31]);
+  u[16] = _mm256_sub_epi32(v[0], v[16]);
+  u[17] = _mm256_sub_epi32(v[1], v[17]);
+  u[18] = _mm256_sub_epi32(v[2], v[18]);
+  u[19] = _mm256_sub_epi32(v[3], v[19]);
+  u[20] = _mm256_sub_epi32(v[4], v[20]);
+  u[21] = _mm256_sub_epi32(v[5], v[21]);
+  u[22] = _mm256_sub_epi32(v[6], v[22]);
+  u[23] = _mm256_sub_epi32(v[7], v[23]);
+  u[24] = _mm256_sub_epi32(v[8], v[24]);
+  u[25] = _mm256_sub_epi32(v[9], v[25]);
+  u[26] = _mm256_sub_epi32(v[10], v[26]);
+  u[27] = _mm256_sub_epi32(v[11], v[27]);
+  u[28] = _mm256_sub_epi32(v[12], v[28]);
+  u[29] = _mm256_sub_epi32(v[13], v[29]);
+  u[30] = _mm256_sub_epi32(v[14], v[30]);
+  u[31] = _mm256_sub_epi32(v[15], v[31]);
+
+  v[0] = _mm256_add_epi32(u[0], k__DCT_CONST_ROUNDING);
+  v[1] = _mm256_add_epi32(u[1], k__DCT_CONST_ROUNDING);
+  v[2] = _mm256_add_epi32(u[2], k__DCT_CONST_ROUNDING);
+  v[3] = _mm256_add_epi32(u[3], k__DCT_CONST_ROUNDING);
+  v[4] = _mm256_add_epi32(u[4], k__DCT_CONST_ROUNDING);
+  v[5] = _mm256_add_epi32(u[5], k__DCT_CONST_ROUNDING);
+  v[6] = _mm256_add_epi32(u[6], k__DCT_CONST_ROUNDING);
+  v[7] = _mm256_add_epi32(u[7], k__DCT_CONST_ROUNDING);
+  v[8] = _mm256_add_epi32(u[8], k__DCT_CONST_ROUNDING);
+  v[9] = _mm256_add_epi32(u[9], k__DCT_CONST_ROUNDING);
+  v[10] = _mm256_add_epi32(u[10], k__DCT_CONST_ROUNDING);
+  v[11] = _mm256_add_epi32(u[11], k__DCT_CONST_ROUNDING);
+  v[12] = _mm256_add_epi32(u[12], k__DCT_CONST_ROUNDING);
+  v[13] = _mm256_add_epi32(u[13], k__DCT_CONST_ROUNDING);
+  v[14] = _mm256_add_epi32(u[14], k__DCT_CONST_ROUNDING);
+  v[15] = _mm256_add_epi32(u[15], k__DCT_CONST_ROUNDING);
+  v[16] = _mm256_add_epi32(u[16], k__DCT_CONST_ROUNDING);
+  v[17] = _mm256_add_epi32(u[17], k__DCT_CONST_ROUNDING);
+  v[18] = _mm256_add_epi32(u[18], k__DCT_CONST_ROUNDING);
+  v[19] = _mm256_add_epi32(u[19], k__DCT_CONST_ROUNDING);
+  v[20] = _mm256_add_epi32(u[20], k__DCT_CONST_ROUNDING);
+  v[21] = _mm256_add_epi32(u[21], k__DCT_CONST_ROUNDING);
+  v[22] = _mm256_add_epi32(u[22], k__DCT_CONST_ROUNDING);
+  v[23] = _mm256_add_epi32(u[23], k__DCT_CONST_ROUNDING);
+  v[24] = _mm256_add_epi32(u[24], k__DCT_CONST_ROUNDING);
+  v[25] = _mm256_add_epi32(u[25], k__DCT_CONST_ROUNDING);
+  v[26] = _mm256_add_epi32(u[26], k__DCT_CONST_ROUNDING);
+  v[27] = _mm256_add_epi32(u[27], k__DCT_CONST_ROUNDING);
+  v[28] = _mm256_add_epi32(u[28], k__DCT_CONST_ROUNDING);
+  v[29] = _mm256_add_epi32(u[29], k__DCT_CONST_ROUNDING);
+  v[30] = _mm256_add_epi32(u[30], k__DCT_CONST_ROUNDING);
+  v[31] = _mm256_add_epi32(u[31], k__DCT_CONST_ROUNDING);
+
+  u[0] = _mm256_srai_epi32(v[0], DCT_CONST_BITS);
+  u[1] = _mm256_srai_epi32(v[1], DCT_CONST_BITS);
+  u[2] = _mm256_srai_epi32(v[2], DCT_CONST_BITS);
+  u[3] = _mm256_srai_epi32(v[3], DCT_CONST_BITS);
+  u[4] = _mm256_srai_epi32(v[4], DCT_CONST_BITS);
+  u[5] = _mm256_srai_epi32(v[5], DCT_CONST_BITS);
+  u[6] = _mm256_srai_epi32(v[6], DCT_CONST_BITS);
+  u[7] = _mm256_srai_epi32(v[7], DCT_CONST_BITS);
+  u[8] = _mm256_srai_epi32(v[8], DCT_CONST_BITS);
+  u[9] = _mm256_srai_epi32(v[9], DCT_CONST_BITS);
+  u[10] = _mm256_srai_epi32(v[10], DCT_CONST_BITS);
+  u[11] = _mm256_srai_epi32(v[11], DCT_CONST_BITS);
+  u[12] = _mm256_srai_epi32(v[12], DCT_CONST_BITS);
+  u[13] = _mm256_srai_epi32(v[13], DCT_CONST_BITS);
+  u[14] = _mm256_srai_epi32(v[14], DCT_CONST_BITS);
+  u[15] = _mm256_srai_epi32(v[15], DCT_CONST_BITS);
+  u[16] = _mm256_srai_epi32(v[16], DCT_CONST_BITS);
+  u[17] = _mm256_srai_epi32(v[17], DCT_CONST_BITS);
+  u[18] = _mm256_srai_epi32(v[18], DCT_CONST_BITS);
+  u[19] = _mm256_srai_epi32(v[19], DCT_CONST_BITS);
+  u[20] = _mm256_srai_epi32(v[20], DCT_CONST_BITS);
+  u[21] = _mm256_srai_epi32(v[21], DCT_CONST_BITS);
+  u[22] = _mm256_srai_epi32(v[22], DCT_CONST_BITS);
+  u[23] = _mm256_srai_epi32(v[23], DCT_CONST_BITS);
+  u[24] = _mm256_srai_epi32(v[24], DCT_CONST_BITS);
+  u[25] = _mm256_srai_epi32(v[25], DCT_CONST_BITS);
+  u[26] = _mm256_srai_epi32(v[26], DCT_CONST_BITS);
+  u[27] = _mm256_srai_epi32(v[27], DCT_CONST_BITS);
+  u[28] = _mm256_srai_epi32(v[28], DCT_CONST_BITS);
+  u[29] = _mm256_srai_epi32(v[29], DCT_CONST_BITS);
+  u[30] = _mm256_srai_epi32(v[30], DCT_CONST_BITS);
+  u[31] = _mm256_srai_epi32(v[31], DCT_CONST_BITS);
+
+  s[0] = PACKS_EPI32(u[0], u[1]);
+  s[1] = PACKS_EPI32(u[2], u[3]);
+  s[2] = PACKS_EPI32(u[4], u[5]);
+  s[3] = PACKS_EPI32(u[6], u[7]);
+  s[4] = PACKS_EPI32(u[8], u[9]);
+  s[5] = PACKS_EPI32(u[10], u[11]);
+  s[6] = PACKS_EPI32(u[12], u[13]);
+  s[7] = PACKS_EPI32(u[14], u[15]);
+  s[8] = PACKS_EPI32(u[16], u[17]);
+  s[9] = PACKS_EPI32(u[18], u[19]);
+  s[10] = PACKS_EPI32(u[20], u[21]);
+  s[11] = PACKS_EPI32(u[22], u[23]);
+  s[12] = PACKS_EPI32(u[24], u[25]);
+  s[13] = PACKS_EPI32(u[26], u[27]);
+  s[14] = PACKS_EPI32(u[28], u[29]);
+  s[15] = PACKS_EPI32(u[30], u[31]);
+
+  // stage 2
+  u[0] = _mm256_unpacklo_epi16(s[8], s[9]);
+  u[1] = _mm256_unpackhi_epi16(s[8], s[9]);
+  u[2] = _mm256_unpacklo_epi16(s[10], s[11]);
+  u[3] = _mm256_unpackhi_epi16(s[10], s[11]);
+  u[4] = _mm256_unpacklo_epi16(s[12], s[13]);
+  u[5] = _mm256_unpackhi_epi16(s[12], s[13]);
+  u[6] = _mm256_unpacklo_epi16(s[14], s[15]);
+  u[7] = _mm256_unpackhi_epi16(s[14], s[15]);
+
+  v[0] = _mm256_madd_epi16(u[0], k__cospi_p04_p28);
+  v[1] = _mm256_madd_epi16(u[1], k__cospi_p04_p28);
+  v[2] = _mm256_madd_epi16(u[0], k__cospi_p28_m04);
+  v[3] = _mm256_madd_epi16(u[1], k__cospi_p28_m04);
+  v[4] = _mm256_madd_epi16(u[2], k__cospi_p20_p12);
+  v[5] = _mm256_madd_epi16(u[3], k__cospi_p20_p12);
+  v[6] = _mm256_madd_epi16(u[2], k__cospi_p12_m20);
+  v[7] = _mm256_madd_epi16(u[3], k__cospi_p12_m20);
+  v[8] = _mm256_madd_epi16(u[4], k__cospi_m28_p04);
+  v[9] = _mm256_madd_epi16(u[5], k__cospi_m28_p04);
+  v[10] = _mm256_madd_epi16(u[4], k__cospi_p04_p28);
+  v[11] = _mm256_madd_epi16(u[5], k__cospi_p04_p28);
+  v[12] = _mm256_madd_epi16(u[6], k__cospi_m12_p20);
+  v[13] = _mm256_madd_epi16(u[7], k__cospi_m12_p20);
+  v[14] = _mm256_madd_epi16(u[6], k__cospi_p20_p12);
+  v[15] = _mm256_madd_epi16(u[7], k__cospi_p20_p12);
+
+  u[0] = _mm256_add_epi32(v[0], v[8]);
+  u[1] = _mm256_add_epi32(v[1], v[9]);
+  u[2] = _mm256_add_epi32(v[2], v[10]);
+  u[3] = _mm256_add_epi32(v[3], v[11]);
+  u[4] = _mm256_add_epi32(v[4], v[12]);
+  u[5] = _mm256_add_epi32(v[5], v[13]);
+  u[6] = _mm256_add_epi32(v[6], v[14]);
+  u[7] = _mm256_add_epi32(v[7], v[15]);
+  u[8] = _mm256_sub_epi32(v[0], v[8]);
+  u[9] = _mm256_sub_epi32(v[1], v[9]);
+  u[10] = _mm256_sub_epi32(v[2], v[10]);
+  u[11] = _mm256_sub_epi32(v[3], v[11]);
+  u[12] = _mm256_sub_epi32(v[4], v[12]);
+  u[13] = _mm256_sub_epi32(v[5], v[13]);
+  u[14] = _mm256_sub_epi32(v[6], v[14]);
+  u[15] = _mm256_sub_epi32(v[7], v[15]);
+
+  v[0] = _mm256_add_epi32(u[0], k__DCT_CONST_ROUNDING);
+  v[1] = _mm256_add_epi32(u[1], k__DCT_CONST_ROUNDING);
+  v[2] = _mm256_add_epi32(u[2], k__DCT_CONST_ROUNDING);
+  v[3] = _mm256_add_epi32(u[3], k__DCT_CONST_ROUNDING);
+  v[4] = _mm256_add_epi32(u[4], k__DCT_CONST_ROUNDING);
+  v[5] = _mm256_add_epi32(u[5], k__DCT_CONST_ROUNDING);
+  v[6] = _mm256_add_epi32(u[6], k__DCT_CONST_ROUNDING);
+  v[7] = _mm256_add_epi32(u[7], k__DCT_CONST_ROUNDING);
+  v[8] = _mm256_add_epi32(u[8], k__DCT_CONST_ROUNDING);
+  v[9] = _mm256_add_epi32(u[9], k__DCT_CONST_ROUNDING);
+  v[10] = _mm256_add_epi32(u[10], k__DCT_CONST_ROUNDING);
+  v[11] = _mm256_add_epi32(u[11], k__DCT_CONST_ROUNDING);
+  v[12] = _mm256_add_epi32(u[12], k__DCT_CONST_ROUNDING);
+  v[13] = _mm256_add_epi32(u[13], k__DCT_CONST_ROUNDING);
+  v[14] = _mm256_add_epi32(u[14], k__DCT_CONST_ROUNDING);
+  v[15] = _mm256_add_epi32(u[15], k__DCT_CONST_ROUNDING);
+
+  u[0] = _mm256_srai_epi32(v[0], DCT_CONST_BITS);
+  u[1] = _mm256_srai_epi32(v[1], DCT_CONST_BITS);
+  u[2] = _mm256_srai_epi32(v[2], DCT_CONST_BITS);
+  u[3] = _mm256_srai_epi32(v[3], DCT_CONST_BITS);
+  u[4] = _mm256_srai_epi32(v[4], DCT_CONST_BITS);
+  u[5] = _mm256_srai_epi32(v[5], DCT_CONST_BITS);
+  u[6] = _mm256_srai_epi32(v[6], DCT_CONST_BITS);
+  u[7] = _mm256_srai_epi32(v[7], DCT_CONST_BITS);
+  u[8] = _mm256_srai_epi32(v[8], DCT_CONST_BITS);
+  u[9] = _mm256_srai_epi32(v[9], DCT_CONST_BITS);
+  u[10] = _mm256_srai_epi32(v[10], DCT_CONST_BITS);
+  u[11] = _mm256_srai_epi32(v[11], DCT_CONST_BITS);
+  u[12] = _mm256_srai_epi32(v[12], DCT_CONST_BITS);
+  u[13] = _mm256_srai_epi32(v[13], DCT_CONST_BITS);
+  u[14] = _mm256_srai_epi32(v[14], DCT_CONST_BITS);
+  u[15] = _mm256_srai_epi32(v[15], DCT_CONST_BITS);
+
+  x[0] = ADD_EPI16(s[0], s[4]);
+  x[1] = ADD_EPI16(s[1], s[5]);
+  x[2] = ADD_EPI16(s[2], s[6]);
+  x[3] = ADD_EPI16(s[3], s[7]);
+  x[4] = SUB_EPI16(s[0], s[4]);
+  x[5] = SUB_EPI16(s[1], s[5]);
+  x[6] = SUB_EPI16(s[2], s[6]);
+  x[7] = SUB_EPI16(s[3], s[7]);
+  x[8] = PACKS_EPI32(u[0], u[1]);
+  x[9] = PACKS_EPI32(u[2], u[3]);
+  x[10] = PACKS_EPI32(u[4], u[5]);
+  x[11] = PACKS_EPI32(u[6], u[7]);
+  x[12] = PACKS_EPI32(u[8], u[9]);
+  x[13] = PACKS_EPI32(u[10], u[11]);
+  x[14] = PACKS_EPI32(u[12], u[13]);
+  x[15] = PACKS_EPI32(u[14], u[15]);
+
+  // stage 3
+  u[0] = _mm256_unpacklo_epi16(x[4], x[5]);
+  u[1] = _mm256_unpackhi_epi16(x[4], x[5]);
+  u[2] = _mm256_unpacklo_epi16(x[6], x[7]);
+  u[3] = _mm256_unpackhi_epi16(x[6], x[7]);
+  u[4] = _mm256_unpacklo_epi16(x[12], x[13]);
+  u[5] = _mm256_unpackhi_epi16(x[12], x[13]);
+  u[6] = _mm256_unpacklo_epi16(x[14], x[15]);
+  u[7] = _mm256_unpackhi_epi16(x[14], x[15]);
+
+  v[0] = _mm256_madd_epi16(u[0], k__cospi_p08_p24);
+  v[1] = _mm256_madd_epi16(u[1], k__cospi_p08_p24);
+  v[2] = _mm256_madd_epi16(u[0], k__cospi_p24_m08);
+  v[3] = _mm256_madd_epi16(u[1], k__cospi_p24_m08);
+  v[4] = _mm256_madd_epi16(u[2], k__cospi_m24_p08);
+  v[5] = _mm256_madd_epi16(u[3], k__cospi_m24_p08);
+  v[6] = _mm256_madd_epi16(u[2], k__cospi_p08_p24);
+  v[7] = _mm256_madd_epi16(u[3], k__cospi_p08_p24);
+  v[8] = _mm256_madd_epi16(u[4], k__cospi_p08_p24);
+  v[9] = _mm256_madd_epi16(u[5], k__cospi_p08_p24);
+  v[10] = _mm256_madd_epi16(u[4], k__cospi_p24_m08);
+  v[11] = _mm256_madd_epi16(u[5], k__cospi_p24_m08);
+  v[12] = _mm256_madd_epi16(u[6], k__cospi_m24_p08);
+  v[13] = _mm256_madd_epi16(u[7], k__cospi_m24_p08);
+  v[14] = _mm256_madd_epi16(u[6], k__cospi_p08_p24);
+  v[15] = _mm256_madd_epi16(u[7], k__cospi_p08_p24);
+
+  u[0] = _mm256_add_epi32(v[0], v[4]);
+  u[1] = _mm256_add_epi32(v[1], v[5]);
+  u[2] = _mm256_add_epi32(v[2], v[6]);
+  u[3] = _mm256_add_epi32(v[3], v[7]);
+  u[4] = _mm256_sub_epi32(v[0], v[4]);
+  u[5] = _mm256_sub_epi32(v[1], v[5]);
+  u[6] = _mm256_sub_epi32(v[2], v[6]);
+  u[7] = _mm256_sub_epi32(v[3], v[7]);
+  u[8] = _mm256_add_epi32(v[8], v[12]);
+  u[9] = _mm256_add_epi32(v[9], v[13]);
+  u[10] = _mm256_add_epi32(v[10], v[14]);
+  u[11] = _mm256_add_epi32(v[11], v[15]);
+  u[12] = _mm256_sub_epi32(v[8], v[12]);
+  u[13] = _mm256_sub_epi32(v[9], v[13]);
+  u[14] = _mm256_sub_epi32(v[10], v[14]);
+  u[15] = _mm256_sub_epi32(v[11], v[15]);
+
+  u[0] = _mm256_add_epi32(u[0], k__DCT_CONST_ROUNDING);
+  u[1] = _mm256_add_epi32(u[1], k__DCT_CONST_ROUNDING);
+  u[2] = _mm256_add_epi32(u[2], k__DCT_CONST_ROUNDING);
+  u[3] = _mm256_add_epi32(u[3], k__DCT_CONST_ROUNDING);
+  u[4] = _mm256_add_epi32(u[4], k__DCT_CONST_ROUNDING);
+  u[5] = _mm256_add_epi32(u[5], k__DCT_CONST_ROUNDING);
+  u[6] = _mm256_add_epi32(u[6], k__DCT_CONST_ROUNDING);
+  u[7] = _mm256_add_epi32(u[7], k__DCT_CONST_ROUNDING);
+  u[8] = _mm256_add_epi32(u[8], k__DCT_CONST_ROUNDING);
+  u[9] = _mm256_add_epi32(u[9], k__DCT_CONST_ROUNDING);
+  u[10] = _mm256_add_epi32(u[10], k__DCT_CONST_ROUNDING);
+  u[11] = _mm256_add_epi32(u[11], k__DCT_CONST_ROUNDING);
+  u[12] = _mm256_add_epi32(u[12], k__DCT_CONST_ROUNDING);
+  u[13] = _mm256_add_epi32(u[13], k__DCT_CONST_ROUNDING);
+  u[14] = _mm256_add_epi32(u[14], k__DCT_CONST_ROUNDING);
+  u[15] = _mm256_add_epi32(u[15], k__DCT_CONST_ROUNDING);
+
+  v[0] = _mm256_srai_epi32(u[0], DCT_CONST_BITS);
+  v[1] = _mm256_srai_epi32(u[1], DCT_CONST_BITS);
+  v[2] = _mm256_srai_epi32(u[2], DCT_CONST_BITS);
+  v[3] = _mm256_srai_epi32(u[3], DCT_CONST_BITS);
+  v[4] = _mm256_srai_epi32(u[4], DCT_CONST_BITS);
+  v[5] = _mm256_srai_epi32(u[5], DCT_CONST_BITS);
+  v[6] = _mm256_srai_epi32(u[6], DCT_CONST_BITS);
+  v[7] = _mm256_srai_epi32(u[7], DCT_CONST_BITS);
+  v[8] = _mm256_srai_epi32(u[8], DCT_CONST_BITS);
+  v[9] = _mm256_srai_epi32(u[9], DCT_CONST_BITS);
+  v[10] = _mm256_srai_epi32(u[10], DCT_CONST_BITS);
+  v[11] = _mm256_srai_epi32(u[11], DCT_CONST_BITS);
+  v[12] = _mm256_srai_epi32(u[12], DCT_CONST_BITS);
+  v[13] = _mm256_srai_epi32(u[13], DCT_CONST_BITS);
+  v[14] = _mm256_srai_epi32(u[14], DCT_CONST_BITS);
+  v[15] = _mm256_srai_epi32(u[15], DCT_CONST_BITS);
+
+  s[0] = ADD_EPI16(x[0], x[2]);
+  s[1] = ADD_EPI16(x[1], x[3]);
+  s[2] = SUB_EPI16(x[0], x[2]);
+  s[3] = SUB_EPI16(x[1], x[3]);
+  s[4] = PACKS_EPI32(v[0], v[1]);
+  s[5] = PACKS_EPI32(v[2], v[3]);
+  s[6] = PACKS_EPI32(v[4], v[5]);
+  s[7] = PACKS_EPI32(v[6], v[7]);
+  s[8] = ADD_EPI16(x[8], x[10]);
+  s[9] = ADD_EPI16(x[9], x[11]);
+  s[10] = SUB_EPI16(x[8], x[10]);
+  s[11] = SUB_EPI16(x[9], x[11]);
+  s[12] = PACKS_EPI32(v[8], v[9]);
+  s[13] = PACKS_EPI32(v[10], v[11]);
+  s[14] = PACKS_EPI32(v[12], v[13]);
+  s[15] = PACKS_EPI32(v[14], v[15]);
+
+  // stage 4
+  u[0] = _mm256_unpacklo_epi16(s[2], s[3]);
+  u[1] = _mm256_unpackhi_epi16(s[2], s[3]);
+  u[2] = _mm256_unpacklo_epi16(s[6], s[7]);
+  u[3] = _mm256_unpackhi_epi16(s[6], s[7]);
+  u[4] = _mm256_unpacklo_epi16(s[10], s[11]);
+  u[5] = _mm256_unpackhi_epi16(s[10], s[11]);
+  u[6] = _mm256_unpacklo_epi16(s[14], s[15]);
+  u[7] = _mm256_unpackhi_epi16(s[14], s[15]);
+
+  v[0] = _mm256_madd_epi16(u[0], k__cospi_m16_m16);
+  v[1] = _mm256_madd_epi16(u[1], k__cospi_m16_m16);
+  v[2] = _mm256_madd_epi16(u[0], k__cospi_p16_m16);
+  v[3] = _mm256_madd_epi16(u[1], k__cospi_p16_m16);
+  v[4] = _mm256_madd_epi16(u[2], k__cospi_p16_p16);
+  v[5] = _mm256_madd_epi16(u[3], k__cospi_p16_p16);
+  v[6] = _mm256_madd_epi16(u[2], k__cospi_m16_p16);
+  v[7] = _mm256_madd_epi16(u[3], k__cospi_m16_p16);
+  v[8] = _mm256_madd_epi16(u[4], k__cospi_p16_p16);
+  v[9] = _mm256_madd_epi16(u[5], k__cospi_p16_p16);
+  v[10] = _mm256_madd_epi16(u[4], k__cospi_m16_p16);
+  v[11] = _mm256_madd_epi16(u[5], k__cospi_m16_p16);
+  v[12] = _mm256_madd_epi16(u[6], k__cospi_m16_m16);
+  v[13] = _mm256_madd_epi16(u[7], k__cospi_m16_m16);
+  v[14] = _mm256_madd_epi16(u[6], k__cospi_p16_m16);
+  v[15] = _mm256_madd_epi16(u[7], k__cospi_p16_m16);
+
+  u[0] = _mm256_add_epi32(v[0], k__DCT_CONST_ROUNDING);
+  u[1] = _mm256_add_epi32(v[1], k__DCT_CONST_ROUNDING);
+  u[2] = _mm256_add_epi32(v[2], k__DCT_CONST_ROUNDING);
+  u[3] = _mm256_add_epi32(v[3], k__DCT_CONST_ROUNDING);
+  u[4] = _mm256_add_epi32(v[4], k__DCT_CONST_ROUNDING);
+  u[5] = _mm256_add_epi32(v[5], k__DCT_CONST_ROUNDING);
+  u[6] = _mm256_add_epi32(v[6], k__DCT_CONST_ROUNDING);
+  u[7] = _mm256_add_epi32(v[7], k__DCT_CONST_ROUNDING);
+  u[8] = _mm256_add_epi32(v[8], k__DCT_CONST_ROUNDING);
+  u[9] = _mm256_add_epi32(v[9], k__DCT_CONST_ROUNDING);
+  u[10] = _mm256_add_epi32(v[10], k__DCT_CONST_ROUNDING);
+  u[11] = _mm256_add_epi32(v[11], k__DCT_CONST_ROUNDING);
+  u[12] = _mm256_add_epi32(v[12], k__DCT_CONST_ROUNDING);
+  u[13] = _mm256_add_epi32(v[13], k__DCT_CONST_ROUNDING);
+  u[14] = _mm256_add_epi32(v[14], k__DCT_CONST_ROUNDING);
+  u[15] = _mm256_add_epi32(v[15], k__DCT_CONST_ROUNDING);
+
+  v[0] = _mm256_srai_epi32(u[0], DCT_CONST_BITS);
+  v[1] = _mm256_srai_epi32(u[1], DCT_CONST_BITS);
+  v[2] = _mm256_srai_epi32(u[2], DCT_CONST_BITS);
+  v[3] = _mm256_srai_epi32(u[3], DCT_CONST_BITS);
+  v[4] = _mm256_srai_epi32(u[4], DCT_CONST_BITS);
+  v[5] = _mm256_srai_epi32(u[5], DCT_CONST_BITS);
+  v[6] = _mm256_srai_epi32(u[6], DCT_CONST_BITS);
+  v[7] = _mm256_srai_epi32(u[7], DCT_CONST_BITS);
+  v[8] = _mm256_srai_epi32(u[8], DCT_CONST_BITS);
+  v[9] = _mm256_srai_epi32(u[9], DCT_CONST_BITS);
+  v[10] = _mm256_srai_epi32(u[10], DCT_CONST_BITS);
+  v[11] = _mm256_srai_epi32(u[11], DCT_CONST_BITS);
+  v[12] = _mm256_srai_epi32(u[12], DCT_CONST_BITS);
+  v[13] = _mm256_srai_epi32(u[13], DCT_CONST_BITS);
+  v[14] = _mm256_srai_epi32(u[14], DCT_CONST_BITS);
+  v[15] = _mm256_srai_epi32(u[15], DCT_CONST_BITS);
+
+  in[0] = s[0];
+  in[1] = SUB_EPI16(kZero, s[8]);
+  in[2] = s[12];
+  in[3] = SUB_EPI16(kZero, s[4]);
+  in[4] = PACKS_EPI32(v[4], v[5]);
+  in[5] = PACKS_EPI32(v[12], v[13]);
+  in[6] = PACKS_EPI32(v[8], v[9]);
+  in[7] = PACKS_EPI32(v[0], v[1]);
+  in[8] = PACKS_EPI32(v[2], v[3]);
+  in[9] = PACKS_EPI32(v[10], v[11]);
+  in[10] = PACKS_EPI32(v[14], v[15]);
+  in[11] = PACKS_EPI32(v[6], v[7]);
+  in[12] = s[5];
+  in[13] = SUB_EPI16(kZero, s[13]);
+  in[14] = s[9];
+  in[15] = SUB_EPI16(kZero, s[1]);
+#if DCT_HIGH_BIT_DEPTH
+  return has_overflow_avx2(overflow);
+#else
+  return 0;
+#endif  // DCT_HIGH_BIT_DEPTH
+}
+
+void FHT16x16_AVX2(const int16_t *input, tran_low_t *output, int stride,
+                   int tx_type) {
+  __m256i in[16];
+  int overflow;
+
+  switch (tx_type) {
+    case DCT_DCT: FDCT16x16_2D(input, output, stride); return;
+    case ADST_DCT:
+      load_buffer_16x16(input, in, stride);
+      overflow = FADST16_AVX2(in);
+      transpose_16bit_16x16_avx2(in, in);
+      overflow |= RIGHT_SHIFT_16x16(in);
+      overflow |= FDCT16_AVX2(in);
+      break;
+    case DCT_ADST:
+      load_buffer_16x16(input, in, stride);
+      overflow = FDCT16_AVX2(in);
+      transpose_16bit_16x16_avx2(in, in);
+      overflow |= RIGHT_SHIFT_16x16(in);
+      overflow |= FADST16_AVX2(in);
+      break;
+    default:
+      assert(tx_type == ADST_ADST);
+      load_buffer_16x16(input, in, stride);
+      overflow = FADST16_AVX2(in);
+      transpose_16bit_16x16_avx2(in, in);
+      overflow |= RIGHT_SHIFT_16x16(in);
+      overflow |= FADST16_AVX2(in);
+      break;
+  }
+#if DCT_HIGH_BIT_DEPTH
+  if (overflow) {
+    vp9_highbd_fht16x16_c(input, output, stride, tx_type);
+    return;
+  }
+#else
+  (void)overflow;
+#endif  // DCT_HIGH_BIT_DEPTH
+  transpose_16bit_16x16_avx2(in, in);
+  write_buffer_16x16(output, in);
+}
+
+#undef ADD_EPI16
+#undef SUB_EPI16
+#undef PACKS_EPI32
@@ -15,6 +15,7 @@
 #include "vpx/vpx_integer.h"
 #include "vpx_dsp/vpx_dsp_common.h"
 #include "vpx_dsp/x86/bitdepth_conversion_avx2.h"
+#include "vpx_dsp/x86/quantize_avx2.h"
 #include "vpx_dsp/x86/quantize_sse2.h"
 
 // Zero fill 8 positions in the output buffer.
@@ -137,3 +138,195 @@ void vp9_quantize_fp_avx2(const tran_low_t *coeff_ptr, intptr_t n_coeffs,
 
   *eob_ptr = accumulate_eob(eob);
 }
+
+// Quantize 16 coefficients of a 32x32 block. Coefficients below |thr| are
+// zeroed, and the >> 15 of the C code is a mulhi with |quant| doubled.
+static INLINE void quantize_fp_32x32_16(
+    const __m256i round, const __m256i quant, const __m256i dequant,
+    const __m256i thr, const tran_low_t *coeff_ptr, const int16_t *iscan_ptr,
+    tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr, __m256i *eob_max) {
+  const __m256i coeff = load_tran_low(coeff_ptr);
+  const __m256i abs_coeff = _mm256_abs_epi16(coeff);
+  const __m256i below_thr = _mm256_cmpgt_epi16(thr, abs_coeff);
+
+  if (_mm256_movemask_epi8(below_thr) == -1) {
+    store_zero_tran_low(qcoeff_ptr);
+    store_zero_tran_low(dqcoeff_ptr);
+  } else {
+    const __m256i tmp = _mm256_adds_epi16(abs_coeff, round);
+    const __m256i abs_qcoeff =
+        _mm256_andnot_si256(below_thr, _mm256_mulhi_epu16(tmp, quant));
+    const __m256i sign = _mm256_srai_epi16(coeff, 15);
+    __m256i qcoeff = _mm256_sub_epi16(_mm256_xor_si256(abs_qcoeff, sign), sign);
+    // dqcoeff = qcoeff * dequant / 2, which needs the full 32 bit product.
+    const __m256i dqcoeff_lo = _mm256_mullo_epi16(abs_qcoeff, dequant);
+    const __m256i dqcoeff_hi = _mm256_mulhi_epu16(abs_qcoeff, dequant);
+#if CONFIG_VP9_HIGHBITDEPTH
+    // load_tran_low() leaves coefficients 0-3 and 8-11 in the low lane, so
+    // the 32 bit unpacks produce coefficients 0-7 and 8-15 in order.
+    const __m256i coeff_0 = _mm256_unpacklo_epi16(coeff, coeff);
+    const __m256i coeff_1 = _mm256_unpackhi_epi16(coeff, coeff);
+    __m256i dqcoeff_0 = _mm256_unpacklo_epi16(dqcoeff_lo, dqcoeff_hi);
+    __m256i dqcoeff_1 = _mm256_unpackhi_epi16(dqcoeff_lo, dqcoeff_hi);
+    dqcoeff_0 =
+        highbd_invert_sign_avx2(_mm256_srli_epi32(dqcoeff_0, 1), coeff_0);
+    dqcoeff_1 =
+        highbd_invert_sign_avx2(_mm256_srli_epi32(dqcoeff_1, 1), coeff_1);
+    _mm256_storeu_si256((__m256i *)dqcoeff_ptr, dqcoeff_0);
+    _mm256_storeu_si256((__m256i *)(dqcoeff_ptr + 8), dqcoeff_1);
+#else
+    __m256i dqcoeff = _mm256_or_si256(_mm256_srli_epi16(dqcoeff_lo, 1),
+                                      _mm256_slli_epi16(dqcoeff_hi, 15));
+    dqcoeff = _mm256_sub_epi16(_mm256_xor_si256(dqcoeff, sign), sign);
+    _mm256_storeu_si256((__m256i *)dqcoeff_ptr, dqcoeff);
+#endif
+    store_tran_low(qcoeff, qcoeff_ptr);
+    *eob_max = _mm256_max_epi16(
+        *eob_max, scan_eob_256((const __m256i *)iscan_ptr, &qcoeff));
+  }
+}
+
+void vp9_quantize_fp_32x32_avx2(const tran_low_t *coeff_ptr, intptr_t n_coeffs,
+                                int skip_block, const int16_t *round_ptr,
+                                const int16_t *quant_ptr,
+                                tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr,
+                                const int16_t *dequant_ptr, uint16_t *eob_ptr,
+                                const int16_t *scan, const int16_t *iscan) {
+  const __m256i one = _mm256_set1_epi16(1);
+  __m256i round256, quant256, dequant256, thr256;
+  __m256i eob256 = _mm256_setzero_si256();
+  intptr_t i;
+
+  (void)scan;
+  (void)skip_block;
+  assert(!skip_block);
+
+  // Setup global values
+  {
+    const __m128i round = _mm_load_si128((const __m128i *)round_ptr);
+    const __m128i quant = _mm_load_si128((const __m128i *)quant_ptr);
+    const __m128i dequant = _mm_load_si128((const __m128i *)dequant_ptr);
+    round256 = _mm256_castsi128_si256(round);
+    round256 = _mm256_permute4x64_epi64(round256, 0x54);
+
+    quant256 = _mm256_castsi128_si256(quant);
+    quant256 = _mm256_permute4x64_epi64(quant256, 0x54);
+
+    dequant256 = _mm256_castsi128_si256(dequant);
+    dequant256 = _mm256_permute4x64_epi64(dequant256, 0x54);
+  }
+
+  round256 = _mm256_srai_epi16(_mm256_add_epi16(round256, one), 1);
+  quant256 = _mm256_slli_epi16(quant256, 1);
+  thr256 = _mm256_srai_epi16(dequant256, 2);
+
+  quantize_fp_32x32_16(round256, quant256, dequant256, thr256, coeff_ptr, iscan,
+                       qcoeff_ptr, dqcoeff_ptr, &eob256);
+
+  // remove dc constants
+  dequant256 = _mm256_permute2x128_si256(dequant256, dequant256, 0x31);
+  quant256 = _mm256_permute2x128_si256(quant256, quant256, 0x31);
+  round256 = _mm256_permute2x128_si256(round256, round256, 0x31);
+  thr256 = _mm256_permute2x128_si256(thr256, thr256, 0x31);
+
+  for (i = 16; i < n_coeffs; i += 16) {
+    quantize_fp_32x32_16(round256, quant256, dequant256, thr256, coeff_ptr + i,
+                         iscan + i, qcoeff_ptr + i, dqcoeff_ptr + i, &eob256);
+  }
+
+  *eob_ptr = accumulate_eob(_mm_max_epi16(
+      _mm256_castsi256_si128(eob256), _mm256_extracti128_si256(eob256, 1)));
+}
+
+#if CONFIG_VP9_HIGHBITDEPTH
+// Quantize 8 coefficients. |log_scale| is 1 for 32x32 blocks, in which case
+// round has already been halved and |qp[3]| holds the zeroing threshold.
+static INLINE void highbd_quantize_fp_8(const tran_low_t *coeff_ptr,
+                                        const int16_t *iscan_ptr,
+                                        tran_low_t *qcoeff_ptr,
+                                        tran_low_t *dqcoeff_ptr,
+                                        const __m256i *qp, int log_scale,
+                                        __m256i *eob_max) {
+  const __m256i coeff = _mm256_loadu_si256((const __m256i *)coeff_ptr);
+  const __m256i abs_coeff = _mm256_abs_epi32(coeff);
+  const __m256i tmp = _mm256_add_epi32(abs_coeff, qp[0]);
+  __m256i abs_qcoeff = highbd_mul_shift_avx2(tmp, qp[1], 16 - log_scale);
+  __m256i qcoeff, dqcoeff;
+
+  if (log_scale) {
+    const __m256i below_thr = _mm256_cmpgt_epi32(qp[3], abs_coeff);
+    abs_qcoeff = _mm256_andnot_si256(below_thr, abs_qcoeff);
+  }
+  qcoeff = highbd_invert_sign_avx2(abs_qcoeff, coeff);
+  dqcoeff = _mm256_mullo_epi32(qcoeff, qp[2]);
+  if (log_scale) dqcoeff = highbd_half_avx2(dqcoeff);
+
+  _mm256_storeu_si256((__m256i *)qcoeff_ptr, qcoeff);
+  _mm256_storeu_si256((__m256i *)dqcoeff_ptr, dqcoeff);
+  *eob_max =
+      _mm256_max_epi32(*eob_max, highbd_scan_eob_avx2(abs_qcoeff, iscan_ptr));
+}
+
+static INLINE void highbd_quantize_fp(const tran_low_t *coeff_ptr,
+                                      intptr_t n_coeffs,
+                                      const int16_t *round_ptr,
+                                      const int16_t *quant_ptr,
+                                      tran_low_t *qcoeff_ptr,
+                                      tran_low_t *dqcoeff_ptr,
+                                      const int16_t *dequant_ptr,
+                                      uint16_t *eob_ptr, const int16_t *iscan,
+                                      int log_scale) {
+  // round, quant, dequant, threshold.
+  __m256i qp[4];
+  __m256i eob_max = _mm256_setzero_si256();
+  intptr_t i;
+
+  qp[0] = highbd_load_qp_avx2(round_ptr);
+  qp[1] = highbd_load_qp_avx2(quant_ptr);
+  qp[2] = highbd_load_qp_avx2(dequant_ptr);
+  qp[3] = _mm256_srai_epi32(qp[2], 2);
+  if (log_scale) {
+    qp[0] = _mm256_srai_epi32(_mm256_add_epi32(qp[0], _mm256_set1_epi32(1)), 1);
+  }
+
+  highbd_quantize_fp_8(coeff_ptr, iscan, qcoeff_ptr, dqcoeff_ptr, qp, log_scale,
+                       &eob_max);
+
+  for (i = 0; i < 4; ++i) qp[i] = highbd_ac_qp_avx2(qp[i]);
+
+  for (i = 8; i < n_coeffs; i += 8) {
+    highbd_quantize_fp_8(coeff_ptr + i, iscan + i, qcoeff_ptr + i,
+                         dqcoeff_ptr + i, qp, log_scale, &eob_max);
+  }
+
+  *eob_ptr = highbd_get_max_eob_avx2(eob_max);
+}
+
+void vp9_highbd_quantize_fp_avx2(const tran_low_t *coeff_ptr, intptr_t n_coeffs,
+                                 int skip_block, const int16_t *round_ptr,
+                                 const int16_t *quant_ptr,
+                                 tran_low_t *qcoeff_ptr,
+                                 tran_low_t *dqcoeff_ptr,
+                                 const int16_t *dequant_ptr, uint16_t *eob_ptr,
+                                 const int16_t *scan, const int16_t *iscan) {
+  (void)scan;
+  (void)skip_block;
+  assert(!skip_block);
+
+  highbd_quantize_fp(coeff_ptr, n_coeffs, round_ptr, quant_ptr, qcoeff_ptr,
+                     dqcoeff_ptr, dequant_ptr, eob_ptr, iscan, 0);
+}
+
+void vp9_highbd_quantize_fp_32x32_avx2(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block,
+    const int16_t *round_ptr, const int16_t *quant_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *scan, const int16_t *iscan) {
+  (void)scan;
+  (void)skip_block;
+  assert(!skip_block);
+
+  highbd_quantize_fp(coeff_ptr, n_coeffs, round_ptr, quant_ptr, qcoeff_ptr,
+                     dqcoeff_ptr, dequant_ptr, eob_ptr, iscan, 1);
+}
+#endif  // CONFIG_VP9_HIGHBITDEPTH
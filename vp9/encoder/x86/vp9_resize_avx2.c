@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vp9_rtcd.h"
+#include "./vpx_config.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_dsp/vpx_filter.h"
+
+// Two outputs per register, one in each lane.
+static INLINE __m256i madd_2x8tap(const uint8_t *a, const int16_t *fa,
+                                  const uint8_t *b, const int16_t *fb) {
+  const __m128i ab = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)a),
+                                        _mm_loadl_epi64((const __m128i *)b));
+  const __m256i f = _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)fa)),
+      _mm_loadu_si128((const __m128i *)fb), 1);
+  return _mm256_madd_epi16(_mm256_cvtepu8_epi16(ab), f);
+}
+
+void vp9_resize_horz_8tap_avx2(const uint8_t *input, const int *pos,
+                               const int16_t *const *filter, uint8_t *output,
+                               int length) {
+  const __m256i round = _mm256_set1_epi32(1 << (FILTER_BITS - 1));
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  int o;
+
+  for (o = 0; o + 8 <= length; o += 8) {
+    const __m256i m01 = madd_2x8tap(input + pos[o + 0], filter[o + 0],
+                                    input + pos[o + 1], filter[o + 1]);
+    const __m256i m23 = madd_2x8tap(input + pos[o + 2], filter[o + 2],
+                                    input + pos[o + 3], filter[o + 3]);
+    const __m256i m45 = madd_2x8tap(input + pos[o + 4], filter[o + 4],
+                                    input + pos[o + 5], filter[o + 5]);
+    const __m256i m67 = madd_2x8tap(input + pos[o + 6], filter[o + 6],
+                                    input + pos[o + 7], filter[o + 7]);
+    // The low lane ends up with outputs 0, 2, 4, 6 and the high lane with
+    // 1, 3, 5, 7.
+    __m256i sum = _mm256_hadd_epi32(_mm256_hadd_epi32(m01, m23),
+                                    _mm256_hadd_epi32(m45, m67));
+    __m128i out;
+    sum = _mm256_permutevar8x32_epi32(sum, order);
+    sum = _mm256_srai_epi32(_mm256_add_epi32(sum, round), FILTER_BITS);
+    out = _mm_packs_epi32(_mm256_castsi256_si128(sum),
+                          _mm256_extracti128_si256(sum, 1));
+    _mm_storel_epi64((__m128i *)(output + o), _mm_packus_epi16(out, out));
+  }
+
+  if (o < length)
+    vp9_resize_horz_8tap_c(input, pos + o, filter + o, output + o, length - o);
+}
+
+static INLINE __m256i round_shift(__m256i sum) {
+  const __m256i round = _mm256_set1_epi32(1 << (FILTER_BITS - 1));
+  return _mm256_srai_epi32(_mm256_add_epi32(sum, round), FILTER_BITS);
+}
+
+void vp9_resize_vert_8tap_avx2(const uint8_t *const *rows,
+                               const int16_t *filter, uint8_t *output,
+                               int width) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i taps[4];
+  int c, k;
+
+  // Rows 2k and 2k + 1 are interleaved and multiplied by their pair of taps.
+  for (k = 0; k < 4; ++k) {
+    taps[k] = _mm256_set1_epi32((int)((uint16_t)filter[2 * k] |
+                                      ((uint32_t)(uint16_t)filter[2 * k + 1]
+                                       << 16)));
+  }
+
+  for (c = 0; c + 32 <= width; c += 32) {
+    __m256i s0 = zero, s1 = zero, s2 = zero, s3 = zero;
+    __m256i lo, hi;
+    for (k = 0; k < 4; ++k) {
+      const __m256i a = _mm256_loadu_si256((const __m256i *)(rows[2 * k] + c));
+      const __m256i b =
+          _mm256_loadu_si256((const __m256i *)(rows[2 * k + 1] + c));
+      const __m256i ab_lo = _mm256_unpacklo_epi8(a, b);
+      const __m256i ab_hi = _mm256_unpackhi_epi8(a, b);
+      s0 = _mm256_add_epi32(
+          s0, _mm256_madd_epi16(_mm256_unpacklo_epi8(ab_lo, zero), taps[k]));
+      s1 = _mm256_add_epi32(
+          s1, _mm256_madd_epi16(_mm256_unpackhi_epi8(ab_lo, zero), taps[k]));
+      s2 = _mm256_add_epi32(
+          s2, _mm256_madd_epi16(_mm256_unpacklo_epi8(ab_hi, zero), taps[k]));
+      s3 = _mm256_add_epi32(
+          s3, _mm256_madd_epi16(_mm256_unpackhi_epi8(ab_hi, zero), taps[k]));
+    }
+    // Every step above works within the lanes, so the packs put the columns
+    // back in order.
+    lo = _mm256_packs_epi32(round_shift(s0), round_shift(s1));
+    hi = _mm256_packs_epi32(round_shift(s2), round_shift(s3));
+    _mm256_storeu_si256((__m256i *)(output + c), _mm256_packus_epi16(lo, hi));
+  }
+
+  for (; c + 16 <= width; c += 16) {
+    __m256i s0 = zero, s1 = zero;
+    __m256i sum;
+    for (k = 0; k < 4; ++k) {
+      const __m128i a = _mm_loadu_si128((const __m128i *)(rows[2 * k] + c));
+      const __m128i b = _mm_loadu_si128((const __m128i *)(rows[2 * k + 1] + c));
+      s0 = _mm256_add_epi32(
+          s0, _mm256_madd_epi16(_mm256_cvtepu8_epi16(_mm_unpacklo_epi8(a, b)),
+                                taps[k]));
+      s1 = _mm256_add_epi32(
+          s1, _mm256_madd_epi16(_mm256_cvtepu8_epi16(_mm_unpackhi_epi8(a, b)),
+                                taps[k]));
+    }
+    // packs leaves columns 0-3, 8-11 | 4-7, 12-15.
+    sum = _mm256_permute4x64_epi64(
+        _mm256_packs_epi32(round_shift(s0), round_shift(s1)), 0xd8);
+    _mm_storeu_si128((__m128i *)(output + c),
+                     _mm_packus_epi16(_mm256_castsi256_si128(sum),
+                                      _mm256_extracti128_si256(sum, 1)));
+  }
+
+  if (c < width) {
+    const uint8_t *tail[8];
+    for (k = 0; k < 8; ++k) tail[k] = rows[k] + c;
+    vp9_resize_vert_8tap_c(tail, filter, output + c, width - c);
+  }
+}
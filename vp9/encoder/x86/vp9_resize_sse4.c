@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <smmintrin.h>  // SSE4.1
+
+#include "./vp9_rtcd.h"
+#include "./vpx_config.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_dsp/vpx_filter.h"
+#include "vpx_dsp/x86/mem_sse2.h"
+
+// The taps go up to 128 and the sums exceed 16 bits, so all the products are
+// accumulated in 32 bits with _mm_madd_epi16.
+static INLINE __m128i madd_8tap(const uint8_t *in, const int16_t *filter) {
+  const __m128i s = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)in));
+  return _mm_madd_epi16(s, _mm_loadu_si128((const __m128i *)filter));
+}
+
+void vp9_resize_horz_8tap_sse4_1(const uint8_t *input, const int *pos,
+                                 const int16_t *const *filter, uint8_t *output,
+                                 int length) {
+  const __m128i round = _mm_set1_epi32(1 << (FILTER_BITS - 1));
+  int o;
+
+  for (o = 0; o + 4 <= length; o += 4) {
+    const __m128i m0 = madd_8tap(input + pos[o + 0], filter[o + 0]);
+    const __m128i m1 = madd_8tap(input + pos[o + 1], filter[o + 1]);
+    const __m128i m2 = madd_8tap(input + pos[o + 2], filter[o + 2]);
+    const __m128i m3 = madd_8tap(input + pos[o + 3], filter[o + 3]);
+    __m128i sum =
+        _mm_hadd_epi32(_mm_hadd_epi32(m0, m1), _mm_hadd_epi32(m2, m3));
+    sum = _mm_srai_epi32(_mm_add_epi32(sum, round), FILTER_BITS);
+    sum = _mm_packs_epi32(sum, sum);
+    storeu_uint32(output + o,
+                  (uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(sum, sum)));
+  }
+
+  if (o < length)
+    vp9_resize_horz_8tap_c(input, pos + o, filter + o, output + o, length - o);
+}
+
+void vp9_resize_vert_8tap_sse4_1(const uint8_t *const *rows,
+                                 const int16_t *filter, uint8_t *output,
+                                 int width) {
+  const __m128i round = _mm_set1_epi32(1 << (FILTER_BITS - 1));
+  const __m128i zero = _mm_setzero_si128();
+  __m128i taps[4];
+  int c, k;
+
+  // Rows 2k and 2k + 1 are interleaved and multiplied by their pair of taps.
+  for (k = 0; k < 4; ++k) {
+    taps[k] = _mm_set1_epi32((int)((uint16_t)filter[2 * k] |
+                                   ((uint32_t)(uint16_t)filter[2 * k + 1]
+                                    << 16)));
+  }
+
+  for (c = 0; c + 16 <= width; c += 16) {
+    __m128i s0 = round, s1 = round, s2 = round, s3 = round;
+    __m128i lo, hi;
+    for (k = 0; k < 4; ++k) {
+      const __m128i a = _mm_loadu_si128((const __m128i *)(rows[2 * k] + c));
+      const __m128i b = _mm_loadu_si128((const __m128i *)(rows[2 * k + 1] + c));
+      const __m128i ab_lo = _mm_unpacklo_epi8(a, b);
+      const __m128i ab_hi = _mm_unpackhi_epi8(a, b);
+      s0 = _mm_add_epi32(
+          s0, _mm_madd_epi16(_mm_unpacklo_epi8(ab_lo, zero), taps[k]));
+      s1 = _mm_add_epi32(
+          s1, _mm_madd_epi16(_mm_unpackhi_epi8(ab_lo, zero), taps[k]));
+      s2 = _mm_add_epi32(
+          s2, _mm_madd_epi16(_mm_unpacklo_epi8(ab_hi, zero), taps[k]));
+      s3 = _mm_add_epi32(
+          s3, _mm_madd_epi16(_mm_unpackhi_epi8(ab_hi, zero), taps[k]));
+    }
+    lo = _mm_packs_epi32(_mm_srai_epi32(s0, FILTER_BITS),
+                         _mm_srai_epi32(s1, FILTER_BITS));
+    hi = _mm_packs_epi32(_mm_srai_epi32(s2, FILTER_BITS),
+                         _mm_srai_epi32(s3, FILTER_BITS));
+    _mm_storeu_si128((__m128i *)(output + c), _mm_packus_epi16(lo, hi));
+  }
+
+  if (c < width) {
+    const uint8_t *tail[8];
+    for (k = 0; k < 8; ++k) tail[k] = rows[k] + c;
+    vp9_resize_vert_8tap_c(tail, filter, output + c, width - c);
+  }
+}
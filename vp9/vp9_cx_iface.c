@@ -55,6 +55,9 @@ struct vp9_extracfg {
   int render_height;
   unsigned int row_mt;
   unsigned int motion_vector_unit_test;
+  unsigned int loopfilter_pipeline;
+  unsigned int inactive_unchanged;
+  unsigned int sampled_lpf_pick;
 };
 
 static struct vp9_extracfg default_extra_cfg = {
@@ -89,6 +92,9 @@ static struct vp9_extracfg default_extra_cfg = {
   0,                     // render height
   0,                     // row_mt
   0,                     // motion_vector_unit_test
+  0,                     // loopfilter_pipeline
+  0,                     // inactive_unchanged
+  0,                     // sampled_lpf_pick
 };
 
 struct vpx_codec_alg_priv {
@@ -113,6 +119,9 @@ struct vpx_codec_alg_priv {
   vpx_codec_pkt_list_decl(256) pkt_list;
   unsigned int fixed_kf_cntr;
   vpx_codec_priv_output_cx_pkt_cb_pair_t output_cx_pkt_cb;
+  // Hands back the source images lent while lend_source is set.
+  vpx_source_release_cb_t source_release_cb;
+  int lend_source;
   // BufferPool that holds all reference frames.
   BufferPool *buffer_pool;
 };
@@ -269,6 +278,9 @@ static vpx_codec_err_t validate_config(vpx_codec_alg_priv_t *ctx,
 
   RANGE_CHECK(extra_cfg, row_mt, 0, 1);
   RANGE_CHECK(extra_cfg, motion_vector_unit_test, 0, 2);
+  RANGE_CHECK(extra_cfg, loopfilter_pipeline, 0, 1);
+  RANGE_CHECK(extra_cfg, inactive_unchanged, 0, 1);
+  RANGE_CHECK(extra_cfg, sampled_lpf_pick, 0, 1);
   RANGE_CHECK(extra_cfg, enable_auto_alt_ref, 0, MAX_ARF_LAYERS);
   RANGE_CHECK(extra_cfg, cpu_used, -9, 9);
   RANGE_CHECK_HI(extra_cfg, noise_sensitivity, 6);
@@ -591,6 +603,9 @@ static vpx_codec_err_t set_encoder_config(
 
   oxcf->row_mt = extra_cfg->row_mt;
   oxcf->motion_vector_unit_test = extra_cfg->motion_vector_unit_test;
+  oxcf->loopfilter_pipeline = extra_cfg->loopfilter_pipeline;
+  oxcf->inactive_unchanged = extra_cfg->inactive_unchanged;
+  oxcf->sampled_lpf_pick = extra_cfg->sampled_lpf_pick;
 
   for (sl = 0; sl < oxcf->ss_number_layers; ++sl) {
     for (tl = 0; tl < oxcf->ts_number_layers; ++tl) {
@@ -692,6 +707,33 @@ static vpx_codec_err_t ctrl_get_quantizer(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_get_loopfilter_level(vpx_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+  int *const arg = va_arg(args, int *);
+  if (arg == NULL) return VPX_CODEC_INVALID_PARAM;
+  *arg = ctx->cpi->common.lf.filter_level;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_merge_firstpass_stats(vpx_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+#if CONFIG_REALTIME_ONLY
+  (void)ctx;
+  (void)args;
+  return VPX_CODEC_INCAPABLE;
+#else
+  vpx_fixed_buf_t *const stats = va_arg(args, vpx_fixed_buf_t *);
+  const size_t packet_sz = sizeof(FIRSTPASS_STATS);
+  (void)ctx;
+  if (stats == NULL || stats->buf == NULL || stats->sz < packet_sz ||
+      stats->sz % packet_sz)
+    return VPX_CODEC_INVALID_PARAM;
+  vp9_merge_first_pass_stats((FIRSTPASS_STATS *)stats->buf,
+                             (int)(stats->sz / packet_sz) - 1);
+  return VPX_CODEC_OK;
+#endif  // CONFIG_REALTIME_ONLY
+}
+
 static vpx_codec_err_t ctrl_get_quantizer64(vpx_codec_alg_priv_t *ctx,
                                             va_list args) {
   int *const arg = va_arg(args, int *);
@@ -892,6 +934,27 @@ static vpx_codec_err_t ctrl_set_row_mt(vpx_codec_alg_priv_t *ctx,
   return update_extra_cfg(ctx, &extra_cfg);
 }
 
+static vpx_codec_err_t ctrl_set_loopfilter_pipeline(vpx_codec_alg_priv_t *ctx,
+                                                    va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.loopfilter_pipeline = CAST(VP9E_SET_LOOPFILTER_PIPELINE, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static vpx_codec_err_t ctrl_set_inactive_unchanged(vpx_codec_alg_priv_t *ctx,
+                                                   va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.inactive_unchanged = CAST(VP9E_SET_INACTIVE_UNCHANGED, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static vpx_codec_err_t ctrl_set_sampled_lpf_pick(vpx_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.sampled_lpf_pick = CAST(VP9E_SET_SAMPLED_LPF_PICK, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
 static vpx_codec_err_t ctrl_enable_motion_vector_unit_test(
     vpx_codec_alg_priv_t *ctx, va_list args) {
   struct vp9_extracfg extra_cfg = ctx->extra_cfg;
@@ -907,6 +970,24 @@ static vpx_codec_err_t ctrl_get_level(vpx_codec_alg_priv_t *ctx, va_list args) {
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_frame_stage_stats(vpx_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  const int enable = va_arg(args, int);
+  if (enable != 0 && enable != 1) return VPX_CODEC_INVALID_PARAM;
+  ctx->cpi->stage_stats = enable;
+  memset(&ctx->cpi->last_stage_stats, 0, sizeof(ctx->cpi->last_stage_stats));
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_get_frame_stage_stats(vpx_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  vp9e_stage_stats_t *const stats = va_arg(args, vp9e_stage_stats_t *);
+  if (stats == NULL) return VPX_CODEC_INVALID_PARAM;
+  if (!ctx->cpi->stage_stats) return VPX_CODEC_ERROR;
+  *stats = ctx->cpi->last_stage_stats;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t encoder_init(vpx_codec_ctx_t *ctx,
                                     vpx_codec_priv_enc_mr_cfg_t *data) {
   vpx_codec_err_t res = VPX_CODEC_OK;
@@ -1096,6 +1177,12 @@ static vpx_codec_frame_flags_t get_frame_pkt_flags(const VP9_COMP *cpi,
   return flags;
 }
 
+static void release_lent_source(void *priv, const void *lent_frame) {
+  vpx_codec_alg_priv_t *const ctx = (vpx_codec_alg_priv_t *)priv;
+  ctx->source_release_cb.release_source(ctx->source_release_cb.user_priv,
+                                        (const vpx_image_t *)lent_frame);
+}
+
 const size_t kMinCompressedSize = 8192;
 static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
                                       const vpx_image_t *img,
@@ -1108,6 +1195,8 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
   volatile vpx_codec_pts_t pts = pts_val;
   VP9_COMP *const cpi = ctx->cpi;
   const vpx_rational64_t *const timestamp_ratio = &ctx->timestamp_ratio;
+  // Set until a lent img is passed to the encoder, which then hands it back.
+  volatile int lent_source_held = img != NULL && ctx->lend_source;
   size_t data_sz;
 
   if (cpi == NULL) return VPX_CODEC_INVALID_PARAM;
@@ -1135,6 +1224,7 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
         free(ctx->cx_data);
         ctx->cx_data = (unsigned char *)malloc(ctx->cx_data_sz);
         if (ctx->cx_data == NULL) {
+          if (lent_source_held) release_lent_source(ctx, img);
           return VPX_CODEC_MEM_ERROR;
         }
       }
@@ -1154,11 +1244,13 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
   if (((flags & VP8_EFLAG_NO_UPD_GF) && (flags & VP8_EFLAG_FORCE_GF)) ||
       ((flags & VP8_EFLAG_NO_UPD_ARF) && (flags & VP8_EFLAG_FORCE_ARF))) {
     ctx->base.err_detail = "Conflicting flags.";
+    if (lent_source_held) release_lent_source(ctx, img);
     return VPX_CODEC_INVALID_PARAM;
   }
 
   if (setjmp(cpi->common.error.jmp)) {
     cpi->common.error.setjmp = 0;
+    if (lent_source_held) release_lent_source(ctx, img);
     res = update_error_state(ctx, &cpi->common.error);
     vpx_clear_system_state();
     return res;
@@ -1196,8 +1288,34 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
 
       // Store the original flags in to the frame buffer. Will extract the
       // key frame flag when we actually encode this frame.
-      if (vp9_receive_raw_frame(cpi, flags | ctx->next_frame_flags, &sd,
-                                dst_time_stamp, dst_end_time_stamp)) {
+      if (ctx->lend_source) {
+        // The allocation is only known for images laid out by
+        // vpx_img_set_rect(), which offsets the planes from the image data by
+        // the margin above and left of the image.
+        const int stride = img->stride[VPX_PLANE_Y];
+        int padded_width = 0;
+        int padded_height = 0;
+        int border = 0;
+        if (img->img_data != NULL && stride > 0 &&
+            img->planes[VPX_PLANE_Y] >= img->img_data) {
+          const ptrdiff_t offset = img->planes[VPX_PLANE_Y] - img->img_data;
+          const int bytes_per_sample =
+              (img->fmt & VPX_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+          const int top = (int)(offset / stride);
+          const int left = (int)(offset % stride) / bytes_per_sample;
+          padded_width = (int)img->w - left;
+          padded_height = (int)img->h - top;
+          border = VPXMIN(top, left);
+        }
+        if (vp9_receive_lent_frame(cpi, flags | ctx->next_frame_flags, &sd,
+                                   padded_width, padded_height, border,
+                                   dst_time_stamp, dst_end_time_stamp, img)) {
+          res = update_error_state(ctx, &cpi->common.error);
+        }
+        lent_source_held = 0;
+      } else if (vp9_receive_raw_frame(cpi, flags | ctx->next_frame_flags,
+                                       &sd, dst_time_stamp,
+                                       dst_end_time_stamp)) {
         res = update_error_state(ctx, &cpi->common.error);
       }
       ctx->next_frame_flags = 0;
@@ -1314,6 +1432,7 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
     }
   }
 
+  if (lent_source_held) release_lent_source(ctx, img);
   cpi->common.error.setjmp = 0;
   return res;
 }
@@ -1359,7 +1478,9 @@ static vpx_codec_err_t ctrl_get_reference(vpx_codec_alg_priv_t *ctx,
 
   if (frame != NULL) {
     const int fb_idx = ctx->cpi->common.cur_show_frame_fb_idx;
-    YV12_BUFFER_CONFIG *fb = get_buf_frame(&ctx->cpi->common, fb_idx);
+    YV12_BUFFER_CONFIG *fb;
+    vp9_sync_loopfilter_pipeline(ctx->cpi);
+    fb = get_buf_frame(&ctx->cpi->common, fb_idx);
     if (fb == NULL) return VPX_CODEC_ERROR;
     yuvconfig2image(&frame->img, fb, NULL);
     return VPX_CODEC_OK;
@@ -1664,6 +1785,20 @@ static vpx_codec_err_t ctrl_set_render_size(vpx_codec_alg_priv_t *ctx,
   return update_extra_cfg(ctx, &extra_cfg);
 }
 
+static vpx_codec_err_t ctrl_set_source_release_cb(vpx_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  vpx_source_release_cb_t *const cb = va_arg(args, vpx_source_release_cb_t *);
+  if (cb == NULL) return VPX_CODEC_INVALID_PARAM;
+  // Images still held are handed back through the last callback set.
+  ctx->lend_source = cb->release_source != NULL;
+  if (ctx->lend_source) {
+    ctx->source_release_cb = *cb;
+    ctx->cpi->release_lent_frame = release_lent_source;
+    ctx->cpi->release_lent_priv = ctx;
+  }
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t ctrl_set_postencode_drop(vpx_codec_alg_priv_t *ctx,
                                                 va_list args) {
   VP9_COMP *const cpi = ctx->cpi;
@@ -1716,6 +1851,12 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { VP9E_SET_TARGET_LEVEL, ctrl_set_target_level },
   { VP9E_SET_ROW_MT, ctrl_set_row_mt },
   { VP9E_SET_POSTENCODE_DROP, ctrl_set_postencode_drop },
+  { VP9E_SET_LOOPFILTER_PIPELINE, ctrl_set_loopfilter_pipeline },
+  { VP9E_SET_SOURCE_RELEASE_CB, ctrl_set_source_release_cb },
+  { VP9E_SET_INACTIVE_UNCHANGED, ctrl_set_inactive_unchanged },
+  { VP9E_SET_FRAME_STAGE_STATS, ctrl_set_frame_stage_stats },
+  { VP9E_SET_SAMPLED_LPF_PICK, ctrl_set_sampled_lpf_pick },
+  { VP9E_MERGE_FIRSTPASS_STATS, ctrl_merge_firstpass_stats },
   { VP9E_ENABLE_MOTION_VECTOR_UNIT_TEST, ctrl_enable_motion_vector_unit_test },
   { VP9E_SET_SVC_INTER_LAYER_PRED, ctrl_set_svc_inter_layer_pred },
   { VP9E_SET_SVC_FRAME_DROP_LAYER, ctrl_set_svc_frame_drop_layer },
@@ -1730,6 +1871,8 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { VP9E_GET_ACTIVEMAP, ctrl_get_active_map },
   { VP9E_GET_LEVEL, ctrl_get_level },
   { VP9E_GET_SVC_REF_FRAME_CONFIG, ctrl_get_svc_ref_frame_config },
+  { VP9E_GET_FRAME_STAGE_STATS, ctrl_get_frame_stage_stats },
+  { VP9E_GET_LOOPFILTER_LEVEL, ctrl_get_loopfilter_level },
 
   { -1, NULL },
 };
@@ -25,6 +25,7 @@
 #include "vp9/common/vp9_frame_buffers.h"
 
 #include "vp9/decoder/vp9_decodeframe.h"
+#include "vp9/decoder/vp9_dthread.h"
 
 #include "vp9/vp9_dx_iface.h"
 #include "vp9/vp9_iface_common.h"
@@ -47,6 +48,7 @@ static vpx_codec_err_t decoder_init(vpx_codec_ctx_t *ctx,
     ctx->priv->init_flags = ctx->init_flags;
     priv->si.sz = sizeof(priv->si);
     priv->flushed = 0;
+    priv->fused_lf = 1;
     if (ctx->config.dec) {
       priv->cfg = *ctx->config.dec;
       ctx->config.dec = &priv->cfg;
@@ -57,16 +59,35 @@ static vpx_codec_err_t decoder_init(vpx_codec_ctx_t *ctx,
 }
 
 static vpx_codec_err_t decoder_destroy(vpx_codec_alg_priv_t *ctx) {
-  if (ctx->pbi != NULL) {
+  if (ctx->frame_workers != NULL) {
+    int i;
+    for (i = 0; i < ctx->num_frame_workers; ++i) {
+      VPxWorker *const worker = &ctx->frame_workers[i];
+      FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)worker->data1;
+      vpx_get_worker_interface()->end(worker);
+      if (frame_worker_data != NULL) {
+        vp9_decoder_remove(frame_worker_data->pbi);
+        vpx_free(frame_worker_data->scratch_buffer);
+        vpx_free(frame_worker_data);
+      }
+    }
+    vpx_free(ctx->frame_workers);
+  } else if (ctx->pbi != NULL) {
     vp9_decoder_remove(ctx->pbi);
   }
 
   if (ctx->buffer_pool) {
     vp9_free_ref_frame_buffers(ctx->buffer_pool);
     vp9_free_internal_frame_buffers(&ctx->buffer_pool->int_frame_buffers);
+#if CONFIG_MULTITHREAD
+    pthread_mutex_destroy(&ctx->buffer_pool->pool_mutex);
+    pthread_cond_destroy(&ctx->buffer_pool->progress_cond);
+#endif
   }
 
   vpx_free(ctx->buffer_pool);
+  if (ctx->thread_pool != NULL) vpx_worker_pool_remove_client(ctx->thread_pool);
   vpx_free(ctx);
   return VPX_CODEC_OK;
 }
@@ -220,6 +241,10 @@ static void init_buffer_callbacks(vpx_codec_alg_priv_t *ctx) {
     if (vp9_alloc_internal_frame_buffers(&pool->int_frame_buffers))
       vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                          "Failed to initialize internal frame buffers");
+    pool->int_frame_buffers.prefault =
+        (ctx->frame_buffer_flags & VP9_FRAME_BUFFER_PREFAULT) != 0;
+    pool->int_frame_buffers.use_huge_pages =
+        (ctx->frame_buffer_flags & VP9_FRAME_BUFFER_HUGE_PAGES) != 0;
 
     pool->cb_priv = &pool->int_frame_buffers;
   }
@@ -251,7 +276,84 @@ static void set_ppflags(const vpx_codec_alg_priv_t *ctx, vp9_ppflags_t *flags) {
       ERROR(#memb " out of range [" #lo ".." #hi "]");                   \
   } while (0)
 
+static int frame_worker_hook(void *arg1, void *arg2) {
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)arg1;
+  const uint8_t *data = frame_worker_data->data;
+  (void)arg2;
+
+  frame_worker_data->result = vp9_receive_compressed_data(
+      frame_worker_data->pbi, frame_worker_data->data_size, &data);
+  frame_worker_data->data_end = data;
+  return !frame_worker_data->result;
+}
+
+static vpx_codec_err_t init_frame_workers(vpx_codec_alg_priv_t *ctx) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  int i;
+
+  ctx->last_submit_worker_id = -1;
+  ctx->num_frame_workers =
+      VPXMAX(1, VPXMIN((int)ctx->cfg.threads, MAX_DECODE_THREADS));
+  ctx->frame_workers = (VPxWorker *)vpx_calloc(ctx->num_frame_workers,
+                                               sizeof(*ctx->frame_workers));
+  if (ctx->frame_workers == NULL) {
+    set_error_detail(ctx, "Failed to allocate frame workers");
+    return VPX_CODEC_MEM_ERROR;
+  }
+
+  for (i = 0; i < ctx->num_frame_workers; ++i) {
+    VPxWorker *const worker = &ctx->frame_workers[i];
+    FrameWorkerData *frame_worker_data;
+    VP9Decoder *pbi;
+
+    winterface->init(worker);
+    worker->data1 = vpx_calloc(1, sizeof(FrameWorkerData));
+    if (worker->data1 == NULL) {
+      set_error_detail(ctx, "Failed to allocate frame worker data");
+      return VPX_CODEC_MEM_ERROR;
+    }
+    frame_worker_data = (FrameWorkerData *)worker->data1;
+    frame_worker_data->worker_id = i;
+    frame_worker_data->pbi = pbi = vp9_decoder_create(ctx->buffer_pool);
+    if (pbi == NULL) {
+      set_error_detail(ctx, "Failed to allocate decoder");
+      return VPX_CODEC_MEM_ERROR;
+    }
+    // Each frame is decoded by a single thread.
+    pbi->max_threads = 1;
+    pbi->inv_tile_order = ctx->invert_tile_order;
+    pbi->fused_lf = ctx->fused_lf;
+    pbi->stage_stats = ctx->stage_stats;
+    pbi->common.frame_parallel_decode = 1;
+    pbi->common.new_fb_idx = INVALID_IDX;
+
+    worker->hook = frame_worker_hook;
+    if (!winterface->reset(worker)) {
+      set_error_detail(ctx, "Frame worker thread creation failed");
+      return VPX_CODEC_MEM_ERROR;
+    }
+  }
+
+  ctx->pbi = ((FrameWorkerData *)ctx->frame_workers[0].data1)->pbi;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
+  // Asynchronous decode runs on the frame workers.
+  if (ctx->base.init_flags & VPX_CODEC_USE_ASYNC)
+    ctx->frame_parallel_decode = 1;
+
+  RANGE_CHECK(ctx, frame_parallel_decode, 0, 1);
+  RANGE_CHECK(ctx, fused_lf, 0, 1);
+  RANGE_CHECK(ctx, stage_stats, 0, 1);
+  if (ctx->frame_parallel_decode &&
+      (ctx->base.init_flags & VPX_CODEC_USE_POSTPROC)) {
+    set_error_detail(ctx,
+                     "Postprocessing is not supported with frame parallel "
+                     "decode");
+    return VPX_CODEC_INCAPABLE;
+  }
+
   ctx->last_show_frame = -1;
   ctx->need_resync = 1;
   ctx->flushed = 0;
@@ -259,6 +361,21 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
   ctx->buffer_pool = (BufferPool *)vpx_calloc(1, sizeof(BufferPool));
   if (ctx->buffer_pool == NULL) return VPX_CODEC_MEM_ERROR;
 
+#if CONFIG_MULTITHREAD
+  if (pthread_mutex_init(&ctx->buffer_pool->pool_mutex, NULL) ||
+      pthread_cond_init(&ctx->buffer_pool->progress_cond, NULL)) {
+    set_error_detail(ctx, "Failed to allocate buffer pool mutex");
+    return VPX_CODEC_MEM_ERROR;
+  }
+#endif
+
+  if (ctx->frame_parallel_decode) {
+    const vpx_codec_err_t res = init_frame_workers(ctx);
+    if (res != VPX_CODEC_OK) return res;
+    init_buffer_callbacks(ctx);
+    return VPX_CODEC_OK;
+  }
+
   ctx->pbi = vp9_decoder_create(ctx->buffer_pool);
   if (ctx->pbi == NULL) {
     set_error_detail(ctx, "Failed to allocate decoder");
@@ -266,12 +383,16 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
   }
   ctx->pbi->max_threads = ctx->cfg.threads;
   ctx->pbi->inv_tile_order = ctx->invert_tile_order;
+  ctx->pbi->worker_pool = ctx->thread_pool;
 
   RANGE_CHECK(ctx, row_mt, 0, 1);
   ctx->pbi->row_mt = ctx->row_mt;
 
   RANGE_CHECK(ctx, lpf_opt, 0, 1);
   ctx->pbi->lpf_mt_opt = ctx->lpf_opt;
+  ctx->pbi->fused_lf = ctx->fused_lf;
+  ctx->pbi->stage_stats = ctx->stage_stats;
+  ctx->pbi->borrowed_frames = ctx->borrowed_frames;
 
   // If postprocessing was enabled by the application and a
   // configuration has not been provided, default it.
@@ -291,9 +412,187 @@ static INLINE void check_resync(vpx_codec_alg_priv_t *const ctx,
     ctx->need_resync = 0;
 }
 
+static void release_last_output_frame(vpx_codec_alg_priv_t *ctx) {
+  BufferPool *const pool = ctx->buffer_pool;
+
+  if (!ctx->hold_last_show_frame) return;
+  lock_buffer_pool(pool);
+  decrease_ref_count(ctx->last_show_frame, pool->frame_bufs, pool);
+  unlock_buffer_pool(pool);
+  ctx->hold_last_show_frame = 0;
+}
+
+// Wait for the frames in flight and drop them along with the frames waiting
+// for output. The references of a failed frame may still be in use by later
+// frames when it exits, so the buffer pool is flushed here instead.
+static void reset_frame_workers(vpx_codec_alg_priv_t *ctx) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  BufferPool *const pool = ctx->buffer_pool;
+  RefCntBuffer *const frame_bufs = pool->frame_bufs;
+  int i;
+
+  for (i = 0; i < ctx->num_frame_workers; ++i) {
+    VPxWorker *const worker = &ctx->frame_workers[i];
+    VP9Decoder *const pbi = ((FrameWorkerData *)worker->data1)->pbi;
+    winterface->sync(worker);
+    pbi->need_resync = 1;
+    pbi->common.prev_frame = NULL;
+    pbi->prev_seg_map_buf = NULL;
+    pbi->next_prev_frame = NULL;
+    pbi->next_seg_map_buf = NULL;
+    memset(&pbi->common.ref_frame_map, -1, sizeof(pbi->common.ref_frame_map));
+    memset(&pbi->common.next_ref_frame_map, -1,
+           sizeof(pbi->common.next_ref_frame_map));
+  }
+  ctx->num_busy_workers = 0;
+  ctx->next_output_worker_id = ctx->next_submit_worker_id;
+  ctx->num_cache_frames = 0;
+  ctx->frame_cache_read = ctx->frame_cache_write = 0;
+
+  lock_buffer_pool(pool);
+  for (i = 0; i < FRAME_BUFFERS; ++i) {
+    // Borrowed frames stay valid until the application returns them.
+    frame_bufs[i].ref_count = ctx->borrowed_frames[i];
+    if (frame_bufs[i].ref_count == 0 && !frame_bufs[i].released &&
+        frame_bufs[i].raw_frame_buffer.priv) {
+      pool->release_fb_cb(pool->cb_priv, &frame_bufs[i].raw_frame_buffer);
+      frame_bufs[i].released = 1;
+    }
+  }
+  unlock_buffer_pool(pool);
+}
+
+// Wait for the oldest frame in flight and queue it for output if it is shown.
+static vpx_codec_err_t retire_frame_worker(vpx_codec_alg_priv_t *ctx) {
+  VPxWorker *const worker = &ctx->frame_workers[ctx->next_output_worker_id];
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+  VP9Decoder *const pbi = frame_worker_data->pbi;
+  VP9_COMMON *const cm = &pbi->common;
+  BufferPool *const pool = ctx->buffer_pool;
+
+  vpx_get_worker_interface()->sync(worker);
+  ctx->next_output_worker_id =
+      (ctx->next_output_worker_id + 1) % ctx->num_frame_workers;
+  --ctx->num_busy_workers;
+  ctx->pbi = pbi;
+
+  if (frame_worker_data->result != 0) {
+    vpx_codec_err_t res = update_error_state(ctx, &cm->error);
+    if (res == VPX_CODEC_OK) res = VPX_CODEC_ERROR;
+    ctx->need_resync = 1;
+    reset_frame_workers(ctx);
+    return res;
+  }
+
+  check_resync(ctx, pbi);
+
+  lock_buffer_pool(pool);
+  if (frame_worker_data->output_frame && cm->show_frame && !ctx->need_resync) {
+    // Drop the oldest frame if the application does not keep up, the same as
+    // serial decode does when frames are not retrieved.
+    if (ctx->num_cache_frames == FRAME_CACHE_SIZE) {
+      decrease_ref_count(ctx->frame_cache[ctx->frame_cache_read].fb_idx,
+                         pool->frame_bufs, pool);
+      ctx->frame_cache_read = (ctx->frame_cache_read + 1) % FRAME_CACHE_SIZE;
+      --ctx->num_cache_frames;
+    }
+    ctx->frame_cache[ctx->frame_cache_write].fb_idx = cm->new_fb_idx;
+    ctx->frame_cache[ctx->frame_cache_write].user_priv =
+        frame_worker_data->user_priv;
+    ctx->frame_cache_write = (ctx->frame_cache_write + 1) % FRAME_CACHE_SIZE;
+    ++ctx->num_cache_frames;
+  } else {
+    decrease_ref_count(cm->new_fb_idx, pool->frame_bufs, pool);
+  }
+  unlock_buffer_pool(pool);
+
+  return VPX_CODEC_OK;
+}
+
+// Queue the frames that finished decoding for output, without waiting for the
+// ones still in flight.
+static vpx_codec_err_t retire_finished_frame_workers(
+    vpx_codec_alg_priv_t *ctx) {
+  vpx_codec_err_t res = VPX_CODEC_OK;
+  while (ctx->num_busy_workers > 0 && res == VPX_CODEC_OK &&
+         !vpx_worker_is_busy(&ctx->frame_workers[ctx->next_output_worker_id]))
+    res = retire_frame_worker(ctx);
+  return res;
+}
+
+static vpx_codec_err_t drain_frame_workers(vpx_codec_alg_priv_t *ctx) {
+  vpx_codec_err_t res = VPX_CODEC_OK;
+  while (ctx->num_busy_workers > 0 && res == VPX_CODEC_OK)
+    res = retire_frame_worker(ctx);
+  return res;
+}
+
+static vpx_codec_err_t submit_frame(vpx_codec_alg_priv_t *ctx,
+                                    const uint8_t *data, unsigned int data_sz,
+                                    void *user_priv, int output_frame) {
+  vpx_codec_err_t res = VPX_CODEC_OK;
+  VPxWorker *worker;
+  FrameWorkerData *frame_worker_data;
+  VP9Decoder *pbi;
+
+  // An error of an earlier frame is returned once this frame is submitted, as
+  // it may be the key frame that resyncs the decoder.
+  if (ctx->num_busy_workers == ctx->num_frame_workers)
+    res = retire_frame_worker(ctx);
+
+  worker = &ctx->frame_workers[ctx->next_submit_worker_id];
+  frame_worker_data = (FrameWorkerData *)worker->data1;
+  pbi = frame_worker_data->pbi;
+
+  // The application may reuse its buffer before the frame has been decoded.
+  if (frame_worker_data->scratch_buffer_size < data_sz) {
+    vpx_free(frame_worker_data->scratch_buffer);
+    frame_worker_data->scratch_buffer = (uint8_t *)vpx_malloc(data_sz);
+    if (frame_worker_data->scratch_buffer == NULL) {
+      frame_worker_data->scratch_buffer_size = 0;
+      set_error_detail(ctx, "Failed to reallocate scratch buffer");
+      return VPX_CODEC_MEM_ERROR;
+    }
+    frame_worker_data->scratch_buffer_size = data_sz;
+  }
+  memcpy(frame_worker_data->scratch_buffer, data, data_sz);
+  frame_worker_data->data = frame_worker_data->scratch_buffer;
+  frame_worker_data->data_size = data_sz;
+  frame_worker_data->user_priv = user_priv;
+  frame_worker_data->output_frame = output_frame;
+
+  // Wait for the headers of the previous frame to be decoded.
+  if (ctx->last_submit_worker_id >= 0) {
+    const VPxWorker *const last_worker =
+        &ctx->frame_workers[ctx->last_submit_worker_id];
+    vp9_frameworker_copy_context(
+        pbi, ((FrameWorkerData *)last_worker->data1)->pbi);
+  }
+
+  pbi->decrypt_cb = ctx->decrypt_cb;
+  pbi->decrypt_state = ctx->decrypt_state;
+  pbi->common.byte_alignment = ctx->byte_alignment;
+  pbi->common.skip_loop_filter = ctx->skip_loop_filter;
+
+  // Cleared here rather than in the worker so the next submitted frame cannot
+  // see the context of the frame this worker decoded before.
+  pbi->frame_context_ready = 0;
+  pbi->next_prev_frame = NULL;
+  pbi->next_seg_map_buf = NULL;
+
+  vpx_get_worker_interface()->launch(worker);
+  ctx->last_submit_worker_id = ctx->next_submit_worker_id;
+  ctx->next_submit_worker_id =
+      (ctx->next_submit_worker_id + 1) % ctx->num_frame_workers;
+  ++ctx->num_busy_workers;
+
+  return res;
+}
+
 static vpx_codec_err_t decode_one(vpx_codec_alg_priv_t *ctx,
                                   const uint8_t **data, unsigned int data_sz,
-                                  void *user_priv, int64_t deadline) {
+                                  void *user_priv, int64_t deadline,
+                                  int output_frame) {
   (void)deadline;
 
   // Determine the stream parameters. Note that we rely on peek_si to
@@ -309,6 +608,14 @@ static vpx_codec_err_t decode_one(vpx_codec_alg_priv_t *ctx,
     if (!ctx->si.is_kf && !is_intra_only) return VPX_CODEC_ERROR;
   }
 
+  if (ctx->frame_parallel_decode) {
+    // The frame is decoded in the background, so it is consumed in whole.
+    const vpx_codec_err_t res =
+        submit_frame(ctx, *data, data_sz, user_priv, output_frame);
+    *data += data_sz;
+    return res;
+  }
+
   ctx->user_priv = user_priv;
 
   // Set these even if already initialized.  The caller may have changed the
@@ -328,15 +635,18 @@ static vpx_codec_err_t decode_one(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
-static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
-                                      const uint8_t *data, unsigned int data_sz,
-                                      void *user_priv, long deadline) {
+static vpx_codec_err_t decode_data(vpx_codec_alg_priv_t *ctx,
+                                   const uint8_t *data, unsigned int data_sz,
+                                   void *user_priv, long deadline) {
   const uint8_t *data_start = data;
   const uint8_t *const data_end = data + data_sz;
   vpx_codec_err_t res;
   uint32_t frame_sizes[8];
   int frame_count;
 
+  // The frame returned by the last call is no longer used by the application.
+  if (ctx->frame_parallel_decode) release_last_output_frame(ctx);
+
   if (data == NULL && data_sz == 0) {
     ctx->flushed = 1;
     return VPX_CODEC_OK;
@@ -371,7 +681,8 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
         return VPX_CODEC_CORRUPT_FRAME;
       }
 
-      res = decode_one(ctx, &data_start_copy, frame_size, user_priv, deadline);
+      res = decode_one(ctx, &data_start_copy, frame_size, user_priv, deadline,
+                       i == frame_count - 1);
       if (res != VPX_CODEC_OK) return res;
 
       data_start += frame_size;
@@ -380,7 +691,7 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
     while (data_start < data_end) {
       const uint32_t frame_size = (uint32_t)(data_end - data_start);
       const vpx_codec_err_t res =
-          decode_one(ctx, &data_start, frame_size, user_priv, deadline);
+          decode_one(ctx, &data_start, frame_size, user_priv, deadline, 1);
       if (res != VPX_CODEC_OK) return res;
 
       // Account for suboptimal termination by the encoder.
@@ -396,6 +707,48 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
   return res;
 }
 
+// Takes the next frame to output, along with its reference. *frame is set to
+// NULL if there is none.
+static vpx_codec_err_t frame_parallel_next_frame(vpx_codec_alg_priv_t *ctx,
+                                                 const cache_frame **frame) {
+  *frame = NULL;
+  release_last_output_frame(ctx);
+
+  if (ctx->base.init_flags & VPX_CODEC_USE_ASYNC) {
+    const vpx_codec_err_t res = retire_finished_frame_workers(ctx);
+    if (res != VPX_CODEC_OK) return res;
+  }
+
+  // Frames in flight are only waited for once the decoder is flushed.
+  while (ctx->num_cache_frames == 0 && ctx->flushed &&
+         ctx->num_busy_workers > 0) {
+    const vpx_codec_err_t res = retire_frame_worker(ctx);
+    if (res != VPX_CODEC_OK) return res;
+  }
+  if (ctx->num_cache_frames == 0) return VPX_CODEC_OK;
+
+  *frame = &ctx->frame_cache[ctx->frame_cache_read];
+  ctx->frame_cache_read = (ctx->frame_cache_read + 1) % FRAME_CACHE_SIZE;
+  --ctx->num_cache_frames;
+  return VPX_CODEC_OK;
+}
+
+static vpx_image_t *frame_parallel_get_frame(vpx_codec_alg_priv_t *ctx) {
+  RefCntBuffer *const frame_bufs = ctx->buffer_pool->frame_bufs;
+  const cache_frame *frame;
+  const vpx_codec_err_t res = frame_parallel_next_frame(ctx, &frame);
+  // The error is returned by the next call to decode.
+  if (res != VPX_CODEC_OK) ctx->output_error = res;
+  if (frame == NULL) return NULL;
+
+  // The frame is held until the next call to decode or get the next frame.
+  ctx->last_show_frame = frame->fb_idx;
+  ctx->hold_last_show_frame = 1;
+  yuvconfig2image(&ctx->img, &frame_bufs[frame->fb_idx].buf, frame->user_priv);
+  ctx->img.fb_priv = frame_bufs[frame->fb_idx].raw_frame_buffer.priv;
+  return &ctx->img;
+}
+
 static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
                                       vpx_codec_iter_t *iter) {
   vpx_image_t *img = NULL;
@@ -404,6 +757,9 @@ static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
   // always return only 1 frame per decode call.
   (void)iter;
 
+  if (ctx->frame_parallel_decode && ctx->pbi != NULL)
+    return frame_parallel_get_frame(ctx);
+
   if (ctx->pbi != NULL) {
     YV12_BUFFER_CONFIG sd;
     vp9_ppflags_t flags = { 0, 0, 0 };
@@ -422,6 +778,29 @@ static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
   return NULL;
 }
 
+// Hand the frames ready for output to the put_frame callback.
+static void put_frames(vpx_codec_alg_priv_t *ctx) {
+  const vpx_codec_priv_cb_pair_t *const cb = &ctx->base.dec.put_frame_cb;
+  vpx_codec_iter_t iter = NULL;
+  vpx_image_t *img;
+
+  while ((img = decoder_get_frame(ctx, &iter)) != NULL)
+    cb->u.put_frame(cb->user_priv, img);
+}
+
+static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
+                                      const uint8_t *data, unsigned int data_sz,
+                                      void *user_priv, long deadline) {
+  vpx_codec_err_t res = decode_data(ctx, data, data_sz, user_priv, deadline);
+
+  if (ctx->base.dec.put_frame_cb.u.put_frame != NULL)
+    put_frames(ctx);
+
+  if (res == VPX_CODEC_OK) res = ctx->output_error;
+  ctx->output_error = VPX_CODEC_OK;
+  return res;
+}
+
 static vpx_codec_err_t decoder_set_fb_fn(
     vpx_codec_alg_priv_t *ctx, vpx_get_frame_buffer_cb_fn_t cb_get,
     vpx_release_frame_buffer_cb_fn_t cb_release, void *cb_priv) {
@@ -446,6 +825,10 @@ static vpx_codec_err_t ctrl_set_reference(vpx_codec_alg_priv_t *ctx,
   if (data) {
     vpx_ref_frame_t *const frame = (vpx_ref_frame_t *)data;
     YV12_BUFFER_CONFIG sd;
+    if (ctx->frame_parallel_decode && ctx->pbi != NULL) {
+      const vpx_codec_err_t res = drain_frame_workers(ctx);
+      if (res != VPX_CODEC_OK) return res;
+    }
     image2yuvconfig(&frame->img, &sd);
     return vp9_set_reference_dec(
         &ctx->pbi->common, ref_frame_to_vp9_reframe(frame->frame_type), &sd);
@@ -461,6 +844,10 @@ static vpx_codec_err_t ctrl_copy_reference(vpx_codec_alg_priv_t *ctx,
   if (data) {
     vpx_ref_frame_t *frame = (vpx_ref_frame_t *)data;
     YV12_BUFFER_CONFIG sd;
+    if (ctx->frame_parallel_decode && ctx->pbi != NULL) {
+      const vpx_codec_err_t res = drain_frame_workers(ctx);
+      if (res != VPX_CODEC_OK) return res;
+    }
     image2yuvconfig(&frame->img, &sd);
     return vp9_copy_reference_dec(ctx->pbi, (VP9_REFFRAME)frame->frame_type,
                                   &sd);
@@ -474,8 +861,13 @@ static vpx_codec_err_t ctrl_get_reference(vpx_codec_alg_priv_t *ctx,
   vp9_ref_frame_t *data = va_arg(args, vp9_ref_frame_t *);
 
   if (data) {
-    const int fb_idx = ctx->pbi->common.cur_show_frame_fb_idx;
-    YV12_BUFFER_CONFIG *fb = get_buf_frame(&ctx->pbi->common, fb_idx);
+    YV12_BUFFER_CONFIG *fb;
+    if (ctx->frame_parallel_decode && ctx->pbi != NULL) {
+      const vpx_codec_err_t res = drain_frame_workers(ctx);
+      if (res != VPX_CODEC_OK) return res;
+    }
+    fb = get_buf_frame(&ctx->pbi->common,
+                       ctx->pbi->common.cur_show_frame_fb_idx);
     if (fb == NULL) return VPX_CODEC_ERROR;
     yuvconfig2image(&data->img, fb, NULL);
     return VPX_CODEC_OK;
@@ -534,7 +926,10 @@ static vpx_codec_err_t ctrl_get_frame_corrupted(vpx_codec_alg_priv_t *ctx,
   if (corrupted) {
     if (ctx->pbi != NULL) {
       RefCntBuffer *const frame_bufs = ctx->pbi->common.buffer_pool->frame_bufs;
-      if (ctx->pbi->common.frame_to_show == NULL) return VPX_CODEC_ERROR;
+      // Output lags the decode of frames in frame parallel decode.
+      if (!ctx->frame_parallel_decode &&
+          ctx->pbi->common.frame_to_show == NULL)
+        return VPX_CODEC_ERROR;
       if (ctx->last_show_frame >= 0)
         *corrupted = frame_bufs[ctx->last_show_frame].buf.corrupted;
       return VPX_CODEC_OK;
@@ -661,6 +1056,131 @@ static vpx_codec_err_t ctrl_set_row_mt(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_frame_parallel(vpx_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  // Frame workers are set up when the decoder is initialized.
+  if (ctx->pbi != NULL) return VPX_CODEC_ERROR;
+  ctx->frame_parallel_decode = va_arg(args, int);
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_thread_pool(vpx_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  VPxWorkerPool *const pool =
+      (VPxWorkerPool *)va_arg(args, vpx_codec_thread_pool_t *);
+  // Workers are set up with the decoder.
+  if (ctx->pbi != NULL) return VPX_CODEC_ERROR;
+  if (ctx->thread_pool != NULL) vpx_worker_pool_remove_client(ctx->thread_pool);
+  ctx->thread_pool = pool;
+  if (ctx->thread_pool != NULL) vpx_worker_pool_add_client(ctx->thread_pool);
+
+  return VPX_CODEC_OK;
+}
+
+#if VP9_MAXIMUM_BORROWED_FRAMES != MAX_BORROWED_FRAMES
+#error "FRAME_BUFFERS must leave room for the borrowed frames."
+#endif
+
+static vpx_codec_err_t ctrl_borrow_frame(vpx_codec_alg_priv_t *ctx,
+                                        va_list args) {
+  vp9_borrowed_frame_t *const data = va_arg(args, vp9_borrowed_frame_t *);
+  BufferPool *pool;
+  int fb_idx = INVALID_IDX;
+  void *user_priv = NULL;
+
+  if (data == NULL) return VPX_CODEC_INVALID_PARAM;
+  data->idx = INVALID_IDX;
+  if (ctx->pbi == NULL) return VPX_CODEC_OK;
+  if (ctx->num_borrowed_frames == MAX_BORROWED_FRAMES) {
+    set_error_detail(ctx, "Too many borrowed frames");
+    return VPX_CODEC_ERROR;
+  }
+  pool = ctx->buffer_pool;
+
+  if (ctx->frame_parallel_decode) {
+    // The reference held by the frame cache is handed over.
+    const cache_frame *frame;
+    const vpx_codec_err_t res = frame_parallel_next_frame(ctx, &frame);
+    if (frame == NULL) return res;
+    fb_idx = frame->fb_idx;
+    user_priv = frame->user_priv;
+  } else {
+    YV12_BUFFER_CONFIG sd;
+    // No post-processing, so the frame is not copied.
+    vp9_ppflags_t flags = { 0, 0, 0 };
+    if (vp9_get_raw_frame(ctx->pbi, &sd, &flags) != 0) return VPX_CODEC_OK;
+    ctx->last_show_frame = ctx->pbi->common.new_fb_idx;
+    if (ctx->need_resync) return VPX_CODEC_OK;
+    fb_idx = ctx->pbi->common.new_fb_idx;
+    user_priv = ctx->user_priv;
+    lock_buffer_pool(pool);
+    ++pool->frame_bufs[fb_idx].ref_count;
+    unlock_buffer_pool(pool);
+  }
+
+  ++ctx->borrowed_frames[fb_idx];
+  ++ctx->num_borrowed_frames;
+  data->idx = fb_idx;
+  yuvconfig2image(&data->img, &pool->frame_bufs[fb_idx].buf, user_priv);
+  data->img.fb_priv = pool->frame_bufs[fb_idx].raw_frame_buffer.priv;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_return_frame(vpx_codec_alg_priv_t *ctx,
+                                        va_list args) {
+  vp9_borrowed_frame_t *const data = va_arg(args, vp9_borrowed_frame_t *);
+  BufferPool *const pool = ctx->buffer_pool;
+
+  if (data == NULL || data->idx < 0 || data->idx >= FRAME_BUFFERS ||
+      ctx->borrowed_frames[data->idx] == 0) {
+    return VPX_CODEC_INVALID_PARAM;
+  }
+
+  lock_buffer_pool(pool);
+  decrease_ref_count(data->idx, pool->frame_bufs, pool);
+  unlock_buffer_pool(pool);
+  --ctx->borrowed_frames[data->idx];
+  --ctx->num_borrowed_frames;
+  data->idx = INVALID_IDX;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_frame_buffer_flags(vpx_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  const int flags = va_arg(args, int);
+  // Applied when the frame buffers are set up with the decoder.
+  if (ctx->pbi != NULL) return VPX_CODEC_ERROR;
+  if (flags & ~(VP9_FRAME_BUFFER_PREFAULT | VP9_FRAME_BUFFER_HUGE_PAGES))
+    return VPX_CODEC_INVALID_PARAM;
+  ctx->frame_buffer_flags = flags;
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_get_frame_buffer_stats(vpx_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  vp9_frame_buffer_stats_t *const stats =
+      va_arg(args, vp9_frame_buffer_stats_t *);
+
+  if (stats) {
+    if (ctx->pbi != NULL) {
+      BufferPool *const pool = ctx->buffer_pool;
+      const InternalFrameBufferList *const list = &pool->int_frame_buffers;
+      lock_buffer_pool(pool);
+      stats->num_allocs = list->num_allocs;
+      stats->num_recycles = list->num_recycles;
+      stats->bytes_allocated = list->bytes_allocated;
+      unlock_buffer_pool(pool);
+      return VPX_CODEC_OK;
+    } else {
+      return VPX_CODEC_ERROR;
+    }
+  }
+
+  return VPX_CODEC_INVALID_PARAM;
+}
+
 static vpx_codec_err_t ctrl_enable_lpf_opt(vpx_codec_alg_priv_t *ctx,
                                            va_list args) {
   ctx->lpf_opt = va_arg(args, int);
@@ -668,6 +1188,39 @@ static vpx_codec_err_t ctrl_enable_lpf_opt(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_fused_loop_filter(vpx_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  ctx->fused_lf = va_arg(args, int);
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_stage_stats(vpx_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  // Applied when the decoder is created.
+  if (ctx->pbi != NULL) return VPX_CODEC_ERROR;
+  ctx->stage_stats = va_arg(args, int);
+
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_get_stage_stats(vpx_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  vp9_stage_stats_t *const stats = va_arg(args, vp9_stage_stats_t *);
+
+  if (stats) {
+    if (ctx->pbi != NULL && ctx->pbi->stage_stats) {
+      // In frame parallel decode, the last frame collected from the workers.
+      *stats = ctx->pbi->last_stage_stats;
+      return VPX_CODEC_OK;
+    } else {
+      return VPX_CODEC_ERROR;
+    }
+  }
+
+  return VPX_CODEC_INVALID_PARAM;
+}
+
 static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP8_COPY_REFERENCE, ctrl_copy_reference },
 
@@ -681,6 +1234,12 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP9_DECODE_SVC_SPATIAL_LAYER, ctrl_set_spatial_layer_svc },
   { VP9D_SET_ROW_MT, ctrl_set_row_mt },
   { VP9D_SET_LOOP_FILTER_OPT, ctrl_enable_lpf_opt },
+  { VP9D_SET_FRAME_PARALLEL, ctrl_set_frame_parallel },
+  { VP9D_SET_THREAD_POOL, ctrl_set_thread_pool },
+  { VP9D_RETURN_FRAME, ctrl_return_frame },
+  { VP9D_SET_FRAME_BUFFER_FLAGS, ctrl_set_frame_buffer_flags },
+  { VP9D_SET_FUSED_LOOP_FILTER, ctrl_set_fused_loop_filter },
+  { VP9D_SET_STAGE_STATS, ctrl_set_stage_stats },
 
   // Getters
   { VPXD_GET_LAST_QUANTIZER, ctrl_get_quantizer },
@@ -690,6 +1249,9 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP9D_GET_DISPLAY_SIZE, ctrl_get_render_size },
   { VP9D_GET_BIT_DEPTH, ctrl_get_bit_depth },
   { VP9D_GET_FRAME_SIZE, ctrl_get_frame_size },
+  { VP9D_BORROW_FRAME, ctrl_borrow_frame },
+  { VP9D_GET_FRAME_BUFFER_STATS, ctrl_get_frame_buffer_stats },
+  { VP9D_GET_STAGE_STATS, ctrl_get_stage_stats },
 
   { -1, NULL },
 };
@@ -704,10 +1266,11 @@ CODEC_INTERFACE(vpx_codec_vp9_dx) = {
   VPX_CODEC_CAP_HIGHBITDEPTH |
 #endif
       VPX_CODEC_CAP_DECODER | VP9_CAP_POSTPROC |
-      VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER,  // vpx_codec_caps_t
-  decoder_init,                             // vpx_codec_init_fn_t
-  decoder_destroy,                          // vpx_codec_destroy_fn_t
-  decoder_ctrl_maps,                        // vpx_codec_ctrl_fn_map_t
+      VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER | VPX_CODEC_CAP_PUT_FRAME |
+      VPX_CODEC_CAP_ASYNC,  // vpx_codec_caps_t
+  decoder_init,             // vpx_codec_init_fn_t
+  decoder_destroy,          // vpx_codec_destroy_fn_t
+  decoder_ctrl_maps,        // vpx_codec_ctrl_fn_map_t
   {
       // NOLINT
       decoder_peek_si,    // vpx_codec_peek_si_fn_t
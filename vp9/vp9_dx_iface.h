@@ -15,6 +15,14 @@
 
 typedef vpx_codec_stream_info_t vp9_stream_info_t;
 
+// Decoded frames waiting to be output in frame parallel decode.
+#define FRAME_CACHE_SIZE MAX_DECODE_THREADS
+
+typedef struct {
+  int fb_idx;
+  void *user_priv;
+} cache_frame;
+
 struct vpx_codec_alg_priv {
   vpx_codec_priv_t base;
   vpx_codec_dec_cfg_t cfg;
@@ -47,6 +55,31 @@ struct vpx_codec_alg_priv {
   int svc_spatial_layer;
   int row_mt;
   int lpf_opt;
+  int fused_lf;
+  int stage_stats;
+  VPxWorkerPool *thread_pool;  // Shared by the decoders attached to it.
+  int frame_buffer_flags;
+
+  // Frame parallel related.
+  int frame_parallel_decode;  // frame-based threading.
+  VPxWorker *frame_workers;
+  int num_frame_workers;
+  int num_busy_workers;  // Workers with a frame that has not been output.
+  int next_submit_worker_id;
+  int last_submit_worker_id;
+  int next_output_worker_id;
+  int hold_last_show_frame;  // last_show_frame is held until the next call.
+  cache_frame frame_cache[FRAME_CACHE_SIZE];
+  int frame_cache_write;
+  int frame_cache_read;
+  int num_cache_frames;
+  // Error of a frame retired while getting the frames for output, returned by
+  // the next decode call.
+  vpx_codec_err_t output_error;
+
+  // References held on each frame buffer by VP9D_BORROW_FRAME.
+  int borrowed_frames[FRAME_BUFFERS];
+  int num_borrowed_frames;
 };
 
 #endif  // VPX_VP9_VP9_DX_IFACE_H_
@@ -12,8 +12,10 @@
  * \brief Provides the high level interface to wrap decoder algorithms.
  *
  */
+#include <limits.h>
 #include <string.h>
 #include "vpx/internal/vpx_codec_internal.h"
+#include "vpx_util/vpx_thread.h"
 
 #define SAVE_STATUS(ctx, var) (ctx ? (ctx->err = var) : var)
 
@@ -42,6 +44,9 @@ vpx_codec_err_t vpx_codec_dec_init_ver(vpx_codec_ctx_t *ctx,
   else if ((flags & VPX_CODEC_USE_INPUT_FRAGMENTS) &&
            !(iface->caps & VPX_CODEC_CAP_INPUT_FRAGMENTS))
     res = VPX_CODEC_INCAPABLE;
+  else if ((flags & VPX_CODEC_USE_ASYNC) &&
+           !(iface->caps & VPX_CODEC_CAP_ASYNC))
+    res = VPX_CODEC_INCAPABLE;
   else if (!(iface->caps & VPX_CODEC_CAP_DECODER))
     res = VPX_CODEC_INCAPABLE;
   else {
@@ -186,3 +191,13 @@ vpx_codec_err_t vpx_codec_set_frame_buffer_functions(
 
   return SAVE_STATUS(ctx, res);
 }
+
+vpx_codec_thread_pool_t *vpx_codec_thread_pool_create(
+    unsigned int num_threads) {
+  if (num_threads == 0 || num_threads > INT_MAX) return NULL;
+  return (vpx_codec_thread_pool_t *)vpx_worker_pool_create((int)num_threads);
+}
+
+void vpx_codec_thread_pool_destroy(vpx_codec_thread_pool_t *pool) {
+  vpx_worker_pool_destroy((VPxWorkerPool *)pool);
+}
@@ -676,6 +676,114 @@ enum vp8e_enc_control_id {
    * Supported in codecs: VP9
    */
   VP9E_SET_POSTENCODE_DROP,
+
+  /*!\brief Codec control function to pipeline the loop filter.
+   *
+   * When enabled, the loop filter of a frame runs on a separate thread while
+   * the bitstream of that frame is packed, and keeps running until the next
+   * call into the encoder that needs the reconstructed frame. The output is
+   * the same as with the option disabled.
+   *
+   * The option has no effect once the encoder runs more than one worker
+   * thread, as with several tile columns or row based multi-threading. The
+   * workers then filter the rows of the frame in parallel, before the
+   * bitstream is packed.
+   *
+   * 0: Off (default), 1: Enabled
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_LOOPFILTER_PIPELINE,
+
+  /*!\brief Codec control function to lend source images to the encoder.
+   *
+   * Takes a vpx_source_release_cb_t. While a callback is set, every image
+   * passed to vpx_codec_encode() is handed back through it exactly once, when
+   * the encoder no longer reads it, also when vpx_codec_encode() fails. The
+   * image must stay unchanged and valid until then. Images that can not be
+   * used in place are copied and handed back before vpx_codec_encode()
+   * returns.
+   *
+   * An image is read in place when the encoder is not in the first pass and
+   * has no spatial layers, no resizing and no denoising, and the image is
+   * allocated at least 16 pixels and up to the next multiple of 64 beyond its
+   * display size rounded up to a multiple of 8, starting from its first pixel
+   * (for example with vpx_img_alloc() or vpx_img_wrap() on the larger size
+   * followed by vpx_img_set_rect()). With g_lag_in_frames not 0, the image
+   * needs to be allocated at least 48 pixels beyond that rounded size, and
+   * with a margin of 16 pixels above and left of it, which vpx_img_set_rect()
+   * at 16, 16 leaves. The encoder replicates the edge pixels into the
+   * padding and margin. Images held for lookahead are handed back once they
+   * have left the lookahead and alt-ref filtering window, and images still
+   * held when the encoder is destroyed are handed back then.
+   *
+   * Setting a NULL release_source stops lending new images.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_SOURCE_RELEASE_CB,
+
+  /*!\brief Codec control function to mark inactive blocks as unchanged.
+   *
+   * When enabled, the blocks set inactive in the active map must be the same
+   * in each source image as in the image before it. Only the active blocks
+   * are then copied from the source images. This needs an encoder without
+   * lag, spatial layers, resizing or denoising, and has no effect otherwise.
+   *
+   * 0: Off (default), 1: Enabled
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_INACTIVE_UNCHANGED,
+
+  /*!\brief Codec control function to time the encoding stages of each frame.
+   *
+   * 0 : off, 1 : on. Off by default. The counters are read with
+   * #VP9E_GET_FRAME_STAGE_STATS.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_FRAME_STAGE_STATS,
+
+  /*!\brief Codec control function to get the stage counters of the last
+   * encoded frame, see #vp9e_stage_stats_t.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_GET_FRAME_STAGE_STATS,
+
+  /*!\brief Codec control function to pick the loop filter level from a
+   * sample of the superblock rows.
+   *
+   * Only applies when the encoder searches for the level. The sampled search
+   * is faster but can pick a different level than the full search.
+   *
+   * 0: Search the whole frame (default), 1: Search sampled rows
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_SAMPLED_LPF_PICK,
+
+  /*!\brief Codec control function to get the loop filter level of the last
+   * encoded frame.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_GET_LOOPFILTER_LEVEL,
+
+  /*!\brief Codec control function to merge the first pass stats of
+   * consecutive parts of a clip.
+   *
+   * The argument's buffer holds the per frame stats packets of the whole
+   * clip in display order, as returned by the encoders that analyzed each
+   * part, followed by space for one more packet. The frames are renumbered
+   * from 0 and the last packet is set to their totals, so the buffer can be
+   * used as rc_twopass_stats_in. It does not depend on the state of the
+   * encoder it is called on.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_MERGE_FIRSTPASS_STATS,
 };
 
 /*!\brief vpx 1-D scaling mode
@@ -865,6 +973,57 @@ typedef struct vpx_svc_spatial_layer_sync {
   int base_layer_intra_only; /**< Flag for setting Intra-only frame on base */
 } vpx_svc_spatial_layer_sync_t;
 
+/*!\brief Callback that hands a lent source image back to the application.
+ *
+ * \param[in] user_priv  The user_priv of the vpx_source_release_cb_t
+ * \param[in] img        The image passed to vpx_codec_encode()
+ */
+typedef void (*vpx_release_source_cb_fn_t)(void *user_priv,
+                                           const vpx_image_t *img);
+
+/*!\brief vp9 source image release callback.
+ *
+ * This defines the callback used with VP9E_SET_SOURCE_RELEASE_CB.
+ */
+typedef struct vpx_source_release_cb {
+  vpx_release_source_cb_fn_t release_source; /**< Release callback */
+  void *user_priv; /**< Pointer passed to the callback */
+} vpx_source_release_cb_t;
+
+/*!\brief Encoding stages timed by #VP9E_SET_FRAME_STAGE_STATS */
+enum vp9e_encoder_stage {
+  VP9E_STAGE_TEMPORAL_FILTER,  /**< ARNR filtering of the lookahead frames */
+  VP9E_STAGE_TPL,              /**< temporal dependency model */
+  VP9E_STAGE_PARTITION_SEARCH, /**< partition search, less the next 2 stages */
+  VP9E_STAGE_MODE_DECISION,    /**< RD/pickmode search and its dry runs */
+  VP9E_STAGE_QUANTIZE,         /**< transform and quantize the final modes */
+  VP9E_STAGE_LOOP_FILTER_PICK, /**< loop filter level search */
+  VP9E_STAGE_BITSTREAM,        /**< bitstream packing */
+  VP9E_ENCODER_STAGES
+};
+
+/*!\brief Maximum number of threads reported in #vp9e_stage_stats_t. */
+#define VP9E_STAGE_STATS_MAX_THREADS 64
+
+/*!\brief Per frame encoder stage counters
+ *
+ * Used with #VP9E_GET_FRAME_STAGE_STATS. Ticks are timestamp counter cycles on
+ * x86 and nanoseconds elsewhere; frame_usec relates them to wall clock time.
+ * Stage ticks are summed over all the threads encoding the frame, and over all
+ * the encodes of a frame the rate control loop makes. A thread is busy while
+ * it encodes superblocks and idle for the rest of the tile encoding, such as
+ * while it waits for the superblock row above or for the other threads.
+ */
+typedef struct vp9e_stage_stats {
+  uint64_t stage_ticks[VP9E_ENCODER_STAGES]; /**< time in each stage */
+  uint64_t frame_ticks; /**< time to encode the frame */
+  int64_t frame_usec;   /**< time to encode the frame in microseconds */
+  int encode_passes;    /**< times the frame was encoded */
+  int num_threads;      /**< threads that encoded tiles */
+  uint64_t thread_busy_ticks[VP9E_STAGE_STATS_MAX_THREADS]; /**< per thread */
+  uint64_t thread_idle_ticks[VP9E_STAGE_STATS_MAX_THREADS]; /**< per thread */
+} vp9e_stage_stats_t;
+
 /*!\cond */
 /*!\brief VP8 encoder control function parameter type
  *
@@ -1021,6 +1180,27 @@ VPX_CTRL_USE_TYPE(VP9E_SET_SVC_SPATIAL_LAYER_SYNC,
 VPX_CTRL_USE_TYPE(VP9E_SET_POSTENCODE_DROP, unsigned int)
 #define VPX_CTRL_VP9E_SET_POSTENCODE_DROP
 
+VPX_CTRL_USE_TYPE(VP9E_SET_LOOPFILTER_PIPELINE, unsigned int)
+#define VPX_CTRL_VP9E_SET_LOOPFILTER_PIPELINE
+
+VPX_CTRL_USE_TYPE(VP9E_SET_SOURCE_RELEASE_CB, vpx_source_release_cb_t *)
+#define VPX_CTRL_VP9E_SET_SOURCE_RELEASE_CB
+
+VPX_CTRL_USE_TYPE(VP9E_SET_INACTIVE_UNCHANGED, unsigned int)
+#define VPX_CTRL_VP9E_SET_INACTIVE_UNCHANGED
+
+VPX_CTRL_USE_TYPE(VP9E_SET_FRAME_STAGE_STATS, int)
+#define VPX_CTRL_VP9E_SET_FRAME_STAGE_STATS
+VPX_CTRL_USE_TYPE(VP9E_GET_FRAME_STAGE_STATS, vp9e_stage_stats_t *)
+#define VPX_CTRL_VP9E_GET_FRAME_STAGE_STATS
+
+VPX_CTRL_USE_TYPE(VP9E_SET_SAMPLED_LPF_PICK, unsigned int)
+#define VPX_CTRL_VP9E_SET_SAMPLED_LPF_PICK
+VPX_CTRL_USE_TYPE(VP9E_GET_LOOPFILTER_LEVEL, int *)
+#define VPX_CTRL_VP9E_GET_LOOPFILTER_LEVEL
+VPX_CTRL_USE_TYPE(VP9E_MERGE_FIRSTPASS_STATS, vpx_fixed_buf_t *)
+#define VPX_CTRL_VP9E_MERGE_FIRSTPASS_STATS
+
 /*!\endcond */
 /*! @} - end defgroup vp8_encoder */
 #ifdef __cplusplus
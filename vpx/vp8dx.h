@@ -26,6 +26,7 @@ extern "C" {
 
 /* Include controls common to both the encoder and decoder */
 #include "./vp8.h"
+#include "./vpx_decoder.h"
 
 /*!\name Algorithm interface for VP8
  *
@@ -142,9 +143,165 @@ enum vp8_dec_control_id {
    */
   VP9D_SET_LOOP_FILTER_OPT,
 
+  /*!\brief Codec control function to enable frame parallel decoding.
+   *
+   * 0 : off, 1 : on
+   *
+   * Decodes up to the configured number of threads frames at once, each frame
+   * waiting on the rows of its references as they are decoded. Output is
+   * delayed by that many frames, so the decoder must be flushed with a NULL
+   * data pointer to get the last frames. Packets holding several frames need
+   * a superframe index. Must be set before the first frame is decoded and is
+   * not compatible with post-processing.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_FRAME_PARALLEL,
+
+  /*!\brief Codec control function to run the decoder threads on a pool.
+   *
+   * Takes a pool from vpx_codec_thread_pool_create(), or NULL to use threads
+   * owned by the decoder. The tile, row and loop filter jobs of all the
+   * decoders attached to a pool share its threads, each decoder getting at
+   * most its fair share of them. The number of threads configured for the
+   * decoder still bounds how many jobs it splits a frame into. Must be set
+   * before the first frame is decoded. The pool must outlive the decoder.
+   * Frame parallel decoding keeps its own threads.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_THREAD_POOL,
+
+  /*!\brief Codec control function to get the next frame without a copy.
+   *
+   * Used instead of vpx_codec_get_frame(). The image points to the decoder's
+   * own frame buffer, which is not post-processed, and is held until it is
+   * passed back with #VP9D_RETURN_FRAME, so it stays valid across decode
+   * calls. idx is set to -1 if there is no frame to output. At most
+   * #VP9_MAXIMUM_BORROWED_FRAMES frames can be held at once; when using
+   * external frame buffers, as many more buffers are needed. Frames must be
+   * returned before the decoder is destroyed.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_BORROW_FRAME,
+
+  /*!\brief Codec control function to return a frame from #VP9D_BORROW_FRAME.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_RETURN_FRAME,
+
+  /*!\brief Codec control function to set how internal frame buffers are
+   * allocated.
+   *
+   * Takes a combination of #vp9_frame_buffer_flags, 0 by default. Must be set
+   * before the first frame is decoded. Has no effect with external frame
+   * buffers.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_FRAME_BUFFER_FLAGS,
+
+  /*!\brief Codec control function to get the internal frame buffer counters.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_GET_FRAME_BUFFER_STATS,
+
+  /*!\brief Codec control function to fuse the loop filter into decoding.
+   *
+   * 0 : off, Loop filter is run a superblock row at a time.
+   * 1 : on, Each superblock is filtered as soon as the superblocks that
+   *     predict from it have been decoded, while it is still in cache.
+   *
+   * On by default. Only applies to frames decoded by a single thread.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_FUSED_LOOP_FILTER,
+
+  /*!\brief Codec control function to time the decoding stages of each frame.
+   *
+   * 0 : off, 1 : on. Off by default. Must be set before the first frame is
+   * decoded. The counters are read with #VP9D_GET_STAGE_STATS.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_STAGE_STATS,
+
+  /*!\brief Codec control function to get the stage counters of the last
+   * decoded frame, see #vp9_stage_stats_t.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_GET_STAGE_STATS,
+
   VP8_DECODER_CTRL_ID_MAX
 };
 
+/*!\brief Internal frame buffer allocation flags
+ *
+ * Used with #VP9D_SET_FRAME_BUFFER_FLAGS.
+ */
+enum vp9_frame_buffer_flags {
+  /*!\brief Fault the pages of a buffer in when it is allocated instead of
+   * while a frame is decoded into it. */
+  VP9_FRAME_BUFFER_PREFAULT = 1 << 0,
+  /*!\brief Back the buffers with huge pages where supported. Implies
+   * #VP9_FRAME_BUFFER_PREFAULT. */
+  VP9_FRAME_BUFFER_HUGE_PAGES = 1 << 1
+};
+
+/*!\brief Internal frame buffer counters
+ *
+ * Buffers are recycled across resolution changes: a request is served by the
+ * smallest free buffer that is large enough, and new buffers are rounded up
+ * to a size class.
+ */
+typedef struct vp9_frame_buffer_stats {
+  unsigned int num_allocs;   /**< requests that allocated a buffer */
+  unsigned int num_recycles; /**< requests served by a free buffer */
+  size_t bytes_allocated;    /**< size of the buffers currently allocated */
+} vp9_frame_buffer_stats_t;
+
+/*!\brief Decoding stages timed by #VP9D_SET_STAGE_STATS */
+enum vp9_decoder_stage {
+  VP9_STAGE_MODE_INFO,         /**< reading the modes and motion vectors */
+  VP9_STAGE_DETOKENIZE,        /**< reading the coefficients */
+  VP9_STAGE_PREDICTION,        /**< intra and inter prediction */
+  VP9_STAGE_INVERSE_TRANSFORM, /**< dequantized coefficients to residual */
+  VP9_STAGE_LOOP_FILTER,       /**< loop filtering */
+  VP9_DECODER_STAGES
+};
+
+/*!\brief Per frame decoder stage counters
+ *
+ * Used with #VP9D_GET_STAGE_STATS. Ticks are timestamp counter cycles on x86
+ * and nanoseconds elsewhere; frame_usec relates them to wall clock time.
+ * Stage and idle ticks are summed over all the threads decoding the frame.
+ */
+typedef struct vp9_stage_stats {
+  uint64_t stage_ticks[VP9_DECODER_STAGES]; /**< time in each stage */
+  uint64_t idle_ticks;      /**< time threads waited on each other */
+  uint64_t frame_ticks;     /**< time to decode the frame */
+  int64_t frame_usec;       /**< time to decode the frame in microseconds */
+  size_t bytes_read;        /**< compressed size of the frame */
+  unsigned int superblocks; /**< 64x64 superblocks decoded */
+} vp9_stage_stats_t;
+
+/*!\brief Maximum number of frames held with #VP9D_BORROW_FRAME. */
+#define VP9_MAXIMUM_BORROWED_FRAMES 8
+
+/*!\brief Frame held by the application
+ *
+ * Used with #VP9D_BORROW_FRAME and #VP9D_RETURN_FRAME.
+ */
+typedef struct vp9_borrowed_frame {
+  int idx;         /**< buffer holding the frame (output) */
+  vpx_image_t img; /**< img structure to populate (output) */
+} vp9_borrowed_frame_t;
+
 /** Decrypt n bytes of data from input -> output, using the decrypt_state
  *  passed in VPXD_SET_DECRYPTOR.
  */
@@ -199,6 +356,24 @@ VPX_CTRL_USE_TYPE(VP9_SET_SKIP_LOOP_FILTER, int)
 VPX_CTRL_USE_TYPE(VP9D_SET_ROW_MT, int)
 #define VPX_CTRL_VP9_SET_LOOP_FILTER_OPT
 VPX_CTRL_USE_TYPE(VP9D_SET_LOOP_FILTER_OPT, int)
+#define VPX_CTRL_VP9D_SET_FRAME_PARALLEL
+VPX_CTRL_USE_TYPE(VP9D_SET_FRAME_PARALLEL, int)
+#define VPX_CTRL_VP9D_SET_THREAD_POOL
+VPX_CTRL_USE_TYPE(VP9D_SET_THREAD_POOL, vpx_codec_thread_pool_t *)
+#define VPX_CTRL_VP9D_BORROW_FRAME
+VPX_CTRL_USE_TYPE(VP9D_BORROW_FRAME, vp9_borrowed_frame_t *)
+#define VPX_CTRL_VP9D_RETURN_FRAME
+VPX_CTRL_USE_TYPE(VP9D_RETURN_FRAME, vp9_borrowed_frame_t *)
+#define VPX_CTRL_VP9D_SET_FRAME_BUFFER_FLAGS
+VPX_CTRL_USE_TYPE(VP9D_SET_FRAME_BUFFER_FLAGS, int)
+#define VPX_CTRL_VP9D_GET_FRAME_BUFFER_STATS
+VPX_CTRL_USE_TYPE(VP9D_GET_FRAME_BUFFER_STATS, vp9_frame_buffer_stats_t *)
+#define VPX_CTRL_VP9D_SET_FUSED_LOOP_FILTER
+VPX_CTRL_USE_TYPE(VP9D_SET_FUSED_LOOP_FILTER, int)
+#define VPX_CTRL_VP9D_SET_STAGE_STATS
+VPX_CTRL_USE_TYPE(VP9D_SET_STAGE_STATS, int)
+#define VPX_CTRL_VP9D_GET_STAGE_STATS
+VPX_CTRL_USE_TYPE(VP9D_GET_STAGE_STATS, vp9_stage_stats_t *)
 
 /*!\endcond */
 /*! @} - end defgroup vp8_decoder */
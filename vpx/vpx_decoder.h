@@ -70,6 +70,8 @@ extern "C" {
 #define VPX_CODEC_CAP_FRAME_THREADING 0x200000
 /*!brief Can support external frame buffers */
 #define VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER 0x400000
+/*!\brief Can decode asynchronously, see \ref async_decode */
+#define VPX_CODEC_CAP_ASYNC 0x800000
 
 #define VPX_CODEC_USE_POSTPROC 0x10000 /**< Postprocess decoded frame */
 /*!\brief Conceal errors in decoded frames */
@@ -79,6 +81,8 @@ extern "C" {
 #define VPX_CODEC_USE_INPUT_FRAGMENTS 0x40000
 /*!\brief Enable frame-based multi-threading */
 #define VPX_CODEC_USE_FRAME_THREADING 0x80000
+/*!\brief Decode in the background, see \ref async_decode */
+#define VPX_CODEC_USE_ASYNC 0x100000
 
 /*!\brief Stream properties
  *
@@ -273,6 +277,31 @@ vpx_codec_err_t vpx_codec_register_put_frame_cb(vpx_codec_ctx_t *ctx,
 
 /*!@} - end defgroup cap_put_frame */
 
+/*!\defgroup async_decode Asynchronous Decoding
+ *
+ * Decoders that advertise the VPX_CODEC_CAP_ASYNC capability may be
+ * initialized with VPX_CODEC_USE_ASYNC. vpx_codec_decode() then queues the
+ * coded data for decoding on the decoder's threads and returns without
+ * waiting for the frame, so consecutive frames are parsed and decoded while
+ * the application prepares the next buffers. It blocks only when
+ * cfg.threads frames are already in flight. The data is copied and may be
+ * reused once the call returns.
+ *
+ * vpx_codec_get_frame() does not block in this mode: it returns the frames
+ * that have finished decoding, in order, and NULL if the next one is not
+ * ready yet. Calling vpx_codec_decode() with NULL data flushes the decoder,
+ * after which vpx_codec_get_frame() waits for the frames still in flight.
+ *
+ * Alternatively, a callback registered with
+ * vpx_codec_register_put_frame_cb() receives the frames. It is called on the
+ * application's thread from within vpx_codec_decode(), with every frame
+ * finished by then, and with all the remaining frames when flushing. The
+ * image is valid until the callback returns.
+ *
+ * An error in a frame is returned by the vpx_codec_decode() call that
+ * follows its completion.
+ */
+
 /*!\defgroup cap_put_slice Slice-Based Decoding Functions
  *
  * The following functions are required to be implemented for all decoders
@@ -358,6 +387,37 @@ vpx_codec_err_t vpx_codec_set_frame_buffer_functions(
 
 /*!@} - end defgroup cap_external_frame_buffer */
 
+/*!\defgroup thread_pool Shared Thread Pool
+ *
+ * Several decoder instances may run their threads on one pool, so that a
+ * process decoding many streams does not create threads for each of them.
+ * A decoder is attached to a pool with a codec control, see
+ * #VP9D_SET_THREAD_POOL.
+ * @{
+ */
+
+/*!\brief Opaque thread pool handle. */
+typedef struct vpx_codec_thread_pool vpx_codec_thread_pool_t;
+
+/*!\brief Create a thread pool.
+ *
+ * \param[in] num_threads  Number of threads of the pool
+ *
+ * \return The pool, or NULL if the threads could not be created or
+ *     multithreading is not supported.
+ */
+vpx_codec_thread_pool_t *vpx_codec_thread_pool_create(unsigned int num_threads);
+
+/*!\brief Destroy a thread pool.
+ *
+ * All the decoders attached to the pool must have been destroyed first.
+ *
+ * \param[in] pool  Pool to destroy, may be NULL
+ */
+void vpx_codec_thread_pool_destroy(vpx_codec_thread_pool_t *pool);
+
+/*!@} - end defgroup thread_pool */
+
 /*!@} - end defgroup decoder*/
 #ifdef __cplusplus
 }
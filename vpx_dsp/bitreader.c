@@ -56,29 +56,33 @@ void vpx_reader_fill(vpx_reader *r) {
     BD_VALUE nv;
     BD_VALUE big_endian_values;
     memcpy(&big_endian_values, buffer, sizeof(BD_VALUE));
-#if SIZE_MAX == 0xffffffffffffffffULL
     big_endian_values = HToBE64(big_endian_values);
-#else
-    big_endian_values = HToBE32(big_endian_values);
-#endif
     nv = big_endian_values >> (BD_VALUE_SIZE - bits);
     count += bits;
     buffer += (bits >> 3);
     value = r->value | (nv << (shift & 0x7));
   } else {
+    // Near the end of the buffer, load the remaining bytes the same way
+    // through a zero padded copy instead of one byte at a time.
     const int bits_over = (int)(shift + CHAR_BIT - (int)bits_left);
-    int loop_end = 0;
+    size_t bytes = bytes_left;
     if (bits_over >= 0) {
       count += LOTS_OF_BITS;
-      loop_end = bits_over;
+    } else {
+      bytes = (shift >> 3) + 1;
     }
 
-    if (bits_over < 0 || bits_left) {
-      while (shift >= loop_end) {
-        count += CHAR_BIT;
-        value |= (BD_VALUE)*buffer++ << shift;
-        shift -= CHAR_BIT;
-      }
+    if (bytes) {
+      uint8_t tail[sizeof(BD_VALUE)] = { 0 };
+      BD_VALUE big_endian_values;
+      memcpy(tail, buffer, bytes);
+      memcpy(&big_endian_values, tail, sizeof(BD_VALUE));
+      big_endian_values = HToBE64(big_endian_values);
+      count += (int)bytes * CHAR_BIT;
+      buffer += bytes;
+      value |= (big_endian_values >> (BD_VALUE_SIZE - CHAR_BIT -
+                                      (shift & 0xfffffff8)))
+               << (shift & 0x7);
     }
   }
 
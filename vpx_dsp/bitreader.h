@@ -28,10 +28,22 @@
 extern "C" {
 #endif
 
-typedef size_t BD_VALUE;
+// The value window is 64 bits on every target. A refill then tops it up to
+// at least BD_VALUE_SIZE - 15 buffered bits, which lets callers read a run of
+// bools after a single refill check (see VPX_READER_BOOLS_PER_FILL).
+typedef uint64_t BD_VALUE;
 
 #define BD_VALUE_SIZE ((int)sizeof(BD_VALUE) * CHAR_BIT)
 
+// A bool consumes at most this many bits of 'count' (vpx_norm[] <= 7).
+#define VPX_READER_MAX_BOOL_BITS 7
+
+// Once 'count' is at least VPX_READER_MAX_BOOL_BITS * (n - 1), the next n
+// bools can be read without checking it. A refill guarantees this for up to
+// VPX_READER_BOOLS_PER_FILL bools.
+#define VPX_READER_BOOLS_PER_FILL \
+  ((BD_VALUE_SIZE - 15) / VPX_READER_MAX_BOOL_BITS + 1)
+
 // This is meant to be a large, positive constant that can still be efficiently
 // loaded as an immediate (on platforms like ARM, for example).
 // Even relatively modest values like 100 would work fine.
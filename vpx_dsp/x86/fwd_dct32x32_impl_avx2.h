@@ -11,7 +11,10 @@
 #include <immintrin.h>  // AVX2
 
 #include "./vpx_dsp_rtcd.h"
+#include "vpx_dsp/fwd_txfm.h"
 #include "vpx_dsp/txfm_common.h"
+#include "vpx_dsp/x86/fwd_txfm_avx2.h"
+#include "vpx_dsp/x86/fwd_txfm_sse2.h"
 
 #define pair256_set_epi16(a, b)                                            \
   _mm256_set_epi16((int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a), \
@@ -23,24 +26,50 @@
   _mm256_set_epi32((int)(b), (int)(a), (int)(b), (int)(a), (int)(b), (int)(a), \
                    (int)(b), (int)(a))
 
+#if DCT_HIGH_BIT_DEPTH
+// Saturate instead of wrapping and remember the largest magnitude, so that
+// blocks whose intermediates leave the 16 bit range can be redone in C.
+#define ADD_EPI16(a, b) adds_epi16_overflow_avx2(a, b, &overflow)
+#define SUB_EPI16(a, b) subs_epi16_overflow_avx2(a, b, &overflow)
+#define PACKS_EPI32(a, b) packs_epi32_overflow_avx2(a, b, &overflow)
+#define K_MADD_EPI32(a, b) k_madd_epi32_overflow_avx2(a, b, &overflow)
 #if FDCT32x32_HIGH_PRECISION
-static INLINE __m256i k_madd_epi32_avx2(__m256i a, __m256i b) {
-  __m256i buf0, buf1;
-  buf0 = _mm256_mul_epu32(a, b);
-  a = _mm256_srli_epi64(a, 32);
-  b = _mm256_srli_epi64(b, 32);
-  buf1 = _mm256_mul_epu32(a, b);
-  return _mm256_add_epi64(buf0, buf1);
+static void vpx_fdct32x32_rows_c(const int16_t *intermediate, tran_low_t *out) {
+  int i, j;
+  for (i = 0; i < 32; ++i) {
+    tran_high_t temp_in[32], temp_out[32];
+    for (j = 0; j < 32; ++j) temp_in[j] = intermediate[j * 32 + i];
+    vpx_fdct32(temp_in, temp_out, 0);
+    for (j = 0; j < 32; ++j)
+      out[j + i * 32] =
+          (tran_low_t)((temp_out[j] + 1 + (temp_out[j] < 0)) >> 2);
+  }
 }
-
-static INLINE __m256i k_packs_epi64_avx2(__m256i a, __m256i b) {
-  __m256i buf0 = _mm256_shuffle_epi32(a, _MM_SHUFFLE(0, 0, 2, 0));
-  __m256i buf1 = _mm256_shuffle_epi32(b, _MM_SHUFFLE(0, 0, 2, 0));
-  return _mm256_unpacklo_epi64(buf0, buf1);
+#define HIGH_FDCT32x32_2D_C vpx_highbd_fdct32x32_c
+#define HIGH_FDCT32x32_2D_ROWS_C vpx_fdct32x32_rows_c
+#else
+static void vpx_fdct32x32_rd_rows_c(const int16_t *intermediate,
+                                    tran_low_t *out) {
+  int i, j;
+  for (i = 0; i < 32; ++i) {
+    tran_high_t temp_in[32], temp_out[32];
+    for (j = 0; j < 32; ++j) temp_in[j] = intermediate[j * 32 + i];
+    vpx_fdct32(temp_in, temp_out, 1);
+    for (j = 0; j < 32; ++j) out[j + i * 32] = (tran_low_t)temp_out[j];
+  }
 }
-#endif
-
-void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
+#define HIGH_FDCT32x32_2D_C vpx_highbd_fdct32x32_rd_c
+#define HIGH_FDCT32x32_2D_ROWS_C vpx_fdct32x32_rd_rows_c
+#endif  // FDCT32x32_HIGH_PRECISION
+#else
+#define ADD_EPI16 _mm256_add_epi16
+#define SUB_EPI16 _mm256_sub_epi16
+#define PACKS_EPI32 _mm256_packs_epi32
+#define K_MADD_EPI32 k_madd_epi32_avx2
+#endif  // DCT_HIGH_BIT_DEPTH
+
+void FDCT32x32_2D_AVX2(const int16_t *input, tran_low_t *output_org,
+                       int stride) {
   // Calculate pre-multiplied strides
   const int str1 = stride;
   const int str2 = 2 * stride;
@@ -93,6 +122,9 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
   const __m256i kOne = _mm256_set1_epi16(1);
   // Do the two transform/transpose passes
   int pass;
+#if DCT_HIGH_BIT_DEPTH
+  __m256i overflow = _mm256_setzero_si256();
+#endif
   for (pass = 0; pass < 2; ++pass) {
     // We process sixteen columns (transposed rows in second pass) at a time.
     int column_start;
@@ -128,14 +160,14 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           const __m256i inb1 =
               _mm256_loadu_si256((const __m256i *)(inb - str1));
           const __m256i inb0 = _mm256_loadu_si256((const __m256i *)(inb));
-          step1a[0] = _mm256_add_epi16(ina0, inb0);
-          step1a[1] = _mm256_add_epi16(ina1, inb1);
-          step1a[2] = _mm256_add_epi16(ina2, inb2);
-          step1a[3] = _mm256_add_epi16(ina3, inb3);
-          step1b[-3] = _mm256_sub_epi16(ina3, inb3);
-          step1b[-2] = _mm256_sub_epi16(ina2, inb2);
-          step1b[-1] = _mm256_sub_epi16(ina1, inb1);
-          step1b[-0] = _mm256_sub_epi16(ina0, inb0);
+          step1a[0] = ADD_EPI16(ina0, inb0);
+          step1a[1] = ADD_EPI16(ina1, inb1);
+          step1a[2] = ADD_EPI16(ina2, inb2);
+          step1a[3] = ADD_EPI16(ina3, inb3);
+          step1b[-3] = SUB_EPI16(ina3, inb3);
+          step1b[-2] = SUB_EPI16(ina2, inb2);
+          step1b[-1] = SUB_EPI16(ina1, inb1);
+          step1b[-0] = SUB_EPI16(ina0, inb0);
           step1a[0] = _mm256_slli_epi16(step1a[0], 2);
           step1a[1] = _mm256_slli_epi16(step1a[1], 2);
           step1a[2] = _mm256_slli_epi16(step1a[2], 2);
@@ -164,14 +196,14 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           const __m256i inb1 =
               _mm256_loadu_si256((const __m256i *)(inb - str1));
           const __m256i inb0 = _mm256_loadu_si256((const __m256i *)(inb));
-          step1a[0] = _mm256_add_epi16(ina0, inb0);
-          step1a[1] = _mm256_add_epi16(ina1, inb1);
-          step1a[2] = _mm256_add_epi16(ina2, inb2);
-          step1a[3] = _mm256_add_epi16(ina3, inb3);
-          step1b[-3] = _mm256_sub_epi16(ina3, inb3);
-          step1b[-2] = _mm256_sub_epi16(ina2, inb2);
-          step1b[-1] = _mm256_sub_epi16(ina1, inb1);
-          step1b[-0] = _mm256_sub_epi16(ina0, inb0);
+          step1a[0] = ADD_EPI16(ina0, inb0);
+          step1a[1] = ADD_EPI16(ina1, inb1);
+          step1a[2] = ADD_EPI16(ina2, inb2);
+          step1a[3] = ADD_EPI16(ina3, inb3);
+          step1b[-3] = SUB_EPI16(ina3, inb3);
+          step1b[-2] = SUB_EPI16(ina2, inb2);
+          step1b[-1] = SUB_EPI16(ina1, inb1);
+          step1b[-0] = SUB_EPI16(ina0, inb0);
           step1a[0] = _mm256_slli_epi16(step1a[0], 2);
           step1a[1] = _mm256_slli_epi16(step1a[1], 2);
           step1a[2] = _mm256_slli_epi16(step1a[2], 2);
@@ -200,14 +232,14 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           const __m256i inb1 =
               _mm256_loadu_si256((const __m256i *)(inb - str1));
           const __m256i inb0 = _mm256_loadu_si256((const __m256i *)(inb));
-          step1a[0] = _mm256_add_epi16(ina0, inb0);
-          step1a[1] = _mm256_add_epi16(ina1, inb1);
-          step1a[2] = _mm256_add_epi16(ina2, inb2);
-          step1a[3] = _mm256_add_epi16(ina3, inb3);
-          step1b[-3] = _mm256_sub_epi16(ina3, inb3);
-          step1b[-2] = _mm256_sub_epi16(ina2, inb2);
-          step1b[-1] = _mm256_sub_epi16(ina1, inb1);
-          step1b[-0] = _mm256_sub_epi16(ina0, inb0);
+          step1a[0] = ADD_EPI16(ina0, inb0);
+          step1a[1] = ADD_EPI16(ina1, inb1);
+          step1a[2] = ADD_EPI16(ina2, inb2);
+          step1a[3] = ADD_EPI16(ina3, inb3);
+          step1b[-3] = SUB_EPI16(ina3, inb3);
+          step1b[-2] = SUB_EPI16(ina2, inb2);
+          step1b[-1] = SUB_EPI16(ina1, inb1);
+          step1b[-0] = SUB_EPI16(ina0, inb0);
           step1a[0] = _mm256_slli_epi16(step1a[0], 2);
           step1a[1] = _mm256_slli_epi16(step1a[1], 2);
           step1a[2] = _mm256_slli_epi16(step1a[2], 2);
@@ -236,14 +268,14 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           const __m256i inb1 =
               _mm256_loadu_si256((const __m256i *)(inb - str1));
           const __m256i inb0 = _mm256_loadu_si256((const __m256i *)(inb));
-          step1a[0] = _mm256_add_epi16(ina0, inb0);
-          step1a[1] = _mm256_add_epi16(ina1, inb1);
-          step1a[2] = _mm256_add_epi16(ina2, inb2);
-          step1a[3] = _mm256_add_epi16(ina3, inb3);
-          step1b[-3] = _mm256_sub_epi16(ina3, inb3);
-          step1b[-2] = _mm256_sub_epi16(ina2, inb2);
-          step1b[-1] = _mm256_sub_epi16(ina1, inb1);
-          step1b[-0] = _mm256_sub_epi16(ina0, inb0);
+          step1a[0] = ADD_EPI16(ina0, inb0);
+          step1a[1] = ADD_EPI16(ina1, inb1);
+          step1a[2] = ADD_EPI16(ina2, inb2);
+          step1a[3] = ADD_EPI16(ina3, inb3);
+          step1b[-3] = SUB_EPI16(ina3, inb3);
+          step1b[-2] = SUB_EPI16(ina2, inb2);
+          step1b[-1] = SUB_EPI16(ina1, inb1);
+          step1b[-0] = SUB_EPI16(ina0, inb0);
           step1a[0] = _mm256_slli_epi16(step1a[0], 2);
           step1a[1] = _mm256_slli_epi16(step1a[1], 2);
           step1a[2] = _mm256_slli_epi16(step1a[2], 2);
@@ -270,14 +302,14 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           __m256i in29 = _mm256_loadu_si256((const __m256i *)(in + 29 * 32));
           __m256i in30 = _mm256_loadu_si256((const __m256i *)(in + 30 * 32));
           __m256i in31 = _mm256_loadu_si256((const __m256i *)(in + 31 * 32));
-          step1[0] = _mm256_add_epi16(in00, in31);
-          step1[1] = _mm256_add_epi16(in01, in30);
-          step1[2] = _mm256_add_epi16(in02, in29);
-          step1[3] = _mm256_add_epi16(in03, in28);
-          step1[28] = _mm256_sub_epi16(in03, in28);
-          step1[29] = _mm256_sub_epi16(in02, in29);
-          step1[30] = _mm256_sub_epi16(in01, in30);
-          step1[31] = _mm256_sub_epi16(in00, in31);
+          step1[0] = ADD_EPI16(in00, in31);
+          step1[1] = ADD_EPI16(in01, in30);
+          step1[2] = ADD_EPI16(in02, in29);
+          step1[3] = ADD_EPI16(in03, in28);
+          step1[28] = SUB_EPI16(in03, in28);
+          step1[29] = SUB_EPI16(in02, in29);
+          step1[30] = SUB_EPI16(in01, in30);
+          step1[31] = SUB_EPI16(in00, in31);
         }
         {
           __m256i in04 = _mm256_loadu_si256((const __m256i *)(in + 4 * 32));
@@ -288,14 +320,14 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           __m256i in25 = _mm256_loadu_si256((const __m256i *)(in + 25 * 32));
           __m256i in26 = _mm256_loadu_si256((const __m256i *)(in + 26 * 32));
           __m256i in27 = _mm256_loadu_si256((const __m256i *)(in + 27 * 32));
-          step1[4] = _mm256_add_epi16(in04, in27);
-          step1[5] = _mm256_add_epi16(in05, in26);
-          step1[6] = _mm256_add_epi16(in06, in25);
-          step1[7] = _mm256_add_epi16(in07, in24);
-          step1[24] = _mm256_sub_epi16(in07, in24);
-          step1[25] = _mm256_sub_epi16(in06, in25);
-          step1[26] = _mm256_sub_epi16(in05, in26);
-          step1[27] = _mm256_sub_epi16(in04, in27);
+          step1[4] = ADD_EPI16(in04, in27);
+          step1[5] = ADD_EPI16(in05, in26);
+          step1[6] = ADD_EPI16(in06, in25);
+          step1[7] = ADD_EPI16(in07, in24);
+          step1[24] = SUB_EPI16(in07, in24);
+          step1[25] = SUB_EPI16(in06, in25);
+          step1[26] = SUB_EPI16(in05, in26);
+          step1[27] = SUB_EPI16(in04, in27);
         }
         {
           __m256i in08 = _mm256_loadu_si256((const __m256i *)(in + 8 * 32));
@@ -306,14 +338,14 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           __m256i in21 = _mm256_loadu_si256((const __m256i *)(in + 21 * 32));
           __m256i in22 = _mm256_loadu_si256((const __m256i *)(in + 22 * 32));
           __m256i in23 = _mm256_loadu_si256((const __m256i *)(in + 23 * 32));
-          step1[8] = _mm256_add_epi16(in08, in23);
-          step1[9] = _mm256_add_epi16(in09, in22);
-          step1[10] = _mm256_add_epi16(in10, in21);
-          step1[11] = _mm256_add_epi16(in11, in20);
-          step1[20] = _mm256_sub_epi16(in11, in20);
-          step1[21] = _mm256_sub_epi16(in10, in21);
-          step1[22] = _mm256_sub_epi16(in09, in22);
-          step1[23] = _mm256_sub_epi16(in08, in23);
+          step1[8] = ADD_EPI16(in08, in23);
+          step1[9] = ADD_EPI16(in09, in22);
+          step1[10] = ADD_EPI16(in10, in21);
+          step1[11] = ADD_EPI16(in11, in20);
+          step1[20] = SUB_EPI16(in11, in20);
+          step1[21] = SUB_EPI16(in10, in21);
+          step1[22] = SUB_EPI16(in09, in22);
+          step1[23] = SUB_EPI16(in08, in23);
         }
         {
           __m256i in12 = _mm256_loadu_si256((const __m256i *)(in + 12 * 32));
@@ -324,34 +356,34 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           __m256i in17 = _mm256_loadu_si256((const __m256i *)(in + 17 * 32));
           __m256i in18 = _mm256_loadu_si256((const __m256i *)(in + 18 * 32));
           __m256i in19 = _mm256_loadu_si256((const __m256i *)(in + 19 * 32));
-          step1[12] = _mm256_add_epi16(in12, in19);
-          step1[13] = _mm256_add_epi16(in13, in18);
-          step1[14] = _mm256_add_epi16(in14, in17);
-          step1[15] = _mm256_add_epi16(in15, in16);
-          step1[16] = _mm256_sub_epi16(in15, in16);
-          step1[17] = _mm256_sub_epi16(in14, in17);
-          step1[18] = _mm256_sub_epi16(in13, in18);
-          step1[19] = _mm256_sub_epi16(in12, in19);
+          step1[12] = ADD_EPI16(in12, in19);
+          step1[13] = ADD_EPI16(in13, in18);
+          step1[14] = ADD_EPI16(in14, in17);
+          step1[15] = ADD_EPI16(in15, in16);
+          step1[16] = SUB_EPI16(in15, in16);
+          step1[17] = SUB_EPI16(in14, in17);
+          step1[18] = SUB_EPI16(in13, in18);
+          step1[19] = SUB_EPI16(in12, in19);
         }
       }
       // Stage 2
       {
-        step2[0] = _mm256_add_epi16(step1[0], step1[15]);
-        step2[1] = _mm256_add_epi16(step1[1], step1[14]);
-        step2[2] = _mm256_add_epi16(step1[2], step1[13]);
-        step2[3] = _mm256_add_epi16(step1[3], step1[12]);
-        step2[4] = _mm256_add_epi16(step1[4], step1[11]);
-        step2[5] = _mm256_add_epi16(step1[5], step1[10]);
-        step2[6] = _mm256_add_epi16(step1[6], step1[9]);
-        step2[7] = _mm256_add_epi16(step1[7], step1[8]);
-        step2[8] = _mm256_sub_epi16(step1[7], step1[8]);
-        step2[9] = _mm256_sub_epi16(step1[6], step1[9]);
-        step2[10] = _mm256_sub_epi16(step1[5], step1[10]);
-        step2[11] = _mm256_sub_epi16(step1[4], step1[11]);
-        step2[12] = _mm256_sub_epi16(step1[3], step1[12]);
-        step2[13] = _mm256_sub_epi16(step1[2], step1[13]);
-        step2[14] = _mm256_sub_epi16(step1[1], step1[14]);
-        step2[15] = _mm256_sub_epi16(step1[0], step1[15]);
+        step2[0] = ADD_EPI16(step1[0], step1[15]);
+        step2[1] = ADD_EPI16(step1[1], step1[14]);
+        step2[2] = ADD_EPI16(step1[2], step1[13]);
+        step2[3] = ADD_EPI16(step1[3], step1[12]);
+        step2[4] = ADD_EPI16(step1[4], step1[11]);
+        step2[5] = ADD_EPI16(step1[5], step1[10]);
+        step2[6] = ADD_EPI16(step1[6], step1[9]);
+        step2[7] = ADD_EPI16(step1[7], step1[8]);
+        step2[8] = SUB_EPI16(step1[7], step1[8]);
+        step2[9] = SUB_EPI16(step1[6], step1[9]);
+        step2[10] = SUB_EPI16(step1[5], step1[10]);
+        step2[11] = SUB_EPI16(step1[4], step1[11]);
+        step2[12] = SUB_EPI16(step1[3], step1[12]);
+        step2[13] = SUB_EPI16(step1[2], step1[13]);
+        step2[14] = SUB_EPI16(step1[1], step1[14]);
+        step2[15] = SUB_EPI16(step1[0], step1[15]);
       }
       {
         const __m256i s2_20_0 = _mm256_unpacklo_epi16(step1[27], step1[20]);
@@ -428,14 +460,14 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
         const __m256i s2_27_6 = _mm256_srai_epi32(s2_27_4, DCT_CONST_BITS);
         const __m256i s2_27_7 = _mm256_srai_epi32(s2_27_5, DCT_CONST_BITS);
         // Combine
-        step2[20] = _mm256_packs_epi32(s2_20_6, s2_20_7);
-        step2[21] = _mm256_packs_epi32(s2_21_6, s2_21_7);
-        step2[22] = _mm256_packs_epi32(s2_22_6, s2_22_7);
-        step2[23] = _mm256_packs_epi32(s2_23_6, s2_23_7);
-        step2[24] = _mm256_packs_epi32(s2_24_6, s2_24_7);
-        step2[25] = _mm256_packs_epi32(s2_25_6, s2_25_7);
-        step2[26] = _mm256_packs_epi32(s2_26_6, s2_26_7);
-        step2[27] = _mm256_packs_epi32(s2_27_6, s2_27_7);
+        step2[20] = PACKS_EPI32(s2_20_6, s2_20_7);
+        step2[21] = PACKS_EPI32(s2_21_6, s2_21_7);
+        step2[22] = PACKS_EPI32(s2_22_6, s2_22_7);
+        step2[23] = PACKS_EPI32(s2_23_6, s2_23_7);
+        step2[24] = PACKS_EPI32(s2_24_6, s2_24_7);
+        step2[25] = PACKS_EPI32(s2_25_6, s2_25_7);
+        step2[26] = PACKS_EPI32(s2_26_6, s2_26_7);
+        step2[27] = PACKS_EPI32(s2_27_6, s2_27_7);
       }
 
 #if !FDCT32x32_HIGH_PRECISION
@@ -475,71 +507,71 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
         __m256i s3_30_0 = _mm256_cmpgt_epi16(kZero, step1[30]);
         __m256i s3_31_0 = _mm256_cmpgt_epi16(kZero, step1[31]);
 
-        step2[0] = _mm256_sub_epi16(step2[0], s3_00_0);
-        step2[1] = _mm256_sub_epi16(step2[1], s3_01_0);
-        step2[2] = _mm256_sub_epi16(step2[2], s3_02_0);
-        step2[3] = _mm256_sub_epi16(step2[3], s3_03_0);
-        step2[4] = _mm256_sub_epi16(step2[4], s3_04_0);
-        step2[5] = _mm256_sub_epi16(step2[5], s3_05_0);
-        step2[6] = _mm256_sub_epi16(step2[6], s3_06_0);
-        step2[7] = _mm256_sub_epi16(step2[7], s3_07_0);
-        step2[8] = _mm256_sub_epi16(step2[8], s2_08_0);
-        step2[9] = _mm256_sub_epi16(step2[9], s2_09_0);
-        step2[10] = _mm256_sub_epi16(step2[10], s3_10_0);
-        step2[11] = _mm256_sub_epi16(step2[11], s3_11_0);
-        step2[12] = _mm256_sub_epi16(step2[12], s3_12_0);
-        step2[13] = _mm256_sub_epi16(step2[13], s3_13_0);
-        step2[14] = _mm256_sub_epi16(step2[14], s2_14_0);
-        step2[15] = _mm256_sub_epi16(step2[15], s2_15_0);
-        step1[16] = _mm256_sub_epi16(step1[16], s3_16_0);
-        step1[17] = _mm256_sub_epi16(step1[17], s3_17_0);
-        step1[18] = _mm256_sub_epi16(step1[18], s3_18_0);
-        step1[19] = _mm256_sub_epi16(step1[19], s3_19_0);
-        step2[20] = _mm256_sub_epi16(step2[20], s3_20_0);
-        step2[21] = _mm256_sub_epi16(step2[21], s3_21_0);
-        step2[22] = _mm256_sub_epi16(step2[22], s3_22_0);
-        step2[23] = _mm256_sub_epi16(step2[23], s3_23_0);
-        step2[24] = _mm256_sub_epi16(step2[24], s3_24_0);
-        step2[25] = _mm256_sub_epi16(step2[25], s3_25_0);
-        step2[26] = _mm256_sub_epi16(step2[26], s3_26_0);
-        step2[27] = _mm256_sub_epi16(step2[27], s3_27_0);
-        step1[28] = _mm256_sub_epi16(step1[28], s3_28_0);
-        step1[29] = _mm256_sub_epi16(step1[29], s3_29_0);
-        step1[30] = _mm256_sub_epi16(step1[30], s3_30_0);
-        step1[31] = _mm256_sub_epi16(step1[31], s3_31_0);
-
-        step2[0] = _mm256_add_epi16(step2[0], kOne);
-        step2[1] = _mm256_add_epi16(step2[1], kOne);
-        step2[2] = _mm256_add_epi16(step2[2], kOne);
-        step2[3] = _mm256_add_epi16(step2[3], kOne);
-        step2[4] = _mm256_add_epi16(step2[4], kOne);
-        step2[5] = _mm256_add_epi16(step2[5], kOne);
-        step2[6] = _mm256_add_epi16(step2[6], kOne);
-        step2[7] = _mm256_add_epi16(step2[7], kOne);
-        step2[8] = _mm256_add_epi16(step2[8], kOne);
-        step2[9] = _mm256_add_epi16(step2[9], kOne);
-        step2[10] = _mm256_add_epi16(step2[10], kOne);
-        step2[11] = _mm256_add_epi16(step2[11], kOne);
-        step2[12] = _mm256_add_epi16(step2[12], kOne);
-        step2[13] = _mm256_add_epi16(step2[13], kOne);
-        step2[14] = _mm256_add_epi16(step2[14], kOne);
-        step2[15] = _mm256_add_epi16(step2[15], kOne);
-        step1[16] = _mm256_add_epi16(step1[16], kOne);
-        step1[17] = _mm256_add_epi16(step1[17], kOne);
-        step1[18] = _mm256_add_epi16(step1[18], kOne);
-        step1[19] = _mm256_add_epi16(step1[19], kOne);
-        step2[20] = _mm256_add_epi16(step2[20], kOne);
-        step2[21] = _mm256_add_epi16(step2[21], kOne);
-        step2[22] = _mm256_add_epi16(step2[22], kOne);
-        step2[23] = _mm256_add_epi16(step2[23], kOne);
-        step2[24] = _mm256_add_epi16(step2[24], kOne);
-        step2[25] = _mm256_add_epi16(step2[25], kOne);
-        step2[26] = _mm256_add_epi16(step2[26], kOne);
-        step2[27] = _mm256_add_epi16(step2[27], kOne);
-        step1[28] = _mm256_add_epi16(step1[28], kOne);
-        step1[29] = _mm256_add_epi16(step1[29], kOne);
-        step1[30] = _mm256_add_epi16(step1[30], kOne);
-        step1[31] = _mm256_add_epi16(step1[31], kOne);
+        step2[0] = SUB_EPI16(step2[0], s3_00_0);
+        step2[1] = SUB_EPI16(step2[1], s3_01_0);
+        step2[2] = SUB_EPI16(step2[2], s3_02_0);
+        step2[3] = SUB_EPI16(step2[3], s3_03_0);
+        step2[4] = SUB_EPI16(step2[4], s3_04_0);
+        step2[5] = SUB_EPI16(step2[5], s3_05_0);
+        step2[6] = SUB_EPI16(step2[6], s3_06_0);
+        step2[7] = SUB_EPI16(step2[7], s3_07_0);
+        step2[8] = SUB_EPI16(step2[8], s2_08_0);
+        step2[9] = SUB_EPI16(step2[9], s2_09_0);
+        step2[10] = SUB_EPI16(step2[10], s3_10_0);
+        step2[11] = SUB_EPI16(step2[11], s3_11_0);
+        step2[12] = SUB_EPI16(step2[12], s3_12_0);
+        step2[13] = SUB_EPI16(step2[13], s3_13_0);
+        step2[14] = SUB_EPI16(step2[14], s2_14_0);
+        step2[15] = SUB_EPI16(step2[15], s2_15_0);
+        step1[16] = SUB_EPI16(step1[16], s3_16_0);
+        step1[17] = SUB_EPI16(step1[17], s3_17_0);
+        step1[18] = SUB_EPI16(step1[18], s3_18_0);
+        step1[19] = SUB_EPI16(step1[19], s3_19_0);
+        step2[20] = SUB_EPI16(step2[20], s3_20_0);
+        step2[21] = SUB_EPI16(step2[21], s3_21_0);
+        step2[22] = SUB_EPI16(step2[22], s3_22_0);
+        step2[23] = SUB_EPI16(step2[23], s3_23_0);
+        step2[24] = SUB_EPI16(step2[24], s3_24_0);
+        step2[25] = SUB_EPI16(step2[25], s3_25_0);
+        step2[26] = SUB_EPI16(step2[26], s3_26_0);
+        step2[27] = SUB_EPI16(step2[27], s3_27_0);
+        step1[28] = SUB_EPI16(step1[28], s3_28_0);
+        step1[29] = SUB_EPI16(step1[29], s3_29_0);
+        step1[30] = SUB_EPI16(step1[30], s3_30_0);
+        step1[31] = SUB_EPI16(step1[31], s3_31_0);
+
+        step2[0] = ADD_EPI16(step2[0], kOne);
+        step2[1] = ADD_EPI16(step2[1], kOne);
+        step2[2] = ADD_EPI16(step2[2], kOne);
+        step2[3] = ADD_EPI16(step2[3], kOne);
+        step2[4] = ADD_EPI16(step2[4], kOne);
+        step2[5] = ADD_EPI16(step2[5], kOne);
+        step2[6] = ADD_EPI16(step2[6], kOne);
+        step2[7] = ADD_EPI16(step2[7], kOne);
+        step2[8] = ADD_EPI16(step2[8], kOne);
+        step2[9] = ADD_EPI16(step2[9], kOne);
+        step2[10] = ADD_EPI16(step2[10], kOne);
+        step2[11] = ADD_EPI16(step2[11], kOne);
+        step2[12] = ADD_EPI16(step2[12], kOne);
+        step2[13] = ADD_EPI16(step2[13], kOne);
+        step2[14] = ADD_EPI16(step2[14], kOne);
+        step2[15] = ADD_EPI16(step2[15], kOne);
+        step1[16] = ADD_EPI16(step1[16], kOne);
+        step1[17] = ADD_EPI16(step1[17], kOne);
+        step1[18] = ADD_EPI16(step1[18], kOne);
+        step1[19] = ADD_EPI16(step1[19], kOne);
+        step2[20] = ADD_EPI16(step2[20], kOne);
+        step2[21] = ADD_EPI16(step2[21], kOne);
+        step2[22] = ADD_EPI16(step2[22], kOne);
+        step2[23] = ADD_EPI16(step2[23], kOne);
+        step2[24] = ADD_EPI16(step2[24], kOne);
+        step2[25] = ADD_EPI16(step2[25], kOne);
+        step2[26] = ADD_EPI16(step2[26], kOne);
+        step2[27] = ADD_EPI16(step2[27], kOne);
+        step1[28] = ADD_EPI16(step1[28], kOne);
+        step1[29] = ADD_EPI16(step1[29], kOne);
+        step1[30] = ADD_EPI16(step1[30], kOne);
+        step1[31] = ADD_EPI16(step1[31], kOne);
 
         step2[0] = _mm256_srai_epi16(step2[0], 2);
         step2[1] = _mm256_srai_epi16(step2[1], 2);
@@ -581,14 +613,14 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
 #endif
         // Stage 3
         {
-          step3[0] = _mm256_add_epi16(step2[(8 - 1)], step2[0]);
-          step3[1] = _mm256_add_epi16(step2[(8 - 2)], step2[1]);
-          step3[2] = _mm256_add_epi16(step2[(8 - 3)], step2[2]);
-          step3[3] = _mm256_add_epi16(step2[(8 - 4)], step2[3]);
-          step3[4] = _mm256_sub_epi16(step2[(8 - 5)], step2[4]);
-          step3[5] = _mm256_sub_epi16(step2[(8 - 6)], step2[5]);
-          step3[6] = _mm256_sub_epi16(step2[(8 - 7)], step2[6]);
-          step3[7] = _mm256_sub_epi16(step2[(8 - 8)], step2[7]);
+          step3[0] = ADD_EPI16(step2[(8 - 1)], step2[0]);
+          step3[1] = ADD_EPI16(step2[(8 - 2)], step2[1]);
+          step3[2] = ADD_EPI16(step2[(8 - 3)], step2[2]);
+          step3[3] = ADD_EPI16(step2[(8 - 4)], step2[3]);
+          step3[4] = SUB_EPI16(step2[(8 - 5)], step2[4]);
+          step3[5] = SUB_EPI16(step2[(8 - 6)], step2[5]);
+          step3[6] = SUB_EPI16(step2[(8 - 7)], step2[6]);
+          step3[7] = SUB_EPI16(step2[(8 - 8)], step2[7]);
         }
         {
           const __m256i s3_10_0 = _mm256_unpacklo_epi16(step2[13], step2[10]);
@@ -629,44 +661,44 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           const __m256i s3_13_6 = _mm256_srai_epi32(s3_13_4, DCT_CONST_BITS);
           const __m256i s3_13_7 = _mm256_srai_epi32(s3_13_5, DCT_CONST_BITS);
           // Combine
-          step3[10] = _mm256_packs_epi32(s3_10_6, s3_10_7);
-          step3[11] = _mm256_packs_epi32(s3_11_6, s3_11_7);
-          step3[12] = _mm256_packs_epi32(s3_12_6, s3_12_7);
-          step3[13] = _mm256_packs_epi32(s3_13_6, s3_13_7);
+          step3[10] = PACKS_EPI32(s3_10_6, s3_10_7);
+          step3[11] = PACKS_EPI32(s3_11_6, s3_11_7);
+          step3[12] = PACKS_EPI32(s3_12_6, s3_12_7);
+          step3[13] = PACKS_EPI32(s3_13_6, s3_13_7);
         }
         {
-          step3[16] = _mm256_add_epi16(step2[23], step1[16]);
-          step3[17] = _mm256_add_epi16(step2[22], step1[17]);
-          step3[18] = _mm256_add_epi16(step2[21], step1[18]);
-          step3[19] = _mm256_add_epi16(step2[20], step1[19]);
-          step3[20] = _mm256_sub_epi16(step1[19], step2[20]);
-          step3[21] = _mm256_sub_epi16(step1[18], step2[21]);
-          step3[22] = _mm256_sub_epi16(step1[17], step2[22]);
-          step3[23] = _mm256_sub_epi16(step1[16], step2[23]);
-          step3[24] = _mm256_sub_epi16(step1[31], step2[24]);
-          step3[25] = _mm256_sub_epi16(step1[30], step2[25]);
-          step3[26] = _mm256_sub_epi16(step1[29], step2[26]);
-          step3[27] = _mm256_sub_epi16(step1[28], step2[27]);
-          step3[28] = _mm256_add_epi16(step2[27], step1[28]);
-          step3[29] = _mm256_add_epi16(step2[26], step1[29]);
-          step3[30] = _mm256_add_epi16(step2[25], step1[30]);
-          step3[31] = _mm256_add_epi16(step2[24], step1[31]);
+          step3[16] = ADD_EPI16(step2[23], step1[16]);
+          step3[17] = ADD_EPI16(step2[22], step1[17]);
+          step3[18] = ADD_EPI16(step2[21], step1[18]);
+          step3[19] = ADD_EPI16(step2[20], step1[19]);
+          step3[20] = SUB_EPI16(step1[19], step2[20]);
+          step3[21] = SUB_EPI16(step1[18], step2[21]);
+          step3[22] = SUB_EPI16(step1[17], step2[22]);
+          step3[23] = SUB_EPI16(step1[16], step2[23]);
+          step3[24] = SUB_EPI16(step1[31], step2[24]);
+          step3[25] = SUB_EPI16(step1[30], step2[25]);
+          step3[26] = SUB_EPI16(step1[29], step2[26]);
+          step3[27] = SUB_EPI16(step1[28], step2[27]);
+          step3[28] = ADD_EPI16(step2[27], step1[28]);
+          step3[29] = ADD_EPI16(step2[26], step1[29]);
+          step3[30] = ADD_EPI16(step2[25], step1[30]);
+          step3[31] = ADD_EPI16(step2[24], step1[31]);
         }
 
         // Stage 4
         {
-          step1[0] = _mm256_add_epi16(step3[3], step3[0]);
-          step1[1] = _mm256_add_epi16(step3[2], step3[1]);
-          step1[2] = _mm256_sub_epi16(step3[1], step3[2]);
-          step1[3] = _mm256_sub_epi16(step3[0], step3[3]);
-          step1[8] = _mm256_add_epi16(step3[11], step2[8]);
-          step1[9] = _mm256_add_epi16(step3[10], step2[9]);
-          step1[10] = _mm256_sub_epi16(step2[9], step3[10]);
-          step1[11] = _mm256_sub_epi16(step2[8], step3[11]);
-          step1[12] = _mm256_sub_epi16(step2[15], step3[12]);
-          step1[13] = _mm256_sub_epi16(step2[14], step3[13]);
-          step1[14] = _mm256_add_epi16(step3[13], step2[14]);
-          step1[15] = _mm256_add_epi16(step3[12], step2[15]);
+          step1[0] = ADD_EPI16(step3[3], step3[0]);
+          step1[1] = ADD_EPI16(step3[2], step3[1]);
+          step1[2] = SUB_EPI16(step3[1], step3[2]);
+          step1[3] = SUB_EPI16(step3[0], step3[3]);
+          step1[8] = ADD_EPI16(step3[11], step2[8]);
+          step1[9] = ADD_EPI16(step3[10], step2[9]);
+          step1[10] = SUB_EPI16(step2[9], step3[10]);
+          step1[11] = SUB_EPI16(step2[8], step3[11]);
+          step1[12] = SUB_EPI16(step2[15], step3[12]);
+          step1[13] = SUB_EPI16(step2[14], step3[13]);
+          step1[14] = ADD_EPI16(step3[13], step2[14]);
+          step1[15] = ADD_EPI16(step3[12], step2[15]);
         }
         {
           const __m256i s1_05_0 = _mm256_unpacklo_epi16(step3[6], step3[5]);
@@ -689,8 +721,8 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           const __m256i s1_06_6 = _mm256_srai_epi32(s1_06_4, DCT_CONST_BITS);
           const __m256i s1_06_7 = _mm256_srai_epi32(s1_06_5, DCT_CONST_BITS);
           // Combine
-          step1[5] = _mm256_packs_epi32(s1_05_6, s1_05_7);
-          step1[6] = _mm256_packs_epi32(s1_06_6, s1_06_7);
+          step1[5] = PACKS_EPI32(s1_05_6, s1_05_7);
+          step1[6] = PACKS_EPI32(s1_06_6, s1_06_7);
         }
         {
           const __m256i s1_18_0 = _mm256_unpacklo_epi16(step3[18], step3[29]);
@@ -767,21 +799,21 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           const __m256i s1_29_6 = _mm256_srai_epi32(s1_29_4, DCT_CONST_BITS);
           const __m256i s1_29_7 = _mm256_srai_epi32(s1_29_5, DCT_CONST_BITS);
           // Combine
-          step1[18] = _mm256_packs_epi32(s1_18_6, s1_18_7);
-          step1[19] = _mm256_packs_epi32(s1_19_6, s1_19_7);
-          step1[20] = _mm256_packs_epi32(s1_20_6, s1_20_7);
-          step1[21] = _mm256_packs_epi32(s1_21_6, s1_21_7);
-          step1[26] = _mm256_packs_epi32(s1_26_6, s1_26_7);
-          step1[27] = _mm256_packs_epi32(s1_27_6, s1_27_7);
-          step1[28] = _mm256_packs_epi32(s1_28_6, s1_28_7);
-          step1[29] = _mm256_packs_epi32(s1_29_6, s1_29_7);
+          step1[18] = PACKS_EPI32(s1_18_6, s1_18_7);
+          step1[19] = PACKS_EPI32(s1_19_6, s1_19_7);
+          step1[20] = PACKS_EPI32(s1_20_6, s1_20_7);
+          step1[21] = PACKS_EPI32(s1_21_6, s1_21_7);
+          step1[26] = PACKS_EPI32(s1_26_6, s1_26_7);
+          step1[27] = PACKS_EPI32(s1_27_6, s1_27_7);
+          step1[28] = PACKS_EPI32(s1_28_6, s1_28_7);
+          step1[29] = PACKS_EPI32(s1_29_6, s1_29_7);
         }
         // Stage 5
         {
-          step2[4] = _mm256_add_epi16(step1[5], step3[4]);
-          step2[5] = _mm256_sub_epi16(step3[4], step1[5]);
-          step2[6] = _mm256_sub_epi16(step3[7], step1[6]);
-          step2[7] = _mm256_add_epi16(step1[6], step3[7]);
+          step2[4] = ADD_EPI16(step1[5], step3[4]);
+          step2[5] = SUB_EPI16(step3[4], step1[5]);
+          step2[6] = SUB_EPI16(step3[7], step1[6]);
+          step2[7] = ADD_EPI16(step1[6], step3[7]);
         }
         {
           const __m256i out_00_0 = _mm256_unpacklo_epi16(step1[0], step1[1]);
@@ -830,10 +862,10 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           const __m256i out_24_6 = _mm256_srai_epi32(out_24_4, DCT_CONST_BITS);
           const __m256i out_24_7 = _mm256_srai_epi32(out_24_5, DCT_CONST_BITS);
           // Combine
-          out[0] = _mm256_packs_epi32(out_00_6, out_00_7);
-          out[16] = _mm256_packs_epi32(out_16_6, out_16_7);
-          out[8] = _mm256_packs_epi32(out_08_6, out_08_7);
-          out[24] = _mm256_packs_epi32(out_24_6, out_24_7);
+          out[0] = PACKS_EPI32(out_00_6, out_00_7);
+          out[16] = PACKS_EPI32(out_16_6, out_16_7);
+          out[8] = PACKS_EPI32(out_08_6, out_08_7);
+          out[24] = PACKS_EPI32(out_24_6, out_24_7);
         }
         {
           const __m256i s2_09_0 = _mm256_unpacklo_epi16(step1[9], step1[14]);
@@ -874,28 +906,28 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           const __m256i s2_14_6 = _mm256_srai_epi32(s2_14_4, DCT_CONST_BITS);
           const __m256i s2_14_7 = _mm256_srai_epi32(s2_14_5, DCT_CONST_BITS);
           // Combine
-          step2[9] = _mm256_packs_epi32(s2_09_6, s2_09_7);
-          step2[10] = _mm256_packs_epi32(s2_10_6, s2_10_7);
-          step2[13] = _mm256_packs_epi32(s2_13_6, s2_13_7);
-          step2[14] = _mm256_packs_epi32(s2_14_6, s2_14_7);
+          step2[9] = PACKS_EPI32(s2_09_6, s2_09_7);
+          step2[10] = PACKS_EPI32(s2_10_6, s2_10_7);
+          step2[13] = PACKS_EPI32(s2_13_6, s2_13_7);
+          step2[14] = PACKS_EPI32(s2_14_6, s2_14_7);
         }
         {
-          step2[16] = _mm256_add_epi16(step1[19], step3[16]);
-          step2[17] = _mm256_add_epi16(step1[18], step3[17]);
-          step2[18] = _mm256_sub_epi16(step3[17], step1[18]);
-          step2[19] = _mm256_sub_epi16(step3[16], step1[19]);
-          step2[20] = _mm256_sub_epi16(step3[23], step1[20]);
-          step2[21] = _mm256_sub_epi16(step3[22], step1[21]);
-          step2[22] = _mm256_add_epi16(step1[21], step3[22]);
-          step2[23] = _mm256_add_epi16(step1[20], step3[23]);
-          step2[24] = _mm256_add_epi16(step1[27], step3[24]);
-          step2[25] = _mm256_add_epi16(step1[26], step3[25]);
-          step2[26] = _mm256_sub_epi16(step3[25], step1[26]);
-          step2[27] = _mm256_sub_epi16(step3[24], step1[27]);
-          step2[28] = _mm256_sub_epi16(step3[31], step1[28]);
-          step2[29] = _mm256_sub_epi16(step3[30], step1[29]);
-          step2[30] = _mm256_add_epi16(step1[29], step3[30]);
-          step2[31] = _mm256_add_epi16(step1[28], step3[31]);
+          step2[16] = ADD_EPI16(step1[19], step3[16]);
+          step2[17] = ADD_EPI16(step1[18], step3[17]);
+          step2[18] = SUB_EPI16(step3[17], step1[18]);
+          step2[19] = SUB_EPI16(step3[16], step1[19]);
+          step2[20] = SUB_EPI16(step3[23], step1[20]);
+          step2[21] = SUB_EPI16(step3[22], step1[21]);
+          step2[22] = ADD_EPI16(step1[21], step3[22]);
+          step2[23] = ADD_EPI16(step1[20], step3[23]);
+          step2[24] = ADD_EPI16(step1[27], step3[24]);
+          step2[25] = ADD_EPI16(step1[26], step3[25]);
+          step2[26] = SUB_EPI16(step3[25], step1[26]);
+          step2[27] = SUB_EPI16(step3[24], step1[27]);
+          step2[28] = SUB_EPI16(step3[31], step1[28]);
+          step2[29] = SUB_EPI16(step3[30], step1[29]);
+          step2[30] = ADD_EPI16(step1[29], step3[30]);
+          step2[31] = ADD_EPI16(step1[28], step3[31]);
         }
         // Stage 6
         {
@@ -949,20 +981,20 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           const __m256i out_28_6 = _mm256_srai_epi32(out_28_4, DCT_CONST_BITS);
           const __m256i out_28_7 = _mm256_srai_epi32(out_28_5, DCT_CONST_BITS);
           // Combine
-          out[4] = _mm256_packs_epi32(out_04_6, out_04_7);
-          out[20] = _mm256_packs_epi32(out_20_6, out_20_7);
-          out[12] = _mm256_packs_epi32(out_12_6, out_12_7);
-          out[28] = _mm256_packs_epi32(out_28_6, out_28_7);
+          out[4] = PACKS_EPI32(out_04_6, out_04_7);
+          out[20] = PACKS_EPI32(out_20_6, out_20_7);
+          out[12] = PACKS_EPI32(out_12_6, out_12_7);
+          out[28] = PACKS_EPI32(out_28_6, out_28_7);
         }
         {
-          step3[8] = _mm256_add_epi16(step2[9], step1[8]);
-          step3[9] = _mm256_sub_epi16(step1[8], step2[9]);
-          step3[10] = _mm256_sub_epi16(step1[11], step2[10]);
-          step3[11] = _mm256_add_epi16(step2[10], step1[11]);
-          step3[12] = _mm256_add_epi16(step2[13], step1[12]);
-          step3[13] = _mm256_sub_epi16(step1[12], step2[13]);
-          step3[14] = _mm256_sub_epi16(step1[15], step2[14]);
-          step3[15] = _mm256_add_epi16(step2[14], step1[15]);
+          step3[8] = ADD_EPI16(step2[9], step1[8]);
+          step3[9] = SUB_EPI16(step1[8], step2[9]);
+          step3[10] = SUB_EPI16(step1[11], step2[10]);
+          step3[11] = ADD_EPI16(step2[10], step1[11]);
+          step3[12] = ADD_EPI16(step2[13], step1[12]);
+          step3[13] = SUB_EPI16(step1[12], step2[13]);
+          step3[14] = SUB_EPI16(step1[15], step2[14]);
+          step3[15] = ADD_EPI16(step2[14], step1[15]);
         }
         {
           const __m256i s3_17_0 = _mm256_unpacklo_epi16(step2[17], step2[30]);
@@ -1039,15 +1071,15 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           const __m256i s3_30_6 = _mm256_srai_epi32(s3_30_4, DCT_CONST_BITS);
           const __m256i s3_30_7 = _mm256_srai_epi32(s3_30_5, DCT_CONST_BITS);
           // Combine
-          step3[17] = _mm256_packs_epi32(s3_17_6, s3_17_7);
-          step3[18] = _mm256_packs_epi32(s3_18_6, s3_18_7);
-          step3[21] = _mm256_packs_epi32(s3_21_6, s3_21_7);
-          step3[22] = _mm256_packs_epi32(s3_22_6, s3_22_7);
+          step3[17] = PACKS_EPI32(s3_17_6, s3_17_7);
+          step3[18] = PACKS_EPI32(s3_18_6, s3_18_7);
+          step3[21] = PACKS_EPI32(s3_21_6, s3_21_7);
+          step3[22] = PACKS_EPI32(s3_22_6, s3_22_7);
           // Combine
-          step3[25] = _mm256_packs_epi32(s3_25_6, s3_25_7);
-          step3[26] = _mm256_packs_epi32(s3_26_6, s3_26_7);
-          step3[29] = _mm256_packs_epi32(s3_29_6, s3_29_7);
-          step3[30] = _mm256_packs_epi32(s3_30_6, s3_30_7);
+          step3[25] = PACKS_EPI32(s3_25_6, s3_25_7);
+          step3[26] = PACKS_EPI32(s3_26_6, s3_26_7);
+          step3[29] = PACKS_EPI32(s3_29_6, s3_29_7);
+          step3[30] = PACKS_EPI32(s3_30_6, s3_30_7);
         }
         // Stage 7
         {
@@ -1141,32 +1173,32 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           const __m256i out_30_6 = _mm256_srai_epi32(out_30_4, DCT_CONST_BITS);
           const __m256i out_30_7 = _mm256_srai_epi32(out_30_5, DCT_CONST_BITS);
           // Combine
-          out[2] = _mm256_packs_epi32(out_02_6, out_02_7);
-          out[18] = _mm256_packs_epi32(out_18_6, out_18_7);
-          out[10] = _mm256_packs_epi32(out_10_6, out_10_7);
-          out[26] = _mm256_packs_epi32(out_26_6, out_26_7);
-          out[6] = _mm256_packs_epi32(out_06_6, out_06_7);
-          out[22] = _mm256_packs_epi32(out_22_6, out_22_7);
-          out[14] = _mm256_packs_epi32(out_14_6, out_14_7);
-          out[30] = _mm256_packs_epi32(out_30_6, out_30_7);
+          out[2] = PACKS_EPI32(out_02_6, out_02_7);
+          out[18] = PACKS_EPI32(out_18_6, out_18_7);
+          out[10] = PACKS_EPI32(out_10_6, out_10_7);
+          out[26] = PACKS_EPI32(out_26_6, out_26_7);
+          out[6] = PACKS_EPI32(out_06_6, out_06_7);
+          out[22] = PACKS_EPI32(out_22_6, out_22_7);
+          out[14] = PACKS_EPI32(out_14_6, out_14_7);
+          out[30] = PACKS_EPI32(out_30_6, out_30_7);
         }
         {
-          step1[16] = _mm256_add_epi16(step3[17], step2[16]);
-          step1[17] = _mm256_sub_epi16(step2[16], step3[17]);
-          step1[18] = _mm256_sub_epi16(step2[19], step3[18]);
-          step1[19] = _mm256_add_epi16(step3[18], step2[19]);
-          step1[20] = _mm256_add_epi16(step3[21], step2[20]);
-          step1[21] = _mm256_sub_epi16(step2[20], step3[21]);
-          step1[22] = _mm256_sub_epi16(step2[23], step3[22]);
-          step1[23] = _mm256_add_epi16(step3[22], step2[23]);
-          step1[24] = _mm256_add_epi16(step3[25], step2[24]);
-          step1[25] = _mm256_sub_epi16(step2[24], step3[25]);
-          step1[26] = _mm256_sub_epi16(step2[27], step3[26]);
-          step1[27] = _mm256_add_epi16(step3[26], step2[27]);
-          step1[28] = _mm256_add_epi16(step3[29], step2[28]);
-          step1[29] = _mm256_sub_epi16(step2[28], step3[29]);
-          step1[30] = _mm256_sub_epi16(step2[31], step3[30]);
-          step1[31] = _mm256_add_epi16(step3[30], step2[31]);
+          step1[16] = ADD_EPI16(step3[17], step2[16]);
+          step1[17] = SUB_EPI16(step2[16], step3[17]);
+          step1[18] = SUB_EPI16(step2[19], step3[18]);
+          step1[19] = ADD_EPI16(step3[18], step2[19]);
+          step1[20] = ADD_EPI16(step3[21], step2[20]);
+          step1[21] = SUB_EPI16(step2[20], step3[21]);
+          step1[22] = SUB_EPI16(step2[23], step3[22]);
+          step1[23] = ADD_EPI16(step3[22], step2[23]);
+          step1[24] = ADD_EPI16(step3[25], step2[24]);
+          step1[25] = SUB_EPI16(step2[24], step3[25]);
+          step1[26] = SUB_EPI16(step2[27], step3[26]);
+          step1[27] = ADD_EPI16(step3[26], step2[27]);
+          step1[28] = ADD_EPI16(step3[29], step2[28]);
+          step1[29] = SUB_EPI16(step2[28], step3[29]);
+          step1[30] = SUB_EPI16(step2[31], step3[30]);
+          step1[31] = ADD_EPI16(step3[30], step2[31]);
         }
         // Final stage --- outputs indices are bit-reversed.
         {
@@ -1260,14 +1292,14 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           const __m256i out_31_6 = _mm256_srai_epi32(out_31_4, DCT_CONST_BITS);
           const __m256i out_31_7 = _mm256_srai_epi32(out_31_5, DCT_CONST_BITS);
           // Combine
-          out[1] = _mm256_packs_epi32(out_01_6, out_01_7);
-          out[17] = _mm256_packs_epi32(out_17_6, out_17_7);
-          out[9] = _mm256_packs_epi32(out_09_6, out_09_7);
-          out[25] = _mm256_packs_epi32(out_25_6, out_25_7);
-          out[7] = _mm256_packs_epi32(out_07_6, out_07_7);
-          out[23] = _mm256_packs_epi32(out_23_6, out_23_7);
-          out[15] = _mm256_packs_epi32(out_15_6, out_15_7);
-          out[31] = _mm256_packs_epi32(out_31_6, out_31_7);
+          out[1] = PACKS_EPI32(out_01_6, out_01_7);
+          out[17] = PACKS_EPI32(out_17_6, out_17_7);
+          out[9] = PACKS_EPI32(out_09_6, out_09_7);
+          out[25] = PACKS_EPI32(out_25_6, out_25_7);
+          out[7] = PACKS_EPI32(out_07_6, out_07_7);
+          out[23] = PACKS_EPI32(out_23_6, out_23_7);
+          out[15] = PACKS_EPI32(out_15_6, out_15_7);
+          out[31] = PACKS_EPI32(out_31_6, out_31_7);
         }
         {
           const __m256i out_05_0 = _mm256_unpacklo_epi16(step1[20], step1[27]);
@@ -1360,14 +1392,14 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           const __m256i out_27_6 = _mm256_srai_epi32(out_27_4, DCT_CONST_BITS);
           const __m256i out_27_7 = _mm256_srai_epi32(out_27_5, DCT_CONST_BITS);
           // Combine
-          out[5] = _mm256_packs_epi32(out_05_6, out_05_7);
-          out[21] = _mm256_packs_epi32(out_21_6, out_21_7);
-          out[13] = _mm256_packs_epi32(out_13_6, out_13_7);
-          out[29] = _mm256_packs_epi32(out_29_6, out_29_7);
-          out[3] = _mm256_packs_epi32(out_03_6, out_03_7);
-          out[19] = _mm256_packs_epi32(out_19_6, out_19_7);
-          out[11] = _mm256_packs_epi32(out_11_6, out_11_7);
-          out[27] = _mm256_packs_epi32(out_27_6, out_27_7);
+          out[5] = PACKS_EPI32(out_05_6, out_05_7);
+          out[21] = PACKS_EPI32(out_21_6, out_21_7);
+          out[13] = PACKS_EPI32(out_13_6, out_13_7);
+          out[29] = PACKS_EPI32(out_29_6, out_29_7);
+          out[3] = PACKS_EPI32(out_03_6, out_03_7);
+          out[19] = PACKS_EPI32(out_19_6, out_19_7);
+          out[11] = PACKS_EPI32(out_11_6, out_11_7);
+          out[27] = PACKS_EPI32(out_27_6, out_27_7);
         }
 #if FDCT32x32_HIGH_PRECISION
       } else {
@@ -1557,14 +1589,14 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
 
           // TODO(jingning): manually inline k_madd_epi32_avx2_ to further hide
           // instruction latency.
-          v[0] = k_madd_epi32_avx2(u[0], k32_p16_m16);
-          v[1] = k_madd_epi32_avx2(u[1], k32_p16_m16);
-          v[2] = k_madd_epi32_avx2(u[2], k32_p16_m16);
-          v[3] = k_madd_epi32_avx2(u[3], k32_p16_m16);
-          v[4] = k_madd_epi32_avx2(u[0], k32_p16_p16);
-          v[5] = k_madd_epi32_avx2(u[1], k32_p16_p16);
-          v[6] = k_madd_epi32_avx2(u[2], k32_p16_p16);
-          v[7] = k_madd_epi32_avx2(u[3], k32_p16_p16);
+          v[0] = K_MADD_EPI32(u[0], k32_p16_m16);
+          v[1] = K_MADD_EPI32(u[1], k32_p16_m16);
+          v[2] = K_MADD_EPI32(u[2], k32_p16_m16);
+          v[3] = K_MADD_EPI32(u[3], k32_p16_m16);
+          v[4] = K_MADD_EPI32(u[0], k32_p16_p16);
+          v[5] = K_MADD_EPI32(u[1], k32_p16_p16);
+          v[6] = K_MADD_EPI32(u[2], k32_p16_p16);
+          v[7] = K_MADD_EPI32(u[3], k32_p16_p16);
 
           u[0] = k_packs_epi64_avx2(v[0], v[1]);
           u[1] = k_packs_epi64_avx2(v[2], v[3]);
@@ -1606,38 +1638,38 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           u[14] = _mm256_unpacklo_epi32(lstep3[43], lstep3[53]);
           u[15] = _mm256_unpackhi_epi32(lstep3[43], lstep3[53]);
 
-          v[0] = k_madd_epi32_avx2(u[0], k32_m08_p24);
-          v[1] = k_madd_epi32_avx2(u[1], k32_m08_p24);
-          v[2] = k_madd_epi32_avx2(u[2], k32_m08_p24);
-          v[3] = k_madd_epi32_avx2(u[3], k32_m08_p24);
-          v[4] = k_madd_epi32_avx2(u[4], k32_m08_p24);
-          v[5] = k_madd_epi32_avx2(u[5], k32_m08_p24);
-          v[6] = k_madd_epi32_avx2(u[6], k32_m08_p24);
-          v[7] = k_madd_epi32_avx2(u[7], k32_m08_p24);
-          v[8] = k_madd_epi32_avx2(u[8], k32_m24_m08);
-          v[9] = k_madd_epi32_avx2(u[9], k32_m24_m08);
-          v[10] = k_madd_epi32_avx2(u[10], k32_m24_m08);
-          v[11] = k_madd_epi32_avx2(u[11], k32_m24_m08);
-          v[12] = k_madd_epi32_avx2(u[12], k32_m24_m08);
-          v[13] = k_madd_epi32_avx2(u[13], k32_m24_m08);
-          v[14] = k_madd_epi32_avx2(u[14], k32_m24_m08);
-          v[15] = k_madd_epi32_avx2(u[15], k32_m24_m08);
-          v[16] = k_madd_epi32_avx2(u[12], k32_m08_p24);
-          v[17] = k_madd_epi32_avx2(u[13], k32_m08_p24);
-          v[18] = k_madd_epi32_avx2(u[14], k32_m08_p24);
-          v[19] = k_madd_epi32_avx2(u[15], k32_m08_p24);
-          v[20] = k_madd_epi32_avx2(u[8], k32_m08_p24);
-          v[21] = k_madd_epi32_avx2(u[9], k32_m08_p24);
-          v[22] = k_madd_epi32_avx2(u[10], k32_m08_p24);
-          v[23] = k_madd_epi32_avx2(u[11], k32_m08_p24);
-          v[24] = k_madd_epi32_avx2(u[4], k32_p24_p08);
-          v[25] = k_madd_epi32_avx2(u[5], k32_p24_p08);
-          v[26] = k_madd_epi32_avx2(u[6], k32_p24_p08);
-          v[27] = k_madd_epi32_avx2(u[7], k32_p24_p08);
-          v[28] = k_madd_epi32_avx2(u[0], k32_p24_p08);
-          v[29] = k_madd_epi32_avx2(u[1], k32_p24_p08);
-          v[30] = k_madd_epi32_avx2(u[2], k32_p24_p08);
-          v[31] = k_madd_epi32_avx2(u[3], k32_p24_p08);
+          v[0] = K_MADD_EPI32(u[0], k32_m08_p24);
+          v[1] = K_MADD_EPI32(u[1], k32_m08_p24);
+          v[2] = K_MADD_EPI32(u[2], k32_m08_p24);
+          v[3] = K_MADD_EPI32(u[3], k32_m08_p24);
+          v[4] = K_MADD_EPI32(u[4], k32_m08_p24);
+          v[5] = K_MADD_EPI32(u[5], k32_m08_p24);
+          v[6] = K_MADD_EPI32(u[6], k32_m08_p24);
+          v[7] = K_MADD_EPI32(u[7], k32_m08_p24);
+          v[8] = K_MADD_EPI32(u[8], k32_m24_m08);
+          v[9] = K_MADD_EPI32(u[9], k32_m24_m08);
+          v[10] = K_MADD_EPI32(u[10], k32_m24_m08);
+          v[11] = K_MADD_EPI32(u[11], k32_m24_m08);
+          v[12] = K_MADD_EPI32(u[12], k32_m24_m08);
+          v[13] = K_MADD_EPI32(u[13], k32_m24_m08);
+          v[14] = K_MADD_EPI32(u[14], k32_m24_m08);
+          v[15] = K_MADD_EPI32(u[15], k32_m24_m08);
+          v[16] = K_MADD_EPI32(u[12], k32_m08_p24);
+          v[17] = K_MADD_EPI32(u[13], k32_m08_p24);
+          v[18] = K_MADD_EPI32(u[14], k32_m08_p24);
+          v[19] = K_MADD_EPI32(u[15], k32_m08_p24);
+          v[20] = K_MADD_EPI32(u[8], k32_m08_p24);
+          v[21] = K_MADD_EPI32(u[9], k32_m08_p24);
+          v[22] = K_MADD_EPI32(u[10], k32_m08_p24);
+          v[23] = K_MADD_EPI32(u[11], k32_m08_p24);
+          v[24] = K_MADD_EPI32(u[4], k32_p24_p08);
+          v[25] = K_MADD_EPI32(u[5], k32_p24_p08);
+          v[26] = K_MADD_EPI32(u[6], k32_p24_p08);
+          v[27] = K_MADD_EPI32(u[7], k32_p24_p08);
+          v[28] = K_MADD_EPI32(u[0], k32_p24_p08);
+          v[29] = K_MADD_EPI32(u[1], k32_p24_p08);
+          v[30] = K_MADD_EPI32(u[2], k32_p24_p08);
+          v[31] = K_MADD_EPI32(u[3], k32_p24_p08);
 
           u[0] = k_packs_epi64_avx2(v[0], v[1]);
           u[1] = k_packs_epi64_avx2(v[2], v[3]);
@@ -1722,22 +1754,22 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
 
           // TODO(jingning): manually inline k_madd_epi32_avx2_ to further hide
           // instruction latency.
-          v[0] = k_madd_epi32_avx2(u[0], k32_p16_p16);
-          v[1] = k_madd_epi32_avx2(u[1], k32_p16_p16);
-          v[2] = k_madd_epi32_avx2(u[2], k32_p16_p16);
-          v[3] = k_madd_epi32_avx2(u[3], k32_p16_p16);
-          v[4] = k_madd_epi32_avx2(u[0], k32_p16_m16);
-          v[5] = k_madd_epi32_avx2(u[1], k32_p16_m16);
-          v[6] = k_madd_epi32_avx2(u[2], k32_p16_m16);
-          v[7] = k_madd_epi32_avx2(u[3], k32_p16_m16);
-          v[8] = k_madd_epi32_avx2(u[4], k32_p24_p08);
-          v[9] = k_madd_epi32_avx2(u[5], k32_p24_p08);
-          v[10] = k_madd_epi32_avx2(u[6], k32_p24_p08);
-          v[11] = k_madd_epi32_avx2(u[7], k32_p24_p08);
-          v[12] = k_madd_epi32_avx2(u[4], k32_m08_p24);
-          v[13] = k_madd_epi32_avx2(u[5], k32_m08_p24);
-          v[14] = k_madd_epi32_avx2(u[6], k32_m08_p24);
-          v[15] = k_madd_epi32_avx2(u[7], k32_m08_p24);
+          v[0] = K_MADD_EPI32(u[0], k32_p16_p16);
+          v[1] = K_MADD_EPI32(u[1], k32_p16_p16);
+          v[2] = K_MADD_EPI32(u[2], k32_p16_p16);
+          v[3] = K_MADD_EPI32(u[3], k32_p16_p16);
+          v[4] = K_MADD_EPI32(u[0], k32_p16_m16);
+          v[5] = K_MADD_EPI32(u[1], k32_p16_m16);
+          v[6] = K_MADD_EPI32(u[2], k32_p16_m16);
+          v[7] = K_MADD_EPI32(u[3], k32_p16_m16);
+          v[8] = K_MADD_EPI32(u[4], k32_p24_p08);
+          v[9] = K_MADD_EPI32(u[5], k32_p24_p08);
+          v[10] = K_MADD_EPI32(u[6], k32_p24_p08);
+          v[11] = K_MADD_EPI32(u[7], k32_p24_p08);
+          v[12] = K_MADD_EPI32(u[4], k32_m08_p24);
+          v[13] = K_MADD_EPI32(u[5], k32_m08_p24);
+          v[14] = K_MADD_EPI32(u[6], k32_m08_p24);
+          v[15] = K_MADD_EPI32(u[7], k32_m08_p24);
 
           u[0] = k_packs_epi64_avx2(v[0], v[1]);
           u[1] = k_packs_epi64_avx2(v[2], v[3]);
@@ -1803,10 +1835,10 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           u[7] = _mm256_srai_epi32(u[7], 2);
 
           // Combine
-          out[0] = _mm256_packs_epi32(u[0], u[1]);
-          out[16] = _mm256_packs_epi32(u[2], u[3]);
-          out[8] = _mm256_packs_epi32(u[4], u[5]);
-          out[24] = _mm256_packs_epi32(u[6], u[7]);
+          out[0] = PACKS_EPI32(u[0], u[1]);
+          out[16] = PACKS_EPI32(u[2], u[3]);
+          out[8] = PACKS_EPI32(u[4], u[5]);
+          out[24] = PACKS_EPI32(u[6], u[7]);
         }
         {
           const __m256i k32_m08_p24 =
@@ -1825,22 +1857,22 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           u[6] = _mm256_unpacklo_epi32(lstep1[21], lstep1[27]);
           u[7] = _mm256_unpackhi_epi32(lstep1[21], lstep1[27]);
 
-          v[0] = k_madd_epi32_avx2(u[0], k32_m08_p24);
-          v[1] = k_madd_epi32_avx2(u[1], k32_m08_p24);
-          v[2] = k_madd_epi32_avx2(u[2], k32_m08_p24);
-          v[3] = k_madd_epi32_avx2(u[3], k32_m08_p24);
-          v[4] = k_madd_epi32_avx2(u[4], k32_m24_m08);
-          v[5] = k_madd_epi32_avx2(u[5], k32_m24_m08);
-          v[6] = k_madd_epi32_avx2(u[6], k32_m24_m08);
-          v[7] = k_madd_epi32_avx2(u[7], k32_m24_m08);
-          v[8] = k_madd_epi32_avx2(u[4], k32_m08_p24);
-          v[9] = k_madd_epi32_avx2(u[5], k32_m08_p24);
-          v[10] = k_madd_epi32_avx2(u[6], k32_m08_p24);
-          v[11] = k_madd_epi32_avx2(u[7], k32_m08_p24);
-          v[12] = k_madd_epi32_avx2(u[0], k32_p24_p08);
-          v[13] = k_madd_epi32_avx2(u[1], k32_p24_p08);
-          v[14] = k_madd_epi32_avx2(u[2], k32_p24_p08);
-          v[15] = k_madd_epi32_avx2(u[3], k32_p24_p08);
+          v[0] = K_MADD_EPI32(u[0], k32_m08_p24);
+          v[1] = K_MADD_EPI32(u[1], k32_m08_p24);
+          v[2] = K_MADD_EPI32(u[2], k32_m08_p24);
+          v[3] = K_MADD_EPI32(u[3], k32_m08_p24);
+          v[4] = K_MADD_EPI32(u[4], k32_m24_m08);
+          v[5] = K_MADD_EPI32(u[5], k32_m24_m08);
+          v[6] = K_MADD_EPI32(u[6], k32_m24_m08);
+          v[7] = K_MADD_EPI32(u[7], k32_m24_m08);
+          v[8] = K_MADD_EPI32(u[4], k32_m08_p24);
+          v[9] = K_MADD_EPI32(u[5], k32_m08_p24);
+          v[10] = K_MADD_EPI32(u[6], k32_m08_p24);
+          v[11] = K_MADD_EPI32(u[7], k32_m08_p24);
+          v[12] = K_MADD_EPI32(u[0], k32_p24_p08);
+          v[13] = K_MADD_EPI32(u[1], k32_p24_p08);
+          v[14] = K_MADD_EPI32(u[2], k32_p24_p08);
+          v[15] = K_MADD_EPI32(u[3], k32_p24_p08);
 
           u[0] = k_packs_epi64_avx2(v[0], v[1]);
           u[1] = k_packs_epi64_avx2(v[2], v[3]);
@@ -1931,22 +1963,22 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           u[14] = _mm256_unpacklo_epi32(lstep2[9], lstep2[15]);
           u[15] = _mm256_unpackhi_epi32(lstep2[9], lstep2[15]);
 
-          v[0] = k_madd_epi32_avx2(u[0], k32_p28_p04);
-          v[1] = k_madd_epi32_avx2(u[1], k32_p28_p04);
-          v[2] = k_madd_epi32_avx2(u[2], k32_p28_p04);
-          v[3] = k_madd_epi32_avx2(u[3], k32_p28_p04);
-          v[4] = k_madd_epi32_avx2(u[4], k32_p12_p20);
-          v[5] = k_madd_epi32_avx2(u[5], k32_p12_p20);
-          v[6] = k_madd_epi32_avx2(u[6], k32_p12_p20);
-          v[7] = k_madd_epi32_avx2(u[7], k32_p12_p20);
-          v[8] = k_madd_epi32_avx2(u[8], k32_m20_p12);
-          v[9] = k_madd_epi32_avx2(u[9], k32_m20_p12);
-          v[10] = k_madd_epi32_avx2(u[10], k32_m20_p12);
-          v[11] = k_madd_epi32_avx2(u[11], k32_m20_p12);
-          v[12] = k_madd_epi32_avx2(u[12], k32_m04_p28);
-          v[13] = k_madd_epi32_avx2(u[13], k32_m04_p28);
-          v[14] = k_madd_epi32_avx2(u[14], k32_m04_p28);
-          v[15] = k_madd_epi32_avx2(u[15], k32_m04_p28);
+          v[0] = K_MADD_EPI32(u[0], k32_p28_p04);
+          v[1] = K_MADD_EPI32(u[1], k32_p28_p04);
+          v[2] = K_MADD_EPI32(u[2], k32_p28_p04);
+          v[3] = K_MADD_EPI32(u[3], k32_p28_p04);
+          v[4] = K_MADD_EPI32(u[4], k32_p12_p20);
+          v[5] = K_MADD_EPI32(u[5], k32_p12_p20);
+          v[6] = K_MADD_EPI32(u[6], k32_p12_p20);
+          v[7] = K_MADD_EPI32(u[7], k32_p12_p20);
+          v[8] = K_MADD_EPI32(u[8], k32_m20_p12);
+          v[9] = K_MADD_EPI32(u[9], k32_m20_p12);
+          v[10] = K_MADD_EPI32(u[10], k32_m20_p12);
+          v[11] = K_MADD_EPI32(u[11], k32_m20_p12);
+          v[12] = K_MADD_EPI32(u[12], k32_m04_p28);
+          v[13] = K_MADD_EPI32(u[13], k32_m04_p28);
+          v[14] = K_MADD_EPI32(u[14], k32_m04_p28);
+          v[15] = K_MADD_EPI32(u[15], k32_m04_p28);
 
           u[0] = k_packs_epi64_avx2(v[0], v[1]);
           u[1] = k_packs_epi64_avx2(v[2], v[3]);
@@ -2011,10 +2043,10 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           u[6] = _mm256_srai_epi32(u[6], 2);
           u[7] = _mm256_srai_epi32(u[7], 2);
 
-          out[4] = _mm256_packs_epi32(u[0], u[1]);
-          out[20] = _mm256_packs_epi32(u[2], u[3]);
-          out[12] = _mm256_packs_epi32(u[4], u[5]);
-          out[28] = _mm256_packs_epi32(u[6], u[7]);
+          out[4] = PACKS_EPI32(u[0], u[1]);
+          out[20] = PACKS_EPI32(u[2], u[3]);
+          out[12] = PACKS_EPI32(u[4], u[5]);
+          out[28] = PACKS_EPI32(u[6], u[7]);
         }
         {
           lstep3[16] = _mm256_add_epi32(lstep2[18], lstep1[16]);
@@ -2065,38 +2097,38 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           u[14] = _mm256_unpacklo_epi32(lstep2[45], lstep2[51]);
           u[15] = _mm256_unpackhi_epi32(lstep2[45], lstep2[51]);
 
-          v[0] = k_madd_epi32_avx2(u[0], k32_m04_p28);
-          v[1] = k_madd_epi32_avx2(u[1], k32_m04_p28);
-          v[2] = k_madd_epi32_avx2(u[2], k32_m04_p28);
-          v[3] = k_madd_epi32_avx2(u[3], k32_m04_p28);
-          v[4] = k_madd_epi32_avx2(u[4], k32_m28_m04);
-          v[5] = k_madd_epi32_avx2(u[5], k32_m28_m04);
-          v[6] = k_madd_epi32_avx2(u[6], k32_m28_m04);
-          v[7] = k_madd_epi32_avx2(u[7], k32_m28_m04);
-          v[8] = k_madd_epi32_avx2(u[8], k32_m20_p12);
-          v[9] = k_madd_epi32_avx2(u[9], k32_m20_p12);
-          v[10] = k_madd_epi32_avx2(u[10], k32_m20_p12);
-          v[11] = k_madd_epi32_avx2(u[11], k32_m20_p12);
-          v[12] = k_madd_epi32_avx2(u[12], k32_m12_m20);
-          v[13] = k_madd_epi32_avx2(u[13], k32_m12_m20);
-          v[14] = k_madd_epi32_avx2(u[14], k32_m12_m20);
-          v[15] = k_madd_epi32_avx2(u[15], k32_m12_m20);
-          v[16] = k_madd_epi32_avx2(u[12], k32_m20_p12);
-          v[17] = k_madd_epi32_avx2(u[13], k32_m20_p12);
-          v[18] = k_madd_epi32_avx2(u[14], k32_m20_p12);
-          v[19] = k_madd_epi32_avx2(u[15], k32_m20_p12);
-          v[20] = k_madd_epi32_avx2(u[8], k32_p12_p20);
-          v[21] = k_madd_epi32_avx2(u[9], k32_p12_p20);
-          v[22] = k_madd_epi32_avx2(u[10], k32_p12_p20);
-          v[23] = k_madd_epi32_avx2(u[11], k32_p12_p20);
-          v[24] = k_madd_epi32_avx2(u[4], k32_m04_p28);
-          v[25] = k_madd_epi32_avx2(u[5], k32_m04_p28);
-          v[26] = k_madd_epi32_avx2(u[6], k32_m04_p28);
-          v[27] = k_madd_epi32_avx2(u[7], k32_m04_p28);
-          v[28] = k_madd_epi32_avx2(u[0], k32_p28_p04);
-          v[29] = k_madd_epi32_avx2(u[1], k32_p28_p04);
-          v[30] = k_madd_epi32_avx2(u[2], k32_p28_p04);
-          v[31] = k_madd_epi32_avx2(u[3], k32_p28_p04);
+          v[0] = K_MADD_EPI32(u[0], k32_m04_p28);
+          v[1] = K_MADD_EPI32(u[1], k32_m04_p28);
+          v[2] = K_MADD_EPI32(u[2], k32_m04_p28);
+          v[3] = K_MADD_EPI32(u[3], k32_m04_p28);
+          v[4] = K_MADD_EPI32(u[4], k32_m28_m04);
+          v[5] = K_MADD_EPI32(u[5], k32_m28_m04);
+          v[6] = K_MADD_EPI32(u[6], k32_m28_m04);
+          v[7] = K_MADD_EPI32(u[7], k32_m28_m04);
+          v[8] = K_MADD_EPI32(u[8], k32_m20_p12);
+          v[9] = K_MADD_EPI32(u[9], k32_m20_p12);
+          v[10] = K_MADD_EPI32(u[10], k32_m20_p12);
+          v[11] = K_MADD_EPI32(u[11], k32_m20_p12);
+          v[12] = K_MADD_EPI32(u[12], k32_m12_m20);
+          v[13] = K_MADD_EPI32(u[13], k32_m12_m20);
+          v[14] = K_MADD_EPI32(u[14], k32_m12_m20);
+          v[15] = K_MADD_EPI32(u[15], k32_m12_m20);
+          v[16] = K_MADD_EPI32(u[12], k32_m20_p12);
+          v[17] = K_MADD_EPI32(u[13], k32_m20_p12);
+          v[18] = K_MADD_EPI32(u[14], k32_m20_p12);
+          v[19] = K_MADD_EPI32(u[15], k32_m20_p12);
+          v[20] = K_MADD_EPI32(u[8], k32_p12_p20);
+          v[21] = K_MADD_EPI32(u[9], k32_p12_p20);
+          v[22] = K_MADD_EPI32(u[10], k32_p12_p20);
+          v[23] = K_MADD_EPI32(u[11], k32_p12_p20);
+          v[24] = K_MADD_EPI32(u[4], k32_m04_p28);
+          v[25] = K_MADD_EPI32(u[5], k32_m04_p28);
+          v[26] = K_MADD_EPI32(u[6], k32_m04_p28);
+          v[27] = K_MADD_EPI32(u[7], k32_m04_p28);
+          v[28] = K_MADD_EPI32(u[0], k32_p28_p04);
+          v[29] = K_MADD_EPI32(u[1], k32_p28_p04);
+          v[30] = K_MADD_EPI32(u[2], k32_p28_p04);
+          v[31] = K_MADD_EPI32(u[3], k32_p28_p04);
 
           u[0] = k_packs_epi64_avx2(v[0], v[1]);
           u[1] = k_packs_epi64_avx2(v[2], v[3]);
@@ -2185,38 +2217,38 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           u[14] = _mm256_unpacklo_epi32(lstep3[23], lstep3[25]);
           u[15] = _mm256_unpackhi_epi32(lstep3[23], lstep3[25]);
 
-          v[0] = k_madd_epi32_avx2(u[0], k32_p30_p02);
-          v[1] = k_madd_epi32_avx2(u[1], k32_p30_p02);
-          v[2] = k_madd_epi32_avx2(u[2], k32_p30_p02);
-          v[3] = k_madd_epi32_avx2(u[3], k32_p30_p02);
-          v[4] = k_madd_epi32_avx2(u[4], k32_p14_p18);
-          v[5] = k_madd_epi32_avx2(u[5], k32_p14_p18);
-          v[6] = k_madd_epi32_avx2(u[6], k32_p14_p18);
-          v[7] = k_madd_epi32_avx2(u[7], k32_p14_p18);
-          v[8] = k_madd_epi32_avx2(u[8], k32_p22_p10);
-          v[9] = k_madd_epi32_avx2(u[9], k32_p22_p10);
-          v[10] = k_madd_epi32_avx2(u[10], k32_p22_p10);
-          v[11] = k_madd_epi32_avx2(u[11], k32_p22_p10);
-          v[12] = k_madd_epi32_avx2(u[12], k32_p06_p26);
-          v[13] = k_madd_epi32_avx2(u[13], k32_p06_p26);
-          v[14] = k_madd_epi32_avx2(u[14], k32_p06_p26);
-          v[15] = k_madd_epi32_avx2(u[15], k32_p06_p26);
-          v[16] = k_madd_epi32_avx2(u[12], k32_m26_p06);
-          v[17] = k_madd_epi32_avx2(u[13], k32_m26_p06);
-          v[18] = k_madd_epi32_avx2(u[14], k32_m26_p06);
-          v[19] = k_madd_epi32_avx2(u[15], k32_m26_p06);
-          v[20] = k_madd_epi32_avx2(u[8], k32_m10_p22);
-          v[21] = k_madd_epi32_avx2(u[9], k32_m10_p22);
-          v[22] = k_madd_epi32_avx2(u[10], k32_m10_p22);
-          v[23] = k_madd_epi32_avx2(u[11], k32_m10_p22);
-          v[24] = k_madd_epi32_avx2(u[4], k32_m18_p14);
-          v[25] = k_madd_epi32_avx2(u[5], k32_m18_p14);
-          v[26] = k_madd_epi32_avx2(u[6], k32_m18_p14);
-          v[27] = k_madd_epi32_avx2(u[7], k32_m18_p14);
-          v[28] = k_madd_epi32_avx2(u[0], k32_m02_p30);
-          v[29] = k_madd_epi32_avx2(u[1], k32_m02_p30);
-          v[30] = k_madd_epi32_avx2(u[2], k32_m02_p30);
-          v[31] = k_madd_epi32_avx2(u[3], k32_m02_p30);
+          v[0] = K_MADD_EPI32(u[0], k32_p30_p02);
+          v[1] = K_MADD_EPI32(u[1], k32_p30_p02);
+          v[2] = K_MADD_EPI32(u[2], k32_p30_p02);
+          v[3] = K_MADD_EPI32(u[3], k32_p30_p02);
+          v[4] = K_MADD_EPI32(u[4], k32_p14_p18);
+          v[5] = K_MADD_EPI32(u[5], k32_p14_p18);
+          v[6] = K_MADD_EPI32(u[6], k32_p14_p18);
+          v[7] = K_MADD_EPI32(u[7], k32_p14_p18);
+          v[8] = K_MADD_EPI32(u[8], k32_p22_p10);
+          v[9] = K_MADD_EPI32(u[9], k32_p22_p10);
+          v[10] = K_MADD_EPI32(u[10], k32_p22_p10);
+          v[11] = K_MADD_EPI32(u[11], k32_p22_p10);
+          v[12] = K_MADD_EPI32(u[12], k32_p06_p26);
+          v[13] = K_MADD_EPI32(u[13], k32_p06_p26);
+          v[14] = K_MADD_EPI32(u[14], k32_p06_p26);
+          v[15] = K_MADD_EPI32(u[15], k32_p06_p26);
+          v[16] = K_MADD_EPI32(u[12], k32_m26_p06);
+          v[17] = K_MADD_EPI32(u[13], k32_m26_p06);
+          v[18] = K_MADD_EPI32(u[14], k32_m26_p06);
+          v[19] = K_MADD_EPI32(u[15], k32_m26_p06);
+          v[20] = K_MADD_EPI32(u[8], k32_m10_p22);
+          v[21] = K_MADD_EPI32(u[9], k32_m10_p22);
+          v[22] = K_MADD_EPI32(u[10], k32_m10_p22);
+          v[23] = K_MADD_EPI32(u[11], k32_m10_p22);
+          v[24] = K_MADD_EPI32(u[4], k32_m18_p14);
+          v[25] = K_MADD_EPI32(u[5], k32_m18_p14);
+          v[26] = K_MADD_EPI32(u[6], k32_m18_p14);
+          v[27] = K_MADD_EPI32(u[7], k32_m18_p14);
+          v[28] = K_MADD_EPI32(u[0], k32_m02_p30);
+          v[29] = K_MADD_EPI32(u[1], k32_m02_p30);
+          v[30] = K_MADD_EPI32(u[2], k32_m02_p30);
+          v[31] = K_MADD_EPI32(u[3], k32_m02_p30);
 
           u[0] = k_packs_epi64_avx2(v[0], v[1]);
           u[1] = k_packs_epi64_avx2(v[2], v[3]);
@@ -2337,14 +2369,14 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           u[14] = _mm256_srai_epi32(v[14], 2);
           u[15] = _mm256_srai_epi32(v[15], 2);
 
-          out[2] = _mm256_packs_epi32(u[0], u[1]);
-          out[18] = _mm256_packs_epi32(u[2], u[3]);
-          out[10] = _mm256_packs_epi32(u[4], u[5]);
-          out[26] = _mm256_packs_epi32(u[6], u[7]);
-          out[6] = _mm256_packs_epi32(u[8], u[9]);
-          out[22] = _mm256_packs_epi32(u[10], u[11]);
-          out[14] = _mm256_packs_epi32(u[12], u[13]);
-          out[30] = _mm256_packs_epi32(u[14], u[15]);
+          out[2] = PACKS_EPI32(u[0], u[1]);
+          out[18] = PACKS_EPI32(u[2], u[3]);
+          out[10] = PACKS_EPI32(u[4], u[5]);
+          out[26] = PACKS_EPI32(u[6], u[7]);
+          out[6] = PACKS_EPI32(u[8], u[9]);
+          out[22] = PACKS_EPI32(u[10], u[11]);
+          out[14] = PACKS_EPI32(u[12], u[13]);
+          out[30] = PACKS_EPI32(u[14], u[15]);
         }
         {
           lstep1[32] = _mm256_add_epi32(lstep3[34], lstep2[32]);
@@ -2416,38 +2448,38 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           u[14] = _mm256_unpacklo_epi32(lstep1[39], lstep1[57]);
           u[15] = _mm256_unpackhi_epi32(lstep1[39], lstep1[57]);
 
-          v[0] = k_madd_epi32_avx2(u[0], k32_p31_p01);
-          v[1] = k_madd_epi32_avx2(u[1], k32_p31_p01);
-          v[2] = k_madd_epi32_avx2(u[2], k32_p31_p01);
-          v[3] = k_madd_epi32_avx2(u[3], k32_p31_p01);
-          v[4] = k_madd_epi32_avx2(u[4], k32_p15_p17);
-          v[5] = k_madd_epi32_avx2(u[5], k32_p15_p17);
-          v[6] = k_madd_epi32_avx2(u[6], k32_p15_p17);
-          v[7] = k_madd_epi32_avx2(u[7], k32_p15_p17);
-          v[8] = k_madd_epi32_avx2(u[8], k32_p23_p09);
-          v[9] = k_madd_epi32_avx2(u[9], k32_p23_p09);
-          v[10] = k_madd_epi32_avx2(u[10], k32_p23_p09);
-          v[11] = k_madd_epi32_avx2(u[11], k32_p23_p09);
-          v[12] = k_madd_epi32_avx2(u[12], k32_p07_p25);
-          v[13] = k_madd_epi32_avx2(u[13], k32_p07_p25);
-          v[14] = k_madd_epi32_avx2(u[14], k32_p07_p25);
-          v[15] = k_madd_epi32_avx2(u[15], k32_p07_p25);
-          v[16] = k_madd_epi32_avx2(u[12], k32_m25_p07);
-          v[17] = k_madd_epi32_avx2(u[13], k32_m25_p07);
-          v[18] = k_madd_epi32_avx2(u[14], k32_m25_p07);
-          v[19] = k_madd_epi32_avx2(u[15], k32_m25_p07);
-          v[20] = k_madd_epi32_avx2(u[8], k32_m09_p23);
-          v[21] = k_madd_epi32_avx2(u[9], k32_m09_p23);
-          v[22] = k_madd_epi32_avx2(u[10], k32_m09_p23);
-          v[23] = k_madd_epi32_avx2(u[11], k32_m09_p23);
-          v[24] = k_madd_epi32_avx2(u[4], k32_m17_p15);
-          v[25] = k_madd_epi32_avx2(u[5], k32_m17_p15);
-          v[26] = k_madd_epi32_avx2(u[6], k32_m17_p15);
-          v[27] = k_madd_epi32_avx2(u[7], k32_m17_p15);
-          v[28] = k_madd_epi32_avx2(u[0], k32_m01_p31);
-          v[29] = k_madd_epi32_avx2(u[1], k32_m01_p31);
-          v[30] = k_madd_epi32_avx2(u[2], k32_m01_p31);
-          v[31] = k_madd_epi32_avx2(u[3], k32_m01_p31);
+          v[0] = K_MADD_EPI32(u[0], k32_p31_p01);
+          v[1] = K_MADD_EPI32(u[1], k32_p31_p01);
+          v[2] = K_MADD_EPI32(u[2], k32_p31_p01);
+          v[3] = K_MADD_EPI32(u[3], k32_p31_p01);
+          v[4] = K_MADD_EPI32(u[4], k32_p15_p17);
+          v[5] = K_MADD_EPI32(u[5], k32_p15_p17);
+          v[6] = K_MADD_EPI32(u[6], k32_p15_p17);
+          v[7] = K_MADD_EPI32(u[7], k32_p15_p17);
+          v[8] = K_MADD_EPI32(u[8], k32_p23_p09);
+          v[9] = K_MADD_EPI32(u[9], k32_p23_p09);
+          v[10] = K_MADD_EPI32(u[10], k32_p23_p09);
+          v[11] = K_MADD_EPI32(u[11], k32_p23_p09);
+          v[12] = K_MADD_EPI32(u[12], k32_p07_p25);
+          v[13] = K_MADD_EPI32(u[13], k32_p07_p25);
+          v[14] = K_MADD_EPI32(u[14], k32_p07_p25);
+          v[15] = K_MADD_EPI32(u[15], k32_p07_p25);
+          v[16] = K_MADD_EPI32(u[12], k32_m25_p07);
+          v[17] = K_MADD_EPI32(u[13], k32_m25_p07);
+          v[18] = K_MADD_EPI32(u[14], k32_m25_p07);
+          v[19] = K_MADD_EPI32(u[15], k32_m25_p07);
+          v[20] = K_MADD_EPI32(u[8], k32_m09_p23);
+          v[21] = K_MADD_EPI32(u[9], k32_m09_p23);
+          v[22] = K_MADD_EPI32(u[10], k32_m09_p23);
+          v[23] = K_MADD_EPI32(u[11], k32_m09_p23);
+          v[24] = K_MADD_EPI32(u[4], k32_m17_p15);
+          v[25] = K_MADD_EPI32(u[5], k32_m17_p15);
+          v[26] = K_MADD_EPI32(u[6], k32_m17_p15);
+          v[27] = K_MADD_EPI32(u[7], k32_m17_p15);
+          v[28] = K_MADD_EPI32(u[0], k32_m01_p31);
+          v[29] = K_MADD_EPI32(u[1], k32_m01_p31);
+          v[30] = K_MADD_EPI32(u[2], k32_m01_p31);
+          v[31] = K_MADD_EPI32(u[3], k32_m01_p31);
 
           u[0] = k_packs_epi64_avx2(v[0], v[1]);
           u[1] = k_packs_epi64_avx2(v[2], v[3]);
@@ -2568,14 +2600,14 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           u[14] = _mm256_srai_epi32(v[14], 2);
           u[15] = _mm256_srai_epi32(v[15], 2);
 
-          out[1] = _mm256_packs_epi32(u[0], u[1]);
-          out[17] = _mm256_packs_epi32(u[2], u[3]);
-          out[9] = _mm256_packs_epi32(u[4], u[5]);
-          out[25] = _mm256_packs_epi32(u[6], u[7]);
-          out[7] = _mm256_packs_epi32(u[8], u[9]);
-          out[23] = _mm256_packs_epi32(u[10], u[11]);
-          out[15] = _mm256_packs_epi32(u[12], u[13]);
-          out[31] = _mm256_packs_epi32(u[14], u[15]);
+          out[1] = PACKS_EPI32(u[0], u[1]);
+          out[17] = PACKS_EPI32(u[2], u[3]);
+          out[9] = PACKS_EPI32(u[4], u[5]);
+          out[25] = PACKS_EPI32(u[6], u[7]);
+          out[7] = PACKS_EPI32(u[8], u[9]);
+          out[23] = PACKS_EPI32(u[10], u[11]);
+          out[15] = PACKS_EPI32(u[12], u[13]);
+          out[31] = PACKS_EPI32(u[14], u[15]);
         }
         {
           const __m256i k32_p27_p05 =
@@ -2612,38 +2644,38 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           u[14] = _mm256_unpacklo_epi32(lstep1[47], lstep1[49]);
           u[15] = _mm256_unpackhi_epi32(lstep1[47], lstep1[49]);
 
-          v[0] = k_madd_epi32_avx2(u[0], k32_p27_p05);
-          v[1] = k_madd_epi32_avx2(u[1], k32_p27_p05);
-          v[2] = k_madd_epi32_avx2(u[2], k32_p27_p05);
-          v[3] = k_madd_epi32_avx2(u[3], k32_p27_p05);
-          v[4] = k_madd_epi32_avx2(u[4], k32_p11_p21);
-          v[5] = k_madd_epi32_avx2(u[5], k32_p11_p21);
-          v[6] = k_madd_epi32_avx2(u[6], k32_p11_p21);
-          v[7] = k_madd_epi32_avx2(u[7], k32_p11_p21);
-          v[8] = k_madd_epi32_avx2(u[8], k32_p19_p13);
-          v[9] = k_madd_epi32_avx2(u[9], k32_p19_p13);
-          v[10] = k_madd_epi32_avx2(u[10], k32_p19_p13);
-          v[11] = k_madd_epi32_avx2(u[11], k32_p19_p13);
-          v[12] = k_madd_epi32_avx2(u[12], k32_p03_p29);
-          v[13] = k_madd_epi32_avx2(u[13], k32_p03_p29);
-          v[14] = k_madd_epi32_avx2(u[14], k32_p03_p29);
-          v[15] = k_madd_epi32_avx2(u[15], k32_p03_p29);
-          v[16] = k_madd_epi32_avx2(u[12], k32_m29_p03);
-          v[17] = k_madd_epi32_avx2(u[13], k32_m29_p03);
-          v[18] = k_madd_epi32_avx2(u[14], k32_m29_p03);
-          v[19] = k_madd_epi32_avx2(u[15], k32_m29_p03);
-          v[20] = k_madd_epi32_avx2(u[8], k32_m13_p19);
-          v[21] = k_madd_epi32_avx2(u[9], k32_m13_p19);
-          v[22] = k_madd_epi32_avx2(u[10], k32_m13_p19);
-          v[23] = k_madd_epi32_avx2(u[11], k32_m13_p19);
-          v[24] = k_madd_epi32_avx2(u[4], k32_m21_p11);
-          v[25] = k_madd_epi32_avx2(u[5], k32_m21_p11);
-          v[26] = k_madd_epi32_avx2(u[6], k32_m21_p11);
-          v[27] = k_madd_epi32_avx2(u[7], k32_m21_p11);
-          v[28] = k_madd_epi32_avx2(u[0], k32_m05_p27);
-          v[29] = k_madd_epi32_avx2(u[1], k32_m05_p27);
-          v[30] = k_madd_epi32_avx2(u[2], k32_m05_p27);
-          v[31] = k_madd_epi32_avx2(u[3], k32_m05_p27);
+          v[0] = K_MADD_EPI32(u[0], k32_p27_p05);
+          v[1] = K_MADD_EPI32(u[1], k32_p27_p05);
+          v[2] = K_MADD_EPI32(u[2], k32_p27_p05);
+          v[3] = K_MADD_EPI32(u[3], k32_p27_p05);
+          v[4] = K_MADD_EPI32(u[4], k32_p11_p21);
+          v[5] = K_MADD_EPI32(u[5], k32_p11_p21);
+          v[6] = K_MADD_EPI32(u[6], k32_p11_p21);
+          v[7] = K_MADD_EPI32(u[7], k32_p11_p21);
+          v[8] = K_MADD_EPI32(u[8], k32_p19_p13);
+          v[9] = K_MADD_EPI32(u[9], k32_p19_p13);
+          v[10] = K_MADD_EPI32(u[10], k32_p19_p13);
+          v[11] = K_MADD_EPI32(u[11], k32_p19_p13);
+          v[12] = K_MADD_EPI32(u[12], k32_p03_p29);
+          v[13] = K_MADD_EPI32(u[13], k32_p03_p29);
+          v[14] = K_MADD_EPI32(u[14], k32_p03_p29);
+          v[15] = K_MADD_EPI32(u[15], k32_p03_p29);
+          v[16] = K_MADD_EPI32(u[12], k32_m29_p03);
+          v[17] = K_MADD_EPI32(u[13], k32_m29_p03);
+          v[18] = K_MADD_EPI32(u[14], k32_m29_p03);
+          v[19] = K_MADD_EPI32(u[15], k32_m29_p03);
+          v[20] = K_MADD_EPI32(u[8], k32_m13_p19);
+          v[21] = K_MADD_EPI32(u[9], k32_m13_p19);
+          v[22] = K_MADD_EPI32(u[10], k32_m13_p19);
+          v[23] = K_MADD_EPI32(u[11], k32_m13_p19);
+          v[24] = K_MADD_EPI32(u[4], k32_m21_p11);
+          v[25] = K_MADD_EPI32(u[5], k32_m21_p11);
+          v[26] = K_MADD_EPI32(u[6], k32_m21_p11);
+          v[27] = K_MADD_EPI32(u[7], k32_m21_p11);
+          v[28] = K_MADD_EPI32(u[0], k32_m05_p27);
+          v[29] = K_MADD_EPI32(u[1], k32_m05_p27);
+          v[30] = K_MADD_EPI32(u[2], k32_m05_p27);
+          v[31] = K_MADD_EPI32(u[3], k32_m05_p27);
 
           u[0] = k_packs_epi64_avx2(v[0], v[1]);
           u[1] = k_packs_epi64_avx2(v[2], v[3]);
@@ -2764,28 +2796,25 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
           u[14] = _mm256_srai_epi32(v[14], 2);
           u[15] = _mm256_srai_epi32(v[15], 2);
 
-          out[5] = _mm256_packs_epi32(u[0], u[1]);
-          out[21] = _mm256_packs_epi32(u[2], u[3]);
-          out[13] = _mm256_packs_epi32(u[4], u[5]);
-          out[29] = _mm256_packs_epi32(u[6], u[7]);
-          out[3] = _mm256_packs_epi32(u[8], u[9]);
-          out[19] = _mm256_packs_epi32(u[10], u[11]);
-          out[11] = _mm256_packs_epi32(u[12], u[13]);
-          out[27] = _mm256_packs_epi32(u[14], u[15]);
+          out[5] = PACKS_EPI32(u[0], u[1]);
+          out[21] = PACKS_EPI32(u[2], u[3]);
+          out[13] = PACKS_EPI32(u[4], u[5]);
+          out[29] = PACKS_EPI32(u[6], u[7]);
+          out[3] = PACKS_EPI32(u[8], u[9]);
+          out[19] = PACKS_EPI32(u[10], u[11]);
+          out[11] = PACKS_EPI32(u[12], u[13]);
+          out[27] = PACKS_EPI32(u[14], u[15]);
         }
       }
 #endif
       // Transpose the results, do it as four 8x8 transposes.
       {
         int transpose_block;
-        int16_t *output_currStep, *output_nextStep;
-        if (0 == pass) {
-          output_currStep = &intermediate[column_start * 32];
-          output_nextStep = &intermediate[(column_start + 8) * 32];
-        } else {
-          output_currStep = &output_org[column_start * 32];
-          output_nextStep = &output_org[(column_start + 8) * 32];
-        }
+        int16_t *intermediate_currStep = &intermediate[column_start * 32];
+        int16_t *intermediate_nextStep =
+            &intermediate[(column_start + 8) * 32];
+        tran_low_t *output_currStep = &output_org[column_start * 32];
+        tran_low_t *output_nextStep = &output_org[(column_start + 8) * 32];
         for (transpose_block = 0; transpose_block < 4; ++transpose_block) {
           __m256i *this_out = &out[8 * transpose_block];
           // 00  01  02  03  04  05  06  07  08  09  10  11  12  13  14  15
@@ -2858,24 +2887,24 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
             __m256i tr2_5_0 = _mm256_cmpgt_epi16(tr2_5, kZero);
             __m256i tr2_6_0 = _mm256_cmpgt_epi16(tr2_6, kZero);
             __m256i tr2_7_0 = _mm256_cmpgt_epi16(tr2_7, kZero);
-            tr2_0 = _mm256_sub_epi16(tr2_0, tr2_0_0);
-            tr2_1 = _mm256_sub_epi16(tr2_1, tr2_1_0);
-            tr2_2 = _mm256_sub_epi16(tr2_2, tr2_2_0);
-            tr2_3 = _mm256_sub_epi16(tr2_3, tr2_3_0);
-            tr2_4 = _mm256_sub_epi16(tr2_4, tr2_4_0);
-            tr2_5 = _mm256_sub_epi16(tr2_5, tr2_5_0);
-            tr2_6 = _mm256_sub_epi16(tr2_6, tr2_6_0);
-            tr2_7 = _mm256_sub_epi16(tr2_7, tr2_7_0);
+            tr2_0 = SUB_EPI16(tr2_0, tr2_0_0);
+            tr2_1 = SUB_EPI16(tr2_1, tr2_1_0);
+            tr2_2 = SUB_EPI16(tr2_2, tr2_2_0);
+            tr2_3 = SUB_EPI16(tr2_3, tr2_3_0);
+            tr2_4 = SUB_EPI16(tr2_4, tr2_4_0);
+            tr2_5 = SUB_EPI16(tr2_5, tr2_5_0);
+            tr2_6 = SUB_EPI16(tr2_6, tr2_6_0);
+            tr2_7 = SUB_EPI16(tr2_7, tr2_7_0);
             //           ... and here.
             //           PS: also change code in vp9/encoder/vp9_dct.c
-            tr2_0 = _mm256_add_epi16(tr2_0, kOne);
-            tr2_1 = _mm256_add_epi16(tr2_1, kOne);
-            tr2_2 = _mm256_add_epi16(tr2_2, kOne);
-            tr2_3 = _mm256_add_epi16(tr2_3, kOne);
-            tr2_4 = _mm256_add_epi16(tr2_4, kOne);
-            tr2_5 = _mm256_add_epi16(tr2_5, kOne);
-            tr2_6 = _mm256_add_epi16(tr2_6, kOne);
-            tr2_7 = _mm256_add_epi16(tr2_7, kOne);
+            tr2_0 = ADD_EPI16(tr2_0, kOne);
+            tr2_1 = ADD_EPI16(tr2_1, kOne);
+            tr2_2 = ADD_EPI16(tr2_2, kOne);
+            tr2_3 = ADD_EPI16(tr2_3, kOne);
+            tr2_4 = ADD_EPI16(tr2_4, kOne);
+            tr2_5 = ADD_EPI16(tr2_5, kOne);
+            tr2_6 = ADD_EPI16(tr2_6, kOne);
+            tr2_7 = ADD_EPI16(tr2_7, kOne);
             tr2_0 = _mm256_srai_epi16(tr2_0, 2);
             tr2_1 = _mm256_srai_epi16(tr2_1, 2);
             tr2_2 = _mm256_srai_epi16(tr2_2, 2);
@@ -2885,46 +2914,59 @@ void FDCT32x32_2D_AVX2(const int16_t *input, int16_t *output_org, int stride) {
             tr2_6 = _mm256_srai_epi16(tr2_6, 2);
             tr2_7 = _mm256_srai_epi16(tr2_7, 2);
           }
-          // Note: even though all these stores are aligned, using the aligned
-          //       intrinsic make the code slightly slower.
-          _mm_storeu_si128((__m128i *)(output_currStep + 0 * 32),
-                           _mm256_castsi256_si128(tr2_0));
-          _mm_storeu_si128((__m128i *)(output_currStep + 1 * 32),
-                           _mm256_castsi256_si128(tr2_1));
-          _mm_storeu_si128((__m128i *)(output_currStep + 2 * 32),
-                           _mm256_castsi256_si128(tr2_2));
-          _mm_storeu_si128((__m128i *)(output_currStep + 3 * 32),
-                           _mm256_castsi256_si128(tr2_3));
-          _mm_storeu_si128((__m128i *)(output_currStep + 4 * 32),
-                           _mm256_castsi256_si128(tr2_4));
-          _mm_storeu_si128((__m128i *)(output_currStep + 5 * 32),
-                           _mm256_castsi256_si128(tr2_5));
-          _mm_storeu_si128((__m128i *)(output_currStep + 6 * 32),
-                           _mm256_castsi256_si128(tr2_6));
-          _mm_storeu_si128((__m128i *)(output_currStep + 7 * 32),
-                           _mm256_castsi256_si128(tr2_7));
-
-          _mm_storeu_si128((__m128i *)(output_nextStep + 0 * 32),
-                           _mm256_extractf128_si256(tr2_0, 1));
-          _mm_storeu_si128((__m128i *)(output_nextStep + 1 * 32),
-                           _mm256_extractf128_si256(tr2_1, 1));
-          _mm_storeu_si128((__m128i *)(output_nextStep + 2 * 32),
-                           _mm256_extractf128_si256(tr2_2, 1));
-          _mm_storeu_si128((__m128i *)(output_nextStep + 3 * 32),
-                           _mm256_extractf128_si256(tr2_3, 1));
-          _mm_storeu_si128((__m128i *)(output_nextStep + 4 * 32),
-                           _mm256_extractf128_si256(tr2_4, 1));
-          _mm_storeu_si128((__m128i *)(output_nextStep + 5 * 32),
-                           _mm256_extractf128_si256(tr2_5, 1));
-          _mm_storeu_si128((__m128i *)(output_nextStep + 6 * 32),
-                           _mm256_extractf128_si256(tr2_6, 1));
-          _mm_storeu_si128((__m128i *)(output_nextStep + 7 * 32),
-                           _mm256_extractf128_si256(tr2_7, 1));
+          {
+            __m256i res[8];
+            int i;
+            res[0] = tr2_0;
+            res[1] = tr2_1;
+            res[2] = tr2_2;
+            res[3] = tr2_3;
+            res[4] = tr2_4;
+            res[5] = tr2_5;
+            res[6] = tr2_6;
+            res[7] = tr2_7;
+            for (i = 0; i < 8; ++i) {
+              const __m128i lo = _mm256_castsi256_si128(res[i]);
+              const __m128i hi = _mm256_extractf128_si256(res[i], 1);
+              if (0 == pass) {
+                // Note: even though all these stores are aligned, using the
+                //       aligned intrinsic make the code slightly slower.
+                _mm_storeu_si128((__m128i *)(intermediate_currStep + i * 32),
+                                 lo);
+                _mm_storeu_si128((__m128i *)(intermediate_nextStep + i * 32),
+                                 hi);
+              } else {
+                store_output(&lo, output_currStep + i * 32);
+                store_output(&hi, output_nextStep + i * 32);
+              }
+            }
+          }
           // Process next 8x8
+          intermediate_currStep += 8;
+          intermediate_nextStep += 8;
           output_currStep += 8;
           output_nextStep += 8;
         }
       }
     }
+#if DCT_HIGH_BIT_DEPTH
+    if (has_overflow_avx2(overflow)) {
+      if (0 == pass) {
+        HIGH_FDCT32x32_2D_C(input, output_org, stride);
+      } else {
+        HIGH_FDCT32x32_2D_ROWS_C(intermediate, output_org);
+      }
+      return;
+    }
+#endif  // DCT_HIGH_BIT_DEPTH
   }
 }  // NOLINT
+
+#undef ADD_EPI16
+#undef SUB_EPI16
+#undef PACKS_EPI32
+#undef K_MADD_EPI32
+#if DCT_HIGH_BIT_DEPTH
+#undef HIGH_FDCT32x32_2D_C
+#undef HIGH_FDCT32x32_2D_ROWS_C
+#endif  // DCT_HIGH_BIT_DEPTH
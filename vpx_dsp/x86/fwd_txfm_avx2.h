@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VPX_DSP_X86_FWD_TXFM_AVX2_H_
+#define VPX_VPX_DSP_X86_FWD_TXFM_AVX2_H_
+
+#include <immintrin.h>  // AVX2
+
+#include "vpx/vpx_integer.h"
+#include "vpx_dsp/txfm_common.h"
+#include "vpx_ports/mem.h"
+
+static INLINE __m256i k_madd_epi32_avx2(__m256i a, __m256i b) {
+  __m256i buf0, buf1;
+  buf0 = _mm256_mul_epu32(a, b);
+  a = _mm256_srli_epi64(a, 32);
+  b = _mm256_srli_epi64(b, 32);
+  buf1 = _mm256_mul_epu32(a, b);
+  return _mm256_add_epi64(buf0, buf1);
+}
+
+static INLINE __m256i k_packs_epi64_avx2(__m256i a, __m256i b) {
+  __m256i buf0 = _mm256_shuffle_epi32(a, _MM_SHUFFLE(0, 0, 2, 0));
+  __m256i buf1 = _mm256_shuffle_epi32(b, _MM_SHUFFLE(0, 0, 2, 0));
+  return _mm256_unpacklo_epi64(buf0, buf1);
+}
+
+// The high bitdepth transforms run the 16 bit kernels with saturating
+// arithmetic. Every result is folded into *overflow, which keeps the largest
+// 16 bit magnitude seen so far. A saturated result is 0x7fff or 0x8000, the
+// two largest magnitudes, so has_overflow_avx2() can tell afterwards whether
+// the output may differ from the C transform.
+static INLINE void update_overflow_epi16_avx2(__m256i *overflow, __m256i a) {
+  *overflow = _mm256_max_epu16(*overflow, _mm256_abs_epi16(a));
+}
+
+static INLINE __m256i adds_epi16_overflow_avx2(__m256i a, __m256i b,
+                                               __m256i *overflow) {
+  const __m256i res = _mm256_adds_epi16(a, b);
+  update_overflow_epi16_avx2(overflow, res);
+  return res;
+}
+
+static INLINE __m256i subs_epi16_overflow_avx2(__m256i a, __m256i b,
+                                               __m256i *overflow) {
+  const __m256i res = _mm256_subs_epi16(a, b);
+  update_overflow_epi16_avx2(overflow, res);
+  return res;
+}
+
+static INLINE __m256i packs_epi32_overflow_avx2(__m256i a, __m256i b,
+                                                __m256i *overflow) {
+  const __m256i res = _mm256_packs_epi32(a, b);
+  update_overflow_epi16_avx2(overflow, res);
+  return res;
+}
+
+// Signed version of k_madd_epi32_avx2(). Sums that would not fit in 32 bits
+// once the DCT rounding is added mark every lane of *overflow.
+static INLINE __m256i k_madd_epi32_overflow_avx2(__m256i a, __m256i b,
+                                                 __m256i *overflow) {
+  const __m256i max = _mm256_set1_epi64x(INT32_MAX - DCT_CONST_ROUNDING);
+  const __m256i min = _mm256_set1_epi64x(INT32_MIN);
+  const __m256i buf0 = _mm256_mul_epi32(a, b);
+  const __m256i buf1 =
+      _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+  const __m256i res = _mm256_add_epi64(buf0, buf1);
+  *overflow = _mm256_or_si256(*overflow, _mm256_cmpgt_epi64(res, max));
+  *overflow = _mm256_or_si256(*overflow, _mm256_cmpgt_epi64(min, res));
+  return res;
+}
+
+static INLINE int has_overflow_avx2(__m256i overflow) {
+  const __m256i res =
+      _mm256_subs_epu16(overflow, _mm256_set1_epi16(INT16_MAX - 1));
+  return !_mm256_testz_si256(res, res);
+}
+
+#endif  // VPX_VPX_DSP_X86_FWD_TXFM_AVX2_H_
@@ -0,0 +1,306 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_dsp/x86/highbd_inv_txfm_avx2.h"
+#include "vpx_dsp/x86/inv_txfm_avx2.h"
+#include "vpx_dsp/x86/transpose_avx2.h"
+
+static INLINE void highbd_idct16_8col_stage5(const __m256i *const in,
+                                             __m256i *const out) {
+  // stage 5
+  out[0] = _mm256_add_epi32(in[0], in[3]);
+  out[1] = _mm256_add_epi32(in[1], in[2]);
+  out[2] = _mm256_sub_epi32(in[1], in[2]);
+  out[3] = _mm256_sub_epi32(in[0], in[3]);
+  highbd_butterfly_cospi16_avx2(in[6], in[5], &out[6], &out[5]);
+  out[8] = _mm256_add_epi32(in[8], in[11]);
+  out[9] = _mm256_add_epi32(in[9], in[10]);
+  out[10] = _mm256_sub_epi32(in[9], in[10]);
+  out[11] = _mm256_sub_epi32(in[8], in[11]);
+  out[12] = _mm256_sub_epi32(in[15], in[12]);
+  out[13] = _mm256_sub_epi32(in[14], in[13]);
+  out[14] = _mm256_add_epi32(in[14], in[13]);
+  out[15] = _mm256_add_epi32(in[15], in[12]);
+}
+
+static INLINE void highbd_idct16_8col_stage6(const __m256i *const in,
+                                             __m256i *const out) {
+  out[0] = _mm256_add_epi32(in[0], in[7]);
+  out[1] = _mm256_add_epi32(in[1], in[6]);
+  out[2] = _mm256_add_epi32(in[2], in[5]);
+  out[3] = _mm256_add_epi32(in[3], in[4]);
+  out[4] = _mm256_sub_epi32(in[3], in[4]);
+  out[5] = _mm256_sub_epi32(in[2], in[5]);
+  out[6] = _mm256_sub_epi32(in[1], in[6]);
+  out[7] = _mm256_sub_epi32(in[0], in[7]);
+  out[8] = in[8];
+  out[9] = in[9];
+  highbd_butterfly_cospi16_avx2(in[13], in[10], &out[13], &out[10]);
+  highbd_butterfly_cospi16_avx2(in[12], in[11], &out[12], &out[11]);
+  out[14] = in[14];
+  out[15] = in[15];
+}
+
+void vpx_highbd_idct16_8col_avx2(__m256i *const io /*io[16]*/) {
+  __m256i step1[16], step2[16];
+
+  // stage 2
+  highbd_butterfly_avx2(io[1], io[15], cospi_30_64, cospi_2_64, &step2[8],
+                        &step2[15]);
+  highbd_butterfly_avx2(io[9], io[7], cospi_14_64, cospi_18_64, &step2[9],
+                        &step2[14]);
+  highbd_butterfly_avx2(io[5], io[11], cospi_22_64, cospi_10_64, &step2[10],
+                        &step2[13]);
+  highbd_butterfly_avx2(io[13], io[3], cospi_6_64, cospi_26_64, &step2[11],
+                        &step2[12]);
+
+  // stage 3
+  highbd_butterfly_avx2(io[2], io[14], cospi_28_64, cospi_4_64, &step1[4],
+                        &step1[7]);
+  highbd_butterfly_avx2(io[10], io[6], cospi_12_64, cospi_20_64, &step1[5],
+                        &step1[6]);
+  step1[8] = _mm256_add_epi32(step2[8], step2[9]);
+  step1[9] = _mm256_sub_epi32(step2[8], step2[9]);
+  step1[10] = _mm256_sub_epi32(step2[11], step2[10]);
+  step1[11] = _mm256_add_epi32(step2[11], step2[10]);
+  step1[12] = _mm256_add_epi32(step2[12], step2[13]);
+  step1[13] = _mm256_sub_epi32(step2[12], step2[13]);
+  step1[14] = _mm256_sub_epi32(step2[15], step2[14]);
+  step1[15] = _mm256_add_epi32(step2[15], step2[14]);
+
+  // stage 4
+  highbd_butterfly_cospi16_avx2(io[0], io[8], &step2[0], &step2[1]);
+  highbd_butterfly_avx2(io[4], io[12], cospi_24_64, cospi_8_64, &step2[2],
+                        &step2[3]);
+  highbd_butterfly_avx2(step1[14], step1[9], cospi_24_64, cospi_8_64, &step2[9],
+                        &step2[14]);
+  highbd_butterfly_avx2(step1[10], step1[13], -cospi_8_64, -cospi_24_64,
+                        &step2[13], &step2[10]);
+  step2[5] = _mm256_sub_epi32(step1[4], step1[5]);
+  step1[4] = _mm256_add_epi32(step1[4], step1[5]);
+  step2[6] = _mm256_sub_epi32(step1[7], step1[6]);
+  step1[7] = _mm256_add_epi32(step1[7], step1[6]);
+  step2[8] = step1[8];
+  step2[11] = step1[11];
+  step2[12] = step1[12];
+  step2[15] = step1[15];
+
+  highbd_idct16_8col_stage5(step2, step1);
+  highbd_idct16_8col_stage6(step1, step2);
+  highbd_idct16_8col_stage7(step2, io);
+}
+
+static INLINE void highbd_idct16x16_38_8col(__m256i *const io /*io[16]*/) {
+  __m256i step1[16], step2[16];
+  __m256i temp1[2];
+
+  // stage 2
+  highbd_partial_butterfly_avx2(io[1], cospi_30_64, cospi_2_64, &step2[8],
+                                &step2[15]);
+  highbd_partial_butterfly_avx2(io[7], -cospi_18_64, cospi_14_64, &step2[9],
+                                &step2[14]);
+  highbd_partial_butterfly_avx2(io[5], cospi_22_64, cospi_10_64, &step2[10],
+                                &step2[13]);
+  highbd_partial_butterfly_avx2(io[3], -cospi_26_64, cospi_6_64, &step2[11],
+                                &step2[12]);
+
+  // stage 3
+  highbd_partial_butterfly_avx2(io[2], cospi_28_64, cospi_4_64, &step1[4],
+                                &step1[7]);
+  highbd_partial_butterfly_avx2(io[6], -cospi_20_64, cospi_12_64, &step1[5],
+                                &step1[6]);
+  step1[8] = _mm256_add_epi32(step2[8], step2[9]);
+  step1[9] = _mm256_sub_epi32(step2[8], step2[9]);
+  step1[10] = _mm256_sub_epi32(step2[11], step2[10]);
+  step1[11] = _mm256_add_epi32(step2[11], step2[10]);
+  step1[12] = _mm256_add_epi32(step2[12], step2[13]);
+  step1[13] = _mm256_sub_epi32(step2[12], step2[13]);
+  step1[14] = _mm256_sub_epi32(step2[15], step2[14]);
+  step1[15] = _mm256_add_epi32(step2[15], step2[14]);
+
+  // stage 4
+  extend_64bit_avx2(io[0], temp1);
+  step2[0] = multiplication_round_shift_avx2(temp1, cospi_16_64);
+  step2[1] = step2[0];
+  highbd_partial_butterfly_avx2(io[4], cospi_24_64, cospi_8_64, &step2[2],
+                                &step2[3]);
+  highbd_butterfly_avx2(step1[14], step1[9], cospi_24_64, cospi_8_64, &step2[9],
+                        &step2[14]);
+  highbd_butterfly_avx2(step1[10], step1[13], -cospi_8_64, -cospi_24_64,
+                        &step2[13], &step2[10]);
+  step2[5] = _mm256_sub_epi32(step1[4], step1[5]);
+  step1[4] = _mm256_add_epi32(step1[4], step1[5]);
+  step2[6] = _mm256_sub_epi32(step1[7], step1[6]);
+  step1[7] = _mm256_add_epi32(step1[7], step1[6]);
+  step2[8] = step1[8];
+  step2[11] = step1[11];
+  step2[12] = step1[12];
+  step2[15] = step1[15];
+
+  highbd_idct16_8col_stage5(step2, step1);
+  highbd_idct16_8col_stage6(step1, step2);
+  highbd_idct16_8col_stage7(step2, io);
+}
+
+static INLINE void highbd_idct16x16_10_8col(__m256i *const io /*io[16]*/) {
+  __m256i step1[16], step2[16];
+  __m256i temp[2];
+
+  // stage 2
+  highbd_partial_butterfly_avx2(io[1], cospi_30_64, cospi_2_64, &step2[8],
+                                &step2[15]);
+  highbd_partial_butterfly_avx2(io[3], -cospi_26_64, cospi_6_64, &step2[11],
+                                &step2[12]);
+
+  // stage 3
+  highbd_partial_butterfly_avx2(io[2], cospi_28_64, cospi_4_64, &step1[4],
+                                &step1[7]);
+  step1[8] = step2[8];
+  step1[9] = step2[8];
+  step1[10] = step2[11];
+  step1[11] = step2[11];
+  step1[12] = step2[12];
+  step1[13] = step2[12];
+  step1[14] = step2[15];
+  step1[15] = step2[15];
+
+  // stage 4
+  extend_64bit_avx2(io[0], temp);
+  step2[0] = multiplication_round_shift_avx2(temp, cospi_16_64);
+  step2[1] = step2[0];
+  step2[2] = _mm256_setzero_si256();
+  step2[3] = _mm256_setzero_si256();
+  highbd_butterfly_avx2(step1[14], step1[9], cospi_24_64, cospi_8_64, &step2[9],
+                        &step2[14]);
+  highbd_butterfly_avx2(step1[10], step1[13], -cospi_8_64, -cospi_24_64,
+                        &step2[13], &step2[10]);
+  step2[5] = step1[4];
+  step2[6] = step1[7];
+  step2[8] = step1[8];
+  step2[11] = step1[11];
+  step2[12] = step1[12];
+  step2[15] = step1[15];
+
+  highbd_idct16_8col_stage5(step2, step1);
+  highbd_idct16_8col_stage6(step1, step2);
+  highbd_idct16_8col_stage7(step2, io);
+}
+
+
+void vpx_highbd_idct16x16_256_add_avx2(const tran_low_t *input, uint16_t *dest,
+                                       int stride, int bd) {
+  int i;
+
+  if (bd == 8) {
+    __m256i in[16];
+
+    load_transpose_16bit_16x16_avx2(input, 16, 16, in);
+    idct16_16col_avx2(in, in);
+    transpose_16bit_16x16_avx2(in, in);
+    idct16_16col_avx2(in, in);
+
+    for (i = 0; i < 16; ++i) {
+      highbd_write_buffer_16_avx2(dest + i * stride, in[i], bd);
+    }
+  } else {
+    __m256i all[2][16], out[16], *in;
+
+    for (i = 0; i < 2; i++) {
+      in = all[i];
+      highbd_load_transpose_32bit_8x8_avx2(&input[0], 16, &in[0]);
+      highbd_load_transpose_32bit_8x8_avx2(&input[8], 16, &in[8]);
+      vpx_highbd_idct16_8col_avx2(in);
+      input += 8 * 16;
+    }
+
+    for (i = 0; i < 16; i += 8) {
+      int j;
+      transpose_32bit_8x8_avx2(all[0] + i, out + 0);
+      transpose_32bit_8x8_avx2(all[1] + i, out + 8);
+      vpx_highbd_idct16_8col_avx2(out);
+
+      for (j = 0; j < 16; ++j) {
+        highbd_write_buffer_8_avx2(dest + j * stride, out[j], bd);
+      }
+      dest += 8;
+    }
+  }
+}
+
+void vpx_highbd_idct16x16_38_add_avx2(const tran_low_t *input, uint16_t *dest,
+                                      int stride, int bd) {
+  int i;
+
+  if (bd == 8) {
+    __m256i in[16];
+
+    load_transpose_16bit_16x16_avx2(input, 16, 8, in);
+    idct16_38_16col_avx2(in, in);
+    transpose_16bit_16x16_avx2(in, in);
+    idct16_38_16col_avx2(in, in);
+
+    for (i = 0; i < 16; ++i) {
+      highbd_write_buffer_16_avx2(dest + i * stride, in[i], bd);
+    }
+  } else {
+    __m256i in[16], out[16];
+
+    highbd_load_transpose_32bit_8x8_avx2(input, 16, in);
+    highbd_idct16x16_38_8col(in);
+
+    for (i = 0; i < 16; i += 8) {
+      int j;
+      transpose_32bit_8x8_avx2(in + i, out);
+      highbd_idct16x16_38_8col(out);
+
+      for (j = 0; j < 16; ++j) {
+        highbd_write_buffer_8_avx2(dest + j * stride, out[j], bd);
+      }
+      dest += 8;
+    }
+  }
+}
+
+void vpx_highbd_idct16x16_10_add_avx2(const tran_low_t *input, uint16_t *dest,
+                                      int stride, int bd) {
+  int i;
+
+  if (bd == 8) {
+    __m256i in[16];
+
+    load_transpose_16bit_16x16_avx2(input, 16, 4, in);
+    idct16_10_16col_avx2(in, in);
+    transpose_16bit_16x16_avx2(in, in);
+    idct16_10_16col_avx2(in, in);
+
+    for (i = 0; i < 16; ++i) {
+      highbd_write_buffer_16_avx2(dest + i * stride, in[i], bd);
+    }
+  } else {
+    __m256i in[16], out[16];
+
+    highbd_load_transpose_32bit_8x8_avx2(input, 16, in);
+    highbd_idct16x16_10_8col(in);
+
+    for (i = 0; i < 16; i += 8) {
+      int j;
+      transpose_32bit_8x8_avx2(in + i, out);
+      highbd_idct16x16_10_8col(out);
+
+      for (j = 0; j < 16; ++j) {
+        highbd_write_buffer_8_avx2(dest + j * stride, out[j], bd);
+      }
+      dest += 8;
+    }
+  }
+}
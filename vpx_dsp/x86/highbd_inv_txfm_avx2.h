@@ -0,0 +1,204 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VPX_DSP_X86_HIGHBD_INV_TXFM_AVX2_H_
+#define VPX_VPX_DSP_X86_HIGHBD_INV_TXFM_AVX2_H_
+
+#include <immintrin.h>  // AVX2
+
+#include "./vpx_config.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_dsp/inv_txfm.h"
+#include "vpx_dsp/x86/transpose_avx2.h"
+
+// The high bitdepth AVX2 inverse transforms keep 8 coefficients per register
+// in 32 bit lanes, with the same arithmetic as the SSE4.1 versions.
+// Note: There is no 64-bit bit-level shifting SIMD instruction. All
+// coefficients are left shifted by 2, so that dct_const_round_shift() can be
+// done by right shifting 2 bytes.
+
+#define pair256_set_epi32(a, b)                                                \
+  _mm256_set_epi32((int)(b), (int)(a), (int)(b), (int)(a), (int)(b), (int)(a), \
+                   (int)(b), (int)(a))
+
+static INLINE void extend_64bit_avx2(const __m256i in,
+                                     __m256i *const out /*out[2]*/) {
+  out[0] = _mm256_unpacklo_epi32(in, in);  // 0, 0, 1, 1 | 4, 4, 5, 5
+  out[1] = _mm256_unpackhi_epi32(in, in);  // 2, 2, 3, 3 | 6, 6, 7, 7
+}
+
+static INLINE __m256i dct_const_round_shift_64bit_avx2(const __m256i in) {
+  const __m256i t =
+      _mm256_add_epi64(in, pair256_set_epi32(DCT_CONST_ROUNDING << 2, 0));
+  return _mm256_srli_si256(t, 2);
+}
+
+static INLINE __m256i pack_8_avx2(const __m256i in0, const __m256i in1) {
+  const __m256i t0 = _mm256_unpacklo_epi32(in0, in1);  // 0, 2 | 4, 6
+  const __m256i t1 = _mm256_unpackhi_epi32(in0, in1);  // 1, 3 | 5, 7
+  return _mm256_unpacklo_epi32(t0, t1);  // 0, 1, 2, 3 | 4, 5, 6, 7
+}
+
+// Only do addition and subtraction butterfly, size = 16, 32
+static INLINE void highbd_add_sub_butterfly_avx2(const __m256i *in,
+                                                 __m256i *out, int size) {
+  int i = 0;
+  const int num = size >> 1;
+  const int bound = size - 1;
+  while (i < num) {
+    out[i] = _mm256_add_epi32(in[i], in[bound - i]);
+    out[bound - i] = _mm256_sub_epi32(in[i], in[bound - i]);
+    i++;
+  }
+}
+
+static INLINE void highbd_idct16_8col_stage7(const __m256i *const in,
+                                             __m256i *const out) {
+  out[0] = _mm256_add_epi32(in[0], in[15]);
+  out[1] = _mm256_add_epi32(in[1], in[14]);
+  out[2] = _mm256_add_epi32(in[2], in[13]);
+  out[3] = _mm256_add_epi32(in[3], in[12]);
+  out[4] = _mm256_add_epi32(in[4], in[11]);
+  out[5] = _mm256_add_epi32(in[5], in[10]);
+  out[6] = _mm256_add_epi32(in[6], in[9]);
+  out[7] = _mm256_add_epi32(in[7], in[8]);
+  out[8] = _mm256_sub_epi32(in[7], in[8]);
+  out[9] = _mm256_sub_epi32(in[6], in[9]);
+  out[10] = _mm256_sub_epi32(in[5], in[10]);
+  out[11] = _mm256_sub_epi32(in[4], in[11]);
+  out[12] = _mm256_sub_epi32(in[3], in[12]);
+  out[13] = _mm256_sub_epi32(in[2], in[13]);
+  out[14] = _mm256_sub_epi32(in[1], in[14]);
+  out[15] = _mm256_sub_epi32(in[0], in[15]);
+}
+
+static INLINE __m256i multiplication_round_shift_avx2(
+    const __m256i *const in /*in[2]*/, const int c) {
+  const __m256i pair_c = pair256_set_epi32(c * 4, 0);
+  __m256i t0, t1;
+
+  t0 = _mm256_mul_epi32(in[0], pair_c);
+  t1 = _mm256_mul_epi32(in[1], pair_c);
+  t0 = dct_const_round_shift_64bit_avx2(t0);
+  t1 = dct_const_round_shift_64bit_avx2(t1);
+
+  return pack_8_avx2(t0, t1);
+}
+
+static INLINE void highbd_butterfly_avx2(const __m256i in0, const __m256i in1,
+                                         const int c0, const int c1,
+                                         __m256i *const out0,
+                                         __m256i *const out1) {
+  const __m256i pair_c0 = pair256_set_epi32(4 * c0, 0);
+  const __m256i pair_c1 = pair256_set_epi32(4 * c1, 0);
+  __m256i temp1[4], temp2[4];
+
+  extend_64bit_avx2(in0, temp1);
+  extend_64bit_avx2(in1, temp2);
+  temp1[2] = _mm256_mul_epi32(temp1[0], pair_c1);
+  temp1[3] = _mm256_mul_epi32(temp1[1], pair_c1);
+  temp1[0] = _mm256_mul_epi32(temp1[0], pair_c0);
+  temp1[1] = _mm256_mul_epi32(temp1[1], pair_c0);
+  temp2[2] = _mm256_mul_epi32(temp2[0], pair_c0);
+  temp2[3] = _mm256_mul_epi32(temp2[1], pair_c0);
+  temp2[0] = _mm256_mul_epi32(temp2[0], pair_c1);
+  temp2[1] = _mm256_mul_epi32(temp2[1], pair_c1);
+  temp1[0] = _mm256_sub_epi64(temp1[0], temp2[0]);
+  temp1[1] = _mm256_sub_epi64(temp1[1], temp2[1]);
+  temp2[0] = _mm256_add_epi64(temp1[2], temp2[2]);
+  temp2[1] = _mm256_add_epi64(temp1[3], temp2[3]);
+  temp1[0] = dct_const_round_shift_64bit_avx2(temp1[0]);
+  temp1[1] = dct_const_round_shift_64bit_avx2(temp1[1]);
+  temp2[0] = dct_const_round_shift_64bit_avx2(temp2[0]);
+  temp2[1] = dct_const_round_shift_64bit_avx2(temp2[1]);
+  *out0 = pack_8_avx2(temp1[0], temp1[1]);
+  *out1 = pack_8_avx2(temp2[0], temp2[1]);
+}
+
+static INLINE void highbd_butterfly_cospi16_avx2(const __m256i in0,
+                                                 const __m256i in1,
+                                                 __m256i *const out0,
+                                                 __m256i *const out1) {
+  __m256i temp1[2], temp2;
+
+  temp2 = _mm256_add_epi32(in0, in1);
+  extend_64bit_avx2(temp2, temp1);
+  *out0 = multiplication_round_shift_avx2(temp1, cospi_16_64);
+  temp2 = _mm256_sub_epi32(in0, in1);
+  extend_64bit_avx2(temp2, temp1);
+  *out1 = multiplication_round_shift_avx2(temp1, cospi_16_64);
+}
+
+static INLINE void highbd_partial_butterfly_avx2(const __m256i in, const int c0,
+                                                 const int c1,
+                                                 __m256i *const out0,
+                                                 __m256i *const out1) {
+  __m256i temp[2];
+
+  extend_64bit_avx2(in, temp);
+  *out0 = multiplication_round_shift_avx2(temp, c0);
+  *out1 = multiplication_round_shift_avx2(temp, c1);
+}
+
+
+static INLINE void highbd_load_transpose_32bit_8x8_avx2(const tran_low_t *input,
+                                                        const int stride,
+                                                        __m256i *const in) {
+  in[0] = _mm256_loadu_si256((const __m256i *)(input + 0 * stride));
+  in[1] = _mm256_loadu_si256((const __m256i *)(input + 1 * stride));
+  in[2] = _mm256_loadu_si256((const __m256i *)(input + 2 * stride));
+  in[3] = _mm256_loadu_si256((const __m256i *)(input + 3 * stride));
+  in[4] = _mm256_loadu_si256((const __m256i *)(input + 4 * stride));
+  in[5] = _mm256_loadu_si256((const __m256i *)(input + 5 * stride));
+  in[6] = _mm256_loadu_si256((const __m256i *)(input + 6 * stride));
+  in[7] = _mm256_loadu_si256((const __m256i *)(input + 7 * stride));
+  transpose_32bit_8x8_avx2(in, in);
+}
+
+// Round and add 8 32 bit residuals to a row of pixels.
+static INLINE void highbd_write_buffer_8_avx2(uint16_t *const dest,
+                                              const __m256i in, const int bd) {
+  const __m256i final_rounding = _mm256_set1_epi32(1 << 5);
+  const __m128i one = _mm_set1_epi16(1);
+  const __m128i max = _mm_sub_epi16(_mm_slli_epi16(one, bd), one);
+  __m256i out;
+  __m128i d;
+
+  out = _mm256_add_epi32(in, final_rounding);
+  out = _mm256_srai_epi32(out, 6);
+  out = _mm256_packs_epi32(out, out);
+  out = _mm256_permute4x64_epi64(out, 0x08);
+  d = _mm_loadu_si128((const __m128i *)dest);
+  d = _mm_adds_epi16(d, _mm256_castsi256_si128(out));
+  d = _mm_max_epi16(d, _mm_setzero_si128());
+  d = _mm_min_epi16(d, max);
+  _mm_storeu_si128((__m128i *)dest, d);
+}
+
+// Round and add 16 16 bit residuals to a row of pixels.
+static INLINE void highbd_write_buffer_16_avx2(uint16_t *const dest,
+                                               const __m256i in, const int bd) {
+  const __m256i final_rounding = _mm256_set1_epi16(1 << 5);
+  const __m256i one = _mm256_set1_epi16(1);
+  const __m256i max = _mm256_sub_epi16(_mm256_slli_epi16(one, bd), one);
+  __m256i out, d;
+
+  out = _mm256_adds_epi16(in, final_rounding);
+  out = _mm256_srai_epi16(out, 6);
+  d = _mm256_loadu_si256((const __m256i *)dest);
+  d = _mm256_adds_epi16(d, out);
+  d = _mm256_max_epi16(d, _mm256_setzero_si256());
+  d = _mm256_min_epi16(d, max);
+  _mm256_storeu_si256((__m256i *)dest, d);
+}
+
+void vpx_highbd_idct16_8col_avx2(__m256i *const io /*io[16]*/);
+
+#endif  // VPX_VPX_DSP_X86_HIGHBD_INV_TXFM_AVX2_H_
@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_dsp/vpx_dsp_common.h"
+#include "vpx_dsp/x86/quantize_avx2.h"
+
+// Quantize 8 coefficients. |log_scale| is 1 for 32x32 blocks, in which case
+// zbin and round have already been halved.
+static INLINE void quantize_b_8(const tran_low_t *coeff_ptr,
+                                const int16_t *iscan_ptr,
+                                tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr,
+                                const __m256i *qp, int log_scale,
+                                __m256i *eob_max) {
+  const __m256i coeff = _mm256_loadu_si256((const __m256i *)coeff_ptr);
+  const __m256i abs_coeff = _mm256_abs_epi32(coeff);
+  const __m256i below_zbin = _mm256_cmpgt_epi32(qp[0], abs_coeff);
+
+  if (_mm256_movemask_epi8(below_zbin) == -1) {
+    const __m256i zero = _mm256_setzero_si256();
+    _mm256_storeu_si256((__m256i *)qcoeff_ptr, zero);
+    _mm256_storeu_si256((__m256i *)dqcoeff_ptr, zero);
+  } else {
+    const __m256i tmp1 = _mm256_add_epi32(abs_coeff, qp[1]);
+    const __m256i tmp2 =
+        _mm256_add_epi32(highbd_mul_shift_avx2(tmp1, qp[2], 16), tmp1);
+    const __m256i abs_qcoeff = _mm256_andnot_si256(
+        below_zbin, highbd_mul_shift_avx2(tmp2, qp[3], 16 - log_scale));
+    const __m256i qcoeff = highbd_invert_sign_avx2(abs_qcoeff, coeff);
+    __m256i dqcoeff = _mm256_mullo_epi32(qcoeff, qp[4]);
+    if (log_scale) dqcoeff = highbd_half_avx2(dqcoeff);
+    _mm256_storeu_si256((__m256i *)qcoeff_ptr, qcoeff);
+    _mm256_storeu_si256((__m256i *)dqcoeff_ptr, dqcoeff);
+    *eob_max = _mm256_max_epi32(*eob_max,
+                                highbd_scan_eob_avx2(abs_qcoeff, iscan_ptr));
+  }
+}
+
+static INLINE void quantize_b(const tran_low_t *coeff_ptr, intptr_t n_coeffs,
+                              const int16_t *zbin_ptr, const int16_t *round_ptr,
+                              const int16_t *quant_ptr,
+                              const int16_t *quant_shift_ptr,
+                              tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr,
+                              const int16_t *dequant_ptr, uint16_t *eob_ptr,
+                              const int16_t *iscan, int log_scale) {
+  // zbin, round, quant, quant_shift, dequant.
+  __m256i qp[5];
+  __m256i eob_max = _mm256_setzero_si256();
+  intptr_t i;
+
+  qp[0] = highbd_load_qp_avx2(zbin_ptr);
+  qp[1] = highbd_load_qp_avx2(round_ptr);
+  qp[2] = highbd_load_qp_avx2(quant_ptr);
+  qp[3] = highbd_load_qp_avx2(quant_shift_ptr);
+  qp[4] = highbd_load_qp_avx2(dequant_ptr);
+  if (log_scale) {
+    const __m256i one = _mm256_set1_epi32(1);
+    qp[0] = _mm256_srai_epi32(_mm256_add_epi32(qp[0], one), 1);
+    qp[1] = _mm256_srai_epi32(_mm256_add_epi32(qp[1], one), 1);
+  }
+
+  quantize_b_8(coeff_ptr, iscan, qcoeff_ptr, dqcoeff_ptr, qp, log_scale,
+               &eob_max);
+
+  for (i = 0; i < 5; ++i) qp[i] = highbd_ac_qp_avx2(qp[i]);
+
+  for (i = 8; i < n_coeffs; i += 8) {
+    quantize_b_8(coeff_ptr + i, iscan + i, qcoeff_ptr + i, dqcoeff_ptr + i, qp,
+                 log_scale, &eob_max);
+  }
+
+  *eob_ptr = highbd_get_max_eob_avx2(eob_max);
+}
+
+void vpx_highbd_quantize_b_avx2(const tran_low_t *coeff_ptr, intptr_t n_coeffs,
+                                int skip_block, const int16_t *zbin_ptr,
+                                const int16_t *round_ptr,
+                                const int16_t *quant_ptr,
+                                const int16_t *quant_shift_ptr,
+                                tran_low_t *qcoeff_ptr, tran_low_t *dqcoeff_ptr,
+                                const int16_t *dequant_ptr, uint16_t *eob_ptr,
+                                const int16_t *scan, const int16_t *iscan) {
+  (void)scan;
+  (void)skip_block;
+  assert(!skip_block);
+
+  quantize_b(coeff_ptr, n_coeffs, zbin_ptr, round_ptr, quant_ptr,
+             quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr, dequant_ptr, eob_ptr,
+             iscan, 0);
+}
+
+void vpx_highbd_quantize_b_32x32_avx2(
+    const tran_low_t *coeff_ptr, intptr_t n_coeffs, int skip_block,
+    const int16_t *zbin_ptr, const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *quant_shift_ptr, tran_low_t *qcoeff_ptr,
+    tran_low_t *dqcoeff_ptr, const int16_t *dequant_ptr, uint16_t *eob_ptr,
+    const int16_t *scan, const int16_t *iscan) {
+  (void)scan;
+  (void)skip_block;
+  assert(!skip_block);
+
+  quantize_b(coeff_ptr, n_coeffs, zbin_ptr, round_ptr, quant_ptr,
+             quant_shift_ptr, qcoeff_ptr, dqcoeff_ptr, dequant_ptr, eob_ptr,
+             iscan, 1);
+}
@@ -0,0 +1,330 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VPX_DSP_X86_INV_TXFM_AVX2_H_
+#define VPX_VPX_DSP_X86_INV_TXFM_AVX2_H_
+
+#include <immintrin.h>  // AVX2
+
+#include "./vpx_config.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_dsp/inv_txfm.h"
+#include "vpx_dsp/x86/transpose_avx2.h"
+
+// The AVX2 inverse transforms process 16 rows or columns at a time, one per
+// 16 bit lane, with the same arithmetic as the SSE2 versions.
+
+#define pair256_set_epi16(a, b)                                            \
+  _mm256_set_epi16((int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a), \
+                   (int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a), \
+                   (int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a), \
+                   (int16_t)(b), (int16_t)(a), (int16_t)(b), (int16_t)(a))
+
+static INLINE __m256i dct_const_round_shift_avx2(const __m256i in) {
+  const __m256i t =
+      _mm256_add_epi32(in, _mm256_set1_epi32(DCT_CONST_ROUNDING));
+  return _mm256_srai_epi32(t, DCT_CONST_BITS);
+}
+
+static INLINE __m256i idct_madd_round_shift_avx2(const __m256i in,
+                                                 const __m256i cospi) {
+  const __m256i t = _mm256_madd_epi16(in, cospi);
+  return dct_const_round_shift_avx2(t);
+}
+
+// Calculate the dot product between in0/1 and x and wrap to short.
+static INLINE __m256i idct_calc_wraplow_avx2(const __m256i in0,
+                                             const __m256i in1,
+                                             const __m256i x) {
+  const __m256i t0 = idct_madd_round_shift_avx2(in0, x);
+  const __m256i t1 = idct_madd_round_shift_avx2(in1, x);
+  return _mm256_packs_epi32(t0, t1);
+}
+
+// Multiply elements by constants and add them together.
+static INLINE void butterfly_avx2(const __m256i in0, const __m256i in1,
+                                  const int c0, const int c1,
+                                  __m256i *const out0, __m256i *const out1) {
+  const __m256i cst0 = pair256_set_epi16(c0, -c1);
+  const __m256i cst1 = pair256_set_epi16(c1, c0);
+  const __m256i lo = _mm256_unpacklo_epi16(in0, in1);
+  const __m256i hi = _mm256_unpackhi_epi16(in0, in1);
+  *out0 = idct_calc_wraplow_avx2(lo, hi, cst0);
+  *out1 = idct_calc_wraplow_avx2(lo, hi, cst1);
+}
+
+// butterfly_avx2() with a zero second input. _mm256_mulhrs_epi16() by 2 * c
+// rounds exactly like dct_const_round_shift().
+static INLINE void partial_butterfly_avx2(const __m256i in, const int c0,
+                                          const int c1, __m256i *const out0,
+                                          __m256i *const out1) {
+  const __m256i cst0 = _mm256_set1_epi16(2 * c0);
+  const __m256i cst1 = _mm256_set1_epi16(2 * c1);
+  *out0 = _mm256_mulhrs_epi16(in, cst0);
+  *out1 = _mm256_mulhrs_epi16(in, cst1);
+}
+
+static INLINE __m256i partial_butterfly_cospi16_avx2(const __m256i in) {
+  const __m256i coef_pair = _mm256_set1_epi16(2 * cospi_16_64);
+  return _mm256_mulhrs_epi16(in, coef_pair);
+}
+
+// Only do addition and subtraction butterfly, size = 16, 32
+static INLINE void add_sub_butterfly_avx2(const __m256i *in, __m256i *out,
+                                          int size) {
+  int i = 0;
+  const int num = size >> 1;
+  const int bound = size - 1;
+  while (i < num) {
+    out[i] = _mm256_add_epi16(in[i], in[bound - i]);
+    out[bound - i] = _mm256_sub_epi16(in[i], in[bound - i]);
+    i++;
+  }
+}
+
+// Load 16 coefficients, packing them to 16 bits when tran_low_t is 32 bits.
+static INLINE __m256i load_input_data16_avx2(const tran_low_t *data) {
+#if CONFIG_VP9_HIGHBITDEPTH
+  const __m256i in0 = _mm256_loadu_si256((const __m256i *)(data + 0));
+  const __m256i in1 = _mm256_loadu_si256((const __m256i *)(data + 8));
+  // _mm256_packs_epi32() interleaves the 128 bit lanes of its inputs.
+  return _mm256_permute4x64_epi64(_mm256_packs_epi32(in0, in1), 0xd8);
+#else
+  return _mm256_loadu_si256((const __m256i *)data);
+#endif
+}
+
+// Load the first num rows of a 16 column block and transpose them. The
+// remaining rows are zero.
+static INLINE void load_transpose_16bit_16x16_avx2(const tran_low_t *input,
+                                                   const int stride,
+                                                   const int num,
+                                                   __m256i *const in) {
+  int i;
+  for (i = 0; i < num; ++i) {
+    in[i] = load_input_data16_avx2(input + i * stride);
+  }
+  for (; i < 16; ++i) {
+    in[i] = _mm256_setzero_si256();
+  }
+  transpose_16bit_16x16_avx2(in, in);
+}
+
+static INLINE void recon_and_store_16_avx2(uint8_t *const dest,
+                                           const __m256i in_x) {
+  const __m128i d0 = _mm_loadu_si128((const __m128i *)dest);
+  __m256i d = _mm256_cvtepu8_epi16(d0);
+  d = _mm256_add_epi16(in_x, d);
+  d = _mm256_packus_epi16(d, d);
+  d = _mm256_permute4x64_epi64(d, 0x08);
+  _mm_storeu_si128((__m128i *)dest, _mm256_castsi256_si128(d));
+}
+
+static INLINE void write_buffer_16x1_avx2(uint8_t *const dest,
+                                          const __m256i in) {
+  const __m256i final_rounding = _mm256_set1_epi16(1 << 5);
+  __m256i out;
+  out = _mm256_adds_epi16(in, final_rounding);
+  out = _mm256_srai_epi16(out, 6);
+  recon_and_store_16_avx2(dest, out);
+}
+
+static INLINE void idct16_16col_stage5_to_7(__m256i *const step1,
+                                            __m256i *const step2,
+                                            __m256i *const out) {
+  // stage 5
+  step1[0] = _mm256_add_epi16(step2[0], step2[3]);
+  step1[1] = _mm256_add_epi16(step2[1], step2[2]);
+  step1[2] = _mm256_sub_epi16(step2[1], step2[2]);
+  step1[3] = _mm256_sub_epi16(step2[0], step2[3]);
+  butterfly_avx2(step2[6], step2[5], cospi_16_64, cospi_16_64, &step1[5],
+                 &step1[6]);
+  step1[8] = _mm256_add_epi16(step2[8], step2[11]);
+  step1[9] = _mm256_add_epi16(step2[9], step2[10]);
+  step1[10] = _mm256_sub_epi16(step2[9], step2[10]);
+  step1[11] = _mm256_sub_epi16(step2[8], step2[11]);
+  step1[12] = _mm256_sub_epi16(step2[15], step2[12]);
+  step1[13] = _mm256_sub_epi16(step2[14], step2[13]);
+  step1[14] = _mm256_add_epi16(step2[14], step2[13]);
+  step1[15] = _mm256_add_epi16(step2[15], step2[12]);
+
+  // stage 6
+  step2[0] = _mm256_add_epi16(step1[0], step1[7]);
+  step2[1] = _mm256_add_epi16(step1[1], step1[6]);
+  step2[2] = _mm256_add_epi16(step1[2], step1[5]);
+  step2[3] = _mm256_add_epi16(step1[3], step1[4]);
+  step2[4] = _mm256_sub_epi16(step1[3], step1[4]);
+  step2[5] = _mm256_sub_epi16(step1[2], step1[5]);
+  step2[6] = _mm256_sub_epi16(step1[1], step1[6]);
+  step2[7] = _mm256_sub_epi16(step1[0], step1[7]);
+  butterfly_avx2(step1[13], step1[10], cospi_16_64, cospi_16_64, &step2[10],
+                 &step2[13]);
+  butterfly_avx2(step1[12], step1[11], cospi_16_64, cospi_16_64, &step2[11],
+                 &step2[12]);
+
+  // stage 7
+  out[0] = _mm256_add_epi16(step2[0], step1[15]);
+  out[1] = _mm256_add_epi16(step2[1], step1[14]);
+  out[2] = _mm256_add_epi16(step2[2], step2[13]);
+  out[3] = _mm256_add_epi16(step2[3], step2[12]);
+  out[4] = _mm256_add_epi16(step2[4], step2[11]);
+  out[5] = _mm256_add_epi16(step2[5], step2[10]);
+  out[6] = _mm256_add_epi16(step2[6], step1[9]);
+  out[7] = _mm256_add_epi16(step2[7], step1[8]);
+  out[8] = _mm256_sub_epi16(step2[7], step1[8]);
+  out[9] = _mm256_sub_epi16(step2[6], step1[9]);
+  out[10] = _mm256_sub_epi16(step2[5], step2[10]);
+  out[11] = _mm256_sub_epi16(step2[4], step2[11]);
+  out[12] = _mm256_sub_epi16(step2[3], step2[12]);
+  out[13] = _mm256_sub_epi16(step2[2], step2[13]);
+  out[14] = _mm256_sub_epi16(step2[1], step1[14]);
+  out[15] = _mm256_sub_epi16(step2[0], step1[15]);
+}
+
+static INLINE void idct16_16col_avx2(const __m256i *const in /*in[16]*/,
+                                     __m256i *const out /*out[16]*/) {
+  __m256i step1[16], step2[16];
+
+  // stage 2
+  butterfly_avx2(in[1], in[15], cospi_30_64, cospi_2_64, &step2[8], &step2[15]);
+  butterfly_avx2(in[9], in[7], cospi_14_64, cospi_18_64, &step2[9], &step2[14]);
+  butterfly_avx2(in[5], in[11], cospi_22_64, cospi_10_64, &step2[10],
+                 &step2[13]);
+  butterfly_avx2(in[13], in[3], cospi_6_64, cospi_26_64, &step2[11],
+                 &step2[12]);
+
+  // stage 3
+  butterfly_avx2(in[2], in[14], cospi_28_64, cospi_4_64, &step1[4], &step1[7]);
+  butterfly_avx2(in[10], in[6], cospi_12_64, cospi_20_64, &step1[5], &step1[6]);
+  step1[8] = _mm256_add_epi16(step2[8], step2[9]);
+  step1[9] = _mm256_sub_epi16(step2[8], step2[9]);
+  step1[10] = _mm256_sub_epi16(step2[11], step2[10]);
+  step1[11] = _mm256_add_epi16(step2[10], step2[11]);
+  step1[12] = _mm256_add_epi16(step2[12], step2[13]);
+  step1[13] = _mm256_sub_epi16(step2[12], step2[13]);
+  step1[14] = _mm256_sub_epi16(step2[15], step2[14]);
+  step1[15] = _mm256_add_epi16(step2[14], step2[15]);
+
+  // stage 4
+  butterfly_avx2(in[0], in[8], cospi_16_64, cospi_16_64, &step2[1], &step2[0]);
+  butterfly_avx2(in[4], in[12], cospi_24_64, cospi_8_64, &step2[2], &step2[3]);
+  butterfly_avx2(step1[14], step1[9], cospi_24_64, cospi_8_64, &step2[9],
+                 &step2[14]);
+  butterfly_avx2(step1[10], step1[13], -cospi_8_64, -cospi_24_64, &step2[13],
+                 &step2[10]);
+  step2[5] = _mm256_sub_epi16(step1[4], step1[5]);
+  step1[4] = _mm256_add_epi16(step1[4], step1[5]);
+  step2[6] = _mm256_sub_epi16(step1[7], step1[6]);
+  step1[7] = _mm256_add_epi16(step1[6], step1[7]);
+  step2[8] = step1[8];
+  step2[11] = step1[11];
+  step2[12] = step1[12];
+  step2[15] = step1[15];
+
+  idct16_16col_stage5_to_7(step1, step2, out);
+}
+
+// Only in[0..7] are non-zero.
+static INLINE void idct16_38_16col_avx2(const __m256i *const in /*in[16]*/,
+                                        __m256i *const out /*out[16]*/) {
+  __m256i step1[16], step2[16];
+
+  // stage 2
+  partial_butterfly_avx2(in[1], cospi_30_64, cospi_2_64, &step2[8],
+                         &step2[15]);
+  partial_butterfly_avx2(in[7], -cospi_18_64, cospi_14_64, &step2[9],
+                         &step2[14]);
+  partial_butterfly_avx2(in[5], cospi_22_64, cospi_10_64, &step2[10],
+                         &step2[13]);
+  partial_butterfly_avx2(in[3], -cospi_26_64, cospi_6_64, &step2[11],
+                         &step2[12]);
+
+  // stage 3
+  partial_butterfly_avx2(in[2], cospi_28_64, cospi_4_64, &step1[4], &step1[7]);
+  partial_butterfly_avx2(in[6], -cospi_20_64, cospi_12_64, &step1[5],
+                         &step1[6]);
+  step1[8] = _mm256_add_epi16(step2[8], step2[9]);
+  step1[9] = _mm256_sub_epi16(step2[8], step2[9]);
+  step1[10] = _mm256_sub_epi16(step2[11], step2[10]);
+  step1[11] = _mm256_add_epi16(step2[10], step2[11]);
+  step1[12] = _mm256_add_epi16(step2[12], step2[13]);
+  step1[13] = _mm256_sub_epi16(step2[12], step2[13]);
+  step1[14] = _mm256_sub_epi16(step2[15], step2[14]);
+  step1[15] = _mm256_add_epi16(step2[14], step2[15]);
+
+  // stage 4
+  step2[0] = partial_butterfly_cospi16_avx2(in[0]);
+  step2[1] = step2[0];
+  partial_butterfly_avx2(in[4], cospi_24_64, cospi_8_64, &step2[2], &step2[3]);
+  butterfly_avx2(step1[14], step1[9], cospi_24_64, cospi_8_64, &step2[9],
+                 &step2[14]);
+  butterfly_avx2(step1[10], step1[13], -cospi_8_64, -cospi_24_64, &step2[13],
+                 &step2[10]);
+  step2[5] = _mm256_sub_epi16(step1[4], step1[5]);
+  step1[4] = _mm256_add_epi16(step1[4], step1[5]);
+  step2[6] = _mm256_sub_epi16(step1[7], step1[6]);
+  step1[7] = _mm256_add_epi16(step1[6], step1[7]);
+  step2[8] = step1[8];
+  step2[11] = step1[11];
+  step2[12] = step1[12];
+  step2[15] = step1[15];
+
+  idct16_16col_stage5_to_7(step1, step2, out);
+}
+
+// Only in[0..3] are non-zero.
+static INLINE void idct16_10_16col_avx2(const __m256i *const in /*in[16]*/,
+                                        __m256i *const out /*out[16]*/) {
+  __m256i step1[16], step2[16];
+
+  // stage 2
+  partial_butterfly_avx2(in[1], cospi_30_64, cospi_2_64, &step2[8],
+                         &step2[15]);
+  partial_butterfly_avx2(in[3], -cospi_26_64, cospi_6_64, &step2[11],
+                         &step2[12]);
+
+  // stage 3
+  partial_butterfly_avx2(in[2], cospi_28_64, cospi_4_64, &step1[4], &step1[7]);
+  step1[8] = step2[8];
+  step1[9] = step2[8];
+  step1[10] = step2[11];
+  step1[11] = step2[11];
+  step1[12] = step2[12];
+  step1[13] = step2[12];
+  step1[14] = step2[15];
+  step1[15] = step2[15];
+
+  // stage 4
+  step2[0] = partial_butterfly_cospi16_avx2(in[0]);
+  step2[1] = step2[0];
+  step2[2] = _mm256_setzero_si256();
+  step2[3] = _mm256_setzero_si256();
+  butterfly_avx2(step1[14], step1[9], cospi_24_64, cospi_8_64, &step2[9],
+                 &step2[14]);
+  butterfly_avx2(step1[10], step1[13], -cospi_8_64, -cospi_24_64, &step2[13],
+                 &step2[10]);
+  step2[5] = step1[4];
+  step2[6] = step1[7];
+  step2[8] = step1[8];
+  step2[11] = step1[11];
+  step2[12] = step1[12];
+  step2[15] = step1[15];
+
+  idct16_16col_stage5_to_7(step1, step2, out);
+}
+
+void idct16_avx2(__m256i *const in);
+void iadst16_16col_avx2(__m256i *const in);
+void iadst16_avx2(__m256i *const in);
+void idct32_1024_16x32_avx2(const __m256i *const in, __m256i *const out);
+void idct32_135_16x32_avx2(const __m256i *const in, __m256i *const out);
+void idct32_34_16x32_avx2(const __m256i *const in, __m256i *const out);
+
+#endif  // VPX_VPX_DSP_X86_INV_TXFM_AVX2_H_
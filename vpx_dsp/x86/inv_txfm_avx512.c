@@ -0,0 +1,771 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX512
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_dsp/inv_txfm.h"
+
+// The 32x32 inverse transforms hold a whole row or column of 32 coefficients
+// in each register, so each pass is a single 1-D transform of the block. The
+// arithmetic matches the SSE2 and AVX2 versions.
+
+static INLINE __m512i pair512_set_epi16(int a, int b) {
+  return _mm512_set1_epi32((int)(((uint16_t)a) | (((uint32_t)b) << 16)));
+}
+
+static INLINE __m512i dct_const_round_shift_avx512(const __m512i in) {
+  const __m512i t =
+      _mm512_add_epi32(in, _mm512_set1_epi32(DCT_CONST_ROUNDING));
+  return _mm512_srai_epi32(t, DCT_CONST_BITS);
+}
+
+// Calculate the dot product between in0/1 and x and wrap to short.
+static INLINE __m512i idct_calc_wraplow_avx512(const __m512i in0,
+                                               const __m512i in1,
+                                               const __m512i x) {
+  const __m512i t0 = dct_const_round_shift_avx512(_mm512_madd_epi16(in0, x));
+  const __m512i t1 = dct_const_round_shift_avx512(_mm512_madd_epi16(in1, x));
+  return _mm512_packs_epi32(t0, t1);
+}
+
+// Multiply elements by constants and add them together.
+static INLINE void butterfly_avx512(const __m512i in0, const __m512i in1,
+                                    const int c0, const int c1,
+                                    __m512i *const out0,
+                                    __m512i *const out1) {
+  const __m512i cst0 = pair512_set_epi16(c0, -c1);
+  const __m512i cst1 = pair512_set_epi16(c1, c0);
+  const __m512i lo = _mm512_unpacklo_epi16(in0, in1);
+  const __m512i hi = _mm512_unpackhi_epi16(in0, in1);
+  *out0 = idct_calc_wraplow_avx512(lo, hi, cst0);
+  *out1 = idct_calc_wraplow_avx512(lo, hi, cst1);
+}
+
+static INLINE void partial_butterfly_avx512(const __m512i in, const int c0,
+                                            const int c1, __m512i *const out0,
+                                            __m512i *const out1) {
+  const __m512i cst0 = _mm512_set1_epi16(2 * c0);
+  const __m512i cst1 = _mm512_set1_epi16(2 * c1);
+  *out0 = _mm512_mulhrs_epi16(in, cst0);
+  *out1 = _mm512_mulhrs_epi16(in, cst1);
+}
+
+static INLINE __m512i partial_butterfly_cospi16_avx512(const __m512i in) {
+  const __m512i coef_pair = _mm512_set1_epi16(2 * cospi_16_64);
+  return _mm512_mulhrs_epi16(in, coef_pair);
+}
+
+// Only do addition and subtraction butterfly, size = 16, 32
+static INLINE void add_sub_butterfly_avx512(const __m512i *in, __m512i *out,
+                                            int size) {
+  int i = 0;
+  const int num = size >> 1;
+  const int bound = size - 1;
+  while (i < num) {
+    out[i] = _mm512_add_epi16(in[i], in[bound - i]);
+    out[bound - i] = _mm512_sub_epi16(in[i], in[bound - i]);
+    i++;
+  }
+}
+
+// Transpose the 8x8 16 bit blocks held in each 128 bit lane of in[0..7].
+static INLINE void transpose_16bit_8x8x4_avx512(const __m512i *const in,
+                                                __m512i *const out) {
+  const __m512i a0 = _mm512_unpacklo_epi16(in[0], in[1]);
+  const __m512i a1 = _mm512_unpacklo_epi16(in[2], in[3]);
+  const __m512i a2 = _mm512_unpacklo_epi16(in[4], in[5]);
+  const __m512i a3 = _mm512_unpacklo_epi16(in[6], in[7]);
+  const __m512i a4 = _mm512_unpackhi_epi16(in[0], in[1]);
+  const __m512i a5 = _mm512_unpackhi_epi16(in[2], in[3]);
+  const __m512i a6 = _mm512_unpackhi_epi16(in[4], in[5]);
+  const __m512i a7 = _mm512_unpackhi_epi16(in[6], in[7]);
+
+  const __m512i b0 = _mm512_unpacklo_epi32(a0, a1);
+  const __m512i b1 = _mm512_unpacklo_epi32(a2, a3);
+  const __m512i b2 = _mm512_unpacklo_epi32(a4, a5);
+  const __m512i b3 = _mm512_unpacklo_epi32(a6, a7);
+  const __m512i b4 = _mm512_unpackhi_epi32(a0, a1);
+  const __m512i b5 = _mm512_unpackhi_epi32(a2, a3);
+  const __m512i b6 = _mm512_unpackhi_epi32(a4, a5);
+  const __m512i b7 = _mm512_unpackhi_epi32(a6, a7);
+
+  out[0] = _mm512_unpacklo_epi64(b0, b1);
+  out[1] = _mm512_unpackhi_epi64(b0, b1);
+  out[2] = _mm512_unpacklo_epi64(b4, b5);
+  out[3] = _mm512_unpackhi_epi64(b4, b5);
+  out[4] = _mm512_unpacklo_epi64(b2, b3);
+  out[5] = _mm512_unpackhi_epi64(b2, b3);
+  out[6] = _mm512_unpacklo_epi64(b6, b7);
+  out[7] = _mm512_unpackhi_epi64(b6, b7);
+}
+
+// Transpose a 32x32 block of 16 bit elements, one row per register. in and out
+// may alias.
+static INLINE void transpose_16bit_32x32_avx512(const __m512i *const in,
+                                                __m512i *const out) {
+  // blk[k][i]: 128 bit lane j holds row 8 * j + i, cols 8 * k to 8 * k + 7.
+  __m512i blk[4][8];
+  int i;
+
+  for (i = 0; i < 8; ++i) {
+    const __m512i s0 = _mm512_shuffle_i64x2(in[i], in[i + 8], 0x44);
+    const __m512i s1 = _mm512_shuffle_i64x2(in[i], in[i + 8], 0xee);
+    const __m512i s2 = _mm512_shuffle_i64x2(in[i + 16], in[i + 24], 0x44);
+    const __m512i s3 = _mm512_shuffle_i64x2(in[i + 16], in[i + 24], 0xee);
+    blk[0][i] = _mm512_shuffle_i64x2(s0, s2, 0x88);
+    blk[1][i] = _mm512_shuffle_i64x2(s0, s2, 0xdd);
+    blk[2][i] = _mm512_shuffle_i64x2(s1, s3, 0x88);
+    blk[3][i] = _mm512_shuffle_i64x2(s1, s3, 0xdd);
+  }
+
+  transpose_16bit_8x8x4_avx512(blk[0], out + 0);
+  transpose_16bit_8x8x4_avx512(blk[1], out + 8);
+  transpose_16bit_8x8x4_avx512(blk[2], out + 16);
+  transpose_16bit_8x8x4_avx512(blk[3], out + 24);
+}
+
+// Load 32 coefficients, packing them to 16 bits when tran_low_t is 32 bits.
+static INLINE __m512i load_input_data32_avx512(const tran_low_t *data) {
+#if CONFIG_VP9_HIGHBITDEPTH
+  const __m512i in0 = _mm512_loadu_si512((const __m512i *)(data + 0));
+  const __m512i in1 = _mm512_loadu_si512((const __m512i *)(data + 16));
+  // _mm512_packs_epi32() interleaves the 128 bit lanes of its inputs.
+  const __m512i idx = _mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7);
+  return _mm512_permutexvar_epi64(idx, _mm512_packs_epi32(in0, in1));
+#else
+  return _mm512_loadu_si512((const __m512i *)data);
+#endif
+}
+
+// Load the first num rows of the block and transpose them. The remaining rows
+// are zero.
+static INLINE void load_transpose_16bit_32x32_avx512(const tran_low_t *input,
+                                                     const int num,
+                                                     __m512i *const in) {
+  int i;
+  for (i = 0; i < num; ++i) {
+    in[i] = load_input_data32_avx512(input + i * 32);
+  }
+  for (; i < 32; ++i) {
+    in[i] = _mm512_setzero_si512();
+  }
+  transpose_16bit_32x32_avx512(in, in);
+}
+
+static INLINE void write_buffer_32x32_avx512(const __m512i *const in,
+                                             uint8_t *dest, const int stride) {
+  const __m512i final_rounding = _mm512_set1_epi16(1 << 5);
+  const __m512i zero = _mm512_setzero_si512();
+  int j;
+
+  for (j = 0; j < 32; ++j) {
+    const __m256i d0 = _mm256_loadu_si256((const __m256i *)dest);
+    __m512i out, d;
+    out = _mm512_adds_epi16(in[j], final_rounding);
+    out = _mm512_srai_epi16(out, 6);
+    d = _mm512_add_epi16(out, _mm512_cvtepu8_epi16(d0));
+    d = _mm512_max_epi16(d, zero);
+    _mm256_storeu_si256((__m256i *)dest, _mm512_cvtusepi16_epi8(d));
+    dest += stride;
+  }
+}
+
+// Group the coefficient calculation into smaller functions to prevent stack
+// spillover in 32x32 idct optimizations:
+// quarter_1: 0-7
+// quarter_2: 8-15
+// quarter_3_4: 16-23, 24-31
+
+static INLINE void idct32_32x32_quarter_2_stage_4_to_6(
+    __m512i *const step1 /*step1[16]*/, __m512i *const out /*out[16]*/) {
+  __m512i step2[32];
+
+  // stage 4
+  step2[8] = step1[8];
+  step2[15] = step1[15];
+  butterfly_avx512(step1[14], step1[9], cospi_24_64, cospi_8_64, &step2[9],
+                   &step2[14]);
+  butterfly_avx512(step1[13], step1[10], -cospi_8_64, cospi_24_64, &step2[10],
+                   &step2[13]);
+  step2[11] = step1[11];
+  step2[12] = step1[12];
+
+  // stage 5
+  step1[8] = _mm512_add_epi16(step2[8], step2[11]);
+  step1[9] = _mm512_add_epi16(step2[9], step2[10]);
+  step1[10] = _mm512_sub_epi16(step2[9], step2[10]);
+  step1[11] = _mm512_sub_epi16(step2[8], step2[11]);
+  step1[12] = _mm512_sub_epi16(step2[15], step2[12]);
+  step1[13] = _mm512_sub_epi16(step2[14], step2[13]);
+  step1[14] = _mm512_add_epi16(step2[14], step2[13]);
+  step1[15] = _mm512_add_epi16(step2[15], step2[12]);
+
+  // stage 6
+  out[8] = step1[8];
+  out[9] = step1[9];
+  butterfly_avx512(step1[13], step1[10], cospi_16_64, cospi_16_64, &out[10],
+                   &out[13]);
+  butterfly_avx512(step1[12], step1[11], cospi_16_64, cospi_16_64, &out[11],
+                   &out[12]);
+  out[14] = step1[14];
+  out[15] = step1[15];
+}
+
+static INLINE void idct32_32x32_quarter_3_4_stage_4_to_7(
+    __m512i *const step1 /*step1[32]*/, __m512i *const out /*out[32]*/) {
+  __m512i step2[32];
+
+  // stage 4
+  step2[16] = _mm512_add_epi16(step1[16], step1[19]);
+  step2[17] = _mm512_add_epi16(step1[17], step1[18]);
+  step2[18] = _mm512_sub_epi16(step1[17], step1[18]);
+  step2[19] = _mm512_sub_epi16(step1[16], step1[19]);
+  step2[20] = _mm512_sub_epi16(step1[23], step1[20]);
+  step2[21] = _mm512_sub_epi16(step1[22], step1[21]);
+  step2[22] = _mm512_add_epi16(step1[22], step1[21]);
+  step2[23] = _mm512_add_epi16(step1[23], step1[20]);
+
+  step2[24] = _mm512_add_epi16(step1[24], step1[27]);
+  step2[25] = _mm512_add_epi16(step1[25], step1[26]);
+  step2[26] = _mm512_sub_epi16(step1[25], step1[26]);
+  step2[27] = _mm512_sub_epi16(step1[24], step1[27]);
+  step2[28] = _mm512_sub_epi16(step1[31], step1[28]);
+  step2[29] = _mm512_sub_epi16(step1[30], step1[29]);
+  step2[30] = _mm512_add_epi16(step1[29], step1[30]);
+  step2[31] = _mm512_add_epi16(step1[28], step1[31]);
+
+  // stage 5
+  step1[16] = step2[16];
+  step1[17] = step2[17];
+  butterfly_avx512(step2[29], step2[18], cospi_24_64, cospi_8_64, &step1[18],
+                   &step1[29]);
+  butterfly_avx512(step2[28], step2[19], cospi_24_64, cospi_8_64, &step1[19],
+                   &step1[28]);
+  butterfly_avx512(step2[27], step2[20], -cospi_8_64, cospi_24_64, &step1[20],
+                   &step1[27]);
+  butterfly_avx512(step2[26], step2[21], -cospi_8_64, cospi_24_64, &step1[21],
+                   &step1[26]);
+  step1[22] = step2[22];
+  step1[23] = step2[23];
+  step1[24] = step2[24];
+  step1[25] = step2[25];
+  step1[30] = step2[30];
+  step1[31] = step2[31];
+
+  // stage 6
+  out[16] = _mm512_add_epi16(step1[16], step1[23]);
+  out[17] = _mm512_add_epi16(step1[17], step1[22]);
+  out[18] = _mm512_add_epi16(step1[18], step1[21]);
+  out[19] = _mm512_add_epi16(step1[19], step1[20]);
+  step2[20] = _mm512_sub_epi16(step1[19], step1[20]);
+  step2[21] = _mm512_sub_epi16(step1[18], step1[21]);
+  step2[22] = _mm512_sub_epi16(step1[17], step1[22]);
+  step2[23] = _mm512_sub_epi16(step1[16], step1[23]);
+
+  step2[24] = _mm512_sub_epi16(step1[31], step1[24]);
+  step2[25] = _mm512_sub_epi16(step1[30], step1[25]);
+  step2[26] = _mm512_sub_epi16(step1[29], step1[26]);
+  step2[27] = _mm512_sub_epi16(step1[28], step1[27]);
+  out[28] = _mm512_add_epi16(step1[27], step1[28]);
+  out[29] = _mm512_add_epi16(step1[26], step1[29]);
+  out[30] = _mm512_add_epi16(step1[25], step1[30]);
+  out[31] = _mm512_add_epi16(step1[24], step1[31]);
+
+  // stage 7
+  butterfly_avx512(step2[27], step2[20], cospi_16_64, cospi_16_64, &out[20],
+                   &out[27]);
+  butterfly_avx512(step2[26], step2[21], cospi_16_64, cospi_16_64, &out[21],
+                   &out[26]);
+  butterfly_avx512(step2[25], step2[22], cospi_16_64, cospi_16_64, &out[22],
+                   &out[25]);
+  butterfly_avx512(step2[24], step2[23], cospi_16_64, cospi_16_64, &out[23],
+                   &out[24]);
+}
+
+// For each 32x32 block __m512i in[32],
+// Input with index, 0, 4, 8, 12, 16, 20, 24, 28
+// output pixels: 0-7 in __m512i out[32]
+static INLINE void idct32_1024_32x32_quarter_1(
+    const __m512i *const in /*in[32]*/, __m512i *const out /*out[8]*/) {
+  __m512i step1[8], step2[8];
+
+  // stage 3
+  butterfly_avx512(in[4], in[28], cospi_28_64, cospi_4_64, &step1[4],
+                   &step1[7]);
+  butterfly_avx512(in[20], in[12], cospi_12_64, cospi_20_64, &step1[5],
+                   &step1[6]);
+
+  // stage 4
+  butterfly_avx512(in[0], in[16], cospi_16_64, cospi_16_64, &step2[1],
+                   &step2[0]);
+  butterfly_avx512(in[8], in[24], cospi_24_64, cospi_8_64, &step2[2],
+                   &step2[3]);
+  step2[4] = _mm512_add_epi16(step1[4], step1[5]);
+  step2[5] = _mm512_sub_epi16(step1[4], step1[5]);
+  step2[6] = _mm512_sub_epi16(step1[7], step1[6]);
+  step2[7] = _mm512_add_epi16(step1[7], step1[6]);
+
+  // stage 5
+  step1[0] = _mm512_add_epi16(step2[0], step2[3]);
+  step1[1] = _mm512_add_epi16(step2[1], step2[2]);
+  step1[2] = _mm512_sub_epi16(step2[1], step2[2]);
+  step1[3] = _mm512_sub_epi16(step2[0], step2[3]);
+  step1[4] = step2[4];
+  butterfly_avx512(step2[6], step2[5], cospi_16_64, cospi_16_64, &step1[5],
+                   &step1[6]);
+  step1[7] = step2[7];
+
+  // stage 6
+  out[0] = _mm512_add_epi16(step1[0], step1[7]);
+  out[1] = _mm512_add_epi16(step1[1], step1[6]);
+  out[2] = _mm512_add_epi16(step1[2], step1[5]);
+  out[3] = _mm512_add_epi16(step1[3], step1[4]);
+  out[4] = _mm512_sub_epi16(step1[3], step1[4]);
+  out[5] = _mm512_sub_epi16(step1[2], step1[5]);
+  out[6] = _mm512_sub_epi16(step1[1], step1[6]);
+  out[7] = _mm512_sub_epi16(step1[0], step1[7]);
+}
+
+// For each 32x32 block __m512i in[32],
+// Input with index, 2, 6, 10, 14, 18, 22, 26, 30
+// output pixels: 8-15 in __m512i out[32]
+static INLINE void idct32_1024_32x32_quarter_2(
+    const __m512i *const in /*in[32]*/, __m512i *const out /*out[16]*/) {
+  __m512i step1[16], step2[16];
+
+  // stage 2
+  butterfly_avx512(in[2], in[30], cospi_30_64, cospi_2_64, &step2[8],
+                   &step2[15]);
+  butterfly_avx512(in[18], in[14], cospi_14_64, cospi_18_64, &step2[9],
+                   &step2[14]);
+  butterfly_avx512(in[10], in[22], cospi_22_64, cospi_10_64, &step2[10],
+                   &step2[13]);
+  butterfly_avx512(in[26], in[6], cospi_6_64, cospi_26_64, &step2[11],
+                   &step2[12]);
+
+  // stage 3
+  step1[8] = _mm512_add_epi16(step2[8], step2[9]);
+  step1[9] = _mm512_sub_epi16(step2[8], step2[9]);
+  step1[10] = _mm512_sub_epi16(step2[11], step2[10]);
+  step1[11] = _mm512_add_epi16(step2[11], step2[10]);
+  step1[12] = _mm512_add_epi16(step2[12], step2[13]);
+  step1[13] = _mm512_sub_epi16(step2[12], step2[13]);
+  step1[14] = _mm512_sub_epi16(step2[15], step2[14]);
+  step1[15] = _mm512_add_epi16(step2[15], step2[14]);
+
+  idct32_32x32_quarter_2_stage_4_to_6(step1, out);
+}
+
+static INLINE void idct32_1024_32x32_quarter_1_2(
+    const __m512i *const in /*in[32]*/, __m512i *const out /*out[32]*/) {
+  __m512i temp[16];
+  idct32_1024_32x32_quarter_1(in, temp);
+  idct32_1024_32x32_quarter_2(in, temp);
+  // stage 7
+  add_sub_butterfly_avx512(temp, out, 16);
+}
+
+// For each 32x32 block __m512i in[32],
+// Input with odd index,
+// 1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31
+// output pixels: 16-23, 24-31 in __m512i out[32]
+static INLINE void idct32_1024_32x32_quarter_3_4(
+    const __m512i *const in /*in[32]*/, __m512i *const out /*out[32]*/) {
+  __m512i step1[32], step2[32];
+
+  // stage 1
+  butterfly_avx512(in[1], in[31], cospi_31_64, cospi_1_64, &step1[16],
+                   &step1[31]);
+  butterfly_avx512(in[17], in[15], cospi_15_64, cospi_17_64, &step1[17],
+                   &step1[30]);
+  butterfly_avx512(in[9], in[23], cospi_23_64, cospi_9_64, &step1[18],
+                   &step1[29]);
+  butterfly_avx512(in[25], in[7], cospi_7_64, cospi_25_64, &step1[19],
+                   &step1[28]);
+
+  butterfly_avx512(in[5], in[27], cospi_27_64, cospi_5_64, &step1[20],
+                   &step1[27]);
+  butterfly_avx512(in[21], in[11], cospi_11_64, cospi_21_64, &step1[21],
+                   &step1[26]);
+
+  butterfly_avx512(in[13], in[19], cospi_19_64, cospi_13_64, &step1[22],
+                   &step1[25]);
+  butterfly_avx512(in[29], in[3], cospi_3_64, cospi_29_64, &step1[23],
+                   &step1[24]);
+
+  // stage 2
+  step2[16] = _mm512_add_epi16(step1[16], step1[17]);
+  step2[17] = _mm512_sub_epi16(step1[16], step1[17]);
+  step2[18] = _mm512_sub_epi16(step1[19], step1[18]);
+  step2[19] = _mm512_add_epi16(step1[19], step1[18]);
+  step2[20] = _mm512_add_epi16(step1[20], step1[21]);
+  step2[21] = _mm512_sub_epi16(step1[20], step1[21]);
+  step2[22] = _mm512_sub_epi16(step1[23], step1[22]);
+  step2[23] = _mm512_add_epi16(step1[23], step1[22]);
+
+  step2[24] = _mm512_add_epi16(step1[24], step1[25]);
+  step2[25] = _mm512_sub_epi16(step1[24], step1[25]);
+  step2[26] = _mm512_sub_epi16(step1[27], step1[26]);
+  step2[27] = _mm512_add_epi16(step1[27], step1[26]);
+  step2[28] = _mm512_add_epi16(step1[28], step1[29]);
+  step2[29] = _mm512_sub_epi16(step1[28], step1[29]);
+  step2[30] = _mm512_sub_epi16(step1[31], step1[30]);
+  step2[31] = _mm512_add_epi16(step1[31], step1[30]);
+
+  // stage 3
+  step1[16] = step2[16];
+  step1[31] = step2[31];
+  butterfly_avx512(step2[30], step2[17], cospi_28_64, cospi_4_64, &step1[17],
+                   &step1[30]);
+  butterfly_avx512(step2[29], step2[18], -cospi_4_64, cospi_28_64, &step1[18],
+                   &step1[29]);
+  step1[19] = step2[19];
+  step1[20] = step2[20];
+  butterfly_avx512(step2[26], step2[21], cospi_12_64, cospi_20_64, &step1[21],
+                   &step1[26]);
+  butterfly_avx512(step2[25], step2[22], -cospi_20_64, cospi_12_64, &step1[22],
+                   &step1[25]);
+  step1[23] = step2[23];
+  step1[24] = step2[24];
+  step1[27] = step2[27];
+  step1[28] = step2[28];
+
+  idct32_32x32_quarter_3_4_stage_4_to_7(step1, out);
+}
+
+static void idct32_1024_32x32_avx512(const __m512i *const in /*in[32]*/,
+                                     __m512i *const out /*out[32]*/) {
+  __m512i temp[32];
+
+  idct32_1024_32x32_quarter_1_2(in, temp);
+  idct32_1024_32x32_quarter_3_4(in, temp);
+  // final stage
+  add_sub_butterfly_avx512(temp, out, 32);
+}
+
+// For each 32x32 block __m512i in[32],
+// Input with index, 0, 4
+// output pixels: 0-7 in __m512i out[32]
+static INLINE void idct32_34_32x32_quarter_1(const __m512i *const in /*in[32]*/,
+                                             __m512i *const out /*out[8]*/) {
+  __m512i step1[8], step2[8];
+
+  // stage 3
+  partial_butterfly_avx512(in[4], cospi_28_64, cospi_4_64, &step1[4],
+                           &step1[7]);
+
+  // stage 4
+  step2[0] = partial_butterfly_cospi16_avx512(in[0]);
+  step2[4] = step1[4];
+  step2[5] = step1[4];
+  step2[6] = step1[7];
+  step2[7] = step1[7];
+
+  // stage 5
+  step1[0] = step2[0];
+  step1[1] = step2[0];
+  step1[2] = step2[0];
+  step1[3] = step2[0];
+  step1[4] = step2[4];
+  butterfly_avx512(step2[6], step2[5], cospi_16_64, cospi_16_64, &step1[5],
+                   &step1[6]);
+  step1[7] = step2[7];
+
+  // stage 6
+  out[0] = _mm512_add_epi16(step1[0], step1[7]);
+  out[1] = _mm512_add_epi16(step1[1], step1[6]);
+  out[2] = _mm512_add_epi16(step1[2], step1[5]);
+  out[3] = _mm512_add_epi16(step1[3], step1[4]);
+  out[4] = _mm512_sub_epi16(step1[3], step1[4]);
+  out[5] = _mm512_sub_epi16(step1[2], step1[5]);
+  out[6] = _mm512_sub_epi16(step1[1], step1[6]);
+  out[7] = _mm512_sub_epi16(step1[0], step1[7]);
+}
+
+// For each 32x32 block __m512i in[32],
+// Input with index, 2, 6
+// output pixels: 8-15 in __m512i out[32]
+static INLINE void idct32_34_32x32_quarter_2(const __m512i *const in /*in[32]*/,
+                                             __m512i *const out /*out[16]*/) {
+  __m512i step1[16], step2[16];
+
+  // stage 2
+  partial_butterfly_avx512(in[2], cospi_30_64, cospi_2_64, &step2[8],
+                           &step2[15]);
+  partial_butterfly_avx512(in[6], -cospi_26_64, cospi_6_64, &step2[11],
+                           &step2[12]);
+
+  // stage 3
+  step1[8] = step2[8];
+  step1[9] = step2[8];
+  step1[14] = step2[15];
+  step1[15] = step2[15];
+  step1[10] = step2[11];
+  step1[11] = step2[11];
+  step1[12] = step2[12];
+  step1[13] = step2[12];
+
+  idct32_32x32_quarter_2_stage_4_to_6(step1, out);
+}
+
+static INLINE void idct32_34_32x32_quarter_1_2(
+    const __m512i *const in /*in[32]*/, __m512i *const out /*out[32]*/) {
+  __m512i temp[16];
+  idct32_34_32x32_quarter_1(in, temp);
+  idct32_34_32x32_quarter_2(in, temp);
+  // stage 7
+  add_sub_butterfly_avx512(temp, out, 16);
+}
+
+// For each 32x32 block __m512i in[32],
+// Input with odd index, 1, 3, 5, 7
+// output pixels: 16-23, 24-31 in __m512i out[32]
+static INLINE void idct32_34_32x32_quarter_3_4(
+    const __m512i *const in /*in[32]*/, __m512i *const out /*out[32]*/) {
+  __m512i step1[32];
+
+  // stage 1
+  partial_butterfly_avx512(in[1], cospi_31_64, cospi_1_64, &step1[16],
+                           &step1[31]);
+  partial_butterfly_avx512(in[7], -cospi_25_64, cospi_7_64, &step1[19],
+                           &step1[28]);
+  partial_butterfly_avx512(in[5], cospi_27_64, cospi_5_64, &step1[20],
+                           &step1[27]);
+  partial_butterfly_avx512(in[3], -cospi_29_64, cospi_3_64, &step1[23],
+                           &step1[24]);
+
+  // stage 3
+  butterfly_avx512(step1[31], step1[16], cospi_28_64, cospi_4_64, &step1[17],
+                   &step1[30]);
+  butterfly_avx512(step1[28], step1[19], -cospi_4_64, cospi_28_64, &step1[18],
+                   &step1[29]);
+  butterfly_avx512(step1[27], step1[20], cospi_12_64, cospi_20_64, &step1[21],
+                   &step1[26]);
+  butterfly_avx512(step1[24], step1[23], -cospi_20_64, cospi_12_64, &step1[22],
+                   &step1[25]);
+
+  idct32_32x32_quarter_3_4_stage_4_to_7(step1, out);
+}
+
+static void idct32_34_32x32_avx512(const __m512i *const in /*in[32]*/,
+                                   __m512i *const out /*out[32]*/) {
+  __m512i temp[32];
+
+  idct32_34_32x32_quarter_1_2(in, temp);
+  idct32_34_32x32_quarter_3_4(in, temp);
+  // final stage
+  add_sub_butterfly_avx512(temp, out, 32);
+}
+
+// For each 32x32 block __m512i in[32],
+// Input with index, 0, 4, 8, 12
+// output pixels: 0-7 in __m512i out[32]
+static INLINE void idct32_135_32x32_quarter_1(
+    const __m512i *const in /*in[32]*/, __m512i *const out /*out[8]*/) {
+  __m512i step1[8], step2[8];
+
+  // stage 3
+  partial_butterfly_avx512(in[4], cospi_28_64, cospi_4_64, &step1[4],
+                           &step1[7]);
+  partial_butterfly_avx512(in[12], -cospi_20_64, cospi_12_64, &step1[5],
+                           &step1[6]);
+
+  // stage 4
+  step2[0] = partial_butterfly_cospi16_avx512(in[0]);
+  partial_butterfly_avx512(in[8], cospi_24_64, cospi_8_64, &step2[2],
+                           &step2[3]);
+  step2[4] = _mm512_add_epi16(step1[4], step1[5]);
+  step2[5] = _mm512_sub_epi16(step1[4], step1[5]);
+  step2[6] = _mm512_sub_epi16(step1[7], step1[6]);
+  step2[7] = _mm512_add_epi16(step1[7], step1[6]);
+
+  // stage 5
+  step1[0] = _mm512_add_epi16(step2[0], step2[3]);
+  step1[1] = _mm512_add_epi16(step2[0], step2[2]);
+  step1[2] = _mm512_sub_epi16(step2[0], step2[2]);
+  step1[3] = _mm512_sub_epi16(step2[0], step2[3]);
+  step1[4] = step2[4];
+  butterfly_avx512(step2[6], step2[5], cospi_16_64, cospi_16_64, &step1[5],
+                   &step1[6]);
+  step1[7] = step2[7];
+
+  // stage 6
+  out[0] = _mm512_add_epi16(step1[0], step1[7]);
+  out[1] = _mm512_add_epi16(step1[1], step1[6]);
+  out[2] = _mm512_add_epi16(step1[2], step1[5]);
+  out[3] = _mm512_add_epi16(step1[3], step1[4]);
+  out[4] = _mm512_sub_epi16(step1[3], step1[4]);
+  out[5] = _mm512_sub_epi16(step1[2], step1[5]);
+  out[6] = _mm512_sub_epi16(step1[1], step1[6]);
+  out[7] = _mm512_sub_epi16(step1[0], step1[7]);
+}
+
+// For each 32x32 block __m512i in[32],
+// Input with index, 2, 6, 10, 14
+// output pixels: 8-15 in __m512i out[32]
+static INLINE void idct32_135_32x32_quarter_2(
+    const __m512i *const in /*in[32]*/, __m512i *const out /*out[16]*/) {
+  __m512i step1[16], step2[16];
+
+  // stage 2
+  partial_butterfly_avx512(in[2], cospi_30_64, cospi_2_64, &step2[8],
+                           &step2[15]);
+  partial_butterfly_avx512(in[14], -cospi_18_64, cospi_14_64, &step2[9],
+                           &step2[14]);
+  partial_butterfly_avx512(in[10], cospi_22_64, cospi_10_64, &step2[10],
+                           &step2[13]);
+  partial_butterfly_avx512(in[6], -cospi_26_64, cospi_6_64, &step2[11],
+                           &step2[12]);
+
+  // stage 3
+  step1[8] = _mm512_add_epi16(step2[8], step2[9]);
+  step1[9] = _mm512_sub_epi16(step2[8], step2[9]);
+  step1[10] = _mm512_sub_epi16(step2[11], step2[10]);
+  step1[11] = _mm512_add_epi16(step2[11], step2[10]);
+  step1[12] = _mm512_add_epi16(step2[12], step2[13]);
+  step1[13] = _mm512_sub_epi16(step2[12], step2[13]);
+  step1[14] = _mm512_sub_epi16(step2[15], step2[14]);
+  step1[15] = _mm512_add_epi16(step2[15], step2[14]);
+
+  idct32_32x32_quarter_2_stage_4_to_6(step1, out);
+}
+
+static INLINE void idct32_135_32x32_quarter_1_2(
+    const __m512i *const in /*in[32]*/, __m512i *const out /*out[32]*/) {
+  __m512i temp[16];
+  idct32_135_32x32_quarter_1(in, temp);
+  idct32_135_32x32_quarter_2(in, temp);
+  // stage 7
+  add_sub_butterfly_avx512(temp, out, 16);
+}
+
+// For each 32x32 block __m512i in[32],
+// Input with odd index,
+// 1, 3, 5, 7, 9, 11, 13, 15
+// output pixels: 16-23, 24-31 in __m512i out[32]
+static INLINE void idct32_135_32x32_quarter_3_4(
+    const __m512i *const in /*in[32]*/, __m512i *const out /*out[32]*/) {
+  __m512i step1[32], step2[32];
+
+  // stage 1
+  partial_butterfly_avx512(in[1], cospi_31_64, cospi_1_64, &step1[16],
+                           &step1[31]);
+  partial_butterfly_avx512(in[15], -cospi_17_64, cospi_15_64, &step1[17],
+                           &step1[30]);
+  partial_butterfly_avx512(in[9], cospi_23_64, cospi_9_64, &step1[18],
+                           &step1[29]);
+  partial_butterfly_avx512(in[7], -cospi_25_64, cospi_7_64, &step1[19],
+                           &step1[28]);
+
+  partial_butterfly_avx512(in[5], cospi_27_64, cospi_5_64, &step1[20],
+                           &step1[27]);
+  partial_butterfly_avx512(in[11], -cospi_21_64, cospi_11_64, &step1[21],
+                           &step1[26]);
+
+  partial_butterfly_avx512(in[13], cospi_19_64, cospi_13_64, &step1[22],
+                           &step1[25]);
+  partial_butterfly_avx512(in[3], -cospi_29_64, cospi_3_64, &step1[23],
+                           &step1[24]);
+
+  // stage 2
+  step2[16] = _mm512_add_epi16(step1[16], step1[17]);
+  step2[17] = _mm512_sub_epi16(step1[16], step1[17]);
+  step2[18] = _mm512_sub_epi16(step1[19], step1[18]);
+  step2[19] = _mm512_add_epi16(step1[19], step1[18]);
+  step2[20] = _mm512_add_epi16(step1[20], step1[21]);
+  step2[21] = _mm512_sub_epi16(step1[20], step1[21]);
+  step2[22] = _mm512_sub_epi16(step1[23], step1[22]);
+  step2[23] = _mm512_add_epi16(step1[23], step1[22]);
+
+  step2[24] = _mm512_add_epi16(step1[24], step1[25]);
+  step2[25] = _mm512_sub_epi16(step1[24], step1[25]);
+  step2[26] = _mm512_sub_epi16(step1[27], step1[26]);
+  step2[27] = _mm512_add_epi16(step1[27], step1[26]);
+  step2[28] = _mm512_add_epi16(step1[28], step1[29]);
+  step2[29] = _mm512_sub_epi16(step1[28], step1[29]);
+  step2[30] = _mm512_sub_epi16(step1[31], step1[30]);
+  step2[31] = _mm512_add_epi16(step1[31], step1[30]);
+
+  // stage 3
+  step1[16] = step2[16];
+  step1[31] = step2[31];
+  butterfly_avx512(step2[30], step2[17], cospi_28_64, cospi_4_64, &step1[17],
+                   &step1[30]);
+  butterfly_avx512(step2[29], step2[18], -cospi_4_64, cospi_28_64, &step1[18],
+                   &step1[29]);
+  step1[19] = step2[19];
+  step1[20] = step2[20];
+  butterfly_avx512(step2[26], step2[21], cospi_12_64, cospi_20_64, &step1[21],
+                   &step1[26]);
+  butterfly_avx512(step2[25], step2[22], -cospi_20_64, cospi_12_64, &step1[22],
+                   &step1[25]);
+  step1[23] = step2[23];
+  step1[24] = step2[24];
+  step1[27] = step2[27];
+  step1[28] = step2[28];
+
+  idct32_32x32_quarter_3_4_stage_4_to_7(step1, out);
+}
+
+static void idct32_135_32x32_avx512(const __m512i *const in /*in[32]*/,
+                                    __m512i *const out /*out[32]*/) {
+  __m512i temp[32];
+  idct32_135_32x32_quarter_1_2(in, temp);
+  idct32_135_32x32_quarter_3_4(in, temp);
+  // final stage
+  add_sub_butterfly_avx512(temp, out, 32);
+}
+
+
+void vpx_idct32x32_1024_add_avx512(const tran_low_t *input, uint8_t *dest,
+                                   int stride) {
+  __m512i io[32];
+
+  // rows
+  load_transpose_16bit_32x32_avx512(input, 32, io);
+  idct32_1024_32x32_avx512(io, io);
+
+  // columns
+  transpose_16bit_32x32_avx512(io, io);
+  idct32_1024_32x32_avx512(io, io);
+  write_buffer_32x32_avx512(io, dest, stride);
+}
+
+// Only upper-left 16x16 has non-zero coeff
+void vpx_idct32x32_135_add_avx512(const tran_low_t *input, uint8_t *dest,
+                                  int stride) {
+  __m512i io[32];
+
+  // rows
+  load_transpose_16bit_32x32_avx512(input, 16, io);
+  idct32_135_32x32_avx512(io, io);
+
+  // columns
+  transpose_16bit_32x32_avx512(io, io);
+  idct32_135_32x32_avx512(io, io);
+  write_buffer_32x32_avx512(io, dest, stride);
+}
+
+// Only upper-left 8x8 has non-zero coeff
+void vpx_idct32x32_34_add_avx512(const tran_low_t *input, uint8_t *dest,
+                                 int stride) {
+  __m512i io[32];
+
+  // rows
+  load_transpose_16bit_32x32_avx512(input, 8, io);
+  idct32_34_32x32_avx512(io, io);
+
+  // columns
+  transpose_16bit_32x32_avx512(io, io);
+  idct32_34_32x32_avx512(io, io);
+  write_buffer_32x32_avx512(io, dest, stride);
+}
@@ -911,3 +911,330 @@ void vpx_lpf_horizontal_16_dual_avx2(unsigned char *s, int pitch,
     _mm_storeu_si128((__m128i *)(s + 6 * pitch), q6);
   }
 }
+
+// Round the 16 bit flat filter sums of 16 pixels and pack them back to bytes.
+static INLINE __m128i flat8_round_avx2(const __m256i a, const __m256i b) {
+  const __m256i res = _mm256_srli_epi16(_mm256_add_epi16(a, b), 3);
+  return _mm256_castsi256_si128(
+      _mm256_permute4x64_epi64(_mm256_packus_epi16(res, res), 168));
+}
+
+void vpx_lpf_horizontal_8_dual_avx2(
+    uint8_t *s, int pitch, const uint8_t *blimit0, const uint8_t *limit0,
+    const uint8_t *thresh0, const uint8_t *blimit1, const uint8_t *limit1,
+    const uint8_t *thresh1) {
+  const __m128i zero = _mm_set1_epi16(0);
+  const __m128i blimit =
+      _mm_unpacklo_epi64(_mm_load_si128((const __m128i *)blimit0),
+                         _mm_load_si128((const __m128i *)blimit1));
+  const __m128i limit =
+      _mm_unpacklo_epi64(_mm_load_si128((const __m128i *)limit0),
+                         _mm_load_si128((const __m128i *)limit1));
+  const __m128i thresh =
+      _mm_unpacklo_epi64(_mm_load_si128((const __m128i *)thresh0),
+                         _mm_load_si128((const __m128i *)thresh1));
+
+  __m128i mask, hev, flat;
+  __m128i p3, p2, p1, p0, q0, q1, q2, q3;
+  __m128i flat_op2, flat_op1, flat_op0, flat_oq0, flat_oq1, flat_oq2;
+  __m256i p256_3, p256_2, p256_1, p256_0, q256_0, q256_1, q256_2, q256_3;
+
+  p256_3 = _mm256_castpd_si256(
+      _mm256_broadcast_pd((__m128d const *)(s - 4 * pitch)));
+  p256_2 = _mm256_castpd_si256(
+      _mm256_broadcast_pd((__m128d const *)(s - 3 * pitch)));
+  p256_1 = _mm256_castpd_si256(
+      _mm256_broadcast_pd((__m128d const *)(s - 2 * pitch)));
+  p256_0 = _mm256_castpd_si256(
+      _mm256_broadcast_pd((__m128d const *)(s - 1 * pitch)));
+  q256_0 = _mm256_castpd_si256(
+      _mm256_broadcast_pd((__m128d const *)(s - 0 * pitch)));
+  q256_1 = _mm256_castpd_si256(
+      _mm256_broadcast_pd((__m128d const *)(s + 1 * pitch)));
+  q256_2 = _mm256_castpd_si256(
+      _mm256_broadcast_pd((__m128d const *)(s + 2 * pitch)));
+  q256_3 = _mm256_castpd_si256(
+      _mm256_broadcast_pd((__m128d const *)(s + 3 * pitch)));
+
+  p3 = _mm256_castsi256_si128(p256_3);
+  p2 = _mm256_castsi256_si128(p256_2);
+  p1 = _mm256_castsi256_si128(p256_1);
+  p0 = _mm256_castsi256_si128(p256_0);
+  q0 = _mm256_castsi256_si128(q256_0);
+  q1 = _mm256_castsi256_si128(q256_1);
+  q2 = _mm256_castsi256_si128(q256_2);
+  q3 = _mm256_castsi256_si128(q256_3);
+
+  {
+    const __m128i abs_p1p0 =
+        _mm_or_si128(_mm_subs_epu8(p1, p0), _mm_subs_epu8(p0, p1));
+    const __m128i abs_q1q0 =
+        _mm_or_si128(_mm_subs_epu8(q1, q0), _mm_subs_epu8(q0, q1));
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i fe = _mm_set1_epi8((int8_t)0xfe);
+    const __m128i ff = _mm_cmpeq_epi8(abs_p1p0, abs_p1p0);
+    __m128i abs_p0q0 =
+        _mm_or_si128(_mm_subs_epu8(p0, q0), _mm_subs_epu8(q0, p0));
+    __m128i abs_p1q1 =
+        _mm_or_si128(_mm_subs_epu8(p1, q1), _mm_subs_epu8(q1, p1));
+    __m128i work;
+
+    // filter_mask and hev_mask
+    flat = _mm_max_epu8(abs_p1p0, abs_q1q0);
+    hev = _mm_subs_epu8(flat, thresh);
+    hev = _mm_xor_si128(_mm_cmpeq_epi8(hev, zero), ff);
+
+    abs_p0q0 = _mm_adds_epu8(abs_p0q0, abs_p0q0);
+    abs_p1q1 = _mm_srli_epi16(_mm_and_si128(abs_p1q1, fe), 1);
+    mask = _mm_subs_epu8(_mm_adds_epu8(abs_p0q0, abs_p1q1), blimit);
+    mask = _mm_xor_si128(_mm_cmpeq_epi8(mask, zero), ff);
+    // mask |= (abs(p0 - q0) * 2 + abs(p1 - q1) / 2  > blimit) * -1;
+    mask = _mm_max_epu8(flat, mask);
+    // mask |= (abs(p1 - p0) > limit) * -1;
+    // mask |= (abs(q1 - q0) > limit) * -1;
+    work = _mm_max_epu8(
+        _mm_or_si128(_mm_subs_epu8(p2, p1), _mm_subs_epu8(p1, p2)),
+        _mm_or_si128(_mm_subs_epu8(p3, p2), _mm_subs_epu8(p2, p3)));
+    mask = _mm_max_epu8(work, mask);
+    work = _mm_max_epu8(
+        _mm_or_si128(_mm_subs_epu8(q2, q1), _mm_subs_epu8(q1, q2)),
+        _mm_or_si128(_mm_subs_epu8(q3, q2), _mm_subs_epu8(q2, q3)));
+    mask = _mm_max_epu8(work, mask);
+    mask = _mm_subs_epu8(mask, limit);
+    mask = _mm_cmpeq_epi8(mask, zero);
+
+    // flat_mask4
+    work = _mm_max_epu8(
+        _mm_or_si128(_mm_subs_epu8(p2, p0), _mm_subs_epu8(p0, p2)),
+        _mm_or_si128(_mm_subs_epu8(q2, q0), _mm_subs_epu8(q0, q2)));
+    flat = _mm_max_epu8(work, flat);
+    work = _mm_max_epu8(
+        _mm_or_si128(_mm_subs_epu8(p3, p0), _mm_subs_epu8(p0, p3)),
+        _mm_or_si128(_mm_subs_epu8(q3, q0), _mm_subs_epu8(q0, q3)));
+    flat = _mm_max_epu8(work, flat);
+    flat = _mm_subs_epu8(flat, one);
+    flat = _mm_cmpeq_epi8(flat, zero);
+    flat = _mm_and_si128(flat, mask);
+  }
+
+  // flat calculations, all 16 columns in one pass
+  {
+    const __m256i four = _mm256_set1_epi16(4);
+    const __m256i filter =
+        _mm256_load_si256((__m256i const *)filt_loopfilter_avx2);
+    __m256i workp_a, workp_b;
+
+    p256_3 = _mm256_shuffle_epi8(p256_3, filter);
+    p256_2 = _mm256_shuffle_epi8(p256_2, filter);
+    p256_1 = _mm256_shuffle_epi8(p256_1, filter);
+    p256_0 = _mm256_shuffle_epi8(p256_0, filter);
+    q256_0 = _mm256_shuffle_epi8(q256_0, filter);
+    q256_1 = _mm256_shuffle_epi8(q256_1, filter);
+    q256_2 = _mm256_shuffle_epi8(q256_2, filter);
+    q256_3 = _mm256_shuffle_epi8(q256_3, filter);
+
+    workp_a = _mm256_add_epi16(_mm256_add_epi16(p256_3, p256_3),
+                               _mm256_add_epi16(p256_2, p256_1));
+    workp_a = _mm256_add_epi16(_mm256_add_epi16(workp_a, four), p256_0);
+    workp_b = _mm256_add_epi16(_mm256_add_epi16(q256_0, p256_2), p256_3);
+    flat_op2 = flat8_round_avx2(workp_a, workp_b);
+
+    workp_b = _mm256_add_epi16(_mm256_add_epi16(q256_0, q256_1), p256_1);
+    flat_op1 = flat8_round_avx2(workp_a, workp_b);
+
+    workp_a = _mm256_add_epi16(_mm256_sub_epi16(workp_a, p256_3), q256_2);
+    workp_b = _mm256_add_epi16(_mm256_sub_epi16(workp_b, p256_1), p256_0);
+    flat_op0 = flat8_round_avx2(workp_a, workp_b);
+
+    workp_a = _mm256_add_epi16(_mm256_sub_epi16(workp_a, p256_3), q256_3);
+    workp_b = _mm256_add_epi16(_mm256_sub_epi16(workp_b, p256_0), q256_0);
+    flat_oq0 = flat8_round_avx2(workp_a, workp_b);
+
+    workp_a = _mm256_add_epi16(_mm256_sub_epi16(workp_a, p256_2), q256_3);
+    workp_b = _mm256_add_epi16(_mm256_sub_epi16(workp_b, q256_0), q256_1);
+    flat_oq1 = flat8_round_avx2(workp_a, workp_b);
+
+    workp_a = _mm256_add_epi16(_mm256_sub_epi16(workp_a, p256_1), q256_3);
+    workp_b = _mm256_add_epi16(_mm256_sub_epi16(workp_b, q256_1), q256_2);
+    flat_oq2 = flat8_round_avx2(workp_a, workp_b);
+  }
+
+  // lp filter
+  {
+    const __m128i t4 = _mm_set1_epi8(4);
+    const __m128i t3 = _mm_set1_epi8(3);
+    const __m128i t80 = _mm_set1_epi8((int8_t)0x80);
+    const __m128i te0 = _mm_set1_epi8((int8_t)0xe0);
+    const __m128i t1f = _mm_set1_epi8(0x1f);
+    const __m128i t1 = _mm_set1_epi8(0x1);
+    const __m128i t7f = _mm_set1_epi8(0x7f);
+
+    const __m128i ps1 = _mm_xor_si128(p1, t80);
+    const __m128i ps0 = _mm_xor_si128(p0, t80);
+    const __m128i qs0 = _mm_xor_si128(q0, t80);
+    const __m128i qs1 = _mm_xor_si128(q1, t80);
+    __m128i filt;
+    __m128i work_a;
+    __m128i filter1, filter2;
+
+    filt = _mm_and_si128(_mm_subs_epi8(ps1, qs1), hev);
+    work_a = _mm_subs_epi8(qs0, ps0);
+    filt = _mm_adds_epi8(filt, work_a);
+    filt = _mm_adds_epi8(filt, work_a);
+    filt = _mm_adds_epi8(filt, work_a);
+    // (vpx_filter + 3 * (qs0 - ps0)) & mask
+    filt = _mm_and_si128(filt, mask);
+
+    filter1 = _mm_adds_epi8(filt, t4);
+    filter2 = _mm_adds_epi8(filt, t3);
+
+    // Filter1 >> 3
+    work_a = _mm_cmpgt_epi8(zero, filter1);
+    filter1 = _mm_srli_epi16(filter1, 3);
+    work_a = _mm_and_si128(work_a, te0);
+    filter1 = _mm_and_si128(filter1, t1f);
+    filter1 = _mm_or_si128(filter1, work_a);
+
+    // Filter2 >> 3
+    work_a = _mm_cmpgt_epi8(zero, filter2);
+    filter2 = _mm_srli_epi16(filter2, 3);
+    work_a = _mm_and_si128(work_a, te0);
+    filter2 = _mm_and_si128(filter2, t1f);
+    filter2 = _mm_or_si128(filter2, work_a);
+
+    // filt >> 1
+    filt = _mm_adds_epi8(filter1, t1);
+    work_a = _mm_cmpgt_epi8(zero, filt);
+    filt = _mm_srli_epi16(filt, 1);
+    work_a = _mm_and_si128(work_a, t80);
+    filt = _mm_and_si128(filt, t7f);
+    filt = _mm_or_si128(filt, work_a);
+
+    filt = _mm_andnot_si128(hev, filt);
+
+    work_a = _mm_xor_si128(_mm_subs_epi8(qs0, filter1), t80);
+    q0 = _mm_or_si128(_mm_andnot_si128(flat, work_a),
+                      _mm_and_si128(flat, flat_oq0));
+
+    work_a = _mm_xor_si128(_mm_subs_epi8(qs1, filt), t80);
+    q1 = _mm_or_si128(_mm_andnot_si128(flat, work_a),
+                      _mm_and_si128(flat, flat_oq1));
+
+    q2 = _mm_or_si128(_mm_andnot_si128(flat, q2),
+                      _mm_and_si128(flat, flat_oq2));
+
+    work_a = _mm_xor_si128(_mm_adds_epi8(ps0, filter2), t80);
+    p0 = _mm_or_si128(_mm_andnot_si128(flat, work_a),
+                      _mm_and_si128(flat, flat_op0));
+
+    work_a = _mm_xor_si128(_mm_adds_epi8(ps1, filt), t80);
+    p1 = _mm_or_si128(_mm_andnot_si128(flat, work_a),
+                      _mm_and_si128(flat, flat_op1));
+
+    p2 = _mm_or_si128(_mm_andnot_si128(flat, p2),
+                      _mm_and_si128(flat, flat_op2));
+
+    _mm_storeu_si128((__m128i *)(s - 3 * pitch), p2);
+    _mm_storeu_si128((__m128i *)(s - 2 * pitch), p1);
+    _mm_storeu_si128((__m128i *)(s - 1 * pitch), p0);
+    _mm_storeu_si128((__m128i *)(s + 0 * pitch), q0);
+    _mm_storeu_si128((__m128i *)(s + 1 * pitch), q1);
+    _mm_storeu_si128((__m128i *)(s + 2 * pitch), q2);
+  }
+}
+
+// Transpose two independent 8x8 blocks of bytes, one per 128 bit lane. The
+// block at in0 is written to out0 and the block at in1 to out1.
+static INLINE void transpose_8x8x2_avx2(const uint8_t *in0, const uint8_t *in1,
+                                        int in_p, uint8_t *out0, uint8_t *out1,
+                                        int out_p) {
+  __m256i x[8], a[4], b[4], c[4];
+  int i;
+
+  for (i = 0; i < 8; ++i) {
+    const __m128i lo = _mm_loadl_epi64((const __m128i *)(in0 + i * in_p));
+    const __m128i hi = _mm_loadl_epi64((const __m128i *)(in1 + i * in_p));
+    x[i] = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+  }
+
+  // 00 10 01 11 02 12 03 13 04 14 05 15 06 16 07 17
+  // 20 30 21 31 22 32 23 33 24 34 25 35 26 36 27 37
+  // ...
+  for (i = 0; i < 4; ++i) a[i] = _mm256_unpacklo_epi8(x[2 * i], x[2 * i + 1]);
+
+  // 00 10 20 30 01 11 21 31 02 12 22 32 03 13 23 33
+  // 40 50 60 70 41 51 61 71 42 52 62 72 43 53 63 73
+  // 04 14 24 34 05 15 25 35 06 16 26 36 07 17 27 37
+  // 44 54 64 74 45 55 65 75 46 56 66 76 47 57 67 77
+  b[0] = _mm256_unpacklo_epi16(a[0], a[1]);
+  b[1] = _mm256_unpacklo_epi16(a[2], a[3]);
+  b[2] = _mm256_unpackhi_epi16(a[0], a[1]);
+  b[3] = _mm256_unpackhi_epi16(a[2], a[3]);
+
+  // 00 10 20 30 40 50 60 70 01 11 21 31 41 51 61 71
+  // 02 12 22 32 42 52 62 72 03 13 23 33 43 53 63 73
+  // ...
+  c[0] = _mm256_unpacklo_epi32(b[0], b[1]);
+  c[1] = _mm256_unpackhi_epi32(b[0], b[1]);
+  c[2] = _mm256_unpacklo_epi32(b[2], b[3]);
+  c[3] = _mm256_unpackhi_epi32(b[2], b[3]);
+
+  for (i = 0; i < 4; ++i) {
+    const __m128i lo = _mm256_castsi256_si128(c[i]);
+    const __m128i hi = _mm256_extracti128_si256(c[i], 1);
+    _mm_storel_epi64((__m128i *)(out0 + (2 * i) * out_p), lo);
+    _mm_storeh_pi((__m64 *)(out0 + (2 * i + 1) * out_p), _mm_castsi128_ps(lo));
+    _mm_storel_epi64((__m128i *)(out1 + (2 * i) * out_p), hi);
+    _mm_storeh_pi((__m64 *)(out1 + (2 * i + 1) * out_p), _mm_castsi128_ps(hi));
+  }
+}
+
+void vpx_lpf_vertical_8_dual_avx2(uint8_t *s, int pitch, const uint8_t *blimit0,
+                                  const uint8_t *limit0, const uint8_t *thresh0,
+                                  const uint8_t *blimit1, const uint8_t *limit1,
+                                  const uint8_t *thresh1) {
+  DECLARE_ALIGNED(16, uint8_t, t_dst[16 * 8]);
+
+  // Transpose 8x16
+  transpose_8x8x2_avx2(s - 4, s - 4 + 8 * pitch, pitch, t_dst, t_dst + 8, 16);
+
+  // Loop filtering
+  vpx_lpf_horizontal_8_dual_avx2(t_dst + 4 * 16, 16, blimit0, limit0, thresh0,
+                                 blimit1, limit1, thresh1);
+
+  // Transpose back
+  transpose_8x8x2_avx2(t_dst, t_dst + 8, 16, s - 4, s - 4 + 8 * pitch, pitch);
+}
+
+void vpx_lpf_vertical_16_avx2(uint8_t *s, int pitch, const uint8_t *blimit,
+                              const uint8_t *limit, const uint8_t *thresh) {
+  DECLARE_ALIGNED(16, uint8_t, t_dst[8 * 16]);
+
+  // Transpose 16x8
+  transpose_8x8x2_avx2(s - 8, s, pitch, t_dst, t_dst + 8 * 8, 8);
+
+  // Loop filtering
+  vpx_lpf_horizontal_16_avx2(t_dst + 8 * 8, 8, blimit, limit, thresh);
+
+  // Transpose back
+  transpose_8x8x2_avx2(t_dst, t_dst + 8 * 8, 8, s - 8, s, pitch);
+}
+
+void vpx_lpf_vertical_16_dual_avx2(uint8_t *s, int pitch,
+                                   const uint8_t *blimit, const uint8_t *limit,
+                                   const uint8_t *thresh) {
+  DECLARE_ALIGNED(16, uint8_t, t_dst[256]);
+
+  // Transpose 16x16
+  transpose_8x8x2_avx2(s - 8, s - 8 + 8 * pitch, pitch, t_dst, t_dst + 8, 16);
+  transpose_8x8x2_avx2(s, s + 8 * pitch, pitch, t_dst + 8 * 16,
+                       t_dst + 8 * 16 + 8, 16);
+
+  // Loop filtering
+  vpx_lpf_horizontal_16_dual_avx2(t_dst + 8 * 16, 16, blimit, limit, thresh);
+
+  // Transpose back
+  transpose_8x8x2_avx2(t_dst, t_dst + 8 * 16, 16, s - 8, s, pitch);
+  transpose_8x8x2_avx2(t_dst + 8, t_dst + 8 * 16 + 8, 16, s - 8 + 8 * pitch,
+                       s + 8 * pitch, pitch);
+}
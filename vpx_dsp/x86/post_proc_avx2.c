@@ -0,0 +1,364 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <immintrin.h>  // AVX2
+#include <string.h>
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_dsp/x86/transpose_avx2.h"
+#include "vpx_ports/mem.h"
+
+extern const int16_t vpx_rv[];
+
+// The 5 tap filter of vpx_post_proc_down_and_across_mb_row_c(). The pixel is
+// replaced by the rounded average of itself and its neighbours only where all
+// 4 neighbours differ from it by less than the limit.
+static INLINE __m128i filter5(const __m128i v, const __m128i a2,
+                              const __m128i a1, const __m128i b1,
+                              const __m128i b2, const __m128i flimit) {
+  const __m128i k = _mm_avg_epu8(
+      _mm_avg_epu8(_mm_avg_epu8(a2, a1), _mm_avg_epu8(b2, b1)), v);
+  const __m128i d0 =
+      _mm_max_epu8(_mm_or_si128(_mm_subs_epu8(v, a2), _mm_subs_epu8(a2, v)),
+                   _mm_or_si128(_mm_subs_epu8(v, a1), _mm_subs_epu8(a1, v)));
+  const __m128i d1 =
+      _mm_max_epu8(_mm_or_si128(_mm_subs_epu8(v, b1), _mm_subs_epu8(b1, v)),
+                   _mm_or_si128(_mm_subs_epu8(v, b2), _mm_subs_epu8(b2, v)));
+  // Set where a difference reaches the limit.
+  const __m128i keep =
+      _mm_cmpeq_epi8(_mm_subs_epu8(flimit, _mm_max_epu8(d0, d1)),
+                     _mm_setzero_si128());
+  return _mm_blendv_epi8(k, v, keep);
+}
+
+static INLINE __m256i filter5_x2(const __m256i v, const __m256i a2,
+                                 const __m256i a1, const __m256i b1,
+                                 const __m256i b2, const __m256i flimit) {
+  const __m256i k = _mm256_avg_epu8(
+      _mm256_avg_epu8(_mm256_avg_epu8(a2, a1), _mm256_avg_epu8(b2, b1)), v);
+  const __m256i d0 = _mm256_max_epu8(
+      _mm256_or_si256(_mm256_subs_epu8(v, a2), _mm256_subs_epu8(a2, v)),
+      _mm256_or_si256(_mm256_subs_epu8(v, a1), _mm256_subs_epu8(a1, v)));
+  const __m256i d1 = _mm256_max_epu8(
+      _mm256_or_si256(_mm256_subs_epu8(v, b1), _mm256_subs_epu8(b1, v)),
+      _mm256_or_si256(_mm256_subs_epu8(v, b2), _mm256_subs_epu8(b2, v)));
+  const __m256i keep =
+      _mm256_cmpeq_epi8(_mm256_subs_epu8(flimit, _mm256_max_epu8(d0, d1)),
+                        _mm256_setzero_si256());
+  return _mm256_blendv_epi8(k, v, keep);
+}
+
+static INLINE __m128i load_u8_16(const unsigned char *p) {
+  return _mm_loadu_si128((const __m128i *)p);
+}
+
+static INLINE __m256i load_u8_32(const unsigned char *p) {
+  return _mm256_loadu_si256((const __m256i *)p);
+}
+
+// Filters the row across in place. Each block of pixels reads 2 pixels on
+// either side, so its result is only stored once the next block is loaded.
+static INLINE void post_proc_across(unsigned char *p, int cols,
+                                    const unsigned char *flimits) {
+  __m256i pending_x2 = _mm256_setzero_si256();
+  __m128i pending = _mm_setzero_si128();
+  int pending_width = 0;
+  int col;
+
+  for (col = 0; col + 32 <= cols; col += 32) {
+    unsigned char *const s = p + col;
+    const __m256i out =
+        filter5_x2(load_u8_32(s), load_u8_32(s - 2), load_u8_32(s - 1),
+                   load_u8_32(s + 1), load_u8_32(s + 2),
+                   load_u8_32(flimits + col));
+    if (pending_width) _mm256_storeu_si256((__m256i *)(s - 32), pending_x2);
+    pending_x2 = out;
+    pending_width = 32;
+  }
+
+  // Like the SSE2 version the rest is filtered 16 pixels at a time, reading
+  // up to 17 pixels past the end of the row and 15 limits past the last one.
+  for (; col < cols; col += 16) {
+    unsigned char *const s = p + col;
+    const __m128i out =
+        filter5(load_u8_16(s), load_u8_16(s - 2), load_u8_16(s - 1),
+                load_u8_16(s + 1), load_u8_16(s + 2),
+                load_u8_16(flimits + col));
+    if (pending_width == 32) {
+      _mm256_storeu_si256((__m256i *)(s - 32), pending_x2);
+    } else if (pending_width == 16) {
+      _mm_storeu_si128((__m128i *)(s - 16), pending);
+    }
+    pending = out;
+    pending_width = 16;
+  }
+
+  if (pending_width == 32) {
+    _mm256_storeu_si256((__m256i *)(p + col - 32), pending_x2);
+  } else {
+    const int width = cols - (col - 16);
+    if (width == 16) {
+      _mm_storeu_si128((__m128i *)(p + col - 16), pending);
+    } else {
+      DECLARE_ALIGNED(16, unsigned char, last[16]);
+      _mm_store_si128((__m128i *)last, pending);
+      memcpy(p + col - 16, last, width);
+    }
+  }
+}
+
+void vpx_post_proc_down_and_across_mb_row_avx2(unsigned char *src,
+                                               unsigned char *dst,
+                                               int src_pitch, int dst_pitch,
+                                               int cols,
+                                               unsigned char *flimits,
+                                               int size) {
+  int row, col;
+
+  assert(size >= 8);
+  assert(cols >= 8);
+
+  for (row = 0; row < size; row++) {
+    // post_proc_down. The last 16 pixels may be written past the end of the
+    // row, which the across filter does not read beyond its extension.
+    for (col = 0; col + 32 <= cols; col += 32) {
+      const unsigned char *const s = src + col;
+      _mm256_storeu_si256(
+          (__m256i *)(dst + col),
+          filter5_x2(load_u8_32(s), load_u8_32(s - 2 * src_pitch),
+                     load_u8_32(s - src_pitch), load_u8_32(s + src_pitch),
+                     load_u8_32(s + 2 * src_pitch), load_u8_32(flimits + col)));
+    }
+    for (; col < cols; col += 16) {
+      const unsigned char *const s = src + col;
+      _mm_storeu_si128(
+          (__m128i *)(dst + col),
+          filter5(load_u8_16(s), load_u8_16(s - 2 * src_pitch),
+                  load_u8_16(s - src_pitch), load_u8_16(s + src_pitch),
+                  load_u8_16(s + 2 * src_pitch), load_u8_16(flimits + col)));
+    }
+
+    // post_proc_across
+    dst[-2] = dst[-1] = dst[0];
+    dst[cols] = dst[cols + 1] = dst[cols - 1];
+    post_proc_across(dst, cols, flimits);
+
+    src += src_pitch;
+    dst += dst_pitch;
+  }
+}
+
+// Loads 16 columns of 16 rows, one column of the rows per register.
+static INLINE void load_columns(const unsigned char *src, int pitch,
+                                __m256i *col) {
+  int i;
+  for (i = 0; i < 16; ++i) {
+    col[i] = _mm256_cvtepu8_epi16(
+        _mm_loadu_si128((const __m128i *)(src + i * pitch)));
+  }
+  transpose_16bit_16x16_avx2(col, col);
+}
+
+static INLINE void store_columns(__m256i *col, unsigned char *dst, int pitch,
+                                 int width) {
+  int i;
+  transpose_16bit_16x16_avx2(col, col);
+  for (i = 0; i < 16; ++i) {
+    const __m256i row =
+        _mm256_permute4x64_epi64(_mm256_packus_epi16(col[i], col[i]), 0xd8);
+    if (width == 16) {
+      _mm_storeu_si128((__m128i *)(dst + i * pitch),
+                       _mm256_castsi256_si128(row));
+    } else {
+      DECLARE_ALIGNED(16, unsigned char, last[16]);
+      _mm_store_si128((__m128i *)last, _mm256_castsi256_si128(row));
+      memcpy(dst + i * pitch, last, width);
+    }
+  }
+}
+
+// Adds the 32 bit products of a and b to sumsq[0] (elements 0-3 and 8-11)
+// and sumsq[1] (elements 4-7 and 12-15).
+static INLINE void accumulate_products(const __m256i a, const __m256i b,
+                                       __m256i *sumsq) {
+  const __m256i lo = _mm256_mullo_epi16(a, b);
+  const __m256i hi = _mm256_mulhi_epi16(a, b);
+  sumsq[0] = _mm256_add_epi32(sumsq[0], _mm256_unpacklo_epi16(lo, hi));
+  sumsq[1] = _mm256_add_epi32(sumsq[1], _mm256_unpackhi_epi16(lo, hi));
+}
+
+// Returns where sumsq * 15 - sum * sum < flimit as a 16 bit mask.
+static INLINE __m256i variance_mask(const __m256i sum, const __m256i *sumsq,
+                                    const __m256i flimit) {
+  const __m256i lo = _mm256_mullo_epi16(sum, sum);
+  const __m256i hi = _mm256_mulhi_epi16(sum, sum);
+  const __m256i var_0 = _mm256_sub_epi32(
+      _mm256_sub_epi32(_mm256_slli_epi32(sumsq[0], 4), sumsq[0]),
+      _mm256_unpacklo_epi16(lo, hi));
+  const __m256i var_1 = _mm256_sub_epi32(
+      _mm256_sub_epi32(_mm256_slli_epi32(sumsq[1], 4), sumsq[1]),
+      _mm256_unpackhi_epi16(lo, hi));
+  return _mm256_packs_epi32(_mm256_cmpgt_epi32(flimit, var_0),
+                            _mm256_cmpgt_epi32(flimit, var_1));
+}
+
+// Ring of the unfiltered columns, large enough to hold columns c - 8 to
+// c + 22 while column c is filtered.
+#define ACROSS_CONTEXT 64
+
+// Loads the next 16 columns into the ring. The last block is read up to 15
+// pixels past the end of the row, where the C version writes its extension,
+// and the 8 columns after the row repeat the last one.
+static INLINE void load_next_columns(const unsigned char *src, int pitch,
+                                     int cols, __m256i *context, int *next) {
+  load_columns(src + *next, pitch, &context[*next & (ACROSS_CONTEXT - 1)]);
+  *next += 16;
+  if (*next >= cols) {
+    const __m256i last = context[(cols - 1) & (ACROSS_CONTEXT - 1)];
+    int i;
+    for (i = cols; i < cols + 8; ++i) context[i & (ACROSS_CONTEXT - 1)] = last;
+  }
+}
+
+void vpx_mbpost_proc_across_ip_avx2(unsigned char *src, int pitch, int rows,
+                                    int cols, int flimit) {
+  const __m256i f = _mm256_set1_epi32(flimit);
+  const __m256i round = _mm256_set1_epi16(8);
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i context[ACROSS_CONTEXT];
+  __m256i out[16];
+  int row;
+
+  // 16 rows are filtered together, transposed so that the filter runs down
+  // the registers like vpx_mbpost_proc_down().
+  for (row = 0; row + 16 <= rows; row += 16) {
+    unsigned char *const s = src + row * pitch;
+    __m256i first, sum, sumsq[2], sq;
+    int c, i;
+    int next = 0;  // First column not loaded yet.
+
+    load_next_columns(s, pitch, cols, context, &next);
+    first = context[0];
+    for (i = -8; i < 0; ++i) context[i & (ACROSS_CONTEXT - 1)] = first;
+
+    // sum = 9 * s[0] + s[1] + ... + s[6], sumsq likewise plus 16.
+    sum = _mm256_add_epi16(_mm256_slli_epi16(first, 3), first);
+    sumsq[0] = sumsq[1] = _mm256_set1_epi32(16);
+    accumulate_products(sum, first, sumsq);
+    for (i = 1; i <= 6; ++i) {
+      const __m256i a = context[i];
+      sum = _mm256_add_epi16(sum, a);
+      sq = _mm256_mullo_epi16(a, a);
+      sumsq[0] = _mm256_add_epi32(sumsq[0], _mm256_unpacklo_epi16(sq, zero));
+      sumsq[1] = _mm256_add_epi32(sumsq[1], _mm256_unpackhi_epi16(sq, zero));
+    }
+
+    for (c = 0; c < cols; ++c) {
+      const __m256i v = context[c & (ACROSS_CONTEXT - 1)];
+      __m256i below, above, filtered;
+
+      if (next < cols && next <= c + 7) {
+        load_next_columns(s, pitch, cols, context, &next);
+      }
+      below = context[(c + 7) & (ACROSS_CONTEXT - 1)];
+      above = context[(c - 8) & (ACROSS_CONTEXT - 1)];
+
+      // sumsq += (below - above) * (below + above)
+      sum = _mm256_add_epi16(sum, _mm256_sub_epi16(below, above));
+      accumulate_products(_mm256_sub_epi16(below, above),
+                          _mm256_add_epi16(below, above), sumsq);
+
+      filtered = _mm256_srli_epi16(
+          _mm256_add_epi16(_mm256_add_epi16(sum, v), round), 4);
+      out[c & 15] =
+          _mm256_blendv_epi8(v, filtered, variance_mask(sum, sumsq, f));
+
+      // The columns of the next block have been loaded by now.
+      if ((c & 15) == 15 || c == cols - 1) {
+        store_columns(out, s + (c & ~15), pitch, (c & 15) + 1);
+      }
+    }
+  }
+
+  if (row < rows) {
+    vpx_mbpost_proc_across_ip_c(src + row * pitch, pitch, rows - row, cols,
+                                flimit);
+  }
+}
+
+#undef ACROSS_CONTEXT
+
+void vpx_mbpost_proc_down_avx2(unsigned char *dst, int pitch, int rows,
+                               int cols, int flimit) {
+  const __m256i f = _mm256_set1_epi32(flimit);
+  const __m256i zero = _mm256_setzero_si256();
+  int col;
+
+  // 16 columns are processed at a time and the last 8, if any, by the SSE2
+  // version. The noise only depends on the column modulo 8.
+  assert(cols % 8 == 0);
+  assert(rows >= 8);
+
+  for (col = 0; col + 16 <= cols; col += 16) {
+    unsigned char *const d = dst + col;
+    __m256i above_context[8];
+    __m256i s = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)d));
+    __m256i sum, sumsq[2], below = s;
+    int row, i;
+
+    for (i = 0; i < 8; ++i) above_context[i] = s;
+
+    // sum = 9 * s[0] + s[1] + ... + s[6]
+    sum = _mm256_add_epi16(_mm256_slli_epi16(s, 3), s);
+    sumsq[0] = sumsq[1] = zero;
+    accumulate_products(sum, s, sumsq);
+    for (i = 1; i <= 6; ++i) {
+      const __m256i a = _mm256_cvtepu8_epi16(
+          _mm_loadu_si128((const __m128i *)(d + i * pitch)));
+      const __m256i sq = _mm256_mullo_epi16(a, a);
+      sum = _mm256_add_epi16(sum, a);
+      sumsq[0] = _mm256_add_epi32(sumsq[0], _mm256_unpacklo_epi16(sq, zero));
+      sumsq[1] = _mm256_add_epi32(sumsq[1], _mm256_unpackhi_epi16(sq, zero));
+    }
+
+    // Unlike the SSE2 version the rows past the bottom are not written.
+    for (row = 0; row < rows; ++row) {
+      const __m256i above = above_context[row & 7];
+      const __m256i this_row = _mm256_cvtepu8_epi16(
+          _mm_loadu_si128((const __m128i *)(d + row * pitch)));
+      const __m256i rv = _mm256_broadcastsi128_si256(
+          _mm_loadu_si128((const __m128i *)(vpx_rv + (row & 127))));
+      __m256i out;
+
+      // The bottom row is repeated below the block.
+      if (row + 7 < rows) {
+        below = _mm256_cvtepu8_epi16(
+            _mm_loadu_si128((const __m128i *)(d + (row + 7) * pitch)));
+      }
+
+      sum = _mm256_add_epi16(sum, _mm256_sub_epi16(below, above));
+      accumulate_products(_mm256_sub_epi16(below, above),
+                          _mm256_add_epi16(below, above), sumsq);
+
+      out = _mm256_srai_epi16(
+          _mm256_add_epi16(_mm256_add_epi16(rv, sum), this_row), 4);
+      out = _mm256_blendv_epi8(this_row, out, variance_mask(sum, sumsq, f));
+      out = _mm256_permute4x64_epi64(_mm256_packus_epi16(out, out), 0xd8);
+      _mm_storeu_si128((__m128i *)(d + row * pitch),
+                       _mm256_castsi256_si128(out));
+
+      above_context[row & 7] = this_row;
+    }
+  }
+
+  if (col < cols) vpx_mbpost_proc_down_sse2(dst + col, pitch, rows, 8, flimit);
+}
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VPX_DSP_X86_QUANTIZE_AVX2_H_
+#define VPX_VPX_DSP_X86_QUANTIZE_AVX2_H_
+
+#include <immintrin.h>
+
+#include "./vpx_config.h"
+#include "vpx/vpx_integer.h"
+
+// Helpers for the high bitdepth quantizers, which work on 8 32 bit
+// coefficients at a time.
+
+// Load 8 quantizer values. The first lane holds the DC value and the rest
+// hold the AC value.
+static INLINE __m256i highbd_load_qp_avx2(const int16_t *ptr) {
+  return _mm256_cvtepi16_epi32(_mm_load_si128((const __m128i *)ptr));
+}
+
+// Replace the DC value with the AC value in every lane.
+static INLINE __m256i highbd_ac_qp_avx2(const __m256i qp) {
+  return _mm256_permute2x128_si256(qp, qp, 0x11);
+}
+
+// Return bits [shift, shift + 32) of the signed 64 bit product of each pair
+// of 32 bit lanes. This is (int)(((int64_t)x * y) >> shift) as long as the
+// result fits in 32 bits.
+static INLINE __m256i highbd_mul_shift_avx2(const __m256i x, const __m256i y,
+                                            const int shift) {
+  const __m256i prod_even = _mm256_mul_epi32(x, y);
+  const __m256i prod_odd =
+      _mm256_mul_epi32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32));
+  return _mm256_blend_epi32(_mm256_srli_epi64(prod_even, shift),
+                            _mm256_slli_epi64(prod_odd, 32 - shift), 0xaa);
+}
+
+// Apply the sign of |coeff| to |abs_qcoeff| the way the C code does, which
+// unlike _mm256_sign_epi32() keeps the value when |coeff| is 0.
+static INLINE __m256i highbd_invert_sign_avx2(const __m256i abs_qcoeff,
+                                              const __m256i coeff) {
+  const __m256i sign = _mm256_srai_epi32(coeff, 31);
+  return _mm256_sub_epi32(_mm256_xor_si256(abs_qcoeff, sign), sign);
+}
+
+// Divide by 2, rounding toward zero like the C '/' operator.
+static INLINE __m256i highbd_half_avx2(const __m256i x) {
+  return _mm256_srai_epi32(_mm256_add_epi32(x, _mm256_srli_epi32(x, 31)), 1);
+}
+
+// Return the largest iscan + 1 of the nonzero lanes of |abs_qcoeff|.
+static INLINE __m256i highbd_scan_eob_avx2(const __m256i abs_qcoeff,
+                                           const int16_t *iscan_ptr) {
+  const __m256i iscan =
+      _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)iscan_ptr));
+  const __m256i zero_qcoeff =
+      _mm256_cmpeq_epi32(abs_qcoeff, _mm256_setzero_si256());
+  const __m256i iscan_plus_one = _mm256_add_epi32(iscan, _mm256_set1_epi32(1));
+  return _mm256_andnot_si256(zero_qcoeff, iscan_plus_one);
+}
+
+static INLINE uint16_t highbd_get_max_eob_avx2(const __m256i eob) {
+  __m128i eob_max = _mm_max_epi32(_mm256_castsi256_si128(eob),
+                                  _mm256_extracti128_si256(eob, 1));
+  eob_max = _mm_max_epi32(eob_max, _mm_shuffle_epi32(eob_max, 0xe));
+  eob_max = _mm_max_epi32(eob_max, _mm_shuffle_epi32(eob_max, 0x1));
+  return (uint16_t)_mm_cvtsi128_si32(eob_max);
+}
+
+#endif  // VPX_VPX_DSP_X86_QUANTIZE_AVX2_H_
@@ -185,3 +185,104 @@ void vpx_sad64x64x4d_avx2(const uint8_t *src_ptr, int src_stride,
 
   calc_final_4(sums, sad_array);
 }
+
+// Two 16 pixel rows per register: row i in the low and row i + 1 in the
+// high lane.
+static INLINE __m256i load_16x2(const uint8_t *p, int stride) {
+  const __m128i lo = _mm_loadu_si128((const __m128i *)p);
+  const __m128i hi = _mm_loadu_si128((const __m128i *)(p + stride));
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+static INLINE void sad16xhx4d_avx2(const uint8_t *src_ptr, int src_stride,
+                                   const uint8_t *const ref_array[4],
+                                   int ref_stride, uint32_t sad_array[4],
+                                   int height) {
+  int i;
+  const uint8_t *refs[4];
+  __m256i sums[4];
+
+  refs[0] = ref_array[0];
+  refs[1] = ref_array[1];
+  refs[2] = ref_array[2];
+  refs[3] = ref_array[3];
+  sums[0] = _mm256_setzero_si256();
+  sums[1] = _mm256_setzero_si256();
+  sums[2] = _mm256_setzero_si256();
+  sums[3] = _mm256_setzero_si256();
+
+  for (i = 0; i < height; i += 2) {
+    const __m256i s = load_16x2(src_ptr, src_stride);
+
+    sums[0] = _mm256_add_epi32(
+        sums[0], _mm256_sad_epu8(load_16x2(refs[0], ref_stride), s));
+    sums[1] = _mm256_add_epi32(
+        sums[1], _mm256_sad_epu8(load_16x2(refs[1], ref_stride), s));
+    sums[2] = _mm256_add_epi32(
+        sums[2], _mm256_sad_epu8(load_16x2(refs[2], ref_stride), s));
+    sums[3] = _mm256_add_epi32(
+        sums[3], _mm256_sad_epu8(load_16x2(refs[3], ref_stride), s));
+
+    src_ptr += 2 * src_stride;
+    refs[0] += 2 * ref_stride;
+    refs[1] += 2 * ref_stride;
+    refs[2] += 2 * ref_stride;
+    refs[3] += 2 * ref_stride;
+  }
+
+  calc_final_4(sums, sad_array);
+}
+
+void vpx_sad16x16x4d_avx2(const uint8_t *src_ptr, int src_stride,
+                          const uint8_t *const ref_array[], int ref_stride,
+                          uint32_t *sad_array) {
+  sad16xhx4d_avx2(src_ptr, src_stride, ref_array, ref_stride, sad_array, 16);
+}
+
+void vpx_sad16x8x4d_avx2(const uint8_t *src_ptr, int src_stride,
+                         const uint8_t *const ref_array[], int ref_stride,
+                         uint32_t *sad_array) {
+  sad16xhx4d_avx2(src_ptr, src_stride, ref_array, ref_stride, sad_array, 8);
+}
+
+// _mm256_mpsadbw_epu8 sums 4 pixel groups at 8 consecutive offsets. The low
+// lane covers source groups 0 and 1 against ref[0..14], the high lane groups
+// 2 and 3 against ref[8..22]. The 16 bit sums cannot overflow: even after
+// the lanes are added they are at most 16 rows * 16 * 255.
+static INLINE void sad16xhx8_avx2(const uint8_t *src_ptr, int src_stride,
+                                  const uint8_t *ref_ptr, int ref_stride,
+                                  uint32_t *sad_array, int height) {
+  int i;
+  __m256i sums = _mm256_setzero_si256();
+  __m128i sum;
+
+  for (i = 0; i < height; i++) {
+    const __m256i s = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i *)src_ptr));
+    const __m256i r = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)ref_ptr)),
+        _mm_loadu_si128((const __m128i *)(ref_ptr + 8)), 1);
+
+    sums = _mm256_add_epi16(sums, _mm256_mpsadbw_epu8(r, s, 0x10));
+    sums = _mm256_add_epi16(sums, _mm256_mpsadbw_epu8(r, s, 0x3d));
+
+    src_ptr += src_stride;
+    ref_ptr += ref_stride;
+  }
+
+  sum = _mm_add_epi16(_mm256_castsi256_si128(sums),
+                      _mm256_extracti128_si256(sums, 1));
+  _mm256_storeu_si256((__m256i *)sad_array, _mm256_cvtepu16_epi32(sum));
+}
+
+void vpx_sad16x16x8_avx2(const uint8_t *src_ptr, int src_stride,
+                         const uint8_t *ref_ptr, int ref_stride,
+                         uint32_t *sad_array) {
+  sad16xhx8_avx2(src_ptr, src_stride, ref_ptr, ref_stride, sad_array, 16);
+}
+
+void vpx_sad16x8x8_avx2(const uint8_t *src_ptr, int src_stride,
+                        const uint8_t *ref_ptr, int ref_stride,
+                        uint32_t *sad_array) {
+  sad16xhx8_avx2(src_ptr, src_stride, ref_ptr, ref_stride, sad_array, 8);
+}
@@ -0,0 +1,135 @@
+/*
+ *  Copyright (c) 2019 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VPX_DSP_X86_TRANSPOSE_AVX2_H_
+#define VPX_VPX_DSP_X86_TRANSPOSE_AVX2_H_
+
+#include <immintrin.h>  // AVX2
+
+#include "./vpx_config.h"
+
+// Transpose the 8x8 16 bit blocks held in each 128 bit lane of in[0..7].
+static INLINE void transpose_16bit_8x8x2_avx2(const __m256i *const in,
+                                              __m256i *const out) {
+  // Unpack 16 bit elements. Goes from:
+  // in[0]: 00 01 02 03  04 05 06 07
+  // in[1]: 10 11 12 13  14 15 16 17
+  // ...
+  // in[7]: 70 71 72 73  74 75 76 77
+  // to:
+  // a0:    00 10 01 11  02 12 03 13
+  // a1:    20 30 21 31  22 32 23 33
+  // a2:    40 50 41 51  42 52 43 53
+  // a3:    60 70 61 71  62 72 63 73
+  // a4:    04 14 05 15  06 16 07 17
+  // a5:    24 34 25 35  26 36 27 37
+  // a6:    44 54 45 55  46 56 47 57
+  // a7:    64 74 65 75  66 76 67 77
+  const __m256i a0 = _mm256_unpacklo_epi16(in[0], in[1]);
+  const __m256i a1 = _mm256_unpacklo_epi16(in[2], in[3]);
+  const __m256i a2 = _mm256_unpacklo_epi16(in[4], in[5]);
+  const __m256i a3 = _mm256_unpacklo_epi16(in[6], in[7]);
+  const __m256i a4 = _mm256_unpackhi_epi16(in[0], in[1]);
+  const __m256i a5 = _mm256_unpackhi_epi16(in[2], in[3]);
+  const __m256i a6 = _mm256_unpackhi_epi16(in[4], in[5]);
+  const __m256i a7 = _mm256_unpackhi_epi16(in[6], in[7]);
+
+  // Unpack 32 bit elements resulting in:
+  // b0: 00 10 20 30  01 11 21 31
+  // b1: 40 50 60 70  41 51 61 71
+  // b2: 04 14 24 34  05 15 25 35
+  // b3: 44 54 64 74  45 55 65 75
+  // b4: 02 12 22 32  03 13 23 33
+  // b5: 42 52 62 72  43 53 63 73
+  // b6: 06 16 26 36  07 17 27 37
+  // b7: 46 56 66 76  47 57 67 77
+  const __m256i b0 = _mm256_unpacklo_epi32(a0, a1);
+  const __m256i b1 = _mm256_unpacklo_epi32(a2, a3);
+  const __m256i b2 = _mm256_unpacklo_epi32(a4, a5);
+  const __m256i b3 = _mm256_unpacklo_epi32(a6, a7);
+  const __m256i b4 = _mm256_unpackhi_epi32(a0, a1);
+  const __m256i b5 = _mm256_unpackhi_epi32(a2, a3);
+  const __m256i b6 = _mm256_unpackhi_epi32(a4, a5);
+  const __m256i b7 = _mm256_unpackhi_epi32(a6, a7);
+
+  // Unpack 64 bit elements resulting in:
+  // out[0]: 00 10 20 30  40 50 60 70
+  // out[1]: 01 11 21 31  41 51 61 71
+  // ...
+  // out[7]: 07 17 27 37  47 57 67 77
+  out[0] = _mm256_unpacklo_epi64(b0, b1);
+  out[1] = _mm256_unpackhi_epi64(b0, b1);
+  out[2] = _mm256_unpacklo_epi64(b4, b5);
+  out[3] = _mm256_unpackhi_epi64(b4, b5);
+  out[4] = _mm256_unpacklo_epi64(b2, b3);
+  out[5] = _mm256_unpackhi_epi64(b2, b3);
+  out[6] = _mm256_unpacklo_epi64(b6, b7);
+  out[7] = _mm256_unpackhi_epi64(b6, b7);
+}
+
+// Transpose a 16x16 block of 16 bit elements, one row per register. Rows i and
+// i + 8 are first regrouped so that each 128 bit lane holds an 8x8 quarter,
+// which is then transposed in place by transpose_16bit_8x8x2_avx2(). in and out
+// may alias.
+static INLINE void transpose_16bit_16x16_avx2(const __m256i *const in,
+                                              __m256i *const out) {
+  __m256i l[8], r[8];
+  int i;
+
+  for (i = 0; i < 8; ++i) {
+    // l[i]: row i cols 0-7  | row i + 8 cols 0-7
+    // r[i]: row i cols 8-15 | row i + 8 cols 8-15
+    l[i] = _mm256_permute2x128_si256(in[i], in[i + 8], 0x20);
+    r[i] = _mm256_permute2x128_si256(in[i], in[i + 8], 0x31);
+  }
+
+  transpose_16bit_8x8x2_avx2(l, out);
+  transpose_16bit_8x8x2_avx2(r, out + 8);
+}
+
+// Transpose an 8x8 block of 32 bit elements, one row per register. in and out
+// may alias.
+static INLINE void transpose_32bit_8x8_avx2(const __m256i *const in,
+                                            __m256i *const out) {
+  __m256i l[4], r[4], a0, a1, a2, a3;
+  int i;
+
+  for (i = 0; i < 4; ++i) {
+    // l[i]: row i cols 0-3 | row i + 4 cols 0-3
+    // r[i]: row i cols 4-7 | row i + 4 cols 4-7
+    l[i] = _mm256_permute2x128_si256(in[i], in[i + 4], 0x20);
+    r[i] = _mm256_permute2x128_si256(in[i], in[i + 4], 0x31);
+  }
+
+  // Per lane 4x4 transposes:
+  // a0: 00 10 01 11
+  // a1: 20 30 21 31
+  // a2: 02 12 03 13
+  // a3: 22 32 23 33
+  a0 = _mm256_unpacklo_epi32(l[0], l[1]);
+  a1 = _mm256_unpacklo_epi32(l[2], l[3]);
+  a2 = _mm256_unpackhi_epi32(l[0], l[1]);
+  a3 = _mm256_unpackhi_epi32(l[2], l[3]);
+  out[0] = _mm256_unpacklo_epi64(a0, a1);
+  out[1] = _mm256_unpackhi_epi64(a0, a1);
+  out[2] = _mm256_unpacklo_epi64(a2, a3);
+  out[3] = _mm256_unpackhi_epi64(a2, a3);
+
+  a0 = _mm256_unpacklo_epi32(r[0], r[1]);
+  a1 = _mm256_unpacklo_epi32(r[2], r[3]);
+  a2 = _mm256_unpackhi_epi32(r[0], r[1]);
+  a3 = _mm256_unpackhi_epi32(r[2], r[3]);
+  out[4] = _mm256_unpacklo_epi64(a0, a1);
+  out[5] = _mm256_unpackhi_epi64(a0, a1);
+  out[6] = _mm256_unpacklo_epi64(a2, a3);
+  out[7] = _mm256_unpackhi_epi64(a2, a3);
+}
+
+#endif  // VPX_VPX_DSP_X86_TRANSPOSE_AVX2_H_
@@ -15,6 +15,10 @@
 
 #include "vpx/vpx_integer.h"
 
+#if ARCH_X86 || ARCH_X86_64
+#include "vpx_ports/x86.h"
+#endif
+
 #if CONFIG_OS_SUPPORT
 
 #if defined(_WIN32)
@@ -32,6 +36,7 @@
  * POSIX specific includes
  */
 #include <sys/time.h>
+#include <time.h>
 
 /* timersub is not provided by msys at this time. */
 #ifndef timersub
@@ -87,6 +92,27 @@ static INLINE int64_t vpx_usec_timer_elapsed(struct vpx_usec_timer *t) {
 #endif
 }
 
+/* Cheap timestamp for instrumenting short regions of code. Counts timestamp
+ * counter cycles on x86 and nanoseconds elsewhere.
+ */
+static INLINE uint64_t vpx_timer_ticks(void) {
+#if ARCH_X86 || ARCH_X86_64
+  return x86_readtsc64();
+#elif defined(_WIN32)
+  LARGE_INTEGER now;
+  QueryPerformanceCounter(&now);
+  return (uint64_t)now.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+#else
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return (uint64_t)now.tv_sec * 1000000000 + now.tv_usec * 1000;
+#endif
+}
+
 #else /* CONFIG_OS_SUPPORT = 0*/
 
 /* Empty timer functions if CONFIG_OS_SUPPORT = 0 */
@@ -104,6 +130,14 @@ static INLINE void vpx_usec_timer_mark(struct vpx_usec_timer *t) {}
 
 static INLINE int vpx_usec_timer_elapsed(struct vpx_usec_timer *t) { return 0; }
 
+static INLINE uint64_t vpx_timer_ticks(void) {
+#if ARCH_X86 || ARCH_X86_64
+  return x86_readtsc64();
+#else
+  return 0;
+#endif
+}
+
 #endif /* CONFIG_OS_SUPPORT */
 
 #endif  // VPX_VPX_PORTS_VPX_TIMER_H_
@@ -23,6 +23,22 @@ struct VPxWorkerImpl {
   pthread_mutex_t mutex_;
   pthread_cond_t condition_;
   pthread_t thread_;
+  // Pool workers only.
+  VPxWorker *worker_;
+  VPxWorkerImpl *next_;  // Next worker in the queue of the pool.
+};
+
+struct VPxWorkerPool {
+  pthread_mutex_t mutex_;
+  pthread_cond_t condition_;  // Signaled when a job is queued.
+  pthread_t *threads_;
+  int num_threads_;
+  int shutdown_;
+  // Jobs are run in the order they are launched.
+  VPxWorkerImpl *queue_head_;
+  VPxWorkerImpl *queue_tail_;
+  int num_reserved_;
+  int num_clients_;
 };
 
 //------------------------------------------------------------------------------
@@ -50,6 +66,59 @@ static THREADFN thread_loop(void *ptr) {
   return THREAD_RETURN(NULL);  // Thread is finished
 }
 
+static THREADFN pool_thread_loop(void *ptr) {
+  VPxWorkerPool *const pool = (VPxWorkerPool *)ptr;
+  while (1) {
+    VPxWorkerImpl *impl;
+    VPxWorker *worker;
+    pthread_mutex_lock(&pool->mutex_);
+    while (pool->queue_head_ == NULL && !pool->shutdown_) {
+      pthread_cond_wait(&pool->condition_, &pool->mutex_);
+    }
+    impl = pool->queue_head_;
+    if (impl == NULL) {
+      pthread_mutex_unlock(&pool->mutex_);
+      break;
+    }
+    pool->queue_head_ = impl->next_;
+    if (pool->queue_head_ == NULL) pool->queue_tail_ = NULL;
+    pthread_mutex_unlock(&pool->mutex_);
+
+    worker = impl->worker_;
+    execute(worker);
+    pthread_mutex_lock(&impl->mutex_);
+    worker->status_ = OK;
+    // signal to the main thread that we're done (for sync())
+    pthread_cond_signal(&impl->condition_);
+    pthread_mutex_unlock(&impl->mutex_);
+  }
+  return THREAD_RETURN(NULL);
+}
+
+static void pool_launch(VPxWorker *const worker) {
+  VPxWorkerImpl *const impl = worker->impl_;
+  VPxWorkerPool *const pool = worker->pool;
+  if (impl == NULL) return;
+
+  pthread_mutex_lock(&impl->mutex_);
+  while (worker->status_ != OK) {
+    pthread_cond_wait(&impl->condition_, &impl->mutex_);
+  }
+  worker->status_ = WORK;
+  pthread_mutex_unlock(&impl->mutex_);
+
+  pthread_mutex_lock(&pool->mutex_);
+  impl->next_ = NULL;
+  if (pool->queue_tail_ != NULL) {
+    pool->queue_tail_->next_ = impl;
+  } else {
+    pool->queue_head_ = impl;
+  }
+  pool->queue_tail_ = impl;
+  pthread_cond_signal(&pool->condition_);
+  pthread_mutex_unlock(&pool->mutex_);
+}
+
 // main thread state control
 static void change_state(VPxWorker *const worker, VPxWorkerStatus new_status) {
   // No-op when attempting to change state on a thread that didn't come up.
@@ -105,6 +174,12 @@ static int reset(VPxWorker *const worker) {
       pthread_mutex_destroy(&worker->impl_->mutex_);
       goto Error;
     }
+    if (worker->pool != NULL) {
+      // The job runs on the threads of the pool.
+      worker->impl_->worker_ = worker;
+      worker->status_ = OK;
+      return 1;
+    }
     pthread_mutex_lock(&worker->impl_->mutex_);
     ok = !pthread_create(&worker->impl_->thread_, NULL, thread_loop, worker);
     if (ok) worker->status_ = OK;
@@ -135,6 +210,10 @@ static void execute(VPxWorker *const worker) {
 
 static void launch(VPxWorker *const worker) {
 #if CONFIG_MULTITHREAD
+  if (worker->pool != NULL) {
+    pool_launch(worker);
+    return;
+  }
   change_state(worker, WORK);
 #else
   execute(worker);
@@ -144,8 +223,14 @@ static void launch(VPxWorker *const worker) {
 static void end(VPxWorker *const worker) {
 #if CONFIG_MULTITHREAD
   if (worker->impl_ != NULL) {
-    change_state(worker, NOT_OK);
-    pthread_join(worker->impl_->thread_, NULL);
+    if (worker->pool != NULL) {
+      // Wait for the job to finish, there is no thread to stop.
+      change_state(worker, OK);
+      worker->status_ = NOT_OK;
+    } else {
+      change_state(worker, NOT_OK);
+      pthread_join(worker->impl_->thread_, NULL);
+    }
     pthread_mutex_destroy(&worker->impl_->mutex_);
     pthread_cond_destroy(&worker->impl_->condition_);
     vpx_free(worker->impl_);
@@ -179,3 +264,136 @@ const VPxWorkerInterface *vpx_get_worker_interface(void) {
 }
 
 //------------------------------------------------------------------------------
+
+int vpx_worker_is_busy(VPxWorker *const worker) {
+#if CONFIG_MULTITHREAD
+  int busy;
+  if (worker->impl_ == NULL) return 0;
+  pthread_mutex_lock(&worker->impl_->mutex_);
+  busy = worker->status_ == WORK;
+  pthread_mutex_unlock(&worker->impl_->mutex_);
+  return busy;
+#else
+  (void)worker;
+  return 0;
+#endif  // CONFIG_MULTITHREAD
+}
+
+VPxWorkerPool *vpx_worker_pool_create(int num_threads) {
+#if CONFIG_MULTITHREAD
+  VPxWorkerPool *pool;
+  int i;
+
+  if (num_threads <= 0) return NULL;
+  pool = (VPxWorkerPool *)vpx_calloc(1, sizeof(*pool));
+  if (pool == NULL) return NULL;
+  pool->threads_ =
+      (pthread_t *)vpx_calloc(num_threads, sizeof(*pool->threads_));
+  if (pool->threads_ == NULL) {
+    vpx_free(pool);
+    return NULL;
+  }
+  if (pthread_mutex_init(&pool->mutex_, NULL)) {
+    vpx_free(pool->threads_);
+    vpx_free(pool);
+    return NULL;
+  }
+  if (pthread_cond_init(&pool->condition_, NULL)) {
+    pthread_mutex_destroy(&pool->mutex_);
+    vpx_free(pool->threads_);
+    vpx_free(pool);
+    return NULL;
+  }
+  for (i = 0; i < num_threads; ++i) {
+    if (pthread_create(&pool->threads_[i], NULL, pool_thread_loop, pool)) {
+      break;
+    }
+    ++pool->num_threads_;
+  }
+  if (pool->num_threads_ < num_threads) {
+    vpx_worker_pool_destroy(pool);
+    return NULL;
+  }
+  return pool;
+#else
+  (void)num_threads;
+  return NULL;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vpx_worker_pool_destroy(VPxWorkerPool *pool) {
+#if CONFIG_MULTITHREAD
+  int i;
+  if (pool == NULL) return;
+  pthread_mutex_lock(&pool->mutex_);
+  pool->shutdown_ = 1;
+  pthread_cond_broadcast(&pool->condition_);
+  pthread_mutex_unlock(&pool->mutex_);
+  for (i = 0; i < pool->num_threads_; ++i) {
+    pthread_join(pool->threads_[i], NULL);
+  }
+  pthread_mutex_destroy(&pool->mutex_);
+  pthread_cond_destroy(&pool->condition_);
+  vpx_free(pool->threads_);
+  vpx_free(pool);
+#else
+  (void)pool;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vpx_worker_pool_add_client(VPxWorkerPool *pool) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&pool->mutex_);
+  ++pool->num_clients_;
+  pthread_mutex_unlock(&pool->mutex_);
+#else
+  (void)pool;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vpx_worker_pool_remove_client(VPxWorkerPool *pool) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&pool->mutex_);
+  --pool->num_clients_;
+  assert(pool->num_clients_ >= 0);
+  pthread_mutex_unlock(&pool->mutex_);
+#else
+  (void)pool;
+#endif  // CONFIG_MULTITHREAD
+}
+
+int vpx_worker_pool_reserve(VPxWorkerPool *pool, int num_workers) {
+#if CONFIG_MULTITHREAD
+  int granted;
+  int fair_share;
+  pthread_mutex_lock(&pool->mutex_);
+  // Round up so that no thread stays idle for lack of clients.
+  fair_share = pool->num_clients_ > 1 ? (pool->num_threads_ +
+                                         pool->num_clients_ - 1) /
+                                            pool->num_clients_
+                                      : pool->num_threads_;
+  granted = num_workers < fair_share ? num_workers : fair_share;
+  if (granted > pool->num_threads_ - pool->num_reserved_)
+    granted = pool->num_threads_ - pool->num_reserved_;
+  if (granted < 0) granted = 0;
+  pool->num_reserved_ += granted;
+  pthread_mutex_unlock(&pool->mutex_);
+  return granted;
+#else
+  (void)pool;
+  (void)num_workers;
+  return 0;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vpx_worker_pool_release(VPxWorkerPool *pool, int num_workers) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&pool->mutex_);
+  pool->num_reserved_ -= num_workers;
+  assert(pool->num_reserved_ >= 0);
+  pthread_mutex_unlock(&pool->mutex_);
+#else
+  (void)pool;
+  (void)num_workers;
+#endif  // CONFIG_MULTITHREAD
+}
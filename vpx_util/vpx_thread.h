@@ -384,6 +384,9 @@ typedef int (*VPxWorkerHook)(void *, void *);
 // Platform-dependent implementation details for the worker.
 typedef struct VPxWorkerImpl VPxWorkerImpl;
 
+// Threads shared by the workers of several codec instances.
+typedef struct VPxWorkerPool VPxWorkerPool;
+
 // Synchronization object used to launch job in the worker thread
 typedef struct {
   VPxWorkerImpl *impl_;
@@ -392,6 +395,9 @@ typedef struct {
   void *data1;         // first argument passed to 'hook'
   void *data2;         // second argument passed to 'hook'
   int had_error;       // return value of the last call to 'hook'
+  // If set between init() and reset(), the job runs on a thread of this pool
+  // instead of a thread owned by the worker.
+  VPxWorkerPool *pool;
 } VPxWorker;
 
 // The interface for all thread-worker related functions. All these functions
@@ -429,6 +435,31 @@ int vpx_set_worker_interface(const VPxWorkerInterface *const winterface);
 // Retrieve the currently set thread worker interface.
 const VPxWorkerInterface *vpx_get_worker_interface(void);
 
+// Returns true while the job launched on |worker| has not finished. Unlike
+// sync(), does not wait for it.
+int vpx_worker_is_busy(VPxWorker *const worker);
+
+// Create a pool of |num_threads| threads. Returns NULL on failure or when
+// built without CONFIG_MULTITHREAD.
+VPxWorkerPool *vpx_worker_pool_create(int num_threads);
+
+// Stop the threads and free the pool. All the workers using the pool must
+// have been ended first.
+void vpx_worker_pool_destroy(VPxWorkerPool *pool);
+
+// Codec instances using the pool register themselves so that the threads can
+// be shared fairly between them.
+void vpx_worker_pool_add_client(VPxWorkerPool *pool);
+void vpx_worker_pool_remove_client(VPxWorkerPool *pool);
+
+// Reserve threads to launch up to |num_workers| workers that depend on each
+// other, which therefore must run at the same time. Does not block: returns
+// the number of threads granted, at most the fair share of one client and
+// possibly 0. The threads are returned with vpx_worker_pool_release() once
+// the launched workers have been synced.
+int vpx_worker_pool_reserve(VPxWorkerPool *pool, int num_workers);
+void vpx_worker_pool_release(VPxWorkerPool *pool, int num_workers);
+
 //------------------------------------------------------------------------------
 
 #ifdef __cplusplus
@@ -77,7 +77,7 @@ static const arg_def_t outputfile =
 static const arg_def_t threadsarg =
     ARG_DEF("t", "threads", 1, "Max threads to use");
 static const arg_def_t frameparallelarg =
-    ARG_DEF(NULL, "frame-parallel", 0, "Frame parallel decode (ignored)");
+    ARG_DEF(NULL, "frame-parallel", 0, "Frame parallel decode in VP9");
 static const arg_def_t verbosearg =
     ARG_DEF("v", "verbose", 0, "Show version string");
 static const arg_def_t error_concealment =
@@ -530,6 +530,7 @@ static int main_loop(int argc, const char **argv_) {
   int keep_going = 0;
   int enable_row_mt = 0;
   int enable_lpf_opt = 0;
+  int enable_frame_parallel = 0;
   const VpxInterface *interface = NULL;
   const VpxInterface *fourcc_interface = NULL;
   uint64_t dx_time = 0;
@@ -627,7 +628,7 @@ static int main_loop(int argc, const char **argv_) {
       cfg.threads = arg_parse_uint(&arg);
 #if CONFIG_VP9_DECODER
     else if (arg_match(&arg, &frameparallelarg, argi)) {
-      /* ignored for compatibility */
+      enable_frame_parallel = 1;
     }
 #endif
     else if (arg_match(&arg, &verbosearg, argi))
@@ -793,6 +794,13 @@ static int main_loop(int argc, const char **argv_) {
             vpx_codec_error(&decoder));
     goto fail;
   }
+  if (interface->fourcc == VP9_FOURCC &&
+      vpx_codec_control(&decoder, VP9D_SET_FRAME_PARALLEL,
+                        enable_frame_parallel)) {
+    fprintf(stderr, "Failed to set decoder in frame parallel mode: %s\n",
+            vpx_codec_error(&decoder));
+    goto fail;
+  }
   if (!quiet) fprintf(stderr, "%s\n", decoder.name);
 
 #if CONFIG_VP8_DECODER
@@ -40,6 +40,7 @@
 #endif
 
 #include "vpx/vpx_integer.h"
+#include "vpx_dsp/vpx_dsp_common.h"
 #include "vpx_ports/mem_ops.h"
 #include "vpx_ports/vpx_timer.h"
 #include "./rate_hist.h"
@@ -49,6 +50,7 @@
 #include "./webmenc.h"
 #endif
 #include "./y4minput.h"
+#include "vpx_util/vpx_thread.h"
 
 static size_t wrap_fwrite(const void *ptr, size_t size, size_t nmemb,
                           FILE *stream) {
@@ -112,6 +114,12 @@ static const arg_def_t pass_arg =
     ARG_DEF(NULL, "pass", 1, "Pass to execute (1/2)");
 static const arg_def_t fpf_name =
     ARG_DEF(NULL, "fpf", 1, "First pass statistics file name");
+static const arg_def_t fp_chunk_frames =
+    ARG_DEF(NULL, "fp-chunk-frames", 1,
+            "Run the first pass on independent chunks of n frames (VP9)");
+static const arg_def_t fp_threads =
+    ARG_DEF(NULL, "fp-threads", 1,
+            "Number of chunks to analyze in parallel (default 4)");
 #if CONFIG_FP_MB_STATS
 static const arg_def_t fpmbf_name =
     ARG_DEF(NULL, "fpmbf", 1, "First pass block statistics file name");
@@ -174,6 +182,8 @@ static const arg_def_t *main_args[] = { &help,
                                         &passes,
                                         &pass_arg,
                                         &fpf_name,
+                                        &fp_chunk_frames,
+                                        &fp_threads,
                                         &limit,
                                         &skip,
                                         &deadline,
@@ -462,6 +472,13 @@ static const arg_def_t target_level = ARG_DEF(
 static const arg_def_t row_mt =
     ARG_DEF(NULL, "row-mt", 1,
             "Enable row based non-deterministic multi-threading in VP9");
+static const arg_def_t loopfilter_pipeline =
+    ARG_DEF(NULL, "loopfilter-pipeline", 1,
+            "Run the VP9 loop filter on its own thread, overlapped with "
+            "bitstream packing");
+static const arg_def_t sampled_lpf_pick =
+    ARG_DEF(NULL, "sampled-lpf-pick", 1,
+            "Pick the VP9 loop filter level from sampled superblock rows");
 #endif
 
 #if CONFIG_VP9_ENCODER
@@ -492,6 +509,8 @@ static const arg_def_t *vp9_args[] = { &cpu_used_vp9,
                                        &max_gf_interval,
                                        &target_level,
                                        &row_mt,
+                                       &loopfilter_pipeline,
+                                       &sampled_lpf_pick,
 #if CONFIG_VP9_HIGHBITDEPTH
                                        &bitdeptharg,
                                        &inbitdeptharg,
@@ -524,6 +543,8 @@ static const int vp9_arg_ctrl_map[] = { VP8E_SET_CPUUSED,
                                         VP9E_SET_MAX_GF_INTERVAL,
                                         VP9E_SET_TARGET_LEVEL,
                                         VP9E_SET_ROW_MT,
+                                        VP9E_SET_LOOPFILTER_PIPELINE,
+                                        VP9E_SET_SAMPLED_LPF_PICK,
                                         0 };
 #endif
 
@@ -663,6 +684,7 @@ static void parse_global_config(struct VpxEncoderConfig *global, char **argv) {
   global->color_type = I420;
   /* Assign default deadline to good quality */
   global->deadline = VPX_DL_GOOD_QUALITY;
+  global->fp_threads = 4;
 
   for (argi = argj = argv; (*argj = *argi); argi += arg.argv_step) {
     arg.argv_step = 1;
@@ -712,7 +734,14 @@ static void parse_global_config(struct VpxEncoderConfig *global, char **argv) {
       global->limit = arg_parse_uint(&arg);
     else if (arg_match(&arg, &skip, argi))
       global->skip_frames = arg_parse_uint(&arg);
-    else if (arg_match(&arg, &psnrarg, argi))
+    else if (arg_match(&arg, &fp_chunk_frames, argi))
+      global->fp_chunk_frames = arg_parse_uint(&arg);
+    else if (arg_match(&arg, &fp_threads, argi)) {
+      global->fp_threads = arg_parse_uint(&arg);
+      if (global->fp_threads < 1)
+        die("Error: Invalid number of first pass threads (%d)\n",
+            global->fp_threads);
+    } else if (arg_match(&arg, &psnrarg, argi))
       global->show_psnr = 1;
     else if (arg_match(&arg, &recontest, argi))
       global->test_decode = arg_parse_enum_or_int(&arg);
@@ -1580,6 +1609,283 @@ static void test_decode(struct stream_state *stream,
   vpx_img_free(&dec_img);
 }
 
+#if CONFIG_VP9_ENCODER && !CONFIG_FP_MB_STATS
+/* Chunked first pass.
+ *
+ * The input is split into chunks of --fp-chunk-frames frames which are
+ * analyzed by separate encoder instances, --fp-threads at a time. Every chunk
+ * but the first starts by encoding the frame before it, whose stats are
+ * discarded, so that its first frame is still measured against a real
+ * previous frame. The per frame stats are then concatenated in input order
+ * and merged by the encoder (VP9E_MERGE_FIRSTPASS_STATS), so the stats file
+ * only depends on the chunk size and not on the number of threads or the order
+ * the chunks finish in. A chunk covering the whole input reproduces the serial
+ * first pass exactly. Smaller chunks lose the motion and golden frame history
+ * at each boundary, so the per frame stats drift, but the second pass output
+ * size stays within 5% of the one from serial stats (see test/vpxenc.sh).
+ */
+struct fp_chunk {
+  int first_frame;
+  int num_frames;
+  /* Stats packets of the warm-up frame, the chunk's frames and the totals. */
+  uint8_t *stats;
+  size_t packet_sz;
+};
+
+struct fp_chunk_context {
+  struct VpxEncoderConfig global;
+  const struct stream_state *stream;
+  const struct VpxInputContext *input;
+  int64_t data_start;
+  int64_t frame_bytes;
+  int first_frame;
+#if CONFIG_VP9_HIGHBITDEPTH
+  int input_shift;
+  int use_16bit_internal;
+#endif
+  struct fp_chunk *chunks;
+  int num_chunks;
+  int next_chunk;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t mutex;
+#endif
+};
+
+/* Returns the number of frames the chunked first pass would analyze, or 0 if
+ * the input can't be split, in which case the regular serial loop is used.
+ * Chunks are read through their own file handles, so the input must be a
+ * seekable raw or y4m file with a fixed size per frame.
+ */
+static int setup_fp_chunks(struct fp_chunk_context *ctx,
+                           const struct stream_state *streams,
+                           const struct VpxEncoderConfig *global,
+                           const struct VpxInputContext *input,
+                           const vpx_image_t *raw) {
+  int64_t total_frames;
+  int last_frame, i;
+
+  if (!global->fp_chunk_frames || streams->next != NULL ||
+      streams->config.cfg.g_pass != VPX_RC_FIRST_PASS ||
+      strcmp(global->codec->name, "vp9") != 0 || input->length <= 0 ||
+      !strcmp(input->filename, "-"))
+    return 0;
+
+  memset(ctx, 0, sizeof(*ctx));
+  if (input->file_type == FILE_TYPE_Y4M) {
+    const y4m_input *const y4m = &input->y4m;
+    ctx->data_start = ftello(input->file);
+    ctx->frame_bytes = 6 + y4m->dst_buf_read_sz + y4m->aux_buf_read_sz;
+    /* Frame headers carrying parameters would break the fixed layout. */
+    if ((input->length - ctx->data_start) % ctx->frame_bytes) return 0;
+  } else {
+    const int bytespp = (raw->fmt & VPX_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+    int plane;
+    for (plane = 0; plane < 3; ++plane) {
+      ctx->frame_bytes += (int64_t)vpx_img_plane_width(raw, plane) *
+                          vpx_img_plane_height(raw, plane) * bytespp;
+    }
+  }
+
+  total_frames = (input->length - ctx->data_start) / ctx->frame_bytes;
+  last_frame = (int)VPXMIN(total_frames, INT_MAX);
+  if (global->limit) last_frame = VPXMIN(last_frame, global->limit);
+  if (last_frame <= global->skip_frames) return 0;
+
+  ctx->global = *global;
+  ctx->global.test_decode = TEST_DECODE_OFF;
+  ctx->stream = streams;
+  ctx->input = input;
+  ctx->first_frame = global->skip_frames;
+  ctx->num_chunks =
+      (last_frame - ctx->first_frame + global->fp_chunk_frames - 1) /
+      global->fp_chunk_frames;
+  ctx->chunks = calloc(ctx->num_chunks, sizeof(*ctx->chunks));
+  if (!ctx->chunks) fatal("Failed to allocate first pass chunks");
+
+  for (i = 0; i < ctx->num_chunks; ++i) {
+    struct fp_chunk *const chunk = &ctx->chunks[i];
+    chunk->first_frame = ctx->first_frame + i * global->fp_chunk_frames;
+    chunk->num_frames =
+        VPXMIN(global->fp_chunk_frames, last_frame - chunk->first_frame);
+  }
+
+  return last_frame - ctx->first_frame;
+}
+
+static void encode_fp_chunk(struct fp_chunk_context *ctx,
+                            struct fp_chunk *chunk) {
+  struct stream_state stream = *ctx->stream;
+  struct VpxInputContext input;
+  vpx_image_t raw;
+  const int warmup = chunk->first_frame > ctx->first_frame;
+  const int start = chunk->first_frame - warmup;
+  const int end = chunk->first_frame + chunk->num_frames;
+  int frame, num_stats = 0, got_data = 1;
+#if CONFIG_VP9_HIGHBITDEPTH
+  vpx_image_t raw_shift;
+  const int shift = ctx->input_shift ||
+                    (ctx->use_16bit_internal && ctx->input->bit_depth == 8);
+#endif
+
+  memset(&input, 0, sizeof(input));
+  input.filename = ctx->input->filename;
+  input.fmt = ctx->input->fmt;
+  input.only_i420 = ctx->input->only_i420;
+  open_input_file(&input);
+  input.width = ctx->input->width;
+  input.height = ctx->input->height;
+  input.bit_depth = ctx->input->bit_depth;
+  /* The raw reader would otherwise replay the detection bytes first. */
+  input.detect.position = input.detect.buf_read;
+  if (fseeko(input.file, ctx->data_start + start * ctx->frame_bytes, SEEK_SET))
+    fatal("Failed to seek to frame %d of the input", start);
+
+  if (input.file_type == FILE_TYPE_Y4M)
+    memset(&raw, 0, sizeof(raw));
+  else
+    vpx_img_alloc(&raw, input.fmt, input.width, input.height, 32);
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (shift) {
+    vpx_img_alloc(&raw_shift, input.fmt | VPX_IMG_FMT_HIGHBITDEPTH, input.width,
+                  input.height, 32);
+  }
+#endif
+
+  stream.img = NULL;
+  stream.cx_time = 0;
+  initialize_encoder(&stream, &ctx->global);
+
+  for (frame = start; frame <= end || got_data; ++frame) {
+    vpx_image_t *img = NULL;
+    const vpx_codec_cx_pkt_t *pkt;
+    vpx_codec_iter_t iter = NULL;
+
+    if (frame < end) {
+      if (!read_frame(&input, &raw))
+        fatal("Failed to read frame %d of the input", frame);
+      img = &raw;
+#if CONFIG_VP9_HIGHBITDEPTH
+      if (shift) {
+        vpx_img_upshift(&raw_shift, &raw, ctx->input_shift);
+        img = &raw_shift;
+      }
+#endif
+    }
+    /* Timestamps match those of the serial loop, where frames_in counts
+     * from 1.
+     */
+    encode_frame(&stream, &ctx->global, img, frame + 1);
+
+    got_data = 0;
+    while ((pkt = vpx_codec_get_cx_data(&stream.encoder, &iter))) {
+      if (pkt->kind != VPX_CODEC_STATS_PKT) continue;
+      if (!chunk->stats) {
+        /* One packet per frame, followed by the totals. */
+        chunk->packet_sz = pkt->data.twopass_stats.sz;
+        chunk->stats =
+            malloc((warmup + chunk->num_frames + 1) * chunk->packet_sz);
+        if (!chunk->stats) fatal("Failed to allocate first pass chunk stats");
+      }
+      if (pkt->data.twopass_stats.sz != chunk->packet_sz ||
+          num_stats > warmup + chunk->num_frames)
+        fatal("Unexpected first pass stats packet");
+      memcpy(chunk->stats + num_stats++ * chunk->packet_sz,
+             pkt->data.twopass_stats.buf, chunk->packet_sz);
+      got_data = 1;
+    }
+  }
+
+  if (num_stats != warmup + chunk->num_frames + 1)
+    fatal("First pass chunk at frame %d produced %d stats, expected %d",
+          chunk->first_frame, num_stats, warmup + chunk->num_frames + 1);
+
+  /* Drop the warm-up frame. */
+  if (warmup) {
+    memmove(chunk->stats, chunk->stats + chunk->packet_sz,
+            chunk->num_frames * chunk->packet_sz);
+  }
+
+  vpx_codec_destroy(&stream.encoder);
+  if (stream.img) vpx_img_free(stream.img);
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (shift) vpx_img_free(&raw_shift);
+#endif
+  if (input.file_type != FILE_TYPE_Y4M) vpx_img_free(&raw);
+  close_input_file(&input);
+}
+
+static void encode_fp_chunks(struct fp_chunk_context *ctx) {
+  for (;;) {
+    int chunk;
+#if CONFIG_MULTITHREAD
+    pthread_mutex_lock(&ctx->mutex);
+#endif
+    chunk = ctx->next_chunk++;
+#if CONFIG_MULTITHREAD
+    pthread_mutex_unlock(&ctx->mutex);
+#endif
+    if (chunk >= ctx->num_chunks) break;
+    encode_fp_chunk(ctx, &ctx->chunks[chunk]);
+  }
+}
+
+#if CONFIG_MULTITHREAD
+static THREADFN fp_chunk_worker(void *arg) {
+  encode_fp_chunks((struct fp_chunk_context *)arg);
+  return THREAD_RETURN(NULL);
+}
+#endif
+
+static void run_fp_chunks(struct fp_chunk_context *ctx,
+                          struct stream_state *stream) {
+  size_t packet_sz;
+  vpx_fixed_buf_t stats;
+  int i, num_frames;
+#if CONFIG_MULTITHREAD
+  const int num_threads = VPXMIN(ctx->global.fp_threads, ctx->num_chunks);
+  pthread_t *const threads = malloc(num_threads * sizeof(*threads));
+
+  if (!threads) fatal("Failed to allocate first pass threads");
+  pthread_mutex_init(&ctx->mutex, NULL);
+  for (i = 0; i < num_threads; ++i) {
+    if (pthread_create(&threads[i], NULL, fp_chunk_worker, ctx))
+      fatal("Failed to create first pass thread");
+  }
+  for (i = 0; i < num_threads; ++i) pthread_join(threads[i], NULL);
+  pthread_mutex_destroy(&ctx->mutex);
+  free(threads);
+#else
+  encode_fp_chunks(ctx);
+#endif
+
+  /* Concatenate the frames of every chunk, leaving room for the totals. */
+  packet_sz = ctx->chunks[0].packet_sz;
+  num_frames = 0;
+  for (i = 0; i < ctx->num_chunks; ++i) num_frames += ctx->chunks[i].num_frames;
+  stats.sz = (num_frames + 1) * packet_sz;
+  stats.buf = malloc(stats.sz);
+  if (!stats.buf) fatal("Failed to allocate first pass stats");
+  num_frames = 0;
+  for (i = 0; i < ctx->num_chunks; ++i) {
+    struct fp_chunk *const chunk = &ctx->chunks[i];
+    if (chunk->packet_sz != packet_sz)
+      fatal("First pass chunks produced different stats packets");
+    memcpy((uint8_t *)stats.buf + num_frames * packet_sz, chunk->stats,
+           chunk->num_frames * packet_sz);
+    num_frames += chunk->num_frames;
+    free(chunk->stats);
+  }
+  free(ctx->chunks);
+
+  if (vpx_codec_control(&stream->encoder, VP9E_MERGE_FIRSTPASS_STATS, &stats))
+    ctx_exit_on_error(&stream->encoder, "Failed to merge first pass stats");
+  stats_write(&stream->stats, stats.buf, stats.sz);
+  stream->frames_out += num_frames + 1;
+  stream->nbytes = stats.sz;
+  free(stats.buf);
+}
+#endif  // CONFIG_VP9_ENCODER && !CONFIG_FP_MB_STATS
+
 static void print_time(const char *label, int64_t etl) {
   int64_t hours;
   int64_t mins;
@@ -1802,6 +2108,33 @@ int main(int argc, const char **argv_) {
     frame_avail = 1;
     got_data = 0;
 
+#if CONFIG_VP9_ENCODER && !CONFIG_FP_MB_STATS
+    {
+      struct fp_chunk_context fp_chunks;
+      const int num_frames =
+          setup_fp_chunks(&fp_chunks, streams, &global, &input, &raw);
+
+      if (num_frames) {
+        struct vpx_usec_timer timer;
+#if CONFIG_VP9_HIGHBITDEPTH
+        fp_chunks.input_shift = input_shift;
+        fp_chunks.use_16bit_internal = use_16bit_internal;
+#endif
+        vpx_usec_timer_start(&timer);
+        run_fp_chunks(&fp_chunks, streams);
+        vpx_usec_timer_mark(&timer);
+        cx_time += vpx_usec_timer_elapsed(&timer);
+        streams->cx_time = cx_time;
+        frames_in = global.skip_frames + num_frames;
+        seen_frames = num_frames;
+        frame_avail = 0;
+      } else if (global.fp_chunk_frames &&
+                 streams->config.cfg.g_pass == VPX_RC_FIRST_PASS) {
+        warn("Input can't be split into chunks, running a serial first pass");
+      }
+    }
+#endif
+
     while (frame_avail || got_data) {
       struct vpx_usec_timer timer;
 
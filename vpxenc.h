@@ -55,6 +55,8 @@ struct VpxEncoderConfig {
   int disable_warnings;
   int disable_warning_prompt;
   int experimental_bitstream;
+  int fp_chunk_frames;
+  int fp_threads;
 };
 
 #ifdef __cplusplus
@@ -14,11 +14,39 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+
 #include "./tools_common.h"
 
+#if !defined(_WIN32)
+// Map the whole stats file instead of reading it into a heap buffer. The
+// pages are file backed, so the kernel can bring them in as the encoder walks
+// forward through the stats and drop them again under memory pressure.
+static int map_stats_file(stats_io_t *stats) {
+  void *ptr;
+
+  if (stats->buf.sz == 0) return 0;
+
+  ptr = mmap(NULL, stats->buf.sz, PROT_READ, MAP_PRIVATE, fileno(stats->file),
+             0);
+  if (ptr == MAP_FAILED) return 0;
+
+#if defined(MADV_SEQUENTIAL)
+  (void)madvise(ptr, stats->buf.sz, MADV_SEQUENTIAL);
+#endif
+
+  stats->buf.buf = ptr;
+  stats->mapped = 1;
+  return 1;
+}
+#endif
+
 int stats_open_file(stats_io_t *stats, const char *fpf, int pass) {
   int res;
   stats->pass = pass;
+  stats->mapped = 0;
 
   if (pass == 0) {
     stats->file = fopen(fpf, "wb");
@@ -38,6 +66,10 @@ int stats_open_file(stats_io_t *stats, const char *fpf, int pass) {
     stats->buf.sz = stats->buf_alloc_sz = ftell(stats->file);
     rewind(stats->file);
 
+#if !defined(_WIN32)
+    if (map_stats_file(stats)) return 1;
+#endif
+
     stats->buf.buf = malloc(stats->buf_alloc_sz);
 
     if (!stats->buf.buf)
@@ -54,6 +86,7 @@ int stats_open_file(stats_io_t *stats, const char *fpf, int pass) {
 int stats_open_mem(stats_io_t *stats, int pass) {
   int res;
   stats->pass = pass;
+  stats->mapped = 0;
 
   if (!pass) {
     stats->buf.sz = 0;
@@ -69,7 +102,12 @@ int stats_open_mem(stats_io_t *stats, int pass) {
 void stats_close(stats_io_t *stats, int last_pass) {
   if (stats->file) {
     if (stats->pass == last_pass) {
-      free(stats->buf.buf);
+#if !defined(_WIN32)
+      if (stats->mapped)
+        munmap(stats->buf.buf, stats->buf.sz);
+      else
+#endif
+        free(stats->buf.buf);
     }
 
     fclose(stats->file);
@@ -28,6 +28,9 @@ typedef struct {
   FILE *file;
   char *buf_ptr;
   size_t buf_alloc_sz;
+  // Set when buf is a read-only mapping of the stats file rather than a heap
+  // copy, so the last pass does not need the whole file resident in memory.
+  int mapped;
 } stats_io_t;
 
 int stats_open_file(stats_io_t *stats, const char *fpf, int pass);